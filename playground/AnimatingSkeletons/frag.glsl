@@ -0,0 +1,13 @@
+#version 330 core
+
+out vec4 FragColor;
+in vec2 texCoord;
+in vec3 normal;
+
+uniform sampler2D tex;
+
+void main() {
+    // a fixed sun plus some ambient, enough to see the limbs move
+    float light = 0.3 + 0.7 * max(dot(normalize(normal), normalize(vec3(0.4, 1.0, 0.3))), 0.0);
+    FragColor = vec4(texture(tex, texCoord).rgb * light, 1.0);
+}
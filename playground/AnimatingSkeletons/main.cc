@@ -0,0 +1,1297 @@
+#include <GL/glew.h>
+
+#include <GLFW/glfw3.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cmath>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <immintrin.h>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+#include <glm/ext/matrix_clip_space.hpp>
+#include <glm/ext/matrix_transform.hpp>
+#include <glm/geometric.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/quaternion.hpp>
+#include <glm/ext/matrix_float4x4.hpp>
+#include <glm/gtc/type_ptr.hpp>
+#include <glm/glm.hpp>
+#include <glm/trigonometric.hpp>
+#define STB_IMAGE_IMPLEMENTATION
+#include <stb/stb_image.h>
+#include <iostream>
+
+class Shader {
+    std::string src; 
+protected:
+    const char *getsrc() {
+        return src.data();
+    }
+    GLuint shader_id = 0;
+    bool isCompiled = false;
+protected:
+    virtual const char *getClassName() = 0;
+    GLint getCompilationStatus(GLuint shader_id) {
+        int status;
+        glGetShaderiv(shader_id, GL_COMPILE_STATUS, &status);
+        return status;
+    }
+    void sendError() {
+        char buffer[1024];
+        glGetShaderInfoLog(shader_id, 1024, NULL, buffer);
+        std::cerr << "ERROR::" << getClassName() << " - " << buffer;
+    }
+public:
+    virtual void compile() = 0;
+    void setSource(const char *s) {
+        std::ifstream sourceFile(s);
+        if (!sourceFile.is_open())
+            return;
+        char buffer[8192];
+        while (sourceFile.read(buffer, 8192)) {
+            src.append(buffer, 8192);
+        }
+        if (!sourceFile.eof()) {
+            src.clear();
+            return;
+        }
+        src.append(buffer, sourceFile.gcount());
+    }
+    friend class Program;
+};
+
+
+class VertexShader : public Shader {
+    virtual const char *getClassName() override {
+        return "VertexShader";
+    }
+public:
+    virtual void compile() override {
+        if (shader_id)
+            glDeleteShader(shader_id);
+        shader_id = glCreateShader(GL_VERTEX_SHADER);
+        const char *src = getsrc();
+        glShaderSource(shader_id, 1, &src, NULL);
+        glCompileShader(shader_id);
+        if (!getCompilationStatus(shader_id)) {
+            sendError();
+        }
+        isCompiled = true;
+    }
+};
+
+class FragmentShader : public Shader {
+    const char *getClassName() override {
+        return "FragmentShader";
+    }
+public:
+    virtual void compile() override {
+        if (shader_id)
+            glDeleteShader(shader_id);
+        shader_id = glCreateShader(GL_FRAGMENT_SHADER);
+        const char *src = getsrc();
+        glShaderSource(shader_id, 1, &src, NULL);
+        glCompileShader(shader_id);
+        if (!getCompilationStatus(shader_id)) {
+            sendError();
+        }
+        isCompiled = true;
+    }
+};
+
+
+class Program {
+    GLuint program_id = 0;
+    void sendError() {
+        char buffer[1024];
+        glGetProgramInfoLog(program_id, 1024, NULL, buffer);
+        std::cerr << "ERROR::PROGRAM: " << " - " << buffer;
+    }
+    bool linkStatus() {
+        int status = 0;
+        glGetProgramiv(program_id, GL_LINK_STATUS, &status);
+        return status;
+    }
+public:
+    Program() {
+        program_id = glCreateProgram();
+    }
+    ~Program() {
+        glDeleteProgram(program_id);
+    }
+    void AttachShaders(std::initializer_list<Shader*> shaders) {
+        auto i = shaders.begin();
+        while (i != shaders.end()) {
+            if (!(*i)->isCompiled)
+                (*i)->compile();
+            glAttachShader(program_id, (*i)->shader_id);
+            ++i;
+        }
+        glLinkProgram(program_id);
+        if (!linkStatus()) {
+            sendError();
+        }
+    }
+    void UseProgram() {
+        glUseProgram(program_id);
+    }
+    void setMat4(const char *locName, const glm::mat4 &mat) {
+        int location = glGetUniformLocation(program_id, locName);
+        if (location == -1)
+            return;
+        glUniformMatrix4fv(location, 1, GL_FALSE, glm::value_ptr(mat));
+    }
+    void setInt(const char *locName, int value) {
+        int location = glGetUniformLocation(program_id, locName);
+        if (location == -1)
+            return;
+        glUniform1i(location, value);
+    }
+    void setFloat(const char *locName, float value) {
+        int location = glGetUniformLocation(program_id, locName);
+        if (location == -1)
+            return;
+        glUniform1f(location, value);
+    }
+    void setVec3(const char *locName, const glm::vec3 &vec) {
+        int location = glGetUniformLocation(program_id, locName);
+        if (location == -1)
+            return;
+        glUniform3f(location, vec.x, vec.y, vec.z);
+    }
+    void setVec4(const char *locName, const glm::vec4 &vec) {
+        int location = glGetUniformLocation(program_id, locName);
+        if (location == -1)
+            return;
+        glUniform4f(location, vec.x, vec.y, vec.z, vec.w);
+    }
+};
+
+
+class Texture2D {
+    GLuint tex_id;
+public:
+    void generate2DTex(const char *image_path) {
+        int width, height, nChannels;
+        stbi_set_flip_vertically_on_load(true);
+        uint8_t *raw_image = stbi_load(image_path, &width, &height, &nChannels, 0);
+        float borderColor[] = {1.f, 1.f, 1.f, 1.f};
+        glGenTextures(1, &tex_id);
+        glBindTexture(GL_TEXTURE_2D, tex_id);
+        // what to do when primitive is bigger than the texture
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_BORDER);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_BORDER);
+        glTexParameterfv(GL_TEXTURE_2D, GL_TEXTURE_BORDER_COLOR, borderColor);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        // glTexImage2D(TARGET_TYPE, IM_MIPMAP_LEVEL, TARGET_NRCHANNELS, SRC_WIDTH, SRC_HEIGHT, LEGACY_0, SRC_NRCHANNELS, SRC_DATA_TYPE, SRC_DATA);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, width, height, 0, GL_RGB, GL_UNSIGNED_BYTE, raw_image);
+        stbi_image_free(raw_image);
+    }
+    void bind() {
+        glBindTexture(GL_TEXTURE_2D, tex_id);
+    }
+};
+
+
+
+// a handful of threads that split loops between them, the calling thread helps out
+class WorkerPool {
+    std::vector<std::thread> threads;
+    std::mutex mutex;
+    std::condition_variable wake, finished;
+    const std::function<void(size_t, size_t)> *job = nullptr;
+    size_t jobCount = 0;
+    size_t jobChunk = 1;
+    std::atomic<size_t> next{0};
+    int busy = 0;
+    uint64_t generation = 0;
+    bool quit = false;
+
+    void work() {
+        size_t begin;
+        while ((begin = next.fetch_add(jobChunk)) < jobCount)
+            (*job)(begin, std::min(begin + jobChunk, jobCount));
+    }
+public:
+    explicit WorkerPool(unsigned count = std::thread::hardware_concurrency()) {
+        for (unsigned i = 1; i < std::max(count, 1u); ++i) {
+            threads.emplace_back([this] {
+                uint64_t seen = 0;
+                std::unique_lock<std::mutex> lock(mutex);
+                while (true) {
+                    wake.wait(lock, [&] { return quit || generation != seen; });
+                    if (quit)
+                        return;
+                    seen = generation;
+                    lock.unlock();
+                    work();
+                    lock.lock();
+                    if (--busy == 0)
+                        finished.notify_one();
+                }
+            });
+        }
+    }
+    ~WorkerPool() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            quit = true;
+        }
+        wake.notify_all();
+        for (std::thread &t : threads)
+            t.join();
+    }
+    size_t size() const {
+        return threads.size() + 1;
+    }
+    // calls fn(begin, end) on ranges of at most chunk items until [0, count) is covered, returns when all are done
+    void parallelFor(size_t count, size_t chunk, const std::function<void(size_t, size_t)> &fn) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            job = &fn;
+            jobCount = count;
+            jobChunk = std::max<size_t>(chunk, 1);
+            next = 0;
+            busy = threads.size();
+            ++generation;
+        }
+        wake.notify_all();
+        work();
+        std::unique_lock<std::mutex> lock(mutex);
+        finished.wait(lock, [&] { return busy == 0; });
+    }
+};
+
+
+// ---------------------------------------------------------------------------------------------------------
+// the skeleton. bones are stored parents first, so the model space pose is one pass from the root down.
+// the bind pose has no rotation anywhere, a bone is only its joint's offset from the parent's joint, which
+// makes the inverse bind matrix a translation by minus the joint's bind position
+// ---------------------------------------------------------------------------------------------------------
+
+// poses are padded to a multiple of 8 bones so the SIMD loops never need a tail
+constexpr int MAX_BONES = 24;
+
+struct Skeleton {
+    std::vector<int> parent;
+    std::vector<glm::vec3> offset;   // from the parent's joint, in the parent's space
+    std::vector<glm::vec3> bindPosition;
+    std::vector<const char*> name;
+    int size() const {
+        return int(parent.size());
+    }
+    int find(const char *boneName) const {
+        for (int b = 0; b < size(); ++b)
+            if (!std::strcmp(name[b], boneName))
+                return b;
+        return -1;
+    }
+};
+
+// a stick figure about 1.9m tall, facing +z
+Skeleton buildSkeleton() {
+    Skeleton s;
+    auto add = [&](const char *name, const char *parentName, glm::vec3 joint) {
+        int parent = parentName ? s.find(parentName) : -1;
+        s.parent.push_back(parent);
+        s.bindPosition.push_back(joint);
+        s.offset.push_back(parent < 0 ? joint : joint - s.bindPosition[parent]);
+        s.name.push_back(name);
+    };
+    add("hips", nullptr, glm::vec3(0.f, 1.f, 0.f));
+    add("spine", "hips", glm::vec3(0.f, 1.2f, 0.f));
+    add("chest", "spine", glm::vec3(0.f, 1.4f, 0.f));
+    add("neck", "chest", glm::vec3(0.f, 1.55f, 0.f));
+    add("head", "neck", glm::vec3(0.f, 1.65f, 0.f));
+    add("headTop", "head", glm::vec3(0.f, 1.9f, 0.f));
+    for (int side = 0; side < 2; ++side) {
+        const float x = side ? -1.f : 1.f;
+        const char *names[2][4] = {{"lShoulder", "lElbow", "lHand", "lFingers"}, {"rShoulder", "rElbow", "rHand", "rFingers"}};
+        add(names[side][0], "chest", glm::vec3(0.2f * x, 1.48f, 0.f));
+        add(names[side][1], names[side][0], glm::vec3(0.48f * x, 1.48f, 0.f));
+        add(names[side][2], names[side][1], glm::vec3(0.74f * x, 1.48f, 0.f));
+        add(names[side][3], names[side][2], glm::vec3(0.86f * x, 1.48f, 0.f));
+    }
+    for (int side = 0; side < 2; ++side) {
+        const float x = side ? -1.f : 1.f;
+        const char *names[2][4] = {{"lHip", "lKnee", "lAnkle", "lToe"}, {"rHip", "rKnee", "rAnkle", "rToe"}};
+        add(names[side][0], "hips", glm::vec3(0.11f * x, 0.95f, 0.f));
+        add(names[side][1], names[side][0], glm::vec3(0.11f * x, 0.52f, 0.f));
+        add(names[side][2], names[side][1], glm::vec3(0.11f * x, 0.09f, 0.f));
+        add(names[side][3], names[side][2], glm::vec3(0.11f * x, 0.03f, 0.16f));
+    }
+    return s;
+}
+
+
+// ---------------------------------------------------------------------------------------------------------
+// compressed clips. every bone's rotation track starts as one key per frame at 30 frames a second, then
+// 1. every key is quantized to 48 bits: the largest component is dropped (it follows from the other
+//    three, they're at most 1/sqrt(2) in size) and the other three are kept in 15 bits each, with the
+//    index of the dropped one in the two spare bits
+// 2. keys are dropped where interpolating between the ones around them is within a tolerance of the
+//    source. a greedy fit, each segment grows as long as every frame it spans still fits
+// a key costs 6 bytes and its frame number 2, against 16 for a float quaternion. finding the segment for
+// a time is one lookup in a byte per frame table instead of a search
+// ---------------------------------------------------------------------------------------------------------
+
+struct PackedQuat {
+    int16_t v[3];
+};
+
+constexpr float QUAT_COMPONENT_MAX = 0.70710678f;
+constexpr float QUAT_QUANTUM = QUAT_COMPONENT_MAX / 16383.f;
+
+// quaternions are x, y, z, w in that order here, the same as their layout in memory
+PackedQuat packQuat(glm::quat q) {
+    int largest = 0;
+    for (int i = 1; i < 4; ++i)
+        if (std::fabs(q[i]) > std::fabs(q[largest]))
+            largest = i;
+    // q and -q are the same rotation, the dropped one is made positive so it can be rebuilt with a sqrt
+    if (q[largest] < 0.f)
+        q = q * -1.f;
+    int quantized[3], n = 0;
+    for (int i = 0; i < 4; ++i)
+        if (i != largest)
+            quantized[n++] = int(std::lround(glm::clamp(q[i], -QUAT_COMPONENT_MAX, QUAT_COMPONENT_MAX) / QUAT_QUANTUM));
+    PackedQuat p;
+    p.v[0] = int16_t(quantized[0] * 2 | (largest & 1));
+    p.v[1] = int16_t(quantized[1] * 2 | (largest >> 1));
+    p.v[2] = int16_t(quantized[2] * 2);
+    return p;
+}
+
+glm::quat unpackQuat(PackedQuat p) {
+    const int largest = (p.v[0] & 1) | (p.v[1] & 1) << 1;
+    const float a = (p.v[0] >> 1) * QUAT_QUANTUM, b = (p.v[1] >> 1) * QUAT_QUANTUM, c = (p.v[2] >> 1) * QUAT_QUANTUM;
+    const float r = std::sqrt(std::max(0.f, 1.f - a * a - b * b - c * c));
+    glm::quat q;
+    switch (largest) {
+    case 0: q.x = r, q.y = a, q.z = b, q.w = c; break;
+    case 1: q.x = a, q.y = r, q.z = b, q.w = c; break;
+    case 2: q.x = a, q.y = b, q.z = r, q.w = c; break;
+    default: q.x = a, q.y = b, q.z = c, q.w = r; break;
+    }
+    return q;
+}
+
+// the shorter way, then back to unit length
+glm::quat nlerp(glm::quat a, glm::quat b, float t) {
+    if (glm::dot(a, b) < 0.f)
+        b = b * -1.f;
+    return glm::normalize(a * (1.f - t) + b * t);
+}
+
+float angleBetween(glm::quat a, glm::quat b) {
+    return 2.f * std::acos(std::min(1.f, std::fabs(glm::dot(glm::normalize(a), glm::normalize(b)))));
+}
+
+// one clip as it comes out of the animation tool: a rotation per bone and a root position per frame.
+// the last frame is the same as the first, clips loop
+struct SourceClip {
+    const char *name;
+    int frames;  // intervals, there are frames + 1 samples
+    float fps = 30.f;
+    std::vector<glm::quat> rotations;  // [frame * bones + bone]
+    std::vector<glm::vec3> rootPositions;
+};
+
+using ClipFunction = std::function<void(float phase, glm::quat *rotations, glm::vec3 &root)>;
+
+SourceClip sampleClip(const char *name, const Skeleton &skeleton, float seconds, const ClipFunction &pose) {
+    SourceClip clip;
+    clip.name = name;
+    clip.frames = int(std::lround(seconds * clip.fps));
+    const int bones = skeleton.size();
+    clip.rotations.resize(size_t(clip.frames + 1) * bones);
+    clip.rootPositions.resize(clip.frames + 1);
+    for (int f = 0; f <= clip.frames; ++f) {
+        glm::quat *rotations = &clip.rotations[size_t(f) * bones];
+        for (int b = 0; b < bones; ++b)
+            rotations[b] = glm::quat(1.f, 0.f, 0.f, 0.f);
+        clip.rootPositions[f] = skeleton.bindPosition[0];
+        pose(float(f % clip.frames) / clip.frames, rotations, clip.rootPositions[f]);
+    }
+    return clip;
+}
+
+std::vector<SourceClip> buildClips(const Skeleton &s) {
+    const glm::vec3 X(1.f, 0.f, 0.f), Y(0.f, 1.f, 0.f), Z(0.f, 0.f, 1.f);
+    const float TAU = 2.f * glm::pi<float>();
+    std::vector<SourceClip> clips;
+    clips.push_back(sampleClip("walk", s, 1.f, [&](float phase, glm::quat *r, glm::vec3 &root) {
+        const float swing = std::sin(phase * TAU);
+        root.y += 0.03f * std::cos(2.f * phase * TAU);
+        r[s.find("hips")] = glm::angleAxis(0.08f * swing, Y);
+        r[s.find("chest")] = glm::angleAxis(-0.15f * swing, Y);
+        r[s.find("head")] = glm::angleAxis(0.07f * swing, Y);
+        r[s.find("lHip")] = glm::angleAxis(-0.5f * swing, X);
+        r[s.find("rHip")] = glm::angleAxis(0.5f * swing, X);
+        r[s.find("lKnee")] = glm::angleAxis(0.7f * std::max(0.f, std::sin(phase * TAU + 1.2f)), X);
+        r[s.find("rKnee")] = glm::angleAxis(0.7f * std::max(0.f, -std::sin(phase * TAU + 1.2f)), X);
+        r[s.find("lAnkle")] = glm::angleAxis(0.2f * std::cos(phase * TAU), X);
+        r[s.find("rAnkle")] = glm::angleAxis(-0.2f * std::cos(phase * TAU), X);
+        // arms hang down and swing against the legs
+        r[s.find("lShoulder")] = glm::angleAxis(-1.3f, Z) * glm::angleAxis(0.4f * swing, Y);
+        r[s.find("rShoulder")] = glm::angleAxis(1.3f, Z) * glm::angleAxis(0.4f * swing, Y);
+        r[s.find("lElbow")] = glm::angleAxis(-0.3f - 0.2f * swing, Y);
+        r[s.find("rElbow")] = glm::angleAxis(0.3f - 0.2f * swing, Y);
+    }));
+    clips.push_back(sampleClip("wave", s, 2.f, [&](float phase, glm::quat *r, glm::vec3 &root) {
+        const float sway = std::sin(phase * TAU);
+        root.x += 0.04f * sway;
+        r[s.find("hips")] = glm::angleAxis(0.05f * sway, Z);
+        r[s.find("spine")] = glm::angleAxis(-0.08f * sway, Z);
+        r[s.find("head")] = glm::angleAxis(0.2f * std::sin(2.f * phase * TAU), Y) * glm::angleAxis(-0.1f, X);
+        r[s.find("lShoulder")] = glm::angleAxis(-1.3f, Z);
+        r[s.find("lElbow")] = glm::angleAxis(-0.2f, Y);
+        // the right arm up, the forearm waving
+        r[s.find("rShoulder")] = glm::angleAxis(-0.5f, Z);
+        r[s.find("rElbow")] = glm::angleAxis(-1.2f + 0.5f * std::sin(4.f * phase * TAU), Z);
+        r[s.find("rHand")] = glm::angleAxis(0.3f * std::sin(4.f * phase * TAU + 0.8f), Z);
+        r[s.find("lKnee")] = glm::angleAxis(0.1f + 0.05f * sway, X);
+        r[s.find("rKnee")] = glm::angleAxis(0.1f - 0.05f * sway, X);
+    }));
+    return clips;
+}
+
+struct CompressedClip {
+    const char *name;
+    int frames, bones;
+    float fps;
+    std::vector<uint32_t> trackBegin;   // first key of each bone
+    std::vector<uint16_t> keyFrame;
+    std::vector<PackedQuat> keys;
+    // [bone * (frames + 1) + frame]: the key starting the segment the frame is in, counted from trackBegin.
+    // the last frame points at the segment before it
+    std::vector<uint8_t> segment;
+    std::vector<glm::vec3> rootPositions;
+    float duration() const {
+        return frames / fps;
+    }
+    size_t bytes() const {
+        return trackBegin.size() * sizeof(uint32_t) + keyFrame.size() * sizeof(uint16_t) + keys.size() * sizeof(PackedQuat) +
+               segment.size() + rootPositions.size() * sizeof(glm::vec3);
+    }
+};
+
+// tolerance in radians. the segment table holds key numbers in a byte, so a clip has at most 255 frames.
+// longer ones are refused, they'd have to be split into several clips before they get here
+bool compressClip(const SourceClip &source, int bones, float tolerance, CompressedClip &clip) {
+    if (source.frames > 255) {
+        std::cerr << "ERROR::ANIMATION - clip " << source.name << " has more than 255 frames\n";
+        return false;
+    }
+    clip = CompressedClip();
+    clip.name = source.name;
+    clip.frames = source.frames;
+    clip.bones = bones;
+    clip.fps = source.fps;
+    clip.rootPositions = source.rootPositions;
+    clip.segment.resize(size_t(bones) * (source.frames + 1));
+    auto sourceAt = [&](int bone, int frame) { return source.rotations[size_t(frame) * bones + bone]; };
+    for (int b = 0; b < bones; ++b) {
+        std::vector<PackedQuat> packed(source.frames + 1);
+        for (int f = 0; f <= source.frames; ++f)
+            packed[f] = packQuat(sourceAt(b, f));
+        const uint32_t begin = uint32_t(clip.keys.size());
+        clip.trackBegin.push_back(begin);
+        int from = 0;
+        clip.keys.push_back(packed[0]);
+        clip.keyFrame.push_back(0);
+        while (from < source.frames) {
+            // the furthest key that still reproduces every frame in between
+            int to = from + 1;
+            for (int candidate = from + 2; candidate <= source.frames; ++candidate) {
+                glm::quat a = unpackQuat(packed[from]), c = unpackQuat(packed[candidate]);
+                bool fits = true;
+                for (int f = from + 1; f < candidate && fits; ++f)
+                    fits = angleBetween(nlerp(a, c, float(f - from) / (candidate - from)), sourceAt(b, f)) <= tolerance;
+                if (!fits)
+                    break;
+                to = candidate;
+            }
+            for (int f = from; f < to; ++f)
+                clip.segment[size_t(b) * (source.frames + 1) + f] = uint8_t(clip.keys.size() - 1 - begin);
+            clip.keys.push_back(packed[to]);
+            clip.keyFrame.push_back(uint16_t(to));
+            from = to;
+        }
+        clip.segment[size_t(b) * (source.frames + 1) + source.frames] = uint8_t(clip.keys.size() - 2 - begin);
+    }
+    return true;
+}
+
+
+// ---------------------------------------------------------------------------------------------------------
+// poses. a pose is the bones' local rotations as four arrays, one per component, so sampling and blending
+// work on 8 bones at a time, plus the root's position
+// ---------------------------------------------------------------------------------------------------------
+
+struct alignas(32) Pose {
+    float x[MAX_BONES], y[MAX_BONES], z[MAX_BONES], w[MAX_BONES];
+    glm::vec3 root;
+};
+
+// where the sampler is in a clip: the key pair and how far between them, for every bone
+struct SampleCursor {
+    int frame;
+    float frameFraction;
+};
+
+SampleCursor clipCursor(const CompressedClip &clip, float seconds) {
+    float frames = std::fmod(seconds * clip.fps, float(clip.frames));
+    if (frames < 0.f)
+        frames += clip.frames;
+    SampleCursor cursor;
+    cursor.frame = std::min(int(frames), clip.frames - 1);
+    cursor.frameFraction = frames - cursor.frame;
+    return cursor;
+}
+
+void sampleRoot(const CompressedClip &clip, const SampleCursor &cursor, Pose &pose) {
+    pose.root = glm::mix(clip.rootPositions[cursor.frame], clip.rootPositions[cursor.frame + 1], cursor.frameFraction);
+}
+
+void sampleClipScalar(const CompressedClip &clip, float seconds, Pose &pose) {
+    const SampleCursor cursor = clipCursor(clip, seconds);
+    const float at = cursor.frame + cursor.frameFraction;
+    for (int b = 0; b < clip.bones; ++b) {
+        const uint32_t k = clip.trackBegin[b] + clip.segment[size_t(b) * (clip.frames + 1) + cursor.frame];
+        const float t = (at - clip.keyFrame[k]) / float(clip.keyFrame[k + 1] - clip.keyFrame[k]);
+        glm::quat q = nlerp(unpackQuat(clip.keys[k]), unpackQuat(clip.keys[k + 1]), t);
+        pose.x[b] = q.x, pose.y[b] = q.y, pose.z[b] = q.z, pose.w[b] = q.w;
+    }
+    for (int b = clip.bones; b < MAX_BONES; ++b)
+        pose.x[b] = pose.y[b] = pose.z[b] = 0.f, pose.w[b] = 1.f;
+    sampleRoot(clip, cursor, pose);
+}
+
+// weight 0 is all of a, 1 all of b
+void blendPosesScalar(const Pose &a, const Pose &b, float weight, Pose &out) {
+    for (int i = 0; i < MAX_BONES; ++i) {
+        glm::quat q = nlerp(glm::quat(a.w[i], a.x[i], a.y[i], a.z[i]), glm::quat(b.w[i], b.x[i], b.y[i], b.z[i]), weight);
+        out.x[i] = q.x, out.y[i] = q.y, out.z[i] = q.z, out.w[i] = q.w;
+    }
+    out.root = glm::mix(a.root, b.root, weight);
+}
+
+
+#if defined(__x86_64__) || defined(__i386__)
+#define ANIMATION_KERNELS_X86 1
+
+// picks the rebuilt component or one of the three stored ones per lane, by the dropped index
+__attribute__((target("avx2,fma")))
+static inline void unpackQuats8(__m256i largest, __m256 a, __m256 b, __m256 c, __m256 &x, __m256 &y, __m256 &z, __m256 &w) {
+    const __m256 r = _mm256_sqrt_ps(_mm256_max_ps(_mm256_setzero_ps(),
+        _mm256_fnmadd_ps(c, c, _mm256_fnmadd_ps(b, b, _mm256_fnmadd_ps(a, a, _mm256_set1_ps(1.f))))));
+    const __m256 is0 = _mm256_castsi256_ps(_mm256_cmpeq_epi32(largest, _mm256_set1_epi32(0)));
+    const __m256 is1 = _mm256_castsi256_ps(_mm256_cmpeq_epi32(largest, _mm256_set1_epi32(1)));
+    const __m256 is2 = _mm256_castsi256_ps(_mm256_cmpeq_epi32(largest, _mm256_set1_epi32(2)));
+    const __m256 is3 = _mm256_castsi256_ps(_mm256_cmpeq_epi32(largest, _mm256_set1_epi32(3)));
+    x = _mm256_blendv_ps(a, r, is0);
+    y = _mm256_blendv_ps(_mm256_blendv_ps(b, a, is0), r, is1);
+    z = _mm256_blendv_ps(_mm256_blendv_ps(c, b, _mm256_or_ps(is0, is1)), r, is2);
+    w = _mm256_blendv_ps(c, r, is3);
+}
+
+// out = normalize(a * (1 - t) + b * t), b flipped where it's on the other side
+__attribute__((target("avx2,fma")))
+static inline void nlerp8(__m256 ax, __m256 ay, __m256 az, __m256 aw, __m256 bx, __m256 by, __m256 bz, __m256 bw, __m256 t,
+                          float *ox, float *oy, float *oz, float *ow) {
+    const __m256 d = _mm256_fmadd_ps(aw, bw, _mm256_fmadd_ps(az, bz, _mm256_fmadd_ps(ay, by, _mm256_mul_ps(ax, bx))));
+    // the sign of the dot product onto t flips b
+    const __m256 tb = _mm256_xor_ps(t, _mm256_and_ps(d, _mm256_set1_ps(-0.f)));
+    const __m256 ta = _mm256_sub_ps(_mm256_set1_ps(1.f), t);
+    const __m256 x = _mm256_fmadd_ps(bx, tb, _mm256_mul_ps(ax, ta)), y = _mm256_fmadd_ps(by, tb, _mm256_mul_ps(ay, ta));
+    const __m256 z = _mm256_fmadd_ps(bz, tb, _mm256_mul_ps(az, ta)), w = _mm256_fmadd_ps(bw, tb, _mm256_mul_ps(aw, ta));
+    const __m256 length = _mm256_sqrt_ps(_mm256_fmadd_ps(w, w, _mm256_fmadd_ps(z, z, _mm256_fmadd_ps(y, y, _mm256_mul_ps(x, x)))));
+    _mm256_store_ps(ox, _mm256_div_ps(x, length));
+    _mm256_store_ps(oy, _mm256_div_ps(y, length));
+    _mm256_store_ps(oz, _mm256_div_ps(z, length));
+    _mm256_store_ps(ow, _mm256_div_ps(w, length));
+}
+
+// the keys are found per bone, the same way as the scalar sampler, and copied into lanes. the unpacking
+// and interpolation are then done for 8 bones at once
+__attribute__((target("avx2,fma")))
+void sampleClipAvx2(const CompressedClip &clip, float seconds, Pose &pose) {
+    const SampleCursor cursor = clipCursor(clip, seconds);
+    const float at = cursor.frame + cursor.frameFraction;
+    alignas(32) int32_t raw[2][3][MAX_BONES];
+    alignas(32) float t[MAX_BONES];
+    for (int b = 0; b < MAX_BONES; ++b) {
+        if (b < clip.bones) {
+            const uint32_t k = clip.trackBegin[b] + clip.segment[size_t(b) * (clip.frames + 1) + cursor.frame];
+            for (int key = 0; key < 2; ++key)
+                for (int i = 0; i < 3; ++i)
+                    raw[key][i][b] = clip.keys[k + key].v[i];
+            t[b] = (at - clip.keyFrame[k]) / float(clip.keyFrame[k + 1] - clip.keyFrame[k]);
+        } else {
+            // identity: w is the dropped one, index 3
+            for (int key = 0; key < 2; ++key) {
+                raw[key][0][b] = raw[key][1][b] = 1;
+                raw[key][2][b] = 0;
+            }
+            t[b] = 0.f;
+        }
+    }
+    const __m256 quantum = _mm256_set1_ps(QUAT_QUANTUM);
+    const __m256i one = _mm256_set1_epi32(1);
+    for (int b = 0; b < MAX_BONES; b += 8) {
+        __m256 q[2][4];
+        for (int key = 0; key < 2; ++key) {
+            const __m256i v0 = _mm256_load_si256(reinterpret_cast<const __m256i*>(&raw[key][0][b]));
+            const __m256i v1 = _mm256_load_si256(reinterpret_cast<const __m256i*>(&raw[key][1][b]));
+            const __m256i v2 = _mm256_load_si256(reinterpret_cast<const __m256i*>(&raw[key][2][b]));
+            const __m256i largest = _mm256_or_si256(_mm256_and_si256(v0, one), _mm256_slli_epi32(_mm256_and_si256(v1, one), 1));
+            const __m256 a = _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_srai_epi32(v0, 1)), quantum);
+            const __m256 bb = _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_srai_epi32(v1, 1)), quantum);
+            const __m256 c = _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_srai_epi32(v2, 1)), quantum);
+            unpackQuats8(largest, a, bb, c, q[key][0], q[key][1], q[key][2], q[key][3]);
+        }
+        nlerp8(q[0][0], q[0][1], q[0][2], q[0][3], q[1][0], q[1][1], q[1][2], q[1][3], _mm256_load_ps(t + b),
+               pose.x + b, pose.y + b, pose.z + b, pose.w + b);
+    }
+    _mm256_zeroupper();
+    sampleRoot(clip, cursor, pose);
+}
+
+__attribute__((target("avx2,fma")))
+void blendPosesAvx2(const Pose &a, const Pose &b, float weight, Pose &out) {
+    const __m256 t = _mm256_set1_ps(weight);
+    for (int i = 0; i < MAX_BONES; i += 8)
+        nlerp8(_mm256_load_ps(a.x + i), _mm256_load_ps(a.y + i), _mm256_load_ps(a.z + i), _mm256_load_ps(a.w + i),
+               _mm256_load_ps(b.x + i), _mm256_load_ps(b.y + i), _mm256_load_ps(b.z + i), _mm256_load_ps(b.w + i), t,
+               out.x + i, out.y + i, out.z + i, out.w + i);
+    _mm256_zeroupper();
+    out.root = glm::mix(a.root, b.root, weight);
+}
+#endif
+
+struct AnimationKernels {
+    void (*sample)(const CompressedClip &clip, float seconds, Pose &pose) = sampleClipScalar;
+    void (*blend)(const Pose &a, const Pose &b, float weight, Pose &out) = blendPosesScalar;
+    std::string name = "scalar";
+};
+
+AnimationKernels bestAnimationKernels() {
+    AnimationKernels kernels;
+#ifdef ANIMATION_KERNELS_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) {
+        kernels.sample = sampleClipAvx2;
+        kernels.blend = blendPosesAvx2;
+        kernels.name = "avx2";
+    }
+#endif
+    return kernels;
+}
+
+
+// ---------------------------------------------------------------------------------------------------------
+// the skinned mesh: a tube along every bone, from its parent's joint to its own. a vertex follows the
+// parent bone, and near the joint it blends over to the bone itself so the elbows and knees bend smoothly
+// ---------------------------------------------------------------------------------------------------------
+
+struct SkinnedVertex {
+    glm::vec3 position, normal;
+    glm::vec2 texCoord;
+    uint8_t bones[4];
+    float weights[4];
+};
+
+struct SkinnedMesh {
+    std::vector<SkinnedVertex> vertices;
+    std::vector<uint32_t> indices;
+};
+
+SkinnedMesh buildMesh(const Skeleton &s) {
+    SkinnedMesh mesh;
+    const int SIDES = 10, RINGS = 6;
+    for (int b = 1; b < s.size(); ++b) {
+        const int p = s.parent[b];
+        const glm::vec3 from = s.bindPosition[p], to = s.bindPosition[b], along = to - from;
+        const float length = glm::length(along);
+        const glm::vec3 dir = along / length;
+        // some vector that isn't along the bone to build the ring around
+        const glm::vec3 side = std::fabs(dir.y) < 0.9f ? glm::normalize(glm::cross(dir, glm::vec3(0.f, 1.f, 0.f)))
+                                                       : glm::normalize(glm::cross(dir, glm::vec3(1.f, 0.f, 0.f)));
+        const glm::vec3 up = glm::cross(side, dir);
+        const std::string name = s.name[b];
+        float radius = 0.05f;
+        if (name == "spine" || name == "chest")
+            radius = 0.13f;
+        else if (name == "headTop")
+            radius = 0.11f;
+        else if (name == "lHip" || name == "rHip")
+            radius = 0.08f;
+        else if (name == "neck" || name == "head" || name == "lShoulder" || name == "rShoulder" || name == "lKnee" || name == "rKnee")
+            radius = 0.065f;
+        const uint32_t first = uint32_t(mesh.vertices.size());
+        for (int r = 0; r <= RINGS; ++r) {
+            const float t = float(r) / RINGS;
+            // thinner at the ends so the tubes tuck into each other
+            const float ringRadius = radius * (0.75f + 0.25f * std::sin(t * glm::pi<float>()));
+            const float toChild = std::max(0.f, (t - 0.7f) / 0.3f) * 0.5f;
+            for (int a = 0; a <= SIDES; ++a) {
+                const float angle = 2.f * glm::pi<float>() * a / SIDES;
+                const glm::vec3 normal = side * std::cos(angle) + up * std::sin(angle);
+                SkinnedVertex v;
+                v.position = from + along * t + normal * ringRadius;
+                v.normal = normal;
+                v.texCoord = glm::vec2(float(a) / SIDES, t);
+                v.bones[0] = uint8_t(p), v.bones[1] = uint8_t(b), v.bones[2] = v.bones[3] = 0;
+                v.weights[0] = 1.f - toChild, v.weights[1] = toChild, v.weights[2] = v.weights[3] = 0.f;
+                mesh.vertices.push_back(v);
+            }
+        }
+        for (int r = 0; r < RINGS; ++r) {
+            for (int a = 0; a < SIDES; ++a) {
+                uint32_t i0 = first + r * (SIDES + 1) + a, i1 = i0 + SIDES + 1;
+                uint32_t quad[6] = {i0, i0 + 1, i1, i1, i0 + 1, i1 + 1};
+                mesh.indices.insert(mesh.indices.end(), quad, quad + 6);
+            }
+        }
+    }
+    return mesh;
+}
+
+
+// ---------------------------------------------------------------------------------------------------------
+// the crowd. a frame goes through stages, each a parallel loop over the characters:
+// sample both clips, blend them, go down the hierarchy to model space, and make the skinning palette:
+// model space times the inverse bind pose times where the character stands, as 3 rows of 4 floats a bone.
+// the vertex shader skins with the palettes from a texture buffer, or the CPU does it into a vertex buffer
+// ---------------------------------------------------------------------------------------------------------
+
+struct CrowdTimings {
+    double sample = 0., blend = 0., hierarchy = 0., palette = 0., skin = 0.;
+    void add(const CrowdTimings &t) {
+        sample += t.sample, blend += t.blend, hierarchy += t.hierarchy, palette += t.palette, skin += t.skin;
+    }
+};
+
+// 3 rows of a 4x4 matrix, the last row is always 0 0 0 1
+struct PaletteEntry {
+    glm::vec4 rows[3];
+};
+
+class Crowd {
+    const Skeleton &skeleton;
+    const std::vector<CompressedClip> &clips;
+    AnimationKernels kernels;
+    std::vector<glm::vec3> positions;
+    std::vector<float> phase, speed;
+    std::vector<Pose> walk, wave, local;
+    std::vector<glm::quat> modelRotation;
+    std::vector<glm::vec3> modelPosition;
+    std::vector<PaletteEntry> palettes;
+    static constexpr size_t CHUNK = 16;
+public:
+    Crowd(const Skeleton &skeleton, const std::vector<CompressedClip> &clips, size_t count, AnimationKernels kernels)
+        : skeleton(skeleton), clips(clips), kernels(std::move(kernels)) {
+        const int side = int(std::ceil(std::sqrt(float(count))));
+        std::mt19937 rng(7);
+        std::uniform_real_distribution<float> unit(0.f, 1.f);
+        for (size_t i = 0; i < count; ++i) {
+            positions.push_back(glm::vec3((int(i % side) - side / 2) * 1.5f, 0.f, -float(i / side) * 1.5f));
+            phase.push_back(unit(rng) * 10.f);
+            speed.push_back(0.8f + 0.4f * unit(rng));
+        }
+        walk.resize(count);
+        wave.resize(count);
+        local.resize(count);
+        modelRotation.resize(count * MAX_BONES);
+        modelPosition.resize(count * MAX_BONES);
+        palettes.resize(count * skeleton.size());
+    }
+    size_t size() const {
+        return positions.size();
+    }
+    const char *kernelName() const {
+        return kernels.name.c_str();
+    }
+    const PaletteEntry *palette(size_t character) const {
+        return &palettes[character * skeleton.size()];
+    }
+    size_t paletteBytes() const {
+        return palettes.size() * sizeof(PaletteEntry);
+    }
+
+    CrowdTimings animate(float seconds, WorkerPool &pool) {
+        CrowdTimings timings;
+        auto now = [] { return std::chrono::steady_clock::now(); };
+        auto ms = [](auto from, auto to) { return std::chrono::duration<double, std::milli>(to - from).count(); };
+        const int bones = skeleton.size();
+
+        auto start = now();
+        pool.parallelFor(size(), CHUNK, [&](size_t begin, size_t end) {
+            for (size_t c = begin; c < end; ++c) {
+                float t = seconds * speed[c] + phase[c];
+                kernels.sample(clips[0], t, walk[c]);
+                kernels.sample(clips[1], t, wave[c]);
+            }
+        });
+        auto sampled = now();
+        pool.parallelFor(size(), CHUNK, [&](size_t begin, size_t end) {
+            for (size_t c = begin; c < end; ++c) {
+                // every character drifts between the two at its own pace
+                float weight = 0.5f + 0.5f * std::sin(seconds * 0.7f * speed[c] + phase[c]);
+                kernels.blend(walk[c], wave[c], weight, local[c]);
+            }
+        });
+        auto blended = now();
+        pool.parallelFor(size(), CHUNK, [&](size_t begin, size_t end) {
+            for (size_t c = begin; c < end; ++c) {
+                const Pose &pose = local[c];
+                glm::quat *rotation = &modelRotation[c * MAX_BONES];
+                glm::vec3 *position = &modelPosition[c * MAX_BONES];
+                for (int b = 0; b < bones; ++b) {
+                    glm::quat q(pose.w[b], pose.x[b], pose.y[b], pose.z[b]);
+                    int p = skeleton.parent[b];
+                    if (p < 0) {
+                        rotation[b] = q;
+                        position[b] = pose.root;
+                    } else {
+                        rotation[b] = rotation[p] * q;
+                        position[b] = position[p] + rotation[p] * skeleton.offset[b];
+                    }
+                }
+            }
+        });
+        auto walked = now();
+        pool.parallelFor(size(), CHUNK, [&](size_t begin, size_t end) {
+            for (size_t c = begin; c < end; ++c) {
+                const glm::quat *rotation = &modelRotation[c * MAX_BONES];
+                const glm::vec3 *position = &modelPosition[c * MAX_BONES];
+                PaletteEntry *out = &palettes[c * bones];
+                for (int b = 0; b < bones; ++b) {
+                    // [R | p - R * bind] moved to where the character stands
+                    glm::mat3 r = glm::mat3_cast(rotation[b]);
+                    glm::vec3 t = position[b] - r * skeleton.bindPosition[b] + positions[c];
+                    for (int row = 0; row < 3; ++row)
+                        out[b].rows[row] = glm::vec4(r[0][row], r[1][row], r[2][row], t[row]);
+                }
+            }
+        });
+        auto paletted = now();
+        timings.sample = ms(start, sampled);
+        timings.blend = ms(sampled, blended);
+        timings.hierarchy = ms(blended, walked);
+        timings.palette = ms(walked, paletted);
+        return timings;
+    }
+
+    // the software fallback: positions and normals for every character, one after the other
+    double skin(const SkinnedMesh &mesh, std::vector<glm::vec3> &out, WorkerPool &pool) const {
+        auto start = std::chrono::steady_clock::now();
+        const size_t vertexCount = mesh.vertices.size();
+        out.resize(size() * vertexCount * 2);
+        pool.parallelFor(size(), CHUNK, [&](size_t begin, size_t end) {
+            for (size_t c = begin; c < end; ++c) {
+                const PaletteEntry *bones = palette(c);
+                glm::vec3 *dst = &out[c * vertexCount * 2];
+                for (size_t i = 0; i < vertexCount; ++i) {
+                    const SkinnedVertex &v = mesh.vertices[i];
+                    // the weighted sum of the bones' matrices, as 12 plain floats the compiler can vectorize.
+                    // unused influences have weight 0 and point at bone 0, adding them costs less than a branch
+                    float m[12];
+                    const float *b0 = &bones[v.bones[0]].rows[0].x, *b1 = &bones[v.bones[1]].rows[0].x;
+                    const float *b2 = &bones[v.bones[2]].rows[0].x, *b3 = &bones[v.bones[3]].rows[0].x;
+                    for (int j = 0; j < 12; ++j)
+                        m[j] = b0[j] * v.weights[0] + b1[j] * v.weights[1] + b2[j] * v.weights[2] + b3[j] * v.weights[3];
+                    const glm::vec3 &p = v.position, &n = v.normal;
+                    dst[i * 2] = glm::vec3(m[0] * p.x + m[1] * p.y + m[2] * p.z + m[3], m[4] * p.x + m[5] * p.y + m[6] * p.z + m[7],
+                                           m[8] * p.x + m[9] * p.y + m[10] * p.z + m[11]);
+                    dst[i * 2 + 1] = glm::vec3(m[0] * n.x + m[1] * n.y + m[2] * n.z, m[4] * n.x + m[5] * n.y + m[6] * n.z,
+                                               m[8] * n.x + m[9] * n.y + m[10] * n.z);
+                }
+            }
+        });
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+};
+
+
+// --bench: how much the compression keeps, how close it stays to the source, and what every stage costs
+// for a crowd, the SIMD kernels against the scalar ones
+int runBench(size_t characters, int frames) {
+    const Skeleton skeleton = buildSkeleton();
+    const std::vector<SourceClip> sources = buildClips(skeleton);
+    const float tolerance = glm::radians(0.5f);
+    std::vector<CompressedClip> clips;
+    for (const SourceClip &source : sources) {
+        auto start = std::chrono::steady_clock::now();
+        clips.emplace_back();
+        if (!compressClip(source, skeleton.size(), tolerance, clips.back()))
+            return EXIT_FAILURE;
+        const CompressedClip &clip = clips.back();
+        double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        // checked at frames and halfway between them
+        float worst = 0.f;
+        Pose pose;
+        for (int half = 0; half < clip.frames * 2; ++half) {
+            sampleClipScalar(clip, half * 0.5f / clip.fps, pose);
+            int f = half / 2;
+            for (int b = 0; b < skeleton.size(); ++b) {
+                glm::quat want = source.rotations[size_t(f) * skeleton.size() + b];
+                if (half & 1)
+                    want = nlerp(want, source.rotations[size_t(f + 1) * skeleton.size() + b], 0.5f);
+                worst = std::max(worst, angleBetween(glm::quat(pose.w[b], pose.x[b], pose.y[b], pose.z[b]), want));
+            }
+        }
+        const size_t rawBytes = source.rotations.size() * sizeof(glm::quat) + source.rootPositions.size() * sizeof(glm::vec3);
+        std::printf("%-5s %3d frames: %4zu of %5zu keys kept, %6zu bytes from %6zu (%.1fx), worst error %.3f degrees, compressed in %.2f ms\n",
+                    clip.name, clip.frames, clip.keys.size(), source.rotations.size(), clip.bytes(), rawBytes,
+                    double(rawBytes) / clip.bytes(), glm::degrees(worst), ms);
+    }
+
+    const AnimationKernels simd = bestAnimationKernels();
+    {
+        Pose a, b, blendA, blendB;
+        float worst = 0.f;
+        for (int i = 0; i < 1000; ++i) {
+            float t = i * 0.0173f;
+            sampleClipScalar(clips[i & 1], t, a);
+            simd.sample(clips[i & 1], t, b);
+            blendPosesScalar(a, b, 0.3f, blendA);
+            simd.blend(a, b, 0.3f, blendB);
+            for (int k = 0; k < MAX_BONES; ++k) {
+                worst = std::max({worst, std::fabs(a.x[k] - b.x[k]), std::fabs(a.y[k] - b.y[k]), std::fabs(a.z[k] - b.z[k]), std::fabs(a.w[k] - b.w[k])});
+                worst = std::max({worst, std::fabs(blendA.x[k] - blendB.x[k]), std::fabs(blendA.w[k] - blendB.w[k])});
+            }
+        }
+        std::printf("%s sampling and blending against scalar: largest difference %g\n", simd.name.c_str(), worst);
+        if (worst > 1e-4f) {
+            std::cerr << "ERROR::ANIMATION - the " << simd.name << " kernels don't match the scalar ones\n";
+            return EXIT_FAILURE;
+        }
+    }
+
+    const SkinnedMesh mesh = buildMesh(skeleton);
+    std::printf("%zu characters, %d bones, %zu vertices each\n", characters, skeleton.size(), mesh.vertices.size());
+    const unsigned all = std::max(1u, std::thread::hardware_concurrency());
+    struct Run {
+        bool simd;
+        unsigned threads;
+    };
+    std::vector<Run> runs = {{false, 1}, {true, 1}};
+    if (all > 1)
+        runs.insert(runs.end(), {{false, all}, {true, all}});
+    std::vector<glm::vec3> skinned;
+    for (const Run &run : runs) {
+        WorkerPool pool(run.threads);
+        Crowd crowd(skeleton, clips, characters, run.simd ? simd : AnimationKernels());
+        CrowdTimings total;
+        for (int frame = 0; frame < frames; ++frame) {
+            CrowdTimings t = crowd.animate(frame / 60.f, pool);
+            t.skin = crowd.skin(mesh, skinned, pool);
+            total.add(t);
+        }
+        std::printf("%-6s %2u threads: sample %.3f ms, blend %.3f ms, hierarchy %.3f ms, palette %.3f ms, "
+                    "%.3f ms for the GPU path; CPU skinning %.3f ms more\n",
+                    crowd.kernelName(), run.threads, total.sample / frames, total.blend / frames, total.hierarchy / frames,
+                    total.palette / frames, (total.sample + total.blend + total.hierarchy + total.palette) / frames, total.skin / frames);
+    }
+    return EXIT_SUCCESS;
+}
+
+
+void processInput(GLFWwindow *window, glm::vec3 &cameraPos, glm::vec3 &cameraFront, glm::vec3 &cameraUp)
+{
+
+    const float cameraSpeed = 0.05f; // adjust accordingly
+    if (glfwGetKey(window, GLFW_KEY_W) == GLFW_PRESS)
+        cameraPos += cameraSpeed * cameraFront;
+    if (glfwGetKey(window, GLFW_KEY_S) == GLFW_PRESS)
+        cameraPos -= cameraSpeed * cameraFront;
+    if (glfwGetKey(window, GLFW_KEY_A) == GLFW_PRESS)
+        cameraPos -= glm::normalize(glm::cross(cameraFront, cameraUp)) * cameraSpeed;
+    if (glfwGetKey(window, GLFW_KEY_D) == GLFW_PRESS)
+        cameraPos += glm::normalize(glm::cross(cameraFront, cameraUp)) * cameraSpeed;
+    if (glfwGetKey(window, GLFW_KEY_UP) == GLFW_PRESS)
+        cameraPos += glm::normalize(glm::cross(cameraFront, cameraUp)) * cameraSpeed;
+
+}
+
+// true only on the frame the key went down
+bool keyPressed(GLFWwindow *window, int key) {
+    static bool down[GLFW_KEY_LAST + 1] = {};
+    bool now = glfwGetKey(window, key) == GLFW_PRESS;
+    bool pressed = now && !down[key];
+    down[key] = now;
+    return pressed;
+}
+
+
+float yaw = -90.f;
+float pitch = 0.f;
+glm::vec3 cameraFront;
+
+void mouseMovement(GLFWwindow *window, double xPos, double yPos) {
+    static float lastX = xPos, lastY = yPos;
+    float xOffset = xPos - lastX;
+    float yOffset = lastY - yPos;
+    
+    constexpr float sensitivity = 0.05f;
+    xOffset *= sensitivity;
+    yOffset *= sensitivity;
+
+    yaw += xOffset;
+    pitch += yOffset;
+
+    if (std::abs(pitch) > 89.f) // don't ever do it this way. I am lazy
+        pitch = std::abs(pitch) / pitch * 89.f;
+
+    cameraFront.x = cos(glm::radians(yaw)) * cos(glm::radians(pitch));
+    cameraFront.y = sin(glm::radians(pitch));
+    cameraFront.z = sin(glm::radians(yaw)) * cos(glm::radians(pitch));
+
+    cameraFront = glm::normalize(cameraFront);
+    lastX = xPos, lastY = yPos;
+}
+
+
+int main(int argc, char **argv) {
+    size_t characters = 1000;
+    bool cpuSkinning = false, scalar = false;
+    for (int i = 1; i < argc; ++i) {
+        if (!std::strcmp(argv[i], "--bench"))
+            return runBench(i + 1 < argc ? size_t(std::max(1, std::atoi(argv[i + 1]))) : characters, 300);
+        if (!std::strcmp(argv[i], "--characters") && i + 1 < argc)
+            characters = size_t(std::max(1, std::atoi(argv[++i])));
+        else if (!std::strcmp(argv[i], "--cpu-skinning"))
+            cpuSkinning = true;
+        else if (!std::strcmp(argv[i], "--scalar"))
+            scalar = true;
+    }
+
+    if (glfwInit() != GLFW_TRUE) {
+        glfwTerminate();
+        std::cerr << "Failed to initialize GLFW";
+        return EXIT_FAILURE;
+    }
+    // setting OpenGL version to 3.3
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+    GLFWwindow *win = glfwCreateWindow(800, 600, "This is a hello window!", NULL, NULL);
+    // setting 'context' for OpenGL, i.e. where to draw on current thread
+    glfwMakeContextCurrent(win);
+    // all it does is fetches us the implemented functions of OpenGL
+    if (glewInit() != GLEW_OK) {
+        glfwTerminate();
+        std::cerr << "Failed to initialize GLEW\n";
+        return EXIT_FAILURE;
+    }
+    int screenWidth, screenHeight;
+    glfwGetFramebufferSize(win, &screenWidth, &screenHeight);
+    glViewport(0, 0, screenWidth, screenHeight);
+
+    glEnable(GL_DEPTH_TEST);
+    glm::vec3 cameraPos(0.f, 0.f, 3.f);
+    cameraFront = glm::vec3(0.f,0.f,-1.f);
+    glm::vec3 cameraUp(0.,1.,0.f);
+
+    Texture2D tex;
+    tex.generate2DTex("./image2d.tex");
+    tex.bind();
+
+    const Skeleton skeleton = buildSkeleton();
+    std::vector<CompressedClip> clips;
+    for (const SourceClip &source : buildClips(skeleton)) {
+        clips.emplace_back();
+        if (!compressClip(source, skeleton.size(), glm::radians(0.5f), clips.back())) {
+            glfwTerminate();
+            return EXIT_FAILURE;
+        }
+    }
+    const SkinnedMesh mesh = buildMesh(skeleton);
+    WorkerPool pool;
+    Crowd crowd(skeleton, clips, characters, scalar ? AnimationKernels() : bestAnimationKernels());
+    const size_t vertexCount = mesh.vertices.size();
+    std::cout << characters << " characters of " << vertexCount << " vertices, " << crowd.kernelName() << " kernels on "
+              << pool.size() << " threads\n";
+
+    // GPU skinning: the mesh once, drawn once per character with instancing, the palettes in a texture buffer
+    GLuint skinVao = 0, meshVbo = 0, meshEbo = 0;
+    glGenVertexArrays(1, &skinVao);
+    glBindVertexArray(skinVao);
+    glGenBuffers(1, &meshVbo); 
+    glBindBuffer(GL_ARRAY_BUFFER, meshVbo);
+    glBufferData(GL_ARRAY_BUFFER, vertexCount * sizeof(SkinnedVertex), mesh.vertices.data(), GL_STATIC_DRAW);
+    glGenBuffers(1, &meshEbo);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, meshEbo);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, mesh.indices.size() * sizeof(uint32_t), mesh.indices.data(), GL_STATIC_DRAW);
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(SkinnedVertex), (void*)offsetof(SkinnedVertex, position));
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, sizeof(SkinnedVertex), (void*)offsetof(SkinnedVertex, texCoord));
+    glEnableVertexAttribArray(1);
+    glVertexAttribPointer(2, 3, GL_FLOAT, GL_FALSE, sizeof(SkinnedVertex), (void*)offsetof(SkinnedVertex, normal));
+    glEnableVertexAttribArray(2);
+    // bone numbers stay integers
+    glVertexAttribIPointer(3, 4, GL_UNSIGNED_BYTE, sizeof(SkinnedVertex), (void*)offsetof(SkinnedVertex, bones));
+    glEnableVertexAttribArray(3);
+    glVertexAttribPointer(4, 4, GL_FLOAT, GL_FALSE, sizeof(SkinnedVertex), (void*)offsetof(SkinnedVertex, weights));
+    glEnableVertexAttribArray(4);
+
+    GLuint paletteTbo = 0, paletteTex = 0;
+    glGenBuffers(1, &paletteTbo);
+    glBindBuffer(GL_TEXTURE_BUFFER, paletteTbo);
+    glBufferData(GL_TEXTURE_BUFFER, crowd.paletteBytes(), NULL, GL_STREAM_DRAW);
+    glGenTextures(1, &paletteTex);
+    glBindTexture(GL_TEXTURE_BUFFER, paletteTex);
+    glTexBuffer(GL_TEXTURE_BUFFER, GL_RGBA32F, paletteTbo);
+
+    // CPU skinning: every character's skinned vertices in one buffer, and the indices repeated for each
+    // so they're all one draw as well
+    GLuint cpuVao = 0, cpuVbo = 0, texCoordVbo = 0, cpuEbo = 0;
+    glGenVertexArrays(1, &cpuVao);
+    glBindVertexArray(cpuVao);
+    glGenBuffers(1, &cpuVbo);
+    glBindBuffer(GL_ARRAY_BUFFER, cpuVbo);
+    glBufferData(GL_ARRAY_BUFFER, characters * vertexCount * 2 * sizeof(glm::vec3), NULL, GL_STREAM_DRAW);
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 2 * sizeof(glm::vec3), (void*)0);
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(2, 3, GL_FLOAT, GL_FALSE, 2 * sizeof(glm::vec3), (void*)sizeof(glm::vec3));
+    glEnableVertexAttribArray(2);
+    {
+        std::vector<glm::vec2> texCoords(characters * vertexCount);
+        std::vector<uint32_t> indices(characters * mesh.indices.size());
+        for (size_t c = 0; c < characters; ++c) {
+            for (size_t i = 0; i < vertexCount; ++i)
+                texCoords[c * vertexCount + i] = mesh.vertices[i].texCoord;
+            for (size_t i = 0; i < mesh.indices.size(); ++i)
+                indices[c * mesh.indices.size() + i] = uint32_t(c * vertexCount + mesh.indices[i]);
+        }
+        glGenBuffers(1, &texCoordVbo);
+        glBindBuffer(GL_ARRAY_BUFFER, texCoordVbo);
+        glBufferData(GL_ARRAY_BUFFER, texCoords.size() * sizeof(glm::vec2), texCoords.data(), GL_STATIC_DRAW);
+        glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, sizeof(glm::vec2), (void*)0);
+        glEnableVertexAttribArray(1);
+        glGenBuffers(1, &cpuEbo);
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, cpuEbo);
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(uint32_t), indices.data(), GL_STATIC_DRAW);
+    }
+    glBindVertexArray(0);
+
+    VertexShader skinVs, vs;
+    FragmentShader fs;
+    skinVs.setSource("./skin_vertex.glsl");
+    vs.setSource("./vertex.glsl");
+    fs.setSource("./frag.glsl");
+    Program skinProg, prog;
+    skinProg.AttachShaders({&skinVs, &fs});
+    prog.AttachShaders({&vs, &fs});
+
+    skinProg.UseProgram();
+    skinProg.setInt("tex", 0);
+    skinProg.setInt("palettes", 1);
+    skinProg.setInt("bonesPerCharacter", skeleton.size());
+    prog.UseProgram();
+    prog.setInt("tex", 0);
+
+    cameraPos = glm::vec3(0.f, 3.f, 8.f);
+    std::vector<glm::vec3> skinned;
+
+    glfwSetCursorPosCallback(win, mouseMovement); 
+    glfwSetInputMode(win, GLFW_CURSOR, GLFW_CURSOR_DISABLED);  
+
+    std::cout << "C: switch between skinning on the GPU and on the CPU\n";
+    double lastReport = glfwGetTime(), uploadMs = 0.;
+    CrowdTimings total;
+    size_t frames = 0;
+    
+    while (!glfwWindowShouldClose(win)) {
+        processInput(win, cameraPos, cameraFront, cameraUp);
+        if (keyPressed(win, GLFW_KEY_C))
+            cpuSkinning = !cpuSkinning;
+
+        CrowdTimings t = crowd.animate(float(glfwGetTime()), pool);
+        auto uploadStart = std::chrono::steady_clock::now();
+        if (cpuSkinning) {
+            t.skin = crowd.skin(mesh, skinned, pool);
+            uploadStart = std::chrono::steady_clock::now();
+            glBindBuffer(GL_ARRAY_BUFFER, cpuVbo);
+            glBufferData(GL_ARRAY_BUFFER, skinned.size() * sizeof(glm::vec3), NULL, GL_STREAM_DRAW);
+            glBufferSubData(GL_ARRAY_BUFFER, 0, skinned.size() * sizeof(glm::vec3), skinned.data());
+        } else {
+            glBindBuffer(GL_TEXTURE_BUFFER, paletteTbo);
+            glBufferData(GL_TEXTURE_BUFFER, crowd.paletteBytes(), NULL, GL_STREAM_DRAW);
+            glBufferSubData(GL_TEXTURE_BUFFER, 0, crowd.paletteBytes(), crowd.palette(0));
+        }
+        uploadMs += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - uploadStart).count();
+        total.add(t);
+
+        glm::mat4 view = glm::lookAt(cameraPos, cameraPos + cameraFront, cameraUp);
+        glfwGetFramebufferSize(win, &screenWidth, &screenHeight);
+        glm::mat4 proj = glm::perspective(glm::radians(45.f), screenHeight > 0 ? float(screenWidth) / screenHeight : 1.f, 0.1f, 300.f);
+
+        glViewport(0, 0, screenWidth, screenHeight);
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+        glActiveTexture(GL_TEXTURE0);
+        tex.bind();
+        if (cpuSkinning) {
+            prog.UseProgram();
+            prog.setMat4("view", view);
+            prog.setMat4("proj", proj);
+            glBindVertexArray(cpuVao);
+            glDrawElements(GL_TRIANGLES, GLsizei(characters * mesh.indices.size()), GL_UNSIGNED_INT, 0);
+        } else {
+            skinProg.UseProgram();
+            skinProg.setMat4("view", view);
+            skinProg.setMat4("proj", proj);
+            glActiveTexture(GL_TEXTURE1);
+            glBindTexture(GL_TEXTURE_BUFFER, paletteTex);
+            glActiveTexture(GL_TEXTURE0);
+            glBindVertexArray(skinVao);
+            glDrawElementsInstanced(GL_TRIANGLES, GLsizei(mesh.indices.size()), GL_UNSIGNED_INT, 0, GLsizei(characters));
+        }
+
+        // polls different kinds of events, for example, when we close an application, it fetches that event
+        // or it fetches events like movement of the window.
+        // Without it you can neither move the window or close the window
+        glfwPollEvents();
+        // have you drawn the image, it is stored in the buffer. You can now swap this buffer with main buffer
+        // so the image appears
+        glfwSwapBuffers(win);
+
+        ++frames;
+        if (glfwGetTime() - lastReport > 1.) {
+            lastReport = glfwGetTime();
+            std::printf("%s skinning: sample %.3fms, blend %.3fms, hierarchy %.3fms, palette %.3fms, skin %.3fms, upload %.3fms\n",
+                        cpuSkinning ? "CPU" : "GPU", total.sample / frames, total.blend / frames, total.hierarchy / frames,
+                        total.palette / frames, total.skin / frames, uploadMs / frames);
+            total = CrowdTimings();
+            uploadMs = 0.;
+            frames = 0;
+        }
+    }
+    glDeleteTextures(1, &paletteTex);
+    glDeleteBuffers(1, &paletteTbo);
+    glDeleteBuffers(1, &cpuEbo);
+    glDeleteBuffers(1, &texCoordVbo);
+    glDeleteBuffers(1, &cpuVbo);
+    glDeleteBuffers(1, &meshEbo);
+    glDeleteBuffers(1, &meshVbo);
+    glDeleteVertexArrays(1, &cpuVao);
+    glDeleteVertexArrays(1, &skinVao);
+    glfwTerminate();
+    
+    std::cout << "Window should close now!\n";
+
+    return EXIT_SUCCESS;
+
+}
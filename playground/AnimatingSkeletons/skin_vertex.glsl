@@ -0,0 +1,35 @@
+#version 330 core
+
+layout(location = 0) in vec3 aPos;
+layout(location = 1) in vec2 aTexCoord;
+layout(location = 2) in vec3 aNormal;
+// up to four bones per vertex, unused ones have a weight of 0
+layout(location = 3) in uvec4 aBones;
+layout(location = 4) in vec4 aWeights;
+
+out vec2 texCoord;
+out vec3 normal;
+
+// three rows of a 3x4 matrix per bone, every character's bones one after another
+uniform samplerBuffer palettes;
+uniform int bonesPerCharacter;
+uniform mat4 proj;
+uniform mat4 view;
+
+
+void main() {
+    int base = gl_InstanceID * bonesPerCharacter;
+    vec4 row0 = vec4(0.0), row1 = vec4(0.0), row2 = vec4(0.0);
+    for (int i = 0; i < 4; ++i) {
+        int texel = (base + int(aBones[i])) * 3;
+        row0 += texelFetch(palettes, texel) * aWeights[i];
+        row1 += texelFetch(palettes, texel + 1) * aWeights[i];
+        row2 += texelFetch(palettes, texel + 2) * aWeights[i];
+    }
+    vec4 p = vec4(aPos, 1.0);
+    vec4 n = vec4(aNormal, 0.0);
+    vec3 pos = vec3(dot(row0, p), dot(row1, p), dot(row2, p));
+    normal = vec3(dot(row0, n), dot(row1, n), dot(row2, n));
+    gl_Position = proj * view * vec4(pos, 1.0);
+    texCoord = aTexCoord;
+}
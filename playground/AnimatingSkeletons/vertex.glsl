@@ -0,0 +1,19 @@
+#version 330 core
+
+// already skinned on the CPU, so these are in world space
+layout(location = 0) in vec3 aPos;
+layout(location = 1) in vec2 aTexCoord;
+layout(location = 2) in vec3 aNormal;
+
+out vec2 texCoord;
+out vec3 normal;
+
+uniform mat4 proj;
+uniform mat4 view;
+
+
+void main() {
+    gl_Position = proj * view * vec4(aPos, 1.0);
+    texCoord = aTexCoord;
+    normal = aNormal;
+}
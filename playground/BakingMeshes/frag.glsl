@@ -0,0 +1,13 @@
+#version 330 core
+
+out vec4 FragColor;
+in vec2 texCoord;
+in vec3 normal;
+
+uniform sampler2D tex;
+
+void main() {
+    vec3 light = normalize(vec3(0.4, 1.0, 0.6));
+    float diffuse = 0.2 + 0.8 * max(dot(normalize(normal), light), 0.0);
+    FragColor = vec4(texture(tex, texCoord).rgb * diffuse, 1.0);
+}
@@ -0,0 +1,1527 @@
+#include <GL/glew.h>
+
+#include <GLFW/glfw3.h>
+#include <algorithm>
+#include <cfloat>
+#include <cstddef>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <glm/ext/matrix_clip_space.hpp>
+#include <glm/ext/matrix_transform.hpp>
+#include <glm/geometric.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/ext/matrix_float4x4.hpp>
+#include <glm/gtc/type_ptr.hpp>
+#include <glm/glm.hpp>
+#include <glm/trigonometric.hpp>
+#define STB_IMAGE_IMPLEMENTATION
+#include <stb/stb_image.h>
+#include <iostream>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+class Shader {
+    std::string src; 
+protected:
+    const char *getsrc() {
+        return src.data();
+    }
+    GLuint shader_id = 0;
+    bool isCompiled = false;
+protected:
+    virtual const char *getClassName() = 0;
+    GLint getCompilationStatus(GLuint shader_id) {
+        int status;
+        glGetShaderiv(shader_id, GL_COMPILE_STATUS, &status);
+        return status;
+    }
+    void sendError() {
+        char buffer[1024];
+        glGetShaderInfoLog(shader_id, 1024, NULL, buffer);
+        std::cerr << "ERROR::" << getClassName() << " - " << buffer;
+    }
+public:
+    virtual void compile() = 0;
+    void setSource(const char *s) {
+        std::ifstream sourceFile(s);
+        if (!sourceFile.is_open())
+            return;
+        char buffer[8192];
+        while (sourceFile.read(buffer, 8192)) {
+            src.append(buffer, 8192);
+        }
+        if (!sourceFile.eof()) {
+            src.clear();
+            return;
+        }
+        src.append(buffer, sourceFile.gcount());
+    }
+    friend class Program;
+};
+
+
+class VertexShader : public Shader {
+    virtual const char *getClassName() override {
+        return "VertexShader";
+    }
+public:
+    virtual void compile() override {
+        if (shader_id)
+            glDeleteShader(shader_id);
+        shader_id = glCreateShader(GL_VERTEX_SHADER);
+        const char *src = getsrc();
+        glShaderSource(shader_id, 1, &src, NULL);
+        glCompileShader(shader_id);
+        if (!getCompilationStatus(shader_id)) {
+            sendError();
+        }
+        isCompiled = true;
+    }
+};
+
+class FragmentShader : public Shader {
+    const char *getClassName() override {
+        return "FragmentShader";
+    }
+public:
+    virtual void compile() override {
+        if (shader_id)
+            glDeleteShader(shader_id);
+        shader_id = glCreateShader(GL_FRAGMENT_SHADER);
+        const char *src = getsrc();
+        glShaderSource(shader_id, 1, &src, NULL);
+        glCompileShader(shader_id);
+        if (!getCompilationStatus(shader_id)) {
+            sendError();
+        }
+        isCompiled = true;
+    }
+};
+
+
+class Program {
+    GLuint program_id = 0;
+    void sendError() {
+        char buffer[1024];
+        glGetProgramInfoLog(program_id, 1024, NULL, buffer);
+        std::cerr << "ERROR::PROGRAM: " << " - " << buffer;
+    }
+    bool linkStatus() {
+        int status = 0;
+        glGetProgramiv(program_id, GL_LINK_STATUS, &status);
+        return status;
+    }
+public:
+    Program() {
+        program_id = glCreateProgram();
+    }
+    ~Program() {
+        glDeleteProgram(program_id);
+    }
+    void AttachShaders(std::initializer_list<Shader*> shaders) {
+        auto i = shaders.begin();
+        while (i != shaders.end()) {
+            if (!(*i)->isCompiled)
+                (*i)->compile();
+            glAttachShader(program_id, (*i)->shader_id);
+            ++i;
+        }
+        glLinkProgram(program_id);
+        if (!linkStatus()) {
+            sendError();
+        }
+    }
+    void UseProgram() {
+        glUseProgram(program_id);
+    }
+    void setMat4(const char *locName, const glm::mat4 &mat) {
+        int location = glGetUniformLocation(program_id, locName);
+        if (location == -1)
+            return;
+        glUniformMatrix4fv(location, 1, GL_FALSE, glm::value_ptr(mat));
+    }
+    void setInt(const char *locName, int value) {
+        int location = glGetUniformLocation(program_id, locName);
+        if (location == -1)
+            return;
+        glUniform1i(location, value);
+    }
+    void setFloat(const char *locName, float value) {
+        int location = glGetUniformLocation(program_id, locName);
+        if (location == -1)
+            return;
+        glUniform1f(location, value);
+    }
+    void setVec3(const char *locName, const glm::vec3 &vec) {
+        int location = glGetUniformLocation(program_id, locName);
+        if (location == -1)
+            return;
+        glUniform3f(location, vec.x, vec.y, vec.z);
+    }
+    void setVec4(const char *locName, const glm::vec4 &vec) {
+        int location = glGetUniformLocation(program_id, locName);
+        if (location == -1)
+            return;
+        glUniform4f(location, vec.x, vec.y, vec.z, vec.w);
+    }
+};
+
+
+class Texture2D {
+    GLuint tex_id;
+public:
+    void generate2DTex(const char *image_path) {
+        int width, height, nChannels;
+        stbi_set_flip_vertically_on_load(true);
+        uint8_t *raw_image = stbi_load(image_path, &width, &height, &nChannels, 0);
+        float borderColor[] = {1.f, 1.f, 1.f, 1.f};
+        glGenTextures(1, &tex_id);
+        glBindTexture(GL_TEXTURE_2D, tex_id);
+        // what to do when primitive is bigger than the texture
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_BORDER);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_BORDER);
+        glTexParameterfv(GL_TEXTURE_2D, GL_TEXTURE_BORDER_COLOR, borderColor);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        // glTexImage2D(TARGET_TYPE, IM_MIPMAP_LEVEL, TARGET_NRCHANNELS, SRC_WIDTH, SRC_HEIGHT, LEGACY_0, SRC_NRCHANNELS, SRC_DATA_TYPE, SRC_DATA);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, width, height, 0, GL_RGB, GL_UNSIGNED_BYTE, raw_image);
+        stbi_image_free(raw_image);
+    }
+    void bind() {
+        glBindTexture(GL_TEXTURE_2D, tex_id);
+    }
+};
+
+
+
+// ---------------------------------------------------------------------------------------------------------
+// the baked mesh format. everything the runtime needs is laid out the way GL wants it, so loading is an mmap
+// and a glBufferData per section. all offsets are from the start of the file and 16 byte aligned
+//
+//   MeshFileHeader
+//   MeshSubmesh[submeshCount]
+//   PackedPosition[vertexCount]    stream 0
+//   PackedAttributes[vertexCount]  stream 1
+//   uint16_t or uint32_t[indexCount]
+// ---------------------------------------------------------------------------------------------------------
+
+constexpr char MESH_MAGIC[4] = {'A', 'G', 'M', 'S'};
+// bump on any change to the structs below, old files are rejected and have to be baked again
+constexpr uint32_t MESH_VERSION = 1;
+
+struct MeshFileHeader {
+    char magic[4];
+    uint32_t version;
+    uint32_t vertexCount;
+    uint32_t indexCount;
+    uint32_t submeshCount;
+    uint32_t indexType;   // GL_UNSIGNED_SHORT or GL_UNSIGNED_INT
+    uint64_t submeshOffset;
+    uint64_t positionOffset;
+    uint64_t attributeOffset;
+    uint64_t indexOffset;
+    uint64_t fileSize;
+    // positions are stored as unorm16 inside the bounds, pos = bounds.min + unorm * (max - min)
+    float boundsMin[3];
+    float boundsMax[3];
+};
+static_assert(sizeof(MeshFileHeader) == 88, "MeshFileHeader layout is part of the file format");
+
+// xyz as unorm16 within the mesh bounds, w is padding so GL gets 4 byte aligned attributes
+struct PackedPosition {
+    uint16_t x, y, z, w;
+};
+
+// normal as GL_INT_2_10_10_10_REV, uv as half floats
+struct PackedAttributes {
+    uint32_t normal;
+    uint16_t u, v;
+};
+
+struct MeshSubmesh {
+    uint32_t firstIndex;
+    uint32_t indexCount;
+    uint32_t minVertex, maxVertex;  // for glDrawRangeElements
+    float boundsMin[3];
+    float boundsMax[3];
+    char name[32];
+};
+static_assert(sizeof(MeshSubmesh) == 72, "MeshSubmesh layout is part of the file format");
+
+uint64_t alignUp(uint64_t value, uint64_t alignment) {
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+
+// ---------------------------------------------------------------------------------------------------------
+// importing. both importers give us the same thing: an indexed triangle list with float attributes,
+// split into submeshes
+// ---------------------------------------------------------------------------------------------------------
+
+struct RawVertex {
+    glm::vec3 pos;
+    glm::vec3 normal;
+    glm::vec2 uv;
+};
+
+struct RawSubmesh {
+    uint32_t firstIndex = 0, indexCount = 0;
+    std::string name;
+};
+
+struct RawMesh {
+    std::vector<RawVertex> vertices;
+    std::vector<uint32_t> indices;
+    std::vector<RawSubmesh> submeshes;
+    bool hasNormals = true;
+};
+
+std::string readWholeFile(const std::string &path) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open())
+        return std::string();
+    return std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+}
+
+// wavefront obj: v, vt, vn and f with any polygon size (triangulated as fans) and negative indices.
+// every usemtl, o or g starts a new submesh
+bool importObj(const std::string &path, RawMesh &mesh) {
+    std::string text = readWholeFile(path);
+    if (text.empty()) {
+        std::cerr << "ERROR::BAKER - can't read " << path << "\n";
+        return false;
+    }
+    std::vector<glm::vec3> positions, normals;
+    std::vector<glm::vec2> uvs;
+    // one obj v/vt/vn triple -> one vertex, welding the rest happens later
+    struct Key {
+        int p, t, n;
+        bool operator==(const Key &o) const {
+            return p == o.p && t == o.t && n == o.n;
+        }
+    };
+    struct KeyHash {
+        size_t operator()(const Key &k) const {
+            return (size_t(k.p) * 73856093u) ^ (size_t(k.t) * 19349663u) ^ (size_t(k.n) * 83492791u);
+        }
+    };
+    std::unordered_map<Key, uint32_t, KeyHash> vertexOf;
+    bool missingNormals = false;
+    mesh.submeshes.push_back(RawSubmesh());
+    mesh.submeshes.back().name = "default";
+
+    auto newSubmesh = [&](const char *name, const char *end) {
+        RawSubmesh &last = mesh.submeshes.back();
+        last.indexCount = mesh.indices.size() - last.firstIndex;
+        if (last.indexCount == 0)
+            mesh.submeshes.pop_back();
+        RawSubmesh next;
+        next.firstIndex = mesh.indices.size();
+        next.name.assign(name, end);
+        mesh.submeshes.push_back(next);
+    };
+    // obj indices are 1 based, negative ones count back from the end
+    auto resolve = [](long index, size_t count) -> int {
+        if (index > 0)
+            return index - 1 < long(count) ? int(index - 1) : -2;
+        if (index < 0)
+            return long(count) + index >= 0 ? int(count + index) : -2;
+        return -1;
+    };
+
+    const char *p = text.c_str();
+    const char *end = p + text.size();
+    int lineNumber = 0;
+    std::vector<uint32_t> face;
+    while (p < end) {
+        const char *line = p;
+        const char *eol = static_cast<const char*>(std::memchr(p, '\n', end - p));
+        if (!eol)
+            eol = end;
+        p = eol + 1;
+        ++lineNumber;
+        while (line < eol && (*line == ' ' || *line == '\t'))
+            ++line;
+        char *next;
+        if (line[0] == 'v' && line[1] == ' ') {
+            glm::vec3 v;
+            v.x = std::strtof(line + 2, &next);
+            v.y = std::strtof(next, &next);
+            v.z = std::strtof(next, &next);
+            positions.push_back(v);
+        } else if (line[0] == 'v' && line[1] == 't') {
+            glm::vec2 t;
+            t.x = std::strtof(line + 2, &next);
+            t.y = std::strtof(next, &next);
+            uvs.push_back(t);
+        } else if (line[0] == 'v' && line[1] == 'n') {
+            glm::vec3 n;
+            n.x = std::strtof(line + 2, &next);
+            n.y = std::strtof(next, &next);
+            n.z = std::strtof(next, &next);
+            normals.push_back(n);
+        } else if (line[0] == 'f' && line[1] == ' ') {
+            face.clear();
+            const char *c = line + 2;
+            while (c < eol) {
+                while (c < eol && (*c == ' ' || *c == '\t' || *c == '\r'))
+                    ++c;
+                if (c >= eol)
+                    break;
+                long idx[3] = {0, 0, 0};
+                idx[0] = std::strtol(c, &next, 10);
+                c = next;
+                for (int k = 1; k < 3 && *c == '/'; ++k) {
+                    ++c;
+                    if (*c != '/' && *c != ' ' && c < eol) {
+                        idx[k] = std::strtol(c, &next, 10);
+                        c = next;
+                    }
+                }
+                Key key = {resolve(idx[0], positions.size()), resolve(idx[1], uvs.size()), resolve(idx[2], normals.size())};
+                if (key.p < 0 || key.t == -2 || key.n == -2) {
+                    std::cerr << "ERROR::BAKER - " << path << ":" << lineNumber << ": face index out of range\n";
+                    return false;
+                }
+                auto found = vertexOf.find(key);
+                if (found == vertexOf.end()) {
+                    RawVertex v;
+                    v.pos = positions[key.p];
+                    v.uv = key.t >= 0 ? uvs[key.t] : glm::vec2(0.f);
+                    v.normal = key.n >= 0 ? normals[key.n] : glm::vec3(0.f);
+                    missingNormals |= key.n < 0;
+                    found = vertexOf.emplace(key, mesh.vertices.size()).first;
+                    mesh.vertices.push_back(v);
+                }
+                face.push_back(found->second);
+            }
+            for (size_t k = 2; k < face.size(); ++k) {
+                mesh.indices.push_back(face[0]);
+                mesh.indices.push_back(face[k - 1]);
+                mesh.indices.push_back(face[k]);
+            }
+        } else if (!std::strncmp(line, "usemtl ", 7) || !std::strncmp(line, "o ", 2) || !std::strncmp(line, "g ", 2)) {
+            const char *name = std::strchr(line, ' ') + 1;
+            const char *nameEnd = eol;
+            while (nameEnd > name && (nameEnd[-1] == '\r' || nameEnd[-1] == ' '))
+                --nameEnd;
+            newSubmesh(name, nameEnd);
+        }
+    }
+    RawSubmesh &last = mesh.submeshes.back();
+    last.indexCount = mesh.indices.size() - last.firstIndex;
+    if (last.indexCount == 0)
+        mesh.submeshes.pop_back();
+    mesh.hasNormals = !missingNormals;
+    return true;
+}
+
+
+// just enough json for gltf: no unicode escapes, numbers are doubles
+struct Json {
+    enum Type { NUL, BOOL, NUMBER, STRING, ARRAY, OBJECT } type = NUL;
+    double number = 0.;
+    std::string string;
+    std::vector<Json> items;
+    std::vector<std::pair<std::string, Json>> members;
+
+    const Json *get(const char *key) const {
+        for (const auto &m : members)
+            if (m.first == key)
+                return &m.second;
+        return nullptr;
+    }
+    double num(const char *key, double fallback) const {
+        const Json *j = get(key);
+        return j && j->type == NUMBER ? j->number : fallback;
+    }
+    const Json *at(size_t i) const {
+        return type == ARRAY && i < items.size() ? &items[i] : nullptr;
+    }
+};
+
+class JsonParser {
+    const char *p, *end;
+    bool failed = false;
+
+    void skip() {
+        while (p < end && (*p == ' ' || *p == '\n' || *p == '\r' || *p == '\t'))
+            ++p;
+    }
+    bool expect(char c) {
+        skip();
+        if (p < end && *p == c) {
+            ++p;
+            return true;
+        }
+        failed = true;
+        return false;
+    }
+    std::string parseString() {
+        std::string s;
+        if (!expect('"'))
+            return s;
+        while (p < end && *p != '"') {
+            if (*p == '\\' && p + 1 < end) {
+                ++p;
+                char c = *p == 'n' ? '\n' : *p == 't' ? '\t' : *p;
+                s += c;
+            } else {
+                s += *p;
+            }
+            ++p;
+        }
+        expect('"');
+        return s;
+    }
+    void parseValue(Json &out) {
+        skip();
+        if (p >= end) {
+            failed = true;
+            return;
+        }
+        if (*p == '{') {
+            ++p;
+            out.type = Json::OBJECT;
+            skip();
+            if (p < end && *p == '}') {
+                ++p;
+                return;
+            }
+            do {
+                out.members.emplace_back(parseString(), Json());
+                expect(':');
+                parseValue(out.members.back().second);
+                skip();
+            } while (!failed && p < end && *p == ',' && ++p);
+            expect('}');
+        } else if (*p == '[') {
+            ++p;
+            out.type = Json::ARRAY;
+            skip();
+            if (p < end && *p == ']') {
+                ++p;
+                return;
+            }
+            do {
+                out.items.emplace_back();
+                parseValue(out.items.back());
+                skip();
+            } while (!failed && p < end && *p == ',' && ++p);
+            expect(']');
+        } else if (*p == '"') {
+            out.type = Json::STRING;
+            out.string = parseString();
+        } else if (!std::strncmp(p, "true", 4) || !std::strncmp(p, "false", 5)) {
+            out.type = Json::BOOL;
+            out.number = *p == 't';
+            p += *p == 't' ? 4 : 5;
+        } else if (!std::strncmp(p, "null", 4)) {
+            p += 4;
+        } else {
+            char *next;
+            out.type = Json::NUMBER;
+            out.number = std::strtod(p, &next);
+            failed |= next == p;
+            p = next;
+        }
+    }
+public:
+    bool parse(const char *text, size_t size, Json &out) {
+        p = text, end = text + size;
+        parseValue(out);
+        return !failed;
+    }
+};
+
+std::string decodeBase64(const char *s, size_t size) {
+    auto value = [](char c) -> int {
+        if (c >= 'A' && c <= 'Z') return c - 'A';
+        if (c >= 'a' && c <= 'z') return c - 'a' + 26;
+        if (c >= '0' && c <= '9') return c - '0' + 52;
+        if (c == '+') return 62;
+        if (c == '/') return 63;
+        return -1;
+    };
+    std::string out;
+    out.reserve(size / 4 * 3);
+    uint32_t bits = 0;
+    int count = 0;
+    for (size_t i = 0; i < size; ++i) {
+        int v = value(s[i]);
+        if (v < 0)
+            continue;
+        bits = bits << 6 | v;
+        count += 6;
+        if (count >= 8) {
+            count -= 8;
+            out += char(bits >> count & 0xFF);
+        }
+    }
+    return out;
+}
+
+// gltf 2.0, .gltf with external or data uri buffers and .glb. every triangle primitive of every mesh
+// becomes a submesh. node transforms are not applied, the meshes come out in their own space
+class GltfImporter {
+    Json doc;
+    std::vector<std::string> buffers;
+    std::string path;
+
+    bool fail(const char *what) {
+        std::cerr << "ERROR::BAKER - " << path << ": " << what << "\n";
+        return false;
+    }
+    bool loadBuffers(const std::string &glbBin) {
+        const Json *list = doc.get("buffers");
+        for (size_t i = 0; list && i < list->items.size(); ++i) {
+            const Json *uri = list->items[i].get("uri");
+            if (!uri) {
+                buffers.push_back(glbBin);
+            } else if (!uri->string.compare(0, 5, "data:")) {
+                size_t comma = uri->string.find(',');
+                if (comma == std::string::npos)
+                    return fail("bad data uri");
+                buffers.push_back(decodeBase64(uri->string.data() + comma + 1, uri->string.size() - comma - 1));
+            } else {
+                size_t slash = path.find_last_of('/');
+                std::string dir = slash == std::string::npos ? std::string() : path.substr(0, slash + 1);
+                buffers.push_back(readWholeFile(dir + uri->string));
+            }
+            if (buffers.back().size() < list->items[i].num("byteLength", 0))
+                return fail("buffer is shorter than its byteLength");
+        }
+        return true;
+    }
+    // reads accessor as floats, components per element are returned in width. normalized integers are mapped to [0, 1]/[-1, 1]
+    bool readAccessor(size_t index, std::vector<float> &out, int &width) {
+        const Json *accessor = doc.get("accessors") ? doc.get("accessors")->at(index) : nullptr;
+        if (!accessor)
+            return fail("missing accessor");
+        if (accessor->get("sparse"))
+            return fail("sparse accessors are not supported");
+        const Json *typeName = accessor->get("type");
+        const std::string type = typeName ? typeName->string : "";
+        width = type == "SCALAR" ? 1 : type == "VEC2" ? 2 : type == "VEC3" ? 3 : type == "VEC4" ? 4 : 0;
+        const int componentType = accessor->num("componentType", 0);
+        const int componentSize = componentType == 5126 || componentType == 5125 ? 4 : componentType == 5123 || componentType == 5122 ? 2 : 1;
+        const size_t count = accessor->num("count", 0);
+        const bool normalized = accessor->get("normalized") && accessor->get("normalized")->number != 0.;
+        const Json *view = doc.get("bufferViews") ? doc.get("bufferViews")->at(accessor->num("bufferView", -1)) : nullptr;
+        if (!width || !view)
+            return fail("accessor without a usable type or buffer view");
+        const size_t bufferIndex = view->num("buffer", 0);
+        if (bufferIndex >= buffers.size())
+            return fail("buffer view points to a missing buffer");
+        const size_t stride = view->num("byteStride", width * componentSize);
+        const size_t offset = size_t(view->num("byteOffset", 0)) + size_t(accessor->num("byteOffset", 0));
+        const std::string &buffer = buffers[bufferIndex];
+        if (count && offset + (count - 1) * stride + width * componentSize > buffer.size())
+            return fail("accessor reads past the end of its buffer");
+
+        out.resize(count * width);
+        for (size_t i = 0; i < count; ++i) {
+            const char *element = buffer.data() + offset + i * stride;
+            for (int c = 0; c < width; ++c) {
+                const char *src = element + c * componentSize;
+                float v = 0.f;
+                switch (componentType) {
+                case 5126: std::memcpy(&v, src, 4); break;
+                case 5125: { uint32_t u; std::memcpy(&u, src, 4); v = u; break; }
+                case 5123: { uint16_t u; std::memcpy(&u, src, 2); v = normalized ? u / 65535.f : u; break; }
+                case 5122: { int16_t s; std::memcpy(&s, src, 2); v = normalized ? std::max(s / 32767.f, -1.f) : s; break; }
+                case 5121: v = normalized ? uint8_t(*src) / 255.f : uint8_t(*src); break;
+                case 5120: v = normalized ? std::max(int8_t(*src) / 127.f, -1.f) : int8_t(*src); break;
+                default: return fail("unknown component type");
+                }
+                out[i * width + c] = v;
+            }
+        }
+        return true;
+    }
+public:
+    bool import(const std::string &file, RawMesh &mesh) {
+        path = file;
+        std::string data = readWholeFile(file);
+        if (data.empty())
+            return fail("can't read file");
+        std::string json = data, bin;
+        if (data.size() >= 12 && !data.compare(0, 4, "glTF")) {
+            // glb: 12 byte header, then length/type/data chunks, JSON first and an optional BIN
+            size_t at = 12;
+            json.clear();
+            while (at + 8 <= data.size()) {
+                uint32_t length, type;
+                std::memcpy(&length, data.data() + at, 4);
+                std::memcpy(&type, data.data() + at + 4, 4);
+                if (at + 8 + length > data.size())
+                    return fail("truncated glb chunk");
+                if (type == 0x4E4F534A)
+                    json = data.substr(at + 8, length);
+                else if (type == 0x004E4942)
+                    bin = data.substr(at + 8, length);
+                at += 8 + alignUp(length, 4);
+            }
+        }
+        if (!JsonParser().parse(json.data(), json.size(), doc) || doc.type != Json::OBJECT)
+            return fail("invalid json");
+        if (!loadBuffers(bin))
+            return false;
+
+        const Json *meshes = doc.get("meshes");
+        bool missingNormals = false;
+        for (size_t m = 0; meshes && m < meshes->items.size(); ++m) {
+            const Json &gltfMesh = meshes->items[m];
+            const Json *primitives = gltfMesh.get("primitives");
+            for (size_t k = 0; primitives && k < primitives->items.size(); ++k) {
+                const Json &prim = primitives->items[k];
+                if (prim.num("mode", 4) != 4) {
+                    std::cerr << "WARNING::BAKER - skipping a primitive that isn't a triangle list\n";
+                    continue;
+                }
+                const Json *attributes = prim.get("attributes");
+                if (!attributes || !attributes->get("POSITION"))
+                    return fail("primitive without positions");
+                std::vector<float> pos, normal, uv, indices;
+                int width = 0;
+                if (!readAccessor(attributes->num("POSITION", 0), pos, width) || width != 3)
+                    return fail("bad POSITION");
+                const size_t count = pos.size() / 3;
+                if (attributes->get("NORMAL") && (!readAccessor(attributes->num("NORMAL", 0), normal, width) || width != 3))
+                    return fail("bad NORMAL");
+                if (attributes->get("TEXCOORD_0") && (!readAccessor(attributes->num("TEXCOORD_0", 0), uv, width) || width != 2))
+                    return fail("bad TEXCOORD_0");
+                if (prim.get("indices") && (!readAccessor(prim.num("indices", 0), indices, width) || width != 1))
+                    return fail("bad indices");
+                missingNormals |= normal.empty();
+
+                const uint32_t base = mesh.vertices.size();
+                for (size_t i = 0; i < count; ++i) {
+                    RawVertex v;
+                    v.pos = glm::vec3(pos[i * 3], pos[i * 3 + 1], pos[i * 3 + 2]);
+                    v.normal = normal.size() == count * 3 ? glm::vec3(normal[i * 3], normal[i * 3 + 1], normal[i * 3 + 2]) : glm::vec3(0.f);
+                    // gltf puts the uv origin at the top left, gl at the bottom left
+                    v.uv = uv.size() == count * 2 ? glm::vec2(uv[i * 2], 1.f - uv[i * 2 + 1]) : glm::vec2(0.f);
+                    mesh.vertices.push_back(v);
+                }
+                RawSubmesh sub;
+                sub.firstIndex = mesh.indices.size();
+                const Json *name = gltfMesh.get("name");
+                sub.name = name ? name->string : "mesh" + std::to_string(m);
+                if (indices.empty()) {
+                    for (size_t i = 0; i + 2 < count; i += 3)
+                        for (int c = 0; c < 3; ++c)
+                            mesh.indices.push_back(base + i + c);
+                } else {
+                    for (size_t i = 0; i + 2 < indices.size(); i += 3) {
+                        for (int c = 0; c < 3; ++c) {
+                            if (indices[i + c] >= count)
+                                return fail("index out of range");
+                            mesh.indices.push_back(base + uint32_t(indices[i + c]));
+                        }
+                    }
+                }
+                sub.indexCount = mesh.indices.size() - sub.firstIndex;
+                if (sub.indexCount)
+                    mesh.submeshes.push_back(sub);
+            }
+        }
+        mesh.hasNormals = !missingNormals;
+        if (mesh.indices.empty())
+            return fail("no triangles");
+        return true;
+    }
+};
+
+
+// ---------------------------------------------------------------------------------------------------------
+// baking
+// ---------------------------------------------------------------------------------------------------------
+
+// area weighted smooth normals over vertices that share a position
+void computeNormals(RawMesh &mesh) {
+    std::unordered_map<uint64_t, glm::vec3> sums;
+    auto key = [](const glm::vec3 &p) {
+        uint32_t bits[3];
+        std::memcpy(bits, &p, 12);
+        return (uint64_t(bits[0]) * 0x9E3779B97F4A7C15ull) ^ (uint64_t(bits[1]) * 0xC2B2AE3D27D4EB4Full) ^ uint64_t(bits[2]);
+    };
+    for (size_t i = 0; i + 2 < mesh.indices.size(); i += 3) {
+        const glm::vec3 &a = mesh.vertices[mesh.indices[i]].pos;
+        const glm::vec3 &b = mesh.vertices[mesh.indices[i + 1]].pos;
+        const glm::vec3 &c = mesh.vertices[mesh.indices[i + 2]].pos;
+        glm::vec3 n = glm::cross(b - a, c - a);
+        for (const glm::vec3 *p : {&a, &b, &c})
+            sums[key(*p)] += n;
+    }
+    for (RawVertex &v : mesh.vertices) {
+        glm::vec3 n = sums[key(v.pos)];
+        float len = glm::length(n);
+        v.normal = len > 0.f ? n / len : glm::vec3(0.f, 1.f, 0.f);
+    }
+}
+
+uint16_t floatToHalf(float f) {
+    uint32_t bits;
+    std::memcpy(&bits, &f, 4);
+    const uint32_t sign = bits >> 16 & 0x8000;
+    const int32_t exponent = int32_t(bits >> 23 & 0xFF) - 127 + 15;
+    uint32_t mantissa = bits & 0x7FFFFF;
+    if ((bits & 0x7FFFFFFF) > 0x7F800000)
+        return sign | 0x7E00;  // nan
+    if (exponent >= 31)
+        return sign | 0x7C00;  // too big or inf
+    if (exponent <= 0) {
+        if (exponent < -10)
+            return sign;
+        // denormal, round to nearest even
+        mantissa |= 0x800000;
+        const int shift = 14 - exponent;
+        uint32_t half = mantissa >> shift;
+        const uint32_t rest = mantissa & ((1u << shift) - 1), middle = 1u << (shift - 1);
+        half += rest > middle || (rest == middle && (half & 1));
+        return sign | half;
+    }
+    uint32_t half = uint32_t(exponent) << 10 | mantissa >> 13;
+    const uint32_t rest = mantissa & 0x1FFF;
+    // a carry out of the mantissa correctly bumps the exponent
+    half += rest > 0x1000 || (rest == 0x1000 && (half & 1));
+    return sign | half;
+}
+
+uint32_t packNormal(const glm::vec3 &n) {
+    auto snorm10 = [](float v) {
+        return uint32_t(int32_t(std::round(glm::clamp(v, -1.f, 1.f) * 511.f)) & 0x3FF);
+    };
+    return snorm10(n.x) | snorm10(n.y) << 10 | snorm10(n.z) << 20;
+}
+
+// average cache miss ratio: vertex shader runs per triangle with a FIFO post transform cache,
+// 3 is no reuse at all, ~0.5-0.7 is about as good as it gets for regular meshes
+float averageCacheMissRatio(const uint32_t *indices, size_t count, size_t vertexCount, int cacheSize = 16) {
+    std::vector<uint32_t> fifo(cacheSize, UINT32_MAX);
+    std::vector<uint32_t> inCache(vertexCount, 0);
+    size_t head = 0, misses = 0;
+    for (size_t i = 0; i < count; ++i) {
+        uint32_t v = indices[i];
+        if (inCache[v])
+            continue;
+        ++misses;
+        if (fifo[head] != UINT32_MAX)
+            inCache[fifo[head]] = 0;
+        fifo[head] = v;
+        inCache[v] = 1;
+        head = (head + 1) % cacheSize;
+    }
+    return count ? float(misses) / (count / 3) : 0.f;
+}
+
+// tom forsyth's linear-speed vertex cache optimisation: greedily emits the triangle with the best score,
+// where vertices score high when they were used recently and when few triangles are left that use them
+void optimizeVertexCache(uint32_t *indices, size_t count, size_t vertexCount) {
+    constexpr int CACHE_SIZE = 32;
+    const size_t triangleCount = count / 3;
+    auto vertexScore = [](int cachePosition, uint32_t remaining) {
+        if (remaining == 0)
+            return -1.f;
+        float score = 0.f;
+        if (cachePosition >= 0)
+            score = cachePosition < 3 ? 0.75f : std::pow(1.f - float(cachePosition - 3) / (CACHE_SIZE - 3), 1.5f);
+        return score + 2.f / std::sqrt(float(remaining));
+    };
+
+    std::vector<uint32_t> remaining(vertexCount, 0), offsets(vertexCount + 1, 0);
+    for (size_t i = 0; i < count; ++i)
+        ++remaining[indices[i]];
+    for (size_t v = 0; v < vertexCount; ++v)
+        offsets[v + 1] = offsets[v] + remaining[v];
+    // per vertex, the triangles that still use it
+    std::vector<uint32_t> triangles(count), filled(offsets.begin(), offsets.end() - 1);
+    for (size_t t = 0; t < triangleCount; ++t)
+        for (int c = 0; c < 3; ++c)
+            triangles[filled[indices[t * 3 + c]]++] = t;
+
+    std::vector<int> cachePosition(vertexCount, -1);
+    std::vector<float> score(vertexCount), triangleScore(triangleCount);
+    std::vector<uint8_t> emitted(triangleCount, 0);
+    for (size_t v = 0; v < vertexCount; ++v)
+        score[v] = vertexScore(-1, remaining[v]);
+    for (size_t t = 0; t < triangleCount; ++t)
+        triangleScore[t] = score[indices[t * 3]] + score[indices[t * 3 + 1]] + score[indices[t * 3 + 2]];
+
+    std::vector<uint32_t> out;
+    out.reserve(count);
+    uint32_t cache[CACHE_SIZE + 3];
+    int cacheCount = 0;
+    size_t scan = 0;
+    int64_t best = -1;
+    while (out.size() < count) {
+        if (best < 0) {
+            // nothing in the cache is any good, take the next triangle we haven't emitted yet
+            while (emitted[scan])
+                ++scan;
+            best = scan;
+        }
+        emitted[best] = 1;
+        const uint32_t *tri = indices + best * 3;
+        out.insert(out.end(), tri, tri + 3);
+
+        // move the triangle's vertices to the front of the cache
+        uint32_t next[CACHE_SIZE + 3];
+        int nextCount = 0;
+        for (int c = 0; c < 3; ++c) {
+            next[nextCount++] = tri[c];
+            uint32_t v = tri[c];
+            uint32_t *begin = &triangles[offsets[v]], *end = begin + remaining[v];
+            std::swap(*std::find(begin, end, uint32_t(best)), end[-1]);
+            --remaining[v];
+        }
+        for (int i = 0; i < cacheCount; ++i)
+            if (cache[i] != tri[0] && cache[i] != tri[1] && cache[i] != tri[2])
+                next[nextCount++] = cache[i];
+        for (int i = CACHE_SIZE; i < nextCount; ++i)
+            cachePosition[next[i]] = -1;
+        cacheCount = std::min(nextCount, CACHE_SIZE);
+        std::copy(next, next + cacheCount, cache);
+
+        // rescore what is in the cache and pick the best triangle touching it
+        for (int i = 0; i < cacheCount; ++i) {
+            cachePosition[cache[i]] = i;
+        }
+        for (int i = 0; i < nextCount; ++i) {
+            uint32_t v = next[i];
+            float newScore = vertexScore(cachePosition[v], remaining[v]);
+            float diff = newScore - score[v];
+            score[v] = newScore;
+            for (uint32_t k = offsets[v]; k < offsets[v] + remaining[v]; ++k)
+                triangleScore[triangles[k]] += diff;
+        }
+        best = -1;
+        float bestScore = -1.f;
+        for (int i = 0; i < cacheCount; ++i) {
+            uint32_t v = cache[i];
+            for (uint32_t k = offsets[v]; k < offsets[v] + remaining[v]; ++k) {
+                if (triangleScore[triangles[k]] > bestScore) {
+                    bestScore = triangleScore[triangles[k]];
+                    best = triangles[k];
+                }
+            }
+        }
+    }
+    std::copy(out.begin(), out.end(), indices);
+}
+
+struct BakeStats {
+    size_t inputVertices = 0, outputVertices = 0;
+    size_t triangles = 0, degenerate = 0;
+    float acmrBefore = 0.f, acmrAfter = 0.f;
+    float maxPositionError = 0.f;
+    uint64_t fileSize = 0;
+};
+
+// quantizes, welds, drops degenerate triangles, optimizes for the vertex cache and then for fetch order,
+// and writes the result
+bool bakeMesh(RawMesh &mesh, const std::string &outPath, BakeStats &stats) {
+    if (!mesh.hasNormals)
+        computeNormals(mesh);
+    stats.inputVertices = mesh.vertices.size();
+
+    glm::vec3 lo(FLT_MAX), hi(-FLT_MAX);
+    for (uint32_t i : mesh.indices) {
+        lo = glm::min(lo, mesh.vertices[i].pos);
+        hi = glm::max(hi, mesh.vertices[i].pos);
+    }
+    const glm::vec3 extent = glm::max(hi - lo, glm::vec3(1e-20f));
+
+    // quantize first and weld on the quantized bits, vertices that end up the same really are the same
+    struct Packed {
+        PackedPosition pos;
+        PackedAttributes attr;
+        bool operator==(const Packed &o) const {
+            return !std::memcmp(this, &o, sizeof(Packed));
+        }
+    };
+    struct PackedHash {
+        size_t operator()(const Packed &p) const {
+            uint64_t a, b;
+            std::memcpy(&a, &p, 8);
+            std::memcpy(&b, reinterpret_cast<const char*>(&p) + 8, 8);
+            return size_t((a * 0x9E3779B97F4A7C15ull) ^ (b + 0x632BE59BD9B4E019ull + (a << 6) + (a >> 2)));
+        }
+    };
+    static_assert(sizeof(Packed) == 16, "no padding, we hash the bytes");
+    std::vector<Packed> packed(mesh.vertices.size());
+    for (size_t i = 0; i < mesh.vertices.size(); ++i) {
+        const RawVertex &v = mesh.vertices[i];
+        glm::vec3 unorm = glm::clamp((v.pos - lo) / extent, glm::vec3(0.f), glm::vec3(1.f)) * 65535.f;
+        Packed &p = packed[i];
+        p.pos = {uint16_t(std::round(unorm.x)), uint16_t(std::round(unorm.y)), uint16_t(std::round(unorm.z)), 0};
+        float len = glm::length(v.normal);
+        p.attr.normal = packNormal(len > 0.f ? v.normal / len : glm::vec3(0.f, 1.f, 0.f));
+        p.attr.u = floatToHalf(v.uv.x);
+        p.attr.v = floatToHalf(v.uv.y);
+        glm::vec3 back = lo + glm::vec3(float(p.pos.x), float(p.pos.y), float(p.pos.z)) / 65535.f * extent;
+        glm::vec3 err = glm::abs(back - v.pos);
+        stats.maxPositionError = std::max(stats.maxPositionError, std::max(err.x, std::max(err.y, err.z)));
+    }
+    std::unordered_map<Packed, uint32_t, PackedHash> welded;
+    std::vector<uint32_t> remap(mesh.vertices.size());
+    std::vector<Packed> vertices;
+    for (size_t i = 0; i < packed.size(); ++i) {
+        auto found = welded.emplace(packed[i], vertices.size());
+        if (found.second)
+            vertices.push_back(packed[i]);
+        remap[i] = found.first->second;
+    }
+
+    std::vector<uint32_t> indices;
+    indices.reserve(mesh.indices.size());
+    std::vector<MeshSubmesh> submeshes;
+    size_t acmrTriangles = 0;
+    for (const RawSubmesh &raw : mesh.submeshes) {
+        MeshSubmesh sub = {};
+        sub.firstIndex = indices.size();
+        for (uint32_t i = raw.firstIndex; i + 2 < raw.firstIndex + raw.indexCount; i += 3) {
+            uint32_t a = remap[mesh.indices[i]], b = remap[mesh.indices[i + 1]], c = remap[mesh.indices[i + 2]];
+            if (a == b || b == c || a == c) {
+                ++stats.degenerate;
+                continue;
+            }
+            indices.insert(indices.end(), {a, b, c});
+        }
+        sub.indexCount = indices.size() - sub.firstIndex;
+        if (!sub.indexCount)
+            continue;
+        std::strncpy(sub.name, raw.name.c_str(), sizeof(sub.name) - 1);
+        stats.acmrBefore += averageCacheMissRatio(&indices[sub.firstIndex], sub.indexCount, vertices.size()) * sub.indexCount / 3;
+        optimizeVertexCache(&indices[sub.firstIndex], sub.indexCount, vertices.size());
+        stats.acmrAfter += averageCacheMissRatio(&indices[sub.firstIndex], sub.indexCount, vertices.size()) * sub.indexCount / 3;
+        acmrTriangles += sub.indexCount / 3;
+        submeshes.push_back(sub);
+    }
+    stats.acmrBefore /= std::max<size_t>(acmrTriangles, 1);
+    stats.acmrAfter /= std::max<size_t>(acmrTriangles, 1);
+
+    // renumber vertices in the order the index buffer first uses them, so fetches walk forward through memory.
+    // vertices nothing uses anymore are dropped here
+    std::vector<uint32_t> order(vertices.size(), UINT32_MAX);
+    std::vector<Packed> fetchOrdered;
+    fetchOrdered.reserve(vertices.size());
+    for (uint32_t &i : indices) {
+        if (order[i] == UINT32_MAX) {
+            order[i] = fetchOrdered.size();
+            fetchOrdered.push_back(vertices[i]);
+        }
+        i = order[i];
+    }
+    vertices.swap(fetchOrdered);
+    for (MeshSubmesh &sub : submeshes) {
+        glm::vec3 subLo(FLT_MAX), subHi(-FLT_MAX);
+        sub.minVertex = UINT32_MAX, sub.maxVertex = 0;
+        for (uint32_t k = sub.firstIndex; k < sub.firstIndex + sub.indexCount; ++k) {
+            const PackedPosition &p = vertices[indices[k]].pos;
+            glm::vec3 pos = lo + glm::vec3(float(p.x), float(p.y), float(p.z)) / 65535.f * extent;
+            subLo = glm::min(subLo, pos), subHi = glm::max(subHi, pos);
+            sub.minVertex = std::min(sub.minVertex, indices[k]);
+            sub.maxVertex = std::max(sub.maxVertex, indices[k]);
+        }
+        std::memcpy(sub.boundsMin, &subLo, 12);
+        std::memcpy(sub.boundsMax, &subHi, 12);
+    }
+    stats.outputVertices = vertices.size();
+    stats.triangles = indices.size() / 3;
+
+    MeshFileHeader header = {};
+    std::memcpy(header.magic, MESH_MAGIC, 4);
+    header.version = MESH_VERSION;
+    header.vertexCount = vertices.size();
+    header.indexCount = indices.size();
+    header.submeshCount = submeshes.size();
+    const bool shortIndices = vertices.size() <= 65536;
+    header.indexType = shortIndices ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT;
+    header.submeshOffset = alignUp(sizeof(MeshFileHeader), 16);
+    header.positionOffset = alignUp(header.submeshOffset + submeshes.size() * sizeof(MeshSubmesh), 16);
+    header.attributeOffset = alignUp(header.positionOffset + vertices.size() * sizeof(PackedPosition), 16);
+    header.indexOffset = alignUp(header.attributeOffset + vertices.size() * sizeof(PackedAttributes), 16);
+    header.fileSize = header.indexOffset + indices.size() * (shortIndices ? 2 : 4);
+    std::memcpy(header.boundsMin, &lo, 12);
+    std::memcpy(header.boundsMax, &hi, 12);
+    stats.fileSize = header.fileSize;
+
+    std::string blob(header.fileSize, '\0');
+    std::memcpy(&blob[0], &header, sizeof(header));
+    if (!submeshes.empty())
+        std::memcpy(&blob[header.submeshOffset], submeshes.data(), submeshes.size() * sizeof(MeshSubmesh));
+    for (size_t i = 0; i < vertices.size(); ++i) {
+        std::memcpy(&blob[header.positionOffset + i * sizeof(PackedPosition)], &vertices[i].pos, sizeof(PackedPosition));
+        std::memcpy(&blob[header.attributeOffset + i * sizeof(PackedAttributes)], &vertices[i].attr, sizeof(PackedAttributes));
+    }
+    for (size_t i = 0; i < indices.size(); ++i) {
+        if (shortIndices) {
+            uint16_t index = indices[i];
+            std::memcpy(&blob[header.indexOffset + i * 2], &index, 2);
+        } else {
+            std::memcpy(&blob[header.indexOffset + i * 4], &indices[i], 4);
+        }
+    }
+    // write next to it and rename, so a running game never maps half a file
+    const std::string tmpPath = outPath + ".tmp";
+    std::ofstream out(tmpPath, std::ios::binary | std::ios::trunc);
+    out.write(blob.data(), blob.size());
+    out.close();
+    if (!out || std::rename(tmpPath.c_str(), outPath.c_str()) != 0) {
+        std::cerr << "ERROR::BAKER - can't write " << outPath << "\n";
+        std::remove(tmpPath.c_str());
+        return false;
+    }
+    return true;
+}
+
+bool endsWith(const std::string &s, const char *suffix) {
+    size_t n = std::strlen(suffix);
+    return s.size() >= n && !s.compare(s.size() - n, n, suffix);
+}
+
+bool importMesh(const std::string &path, RawMesh &mesh) {
+    if (endsWith(path, ".gltf") || endsWith(path, ".glb"))
+        return GltfImporter().import(path, mesh);
+    return importObj(path, mesh);
+}
+
+
+// ---------------------------------------------------------------------------------------------------------
+// runtime side: map the file and hand the sections straight to GL
+// ---------------------------------------------------------------------------------------------------------
+
+class MappedMesh {
+    int fd = -1;
+    const char *base = nullptr;
+    size_t size = 0;
+
+    bool fail(const char *path, const char *what) {
+        std::cerr << "ERROR::MESH - " << path << ": " << what << "\n";
+        close();
+        return false;
+    }
+public:
+    MappedMesh() = default;
+    MappedMesh(const MappedMesh&) = delete;
+    MappedMesh &operator=(const MappedMesh&) = delete;
+    ~MappedMesh() {
+        close();
+    }
+    bool open(const char *path) {
+        close();
+        fd = ::open(path, O_RDONLY);
+        if (fd < 0)
+            return fail(path, "can't open");
+        struct stat st;
+        if (fstat(fd, &st) != 0 || size_t(st.st_size) < sizeof(MeshFileHeader))
+            return fail(path, "too small to be a mesh");
+        size = st.st_size;
+        void *mapped = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (mapped == MAP_FAILED) {
+            base = nullptr;
+            return fail(path, "mmap failed");
+        }
+        base = static_cast<const char*>(mapped);
+        // we are going to read all of it front to back right away
+        // the advice values are a list, not flags, so one call each
+        madvise(mapped, size, MADV_SEQUENTIAL);
+        madvise(mapped, size, MADV_WILLNEED);
+
+        // nothing below is parsed, but a bad file must not make us read outside the mapping
+        const MeshFileHeader &h = header();
+        if (std::memcmp(h.magic, MESH_MAGIC, 4))
+            return fail(path, "not a baked mesh");
+        if (h.version != MESH_VERSION)
+            return fail(path, "baked with another version, bake it again");
+        const uint64_t indexSize = h.indexType == GL_UNSIGNED_SHORT ? 2 : h.indexType == GL_UNSIGNED_INT ? 4 : 0;
+        // the offsets come from the file, so subtract from the size rather than add to the offset, a sum can wrap
+        auto fits = [&](uint64_t offset, uint64_t count, uint64_t elementSize) {
+            return offset <= size && count <= (size - offset) / elementSize;
+        };
+        if (!indexSize || h.fileSize != size
+            || !fits(h.submeshOffset, h.submeshCount, sizeof(MeshSubmesh))
+            || !fits(h.positionOffset, h.vertexCount, sizeof(PackedPosition))
+            || !fits(h.attributeOffset, h.vertexCount, sizeof(PackedAttributes))
+            || !fits(h.indexOffset, h.indexCount, indexSize))
+            return fail(path, "sections don't fit in the file");
+        for (uint32_t i = 0; i < h.submeshCount; ++i) {
+            const MeshSubmesh &s = submesh(i);
+            if (uint64_t(s.firstIndex) + s.indexCount > h.indexCount || s.maxVertex >= h.vertexCount)
+                return fail(path, "submesh out of range");
+        }
+        return true;
+    }
+    void close() {
+        if (base)
+            munmap(const_cast<char*>(base), size);
+        if (fd >= 0)
+            ::close(fd);
+        base = nullptr, fd = -1, size = 0;
+    }
+    const MeshFileHeader &header() const {
+        return *reinterpret_cast<const MeshFileHeader*>(base);
+    }
+    const MeshSubmesh &submesh(uint32_t i) const {
+        return reinterpret_cast<const MeshSubmesh*>(base + header().submeshOffset)[i];
+    }
+    const char *data() const {
+        return base;
+    }
+    size_t fileSize() const {
+        return size;
+    }
+    size_t indexBytes() const {
+        return header().indexCount * (header().indexType == GL_UNSIGNED_SHORT ? 2 : 4);
+    }
+};
+
+// one vertex buffer holding both streams, one index buffer
+struct GpuMesh {
+    GLuint vao = 0, vbo = 0, ebo = 0;
+    GLenum indexType = GL_UNSIGNED_SHORT;
+    std::vector<MeshSubmesh> submeshes;
+    glm::vec3 boundsMin, boundsMax;
+};
+
+void uploadMesh(const MappedMesh &file, GpuMesh &mesh) {
+    const MeshFileHeader &h = file.header();
+    const size_t attributeBytes = h.vertexCount * sizeof(PackedAttributes);
+    glGenVertexArrays(1, &mesh.vao);
+    glBindVertexArray(mesh.vao);
+
+    // both streams sit next to each other in the file, so that's one upload straight from the mapping
+    glGenBuffers(1, &mesh.vbo);
+    glBindBuffer(GL_ARRAY_BUFFER, mesh.vbo);
+    glBufferData(GL_ARRAY_BUFFER, h.attributeOffset + attributeBytes - h.positionOffset, file.data() + h.positionOffset, GL_STATIC_DRAW);
+    glVertexAttribPointer(0, 3, GL_UNSIGNED_SHORT, GL_TRUE, sizeof(PackedPosition), (void*)0);
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(1, 2, GL_HALF_FLOAT, GL_FALSE, sizeof(PackedAttributes), (void*)(h.attributeOffset - h.positionOffset + offsetof(PackedAttributes, u)));
+    glEnableVertexAttribArray(1);
+    glVertexAttribPointer(2, 4, GL_INT_2_10_10_10_REV, GL_TRUE, sizeof(PackedAttributes), (void*)(h.attributeOffset - h.positionOffset));
+    glEnableVertexAttribArray(2);
+
+    glGenBuffers(1, &mesh.ebo);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mesh.ebo);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, file.indexBytes(), file.data() + h.indexOffset, GL_STATIC_DRAW);
+    glBindVertexArray(0);
+
+    mesh.indexType = h.indexType;
+    mesh.submeshes.assign(&file.submesh(0), &file.submesh(0) + h.submeshCount);
+    std::memcpy(&mesh.boundsMin, h.boundsMin, 12);
+    std::memcpy(&mesh.boundsMax, h.boundsMax, 12);
+}
+
+void drawMesh(const GpuMesh &mesh) {
+    const size_t indexSize = mesh.indexType == GL_UNSIGNED_SHORT ? 2 : 4;
+    glBindVertexArray(mesh.vao);
+    for (const MeshSubmesh &sub : mesh.submeshes)
+        glDrawRangeElements(GL_TRIANGLES, sub.minVertex, sub.maxVertex, sub.indexCount, mesh.indexType, (void*)(sub.firstIndex * indexSize));
+}
+
+
+// a torus knot as an obj, so there is always something big to bake
+bool writeTestObj(const std::string &path, int rings, int sides) {
+    std::ofstream out(path);
+    if (!out.is_open())
+        return false;
+    auto knot = [](float t) {
+        return glm::vec3((2.f + std::cos(3.f * t)) * std::cos(2.f * t), (2.f + std::cos(3.f * t)) * std::sin(2.f * t), std::sin(3.f * t));
+    };
+    char line[128];
+    const float tau = 6.2831853f;
+    for (int i = 0; i < rings; ++i) {
+        float t = tau * i / rings;
+        glm::vec3 center = knot(t);
+        glm::vec3 tangent = glm::normalize(knot(t + 1e-3f) - knot(t - 1e-3f));
+        glm::vec3 side = glm::normalize(glm::cross(tangent, glm::vec3(0.f, 0.f, 1.f)));
+        glm::vec3 up = glm::cross(side, tangent);
+        for (int j = 0; j < sides; ++j) {
+            float a = tau * j / sides;
+            glm::vec3 n = side * std::cos(a) + up * std::sin(a);
+            glm::vec3 p = center + n * 0.4f;
+            out.write(line, std::snprintf(line, sizeof(line), "v %f %f %f\nvn %f %f %f\n", p.x, p.y, p.z, n.x, n.y, n.z));
+        }
+    }
+    // uvs wrap around, so the seams need their own column/row of texcoords
+    for (int i = 0; i <= rings; ++i)
+        for (int j = 0; j <= sides; ++j)
+            out.write(line, std::snprintf(line, sizeof(line), "vt %f %f\n", float(i) / rings, float(j) / sides));
+    for (int i = 0; i < rings; ++i) {
+        if (i == 0 || i == rings / 2)
+            out << "usemtl " << (i ? "second_half" : "first_half") << "\n";
+        for (int j = 0; j < sides; ++j) {
+            int i1 = (i + 1) % rings, j1 = (j + 1) % sides;
+            int v[4] = {i * sides + j, i1 * sides + j, i1 * sides + j1, i * sides + j1};
+            int t[4] = {i * (sides + 1) + j, (i + 1) * (sides + 1) + j, (i + 1) * (sides + 1) + j + 1, i * (sides + 1) + j + 1};
+            out.write(line, std::snprintf(line, sizeof(line), "f %d/%d/%d %d/%d/%d %d/%d/%d %d/%d/%d\n",
+                                          v[0] + 1, t[0] + 1, v[0] + 1, v[1] + 1, t[1] + 1, v[1] + 1,
+                                          v[2] + 1, t[2] + 1, v[2] + 1, v[3] + 1, t[3] + 1, v[3] + 1));
+        }
+    }
+    return bool(out);
+}
+
+int runBake(const std::string &in, const std::string &out) {
+    RawMesh mesh;
+    auto start = std::chrono::steady_clock::now();
+    if (!importMesh(in, mesh))
+        return EXIT_FAILURE;
+    double importMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    BakeStats stats;
+    if (!bakeMesh(mesh, out, stats))
+        return EXIT_FAILURE;
+    double totalMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    std::cout << in << " -> " << out << ": " << stats.inputVertices << " vertices welded to " << stats.outputVertices
+              << ", " << stats.triangles << " triangles (" << stats.degenerate << " degenerate dropped)\n"
+              << "ACMR " << stats.acmrBefore << " -> " << stats.acmrAfter << ", quantization error up to " << stats.maxPositionError
+              << ", " << stats.fileSize / 1024 << "KB\n"
+              << "import " << importMs << "ms, bake " << totalMs - importMs << "ms\n";
+    return EXIT_SUCCESS;
+}
+
+// drops the file from the page cache, so the next read really goes to the disk
+void evictFromCache(const char *path) {
+    int fd = ::open(path, O_RDONLY);
+    if (fd < 0)
+        return;
+    fdatasync(fd);
+    posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+    ::close(fd);
+}
+
+// ./main --bench [rings]
+// bakes a big generated model and compares a cold load of the baked file against a plain read of the same
+// bytes and against importing the obj. the baked load copies every section like glBufferData would
+int runBenchmark(int rings) {
+    const std::string objPath = "./bench.obj", meshPath = "./bench.mesh";
+    if (!writeTestObj(objPath, rings, rings / 8)) {
+        std::cerr << "ERROR::BENCH - can't write " << objPath << "\n";
+        return EXIT_FAILURE;
+    }
+    if (runBake(objPath, meshPath) != EXIT_SUCCESS)
+        return EXIT_FAILURE;
+
+    constexpr int REPEATS = 5;
+    double bestRead = 1e9, bestMapped = 1e9, bestObj = 1e9;
+    std::vector<char> sink;
+    size_t size = 0;
+    for (int r = 0; r < REPEATS; ++r) {
+        // disk speed: read() the file into memory
+        evictFromCache(meshPath.c_str());
+        auto start = std::chrono::steady_clock::now();
+        {
+            int fd = ::open(meshPath.c_str(), O_RDONLY);
+            struct stat st;
+            fstat(fd, &st);
+            size = st.st_size;
+            sink.resize(size);
+            for (size_t done = 0; done < size;) {
+                ssize_t n = ::read(fd, sink.data() + done, size - done);
+                if (n <= 0)
+                    break;
+                done += n;
+            }
+            ::close(fd);
+        }
+        bestRead = std::min(bestRead, std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+
+        // baked: map, validate and copy the buffers out, which is what glBufferData does with them
+        evictFromCache(meshPath.c_str());
+        start = std::chrono::steady_clock::now();
+        {
+            MappedMesh mapped;
+            if (!mapped.open(meshPath.c_str()))
+                return EXIT_FAILURE;
+            const MeshFileHeader &h = mapped.header();
+            const size_t vertexBytes = h.attributeOffset + h.vertexCount * sizeof(PackedAttributes) - h.positionOffset;
+            std::memcpy(sink.data(), mapped.data() + h.positionOffset, vertexBytes);
+            std::memcpy(sink.data() + vertexBytes, mapped.data() + h.indexOffset, mapped.indexBytes());
+        }
+        bestMapped = std::min(bestMapped, std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+
+        // what we would be doing without the baker, warm cache even
+        start = std::chrono::steady_clock::now();
+        RawMesh mesh;
+        importObj(objPath, mesh);
+        bestObj = std::min(bestObj, std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+    }
+    std::cout << size / 1024 << "KB baked, cold\n"
+              << "  read():        " << bestRead << "ms, " << size / bestRead / 1e3 << " MB/s\n"
+              << "  mapped load:   " << bestMapped << "ms, " << size / bestMapped / 1e3 << " MB/s\n"
+              << "  obj import:    " << bestObj << "ms (warm cache, no welding or optimizing)\n";
+    std::remove(objPath.c_str());
+    std::remove(meshPath.c_str());
+    return EXIT_SUCCESS;
+}
+
+
+void processInput(GLFWwindow *window, glm::vec3 &cameraPos, glm::vec3 &cameraFront, glm::vec3 &cameraUp)
+{
+
+    const float cameraSpeed = 0.05f; // adjust accordingly
+    if (glfwGetKey(window, GLFW_KEY_W) == GLFW_PRESS)
+        cameraPos += cameraSpeed * cameraFront;
+    if (glfwGetKey(window, GLFW_KEY_S) == GLFW_PRESS)
+        cameraPos -= cameraSpeed * cameraFront;
+    if (glfwGetKey(window, GLFW_KEY_A) == GLFW_PRESS)
+        cameraPos -= glm::normalize(glm::cross(cameraFront, cameraUp)) * cameraSpeed;
+    if (glfwGetKey(window, GLFW_KEY_D) == GLFW_PRESS)
+        cameraPos += glm::normalize(glm::cross(cameraFront, cameraUp)) * cameraSpeed;
+    if (glfwGetKey(window, GLFW_KEY_UP) == GLFW_PRESS)
+        cameraPos += glm::normalize(glm::cross(cameraFront, cameraUp)) * cameraSpeed;
+
+}
+
+float yaw = -90.f;
+float pitch = 0.f;
+glm::vec3 cameraFront;
+
+void mouseMovement(GLFWwindow *window, double xPos, double yPos) {
+    static float lastX = xPos, lastY = yPos;
+    float xOffset = xPos - lastX;
+    float yOffset = lastY - yPos;
+    
+    constexpr float sensitivity = 0.05f;
+    xOffset *= sensitivity;
+    yOffset *= sensitivity;
+
+    yaw += xOffset;
+    pitch += yOffset;
+
+    if (std::abs(pitch) > 89.f) // don't ever do it this way. I am lazy
+        pitch = std::abs(pitch) / pitch * 89.f;
+
+    cameraFront.x = cos(glm::radians(yaw)) * cos(glm::radians(pitch));
+    cameraFront.y = sin(glm::radians(pitch));
+    cameraFront.z = sin(glm::radians(yaw)) * cos(glm::radians(pitch));
+
+    cameraFront = glm::normalize(cameraFront);
+    lastX = xPos, lastY = yPos;
+}
+
+
+
+
+
+int main(int argc, char **argv) {
+    if (argc > 3 && !std::strcmp(argv[1], "--bake"))
+        return runBake(argv[2], argv[3]);
+    if (argc > 1 && !std::strcmp(argv[1], "--bench"))
+        return runBenchmark(argc > 2 ? std::atoi(argv[2]) : 4096);
+    // ./main [model.mesh], without one we bake a test model first
+    const char *meshPath = argc > 1 ? argv[1] : "./model.mesh";
+    if (argc <= 1 && access(meshPath, R_OK) != 0) {
+        if (!writeTestObj("./model.obj", 1024, 128) || runBake("./model.obj", meshPath) != EXIT_SUCCESS)
+            return EXIT_FAILURE;
+    }
+
+    if (glfwInit() != GLFW_TRUE) {
+        glfwTerminate();
+        std::cerr << "Failed to initialize GLFW";
+        return EXIT_FAILURE;
+    }
+    // setting OpenGL version to 3.3
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+    GLFWwindow *win = glfwCreateWindow(800, 600, "This is a hello window!", NULL, NULL);
+    // setting 'context' for OpenGL, i.e. where to draw on current thread
+    glfwMakeContextCurrent(win);
+    // all it does is fetches us the implemented functions of OpenGL
+    if (glewInit() != GLEW_OK) {
+        glfwTerminate();
+        std::cerr << "Failed to initialize GLEW\n";
+        return EXIT_FAILURE;
+    }
+    int screenWidth, screenHeight;
+    glfwGetFramebufferSize(win, &screenWidth, &screenHeight);
+    glViewport(0, 0, screenWidth, screenHeight);
+
+    glEnable(GL_DEPTH_TEST);
+
+    // no parsing here, the file already is what GL wants
+    auto start = std::chrono::steady_clock::now();
+    MappedMesh file;
+    if (!file.open(meshPath)) {
+        glfwTerminate();
+        return EXIT_FAILURE;
+    }
+    GpuMesh mesh;
+    uploadMesh(file, mesh);
+    file.close();
+    std::cout << meshPath << ": " << mesh.submeshes.size() << " submeshes loaded in "
+              << std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count() << "ms\n";
+
+
+    glm::vec3 cameraPos(0.f, 0.f, 8.f);
+    cameraFront = glm::vec3(0.f,0.f,-1.f);
+    glm::vec3 cameraUp(0.,1.,0.f);
+    
+
+    Texture2D tex;
+    tex.generate2DTex("./image2d.tex");
+    tex.bind();
+
+    VertexShader vs;
+    FragmentShader fs;
+    vs.setSource("./vertex.glsl");
+    fs.setSource("./frag.glsl");
+    Program prog;
+    prog.AttachShaders({&vs, &fs});
+    prog.UseProgram();
+
+    // positions come in as unorm16 inside the bounds
+    prog.setVec3("boundsMin", mesh.boundsMin);
+    prog.setVec3("boundsSize", mesh.boundsMax - mesh.boundsMin);
+
+    glm::mat4 view; // = glm::translate(glm::mat4(1.f), glm::vec3(0.f,0.f,-3.f));
+       
+
+    glm::mat4 proj = glm::perspective(glm::radians(45.f), float(screenWidth) / screenHeight, 0.1f, 100.f);
+    glm::mat4 model = glm::mat4(1.f);
+
+    prog.setMat4("proj", proj);
+    prog.setMat4("view", view);
+
+    glfwSetCursorPosCallback(win, mouseMovement); 
+    glfwSetInputMode(win, GLFW_CURSOR, GLFW_CURSOR_DISABLED);  
+    
+    while (!glfwWindowShouldClose(win)) {
+        processInput(win, cameraPos, cameraFront, cameraUp);
+        view = glm::lookAt(cameraPos, cameraFront + cameraPos, cameraUp);
+        model = glm::rotate(model, glm::radians(0.2f), glm::vec3(0.f, 1.f, 0.f));
+
+        prog.setMat4("view", view);
+        prog.setMat4("model", model);
+
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+        drawMesh(mesh);
+        // polls different kinds of events, for example, when we close an application, it fetches that event
+        // or it fetches events like movement of the window.
+        // Without it you can neither move the window or close the window
+        glfwPollEvents();
+        // have you drawn the image, it is stored in the buffer. You can now swap this buffer with main buffer
+        // so the image appears
+        glfwSwapBuffers(win);
+    }
+    glDeleteVertexArrays(1, &mesh.vao);
+    GLuint buffers[] = {mesh.vbo, mesh.ebo};
+    glDeleteBuffers(2, buffers);
+    glfwTerminate();
+    
+    std::cout << "Window should close now!\n";
+
+    return EXIT_SUCCESS;
+
+}
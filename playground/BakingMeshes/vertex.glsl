@@ -0,0 +1,23 @@
+#version 330 core
+
+// unorm16 position inside the mesh bounds, see MeshFileHeader
+layout(location = 0) in vec3 aPos;
+layout(location = 1) in vec2 aTexCoord;
+layout(location = 2) in vec3 aNormal;
+
+out vec2 texCoord;
+out vec3 normal;
+
+uniform mat4 proj;
+uniform mat4 view;
+uniform mat4 model;
+uniform vec3 boundsMin;
+uniform vec3 boundsSize;
+
+
+void main() {
+    vec3 pos = boundsMin + aPos * boundsSize;
+    gl_Position = proj * view * model * vec4(pos, 1.0);
+    normal = mat3(model) * aNormal;
+    texCoord = aTexCoord;
+}
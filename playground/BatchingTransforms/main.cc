@@ -0,0 +1,766 @@
+#include <GL/glew.h>
+
+#include <GLFW/glfw3.h>
+#include <algorithm>
+#include <cfloat>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <random>
+#include <vector>
+#include <glm/ext/matrix_clip_space.hpp>
+#include <glm/ext/matrix_transform.hpp>
+#include <glm/geometric.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/ext/matrix_float4x4.hpp>
+#include <glm/gtc/quaternion.hpp>
+#include <glm/gtc/type_ptr.hpp>
+#include <glm/glm.hpp>
+#include <glm/trigonometric.hpp>
+#define STB_IMAGE_IMPLEMENTATION
+#include <stb/stb_image.h>
+#include <iostream>
+
+class Shader {
+    std::string src; 
+protected:
+    const char *getsrc() {
+        return src.data();
+    }
+    GLuint shader_id = 0;
+    bool isCompiled = false;
+protected:
+    virtual const char *getClassName() = 0;
+    GLint getCompilationStatus(GLuint shader_id) {
+        int status;
+        glGetShaderiv(shader_id, GL_COMPILE_STATUS, &status);
+        return status;
+    }
+    void sendError() {
+        char buffer[1024];
+        glGetShaderInfoLog(shader_id, 1024, NULL, buffer);
+        std::cerr << "ERROR::" << getClassName() << " - " << buffer;
+    }
+public:
+    virtual void compile() = 0;
+    void setSource(const char *s) {
+        std::ifstream sourceFile(s);
+        if (!sourceFile.is_open())
+            return;
+        char buffer[8192];
+        while (sourceFile.read(buffer, 8192)) {
+            src.append(buffer, 8192);
+        }
+        if (!sourceFile.eof()) {
+            src.clear();
+            return;
+        }
+        src.append(buffer, sourceFile.gcount());
+    }
+    friend class Program;
+};
+
+
+class VertexShader : public Shader {
+    virtual const char *getClassName() override {
+        return "VertexShader";
+    }
+public:
+    virtual void compile() override {
+        if (shader_id)
+            glDeleteShader(shader_id);
+        shader_id = glCreateShader(GL_VERTEX_SHADER);
+        const char *src = getsrc();
+        glShaderSource(shader_id, 1, &src, NULL);
+        glCompileShader(shader_id);
+        if (!getCompilationStatus(shader_id)) {
+            sendError();
+        }
+        isCompiled = true;
+    }
+};
+
+class FragmentShader : public Shader {
+    const char *getClassName() override {
+        return "FragmentShader";
+    }
+public:
+    virtual void compile() override {
+        if (shader_id)
+            glDeleteShader(shader_id);
+        shader_id = glCreateShader(GL_FRAGMENT_SHADER);
+        const char *src = getsrc();
+        glShaderSource(shader_id, 1, &src, NULL);
+        glCompileShader(shader_id);
+        if (!getCompilationStatus(shader_id)) {
+            sendError();
+        }
+        isCompiled = true;
+    }
+};
+
+
+class Program {
+    GLuint program_id = 0;
+    void sendError() {
+        char buffer[1024];
+        glGetProgramInfoLog(program_id, 1024, NULL, buffer);
+        std::cerr << "ERROR::PROGRAM: " << " - " << buffer;
+    }
+    bool linkStatus() {
+        int status = 0;
+        glGetProgramiv(program_id, GL_LINK_STATUS, &status);
+        return status;
+    }
+public:
+    Program() {
+        program_id = glCreateProgram();
+    }
+    ~Program() {
+        glDeleteProgram(program_id);
+    }
+    void AttachShaders(std::initializer_list<Shader*> shaders) {
+        auto i = shaders.begin();
+        while (i != shaders.end()) {
+            if (!(*i)->isCompiled)
+                (*i)->compile();
+            glAttachShader(program_id, (*i)->shader_id);
+            ++i;
+        }
+        glLinkProgram(program_id);
+        if (!linkStatus()) {
+            sendError();
+        }
+    }
+    void UseProgram() {
+        glUseProgram(program_id);
+    }
+    void setMat4(const char *locName, const glm::mat4 &mat) {
+        int location = glGetUniformLocation(program_id, locName);
+        if (location == -1)
+            return;
+        glUniformMatrix4fv(location, 1, GL_FALSE, glm::value_ptr(mat));
+    }
+};
+
+
+class Texture2D {
+    GLuint tex_id;
+public:
+    void generate2DTex(const char *image_path) {
+        int width, height, nChannels;
+        stbi_set_flip_vertically_on_load(true);
+        uint8_t *raw_image = stbi_load(image_path, &width, &height, &nChannels, 0);
+        float borderColor[] = {1.f, 1.f, 1.f, 1.f};
+        glGenTextures(1, &tex_id);
+        glBindTexture(GL_TEXTURE_2D, tex_id);
+        // what to do when primitive is bigger than the texture
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_BORDER);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_BORDER);
+        glTexParameterfv(GL_TEXTURE_2D, GL_TEXTURE_BORDER_COLOR, borderColor);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        // glTexImage2D(TARGET_TYPE, IM_MIPMAP_LEVEL, TARGET_NRCHANNELS, SRC_WIDTH, SRC_HEIGHT, LEGACY_0, SRC_NRCHANNELS, SRC_DATA_TYPE, SRC_DATA);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, width, height, 0, GL_RGB, GL_UNSIGNED_BYTE, raw_image);
+        stbi_image_free(raw_image);
+    }
+    void bind() {
+        glBindTexture(GL_TEXTURE_2D, tex_id);
+    }
+};
+
+
+// instance transforms as structure of arrays, one array per component, padded to a whole block
+struct TransformSoA {
+    std::vector<float> px, py, pz;
+    std::vector<float> qx, qy, qz, qw;
+    std::vector<float> sx, sy, sz;
+    size_t count = 0;
+
+    void resize(size_t n);
+    void set(size_t i, const glm::vec3 &pos, const glm::quat &rot, const glm::vec3 &scale) {
+        px[i] = pos.x, py[i] = pos.y, pz[i] = pos.z;
+        qx[i] = rot.x, qy[i] = rot.y, qz[i] = rot.z, qw[i] = rot.w;
+        sx[i] = scale.x, sy[i] = scale.y, sz[i] = scale.z;
+    }
+};
+
+// matrices as array of structures of arrays: a block holds BLOCK matrices, element by element.
+// m[c * 4 + r][lane] is column c, row r of matrix lane, same as glm's m[c][r]
+constexpr size_t BLOCK = 16;
+
+struct alignas(64) Mat4Block {
+    float m[16][BLOCK];
+};
+
+struct alignas(64) Mat3Block {
+    float m[9][BLOCK];
+};
+
+// world space bounds, also structure of arrays per block
+struct alignas(64) AABBBlock {
+    float minX[BLOCK], minY[BLOCK], minZ[BLOCK];
+    float maxX[BLOCK], maxY[BLOCK], maxZ[BLOCK];
+};
+
+size_t blockCount(size_t n) {
+    return (n + BLOCK - 1) / BLOCK;
+}
+
+void TransformSoA::resize(size_t n) {
+    count = n;
+    // padding lanes get an identity transform so the kernels never see garbage
+    size_t padded = blockCount(n) * BLOCK;
+    for (std::vector<float> *v : {&px, &py, &pz, &qx, &qy, &qz})
+        v->resize(padded, 0.f);
+    for (std::vector<float> *v : {&qw, &sx, &sy, &sz})
+        v->resize(padded, 1.f);
+}
+
+
+// the kernels are written once against "V", which is either a plain float (the scalar fallback)
+// or one of gcc's vector types. they are always inlined into a wrapper compiled for the instruction
+// set we picked, so the same source becomes scalar, AVX2 or AVX-512 code
+// (gcc warns that passing these around changes the ABI, which is fine, nothing here is ever a real call)
+#pragma GCC diagnostic ignored "-Wpsabi"
+typedef float f32x8 __attribute__((vector_size(32)));
+typedef float f32x16 __attribute__((vector_size(64)));
+
+#define TRANSFORM_INLINE __attribute__((always_inline)) inline
+
+template <typename V>
+TRANSFORM_INLINE V load(const float *p) {
+    V v;
+    std::memcpy(&v, p, sizeof(V));
+    return v;
+}
+
+template <typename V>
+TRANSFORM_INLINE void store(float *p, V v) {
+    std::memcpy(p, &v, sizeof(V));
+}
+
+template <typename V>
+TRANSFORM_INLINE V splat(float s) {
+    return V{} + s;
+}
+
+template <typename V>
+TRANSFORM_INLINE V vabs(V v) {
+    return v < 0 ? -v : v;
+}
+
+template <typename V>
+TRANSFORM_INLINE V vmin(V a, V b) {
+    return a < b ? a : b;
+}
+
+template <typename V>
+TRANSFORM_INLINE V vmax(V a, V b) {
+    return a > b ? a : b;
+}
+
+// model = translate * rotate(quat) * scale
+template <typename V>
+TRANSFORM_INLINE void composeTRS(const TransformSoA &in, Mat4Block *out) {
+    constexpr size_t W = sizeof(V) / sizeof(float);
+    const size_t blocks = blockCount(in.count);
+    for (size_t b = 0; b < blocks; ++b) {
+        Mat4Block &o = out[b];
+        for (size_t l = 0; l < BLOCK; l += W) {
+            const size_t i = b * BLOCK + l;
+            V x = load<V>(&in.qx[i]), y = load<V>(&in.qy[i]), z = load<V>(&in.qz[i]), w = load<V>(&in.qw[i]);
+            V sx = load<V>(&in.sx[i]), sy = load<V>(&in.sy[i]), sz = load<V>(&in.sz[i]);
+            V xx = x * x, yy = y * y, zz = z * z;
+            V xy = x * y, xz = x * z, yz = y * z;
+            V wx = w * x, wy = w * y, wz = w * z;
+            const V one = splat<V>(1.f), two = splat<V>(2.f), zero = splat<V>(0.f);
+            store(&o.m[0][l], (one - two * (yy + zz)) * sx);
+            store(&o.m[1][l], two * (xy + wz) * sx);
+            store(&o.m[2][l], two * (xz - wy) * sx);
+            store(&o.m[3][l], zero);
+            store(&o.m[4][l], two * (xy - wz) * sy);
+            store(&o.m[5][l], (one - two * (xx + zz)) * sy);
+            store(&o.m[6][l], two * (yz + wx) * sy);
+            store(&o.m[7][l], zero);
+            store(&o.m[8][l], two * (xz + wy) * sz);
+            store(&o.m[9][l], two * (yz - wx) * sz);
+            store(&o.m[10][l], (one - two * (xx + yy)) * sz);
+            store(&o.m[11][l], zero);
+            store(&o.m[12][l], load<V>(&in.px[i]));
+            store(&o.m[13][l], load<V>(&in.py[i]));
+            store(&o.m[14][l], load<V>(&in.pz[i]));
+            store(&o.m[15][l], one);
+        }
+    }
+}
+
+// out = viewProj * model for every model, viewProj is the same for all of them
+template <typename V>
+TRANSFORM_INLINE void multiplyShared(const glm::mat4 &viewProj, const Mat4Block *in, Mat4Block *out, size_t count) {
+    constexpr size_t W = sizeof(V) / sizeof(float);
+    const size_t blocks = blockCount(count);
+    V a[16];
+    for (int c = 0; c < 4; ++c)
+        for (int r = 0; r < 4; ++r)
+            a[c * 4 + r] = splat<V>(viewProj[c][r]);
+    for (size_t b = 0; b < blocks; ++b) {
+        for (size_t l = 0; l < BLOCK; l += W) {
+            for (int c = 0; c < 4; ++c) {
+                V m0 = load<V>(&in[b].m[c * 4 + 0][l]);
+                V m1 = load<V>(&in[b].m[c * 4 + 1][l]);
+                V m2 = load<V>(&in[b].m[c * 4 + 2][l]);
+                V m3 = load<V>(&in[b].m[c * 4 + 3][l]);
+                for (int r = 0; r < 4; ++r)
+                    store(&out[b].m[c * 4 + r][l], a[r] * m0 + a[4 + r] * m1 + a[8 + r] * m2 + a[12 + r] * m3);
+            }
+        }
+    }
+}
+
+// inverse transpose of the upper 3x3, which is just the cofactor matrix over the determinant
+template <typename V>
+TRANSFORM_INLINE void normalMatrices(const Mat4Block *in, Mat3Block *out, size_t count) {
+    constexpr size_t W = sizeof(V) / sizeof(float);
+    const size_t blocks = blockCount(count);
+    for (size_t b = 0; b < blocks; ++b) {
+        for (size_t l = 0; l < BLOCK; l += W) {
+            const Mat4Block &m = in[b];
+            V a0 = load<V>(&m.m[0][l]), a1 = load<V>(&m.m[1][l]), a2 = load<V>(&m.m[2][l]);
+            V b0 = load<V>(&m.m[4][l]), b1 = load<V>(&m.m[5][l]), b2 = load<V>(&m.m[6][l]);
+            V c0 = load<V>(&m.m[8][l]), c1 = load<V>(&m.m[9][l]), c2 = load<V>(&m.m[10][l]);
+            // columns of the cofactor matrix are cross products of the other two columns
+            V x0 = b1 * c2 - b2 * c1, x1 = b2 * c0 - b0 * c2, x2 = b0 * c1 - b1 * c0;
+            V y0 = c1 * a2 - c2 * a1, y1 = c2 * a0 - c0 * a2, y2 = c0 * a1 - c1 * a0;
+            V z0 = a1 * b2 - a2 * b1, z1 = a2 * b0 - a0 * b2, z2 = a0 * b1 - a1 * b0;
+            V invDet = splat<V>(1.f) / (a0 * x0 + a1 * x1 + a2 * x2);
+            Mat3Block &o = out[b];
+            store(&o.m[0][l], x0 * invDet);
+            store(&o.m[1][l], x1 * invDet);
+            store(&o.m[2][l], x2 * invDet);
+            store(&o.m[3][l], y0 * invDet);
+            store(&o.m[4][l], y1 * invDet);
+            store(&o.m[5][l], y2 * invDet);
+            store(&o.m[6][l], z0 * invDet);
+            store(&o.m[7][l], z1 * invDet);
+            store(&o.m[8][l], z2 * invDet);
+        }
+    }
+}
+
+// world space box of a local box (center + half extents, shared by all instances of a mesh)
+template <typename V>
+TRANSFORM_INLINE void transformBounds(const Mat4Block *in, const glm::vec3 &center, const glm::vec3 &extent, AABBBlock *out, size_t count) {
+    constexpr size_t W = sizeof(V) / sizeof(float);
+    const size_t blocks = blockCount(count);
+    const V cx = splat<V>(center.x), cy = splat<V>(center.y), cz = splat<V>(center.z);
+    const V ex = splat<V>(extent.x), ey = splat<V>(extent.y), ez = splat<V>(extent.z);
+    for (size_t b = 0; b < blocks; ++b) {
+        for (size_t l = 0; l < BLOCK; l += W) {
+            const Mat4Block &m = in[b];
+            V c[3], e[3];
+            for (int r = 0; r < 3; ++r) {
+                V m0 = load<V>(&m.m[r][l]), m1 = load<V>(&m.m[4 + r][l]), m2 = load<V>(&m.m[8 + r][l]);
+                c[r] = m0 * cx + m1 * cy + m2 * cz + load<V>(&m.m[12 + r][l]);
+                e[r] = vabs(m0) * ex + vabs(m1) * ey + vabs(m2) * ez;
+            }
+            AABBBlock &o = out[b];
+            store(&o.minX[l], c[0] - e[0]);
+            store(&o.minY[l], c[1] - e[1]);
+            store(&o.minZ[l], c[2] - e[2]);
+            store(&o.maxX[l], c[0] + e[0]);
+            store(&o.maxY[l], c[1] + e[1]);
+            store(&o.maxZ[l], c[2] + e[2]);
+        }
+    }
+}
+
+// what the vertex shader wants: plain column major matrices one after another
+void storeMatrices(const Mat4Block *in, size_t count, glm::mat4 *out) {
+    for (size_t i = 0; i < count; ++i) {
+        const Mat4Block &b = in[i / BLOCK];
+        float *dst = &out[i][0][0];
+        for (int e = 0; e < 16; ++e)
+            dst[e] = b.m[e][i % BLOCK];
+    }
+}
+
+
+struct TransformKernels {
+    const char *name;
+    void (*compose)(const TransformSoA &in, Mat4Block *out);
+    void (*multiply)(const glm::mat4 &viewProj, const Mat4Block *in, Mat4Block *out, size_t count);
+    void (*normals)(const Mat4Block *in, Mat3Block *out, size_t count);
+    void (*bounds)(const Mat4Block *in, const glm::vec3 &center, const glm::vec3 &extent, AABBBlock *out, size_t count);
+};
+
+#define TRANSFORM_KERNELS(NAME, TARGET, V) \
+    TARGET void compose##NAME(const TransformSoA &in, Mat4Block *out) { \
+        composeTRS<V>(in, out); \
+    } \
+    TARGET void multiply##NAME(const glm::mat4 &viewProj, const Mat4Block *in, Mat4Block *out, size_t count) { \
+        multiplyShared<V>(viewProj, in, out, count); \
+    } \
+    TARGET void normals##NAME(const Mat4Block *in, Mat3Block *out, size_t count) { \
+        normalMatrices<V>(in, out, count); \
+    } \
+    TARGET void bounds##NAME(const Mat4Block *in, const glm::vec3 &center, const glm::vec3 &extent, AABBBlock *out, size_t count) { \
+        transformBounds<V>(in, center, extent, out, count); \
+    } \
+    const TransformKernels kernels##NAME = {#NAME, compose##NAME, multiply##NAME, normals##NAME, bounds##NAME};
+
+// the scalar one is built with auto vectorization off, otherwise it isn't much of a reference
+TRANSFORM_KERNELS(Scalar, __attribute__((optimize("no-tree-vectorize"))), float)
+TRANSFORM_KERNELS(AVX2, __attribute__((target("avx2,fma"))), f32x8)
+TRANSFORM_KERNELS(AVX512, __attribute__((target("avx512f"))), f32x16)
+
+const TransformKernels &selectKernels() {
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f"))
+        return kernelsAVX512;
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma"))
+        return kernelsAVX2;
+    return kernelsScalar;
+}
+
+
+// the same work done the way we did it so far, one glm call chain per object
+void transformReference(const TransformSoA &in, const glm::mat4 &viewProj, const glm::vec3 &center, const glm::vec3 &extent,
+                        glm::mat4 *mvp, glm::mat3 *normal, glm::vec3 *boundsMin, glm::vec3 *boundsMax) {
+    for (size_t i = 0; i < in.count; ++i) {
+        glm::quat q(in.qw[i], in.qx[i], in.qy[i], in.qz[i]);
+        glm::mat4 model = glm::translate(glm::mat4(1.f), glm::vec3(in.px[i], in.py[i], in.pz[i]));
+        model = model * glm::mat4_cast(q);
+        model = glm::scale(model, glm::vec3(in.sx[i], in.sy[i], in.sz[i]));
+        mvp[i] = viewProj * model;
+        normal[i] = glm::transpose(glm::inverse(glm::mat3(model)));
+        glm::vec3 lo(FLT_MAX), hi(-FLT_MAX);
+        for (int corner = 0; corner < 8; ++corner) {
+            glm::vec3 sign(corner & 1 ? 1.f : -1.f, corner & 2 ? 1.f : -1.f, corner & 4 ? 1.f : -1.f);
+            glm::vec3 p = glm::vec3(model * glm::vec4(center + sign * extent, 1.f));
+            lo = glm::min(lo, p);
+            hi = glm::max(hi, p);
+        }
+        boundsMin[i] = lo;
+        boundsMax[i] = hi;
+    }
+}
+
+void randomTransforms(TransformSoA &soa, size_t count) {
+    std::mt19937 rng(1234);
+    std::uniform_real_distribution<float> pos(-100.f, 100.f), unit(-1.f, 1.f), scale(0.5f, 2.f);
+    soa.resize(count);
+    for (size_t i = 0; i < count; ++i) {
+        glm::quat q = glm::angleAxis(unit(rng) * 3.14159f, glm::normalize(glm::vec3(unit(rng), unit(rng), unit(rng)) + glm::vec3(0.f, 0.f, 1e-3f)));
+        soa.set(i, glm::vec3(pos(rng), pos(rng), pos(rng)), q, glm::vec3(scale(rng), scale(rng), scale(rng)));
+    }
+}
+
+double secondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+float maxError(const float *a, const float *b, size_t n) {
+    float err = 0.f;
+    for (size_t i = 0; i < n; ++i)
+        err = std::max(err, std::abs(a[i] - b[i]) / std::max(1.f, std::abs(b[i])));
+    return err;
+}
+
+// ./main --bench [instances]
+// times glm against each kernel set this CPU can run, and checks every kernel against glm
+int runBenchmark(size_t count) {
+    constexpr int REPEATS = 20;
+    TransformSoA soa;
+    randomTransforms(soa, count);
+    const glm::mat4 viewProj = glm::perspective(glm::radians(45.f), 800 / 600.f, 0.1f, 100.f)
+                             * glm::lookAt(glm::vec3(0.f, 0.f, 3.f), glm::vec3(0.f), glm::vec3(0.f, 1.f, 0.f));
+    const glm::vec3 center(0.f), extent(0.5f);
+
+    std::vector<glm::mat4> refMvp(count);
+    std::vector<glm::mat3> refNormal(count);
+    std::vector<glm::vec3> refMin(count), refMax(count);
+    double best = 1e9;
+    for (int r = 0; r < REPEATS; ++r) {
+        auto start = std::chrono::steady_clock::now();
+        transformReference(soa, viewProj, center, extent, refMvp.data(), refNormal.data(), refMin.data(), refMax.data());
+        best = std::min(best, secondsSince(start));
+    }
+    const double reference = best;
+    std::cout << "glm per object: " << best * 1e9 / count << " ns/instance\n";
+
+    std::vector<Mat4Block> model(blockCount(count)), mvp(blockCount(count));
+    std::vector<Mat3Block> normal(blockCount(count));
+    std::vector<AABBBlock> bounds(blockCount(count));
+    std::vector<glm::mat4> mvpOut(count);
+    bool ok = true;
+
+    __builtin_cpu_init();
+    const bool haveAVX2 = __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+    const bool haveAVX512 = __builtin_cpu_supports("avx512f");
+    for (const TransformKernels *k : {&kernelsScalar, &kernelsAVX2, &kernelsAVX512}) {
+        if ((k == &kernelsAVX2 && !haveAVX2) || (k == &kernelsAVX512 && !haveAVX512)) {
+            std::cout << k->name << ": not supported here\n";
+            continue;
+        }
+        double stage[4] = {1e9, 1e9, 1e9, 1e9};
+        for (int r = 0; r < REPEATS; ++r) {
+            auto start = std::chrono::steady_clock::now();
+            k->compose(soa, model.data());
+            stage[0] = std::min(stage[0], secondsSince(start));
+            start = std::chrono::steady_clock::now();
+            k->multiply(viewProj, model.data(), mvp.data(), count);
+            stage[1] = std::min(stage[1], secondsSince(start));
+            start = std::chrono::steady_clock::now();
+            k->normals(model.data(), normal.data(), count);
+            stage[2] = std::min(stage[2], secondsSince(start));
+            start = std::chrono::steady_clock::now();
+            k->bounds(model.data(), center, extent, bounds.data(), count);
+            stage[3] = std::min(stage[3], secondsSince(start));
+        }
+        const double total = stage[0] + stage[1] + stage[2] + stage[3];
+        std::cout << k->name << ": " << total * 1e9 / count << " ns/instance ("
+                  << "compose " << stage[0] * 1e9 / count
+                  << ", mvp " << stage[1] * 1e9 / count
+                  << ", normal " << stage[2] * 1e9 / count
+                  << ", bounds " << stage[3] * 1e9 / count
+                  << "), " << reference / total << "x glm\n";
+
+        // compare against glm, relative error because positions go up to 100
+        storeMatrices(mvp.data(), count, mvpOut.data());
+        float err = maxError(&mvpOut[0][0][0], &refMvp[0][0][0], count * 16);
+        for (size_t i = 0; i < count; ++i) {
+            const Mat3Block &nb = normal[i / BLOCK];
+            const AABBBlock &bb = bounds[i / BLOCK];
+            const size_t l = i % BLOCK;
+            float n[9];
+            for (int e = 0; e < 9; ++e)
+                n[e] = nb.m[e][l];
+            const float lo[3] = {bb.minX[l], bb.minY[l], bb.minZ[l]}, hi[3] = {bb.maxX[l], bb.maxY[l], bb.maxZ[l]};
+            err = std::max(err, maxError(n, &refNormal[i][0][0], 9));
+            err = std::max(err, maxError(lo, &refMin[i].x, 3));
+            err = std::max(err, maxError(hi, &refMax[i].x, 3));
+        }
+        if (err > 1e-3f) {
+            std::cout << k->name << ": MISMATCH against glm, max relative error " << err << "\n";
+            ok = false;
+        }
+    }
+    return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+
+void processInput(GLFWwindow *window, glm::vec3 &cameraPos, glm::vec3 &cameraFront, glm::vec3 &cameraUp)
+{
+
+    const float cameraSpeed = 0.05f; // adjust accordingly
+    if (glfwGetKey(window, GLFW_KEY_W) == GLFW_PRESS)
+        cameraPos += cameraSpeed * cameraFront;
+    if (glfwGetKey(window, GLFW_KEY_S) == GLFW_PRESS)
+        cameraPos -= cameraSpeed * cameraFront;
+    if (glfwGetKey(window, GLFW_KEY_A) == GLFW_PRESS)
+        cameraPos -= glm::normalize(glm::cross(cameraFront, cameraUp)) * cameraSpeed;
+    if (glfwGetKey(window, GLFW_KEY_D) == GLFW_PRESS)
+        cameraPos += glm::normalize(glm::cross(cameraFront, cameraUp)) * cameraSpeed;
+    if (glfwGetKey(window, GLFW_KEY_UP) == GLFW_PRESS)
+        cameraPos += glm::normalize(glm::cross(cameraFront, cameraUp)) * cameraSpeed;
+
+}
+
+
+float yaw = -90.f;
+float pitch = 0.f;
+glm::vec3 cameraFront;
+
+void mouseMovement(GLFWwindow *window, double xPos, double yPos) {
+    static float lastX = xPos, lastY = yPos;
+    float xOffset = xPos - lastX;
+    float yOffset = lastY - yPos;
+    
+    constexpr float sensitivity = 0.05f;
+    xOffset *= sensitivity;
+    yOffset *= sensitivity;
+
+    yaw += xOffset;
+    pitch += yOffset;
+
+    if (std::abs(pitch) > 89.f) // don't ever do it this way. I am lazy
+        pitch = std::abs(pitch) / pitch * 89.f;
+
+    cameraFront.x = cos(glm::radians(yaw)) * cos(glm::radians(pitch));
+    cameraFront.y = sin(glm::radians(pitch));
+    cameraFront.z = sin(glm::radians(yaw)) * cos(glm::radians(pitch));
+
+    cameraFront = glm::normalize(cameraFront);
+    lastX = xPos, lastY = yPos;
+}
+
+
+
+
+
+int main(int argc, char **argv) {
+    if (argc > 1 && !std::strcmp(argv[1], "--bench"))
+        return runBenchmark(argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 100000);
+
+    if (glfwInit() != GLFW_TRUE) {
+        glfwTerminate();
+        std::cerr << "Failed to initialize GLFW";
+        return EXIT_FAILURE;
+    }
+    // setting OpenGL version to 3.3
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+    GLFWwindow *win = glfwCreateWindow(600, 600, "This is a hello window!", NULL, NULL);
+    glViewport(0, 0, 600, 600);
+    // setting 'context' for OpenGL, i.e. where to draw on current thread
+    glfwMakeContextCurrent(win);
+    // all it does is fetches us the implemented functions of OpenGL
+    if (glewInit() != GLEW_OK) {
+        glfwTerminate();
+        std::cerr << "Failed to initialize GLEW\n";
+        return EXIT_FAILURE;
+    }
+
+    glEnable(GL_DEPTH_TEST);
+    float triangle_data[] = {
+        //   vertpos   //  //texcord//
+    -0.5f, -0.5f, -0.5f,  0.0f, 0.0f,
+     0.5f, -0.5f, -0.5f,  1.0f, 0.0f,
+     0.5f,  0.5f, -0.5f,  1.0f, 1.0f,
+     0.5f,  0.5f, -0.5f,  1.0f, 1.0f,
+    -0.5f,  0.5f, -0.5f,  0.0f, 1.0f,
+    -0.5f, -0.5f, -0.5f,  0.0f, 0.0f,
+
+    -0.5f, -0.5f,  0.5f,  0.0f, 0.0f,
+     0.5f, -0.5f,  0.5f,  1.0f, 0.0f,
+     0.5f,  0.5f,  0.5f,  1.0f, 1.0f,
+     0.5f,  0.5f,  0.5f,  1.0f, 1.0f,
+    -0.5f,  0.5f,  0.5f,  0.0f, 1.0f,
+    -0.5f, -0.5f,  0.5f,  0.0f, 0.0f,
+
+    -0.5f,  0.5f,  0.5f,  1.0f, 0.0f,
+    -0.5f,  0.5f, -0.5f,  1.0f, 1.0f,
+    -0.5f, -0.5f, -0.5f,  0.0f, 1.0f,
+    -0.5f, -0.5f, -0.5f,  0.0f, 1.0f,
+    -0.5f, -0.5f,  0.5f,  0.0f, 0.0f,
+    -0.5f,  0.5f,  0.5f,  1.0f, 0.0f,
+
+     0.5f,  0.5f,  0.5f,  1.0f, 0.0f,
+     0.5f,  0.5f, -0.5f,  1.0f, 1.0f,
+     0.5f, -0.5f, -0.5f,  0.0f, 1.0f,
+     0.5f, -0.5f, -0.5f,  0.0f, 1.0f,
+     0.5f, -0.5f,  0.5f,  0.0f, 0.0f,
+     0.5f,  0.5f,  0.5f,  1.0f, 0.0f,
+
+    -0.5f, -0.5f, -0.5f,  0.0f, 1.0f,
+     0.5f, -0.5f, -0.5f,  1.0f, 1.0f,
+     0.5f, -0.5f,  0.5f,  1.0f, 0.0f,
+     0.5f, -0.5f,  0.5f,  1.0f, 0.0f,
+    -0.5f, -0.5f,  0.5f,  0.0f, 0.0f,
+    -0.5f, -0.5f, -0.5f,  0.0f, 1.0f,
+
+    -0.5f,  0.5f, -0.5f,  0.0f, 1.0f,
+     0.5f,  0.5f, -0.5f,  1.0f, 1.0f,
+     0.5f,  0.5f,  0.5f,  1.0f, 0.0f,
+     0.5f,  0.5f,  0.5f,  1.0f, 0.0f,
+    -0.5f,  0.5f,  0.5f,  0.0f, 0.0f,
+    -0.5f,  0.5f, -0.5f,  0.0f, 1.0f
+        
+    };
+
+
+    glm::vec3 cameraPos(0.f, 0.f, 3.f);
+    cameraFront = glm::vec3(0.f,0.f,-1.f);
+    glm::vec3 cameraUp(0.,1.,0.f);
+    
+
+    Texture2D tex;
+    tex.generate2DTex("./image2d.tex");
+    tex.bind();
+
+    GLuint vbo = 0;
+    glGenBuffers(1, &vbo); 
+    glBindBuffer(GL_ARRAY_BUFFER, vbo);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(triangle_data), triangle_data, GL_STATIC_DRAW);
+
+    GLuint vao = 0;
+    glGenVertexArrays(1, &vao);
+    glBindVertexArray(vao);
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)0);
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)(3 * sizeof(float)));
+    glEnableVertexAttribArray(1);
+
+    // a grid of cubes, each spinning on its own
+    constexpr int GRID = 100;
+    constexpr size_t COUNT = GRID * GRID;
+    TransformSoA transforms;
+    transforms.resize(COUNT);
+    std::vector<Mat4Block> models(blockCount(COUNT)), mvps(blockCount(COUNT));
+    std::vector<glm::mat4> mvpUpload(COUNT);
+    const TransformKernels &kernels = selectKernels();
+    std::cout << "transform kernels: " << kernels.name << "\n";
+
+    // one mvp per instance, a mat4 attribute takes 4 locations
+    GLuint instanceVbo = 0;
+    glGenBuffers(1, &instanceVbo);
+    glBindBuffer(GL_ARRAY_BUFFER, instanceVbo);
+    glBufferData(GL_ARRAY_BUFFER, COUNT * sizeof(glm::mat4), NULL, GL_STREAM_DRAW);
+    for (int i = 0; i < 4; ++i) {
+        glVertexAttribPointer(2 + i, 4, GL_FLOAT, GL_FALSE, sizeof(glm::mat4), (void*)(i * sizeof(glm::vec4)));
+        glEnableVertexAttribArray(2 + i);
+        glVertexAttribDivisor(2 + i, 1);
+    }
+
+    VertexShader vs;
+    FragmentShader fs;
+    vs.setSource("./vertex.glsl");
+    fs.setSource("./frag.glsl");
+    Program prog;
+    prog.AttachShaders({&vs, &fs});
+    prog.UseProgram();
+
+
+    glm::mat4 view; // = glm::translate(glm::mat4(1.f), glm::vec3(0.f,0.f,-3.f));
+       
+
+    glm::mat4 proj = glm::perspective(glm::radians(45.f), 800 / 600.f, 0.1f, 100.f);
+
+
+    glfwSetCursorPosCallback(win, mouseMovement); 
+    glfwSetInputMode(win, GLFW_CURSOR, GLFW_CURSOR_DISABLED);  
+    
+    while (!glfwWindowShouldClose(win)) {
+        processInput(win, cameraPos, cameraFront, cameraUp);
+        view = glm::lookAt(cameraPos, cameraFront + cameraPos, cameraUp);
+
+        const float time = glfwGetTime();
+        for (size_t i = 0; i < COUNT; ++i) {
+            glm::vec3 pos((int(i % GRID) - GRID / 2) * 2.f, -2.f, -int(i / GRID) * 2.f);
+            transforms.set(i, pos, glm::angleAxis(time + i * 0.1f, glm::normalize(glm::vec3(1.f, 0.f, 1.f))), glm::vec3(1.f));
+        }
+        kernels.compose(transforms, models.data());
+        kernels.multiply(proj * view, models.data(), mvps.data(), COUNT);
+        storeMatrices(mvps.data(), COUNT, mvpUpload.data());
+        glBindBuffer(GL_ARRAY_BUFFER, instanceVbo);
+        glBufferSubData(GL_ARRAY_BUFFER, 0, COUNT * sizeof(glm::mat4), mvpUpload.data());
+
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+        glDrawArraysInstanced(GL_TRIANGLES, 0, 36, COUNT);
+        // polls different kinds of events, for example, when we close an application, it fetches that event
+        // or it fetches events like movement of the window.
+        // Without it you can neither move the window or close the window
+        glfwPollEvents();
+        // have you drawn the image, it is stored in the buffer. You can now swap this buffer with main buffer
+        // so the image appears
+        glfwSwapBuffers(win);
+    }
+    glfwTerminate();
+    
+    std::cout << "Window should close now!\n";
+
+    return EXIT_SUCCESS;
+
+}
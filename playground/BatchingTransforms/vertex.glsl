@@ -0,0 +1,16 @@
+#version 330 core
+
+layout(location = 0) in vec3 aPos;
+layout(location = 1) in vec2 aTexCoord;
+// proj * view * model, already multiplied on the CPU for every instance
+layout(location = 2) in mat4 aMVP;
+
+out vec4 color;
+out vec2 texCoord;
+
+
+void main() {
+    gl_Position = aMVP * vec4(aPos, 1.0);
+    color = vec4(aPos, 1.0f);
+    texCoord = aTexCoord;
+}
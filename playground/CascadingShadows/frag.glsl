@@ -0,0 +1,48 @@
+#version 330 core
+
+out vec4 FragColor;
+in vec2 texCoord;
+in vec3 worldPos;
+in vec3 worldNormal;
+in float viewDepth;
+
+uniform sampler2D tex;
+
+// set by CascadedShadows::setUniforms
+uniform sampler2DArrayShadow shadowMap;
+uniform mat4 lightViewProj[4];
+uniform vec4 cascadeSplits;  // view depth where each cascade ends
+uniform vec4 texelSizes;     // size of a shadow texel in world units
+uniform vec3 lightDir;
+uniform bool showCascades;
+
+float shadow(int cascade, vec3 n) {
+    // push the point out along the normal by about a texel, so surfaces don't shadow themselves
+    vec3 pos = worldPos + n * texelSizes[cascade] * 1.5;
+    vec4 lightPos = lightViewProj[cascade] * vec4(pos, 1.0);
+    vec3 coord = lightPos.xyz * 0.5 + 0.5;
+    vec2 texel = 1.0 / vec2(textureSize(shadowMap, 0).xy);
+    // 3x3 pcf, each tap is already a bilinear 2x2 compare
+    float lit = 0.0;
+    for (int y = -1; y <= 1; ++y)
+        for (int x = -1; x <= 1; ++x)
+            lit += texture(shadowMap, vec4(coord.xy + vec2(x, y) * texel, float(cascade), coord.z));
+    return lit / 9.0;
+}
+
+void main() {
+    vec3 albedo = texture(tex, texCoord).rgb;
+    vec3 n = normalize(worldNormal);
+
+    int cascade = 0;
+    while (cascade < 4 && viewDepth > cascadeSplits[cascade])
+        ++cascade;
+    float lit = cascade < 4 ? shadow(cascade, n) : 1.0;
+
+    vec3 color = albedo * (0.15 + 0.85 * max(dot(n, -lightDir), 0.0) * lit);
+    if (showCascades && cascade < 4) {
+        vec3 tints[4] = vec3[](vec3(1.0, 0.5, 0.5), vec3(0.5, 1.0, 0.5), vec3(0.5, 0.5, 1.0), vec3(1.0, 1.0, 0.5));
+        color *= tints[cascade];
+    }
+    FragColor = vec4(color, 1.0);
+}
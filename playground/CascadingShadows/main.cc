@@ -0,0 +1,928 @@
+#include <GL/glew.h>
+
+#include <GLFW/glfw3.h>
+#include <algorithm>
+#include <cfloat>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <random>
+#include <vector>
+#include <glm/ext/matrix_clip_space.hpp>
+#include <glm/ext/matrix_transform.hpp>
+#include <glm/geometric.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/ext/matrix_float4x4.hpp>
+#include <glm/gtc/type_ptr.hpp>
+#include <glm/glm.hpp>
+#include <glm/trigonometric.hpp>
+#define STB_IMAGE_IMPLEMENTATION
+#include <stb/stb_image.h>
+#include <iostream>
+
+class Shader {
+    std::string src; 
+protected:
+    const char *getsrc() {
+        return src.data();
+    }
+    GLuint shader_id = 0;
+    bool isCompiled = false;
+protected:
+    virtual const char *getClassName() = 0;
+    GLint getCompilationStatus(GLuint shader_id) {
+        int status;
+        glGetShaderiv(shader_id, GL_COMPILE_STATUS, &status);
+        return status;
+    }
+    void sendError() {
+        char buffer[1024];
+        glGetShaderInfoLog(shader_id, 1024, NULL, buffer);
+        std::cerr << "ERROR::" << getClassName() << " - " << buffer;
+    }
+public:
+    virtual void compile() = 0;
+    void setSource(const char *s) {
+        std::ifstream sourceFile(s);
+        if (!sourceFile.is_open())
+            return;
+        char buffer[8192];
+        while (sourceFile.read(buffer, 8192)) {
+            src.append(buffer, 8192);
+        }
+        if (!sourceFile.eof()) {
+            src.clear();
+            return;
+        }
+        src.append(buffer, sourceFile.gcount());
+    }
+    friend class Program;
+};
+
+
+class VertexShader : public Shader {
+    virtual const char *getClassName() override {
+        return "VertexShader";
+    }
+public:
+    virtual void compile() override {
+        if (shader_id)
+            glDeleteShader(shader_id);
+        shader_id = glCreateShader(GL_VERTEX_SHADER);
+        const char *src = getsrc();
+        glShaderSource(shader_id, 1, &src, NULL);
+        glCompileShader(shader_id);
+        if (!getCompilationStatus(shader_id)) {
+            sendError();
+        }
+        isCompiled = true;
+    }
+};
+
+class FragmentShader : public Shader {
+    const char *getClassName() override {
+        return "FragmentShader";
+    }
+public:
+    virtual void compile() override {
+        if (shader_id)
+            glDeleteShader(shader_id);
+        shader_id = glCreateShader(GL_FRAGMENT_SHADER);
+        const char *src = getsrc();
+        glShaderSource(shader_id, 1, &src, NULL);
+        glCompileShader(shader_id);
+        if (!getCompilationStatus(shader_id)) {
+            sendError();
+        }
+        isCompiled = true;
+    }
+};
+
+
+class Program {
+    GLuint program_id = 0;
+    void sendError() {
+        char buffer[1024];
+        glGetProgramInfoLog(program_id, 1024, NULL, buffer);
+        std::cerr << "ERROR::PROGRAM: " << " - " << buffer;
+    }
+    bool linkStatus() {
+        int status = 0;
+        glGetProgramiv(program_id, GL_LINK_STATUS, &status);
+        return status;
+    }
+public:
+    Program() {
+        program_id = glCreateProgram();
+    }
+    ~Program() {
+        glDeleteProgram(program_id);
+    }
+    void AttachShaders(std::initializer_list<Shader*> shaders) {
+        auto i = shaders.begin();
+        while (i != shaders.end()) {
+            if (!(*i)->isCompiled)
+                (*i)->compile();
+            glAttachShader(program_id, (*i)->shader_id);
+            ++i;
+        }
+        glLinkProgram(program_id);
+        if (!linkStatus()) {
+            sendError();
+        }
+    }
+    void UseProgram() {
+        glUseProgram(program_id);
+    }
+    void setMat4(const char *locName, const glm::mat4 &mat) {
+        int location = glGetUniformLocation(program_id, locName);
+        if (location == -1)
+            return;
+        glUniformMatrix4fv(location, 1, GL_FALSE, glm::value_ptr(mat));
+    }
+    void setInt(const char *locName, int value) {
+        int location = glGetUniformLocation(program_id, locName);
+        if (location == -1)
+            return;
+        glUniform1i(location, value);
+    }
+    void setFloat(const char *locName, float value) {
+        int location = glGetUniformLocation(program_id, locName);
+        if (location == -1)
+            return;
+        glUniform1f(location, value);
+    }
+    void setVec3(const char *locName, const glm::vec3 &vec) {
+        int location = glGetUniformLocation(program_id, locName);
+        if (location == -1)
+            return;
+        glUniform3f(location, vec.x, vec.y, vec.z);
+    }
+    void setVec4(const char *locName, const glm::vec4 &vec) {
+        int location = glGetUniformLocation(program_id, locName);
+        if (location == -1)
+            return;
+        glUniform4f(location, vec.x, vec.y, vec.z, vec.w);
+    }
+};
+
+
+class Texture2D {
+    GLuint tex_id;
+public:
+    void generate2DTex(const char *image_path) {
+        int width, height, nChannels;
+        stbi_set_flip_vertically_on_load(true);
+        uint8_t *raw_image = stbi_load(image_path, &width, &height, &nChannels, 0);
+        float borderColor[] = {1.f, 1.f, 1.f, 1.f};
+        glGenTextures(1, &tex_id);
+        glBindTexture(GL_TEXTURE_2D, tex_id);
+        // what to do when primitive is bigger than the texture
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_BORDER);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_BORDER);
+        glTexParameterfv(GL_TEXTURE_2D, GL_TEXTURE_BORDER_COLOR, borderColor);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        // glTexImage2D(TARGET_TYPE, IM_MIPMAP_LEVEL, TARGET_NRCHANNELS, SRC_WIDTH, SRC_HEIGHT, LEGACY_0, SRC_NRCHANNELS, SRC_DATA_TYPE, SRC_DATA);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, width, height, 0, GL_RGB, GL_UNSIGNED_BYTE, raw_image);
+        stbi_image_free(raw_image);
+    }
+    void bind() {
+        glBindTexture(GL_TEXTURE_2D, tex_id);
+    }
+};
+
+
+// GPU time of a stretch of commands, without waiting for it. there are a few queries in flight and
+// we only read the one that was issued QUERIES frames ago, which has long finished by then
+class GpuTimer {
+    static constexpr int QUERIES = 4;
+    GLuint queries[QUERIES] = {};
+    int frame = 0;
+public:
+    GpuTimer() {
+        glGenQueries(QUERIES, queries);
+    }
+    ~GpuTimer() {
+        glDeleteQueries(QUERIES, queries);
+    }
+    void begin() {
+        glBeginQuery(GL_TIME_ELAPSED, queries[frame % QUERIES]);
+    }
+    // returns the milliseconds of an older frame, or a negative value if there is none yet
+    double end() {
+        glEndQuery(GL_TIME_ELAPSED);
+        ++frame;
+        if (frame < QUERIES)
+            return -1.;
+        GLuint oldest = queries[frame % QUERIES];
+        GLint available = 0;
+        glGetQueryObjectiv(oldest, GL_QUERY_RESULT_AVAILABLE, &available);
+        if (!available)
+            return -1.;
+        GLuint64 ns = 0;
+        glGetQueryObjectui64v(oldest, GL_QUERY_RESULT, &ns);
+        return ns / 1e6;
+    }
+};
+
+
+// something that goes into the shadow map. all of them are the unit cube scaled by model,
+// center/radius is a sphere around it in world space
+struct ShadowCaster {
+    glm::mat4 model;
+    glm::vec3 center;
+    float radius;
+    bool dynamic = false;
+    // dynamic casters only: where it was when the shadow maps were last drawn, and whether it moved this frame
+    glm::vec3 prevCenter;
+    bool moved = false;
+};
+
+ShadowCaster makeCaster(const glm::vec3 &pos, const glm::vec3 &size, bool dynamic) {
+    ShadowCaster c;
+    c.model = glm::scale(glm::translate(glm::mat4(1.f), pos), size);
+    c.center = c.prevCenter = pos;
+    c.radius = glm::length(size) * 0.5f;
+    c.dynamic = dynamic;
+    return c;
+}
+
+
+// a directional light's shadow split into CASCADES orthographic maps, each one covering a depth range of
+// the camera frustum. every cascade is fitted to the bounding sphere of its piece of the frustum: the sphere
+// doesn't change size when the camera turns, and its center is snapped to whole shadow texels, so the
+// shadow edges don't crawl while the camera moves.
+//
+// cascades from CACHED_FROM on only hold static geometry. they are fitted with some margin and kept as they are
+// until the camera gets close to the edge of what they cover, the light turns or static geometry changes.
+// the near ones also get redrawn only when something inside them moved, so a scene where nothing moves
+// doesn't draw any shadows at all
+class CascadedShadows {
+public:
+    static constexpr int CASCADES = 4;
+    static constexpr int CACHED_FROM = 2;
+    // how much larger than needed the cached cascades are, i.e. how far the camera can go before we redraw them
+    static constexpr float CACHE_MARGIN = 0.2f;
+
+    struct Cascade {
+        glm::mat4 viewProj = glm::mat4(1.f);
+        glm::vec2 center;      // light space, snapped to texels
+        float halfSize = 0.f;
+        float splitFar = 0.f;  // view depth where the next cascade starts
+        float texelSize = 0.f; // world units
+        uint64_t staticVersion = 0;
+        bool valid = false;
+        bool dirty = true;
+    };
+private:
+    int resolution = 0;
+    GLuint depth_tex = 0;
+    GLuint fbo_id = 0;
+    Cascade cascades[CASCADES];
+    // per cascade, the view space sphere around its piece of the frustum: z along -front and radius
+    float sphereDepth[CASCADES] = {}, sphereRadius[CASCADES] = {};
+    glm::vec3 lightDir = glm::vec3(0.f);
+    glm::mat4 lightView = glm::mat4(1.f);
+    glm::vec3 sceneMin = glm::vec3(0.f), sceneMax = glm::vec3(0.f);
+    float depthNear = 0.f, depthFar = 1.f;
+    std::vector<glm::vec2> casterPos; // light space, refreshed by update()
+    bool caching = true;
+
+    glm::vec2 toLight(const glm::vec3 &p) const {
+        glm::vec4 l = lightView * glm::vec4(p, 1.f);
+        return glm::vec2(l.x, l.y);
+    }
+    bool overlaps(const Cascade &c, const glm::vec2 &p, float radius) const {
+        return std::abs(p.x - c.center.x) < c.halfSize + radius && std::abs(p.y - c.center.y) < c.halfSize + radius;
+    }
+    void invalidate() {
+        for (Cascade &c : cascades)
+            c.valid = false;
+    }
+    void updateDepthRange();
+public:
+    explicit CascadedShadows(int size) : resolution(size) {}
+    CascadedShadows(const CascadedShadows&) = delete;
+    CascadedShadows &operator=(const CascadedShadows&) = delete;
+    ~CascadedShadows() {
+        glDeleteFramebuffers(1, &fbo_id);
+        glDeleteTextures(1, &depth_tex);
+    }
+    // one depth layer per cascade, compared in the shader with sampler2DArrayShadow
+    bool create();
+    // splits [zNear, shadowFar] between the cascades, lambda blends logarithmic (1) and even (0) splits
+    void setProjection(float fovy, float aspect, float zNear, float shadowFar, float lambda = 0.75f);
+    void setLight(const glm::vec3 &dir);
+    // everything that can ever cast a shadow has to be in here, it decides the depth range of the maps
+    void setSceneBounds(const glm::vec3 &min, const glm::vec3 &max);
+    void setCaching(bool on) {
+        caching = on;
+        invalidate();
+    }
+    // fits the cascades to the camera and decides which ones have to be redrawn
+    void update(const glm::vec3 &cameraPos, const glm::vec3 &cameraFront, const std::vector<ShadowCaster> &casters, uint64_t staticVersion);
+    // whether cascade i contains all of its piece of the camera frustum
+    bool covers(int i, const glm::vec3 &cameraPos, const glm::vec3 &cameraFront) const;
+    // the casters that go into a cascade
+    void castersFor(int cascade, const std::vector<ShadowCaster> &casters, std::vector<uint32_t> &out) const;
+    // draws the dirty cascades with depthProg, which needs "lightViewProj" and "model". the unit cube has to be
+    // bound as the current vertex array. returns the number of draw calls
+    int render(Program &depthProg, std::vector<ShadowCaster> &casters, GLsizei cubeVertices);
+    // the maps now show where the moving things are
+    static void markDrawn(std::vector<ShadowCaster> &casters) {
+        for (ShadowCaster &caster : casters) {
+            if (caster.moved)
+                caster.prevCenter = caster.center;
+            caster.moved = false;
+        }
+    }
+    // cascade matrices, splits and texel sizes for the lit pass
+    void setUniforms(Program &prog) const;
+    const Cascade &cascade(int i) const {
+        return cascades[i];
+    }
+    GLuint texture() const {
+        return depth_tex;
+    }
+};
+
+bool CascadedShadows::create() {
+    glGenTextures(1, &depth_tex);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, depth_tex);
+    glTexImage3D(GL_TEXTURE_2D_ARRAY, 0, GL_DEPTH_COMPONENT24, resolution, resolution, CASCADES, 0, GL_DEPTH_COMPONENT, GL_FLOAT, NULL);
+    // hardware 2x2 pcf on top of what the shader does
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_COMPARE_MODE, GL_COMPARE_REF_TO_TEXTURE);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_COMPARE_FUNC, GL_LEQUAL);
+
+    glGenFramebuffers(1, &fbo_id);
+    glBindFramebuffer(GL_FRAMEBUFFER, fbo_id);
+    glFramebufferTextureLayer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, depth_tex, 0, 0);
+    glDrawBuffer(GL_NONE);
+    glReadBuffer(GL_NONE);
+    GLenum status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    if (status != GL_FRAMEBUFFER_COMPLETE) {
+        std::cerr << "ERROR::SHADOWS - shadow framebuffer is incomplete: 0x" << std::hex << status << std::dec << "\n";
+        return false;
+    }
+    invalidate();
+    return true;
+}
+
+void CascadedShadows::setProjection(float fovy, float aspect, float zNear, float shadowFar, float lambda) {
+    const float tanY = std::tan(fovy * 0.5f), tanX = tanY * aspect;
+    const float k = tanX * tanX + tanY * tanY;
+    float splitNear = zNear;
+    for (int i = 0; i < CASCADES; ++i) {
+        float t = float(i + 1) / CASCADES;
+        float f = glm::mix(zNear + (shadowFar - zNear) * t, zNear * std::pow(shadowFar / zNear, t), lambda);
+        float n = splitNear;
+        // the smallest sphere through the near and far corners has its center on the view axis.
+        // it only depends on the projection, never on where the camera looks, so its size stays put
+        float z = (f * f * (1.f + k) - n * n * (1.f + k)) / (2.f * (f - n));
+        z = std::min(z, f);
+        sphereDepth[i] = z;
+        sphereRadius[i] = std::sqrt(std::max((z - n) * (z - n) + n * n * k, (f - z) * (f - z) + f * f * k));
+        cascades[i].splitFar = f;
+        splitNear = f;
+    }
+    invalidate();
+}
+
+void CascadedShadows::setLight(const glm::vec3 &dir) {
+    glm::vec3 d = glm::normalize(dir);
+    if (d == lightDir)
+        return;
+    lightDir = d;
+    // rotation only, so light space is just world space turned around. the maps move around in it
+    glm::vec3 up = std::abs(d.y) > 0.99f ? glm::vec3(0.f, 0.f, 1.f) : glm::vec3(0.f, 1.f, 0.f);
+    lightView = glm::lookAt(glm::vec3(0.f), d, up);
+    updateDepthRange();
+    invalidate();
+}
+
+void CascadedShadows::setSceneBounds(const glm::vec3 &min, const glm::vec3 &max) {
+    if (min == sceneMin && max == sceneMax)
+        return;
+    sceneMin = min, sceneMax = max;
+    updateDepthRange();
+    invalidate();
+}
+
+void CascadedShadows::updateDepthRange() {
+    float lo = FLT_MAX, hi = -FLT_MAX;
+    for (int corner = 0; corner < 8; ++corner) {
+        glm::vec3 p(corner & 1 ? sceneMax.x : sceneMin.x, corner & 2 ? sceneMax.y : sceneMin.y, corner & 4 ? sceneMax.z : sceneMin.z);
+        float z = (lightView * glm::vec4(p, 1.f)).z;
+        lo = std::min(lo, z), hi = std::max(hi, z);
+    }
+    // we look down -z
+    depthNear = -hi - 1.f;
+    depthFar = -lo + 1.f;
+}
+
+void CascadedShadows::update(const glm::vec3 &cameraPos, const glm::vec3 &cameraFront, const std::vector<ShadowCaster> &casters, uint64_t staticVersion) {
+    casterPos.resize(casters.size());
+    for (size_t i = 0; i < casters.size(); ++i)
+        casterPos[i] = toLight(casters[i].center);
+
+    for (int i = 0; i < CASCADES; ++i) {
+        Cascade &c = cascades[i];
+        const bool cached = caching && i >= CACHED_FROM;
+        const glm::vec2 center = toLight(cameraPos + glm::normalize(cameraFront) * sphereDepth[i]);
+        const float radius = sphereRadius[i];
+        // snapping moves the map by up to a texel, one texel of slack keeps the sphere inside
+        const float halfSize = cached ? radius * (1.f + CACHE_MARGIN) : radius / (1.f - 2.f / resolution);
+
+        c.dirty = !c.valid || !caching || c.staticVersion != staticVersion;
+        if (cached && !c.dirty) {
+            // still covers everything we need?
+            c.dirty = std::abs(center.x - c.center.x) + radius > c.halfSize || std::abs(center.y - c.center.y) + radius > c.halfSize;
+        }
+        if (!cached) {
+            // moves with the camera, but only in whole texels. if it didn't move, only moving things make it dirty
+            const float texel = 2.f * halfSize / resolution;
+            glm::vec2 snapped(std::floor(center.x / texel) * texel, std::floor(center.y / texel) * texel);
+            if (snapped.x != c.center.x || snapped.y != c.center.y || halfSize != c.halfSize)
+                c.dirty = true;
+        }
+        if (!c.dirty && !cached) {
+            for (size_t k = 0; k < casters.size() && !c.dirty; ++k) {
+                const ShadowCaster &caster = casters[k];
+                if (caster.dynamic && caster.moved)
+                    c.dirty = overlaps(c, casterPos[k], caster.radius) || overlaps(c, toLight(caster.prevCenter), caster.radius);
+            }
+        }
+        if (!c.dirty)
+            continue;
+
+        const float texel = 2.f * halfSize / resolution;
+        c.center = glm::vec2(std::floor(center.x / texel) * texel, std::floor(center.y / texel) * texel);
+        c.halfSize = halfSize;
+        c.texelSize = texel;
+        c.staticVersion = staticVersion;
+        c.valid = true;
+        glm::mat4 proj = glm::ortho(c.center.x - halfSize, c.center.x + halfSize, c.center.y - halfSize, c.center.y + halfSize, depthNear, depthFar);
+        c.viewProj = proj * lightView;
+    }
+}
+
+bool CascadedShadows::covers(int i, const glm::vec3 &cameraPos, const glm::vec3 &cameraFront) const {
+    const Cascade &c = cascades[i];
+    glm::vec2 center = toLight(cameraPos + glm::normalize(cameraFront) * sphereDepth[i]);
+    return std::abs(center.x - c.center.x) + sphereRadius[i] <= c.halfSize
+        && std::abs(center.y - c.center.y) + sphereRadius[i] <= c.halfSize;
+}
+
+void CascadedShadows::castersFor(int cascade, const std::vector<ShadowCaster> &casters, std::vector<uint32_t> &out) const {
+    out.clear();
+    const Cascade &c = cascades[cascade];
+    const bool staticOnly = caching && cascade >= CACHED_FROM;
+    for (size_t i = 0; i < casters.size(); ++i) {
+        if (staticOnly && casters[i].dynamic)
+            continue;
+        if (overlaps(c, casterPos[i], casters[i].radius))
+            out.push_back(i);
+    }
+}
+
+int CascadedShadows::render(Program &depthProg, std::vector<ShadowCaster> &casters, GLsizei cubeVertices) {
+    GLint viewport[4];
+    glGetIntegerv(GL_VIEWPORT, viewport);
+    glBindFramebuffer(GL_FRAMEBUFFER, fbo_id);
+    glViewport(0, 0, resolution, resolution);
+    // slope scaled bias in the map, the lit pass adds a normal offset on top
+    glEnable(GL_POLYGON_OFFSET_FILL);
+    glPolygonOffset(2.f, 4.f);
+    depthProg.UseProgram();
+
+    int draws = 0;
+    std::vector<uint32_t> visible;
+    for (int i = 0; i < CASCADES; ++i) {
+        if (!cascades[i].dirty)
+            continue;
+        glFramebufferTextureLayer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, depth_tex, 0, i);
+        glClear(GL_DEPTH_BUFFER_BIT);
+        depthProg.setMat4("lightViewProj", cascades[i].viewProj);
+        castersFor(i, casters, visible);
+        for (uint32_t k : visible) {
+            depthProg.setMat4("model", casters[k].model);
+            glDrawArrays(GL_TRIANGLES, 0, cubeVertices);
+        }
+        draws += visible.size();
+        cascades[i].dirty = false;
+    }
+    markDrawn(casters);
+
+    glDisable(GL_POLYGON_OFFSET_FILL);
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    glViewport(viewport[0], viewport[1], viewport[2], viewport[3]);
+    return draws;
+}
+
+void CascadedShadows::setUniforms(Program &prog) const {
+    char name[32];
+    glm::vec4 splits, texels;
+    for (int i = 0; i < CASCADES; ++i) {
+        std::snprintf(name, sizeof(name), "lightViewProj[%d]", i);
+        prog.setMat4(name, cascades[i].viewProj);
+        splits[i] = cascades[i].splitFar;
+        texels[i] = cascades[i].texelSize;
+    }
+    prog.setVec4("cascadeSplits", splits);
+    prog.setVec4("texelSizes", texels);
+    prog.setVec3("lightDir", lightDir);
+}
+
+
+// a floor, a field of pillars and a few cubes flying around the start position. only the cubes move
+std::vector<ShadowCaster> buildScene() {
+    std::vector<ShadowCaster> casters;
+    casters.push_back(makeCaster(glm::vec3(0.f, -0.1f, 0.f), glm::vec3(160.f, 0.2f, 160.f), false));
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<float> height(1.f, 8.f);
+    for (int z = 0; z < 24; ++z) {
+        for (int x = 0; x < 24; ++x) {
+            float h = height(rng);
+            casters.push_back(makeCaster(glm::vec3(x * 6.f - 69.f, h * 0.5f, z * 6.f - 69.f), glm::vec3(0.8f, h, 0.8f), false));
+        }
+    }
+    for (int i = 0; i < 12; ++i)
+        casters.push_back(makeCaster(glm::vec3(0.f), glm::vec3(0.5f), true));
+    return casters;
+}
+
+void moveCasters(std::vector<ShadowCaster> &casters, float time) {
+    int i = 0;
+    for (ShadowCaster &c : casters) {
+        if (!c.dynamic)
+            continue;
+        float angle = time * (0.5f + 0.1f * i) + i;
+        glm::vec3 pos(std::cos(angle) * (2.f + i * 0.4f), 1.f + 0.5f * std::sin(time + i), std::sin(angle) * (2.f + i * 0.4f) - 4.f);
+        c.model = glm::rotate(glm::scale(glm::translate(glm::mat4(1.f), pos), glm::vec3(0.5f)), time + i, glm::vec3(0.3f, 1.f, 0.f));
+        c.center = pos;
+        c.moved = true;
+        ++i;
+    }
+}
+
+// ./main --bench
+// runs a scripted camera through the scene without drawing anything and counts what the shadow pass
+// would draw, with and without caching. also checks that the cascades always cover the frustum, that they
+// stay on the texel grid and that turning the camera doesn't change their size
+int runBenchmark() {
+    constexpr int FRAMES = 240;
+    const char *phases[] = {"static scene, still camera", "static scene, camera walking", "static scene, camera turning",
+                            "cubes moving, still camera"};
+    bool ok = true;
+    for (bool caching : {false, true}) {
+        CascadedShadows shadows(2048);
+        shadows.setProjection(glm::radians(45.f), 800 / 600.f, 0.1f, 100.f);
+        shadows.setLight(glm::vec3(-0.4f, -1.f, -0.3f));
+        shadows.setSceneBounds(glm::vec3(-80.f, -1.f, -80.f), glm::vec3(80.f, 12.f, 80.f));
+        shadows.setCaching(caching);
+        std::vector<ShadowCaster> casters = buildScene();
+        std::vector<uint32_t> visible;
+        std::cout << (caching ? "cached:\n" : "every cascade every frame:\n");
+
+        glm::vec3 cameraPos(0.f, 1.5f, 3.f), cameraFront(0.f, 0.f, -1.f);
+        float texelSizes[CascadedShadows::CASCADES] = {};
+        for (int phase = 0; phase < 4; ++phase) {
+            size_t cascadesDrawn = 0, draws = 0;
+            double seconds = 0.;
+            for (int frame = 0; frame < FRAMES; ++frame) {
+                if (phase == 1)
+                    cameraPos += 0.05f * cameraFront;
+                if (phase == 2) {
+                    float yaw = glm::radians(-90.f + frame * 0.5f);
+                    cameraFront = glm::vec3(std::cos(yaw), 0.f, std::sin(yaw));
+                }
+                if (phase == 3)
+                    moveCasters(casters, frame / 60.f);
+
+                auto start = std::chrono::steady_clock::now();
+                shadows.update(cameraPos, cameraFront, casters, 0);
+                for (int i = 0; i < CascadedShadows::CASCADES; ++i) {
+                    if (!shadows.cascade(i).dirty)
+                        continue;
+                    shadows.castersFor(i, casters, visible);
+                    ++cascadesDrawn;
+                    draws += visible.size();
+                }
+                CascadedShadows::markDrawn(casters);
+                seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+                for (int i = 0; i < CascadedShadows::CASCADES; ++i) {
+                    const CascadedShadows::Cascade &c = shadows.cascade(i);
+                    if (!shadows.covers(i, cameraPos, cameraFront)) {
+                        std::cout << "cascade " << i << " doesn't cover the frustum\n";
+                        ok = false;
+                    }
+                    // the world origin has to land on a texel corner, otherwise the map slid by part of a texel
+                    float texel = (c.viewProj * glm::vec4(0.f, 0.f, 0.f, 1.f)).x * 0.5f * 2048.f;
+                    if (std::abs(texel - std::round(texel)) > 0.01f) {
+                        std::cout << "cascade " << i << " is off the texel grid by " << texel - std::round(texel) << "\n";
+                        ok = false;
+                    }
+                    if (texelSizes[i] != 0.f && texelSizes[i] != c.texelSize) {
+                        std::cout << "cascade " << i << " changed texel size\n";
+                        ok = false;
+                    }
+                    texelSizes[i] = c.texelSize;
+                }
+            }
+            std::cout << "  " << phases[phase] << ": " << double(cascadesDrawn) / FRAMES << " cascades, "
+                      << double(draws) / FRAMES << " draws per frame, " << seconds * 1e6 / FRAMES << "us to decide\n";
+        }
+    }
+    return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+
+void processInput(GLFWwindow *window, glm::vec3 &cameraPos, glm::vec3 &cameraFront, glm::vec3 &cameraUp)
+{
+
+    const float cameraSpeed = 0.05f; // adjust accordingly
+    if (glfwGetKey(window, GLFW_KEY_W) == GLFW_PRESS)
+        cameraPos += cameraSpeed * cameraFront;
+    if (glfwGetKey(window, GLFW_KEY_S) == GLFW_PRESS)
+        cameraPos -= cameraSpeed * cameraFront;
+    if (glfwGetKey(window, GLFW_KEY_A) == GLFW_PRESS)
+        cameraPos -= glm::normalize(glm::cross(cameraFront, cameraUp)) * cameraSpeed;
+    if (glfwGetKey(window, GLFW_KEY_D) == GLFW_PRESS)
+        cameraPos += glm::normalize(glm::cross(cameraFront, cameraUp)) * cameraSpeed;
+    if (glfwGetKey(window, GLFW_KEY_UP) == GLFW_PRESS)
+        cameraPos += glm::normalize(glm::cross(cameraFront, cameraUp)) * cameraSpeed;
+
+}
+
+// true only on the frame the key went down
+bool keyPressed(GLFWwindow *window, int key) {
+    static bool down[GLFW_KEY_LAST + 1] = {};
+    bool now = glfwGetKey(window, key) == GLFW_PRESS;
+    bool pressed = now && !down[key];
+    down[key] = now;
+    return pressed;
+}
+
+
+float yaw = -90.f;
+float pitch = 0.f;
+glm::vec3 cameraFront;
+
+void mouseMovement(GLFWwindow *window, double xPos, double yPos) {
+    static float lastX = xPos, lastY = yPos;
+    float xOffset = xPos - lastX;
+    float yOffset = lastY - yPos;
+    
+    constexpr float sensitivity = 0.05f;
+    xOffset *= sensitivity;
+    yOffset *= sensitivity;
+
+    yaw += xOffset;
+    pitch += yOffset;
+
+    if (std::abs(pitch) > 89.f) // don't ever do it this way. I am lazy
+        pitch = std::abs(pitch) / pitch * 89.f;
+
+    cameraFront.x = cos(glm::radians(yaw)) * cos(glm::radians(pitch));
+    cameraFront.y = sin(glm::radians(pitch));
+    cameraFront.z = sin(glm::radians(yaw)) * cos(glm::radians(pitch));
+
+    cameraFront = glm::normalize(cameraFront);
+    lastX = xPos, lastY = yPos;
+}
+
+
+
+
+
+int main(int argc, char **argv) {
+    if (argc > 1 && !std::strcmp(argv[1], "--bench"))
+        return runBenchmark();
+
+    if (glfwInit() != GLFW_TRUE) {
+        glfwTerminate();
+        std::cerr << "Failed to initialize GLFW";
+        return EXIT_FAILURE;
+    }
+    // setting OpenGL version to 3.3
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+    GLFWwindow *win = glfwCreateWindow(800, 600, "This is a hello window!", NULL, NULL);
+    // setting 'context' for OpenGL, i.e. where to draw on current thread
+    glfwMakeContextCurrent(win);
+    // all it does is fetches us the implemented functions of OpenGL
+    if (glewInit() != GLEW_OK) {
+        glfwTerminate();
+        std::cerr << "Failed to initialize GLEW\n";
+        return EXIT_FAILURE;
+    }
+    int screenWidth, screenHeight;
+    glfwGetFramebufferSize(win, &screenWidth, &screenHeight);
+    glViewport(0, 0, screenWidth, screenHeight);
+
+    glEnable(GL_DEPTH_TEST);
+    float triangle_data[] = {
+        //   vertpos   //  //   normal   //  //texcord//
+    -0.5f, -0.5f, -0.5f,  0.0f,  0.0f, -1.0f,  0.0f, 0.0f,
+     0.5f, -0.5f, -0.5f,  0.0f,  0.0f, -1.0f,  1.0f, 0.0f,
+     0.5f,  0.5f, -0.5f,  0.0f,  0.0f, -1.0f,  1.0f, 1.0f,
+     0.5f,  0.5f, -0.5f,  0.0f,  0.0f, -1.0f,  1.0f, 1.0f,
+    -0.5f,  0.5f, -0.5f,  0.0f,  0.0f, -1.0f,  0.0f, 1.0f,
+    -0.5f, -0.5f, -0.5f,  0.0f,  0.0f, -1.0f,  0.0f, 0.0f,
+
+    -0.5f, -0.5f,  0.5f,  0.0f,  0.0f,  1.0f,  0.0f, 0.0f,
+     0.5f, -0.5f,  0.5f,  0.0f,  0.0f,  1.0f,  1.0f, 0.0f,
+     0.5f,  0.5f,  0.5f,  0.0f,  0.0f,  1.0f,  1.0f, 1.0f,
+     0.5f,  0.5f,  0.5f,  0.0f,  0.0f,  1.0f,  1.0f, 1.0f,
+    -0.5f,  0.5f,  0.5f,  0.0f,  0.0f,  1.0f,  0.0f, 1.0f,
+    -0.5f, -0.5f,  0.5f,  0.0f,  0.0f,  1.0f,  0.0f, 0.0f,
+
+    -0.5f,  0.5f,  0.5f, -1.0f,  0.0f,  0.0f,  1.0f, 0.0f,
+    -0.5f,  0.5f, -0.5f, -1.0f,  0.0f,  0.0f,  1.0f, 1.0f,
+    -0.5f, -0.5f, -0.5f, -1.0f,  0.0f,  0.0f,  0.0f, 1.0f,
+    -0.5f, -0.5f, -0.5f, -1.0f,  0.0f,  0.0f,  0.0f, 1.0f,
+    -0.5f, -0.5f,  0.5f, -1.0f,  0.0f,  0.0f,  0.0f, 0.0f,
+    -0.5f,  0.5f,  0.5f, -1.0f,  0.0f,  0.0f,  1.0f, 0.0f,
+
+     0.5f,  0.5f,  0.5f,  1.0f,  0.0f,  0.0f,  1.0f, 0.0f,
+     0.5f,  0.5f, -0.5f,  1.0f,  0.0f,  0.0f,  1.0f, 1.0f,
+     0.5f, -0.5f, -0.5f,  1.0f,  0.0f,  0.0f,  0.0f, 1.0f,
+     0.5f, -0.5f, -0.5f,  1.0f,  0.0f,  0.0f,  0.0f, 1.0f,
+     0.5f, -0.5f,  0.5f,  1.0f,  0.0f,  0.0f,  0.0f, 0.0f,
+     0.5f,  0.5f,  0.5f,  1.0f,  0.0f,  0.0f,  1.0f, 0.0f,
+
+    -0.5f, -0.5f, -0.5f,  0.0f, -1.0f,  0.0f,  0.0f, 1.0f,
+     0.5f, -0.5f, -0.5f,  0.0f, -1.0f,  0.0f,  1.0f, 1.0f,
+     0.5f, -0.5f,  0.5f,  0.0f, -1.0f,  0.0f,  1.0f, 0.0f,
+     0.5f, -0.5f,  0.5f,  0.0f, -1.0f,  0.0f,  1.0f, 0.0f,
+    -0.5f, -0.5f,  0.5f,  0.0f, -1.0f,  0.0f,  0.0f, 0.0f,
+    -0.5f, -0.5f, -0.5f,  0.0f, -1.0f,  0.0f,  0.0f, 1.0f,
+
+    -0.5f,  0.5f, -0.5f,  0.0f,  1.0f,  0.0f,  0.0f, 1.0f,
+     0.5f,  0.5f, -0.5f,  0.0f,  1.0f,  0.0f,  1.0f, 1.0f,
+     0.5f,  0.5f,  0.5f,  0.0f,  1.0f,  0.0f,  1.0f, 0.0f,
+     0.5f,  0.5f,  0.5f,  0.0f,  1.0f,  0.0f,  1.0f, 0.0f,
+    -0.5f,  0.5f,  0.5f,  0.0f,  1.0f,  0.0f,  0.0f, 0.0f,
+    -0.5f,  0.5f, -0.5f,  0.0f,  1.0f,  0.0f,  0.0f, 1.0f
+        
+    };
+
+
+    glm::vec3 cameraPos(0.f, 1.5f, 3.f);
+    cameraFront = glm::vec3(0.f,0.f,-1.f);
+    glm::vec3 cameraUp(0.,1.,0.f);
+    
+
+    Texture2D tex;
+    tex.generate2DTex("./image2d.tex");
+    tex.bind();
+
+    GLuint vbo = 0;
+    glGenBuffers(1, &vbo); 
+    glBindBuffer(GL_ARRAY_BUFFER, vbo);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(triangle_data), triangle_data, GL_STATIC_DRAW);
+
+    GLuint vao = 0;
+    glGenVertexArrays(1, &vao);
+    glBindVertexArray(vao);
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)0);
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)(6 * sizeof(float)));
+    glEnableVertexAttribArray(1);
+    glVertexAttribPointer(2, 3, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)(3 * sizeof(float)));
+    glEnableVertexAttribArray(2);
+
+    VertexShader vs;
+    FragmentShader fs;
+    vs.setSource("./vertex.glsl");
+    fs.setSource("./frag.glsl");
+    Program prog;
+    prog.AttachShaders({&vs, &fs});
+
+    VertexShader shadowVs;
+    FragmentShader shadowFs;
+    shadowVs.setSource("./shadow_vertex.glsl");
+    shadowFs.setSource("./shadow_frag.glsl");
+    Program shadowProg;
+    shadowProg.AttachShaders({&shadowVs, &shadowFs});
+
+    const float zNear = 0.1f, zFar = 200.f, shadowFar = 100.f;
+    CascadedShadows shadows(2048);
+    if (!shadows.create()) {
+        glfwTerminate();
+        return EXIT_FAILURE;
+    }
+    shadows.setProjection(glm::radians(45.f), float(screenWidth) / screenHeight, zNear, shadowFar);
+    shadows.setSceneBounds(glm::vec3(-80.f, -1.f, -80.f), glm::vec3(80.f, 12.f, 80.f));
+    float lightAngle = 0.f;
+    shadows.setLight(glm::vec3(-0.4f, -1.f, -0.3f));
+    std::vector<ShadowCaster> casters = buildScene();
+    uint64_t staticVersion = 0;
+    bool paused = false, caching = true, showCascades = false;
+
+    prog.UseProgram();
+    prog.setInt("tex", 0);
+    prog.setInt("shadowMap", 1);
+    glActiveTexture(GL_TEXTURE1);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, shadows.texture());
+    glActiveTexture(GL_TEXTURE0);
+
+    glm::mat4 view; // = glm::translate(glm::mat4(1.f), glm::vec3(0.f,0.f,-3.f));
+       
+
+    glm::mat4 proj = glm::perspective(glm::radians(45.f), float(screenWidth) / screenHeight, zNear, zFar);
+
+    prog.setMat4("proj", proj);
+    prog.setMat4("view", view);
+
+    glfwSetCursorPosCallback(win, mouseMovement); 
+    glfwSetInputMode(win, GLFW_CURSOR, GLFW_CURSOR_DISABLED);  
+
+    GpuTimer shadowTimer;
+    double lastReport = glfwGetTime(), shadowGpuMs = 0., shadowCpuMs = 0.;
+    int frames = 0, cascadesDrawn = 0, shadowDraws = 0, gpuSamples = 0;
+    
+    while (!glfwWindowShouldClose(win)) {
+        processInput(win, cameraPos, cameraFront, cameraUp);
+        view = glm::lookAt(cameraPos, cameraFront + cameraPos, cameraUp);
+
+        // P stops the cubes, L turns the sun, K moves a pillar, T turns caching off, C shows the cascades
+        if (keyPressed(win, GLFW_KEY_P))
+            paused = !paused;
+        if (keyPressed(win, GLFW_KEY_T)) {
+            caching = !caching;
+            shadows.setCaching(caching);
+        }
+        if (keyPressed(win, GLFW_KEY_C))
+            showCascades = !showCascades;
+        if (keyPressed(win, GLFW_KEY_K)) {
+            ShadowCaster &pillar = casters[1];
+            pillar.center.y = pillar.center.y > 4.f ? 2.f : 6.f;
+            pillar.model[3].y = pillar.center.y;
+            ++staticVersion;
+        }
+        if (glfwGetKey(win, GLFW_KEY_L) == GLFW_PRESS) {
+            lightAngle += 0.01f;
+            shadows.setLight(glm::vec3(-0.4f * std::cos(lightAngle) + 0.3f * std::sin(lightAngle), -1.f,
+                                       -0.3f * std::cos(lightAngle) - 0.4f * std::sin(lightAngle)));
+        }
+        if (!paused)
+            moveCasters(casters, glfwGetTime());
+
+        auto start = std::chrono::steady_clock::now();
+        shadows.update(cameraPos, cameraFront, casters, staticVersion);
+        for (int i = 0; i < CascadedShadows::CASCADES; ++i)
+            cascadesDrawn += shadows.cascade(i).dirty;
+        shadowTimer.begin();
+        shadowDraws += shadows.render(shadowProg, casters, 36);
+        double gpuMs = shadowTimer.end();
+        shadowCpuMs += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        if (gpuMs >= 0.) {
+            shadowGpuMs += gpuMs;
+            ++gpuSamples;
+        }
+
+        prog.UseProgram();
+        prog.setMat4("view", view);
+        prog.setInt("showCascades", showCascades);
+        shadows.setUniforms(prog);
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+        for (const ShadowCaster &caster : casters) {
+            prog.setMat4("model", caster.model);
+            glDrawArrays(GL_TRIANGLES, 0, 36);
+        }
+
+        ++frames;
+        if (glfwGetTime() - lastReport > 1.) {
+            lastReport = glfwGetTime();
+            std::cout << "shadow pass: " << (gpuSamples ? shadowGpuMs / gpuSamples : 0.) << "ms gpu, "
+                      << shadowCpuMs / frames << "ms cpu, " << float(cascadesDrawn) / frames << " cascades and "
+                      << float(shadowDraws) / frames << " draws per frame" << (caching ? "" : " (caching off)") << "\n";
+            frames = cascadesDrawn = shadowDraws = gpuSamples = 0;
+            shadowGpuMs = shadowCpuMs = 0.;
+        }
+        // polls different kinds of events, for example, when we close an application, it fetches that event
+        // or it fetches events like movement of the window.
+        // Without it you can neither move the window or close the window
+        glfwPollEvents();
+        // have you drawn the image, it is stored in the buffer. You can now swap this buffer with main buffer
+        // so the image appears
+        glfwSwapBuffers(win);
+    }
+    glfwTerminate();
+    
+    std::cout << "Window should close now!\n";
+
+    return EXIT_SUCCESS;
+
+}
@@ -0,0 +1,25 @@
+#version 330 core
+
+layout(location = 0) in vec3 aPos;
+layout(location = 1) in vec2 aTexCoord;
+layout(location = 2) in vec3 aNormal;
+
+out vec2 texCoord;
+out vec3 worldPos;
+out vec3 worldNormal;
+out float viewDepth;
+
+uniform mat4 proj;
+uniform mat4 view;
+uniform mat4 model;
+
+
+void main() {
+    vec4 pos = model * vec4(aPos, 1.0);
+    vec4 viewPos = view * pos;
+    gl_Position = proj * viewPos;
+    worldPos = pos.xyz;
+    worldNormal = transpose(inverse(mat3(model))) * aNormal;
+    viewDepth = -viewPos.z;
+    texCoord = aTexCoord;
+}
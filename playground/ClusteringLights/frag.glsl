@@ -0,0 +1,49 @@
+#version 330 core
+
+out vec4 FragColor;
+in vec2 texCoord;
+in vec3 viewPos;
+in vec3 viewNormal;
+
+uniform sampler2D tex;
+
+// filled by LightClusters on the CPU every frame
+uniform samplerBuffer lights;        // 3 texels per light: pos.xyz + radius, color + cos(cone angle), direction
+uniform usamplerBuffer clusters;     // per cluster: offset into lightIndices, light count
+uniform usamplerBuffer lightIndices;
+uniform ivec3 clusterDims;
+uniform vec2 screenSize;
+uniform float zNear;
+uniform float zFar;
+
+void main() {
+    vec3 albedo = texture(tex, texCoord).rgb;
+
+    // same slicing as LightClusters::sliceOf
+    float depth = -viewPos.z;
+    int slice = clamp(int(floor(log(depth / zNear) / log(zFar / zNear) * float(clusterDims.z))), 0, clusterDims.z - 1);
+    ivec2 tile = clamp(ivec2(gl_FragCoord.xy / screenSize * vec2(clusterDims.xy)), ivec2(0), clusterDims.xy - 1);
+    int cluster = (slice * clusterDims.y + tile.y) * clusterDims.x + tile.x;
+    uvec2 range = texelFetch(clusters, cluster).xy;
+
+    vec3 n = normalize(viewNormal);
+    vec3 color = albedo * 0.05;
+    for (uint i = 0u; i < range.y; ++i) {
+        int light = int(texelFetch(lightIndices, int(range.x + i)).r);
+        vec4 posRadius = texelFetch(lights, light * 3);
+        vec4 colorCone = texelFetch(lights, light * 3 + 1);
+        vec3 toLight = posRadius.xyz - viewPos;
+        float dist = length(toLight);
+        if (dist >= posRadius.w)
+            continue;
+        vec3 l = toLight / dist;
+        float attenuation = 1.0 - dist / posRadius.w;
+        attenuation *= attenuation;
+        if (colorCone.w > -1.0) {
+            vec3 dir = texelFetch(lights, light * 3 + 2).xyz;
+            attenuation *= smoothstep(colorCone.w, mix(colorCone.w, 1.0, 0.1), dot(-l, dir));
+        }
+        color += albedo * colorCone.rgb * max(dot(n, l), 0.0) * attenuation;
+    }
+    FragColor = vec4(color, 1.0);
+}
@@ -0,0 +1,824 @@
+#include <GL/glew.h>
+
+#include <GLFW/glfw3.h>
+#include <algorithm>
+#include <atomic>
+#include <cfloat>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <vector>
+#include <glm/ext/matrix_clip_space.hpp>
+#include <glm/ext/matrix_transform.hpp>
+#include <glm/geometric.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/ext/matrix_float4x4.hpp>
+#include <glm/gtc/type_ptr.hpp>
+#include <glm/glm.hpp>
+#include <glm/trigonometric.hpp>
+#define STB_IMAGE_IMPLEMENTATION
+#include <stb/stb_image.h>
+#include <iostream>
+
+class Shader {
+    std::string src; 
+protected:
+    const char *getsrc() {
+        return src.data();
+    }
+    GLuint shader_id = 0;
+    bool isCompiled = false;
+protected:
+    virtual const char *getClassName() = 0;
+    GLint getCompilationStatus(GLuint shader_id) {
+        int status;
+        glGetShaderiv(shader_id, GL_COMPILE_STATUS, &status);
+        return status;
+    }
+    void sendError() {
+        char buffer[1024];
+        glGetShaderInfoLog(shader_id, 1024, NULL, buffer);
+        std::cerr << "ERROR::" << getClassName() << " - " << buffer;
+    }
+public:
+    virtual void compile() = 0;
+    void setSource(const char *s) {
+        std::ifstream sourceFile(s);
+        if (!sourceFile.is_open())
+            return;
+        char buffer[8192];
+        while (sourceFile.read(buffer, 8192)) {
+            src.append(buffer, 8192);
+        }
+        if (!sourceFile.eof()) {
+            src.clear();
+            return;
+        }
+        src.append(buffer, sourceFile.gcount());
+    }
+    friend class Program;
+};
+
+
+class VertexShader : public Shader {
+    virtual const char *getClassName() override {
+        return "VertexShader";
+    }
+public:
+    virtual void compile() override {
+        if (shader_id)
+            glDeleteShader(shader_id);
+        shader_id = glCreateShader(GL_VERTEX_SHADER);
+        const char *src = getsrc();
+        glShaderSource(shader_id, 1, &src, NULL);
+        glCompileShader(shader_id);
+        if (!getCompilationStatus(shader_id)) {
+            sendError();
+        }
+        isCompiled = true;
+    }
+};
+
+class FragmentShader : public Shader {
+    const char *getClassName() override {
+        return "FragmentShader";
+    }
+public:
+    virtual void compile() override {
+        if (shader_id)
+            glDeleteShader(shader_id);
+        shader_id = glCreateShader(GL_FRAGMENT_SHADER);
+        const char *src = getsrc();
+        glShaderSource(shader_id, 1, &src, NULL);
+        glCompileShader(shader_id);
+        if (!getCompilationStatus(shader_id)) {
+            sendError();
+        }
+        isCompiled = true;
+    }
+};
+
+
+class Program {
+    GLuint program_id = 0;
+    void sendError() {
+        char buffer[1024];
+        glGetProgramInfoLog(program_id, 1024, NULL, buffer);
+        std::cerr << "ERROR::PROGRAM: " << " - " << buffer;
+    }
+    bool linkStatus() {
+        int status = 0;
+        glGetProgramiv(program_id, GL_LINK_STATUS, &status);
+        return status;
+    }
+public:
+    Program() {
+        program_id = glCreateProgram();
+    }
+    ~Program() {
+        glDeleteProgram(program_id);
+    }
+    void AttachShaders(std::initializer_list<Shader*> shaders) {
+        auto i = shaders.begin();
+        while (i != shaders.end()) {
+            if (!(*i)->isCompiled)
+                (*i)->compile();
+            glAttachShader(program_id, (*i)->shader_id);
+            ++i;
+        }
+        glLinkProgram(program_id);
+        if (!linkStatus()) {
+            sendError();
+        }
+    }
+    void UseProgram() {
+        glUseProgram(program_id);
+    }
+    void setMat4(const char *locName, const glm::mat4 &mat) {
+        int location = glGetUniformLocation(program_id, locName);
+        if (location == -1)
+            return;
+        glUniformMatrix4fv(location, 1, GL_FALSE, glm::value_ptr(mat));
+    }
+    void setInt(const char *locName, int value) {
+        int location = glGetUniformLocation(program_id, locName);
+        if (location == -1)
+            return;
+        glUniform1i(location, value);
+    }
+    void setFloat(const char *locName, float value) {
+        int location = glGetUniformLocation(program_id, locName);
+        if (location == -1)
+            return;
+        glUniform1f(location, value);
+    }
+    void setVec2(const char *locName, const glm::vec2 &vec) {
+        int location = glGetUniformLocation(program_id, locName);
+        if (location == -1)
+            return;
+        glUniform2f(location, vec.x, vec.y);
+    }
+    GLuint id() {
+        return program_id;
+    }
+};
+
+
+class Texture2D {
+    GLuint tex_id;
+public:
+    void generate2DTex(const char *image_path) {
+        int width, height, nChannels;
+        stbi_set_flip_vertically_on_load(true);
+        uint8_t *raw_image = stbi_load(image_path, &width, &height, &nChannels, 0);
+        float borderColor[] = {1.f, 1.f, 1.f, 1.f};
+        glGenTextures(1, &tex_id);
+        glBindTexture(GL_TEXTURE_2D, tex_id);
+        // what to do when primitive is bigger than the texture
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_BORDER);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_BORDER);
+        glTexParameterfv(GL_TEXTURE_2D, GL_TEXTURE_BORDER_COLOR, borderColor);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        // glTexImage2D(TARGET_TYPE, IM_MIPMAP_LEVEL, TARGET_NRCHANNELS, SRC_WIDTH, SRC_HEIGHT, LEGACY_0, SRC_NRCHANNELS, SRC_DATA_TYPE, SRC_DATA);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, width, height, 0, GL_RGB, GL_UNSIGNED_BYTE, raw_image);
+        stbi_image_free(raw_image);
+    }
+    void bind() {
+        glBindTexture(GL_TEXTURE_2D, tex_id);
+    }
+};
+// a handful of threads that split loops between them, the calling thread helps out
+class WorkerPool {
+    std::vector<std::thread> threads;
+    std::mutex mutex;
+    std::condition_variable wake, finished;
+    const std::function<void(size_t, size_t)> *job = nullptr;
+    size_t jobCount = 0;
+    size_t jobChunk = 1;
+    std::atomic<size_t> next{0};
+    int busy = 0;
+    uint64_t generation = 0;
+    bool quit = false;
+
+    void work() {
+        size_t begin;
+        while ((begin = next.fetch_add(jobChunk)) < jobCount)
+            (*job)(begin, std::min(begin + jobChunk, jobCount));
+    }
+public:
+    explicit WorkerPool(unsigned count = std::thread::hardware_concurrency()) {
+        for (unsigned i = 1; i < std::max(count, 1u); ++i) {
+            threads.emplace_back([this] {
+                uint64_t seen = 0;
+                std::unique_lock<std::mutex> lock(mutex);
+                while (true) {
+                    wake.wait(lock, [&] { return quit || generation != seen; });
+                    if (quit)
+                        return;
+                    seen = generation;
+                    lock.unlock();
+                    work();
+                    lock.lock();
+                    if (--busy == 0)
+                        finished.notify_one();
+                }
+            });
+        }
+    }
+    ~WorkerPool() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            quit = true;
+        }
+        wake.notify_all();
+        for (std::thread &t : threads)
+            t.join();
+    }
+    size_t size() const {
+        return threads.size() + 1;
+    }
+    // calls fn(begin, end) on ranges of at most chunk items until [0, count) is covered, returns when all are done
+    void parallelFor(size_t count, size_t chunk, const std::function<void(size_t, size_t)> &fn) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            job = &fn;
+            jobCount = count;
+            jobChunk = std::max<size_t>(chunk, 1);
+            next = 0;
+            busy = threads.size();
+            ++generation;
+        }
+        wake.notify_all();
+        work();
+        std::unique_lock<std::mutex> lock(mutex);
+        finished.wait(lock, [&] { return busy == 0; });
+    }
+};
+
+
+// a point light, or a spot light when cosAngle is above -1
+struct Light {
+    glm::vec3 pos;
+    float radius;
+    glm::vec3 color;
+    float cosAngle = -2.f;
+    glm::vec3 dir = glm::vec3(0.f, -1.f, 0.f);
+};
+
+// what the fragment shader gets per light: 3 RGBA32F texels in a texture buffer,
+// position and direction already in view space
+struct GpuLight {
+    glm::vec4 posRadius;
+    glm::vec4 colorCone;
+    glm::vec4 dir;
+};
+
+// the view frustum cut into a CLUSTERS_X x CLUSTERS_Y grid of screen tiles and CLUSTERS_Z depth slices.
+// slices are exponential in depth, so clusters are about as deep as they are wide everywhere.
+// every cluster gets the list of lights that can reach it; the shader finds its cluster from
+// gl_FragCoord and its depth, and only loops over that list
+class LightClusters {
+public:
+    static constexpr int CLUSTERS_X = 16;
+    static constexpr int CLUSTERS_Y = 9;
+    static constexpr int CLUSTERS_Z = 24;
+    static constexpr int CLUSTER_COUNT = CLUSTERS_X * CLUSTERS_Y * CLUSTERS_Z;
+private:
+    struct ClusterBounds {
+        glm::vec3 min, max;
+        glm::vec3 center;
+        float radius;
+    };
+    std::vector<ClusterBounds> bounds;
+    float zNear = 0.f, zFar = 0.f;
+    glm::mat4 projection = glm::mat4(0.f);
+
+    // per light: which tiles and slices it can touch at most
+    struct LightRange {
+        int x0, x1, y0, y1, z0, z1;
+    };
+    std::vector<LightRange> ranges;
+    std::vector<std::vector<uint32_t>> sliceIndices;
+    std::vector<uint32_t> clusterCounts;
+public:
+    std::vector<GpuLight> gpuLights;
+    std::vector<uint32_t> clusterRanges;  // offset, count per cluster
+    std::vector<uint32_t> lightIndices;
+
+    static int sliceOf(float depth, float zNear, float zFar) {
+        return int(std::floor(std::log(depth / zNear) / std::log(zFar / zNear) * CLUSTERS_Z));
+    }
+    void setProjection(const glm::mat4 &proj, float nearPlane, float farPlane);
+    void assign(const std::vector<Light> &lights, const glm::mat4 &view, WorkerPool &pool);
+};
+
+void LightClusters::setProjection(const glm::mat4 &proj, float nearPlane, float farPlane) {
+    if (proj == projection && nearPlane == zNear && farPlane == zFar)
+        return;
+    projection = proj, zNear = nearPlane, zFar = farPlane;
+    const glm::mat4 invProj = glm::inverse(proj);
+    bounds.resize(CLUSTER_COUNT);
+    for (int z = 0; z < CLUSTERS_Z; ++z) {
+        float sliceNear = zNear * std::pow(zFar / zNear, float(z) / CLUSTERS_Z);
+        float sliceFar = zNear * std::pow(zFar / zNear, float(z + 1) / CLUSTERS_Z);
+        for (int y = 0; y < CLUSTERS_Y; ++y) {
+            for (int x = 0; x < CLUSTERS_X; ++x) {
+                ClusterBounds &b = bounds[(z * CLUSTERS_Y + y) * CLUSTERS_X + x];
+                b.min = glm::vec3(FLT_MAX), b.max = glm::vec3(-FLT_MAX);
+                for (int corner = 0; corner < 4; ++corner) {
+                    float nx = float(x + (corner & 1)) / CLUSTERS_X * 2.f - 1.f;
+                    float ny = float(y + (corner >> 1)) / CLUSTERS_Y * 2.f - 1.f;
+                    // a point on the near plane through this tile corner gives us the ray direction
+                    glm::vec4 p = invProj * glm::vec4(nx, ny, -1.f, 1.f);
+                    glm::vec3 ray = glm::vec3(p) / p.w;
+                    for (float depth : {sliceNear, sliceFar}) {
+                        glm::vec3 q = ray * (depth / -ray.z);
+                        b.min = glm::min(b.min, q);
+                        b.max = glm::max(b.max, q);
+                    }
+                }
+                b.center = (b.min + b.max) * 0.5f;
+                b.radius = glm::length(b.max - b.center);
+            }
+        }
+    }
+}
+
+void LightClusters::assign(const std::vector<Light> &lights, const glm::mat4 &view, WorkerPool &pool) {
+    gpuLights.resize(lights.size());
+    ranges.resize(lights.size());
+    // pass 1, per light: view space, plus the conservative range of clusters it can touch
+    pool.parallelFor(lights.size(), 256, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            const Light &light = lights[i];
+            glm::vec3 pos = glm::vec3(view * glm::vec4(light.pos, 1.f));
+            glm::vec3 dir = glm::normalize(glm::vec3(view * glm::vec4(light.dir, 0.f)));
+            gpuLights[i] = {glm::vec4(pos, light.radius), glm::vec4(light.color, light.cosAngle), glm::vec4(dir, 0.f)};
+            LightRange &r = ranges[i];
+            float nearest = -pos.z - light.radius, farthest = -pos.z + light.radius;
+            if (farthest < zNear || nearest > zFar) {
+                r = {0, -1, 0, -1, 0, -1};
+                continue;
+            }
+            r.z0 = nearest <= zNear ? 0 : std::max(0, sliceOf(nearest, zNear, zFar));
+            r.z1 = std::min(CLUSTERS_Z - 1, sliceOf(std::min(farthest, zFar), zNear, zFar));
+            r.x0 = 0, r.x1 = CLUSTERS_X - 1, r.y0 = 0, r.y1 = CLUSTERS_Y - 1;
+            if (nearest <= zNear)
+                continue;  // camera is (almost) inside the light, don't bother projecting
+            float minX = 1.f, maxX = -1.f, minY = 1.f, maxY = -1.f;
+            for (int corner = 0; corner < 8; ++corner) {
+                glm::vec3 c = pos + glm::vec3(corner & 1 ? light.radius : -light.radius,
+                                              corner & 2 ? light.radius : -light.radius,
+                                              corner & 4 ? light.radius : -light.radius);
+                glm::vec4 clip = projection * glm::vec4(c, 1.f);
+                minX = std::min(minX, clip.x / clip.w), maxX = std::max(maxX, clip.x / clip.w);
+                minY = std::min(minY, clip.y / clip.w), maxY = std::max(maxY, clip.y / clip.w);
+            }
+            r.x0 = glm::clamp(int(std::floor((minX * 0.5f + 0.5f) * CLUSTERS_X)), 0, CLUSTERS_X - 1);
+            r.x1 = glm::clamp(int(std::floor((maxX * 0.5f + 0.5f) * CLUSTERS_X)), 0, CLUSTERS_X - 1);
+            r.y0 = glm::clamp(int(std::floor((minY * 0.5f + 0.5f) * CLUSTERS_Y)), 0, CLUSTERS_Y - 1);
+            r.y1 = glm::clamp(int(std::floor((maxY * 0.5f + 0.5f) * CLUSTERS_Y)), 0, CLUSTERS_Y - 1);
+            if (maxX < -1.f || minX > 1.f || maxY < -1.f || minY > 1.f)
+                r = {0, -1, 0, -1, 0, -1};
+        }
+    });
+
+    // pass 2, per depth slice: exact tests against the clusters. a worker owns whole slices,
+    // so the lists are built without any locking
+    sliceIndices.resize(CLUSTERS_Z);
+    clusterCounts.assign(CLUSTER_COUNT, 0);
+    pool.parallelFor(CLUSTERS_Z, 1, [&](size_t begin, size_t end) {
+        std::vector<uint32_t> cell[CLUSTERS_X * CLUSTERS_Y];
+        for (size_t z = begin; z < end; ++z) {
+            for (std::vector<uint32_t> &c : cell)
+                c.clear();
+            for (uint32_t i = 0; i < lights.size(); ++i) {
+                const LightRange &r = ranges[i];
+                if (int(z) < r.z0 || int(z) > r.z1)
+                    continue;
+                const glm::vec3 pos = glm::vec3(gpuLights[i].posRadius);
+                const float radius = gpuLights[i].posRadius.w;
+                const bool spot = lights[i].cosAngle > -1.f;
+                for (int y = r.y0; y <= r.y1; ++y) {
+                    for (int x = r.x0; x <= r.x1; ++x) {
+                        const ClusterBounds &b = bounds[(z * CLUSTERS_Y + y) * CLUSTERS_X + x];
+                        // sphere against box
+                        glm::vec3 closest = glm::clamp(pos, b.min, b.max);
+                        glm::vec3 d = closest - pos;
+                        if (glm::dot(d, d) > radius * radius)
+                            continue;
+                        if (spot) {
+                            // cone against the cluster's bounding sphere
+                            glm::vec3 v = b.center - pos;
+                            float lenSq = glm::dot(v, v);
+                            float v1 = glm::dot(v, glm::vec3(gpuLights[i].dir));
+                            float cosA = lights[i].cosAngle, sinA = std::sqrt(1.f - cosA * cosA);
+                            float distClosest = cosA * std::sqrt(std::max(lenSq - v1 * v1, 0.f)) - v1 * sinA;
+                            if (distClosest > b.radius || v1 > b.radius + radius || v1 < -b.radius)
+                                continue;
+                        }
+                        cell[y * CLUSTERS_X + x].push_back(i);
+                    }
+                }
+            }
+            std::vector<uint32_t> &out = sliceIndices[z];
+            out.clear();
+            for (int c = 0; c < CLUSTERS_X * CLUSTERS_Y; ++c) {
+                clusterCounts[z * CLUSTERS_X * CLUSTERS_Y + c] = cell[c].size();
+                out.insert(out.end(), cell[c].begin(), cell[c].end());
+            }
+        }
+    });
+
+    // stitch the slices together into one index list
+    clusterRanges.resize(CLUSTER_COUNT * 2);
+    lightIndices.clear();
+    for (int z = 0; z < CLUSTERS_Z; ++z) {
+        for (int c = 0; c < CLUSTERS_X * CLUSTERS_Y; ++c) {
+            int cluster = z * CLUSTERS_X * CLUSTERS_Y + c;
+            clusterRanges[cluster * 2] = lightIndices.size();
+            clusterRanges[cluster * 2 + 1] = clusterCounts[cluster];
+            lightIndices.resize(lightIndices.size() + clusterCounts[cluster]);
+        }
+        std::copy(sliceIndices[z].begin(), sliceIndices[z].end(), lightIndices.end() - sliceIndices[z].size());
+    }
+}
+
+
+// a buffer the shaders read with texelFetch through a texture buffer, e.g. samplerBuffer or usamplerBuffer
+class TextureBuffer {
+    GLuint buffer_id = 0;
+    GLuint tex_id = 0;
+    GLenum format;
+    size_t capacity = 0;
+public:
+    explicit TextureBuffer(GLenum format) : format(format) {
+        glGenBuffers(1, &buffer_id);
+        glGenTextures(1, &tex_id);
+    }
+    ~TextureBuffer() {
+        glDeleteTextures(1, &tex_id);
+        glDeleteBuffers(1, &buffer_id);
+    }
+    void upload(const void *data, size_t bytes) {
+        glBindBuffer(GL_TEXTURE_BUFFER, buffer_id);
+        if (bytes > capacity) {
+            capacity = std::max(bytes, capacity * 2);
+            glBufferData(GL_TEXTURE_BUFFER, capacity, NULL, GL_STREAM_DRAW);
+            glBindTexture(GL_TEXTURE_BUFFER, tex_id);
+            glTexBuffer(GL_TEXTURE_BUFFER, format, buffer_id);
+        } else {
+            // orphan the old storage so we don't wait for the frame that still reads it
+            glBufferData(GL_TEXTURE_BUFFER, capacity, NULL, GL_STREAM_DRAW);
+        }
+        glBufferSubData(GL_TEXTURE_BUFFER, 0, bytes, data);
+    }
+    void bind(int unit) {
+        glActiveTexture(GL_TEXTURE0 + unit);
+        glBindTexture(GL_TEXTURE_BUFFER, tex_id);
+        glActiveTexture(GL_TEXTURE0);
+    }
+};
+
+
+std::vector<Light> makeLights(size_t count) {
+    std::mt19937 rng(99);
+    std::uniform_real_distribution<float> unit(0.f, 1.f);
+    std::vector<Light> lights(count);
+    for (size_t i = 0; i < lights.size(); ++i) {
+        Light &light = lights[i];
+        light.pos = glm::vec3(unit(rng) * 60.f - 30.f, 0.3f + unit(rng) * 2.f, -unit(rng) * 60.f);
+        light.radius = 1.f + unit(rng) * 3.f;
+        light.color = glm::vec3(unit(rng), unit(rng), unit(rng));
+        // an eighth of them are spot lights pointing down
+        if (i < count / 8)
+            light.cosAngle = std::cos(glm::radians(20.f + unit(rng) * 20.f)), light.radius *= 2.f;
+    }
+    return lights;
+}
+
+void moveLights(std::vector<Light> &lights, float time) {
+    for (size_t i = 0; i < lights.size(); ++i) {
+        float phase = time * (0.5f + (i % 7) * 0.1f) + i;
+        lights[i].pos.x += std::cos(phase) * 0.02f;
+        lights[i].pos.z += std::sin(phase) * 0.02f;
+    }
+}
+
+// ./main --bench [lights]: times the assignment and compares it with testing every light against every cluster
+int runBenchmark(size_t count) {
+    WorkerPool pool;
+    LightClusters clusters;
+    const float zNear = 0.1f, zFar = 100.f;
+    glm::mat4 proj = glm::perspective(glm::radians(45.f), 800 / 600.f, zNear, zFar);
+    glm::mat4 view = glm::lookAt(glm::vec3(0.f, 2.f, 3.f), glm::vec3(0.f, 0.f, -10.f), glm::vec3(0.f, 1.f, 0.f));
+    clusters.setProjection(proj, zNear, zFar);
+    std::vector<Light> lights = makeLights(count);
+
+    constexpr int REPEATS = 50;
+    double best = 1e9;
+    for (int r = 0; r < REPEATS; ++r) {
+        auto start = std::chrono::steady_clock::now();
+        clusters.assign(lights, view, pool);
+        best = std::min(best, std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+    }
+    size_t maxPerCluster = 0, nonEmpty = 0;
+    for (int c = 0; c < LightClusters::CLUSTER_COUNT; ++c) {
+        maxPerCluster = std::max<size_t>(maxPerCluster, clusters.clusterRanges[c * 2 + 1]);
+        nonEmpty += clusters.clusterRanges[c * 2 + 1] != 0;
+    }
+    std::cout << count << " lights assigned in " << best << "ms on " << pool.size() << " threads\n"
+              << clusters.lightIndices.size() << " light references, " << double(clusters.lightIndices.size()) / std::max<size_t>(nonEmpty, 1)
+              << " lights per non-empty cluster on average, " << maxPerCluster << " at most\n";
+
+    // brute force the other way around: sample points all through every cluster's piece of the frustum,
+    // any light that reaches one of them has to be in that cluster's list
+    const glm::mat4 invProj = glm::inverse(proj);
+    constexpr int SAMPLES = 4;
+    size_t missing = 0;
+    for (int z = 0; z < LightClusters::CLUSTERS_Z; ++z) {
+        for (int y = 0; y < LightClusters::CLUSTERS_Y; ++y) {
+            for (int x = 0; x < LightClusters::CLUSTERS_X; ++x) {
+                std::vector<glm::vec3> points;
+                for (int sz = 0; sz <= SAMPLES; ++sz) {
+                    float depth = zNear * std::pow(zFar / zNear, (z + float(sz) / SAMPLES) / LightClusters::CLUSTERS_Z);
+                    for (int sy = 0; sy <= SAMPLES; ++sy) {
+                        for (int sx = 0; sx <= SAMPLES; ++sx) {
+                            glm::vec4 p = invProj * glm::vec4((x + float(sx) / SAMPLES) / LightClusters::CLUSTERS_X * 2.f - 1.f,
+                                                              (y + float(sy) / SAMPLES) / LightClusters::CLUSTERS_Y * 2.f - 1.f, -1.f, 1.f);
+                            glm::vec3 ray = glm::vec3(p) / p.w;
+                            points.push_back(ray * (depth / -ray.z));
+                        }
+                    }
+                }
+                int cluster = (z * LightClusters::CLUSTERS_Y + y) * LightClusters::CLUSTERS_X + x;
+                const uint32_t *list = &clusters.lightIndices[clusters.clusterRanges[cluster * 2]];
+                const uint32_t *listEnd = list + clusters.clusterRanges[cluster * 2 + 1];
+                for (uint32_t i = 0; i < lights.size(); ++i) {
+                    const GpuLight &light = clusters.gpuLights[i];
+                    for (const glm::vec3 &p : points) {
+                        glm::vec3 toPoint = p - glm::vec3(light.posRadius);
+                        float dist = glm::length(toPoint);
+                        bool lit = dist < light.posRadius.w * 0.999f;
+                        if (lit && light.colorCone.w > -1.f && dist > 0.f)
+                            lit = glm::dot(toPoint / dist, glm::vec3(light.dir)) > light.colorCone.w + 1e-3f;
+                        if (lit) {
+                            missing += std::find(list, listEnd, i) == listEnd;
+                            break;
+                        }
+                    }
+                }
+            }
+        }
+    }
+    std::cout << (missing ? "MISSING " : "") << missing << " light/cluster pairs missed compared to brute force\n";
+    return missing ? EXIT_FAILURE : EXIT_SUCCESS;
+}
+
+
+void processInput(GLFWwindow *window, glm::vec3 &cameraPos, glm::vec3 &cameraFront, glm::vec3 &cameraUp)
+{
+
+    const float cameraSpeed = 0.05f; // adjust accordingly
+    if (glfwGetKey(window, GLFW_KEY_W) == GLFW_PRESS)
+        cameraPos += cameraSpeed * cameraFront;
+    if (glfwGetKey(window, GLFW_KEY_S) == GLFW_PRESS)
+        cameraPos -= cameraSpeed * cameraFront;
+    if (glfwGetKey(window, GLFW_KEY_A) == GLFW_PRESS)
+        cameraPos -= glm::normalize(glm::cross(cameraFront, cameraUp)) * cameraSpeed;
+    if (glfwGetKey(window, GLFW_KEY_D) == GLFW_PRESS)
+        cameraPos += glm::normalize(glm::cross(cameraFront, cameraUp)) * cameraSpeed;
+    if (glfwGetKey(window, GLFW_KEY_UP) == GLFW_PRESS)
+        cameraPos += glm::normalize(glm::cross(cameraFront, cameraUp)) * cameraSpeed;
+
+}
+
+
+float yaw = -90.f;
+float pitch = 0.f;
+glm::vec3 cameraFront;
+
+void mouseMovement(GLFWwindow *window, double xPos, double yPos) {
+    static float lastX = xPos, lastY = yPos;
+    float xOffset = xPos - lastX;
+    float yOffset = lastY - yPos;
+    
+    constexpr float sensitivity = 0.05f;
+    xOffset *= sensitivity;
+    yOffset *= sensitivity;
+
+    yaw += xOffset;
+    pitch += yOffset;
+
+    if (std::abs(pitch) > 89.f) // don't ever do it this way. I am lazy
+        pitch = std::abs(pitch) / pitch * 89.f;
+
+    cameraFront.x = cos(glm::radians(yaw)) * cos(glm::radians(pitch));
+    cameraFront.y = sin(glm::radians(pitch));
+    cameraFront.z = sin(glm::radians(yaw)) * cos(glm::radians(pitch));
+
+    cameraFront = glm::normalize(cameraFront);
+    lastX = xPos, lastY = yPos;
+}
+
+
+
+
+
+int main(int argc, char **argv) {
+    if (argc > 1 && !std::strcmp(argv[1], "--bench"))
+        return runBenchmark(argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 4096);
+    // ./main [lights]
+    const size_t lightCount = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 4096;
+
+    if (glfwInit() != GLFW_TRUE) {
+        glfwTerminate();
+        std::cerr << "Failed to initialize GLFW";
+        return EXIT_FAILURE;
+    }
+    // setting OpenGL version to 3.3
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+    GLFWwindow *win = glfwCreateWindow(800, 600, "This is a hello window!", NULL, NULL);
+    // setting 'context' for OpenGL, i.e. where to draw on current thread
+    glfwMakeContextCurrent(win);
+    // all it does is fetches us the implemented functions of OpenGL
+    if (glewInit() != GLEW_OK) {
+        glfwTerminate();
+        std::cerr << "Failed to initialize GLEW\n";
+        return EXIT_FAILURE;
+    }
+    // the clusters are laid over the framebuffer, so it has to be what the shader thinks it is
+    int screenWidth, screenHeight;
+    glfwGetFramebufferSize(win, &screenWidth, &screenHeight);
+    glViewport(0, 0, screenWidth, screenHeight);
+
+    glEnable(GL_DEPTH_TEST);
+    float triangle_data[] = {
+        //   vertpos   //  //   normal   //  //texcord//
+    -0.5f, -0.5f, -0.5f,  0.0f,  0.0f, -1.0f,  0.0f, 0.0f,
+     0.5f, -0.5f, -0.5f,  0.0f,  0.0f, -1.0f,  1.0f, 0.0f,
+     0.5f,  0.5f, -0.5f,  0.0f,  0.0f, -1.0f,  1.0f, 1.0f,
+     0.5f,  0.5f, -0.5f,  0.0f,  0.0f, -1.0f,  1.0f, 1.0f,
+    -0.5f,  0.5f, -0.5f,  0.0f,  0.0f, -1.0f,  0.0f, 1.0f,
+    -0.5f, -0.5f, -0.5f,  0.0f,  0.0f, -1.0f,  0.0f, 0.0f,
+
+    -0.5f, -0.5f,  0.5f,  0.0f,  0.0f,  1.0f,  0.0f, 0.0f,
+     0.5f, -0.5f,  0.5f,  0.0f,  0.0f,  1.0f,  1.0f, 0.0f,
+     0.5f,  0.5f,  0.5f,  0.0f,  0.0f,  1.0f,  1.0f, 1.0f,
+     0.5f,  0.5f,  0.5f,  0.0f,  0.0f,  1.0f,  1.0f, 1.0f,
+    -0.5f,  0.5f,  0.5f,  0.0f,  0.0f,  1.0f,  0.0f, 1.0f,
+    -0.5f, -0.5f,  0.5f,  0.0f,  0.0f,  1.0f,  0.0f, 0.0f,
+
+    -0.5f,  0.5f,  0.5f, -1.0f,  0.0f,  0.0f,  1.0f, 0.0f,
+    -0.5f,  0.5f, -0.5f, -1.0f,  0.0f,  0.0f,  1.0f, 1.0f,
+    -0.5f, -0.5f, -0.5f, -1.0f,  0.0f,  0.0f,  0.0f, 1.0f,
+    -0.5f, -0.5f, -0.5f, -1.0f,  0.0f,  0.0f,  0.0f, 1.0f,
+    -0.5f, -0.5f,  0.5f, -1.0f,  0.0f,  0.0f,  0.0f, 0.0f,
+    -0.5f,  0.5f,  0.5f, -1.0f,  0.0f,  0.0f,  1.0f, 0.0f,
+
+     0.5f,  0.5f,  0.5f,  1.0f,  0.0f,  0.0f,  1.0f, 0.0f,
+     0.5f,  0.5f, -0.5f,  1.0f,  0.0f,  0.0f,  1.0f, 1.0f,
+     0.5f, -0.5f, -0.5f,  1.0f,  0.0f,  0.0f,  0.0f, 1.0f,
+     0.5f, -0.5f, -0.5f,  1.0f,  0.0f,  0.0f,  0.0f, 1.0f,
+     0.5f, -0.5f,  0.5f,  1.0f,  0.0f,  0.0f,  0.0f, 0.0f,
+     0.5f,  0.5f,  0.5f,  1.0f,  0.0f,  0.0f,  1.0f, 0.0f,
+
+    -0.5f, -0.5f, -0.5f,  0.0f, -1.0f,  0.0f,  0.0f, 1.0f,
+     0.5f, -0.5f, -0.5f,  0.0f, -1.0f,  0.0f,  1.0f, 1.0f,
+     0.5f, -0.5f,  0.5f,  0.0f, -1.0f,  0.0f,  1.0f, 0.0f,
+     0.5f, -0.5f,  0.5f,  0.0f, -1.0f,  0.0f,  1.0f, 0.0f,
+    -0.5f, -0.5f,  0.5f,  0.0f, -1.0f,  0.0f,  0.0f, 0.0f,
+    -0.5f, -0.5f, -0.5f,  0.0f, -1.0f,  0.0f,  0.0f, 1.0f,
+
+    -0.5f,  0.5f, -0.5f,  0.0f,  1.0f,  0.0f,  0.0f, 1.0f,
+     0.5f,  0.5f, -0.5f,  0.0f,  1.0f,  0.0f,  1.0f, 1.0f,
+     0.5f,  0.5f,  0.5f,  0.0f,  1.0f,  0.0f,  1.0f, 0.0f,
+     0.5f,  0.5f,  0.5f,  0.0f,  1.0f,  0.0f,  1.0f, 0.0f,
+    -0.5f,  0.5f,  0.5f,  0.0f,  1.0f,  0.0f,  0.0f, 0.0f,
+    -0.5f,  0.5f, -0.5f,  0.0f,  1.0f,  0.0f,  0.0f, 1.0f
+        
+    };
+
+
+    glm::vec3 cameraPos(0.f, 0.f, 3.f);
+    cameraFront = glm::vec3(0.f,0.f,-1.f);
+    glm::vec3 cameraUp(0.,1.,0.f);
+    
+
+    Texture2D tex;
+    tex.generate2DTex("./image2d.tex");
+    tex.bind();
+
+    GLuint vbo = 0;
+    glGenBuffers(1, &vbo); 
+    glBindBuffer(GL_ARRAY_BUFFER, vbo);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(triangle_data), triangle_data, GL_STATIC_DRAW);
+
+    GLuint vao = 0;
+    glGenVertexArrays(1, &vao);
+    glBindVertexArray(vao);
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)0);
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)(6 * sizeof(float)));
+    glEnableVertexAttribArray(1);
+    glVertexAttribPointer(2, 3, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)(3 * sizeof(float)));
+    glEnableVertexAttribArray(2);
+
+    VertexShader vs;
+    FragmentShader fs;
+    vs.setSource("./vertex.glsl");
+    fs.setSource("./frag.glsl");
+    Program prog;
+    prog.AttachShaders({&vs, &fs});
+    prog.UseProgram();
+
+
+    // light data, the cluster grid and the per cluster light lists, all read with texelFetch
+    TextureBuffer lightBuffer(GL_RGBA32F);
+    TextureBuffer clusterBuffer(GL_RG32UI);
+    TextureBuffer indexBuffer(GL_R32UI);
+    lightBuffer.bind(1);
+    clusterBuffer.bind(2);
+    indexBuffer.bind(3);
+    prog.setInt("tex", 0);
+    prog.setInt("lights", 1);
+    prog.setInt("clusters", 2);
+    prog.setInt("lightIndices", 3);
+
+    WorkerPool pool;
+    LightClusters clusters;
+    std::vector<Light> lights = makeLights(lightCount);
+    double lastReport = glfwGetTime();
+
+    glm::mat4 view; // = glm::translate(glm::mat4(1.f), glm::vec3(0.f,0.f,-3.f));
+       
+
+    const float zNear = 0.1f, zFar = 100.f;
+    glm::mat4 proj = glm::perspective(glm::radians(45.f), float(screenWidth) / screenHeight, zNear, zFar);
+    clusters.setProjection(proj, zNear, zFar);
+
+    prog.setMat4("proj", proj);
+    prog.setFloat("zNear", zNear);
+    prog.setFloat("zFar", zFar);
+    prog.setVec2("screenSize", glm::vec2(screenWidth, screenHeight));
+    glUniform3i(glGetUniformLocation(prog.id(), "clusterDims"), LightClusters::CLUSTERS_X, LightClusters::CLUSTERS_Y, LightClusters::CLUSTERS_Z);
+    prog.setMat4("view", view);
+
+    glfwSetCursorPosCallback(win, mouseMovement); 
+    glfwSetInputMode(win, GLFW_CURSOR, GLFW_CURSOR_DISABLED);  
+    
+    while (!glfwWindowShouldClose(win)) {
+        processInput(win, cameraPos, cameraFront, cameraUp);
+        view = glm::lookAt(cameraPos, cameraFront + cameraPos, cameraUp);
+
+        prog.setMat4("view", view);
+
+        moveLights(lights, glfwGetTime());
+        auto start = std::chrono::steady_clock::now();
+        clusters.assign(lights, view, pool);
+        double assignMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        lightBuffer.upload(clusters.gpuLights.data(), clusters.gpuLights.size() * sizeof(GpuLight));
+        clusterBuffer.upload(clusters.clusterRanges.data(), clusters.clusterRanges.size() * sizeof(uint32_t));
+        indexBuffer.upload(clusters.lightIndices.data(), std::max<size_t>(clusters.lightIndices.size(), 1) * sizeof(uint32_t));
+
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+        // a floor and a forest of pillars for the lights to shine on
+        glm::mat4 floor = glm::translate(glm::mat4(1.f), glm::vec3(0.f, -0.1f, -30.f));
+        prog.setMat4("model", glm::scale(floor, glm::vec3(60.f, 0.2f, 60.f)));
+        glDrawArrays(GL_TRIANGLES, 0, 36);
+        for (int z = 0; z < 12; ++z) {
+            for (int x = 0; x < 12; ++x) {
+                glm::mat4 pillar = glm::translate(glm::mat4(1.f), glm::vec3(x * 5.f - 27.5f, 1.5f, -z * 5.f - 2.5f));
+                prog.setMat4("model", glm::scale(pillar, glm::vec3(0.6f, 3.f, 0.6f)));
+                glDrawArrays(GL_TRIANGLES, 0, 36);
+            }
+        }
+        if (glfwGetTime() - lastReport > 1.) {
+            lastReport = glfwGetTime();
+            std::cout << lights.size() << " lights, " << clusters.lightIndices.size() << " light/cluster pairs, assigned in "
+                      << assignMs << "ms\n";
+        }
+        // polls different kinds of events, for example, when we close an application, it fetches that event
+        // or it fetches events like movement of the window.
+        // Without it you can neither move the window or close the window
+        glfwPollEvents();
+        // have you drawn the image, it is stored in the buffer. You can now swap this buffer with main buffer
+        // so the image appears
+        glfwSwapBuffers(win);
+    }
+    glfwTerminate();
+    
+    std::cout << "Window should close now!\n";
+
+    return EXIT_SUCCESS;
+
+}
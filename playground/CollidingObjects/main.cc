@@ -0,0 +1,1019 @@
+#include <GL/glew.h>
+
+#include <GLFW/glfw3.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cmath>
+#include <cstdio>
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <immintrin.h>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+#include <glm/ext/matrix_clip_space.hpp>
+#include <glm/ext/matrix_transform.hpp>
+#include <glm/geometric.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/ext/matrix_float4x4.hpp>
+#include <glm/gtc/type_ptr.hpp>
+#include <glm/glm.hpp>
+#include <glm/trigonometric.hpp>
+#define STB_IMAGE_IMPLEMENTATION
+#include <stb/stb_image.h>
+#include <iostream>
+
+class Shader {
+    std::string src; 
+protected:
+    const char *getsrc() {
+        return src.data();
+    }
+    GLuint shader_id = 0;
+    bool isCompiled = false;
+protected:
+    virtual const char *getClassName() = 0;
+    GLint getCompilationStatus(GLuint shader_id) {
+        int status;
+        glGetShaderiv(shader_id, GL_COMPILE_STATUS, &status);
+        return status;
+    }
+    void sendError() {
+        char buffer[1024];
+        glGetShaderInfoLog(shader_id, 1024, NULL, buffer);
+        std::cerr << "ERROR::" << getClassName() << " - " << buffer;
+    }
+public:
+    virtual void compile() = 0;
+    void setSource(const char *s) {
+        std::ifstream sourceFile(s);
+        if (!sourceFile.is_open())
+            return;
+        char buffer[8192];
+        while (sourceFile.read(buffer, 8192)) {
+            src.append(buffer, 8192);
+        }
+        if (!sourceFile.eof()) {
+            src.clear();
+            return;
+        }
+        src.append(buffer, sourceFile.gcount());
+    }
+    friend class Program;
+};
+
+
+class VertexShader : public Shader {
+    virtual const char *getClassName() override {
+        return "VertexShader";
+    }
+public:
+    virtual void compile() override {
+        if (shader_id)
+            glDeleteShader(shader_id);
+        shader_id = glCreateShader(GL_VERTEX_SHADER);
+        const char *src = getsrc();
+        glShaderSource(shader_id, 1, &src, NULL);
+        glCompileShader(shader_id);
+        if (!getCompilationStatus(shader_id)) {
+            sendError();
+        }
+        isCompiled = true;
+    }
+};
+
+class FragmentShader : public Shader {
+    const char *getClassName() override {
+        return "FragmentShader";
+    }
+public:
+    virtual void compile() override {
+        if (shader_id)
+            glDeleteShader(shader_id);
+        shader_id = glCreateShader(GL_FRAGMENT_SHADER);
+        const char *src = getsrc();
+        glShaderSource(shader_id, 1, &src, NULL);
+        glCompileShader(shader_id);
+        if (!getCompilationStatus(shader_id)) {
+            sendError();
+        }
+        isCompiled = true;
+    }
+};
+
+
+class Program {
+    GLuint program_id = 0;
+    void sendError() {
+        char buffer[1024];
+        glGetProgramInfoLog(program_id, 1024, NULL, buffer);
+        std::cerr << "ERROR::PROGRAM: " << " - " << buffer;
+    }
+    bool linkStatus() {
+        int status = 0;
+        glGetProgramiv(program_id, GL_LINK_STATUS, &status);
+        return status;
+    }
+public:
+    Program() {
+        program_id = glCreateProgram();
+    }
+    ~Program() {
+        glDeleteProgram(program_id);
+    }
+    void AttachShaders(std::initializer_list<Shader*> shaders) {
+        auto i = shaders.begin();
+        while (i != shaders.end()) {
+            if (!(*i)->isCompiled)
+                (*i)->compile();
+            glAttachShader(program_id, (*i)->shader_id);
+            ++i;
+        }
+        glLinkProgram(program_id);
+        if (!linkStatus()) {
+            sendError();
+        }
+    }
+    void UseProgram() {
+        glUseProgram(program_id);
+    }
+    void setMat4(const char *locName, const glm::mat4 &mat) {
+        int location = glGetUniformLocation(program_id, locName);
+        if (location == -1)
+            return;
+        glUniformMatrix4fv(location, 1, GL_FALSE, glm::value_ptr(mat));
+    }
+    void setInt(const char *locName, int value) {
+        int location = glGetUniformLocation(program_id, locName);
+        if (location == -1)
+            return;
+        glUniform1i(location, value);
+    }
+    void setFloat(const char *locName, float value) {
+        int location = glGetUniformLocation(program_id, locName);
+        if (location == -1)
+            return;
+        glUniform1f(location, value);
+    }
+    void setVec3(const char *locName, const glm::vec3 &vec) {
+        int location = glGetUniformLocation(program_id, locName);
+        if (location == -1)
+            return;
+        glUniform3f(location, vec.x, vec.y, vec.z);
+    }
+    void setVec4(const char *locName, const glm::vec4 &vec) {
+        int location = glGetUniformLocation(program_id, locName);
+        if (location == -1)
+            return;
+        glUniform4f(location, vec.x, vec.y, vec.z, vec.w);
+    }
+};
+
+
+class Texture2D {
+    GLuint tex_id;
+public:
+    void generate2DTex(const char *image_path) {
+        int width, height, nChannels;
+        stbi_set_flip_vertically_on_load(true);
+        uint8_t *raw_image = stbi_load(image_path, &width, &height, &nChannels, 0);
+        float borderColor[] = {1.f, 1.f, 1.f, 1.f};
+        glGenTextures(1, &tex_id);
+        glBindTexture(GL_TEXTURE_2D, tex_id);
+        // what to do when primitive is bigger than the texture
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_BORDER);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_BORDER);
+        glTexParameterfv(GL_TEXTURE_2D, GL_TEXTURE_BORDER_COLOR, borderColor);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        // glTexImage2D(TARGET_TYPE, IM_MIPMAP_LEVEL, TARGET_NRCHANNELS, SRC_WIDTH, SRC_HEIGHT, LEGACY_0, SRC_NRCHANNELS, SRC_DATA_TYPE, SRC_DATA);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, width, height, 0, GL_RGB, GL_UNSIGNED_BYTE, raw_image);
+        stbi_image_free(raw_image);
+    }
+    void bind() {
+        glBindTexture(GL_TEXTURE_2D, tex_id);
+    }
+};
+
+
+// a handful of threads that split loops between them, the calling thread helps out
+class WorkerPool {
+    std::vector<std::thread> threads;
+    std::mutex mutex;
+    std::condition_variable wake, finished;
+    const std::function<void(size_t, size_t)> *job = nullptr;
+    size_t jobCount = 0;
+    size_t jobChunk = 1;
+    std::atomic<size_t> next{0};
+    int busy = 0;
+    uint64_t generation = 0;
+    bool quit = false;
+
+    void work() {
+        size_t begin;
+        while ((begin = next.fetch_add(jobChunk)) < jobCount)
+            (*job)(begin, std::min(begin + jobChunk, jobCount));
+    }
+public:
+    explicit WorkerPool(unsigned count = std::thread::hardware_concurrency()) {
+        for (unsigned i = 1; i < std::max(count, 1u); ++i) {
+            threads.emplace_back([this] {
+                uint64_t seen = 0;
+                std::unique_lock<std::mutex> lock(mutex);
+                while (true) {
+                    wake.wait(lock, [&] { return quit || generation != seen; });
+                    if (quit)
+                        return;
+                    seen = generation;
+                    lock.unlock();
+                    work();
+                    lock.lock();
+                    if (--busy == 0)
+                        finished.notify_one();
+                }
+            });
+        }
+    }
+    ~WorkerPool() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            quit = true;
+        }
+        wake.notify_all();
+        for (std::thread &t : threads)
+            t.join();
+    }
+    size_t size() const {
+        return threads.size() + 1;
+    }
+    // calls fn(begin, end) on ranges of at most chunk items until [0, count) is covered, returns when all are done
+    void parallelFor(size_t count, size_t chunk, const std::function<void(size_t, size_t)> &fn) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            job = &fn;
+            jobCount = count;
+            jobChunk = std::max<size_t>(chunk, 1);
+            next = 0;
+            busy = threads.size();
+            ++generation;
+        }
+        wake.notify_all();
+        work();
+        std::unique_lock<std::mutex> lock(mutex);
+        finished.wait(lock, [&] { return busy == 0; });
+    }
+};
+
+
+// ---------------------------------------------------------------------------------------------------------
+// broadphase: sweep and prune. the boxes are kept sorted by where they start along x, and two boxes can
+// only overlap if the later one starts before the earlier one ends, so every box is tested only against
+// the short run of boxes right after it. things move a little from one frame to the next, which means last
+// frame's order is nearly right already and an insertion sort fixes it in about linear time, where sorting
+// from scratch would be n log n every frame. what comes out is a list of pairs whose boxes touch, deciding
+// what to do about them is up to the narrowphase
+// ---------------------------------------------------------------------------------------------------------
+
+struct Aabb {
+    glm::vec3 min, max;
+};
+
+bool overlaps(const Aabb &a, const Aabb &b) {
+    return a.min.x <= b.max.x && b.min.x <= a.max.x &&
+           a.min.y <= b.max.y && b.min.y <= a.max.y &&
+           a.min.z <= b.max.z && b.min.z <= a.max.z;
+}
+
+// smaller id first, so the same two boxes always make the same pair
+struct BoxPair {
+    uint32_t a, b;
+
+    bool operator<(const BoxPair &other) const {
+        return a != other.a ? a < other.a : b < other.b;
+    }
+    bool operator==(const BoxPair &other) const {
+        return a == other.a && b == other.b;
+    }
+};
+
+BoxPair makePair(uint32_t a, uint32_t b) {
+    return a < b ? BoxPair{a, b} : BoxPair{b, a};
+}
+
+// the boxes in sweep order, one array per side, so a whole run of candidates is loaded 8 at a time
+struct SweepBounds {
+    std::vector<float> minX, maxX, minY, maxY, minZ, maxZ;
+    std::vector<uint32_t> ids;
+
+    void resize(size_t count) {
+        for (std::vector<float> *side : {&minX, &maxX, &minY, &maxY, &minZ, &maxZ})
+            side->resize(count);
+        ids.resize(count);
+    }
+    size_t size() const {
+        return ids.size();
+    }
+};
+
+// the pairs that start at boxes [begin, end) of the sweep order, as positions in it. the run after a box
+// ends at the first box that starts past its end on x, and since every box in it starts after ours on x,
+// x never needs the other test
+void sweepScalar(const SweepBounds &s, size_t begin, size_t end, std::vector<BoxPair> &pairs) {
+    const size_t count = s.size();
+    for (size_t i = begin; i < end; ++i) {
+        const float maxX = s.maxX[i], minY = s.minY[i], maxY = s.maxY[i], minZ = s.minZ[i], maxZ = s.maxZ[i];
+        for (size_t j = i + 1; j < count && s.minX[j] <= maxX; ++j) {
+            if (s.minY[j] <= maxY && s.maxY[j] >= minY && s.minZ[j] <= maxZ && s.maxZ[j] >= minZ)
+                pairs.push_back({uint32_t(i), uint32_t(j)});
+        }
+    }
+}
+
+
+#if defined(__x86_64__) || defined(__i386__)
+#define SWEEP_KERNELS_X86 1
+
+// the same sweep, 8 candidates at once. the run is sorted, so the candidates still inside it on x are the
+// first lanes of the mask, and the first block that isn't all inside is the last one
+__attribute__((target("avx2")))
+void sweepAvx2(const SweepBounds &s, size_t begin, size_t end, std::vector<BoxPair> &pairs) {
+    const size_t count = s.size();
+    for (size_t i = begin; i < end; ++i) {
+        const __m256 maxX = _mm256_set1_ps(s.maxX[i]);
+        const __m256 minY = _mm256_set1_ps(s.minY[i]), maxY = _mm256_set1_ps(s.maxY[i]);
+        const __m256 minZ = _mm256_set1_ps(s.minZ[i]), maxZ = _mm256_set1_ps(s.maxZ[i]);
+        size_t j = i + 1;
+        bool runEnded = false;
+        for (; j + 8 <= count; j += 8) {
+            __m256 inRun = _mm256_cmp_ps(_mm256_loadu_ps(&s.minX[j]), maxX, _CMP_LE_OQ);
+            __m256 hit = _mm256_and_ps(inRun, _mm256_cmp_ps(_mm256_loadu_ps(&s.minY[j]), maxY, _CMP_LE_OQ));
+            hit = _mm256_and_ps(hit, _mm256_cmp_ps(_mm256_loadu_ps(&s.maxY[j]), minY, _CMP_GE_OQ));
+            hit = _mm256_and_ps(hit, _mm256_cmp_ps(_mm256_loadu_ps(&s.minZ[j]), maxZ, _CMP_LE_OQ));
+            hit = _mm256_and_ps(hit, _mm256_cmp_ps(_mm256_loadu_ps(&s.maxZ[j]), minZ, _CMP_GE_OQ));
+            for (unsigned mask = _mm256_movemask_ps(hit); mask; mask &= mask - 1)
+                pairs.push_back({uint32_t(i), uint32_t(j + __builtin_ctz(mask))});
+            if (_mm256_movemask_ps(inRun) != 0xff) {
+                runEnded = true;
+                break;
+            }
+        }
+        if (runEnded)
+            continue;
+        const float maxXs = s.maxX[i], minYs = s.minY[i], maxYs = s.maxY[i], minZs = s.minZ[i], maxZs = s.maxZ[i];
+        for (; j < count && s.minX[j] <= maxXs; ++j) {
+            if (s.minY[j] <= maxYs && s.maxY[j] >= minYs && s.minZ[j] <= maxZs && s.maxZ[j] >= minZs)
+                pairs.push_back({uint32_t(i), uint32_t(j)});
+        }
+    }
+}
+#endif
+
+struct SweepKernels {
+    void (*sweep)(const SweepBounds &s, size_t begin, size_t end, std::vector<BoxPair> &pairs) = sweepScalar;
+    std::string name = "scalar";
+};
+
+SweepKernels bestSweepKernels() {
+    SweepKernels kernels;
+#ifdef SWEEP_KERNELS_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        kernels.sweep = sweepAvx2;
+        kernels.name = "avx2";
+    }
+#endif
+    return kernels;
+}
+
+struct BroadphaseTimings {
+    double sort = 0., sweep = 0.;
+    size_t swaps = 0;
+};
+
+// one sorted run is fine while the boxes are spread along a line, but over a floor the boxes starting
+// inside any box's x extent are a whole strip of the world deep, and that strip gets longer as the world
+// grows. so the world is cut into bands along z and every band is swept on its own: a box is in every
+// band it reaches into, and a pair is only kept by the band its overlap starts in, so it comes out once.
+// the bands are also what the threads split between them
+class SweepAndPrune {
+    // a box's bounds as of this frame and which box it is, in last frame's order
+    struct Entry {
+        Aabb box;
+        uint32_t id;
+    };
+    struct Band {
+        std::vector<Entry> order;
+        std::vector<uint32_t> joining;
+        SweepBounds sorted;
+        std::vector<BoxPair> found, pairs;
+        size_t swaps = 0;
+    };
+    // the first and last band a box was in last frame, first is -1 for a box that's new
+    struct BandRange {
+        int first = -1, last = -1;
+    };
+    std::vector<Band> bands;
+    std::vector<BandRange> ranges;
+    std::vector<BoxPair> pairs;
+    SweepKernels kernels;
+    float origin, bandsPerUnit;
+
+    int bandOf(float z) const {
+        float band = (z - origin) * bandsPerUnit;
+        // truncating is flooring for anything above 0
+        return band > 0.f ? std::min(int(band), int(bands.size()) - 1) : 0;
+    }
+
+    void sortBand(Band &band, const std::vector<Aabb> &boxes, int index) {
+        // boxes that left the band (or the scene) go, the rest get this frame's bounds, new ones join at the end
+        size_t kept = 0;
+        for (const Entry &e : band.order) {
+            if (e.id < boxes.size() && ranges[e.id].first <= index && index <= ranges[e.id].last)
+                band.order[kept++] = {boxes[e.id], e.id};
+        }
+        band.order.resize(kept);
+        for (uint32_t id : band.joining)
+            band.order.push_back({boxes[id], id});
+
+        // a few new boxes are cheap to sort in, a lot of them (like on the first frame) are not
+        band.swaps = 0;
+        if (fullSort || band.joining.size() > band.order.size() / 16) {
+            std::sort(band.order.begin(), band.order.end(), [](const Entry &a, const Entry &b) { return a.box.min.x < b.box.min.x; });
+        } else {
+            for (size_t i = 1; i < band.order.size(); ++i) {
+                Entry e = band.order[i];
+                size_t j = i;
+                for (; j > 0 && band.order[j - 1].box.min.x > e.box.min.x; --j)
+                    band.order[j] = band.order[j - 1];
+                band.order[j] = e;
+                band.swaps += i - j;
+            }
+        }
+        band.joining.clear();
+    }
+public:
+    // sort from scratch every frame instead of fixing last frame's order, to see what coherence buys
+    bool fullSort = false;
+
+    // bands of bandWidth across the world's z, boxes outside of it count as in the first or last band
+    SweepAndPrune(SweepKernels kernels, const Aabb &world, float bandWidth = 8.f)
+        : kernels(std::move(kernels)), origin(world.min.z), bandsPerUnit(1.f / bandWidth) {
+        bands.resize(std::max(1, int(std::ceil((world.max.z - world.min.z) / bandWidth))));
+    }
+
+    const char *kernelName() const {
+        return kernels.name.c_str();
+    }
+    size_t bandCount() const {
+        return bands.size();
+    }
+
+    const std::vector<BoxPair> &update(const std::vector<Aabb> &boxes, WorkerPool &pool, BroadphaseTimings &timings) {
+        auto now = [] { return std::chrono::steady_clock::now(); };
+        auto ms = [](auto from, auto to) { return std::chrono::duration<double, std::milli>(to - from).count(); };
+        auto start = now();
+
+        // only the boxes that crossed into a band they weren't in are written down, leaving is noticed by the band
+        ranges.resize(boxes.size());
+        for (size_t id = 0; id < boxes.size(); ++id) {
+            BandRange reach = {bandOf(boxes[id].min.z), bandOf(boxes[id].max.z)};
+            BandRange &was = ranges[id];
+            if (reach.first == was.first && reach.last == was.last)
+                continue;
+            for (int band = reach.first; band <= reach.last; ++band)
+                if (band < was.first || band > was.last)
+                    bands[band].joining.push_back(uint32_t(id));
+            was = reach;
+        }
+        pool.parallelFor(bands.size(), 4, [&](size_t begin, size_t end) {
+            for (size_t band = begin; band < end; ++band)
+                sortBand(bands[band], boxes, int(band));
+        });
+        auto sortDone = now();
+
+        // laid out for the sweep and swept straight away, while the band is still in the cache
+        pool.parallelFor(bands.size(), 4, [&](size_t begin, size_t end) {
+            for (size_t index = begin; index < end; ++index) {
+                Band &band = bands[index];
+                SweepBounds &sorted = band.sorted;
+                sorted.resize(band.order.size());
+                for (size_t i = 0; i < band.order.size(); ++i) {
+                    const Entry &e = band.order[i];
+                    sorted.minX[i] = e.box.min.x, sorted.maxX[i] = e.box.max.x;
+                    sorted.minY[i] = e.box.min.y, sorted.maxY[i] = e.box.max.y;
+                    sorted.minZ[i] = e.box.min.z, sorted.maxZ[i] = e.box.max.z;
+                    sorted.ids[i] = e.id;
+                }
+                band.found.clear();
+                kernels.sweep(sorted, 0, sorted.size(), band.found);
+                // both boxes reach into the band their overlap starts in, that one keeps the pair
+                band.pairs.clear();
+                for (const BoxPair &found : band.found)
+                    if (bandOf(std::max(sorted.minZ[found.a], sorted.minZ[found.b])) == int(index))
+                        band.pairs.push_back(makePair(sorted.ids[found.a], sorted.ids[found.b]));
+            }
+        });
+        pairs.clear();
+        for (const Band &band : bands)
+            pairs.insert(pairs.end(), band.pairs.begin(), band.pairs.end());
+        auto sweepDone = now();
+
+        timings.sort += ms(start, sortDone);
+        timings.sweep += ms(sortDone, sweepDone);
+        for (const Band &band : bands)
+            timings.swaps += band.swaps;
+        return pairs;
+    }
+};
+
+// every pair tested against every other, only for checking the sweep
+std::vector<BoxPair> bruteForcePairs(const std::vector<Aabb> &boxes) {
+    std::vector<BoxPair> pairs;
+    for (size_t i = 0; i < boxes.size(); ++i)
+        for (size_t j = i + 1; j < boxes.size(); ++j)
+            if (overlaps(boxes[i], boxes[j]))
+                pairs.push_back(makePair(uint32_t(i), uint32_t(j)));
+    return pairs;
+}
+
+
+// ---------------------------------------------------------------------------------------------------------
+// the scene: boxes drifting over a flat world and bouncing off its edges. box 0 is the camera's, it doesn't
+// drift, it's put wherever the camera is before the broadphase runs. its id is the smallest, so in every
+// pair it's in, it's a
+// ---------------------------------------------------------------------------------------------------------
+
+const uint32_t CAMERA_BOX = 0;
+const float CAMERA_RADIUS = 0.4f;
+
+struct MovingBoxes {
+    std::vector<Aabb> boxes;
+    std::vector<glm::vec3> velocities;
+    Aabb world;
+
+    void move(float dt, WorkerPool &pool) {
+        pool.parallelFor(boxes.size(), 8192, [&](size_t begin, size_t end) {
+            for (size_t i = std::max<size_t>(begin, CAMERA_BOX + 1); i < end; ++i) {
+                Aabb &box = boxes[i];
+                glm::vec3 &v = velocities[i];
+                glm::vec3 step = v * dt;
+                box.min += step;
+                box.max += step;
+                // bounce: flip the velocity and put it back inside
+                for (int axis = 0; axis < 3; ++axis) {
+                    if (box.min[axis] < world.min[axis]) {
+                        float back = world.min[axis] - box.min[axis];
+                        box.min[axis] += back, box.max[axis] += back;
+                        v[axis] = std::fabs(v[axis]);
+                    } else if (box.max[axis] > world.max[axis]) {
+                        float back = box.max[axis] - world.max[axis];
+                        box.min[axis] -= back, box.max[axis] -= back;
+                        v[axis] = -std::fabs(v[axis]);
+                    }
+                }
+            }
+        });
+    }
+
+    void placeCamera(const glm::vec3 &position) {
+        boxes[CAMERA_BOX] = {position - glm::vec3(CAMERA_RADIUS), position + glm::vec3(CAMERA_RADIUS)};
+    }
+};
+
+// the world grows with the count so there are about as many boxes around any one box at any size
+MovingBoxes scatterBoxes(size_t count, uint32_t seed) {
+    MovingBoxes scene;
+    const float half = 1.6f * std::sqrt(float(count));
+    scene.world = {glm::vec3(-half, 0.f, -half), glm::vec3(half, 6.f, half)};
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<float> unit(0.f, 1.f);
+    scene.boxes.resize(count + 1);
+    scene.velocities.resize(count + 1, glm::vec3(0.f));
+    scene.placeCamera(glm::vec3(0.f, 1.5f, 0.f));
+    for (size_t i = CAMERA_BOX + 1; i < scene.boxes.size(); ++i) {
+        glm::vec3 size(0.5f + 1.5f * unit(rng), 0.5f + 1.5f * unit(rng), 0.5f + 1.5f * unit(rng));
+        glm::vec3 min(-half + (2.f * half - size.x) * unit(rng), (6.f - size.y) * unit(rng), -half + (2.f * half - size.z) * unit(rng));
+        scene.boxes[i] = {min, min + size};
+        float angle = unit(rng) * 2.f * glm::pi<float>(), speed = 3.f * unit(rng);
+        scene.velocities[i] = glm::vec3(std::cos(angle) * speed, unit(rng) - 0.5f, std::sin(angle) * speed);
+    }
+    return scene;
+}
+
+
+// ---------------------------------------------------------------------------------------------------------
+// narrowphase for the camera, a sphere against each box the broadphase says it might touch. the sphere is
+// pushed out the shortest way, one box after the other, which is plenty for a camera
+// ---------------------------------------------------------------------------------------------------------
+
+bool pushSphereOut(glm::vec3 &center, float radius, const Aabb &box) {
+    glm::vec3 closest = glm::clamp(center, box.min, box.max);
+    glm::vec3 away = center - closest;
+    float distance2 = glm::dot(away, away);
+    if (distance2 > radius * radius)
+        return false;
+    if (distance2 > 1e-12f) {
+        float distance = std::sqrt(distance2);
+        center += away * ((radius - distance) / distance);
+        return true;
+    }
+    // the center is inside the box, out through the closest face
+    glm::vec3 toMin = center - box.min, toMax = box.max - center;
+    int axis = 0;
+    bool towardsMin = true;
+    float nearest = toMin.x;
+    for (int a = 0; a < 3; ++a) {
+        if (toMin[a] < nearest)
+            nearest = toMin[a], axis = a, towardsMin = true;
+        if (toMax[a] < nearest)
+            nearest = toMax[a], axis = a, towardsMin = false;
+    }
+    center[axis] = towardsMin ? box.min[axis] - radius : box.max[axis] + radius;
+    return true;
+}
+
+// returns how many boxes the camera was pushed out of
+int collideCamera(glm::vec3 &cameraPos, const std::vector<BoxPair> &pairs, const std::vector<Aabb> &boxes) {
+    int contacts = 0;
+    for (const BoxPair &pair : pairs)
+        if (pair.a == CAMERA_BOX && pushSphereOut(cameraPos, CAMERA_RADIUS, boxes[pair.b]))
+            ++contacts;
+    return contacts;
+}
+
+
+// --bench: checks the sweep against every pair tested on a smaller scene while it moves, then times the
+// broadphase on the full count: one band against many, insertion sort against sorting from scratch and
+// AVX2 against scalar
+int runBench(size_t count, int frames) {
+    const float dt = 1.f / 60.f;
+    const SweepKernels simd = bestSweepKernels();
+    auto now = [] { return std::chrono::steady_clock::now(); };
+    auto ms = [](auto from, auto to) { return std::chrono::duration<double, std::milli>(to - from).count(); };
+    // wide enough that the whole world is a single band
+    const float ONE_BAND = 1e9f;
+
+    {
+        const size_t checkCount = std::min<size_t>(count, 10000);
+        WorkerPool pool;
+        MovingBoxes scene = scatterBoxes(checkCount, 7);
+        SweepAndPrune checked[] = {
+            SweepAndPrune(SweepKernels(), scene.world, ONE_BAND), SweepAndPrune(simd, scene.world, ONE_BAND),
+            SweepAndPrune(SweepKernels(), scene.world), SweepAndPrune(simd, scene.world)
+        };
+        BroadphaseTimings unused;
+        for (int frame = 0; frame <= 120; ++frame) {
+            std::vector<std::vector<BoxPair>> found;
+            for (SweepAndPrune &sap : checked)
+                found.push_back(sap.update(scene.boxes, pool, unused));
+            if (frame % 30 == 0) {
+                auto start = now();
+                std::vector<BoxPair> expected = bruteForcePairs(scene.boxes);
+                double bruteMs = ms(start, now());
+                bool same = true;
+                for (std::vector<BoxPair> &pairs : found) {
+                    std::sort(pairs.begin(), pairs.end());
+                    same = same && pairs == expected;
+                }
+                std::printf("frame %3d, %zu boxes: %zu pairs from brute force in %.1f ms, the sweeps %s\n",
+                            frame, checkCount, expected.size(), bruteMs, same ? "agree" : "don't agree");
+                if (!same) {
+                    std::cerr << "ERROR::BROADPHASE - the sweep and brute force found different pairs\n";
+                    return EXIT_FAILURE;
+                }
+            }
+            scene.move(dt, pool);
+        }
+    }
+
+    struct Run {
+        const char *label;
+        bool simd, fullSort, banded;
+        unsigned threads;
+    };
+    const unsigned all = std::max(1u, std::thread::hardware_concurrency());
+    std::vector<Run> runs = {
+        {"one band, insertion, 1 thread", true, false, false, 1},
+        {"bands,    insertion, 1 thread", false, false, true, 1},
+        {"bands,    insertion, 1 thread", true, false, true, 1},
+        {"bands,    std::sort, 1 thread", true, true, true, 1}
+    };
+    if (all > 1)
+        runs.insert(runs.end(), {{"bands,    insertion, all threads", false, false, true, all}, {"bands,    insertion, all threads", true, false, true, all}});
+    for (const Run &run : runs) {
+        WorkerPool pool(run.threads);
+        MovingBoxes scene = scatterBoxes(count, 7);
+        SweepAndPrune sap(run.simd ? simd : SweepKernels(), scene.world, run.banded ? 8.f : ONE_BAND);
+        sap.fullSort = run.fullSort;
+        BroadphaseTimings warmup, total;
+        // the first frame sorts from scratch whatever the mode, keep it out of the numbers
+        sap.update(scene.boxes, pool, warmup);
+        size_t pairs = 0;
+        double moveMs = 0.;
+        for (int frame = 0; frame < frames; ++frame) {
+            auto start = now();
+            scene.move(dt, pool);
+            moveMs += ms(start, now());
+            pairs += sap.update(scene.boxes, pool, total).size();
+        }
+        std::printf("%-32s %-6s %3zu bands: %zu boxes, %zu pairs, %6zu swaps, move %6.3f ms, sort %6.3f ms, sweep %7.3f ms, %7.3f ms for the broadphase\n",
+                    run.label, sap.kernelName(), sap.bandCount(), count, pairs / frames, total.swaps / frames, moveMs / frames,
+                    total.sort / frames, total.sweep / frames, (total.sort + total.sweep) / frames);
+    }
+    return EXIT_SUCCESS;
+}
+
+
+void processInput(GLFWwindow *window, glm::vec3 &cameraPos, glm::vec3 &cameraFront, glm::vec3 &cameraUp)
+{
+
+    const float cameraSpeed = 0.05f; // adjust accordingly
+    if (glfwGetKey(window, GLFW_KEY_W) == GLFW_PRESS)
+        cameraPos += cameraSpeed * cameraFront;
+    if (glfwGetKey(window, GLFW_KEY_S) == GLFW_PRESS)
+        cameraPos -= cameraSpeed * cameraFront;
+    if (glfwGetKey(window, GLFW_KEY_A) == GLFW_PRESS)
+        cameraPos -= glm::normalize(glm::cross(cameraFront, cameraUp)) * cameraSpeed;
+    if (glfwGetKey(window, GLFW_KEY_D) == GLFW_PRESS)
+        cameraPos += glm::normalize(glm::cross(cameraFront, cameraUp)) * cameraSpeed;
+    if (glfwGetKey(window, GLFW_KEY_UP) == GLFW_PRESS)
+        cameraPos += glm::normalize(glm::cross(cameraFront, cameraUp)) * cameraSpeed;
+
+}
+
+// true only on the frame the key went down
+bool keyPressed(GLFWwindow *window, int key) {
+    static bool down[GLFW_KEY_LAST + 1] = {};
+    bool now = glfwGetKey(window, key) == GLFW_PRESS;
+    bool pressed = now && !down[key];
+    down[key] = now;
+    return pressed;
+}
+
+
+float yaw = -90.f;
+float pitch = 0.f;
+glm::vec3 cameraFront;
+
+void mouseMovement(GLFWwindow *window, double xPos, double yPos) {
+    static float lastX = xPos, lastY = yPos;
+    float xOffset = xPos - lastX;
+    float yOffset = lastY - yPos;
+    
+    constexpr float sensitivity = 0.05f;
+    xOffset *= sensitivity;
+    yOffset *= sensitivity;
+
+    yaw += xOffset;
+    pitch += yOffset;
+
+    if (std::abs(pitch) > 89.f) // don't ever do it this way. I am lazy
+        pitch = std::abs(pitch) / pitch * 89.f;
+
+    cameraFront.x = cos(glm::radians(yaw)) * cos(glm::radians(pitch));
+    cameraFront.y = sin(glm::radians(pitch));
+    cameraFront.z = sin(glm::radians(yaw)) * cos(glm::radians(pitch));
+
+    cameraFront = glm::normalize(cameraFront);
+    lastX = xPos, lastY = yPos;
+}
+
+
+int main(int argc, char **argv) {
+    size_t count = 100000;
+    bool scalar = false;
+    for (int i = 1; i < argc; ++i) {
+        if (!std::strcmp(argv[i], "--bench"))
+            return runBench(i + 1 < argc ? size_t(std::max(1, std::atoi(argv[i + 1]))) : count, 300);
+        if (!std::strcmp(argv[i], "--boxes") && i + 1 < argc)
+            count = size_t(std::max(1, std::atoi(argv[++i])));
+        else if (!std::strcmp(argv[i], "--scalar"))
+            scalar = true;
+    }
+
+    if (glfwInit() != GLFW_TRUE) {
+        glfwTerminate();
+        std::cerr << "Failed to initialize GLFW";
+        return EXIT_FAILURE;
+    }
+    // setting OpenGL version to 3.3
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+    GLFWwindow *win = glfwCreateWindow(800, 600, "This is a hello window!", NULL, NULL);
+    // setting 'context' for OpenGL, i.e. where to draw on current thread
+    glfwMakeContextCurrent(win);
+    // all it does is fetches us the implemented functions of OpenGL
+    if (glewInit() != GLEW_OK) {
+        glfwTerminate();
+        std::cerr << "Failed to initialize GLEW\n";
+        return EXIT_FAILURE;
+    }
+    int screenWidth, screenHeight;
+    glfwGetFramebufferSize(win, &screenWidth, &screenHeight);
+    glViewport(0, 0, screenWidth, screenHeight);
+
+    glEnable(GL_DEPTH_TEST);
+    float triangle_data[] = {
+        //   vertpos   //  //   normal   //  //texcord//
+    -0.5f, -0.5f, -0.5f,  0.0f,  0.0f, -1.0f,  0.0f, 0.0f,
+     0.5f, -0.5f, -0.5f,  0.0f,  0.0f, -1.0f,  1.0f, 0.0f,
+     0.5f,  0.5f, -0.5f,  0.0f,  0.0f, -1.0f,  1.0f, 1.0f,
+     0.5f,  0.5f, -0.5f,  0.0f,  0.0f, -1.0f,  1.0f, 1.0f,
+    -0.5f,  0.5f, -0.5f,  0.0f,  0.0f, -1.0f,  0.0f, 1.0f,
+    -0.5f, -0.5f, -0.5f,  0.0f,  0.0f, -1.0f,  0.0f, 0.0f,
+
+    -0.5f, -0.5f,  0.5f,  0.0f,  0.0f,  1.0f,  0.0f, 0.0f,
+     0.5f, -0.5f,  0.5f,  0.0f,  0.0f,  1.0f,  1.0f, 0.0f,
+     0.5f,  0.5f,  0.5f,  0.0f,  0.0f,  1.0f,  1.0f, 1.0f,
+     0.5f,  0.5f,  0.5f,  0.0f,  0.0f,  1.0f,  1.0f, 1.0f,
+    -0.5f,  0.5f,  0.5f,  0.0f,  0.0f,  1.0f,  0.0f, 1.0f,
+    -0.5f, -0.5f,  0.5f,  0.0f,  0.0f,  1.0f,  0.0f, 0.0f,
+
+    -0.5f,  0.5f,  0.5f, -1.0f,  0.0f,  0.0f,  1.0f, 0.0f,
+    -0.5f,  0.5f, -0.5f, -1.0f,  0.0f,  0.0f,  1.0f, 1.0f,
+    -0.5f, -0.5f, -0.5f, -1.0f,  0.0f,  0.0f,  0.0f, 1.0f,
+    -0.5f, -0.5f, -0.5f, -1.0f,  0.0f,  0.0f,  0.0f, 1.0f,
+    -0.5f, -0.5f,  0.5f, -1.0f,  0.0f,  0.0f,  0.0f, 0.0f,
+    -0.5f,  0.5f,  0.5f, -1.0f,  0.0f,  0.0f,  1.0f, 0.0f,
+
+     0.5f,  0.5f,  0.5f,  1.0f,  0.0f,  0.0f,  1.0f, 0.0f,
+     0.5f,  0.5f, -0.5f,  1.0f,  0.0f,  0.0f,  1.0f, 1.0f,
+     0.5f, -0.5f, -0.5f,  1.0f,  0.0f,  0.0f,  0.0f, 1.0f,
+     0.5f, -0.5f, -0.5f,  1.0f,  0.0f,  0.0f,  0.0f, 1.0f,
+     0.5f, -0.5f,  0.5f,  1.0f,  0.0f,  0.0f,  0.0f, 0.0f,
+     0.5f,  0.5f,  0.5f,  1.0f,  0.0f,  0.0f,  1.0f, 0.0f,
+
+    -0.5f, -0.5f, -0.5f,  0.0f, -1.0f,  0.0f,  0.0f, 1.0f,
+     0.5f, -0.5f, -0.5f,  0.0f, -1.0f,  0.0f,  1.0f, 1.0f,
+     0.5f, -0.5f,  0.5f,  0.0f, -1.0f,  0.0f,  1.0f, 0.0f,
+     0.5f, -0.5f,  0.5f,  0.0f, -1.0f,  0.0f,  1.0f, 0.0f,
+    -0.5f, -0.5f,  0.5f,  0.0f, -1.0f,  0.0f,  0.0f, 0.0f,
+    -0.5f, -0.5f, -0.5f,  0.0f, -1.0f,  0.0f,  0.0f, 1.0f,
+
+    -0.5f,  0.5f, -0.5f,  0.0f,  1.0f,  0.0f,  0.0f, 1.0f,
+     0.5f,  0.5f, -0.5f,  0.0f,  1.0f,  0.0f,  1.0f, 1.0f,
+     0.5f,  0.5f,  0.5f,  0.0f,  1.0f,  0.0f,  1.0f, 0.0f,
+     0.5f,  0.5f,  0.5f,  0.0f,  1.0f,  0.0f,  1.0f, 0.0f,
+    -0.5f,  0.5f,  0.5f,  0.0f,  1.0f,  0.0f,  0.0f, 0.0f,
+    -0.5f,  0.5f, -0.5f,  0.0f,  1.0f,  0.0f,  0.0f, 1.0f
+        
+    };
+
+
+    glm::vec3 cameraPos(0.f, 0.f, 3.f);
+    cameraFront = glm::vec3(0.f,0.f,-1.f);
+    glm::vec3 cameraUp(0.,1.,0.f);
+    
+
+    Texture2D tex;
+    tex.generate2DTex("./image2d.tex");
+    tex.bind();
+
+    WorkerPool pool;
+    MovingBoxes scene = scatterBoxes(count, 7);
+    SweepAndPrune sap(scalar ? SweepKernels() : bestSweepKernels(), scene.world);
+    std::cout << count << " boxes in " << sap.bandCount() << " bands, " << sap.kernelName() << " sweep on " << pool.size() << " threads\n";
+
+    GLuint vbo = 0;
+    glGenBuffers(1, &vbo); 
+    glBindBuffer(GL_ARRAY_BUFFER, vbo);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(triangle_data), triangle_data, GL_STATIC_DRAW);
+
+    GLuint vao = 0;
+    glGenVertexArrays(1, &vao);
+    glBindVertexArray(vao);
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)0);
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)(6 * sizeof(float)));
+    glEnableVertexAttribArray(1);
+    glVertexAttribPointer(2, 3, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)(3 * sizeof(float)));
+    glEnableVertexAttribArray(2);
+
+    // a cube instance per box, stretched to its bounds, lit up when the broadphase put it in a pair
+    struct BoxInstance {
+        glm::vec3 center;
+        glm::vec3 halfSize;
+        float touching;
+    };
+    const size_t drawn = scene.boxes.size() - (CAMERA_BOX + 1);
+    std::vector<BoxInstance> instances(drawn);
+    std::vector<uint8_t> touching(scene.boxes.size());
+    GLuint instanceVbo = 0;
+    glGenBuffers(1, &instanceVbo);
+    glBindBuffer(GL_ARRAY_BUFFER, instanceVbo);
+    glBufferData(GL_ARRAY_BUFFER, drawn * sizeof(BoxInstance), NULL, GL_STREAM_DRAW);
+    glVertexAttribPointer(3, 3, GL_FLOAT, GL_FALSE, sizeof(BoxInstance), (void*)offsetof(BoxInstance, center));
+    glEnableVertexAttribArray(3);
+    glVertexAttribDivisor(3, 1);
+    glVertexAttribPointer(4, 3, GL_FLOAT, GL_FALSE, sizeof(BoxInstance), (void*)offsetof(BoxInstance, halfSize));
+    glEnableVertexAttribArray(4);
+    glVertexAttribDivisor(4, 1);
+    glVertexAttribPointer(5, 1, GL_FLOAT, GL_FALSE, sizeof(BoxInstance), (void*)offsetof(BoxInstance, touching));
+    glEnableVertexAttribArray(5);
+    glVertexAttribDivisor(5, 1);
+
+    VertexShader vs;
+    FragmentShader fs;
+    vs.setSource("./vertex.glsl");
+    fs.setSource("./frag.glsl");
+    Program prog;
+    prog.AttachShaders({&vs, &fs});
+
+    prog.UseProgram();
+    prog.setInt("tex", 0);
+
+    cameraPos = glm::vec3(0.f, 1.5f, 0.f);
+
+    glfwSetCursorPosCallback(win, mouseMovement); 
+    glfwSetInputMode(win, GLFW_CURSOR, GLFW_CURSOR_DISABLED);  
+
+    std::cout << "G: fly through the boxes (camera collision off)\n";
+    bool ghost = false;
+    double lastFrame = glfwGetTime(), lastReport = lastFrame;
+    BroadphaseTimings total;
+    double moveMs = 0., uploadMs = 0.;
+    size_t frames = 0, pairCount = 0, contacts = 0;
+    
+    while (!glfwWindowShouldClose(win)) {
+        double now = glfwGetTime();
+        // a long frame shouldn't send boxes flying through each other
+        float dt = float(std::min(now - lastFrame, 1. / 20.));
+        lastFrame = now;
+        processInput(win, cameraPos, cameraFront, cameraUp);
+        if (keyPressed(win, GLFW_KEY_G))
+            ghost = !ghost;
+
+        auto moveStart = std::chrono::steady_clock::now();
+        scene.placeCamera(cameraPos);
+        scene.move(dt, pool);
+        moveMs += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - moveStart).count();
+        const std::vector<BoxPair> &pairs = sap.update(scene.boxes, pool, total);
+        pairCount += pairs.size();
+        if (!ghost)
+            contacts += collideCamera(cameraPos, pairs, scene.boxes);
+
+        auto uploadStart = std::chrono::steady_clock::now();
+        std::fill(touching.begin(), touching.end(), 0);
+        for (const BoxPair &pair : pairs)
+            touching[pair.a] = touching[pair.b] = 1;
+        pool.parallelFor(drawn, 8192, [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) {
+                const Aabb &box = scene.boxes[CAMERA_BOX + 1 + i];
+                instances[i] = {(box.min + box.max) * 0.5f, (box.max - box.min) * 0.5f, float(touching[CAMERA_BOX + 1 + i])};
+            }
+        });
+        glBindBuffer(GL_ARRAY_BUFFER, instanceVbo);
+        // orphaned, so the driver doesn't wait for last frame's draw to be done with it
+        glBufferData(GL_ARRAY_BUFFER, drawn * sizeof(BoxInstance), NULL, GL_STREAM_DRAW);
+        glBufferSubData(GL_ARRAY_BUFFER, 0, drawn * sizeof(BoxInstance), instances.data());
+        uploadMs += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - uploadStart).count();
+
+        glm::mat4 view = glm::lookAt(cameraPos, cameraPos + cameraFront, cameraUp);
+        glfwGetFramebufferSize(win, &screenWidth, &screenHeight);
+        glm::mat4 proj = glm::perspective(glm::radians(45.f), screenHeight > 0 ? float(screenWidth) / screenHeight : 1.f, 0.1f, 300.f);
+
+        prog.UseProgram();
+        prog.setMat4("view", view);
+        prog.setMat4("proj", proj);
+        glViewport(0, 0, screenWidth, screenHeight);
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+        glBindVertexArray(vao);
+        tex.bind();
+        glDrawArraysInstanced(GL_TRIANGLES, 0, 36, GLsizei(drawn));
+
+        // polls different kinds of events, for example, when we close an application, it fetches that event
+        // or it fetches events like movement of the window.
+        // Without it you can neither move the window or close the window
+        glfwPollEvents();
+        // have you drawn the image, it is stored in the buffer. You can now swap this buffer with main buffer
+        // so the image appears
+        glfwSwapBuffers(win);
+
+        ++frames;
+        if (now - lastReport > 1.) {
+            lastReport = now;
+            std::printf("%zu boxes, %zu pairs, %zu swaps, %zu camera contacts: move %.3fms, sort %.3fms, sweep %.3fms, upload %.3fms\n",
+                        drawn, pairCount / frames, total.swaps / frames, contacts, moveMs / frames, total.sort / frames,
+                        total.sweep / frames, uploadMs / frames);
+            total = BroadphaseTimings();
+            moveMs = uploadMs = 0.;
+            frames = pairCount = contacts = 0;
+        }
+    }
+    glDeleteBuffers(1, &instanceVbo);
+    glDeleteBuffers(1, &vbo);
+    glDeleteVertexArrays(1, &vao);
+    glfwTerminate();
+    
+    std::cout << "Window should close now!\n";
+
+    return EXIT_SUCCESS;
+
+}
@@ -0,0 +1,25 @@
+#version 330 core
+
+layout(location = 0) in vec3 aPos;
+layout(location = 1) in vec2 aTexCoord;
+layout(location = 2) in vec3 aNormal;
+// the unit cube is stretched over each box's bounds
+layout(location = 3) in vec3 aCenter;
+layout(location = 4) in vec3 aHalfSize;
+// 1 when the broadphase put the box in a pair this frame
+layout(location = 5) in float aTouching;
+
+out vec2 texCoord;
+out vec3 normal;
+out float touching;
+
+uniform mat4 proj;
+uniform mat4 view;
+
+
+void main() {
+    gl_Position = proj * view * vec4(aCenter + aPos * 2.0 * aHalfSize, 1.0);
+    texCoord = aTexCoord;
+    normal = aNormal;
+    touching = aTouching;
+}
@@ -0,0 +1,1094 @@
+#include <GL/glew.h>
+
+#include <GLFW/glfw3.h>
+#include <algorithm>
+#include <atomic>
+#include <cfloat>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <immintrin.h>
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+#include <glm/ext/matrix_clip_space.hpp>
+#include <glm/ext/matrix_transform.hpp>
+#include <glm/geometric.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/ext/matrix_float4x4.hpp>
+#include <glm/gtc/type_ptr.hpp>
+#include <glm/glm.hpp>
+#include <glm/trigonometric.hpp>
+#define STB_IMAGE_IMPLEMENTATION
+#include <stb/stb_image.h>
+#include <iostream>
+
+class Shader {
+    std::string src; 
+protected:
+    const char *getsrc() {
+        return src.data();
+    }
+    GLuint shader_id = 0;
+    bool isCompiled = false;
+protected:
+    virtual const char *getClassName() = 0;
+    GLint getCompilationStatus(GLuint shader_id) {
+        int status;
+        glGetShaderiv(shader_id, GL_COMPILE_STATUS, &status);
+        return status;
+    }
+    void sendError() {
+        char buffer[1024];
+        glGetShaderInfoLog(shader_id, 1024, NULL, buffer);
+        std::cerr << "ERROR::" << getClassName() << " - " << buffer;
+    }
+public:
+    virtual void compile() = 0;
+    void setSource(const char *s) {
+        std::ifstream sourceFile(s);
+        if (!sourceFile.is_open())
+            return;
+        char buffer[8192];
+        while (sourceFile.read(buffer, 8192)) {
+            src.append(buffer, 8192);
+        }
+        if (!sourceFile.eof()) {
+            src.clear();
+            return;
+        }
+        src.append(buffer, sourceFile.gcount());
+    }
+    friend class Program;
+};
+
+
+class VertexShader : public Shader {
+    virtual const char *getClassName() override {
+        return "VertexShader";
+    }
+public:
+    virtual void compile() override {
+        if (shader_id)
+            glDeleteShader(shader_id);
+        shader_id = glCreateShader(GL_VERTEX_SHADER);
+        const char *src = getsrc();
+        glShaderSource(shader_id, 1, &src, NULL);
+        glCompileShader(shader_id);
+        if (!getCompilationStatus(shader_id)) {
+            sendError();
+        }
+        isCompiled = true;
+    }
+};
+
+class FragmentShader : public Shader {
+    const char *getClassName() override {
+        return "FragmentShader";
+    }
+public:
+    virtual void compile() override {
+        if (shader_id)
+            glDeleteShader(shader_id);
+        shader_id = glCreateShader(GL_FRAGMENT_SHADER);
+        const char *src = getsrc();
+        glShaderSource(shader_id, 1, &src, NULL);
+        glCompileShader(shader_id);
+        if (!getCompilationStatus(shader_id)) {
+            sendError();
+        }
+        isCompiled = true;
+    }
+};
+
+
+class Program {
+    GLuint program_id = 0;
+    void sendError() {
+        char buffer[1024];
+        glGetProgramInfoLog(program_id, 1024, NULL, buffer);
+        std::cerr << "ERROR::PROGRAM: " << " - " << buffer;
+    }
+    bool linkStatus() {
+        int status = 0;
+        glGetProgramiv(program_id, GL_LINK_STATUS, &status);
+        return status;
+    }
+public:
+    Program() {
+        program_id = glCreateProgram();
+    }
+    ~Program() {
+        glDeleteProgram(program_id);
+    }
+    void AttachShaders(std::initializer_list<Shader*> shaders) {
+        auto i = shaders.begin();
+        while (i != shaders.end()) {
+            if (!(*i)->isCompiled)
+                (*i)->compile();
+            glAttachShader(program_id, (*i)->shader_id);
+            ++i;
+        }
+        glLinkProgram(program_id);
+        if (!linkStatus()) {
+            sendError();
+        }
+    }
+    void UseProgram() {
+        glUseProgram(program_id);
+    }
+    void setMat4(const char *locName, const glm::mat4 &mat) {
+        int location = glGetUniformLocation(program_id, locName);
+        if (location == -1)
+            return;
+        glUniformMatrix4fv(location, 1, GL_FALSE, glm::value_ptr(mat));
+    }
+    void setInt(const char *locName, int value) {
+        int location = glGetUniformLocation(program_id, locName);
+        if (location == -1)
+            return;
+        glUniform1i(location, value);
+    }
+    void setFloat(const char *locName, float value) {
+        int location = glGetUniformLocation(program_id, locName);
+        if (location == -1)
+            return;
+        glUniform1f(location, value);
+    }
+    void setVec3(const char *locName, const glm::vec3 &vec) {
+        int location = glGetUniformLocation(program_id, locName);
+        if (location == -1)
+            return;
+        glUniform3f(location, vec.x, vec.y, vec.z);
+    }
+    void setVec4(const char *locName, const glm::vec4 &vec) {
+        int location = glGetUniformLocation(program_id, locName);
+        if (location == -1)
+            return;
+        glUniform4f(location, vec.x, vec.y, vec.z, vec.w);
+    }
+};
+
+
+
+
+// ---------------------------------------------------------------------------------------------------------
+// block compression on the CPU. every 4x4 block of pixels becomes 8 bytes (BC1) or 16 bytes (BC3, BC7),
+// against 48 or 64 uncompressed. the GPU samples them like that, so it's also 4 to 8 times less memory and
+// bandwidth. an encoder tries endpoint pairs for the colors of a block and keeps the one whose palette is
+// closest to the pixels. measuring that is the expensive part and it's what the SIMD is for
+// ---------------------------------------------------------------------------------------------------------
+
+enum class BlockFormat { BC1, BC3, BC7 };
+
+const char *blockFormatName(BlockFormat format) {
+    return format == BlockFormat::BC1 ? "BC1" : format == BlockFormat::BC3 ? "BC3" : "BC7";
+}
+
+size_t blockBytes(BlockFormat format) {
+    return format == BlockFormat::BC1 ? 8 : 16;
+}
+
+// the nearest palette entry for every pixel of a block, lowest index on ties. returns the summed squared
+// error. pixels and palette are RGBA8, alpha only counts when withAlpha is set
+uint32_t bestIndicesScalar(const uint8_t *pixels, const uint8_t *palette, int paletteSize, bool withAlpha, uint8_t *indices) {
+    uint32_t total = 0;
+    const int channels = withAlpha ? 4 : 3;
+    for (int i = 0; i < 16; ++i) {
+        uint32_t best = UINT32_MAX;
+        for (int k = 0; k < paletteSize; ++k) {
+            uint32_t d = 0;
+            for (int c = 0; c < channels; ++c) {
+                int diff = int(pixels[i * 4 + c]) - int(palette[k * 4 + c]);
+                d += uint32_t(diff * diff);
+            }
+            if (d < best) {
+                best = d;
+                indices[i] = uint8_t(k);
+            }
+        }
+        total += best;
+    }
+    return total;
+}
+
+#if defined(__x86_64__) || defined(__i386__)
+#define BLOCK_ENCODER_X86 1
+// four pixels at a time against one palette entry: widen to 16 bits, subtract, and pmaddwd squares and sums
+// channel pairs, phaddd finishes each pixel's sum
+__attribute__((target("sse4.1")))
+uint32_t bestIndicesSse41(const uint8_t *pixels, const uint8_t *palette, int paletteSize, bool withAlpha, uint8_t *indices) {
+    const __m128i keep = withAlpha ? _mm_set1_epi32(-1) : _mm_set1_epi32(0x00ffffff);
+    const __m128i zero = _mm_setzero_si128();
+    __m128i lo[4], hi[4], best[4], index[4];
+    for (int g = 0; g < 4; ++g) {
+        __m128i px = _mm_and_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(pixels + g * 16)), keep);
+        lo[g] = _mm_unpacklo_epi8(px, zero);
+        hi[g] = _mm_unpackhi_epi8(px, zero);
+        best[g] = _mm_set1_epi32(INT32_MAX);
+        index[g] = zero;
+    }
+    for (int k = 0; k < paletteSize; ++k) {
+        uint32_t color;
+        std::memcpy(&color, palette + k * 4, 4);
+        __m128i entry = _mm_unpacklo_epi8(_mm_and_si128(_mm_set1_epi32(int(color)), keep), zero);
+        __m128i kk = _mm_set1_epi32(k);
+        for (int g = 0; g < 4; ++g) {
+            __m128i dl = _mm_sub_epi16(lo[g], entry), dh = _mm_sub_epi16(hi[g], entry);
+            __m128i d = _mm_hadd_epi32(_mm_madd_epi16(dl, dl), _mm_madd_epi16(dh, dh));
+            __m128i closer = _mm_cmplt_epi32(d, best[g]);
+            best[g] = _mm_min_epi32(d, best[g]);
+            index[g] = _mm_blendv_epi8(index[g], kk, closer);
+        }
+    }
+    __m128i sum = _mm_add_epi32(_mm_add_epi32(best[0], best[1]), _mm_add_epi32(best[2], best[3]));
+    sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(1, 0, 3, 2)));
+    sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(2, 3, 0, 1)));
+    // the indices are below 16, so they fit a byte each
+    __m128i packed = _mm_packus_epi16(_mm_packs_epi32(index[0], index[1]), _mm_packs_epi32(index[2], index[3]));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(indices), packed);
+    return uint32_t(_mm_cvtsi128_si32(sum));
+}
+#endif
+
+
+// the direction the colors of a block spread along the most, by power iteration on their covariance
+void principalAxis(const uint8_t *pixels, int channels, float mean[4], float axis[4]) {
+    for (int c = 0; c < 4; ++c)
+        mean[c] = axis[c] = 0.f;
+    for (int i = 0; i < 16; ++i)
+        for (int c = 0; c < channels; ++c)
+            mean[c] += pixels[i * 4 + c] / 16.f;
+    float cov[4][4] = {};
+    for (int i = 0; i < 16; ++i) {
+        float d[4] = {};
+        for (int c = 0; c < channels; ++c)
+            d[c] = pixels[i * 4 + c] - mean[c];
+        for (int a = 0; a < channels; ++a)
+            for (int b = 0; b < channels; ++b)
+                cov[a][b] += d[a] * d[b];
+    }
+    float v[4] = {1.f, 1.f, 1.f, 1.f};
+    for (int iteration = 0; iteration < 8; ++iteration) {
+        float next[4] = {}, length = 0.f;
+        for (int a = 0; a < channels; ++a) {
+            for (int b = 0; b < channels; ++b)
+                next[a] += cov[a][b] * v[b];
+            length = std::max(length, std::fabs(next[a]));
+        }
+        if (length < 1e-6f)
+            break;  // all one color
+        for (int a = 0; a < channels; ++a)
+            v[a] = next[a] / length;
+    }
+    float length = 0.f;
+    for (int c = 0; c < channels; ++c)
+        length += v[c] * v[c];
+    length = std::sqrt(length);
+    for (int c = 0; c < channels; ++c)
+        axis[c] = v[c] / length;
+}
+
+// the two ends of the block's colors along the axis
+void axisEndpoints(const uint8_t *pixels, int channels, float e0[4], float e1[4]) {
+    float mean[4], axis[4];
+    principalAxis(pixels, channels, mean, axis);
+    float tMin = FLT_MAX, tMax = -FLT_MAX;
+    for (int i = 0; i < 16; ++i) {
+        float t = 0.f;
+        for (int c = 0; c < channels; ++c)
+            t += (pixels[i * 4 + c] - mean[c]) * axis[c];
+        tMin = std::min(tMin, t);
+        tMax = std::max(tMax, t);
+    }
+    for (int c = 0; c < 4; ++c) {
+        e0[c] = std::min(std::max(mean[c] + axis[c] * tMin, 0.f), 255.f);
+        e1[c] = std::min(std::max(mean[c] + axis[c] * tMax, 0.f), 255.f);
+    }
+}
+
+// the endpoints that best fit given indices, by least squares. weights[i] is how far towards e1 index i is
+bool fitEndpoints(const uint8_t *pixels, const uint8_t *indices, const float *weights, int channels, float e0[4], float e1[4]) {
+    float aa = 0.f, bb = 0.f, ab = 0.f, ax[4] = {}, bx[4] = {};
+    for (int i = 0; i < 16; ++i) {
+        float w = weights[indices[i]];
+        aa += (1.f - w) * (1.f - w);
+        bb += w * w;
+        ab += (1.f - w) * w;
+        for (int c = 0; c < channels; ++c) {
+            ax[c] += (1.f - w) * pixels[i * 4 + c];
+            bx[c] += w * pixels[i * 4 + c];
+        }
+    }
+    float det = aa * bb - ab * ab;
+    if (std::fabs(det) < 1e-4f)
+        return false;  // every pixel on the same index
+    for (int c = 0; c < channels; ++c) {
+        e0[c] = std::min(std::max((ax[c] * bb - bx[c] * ab) / det, 0.f), 255.f);
+        e1[c] = std::min(std::max((bx[c] * aa - ax[c] * ab) / det, 0.f), 255.f);
+    }
+    return true;
+}
+
+
+struct BlockEncoder {
+    uint32_t (*bestIndices)(const uint8_t*, const uint8_t*, int, bool, uint8_t*) = bestIndicesScalar;
+    int bc7Quality = 1;  // 0 to 2
+    // error of the color part of every block, summed, for telling the quality levels apart
+    std::atomic<uint64_t> colorError{0};
+
+    // BC1 colors are 5:6:5, and the palette is the two endpoints and two colors a third of the way between
+    static uint16_t to565(const float c[4]) {
+        int r = int(c[0] * 31.f / 255.f + 0.5f), g = int(c[1] * 63.f / 255.f + 0.5f), b = int(c[2] * 31.f / 255.f + 0.5f);
+        return uint16_t(r << 11 | g << 5 | b);
+    }
+    static void from565(uint16_t c, uint8_t *rgba) {
+        int r = c >> 11, g = (c >> 5) & 63, b = c & 31;
+        rgba[0] = uint8_t(r << 3 | r >> 2);
+        rgba[1] = uint8_t(g << 2 | g >> 4);
+        rgba[2] = uint8_t(b << 3 | b >> 2);
+        rgba[3] = 255;
+    }
+    static void bc1Palette(uint16_t c0, uint16_t c1, uint8_t palette[16]) {
+        from565(c0, palette);
+        from565(c1, palette + 4);
+        for (int c = 0; c < 3; ++c) {
+            palette[8 + c] = uint8_t((2 * palette[c] + palette[4 + c] + 1) / 3);
+            palette[12 + c] = uint8_t((palette[c] + 2 * palette[4 + c] + 1) / 3);
+        }
+        palette[11] = palette[15] = 255;
+    }
+    // the endpoints go first-biggest, which is what picks the four color mode. for the same pair
+    // the other way round the indices of the ends and of the thirds swap
+    uint32_t tryBC1(const uint8_t *pixels, const float e0[4], const float e1[4], uint16_t &c0, uint16_t &c1, uint8_t indices[16]) const {
+        c0 = to565(e0);
+        c1 = to565(e1);
+        if (c0 < c1)
+            std::swap(c0, c1);
+        uint8_t palette[16];
+        bc1Palette(c0, c1, palette);
+        // with both ends the same there's only the first entry to use anyway
+        return bestIndices(pixels, palette, c0 == c1 ? 1 : 4, false, indices);
+    }
+    uint32_t encodeBC1Colors(const uint8_t *pixels, uint8_t *out) const {
+        static const float weights[4] = {0.f, 1.f, 1.f / 3.f, 2.f / 3.f};
+        float candidates[3][2][4] = {};
+        axisEndpoints(pixels, 3, candidates[0][0], candidates[0][1]);
+        // the bounding box, and the bounding box pulled in a bit, which usually lands closer
+        for (int c = 0; c < 3; ++c) {
+            float lo = 255.f, hi = 0.f;
+            for (int i = 0; i < 16; ++i) {
+                lo = std::min(lo, float(pixels[i * 4 + c]));
+                hi = std::max(hi, float(pixels[i * 4 + c]));
+            }
+            candidates[1][0][c] = lo;
+            candidates[1][1][c] = hi;
+            candidates[2][0][c] = lo + (hi - lo) / 16.f;
+            candidates[2][1][c] = hi - (hi - lo) / 16.f;
+        }
+        uint16_t c0 = 0, c1 = 0;
+        uint8_t indices[16];
+        uint32_t error = UINT32_MAX;
+        for (auto &candidate : candidates) {
+            uint16_t t0, t1;
+            uint8_t tIndices[16];
+            uint32_t e = tryBC1(pixels, candidate[0], candidate[1], t0, t1, tIndices);
+            if (e < error) {
+                error = e;
+                c0 = t0;
+                c1 = t1;
+                std::memcpy(indices, tIndices, 16);
+            }
+        }
+        // then refit to the indices the best one gave, while that keeps helping
+        for (int iteration = 0; iteration < 2 && error > 0; ++iteration) {
+            float e0[4], e1[4];
+            if (!fitEndpoints(pixels, indices, weights, 3, e0, e1))
+                break;
+            uint16_t t0, t1;
+            uint8_t tIndices[16];
+            uint32_t e = tryBC1(pixels, e0, e1, t0, t1, tIndices);
+            if (e >= error)
+                break;
+            error = e;
+            c0 = t0;
+            c1 = t1;
+            std::memcpy(indices, tIndices, 16);
+        }
+        uint32_t bits = 0;
+        for (int i = 0; i < 16; ++i)
+            bits |= uint32_t(c0 == c1 ? 0 : indices[i]) << (i * 2);
+        std::memcpy(out, &c0, 2);
+        std::memcpy(out + 2, &c1, 2);
+        std::memcpy(out + 4, &bits, 4);
+        return error;
+    }
+
+    // BC4, the alpha half of BC3: two 8 bit ends, six steps between them and 3 bit indices
+    static void bc4Palette(uint8_t a0, uint8_t a1, uint8_t palette[8]) {
+        palette[0] = a0;
+        palette[1] = a1;
+        for (int i = 1; i < 7; ++i)
+            palette[i + 1] = uint8_t(((7 - i) * a0 + i * a1 + 3) / 7);
+    }
+    static void encodeBC4(const uint8_t *pixels, uint8_t *out) {
+        uint8_t lo = 255, hi = 0;
+        for (int i = 0; i < 16; ++i) {
+            lo = std::min(lo, pixels[i * 4 + 3]);
+            hi = std::max(hi, pixels[i * 4 + 3]);
+        }
+        uint8_t palette[8];
+        bc4Palette(hi, lo, palette);
+        uint64_t bits = 0;
+        for (int i = 0; i < 16 && hi != lo; ++i) {
+            int best = 0, bestDiff = 256;
+            for (int k = 0; k < 8; ++k) {
+                int diff = std::abs(int(pixels[i * 4 + 3]) - int(palette[k]));
+                if (diff < bestDiff) {
+                    bestDiff = diff;
+                    best = k;
+                }
+            }
+            bits |= uint64_t(best) << (i * 3);
+        }
+        out[0] = hi;
+        out[1] = lo;
+        for (int i = 0; i < 6; ++i)
+            out[2 + i] = uint8_t(bits >> (i * 8));
+    }
+
+    // BC7 mode 6: one pair of RGBA endpoints with 7 bits per channel plus a shared lowest bit per endpoint,
+    // and 4 bit indices. the other seven modes split blocks into subsets or channels, this encoder leaves
+    // them out. quality 0 takes the ends of the principal axis and reads the indices off the projection,
+    // 1 measures every pixel against the palette for each of the four lowest bit choices, 2 refits the
+    // endpoints to those indices a couple of times as well
+    static constexpr int BC7_WEIGHTS[16] = {0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64};
+    static void bc7Quantize(const float e[4], int pbit, uint8_t q[4]) {
+        for (int c = 0; c < 4; ++c)
+            q[c] = uint8_t(std::min(std::max(int(std::lround((e[c] - pbit) / 2.f)), 0), 127));
+    }
+    static void bc7Palette(const uint8_t q0[4], const uint8_t q1[4], int p0, int p1, uint8_t palette[64]) {
+        for (int c = 0; c < 4; ++c) {
+            int a = q0[c] << 1 | p0, b = q1[c] << 1 | p1;
+            for (int k = 0; k < 16; ++k)
+                palette[k * 4 + c] = uint8_t(((64 - BC7_WEIGHTS[k]) * a + BC7_WEIGHTS[k] * b + 32) >> 6);
+        }
+    }
+    static void putBits(uint8_t *block, int &pos, uint32_t value, int count) {
+        for (int i = 0; i < count; ++i, ++pos)
+            block[pos / 8] |= uint8_t(((value >> i) & 1) << (pos % 8));
+    }
+    uint32_t encodeBC7(const uint8_t *pixels, uint8_t *out) const {
+        static constexpr float weights[16] = {0.f / 64, 4.f / 64, 9.f / 64, 13.f / 64, 17.f / 64, 21.f / 64, 26.f / 64, 30.f / 64,
+                                              34.f / 64, 38.f / 64, 43.f / 64, 47.f / 64, 51.f / 64, 55.f / 64, 60.f / 64, 1.f};
+        float e0[4], e1[4];
+        axisEndpoints(pixels, 4, e0, e1);
+        uint8_t q0[4], q1[4], indices[16], palette[64];
+        int p0 = 0, p1 = 0;
+        uint32_t error = UINT32_MAX;
+        if (bc7Quality == 0) {
+            // each end gets the lowest bit that keeps it closest
+            auto pick = [](const float e[4], uint8_t q[4]) {
+                float err[2] = {};
+                for (int p = 0; p < 2; ++p) {
+                    bc7Quantize(e, p, q);
+                    for (int c = 0; c < 4; ++c)
+                        err[p] += std::fabs(float(q[c] << 1 | p) - e[c]);
+                }
+                int p = err[1] < err[0];
+                bc7Quantize(e, p, q);
+                return p;
+            };
+            p0 = pick(e0, q0);
+            p1 = pick(e1, q1);
+            bc7Palette(q0, q1, p0, p1, palette);
+            float axis[4], length = 0.f;
+            for (int c = 0; c < 4; ++c) {
+                axis[c] = palette[60 + c] - palette[c];
+                length += axis[c] * axis[c];
+            }
+            error = 0;
+            for (int i = 0; i < 16; ++i) {
+                float t = 0.f;
+                for (int c = 0; c < 4; ++c)
+                    t += (pixels[i * 4 + c] - palette[c]) * axis[c];
+                t = length > 0.f ? t / length : 0.f;
+                // the weights are close enough to even steps of 1/15
+                indices[i] = uint8_t(std::min(std::max(int(t * 15.f + 0.5f), 0), 15));
+                for (int c = 0; c < 4; ++c) {
+                    int d = pixels[i * 4 + c] - palette[indices[i] * 4 + c];
+                    error += d * d;
+                }
+            }
+        } else {
+            auto tryAll = [&](const float a[4], const float b[4]) {
+                for (int p = 0; p < 4; ++p) {
+                    uint8_t t0[4], t1[4], tIndices[16];
+                    bc7Quantize(a, p & 1, t0);
+                    bc7Quantize(b, p >> 1, t1);
+                    bc7Palette(t0, t1, p & 1, p >> 1, palette);
+                    uint32_t e = bestIndices(pixels, palette, 16, true, tIndices);
+                    if (e < error) {
+                        error = e;
+                        std::memcpy(q0, t0, 4);
+                        std::memcpy(q1, t1, 4);
+                        p0 = p & 1;
+                        p1 = p >> 1;
+                        std::memcpy(indices, tIndices, 16);
+                    }
+                }
+            };
+            tryAll(e0, e1);
+            for (int iteration = 0; iteration < (bc7Quality >= 2 ? 2 : 0) && error > 0; ++iteration) {
+                if (!fitEndpoints(pixels, indices, weights, 4, e0, e1))
+                    break;
+                tryAll(e0, e1);
+            }
+        }
+        // the first index has an implied top bit of 0. if it's set, the ends trade places and the indices flip
+        if (indices[0] >= 8) {
+            std::swap(q0, q1);
+            std::swap(p0, p1);
+            for (uint8_t &index : indices)
+                index = uint8_t(15 - index);
+        }
+        std::memset(out, 0, 16);
+        int pos = 0;
+        putBits(out, pos, 1 << 6, 7);
+        for (int c = 0; c < 4; ++c) {
+            putBits(out, pos, q0[c], 7);
+            putBits(out, pos, q1[c], 7);
+        }
+        putBits(out, pos, p0, 1);
+        putBits(out, pos, p1, 1);
+        for (int i = 0; i < 16; ++i)
+            putBits(out, pos, indices[i], i == 0 ? 3 : 4);
+        return error;
+    }
+
+    void encodeBlock(BlockFormat format, const uint8_t *pixels, uint8_t *out) {
+        uint32_t error;
+        if (format == BlockFormat::BC1) {
+            error = encodeBC1Colors(pixels, out);
+        } else if (format == BlockFormat::BC3) {
+            encodeBC4(pixels, out);
+            error = encodeBC1Colors(pixels, out + 8);
+        } else {
+            error = encodeBC7(pixels, out);
+        }
+        colorError.fetch_add(error, std::memory_order_relaxed);
+    }
+};
+
+
+// decoding, for measuring what the encoder did. the same math as the hardware, more or less: decoders
+// are allowed to round the BC1 thirds a little differently
+void decodeBlock(BlockFormat format, const uint8_t *block, uint8_t *pixels) {
+    if (format == BlockFormat::BC7) {
+        if ((block[0] & 0x7f) != 1 << 6) {
+            for (int i = 0; i < 16; ++i)
+                std::memcpy(pixels + i * 4, "\xff\x00\xff\xff", 4);  // not a mode this encoder writes
+            return;
+        }
+        auto get = [&](int &pos, int count) {
+            uint32_t v = 0;
+            for (int i = 0; i < count; ++i, ++pos)
+                v |= uint32_t((block[pos / 8] >> (pos % 8)) & 1) << i;
+            return v;
+        };
+        int pos = 7;
+        uint8_t q0[4], q1[4], palette[64];
+        for (int c = 0; c < 4; ++c) {
+            q0[c] = uint8_t(get(pos, 7));
+            q1[c] = uint8_t(get(pos, 7));
+        }
+        int p0 = get(pos, 1), p1 = get(pos, 1);
+        BlockEncoder::bc7Palette(q0, q1, p0, p1, palette);
+        for (int i = 0; i < 16; ++i)
+            std::memcpy(pixels + i * 4, palette + get(pos, i == 0 ? 3 : 4) * 4, 4);
+        return;
+    }
+    const uint8_t *colors = format == BlockFormat::BC3 ? block + 8 : block;
+    uint16_t c0, c1;
+    uint32_t bits;
+    std::memcpy(&c0, colors, 2);
+    std::memcpy(&c1, colors + 2, 2);
+    std::memcpy(&bits, colors + 4, 4);
+    uint8_t palette[16];
+    BlockEncoder::bc1Palette(c0, c1, palette);
+    if (format == BlockFormat::BC1 && c0 <= c1) {
+        // the three color mode, the encoder only ends up here with both ends the same
+        for (int c = 0; c < 3; ++c)
+            palette[8 + c] = uint8_t((palette[c] + palette[4 + c]) / 2);
+        std::memset(palette + 12, 0, 4);
+    }
+    for (int i = 0; i < 16; ++i)
+        std::memcpy(pixels + i * 4, palette + ((bits >> (i * 2)) & 3) * 4, 4);
+    if (format == BlockFormat::BC3) {
+        uint8_t alphas[8];
+        BlockEncoder::bc4Palette(block[0], block[1], alphas);
+        if (block[0] <= block[1]) {
+            for (int i = 1; i < 5; ++i)
+                alphas[i + 1] = uint8_t(((5 - i) * block[0] + i * block[1] + 2) / 5);
+            alphas[6] = 0;
+            alphas[7] = 255;
+        }
+        uint64_t alphaBits = 0;
+        for (int i = 0; i < 6; ++i)
+            alphaBits |= uint64_t(block[2 + i]) << (i * 8);
+        for (int i = 0; i < 16; ++i)
+            pixels[i * 4 + 3] = alphas[(alphaBits >> (i * 3)) & 7];
+    }
+}
+
+
+struct CompressedImage {
+    BlockFormat format = BlockFormat::BC1;
+    int width = 0, height = 0;
+    std::vector<uint8_t> blocks;  // rows of blocks, the first row of pixels first
+    double encodeMs = 0.;
+    uint64_t colorError = 0;
+    int blocksWide() const {
+        return (width + 3) / 4;
+    }
+    int blocksHigh() const {
+        return (height + 3) / 4;
+    }
+};
+
+// rows of blocks are handed out to the threads one at a time. blocks past the edge of an image whose
+// size isn't a multiple of 4 repeat its last row and column
+CompressedImage compressImage(const uint8_t *rgba, int width, int height, BlockFormat format, BlockEncoder &encoder, int threads) {
+    CompressedImage image;
+    image.format = format;
+    image.width = width;
+    image.height = height;
+    const int wide = image.blocksWide(), high = image.blocksHigh();
+    const size_t bytes = blockBytes(format);
+    image.blocks.resize(size_t(wide) * high * bytes);
+    encoder.colorError = 0;
+    std::atomic<int> nextRow{0};
+    auto work = [&]() {
+        alignas(16) uint8_t pixels[64];
+        for (int by; (by = nextRow.fetch_add(1)) < high;) {
+            for (int bx = 0; bx < wide; ++bx) {
+                for (int y = 0; y < 4; ++y) {
+                    int sy = std::min(by * 4 + y, height - 1);
+                    for (int x = 0; x < 4; ++x) {
+                        int sx = std::min(bx * 4 + x, width - 1);
+                        std::memcpy(pixels + (y * 4 + x) * 4, rgba + (size_t(sy) * width + sx) * 4, 4);
+                    }
+                }
+                encoder.encodeBlock(format, pixels, &image.blocks[(size_t(by) * wide + bx) * bytes]);
+            }
+        }
+    };
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> workers;
+    for (int i = 1; i < threads; ++i)
+        workers.emplace_back(work);
+    work();
+    for (std::thread &worker : workers)
+        worker.join();
+    image.encodeMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    image.colorError = encoder.colorError;
+    return image;
+}
+
+std::vector<uint8_t> decompressImage(const CompressedImage &image) {
+    std::vector<uint8_t> rgba(size_t(image.width) * image.height * 4);
+    const size_t bytes = blockBytes(image.format);
+    uint8_t pixels[64];
+    for (int by = 0; by < image.blocksHigh(); ++by) {
+        for (int bx = 0; bx < image.blocksWide(); ++bx) {
+            decodeBlock(image.format, &image.blocks[(size_t(by) * image.blocksWide() + bx) * bytes], pixels);
+            for (int y = 0; y < 4 && by * 4 + y < image.height; ++y)
+                for (int x = 0; x < 4 && bx * 4 + x < image.width; ++x)
+                    std::memcpy(&rgba[(size_t(by * 4 + y) * image.width + bx * 4 + x) * 4], pixels + (y * 4 + x) * 4, 4);
+        }
+    }
+    return rgba;
+}
+
+// over the given channels of two RGBA8 images, in dB. identical images are reported as 99
+double psnr(const std::vector<uint8_t> &a, const std::vector<uint8_t> &b, int firstChannel, int channels) {
+    double sum = 0.;
+    size_t n = 0;
+    for (size_t i = 0; i < a.size(); i += 4) {
+        for (int c = firstChannel; c < firstChannel + channels; ++c) {
+            double d = double(a[i + c]) - double(b[i + c]);
+            sum += d * d;
+            ++n;
+        }
+    }
+    if (sum == 0.)
+        return 99.;
+    return 10. * std::log10(255. * 255. / (sum / n));
+}
+
+GLenum compressedFormat(BlockFormat format) {
+    switch (format) {
+    case BlockFormat::BC1: return GL_COMPRESSED_RGB_S3TC_DXT1_EXT;
+    case BlockFormat::BC3: return GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+    default: return GL_COMPRESSED_RGBA_BPTC_UNORM;
+    }
+}
+
+bool compressedFormatSupported(BlockFormat format) {
+    if (format == BlockFormat::BC7)
+        return GLEW_ARB_texture_compression_bptc;
+    return GLEW_EXT_texture_compression_s3tc;
+}
+
+std::unique_ptr<BlockEncoder> makeEncoder(bool simd) {
+    std::unique_ptr<BlockEncoder> encoder(new BlockEncoder());
+#ifdef BLOCK_ENCODER_X86
+    __builtin_cpu_init();
+    if (simd && __builtin_cpu_supports("sse4.1"))
+        encoder->bestIndices = bestIndicesSse41;
+#endif
+    return encoder;
+}
+
+int encoderThreads() {
+    return std::max(1, int(std::thread::hardware_concurrency()));
+}
+
+
+class Texture2D {
+    GLuint tex_id;
+public:
+    // uploaded uncompressed
+    void generate2DTex(const char *image_path) {
+        int width, height, nChannels;
+        stbi_set_flip_vertically_on_load(true);
+        uint8_t *raw_image = stbi_load(image_path, &width, &height, &nChannels, 0);
+        if (!raw_image) {
+            std::cerr << "ERROR::TEXTURE - can't load " << image_path << "\n";
+            return;
+        }
+        create();
+        // rows of 3 channels aren't always a multiple of 4 bytes
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+        // glTexImage2D(TARGET_TYPE, IM_MIPMAP_LEVEL, TARGET_NRCHANNELS, SRC_WIDTH, SRC_HEIGHT, LEGACY_0, SRC_NRCHANNELS, SRC_DATA_TYPE, SRC_DATA);
+        glTexImage2D(GL_TEXTURE_2D, 0, nChannels == 4 ? GL_RGBA : GL_RGB, width, height, 0, nChannels == 4 ? GL_RGBA : GL_RGB, GL_UNSIGNED_BYTE, raw_image);
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+        stbi_image_free(raw_image);
+    }
+    // compressed blocks, as they come out of compressImage. false when the driver can't take the format
+    bool generateCompressed(const CompressedImage &image) {
+        if (!compressedFormatSupported(image.format)) {
+            std::cerr << "ERROR::TEXTURE - " << blockFormatName(image.format) << " textures aren't supported here\n";
+            return false;
+        }
+        create();
+        glCompressedTexImage2D(GL_TEXTURE_2D, 0, compressedFormat(image.format), image.width, image.height, 0, GLsizei(image.blocks.size()), image.blocks.data());
+        return glGetError() == GL_NO_ERROR;
+    }
+    void create() {
+        float borderColor[] = {1.f, 1.f, 1.f, 1.f};
+        glGenTextures(1, &tex_id);
+        glBindTexture(GL_TEXTURE_2D, tex_id);
+        // what to do when primitive is bigger than the texture
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_BORDER);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_BORDER);
+        glTexParameterfv(GL_TEXTURE_2D, GL_TEXTURE_BORDER_COLOR, borderColor);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    }
+    void bind() {
+        glBindTexture(GL_TEXTURE_2D, tex_id);
+    }
+};
+
+
+// the image as RGBA8, bottom row first like GL wants it. with fakeAlpha a soft-edged circle goes into alpha,
+// so the alpha part of BC3 and BC7 has something to do on opaque images
+std::vector<uint8_t> loadRGBA(const char *path, int &width, int &height, bool fakeAlpha) {
+    int channels;
+    stbi_set_flip_vertically_on_load(true);
+    uint8_t *data = stbi_load(path, &width, &height, &channels, 4);
+    if (!data) {
+        std::cerr << "ERROR::TEXTURE - can't load " << path << "\n";
+        return {};
+    }
+    std::vector<uint8_t> rgba(data, data + size_t(width) * height * 4);
+    stbi_image_free(data);
+    if (fakeAlpha && channels != 4) {
+        for (int y = 0; y < height; ++y) {
+            for (int x = 0; x < width; ++x) {
+                float dx = (x + 0.5f) / width - 0.5f, dy = (y + 0.5f) / height - 0.5f;
+                float a = std::min(std::max((0.45f - std::sqrt(dx * dx + dy * dy)) * 10.f, 0.f), 1.f);
+                rgba[(size_t(y) * width + x) * 4 + 3] = uint8_t(a * 255.f + 0.5f);
+            }
+        }
+    }
+    return rgba;
+}
+
+// --bench: every format and BC7 quality on the lesson's image, with and without the SIMD error measure
+int runBench(const char *path, int threads) {
+    int width, height;
+    std::vector<uint8_t> source = loadRGBA(path, width, height, true);
+    if (source.empty())
+        return EXIT_FAILURE;
+    std::printf("%s, %dx%d, %d threads\n", path, width, height, threads);
+    struct Run { BlockFormat format; int quality; };
+    const Run runs[] = {{BlockFormat::BC1, 0}, {BlockFormat::BC3, 0}, {BlockFormat::BC7, 0}, {BlockFormat::BC7, 1}, {BlockFormat::BC7, 2}};
+    std::unique_ptr<BlockEncoder> scalar = makeEncoder(false), simd = makeEncoder(true);
+    bool same = true;
+    for (const Run &run : runs) {
+        scalar->bc7Quality = simd->bc7Quality = run.quality;
+        CompressedImage reference = compressImage(source.data(), width, height, run.format, *scalar, threads);
+        CompressedImage image = compressImage(source.data(), width, height, run.format, *simd, threads);
+        same = same && reference.blocks == image.blocks;
+        std::vector<uint8_t> decoded = decompressImage(image);
+        const double mpix = double(width) * height / 1e6;
+        char name[16];
+        std::snprintf(name, sizeof(name), run.format == BlockFormat::BC7 ? "%s q%d" : "%s", blockFormatName(run.format), run.quality);
+        std::printf("%-7s %7.1f MPix/s (%6.1f scalar)  rgb %5.2f dB", name, mpix / image.encodeMs * 1e3,
+                    mpix / reference.encodeMs * 1e3, psnr(source, decoded, 0, 3));
+        if (run.format != BlockFormat::BC1)
+            std::printf("  alpha %5.2f dB", psnr(source, decoded, 3, 1));
+        std::printf("  %5.2f MB, %s\n", image.blocks.size() / 1e6, reference.blocks == image.blocks ? "same as scalar" : "DIFFERENT from scalar");
+    }
+    std::printf("uncompressed %.2f MB as RGB, %.2f MB as RGBA\n", width * height * 3 / 1e6, width * height * 4 / 1e6);
+    return same ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+
+void processInput(GLFWwindow *window, glm::vec3 &cameraPos, glm::vec3 &cameraFront, glm::vec3 &cameraUp)
+{
+
+    const float cameraSpeed = 0.05f; // adjust accordingly
+    if (glfwGetKey(window, GLFW_KEY_W) == GLFW_PRESS)
+        cameraPos += cameraSpeed * cameraFront;
+    if (glfwGetKey(window, GLFW_KEY_S) == GLFW_PRESS)
+        cameraPos -= cameraSpeed * cameraFront;
+    if (glfwGetKey(window, GLFW_KEY_A) == GLFW_PRESS)
+        cameraPos -= glm::normalize(glm::cross(cameraFront, cameraUp)) * cameraSpeed;
+    if (glfwGetKey(window, GLFW_KEY_D) == GLFW_PRESS)
+        cameraPos += glm::normalize(glm::cross(cameraFront, cameraUp)) * cameraSpeed;
+    if (glfwGetKey(window, GLFW_KEY_UP) == GLFW_PRESS)
+        cameraPos += glm::normalize(glm::cross(cameraFront, cameraUp)) * cameraSpeed;
+
+}
+
+// true only on the frame the key went down
+bool keyPressed(GLFWwindow *window, int key) {
+    static bool down[GLFW_KEY_LAST + 1] = {};
+    bool now = glfwGetKey(window, key) == GLFW_PRESS;
+    bool pressed = now && !down[key];
+    down[key] = now;
+    return pressed;
+}
+
+
+float yaw = -90.f;
+float pitch = 0.f;
+glm::vec3 cameraFront;
+
+void mouseMovement(GLFWwindow *window, double xPos, double yPos) {
+    static float lastX = xPos, lastY = yPos;
+    float xOffset = xPos - lastX;
+    float yOffset = lastY - yPos;
+    
+    constexpr float sensitivity = 0.05f;
+    xOffset *= sensitivity;
+    yOffset *= sensitivity;
+
+    yaw += xOffset;
+    pitch += yOffset;
+
+    if (std::abs(pitch) > 89.f) // don't ever do it this way. I am lazy
+        pitch = std::abs(pitch) / pitch * 89.f;
+
+    cameraFront.x = cos(glm::radians(yaw)) * cos(glm::radians(pitch));
+    cameraFront.y = sin(glm::radians(pitch));
+    cameraFront.z = sin(glm::radians(yaw)) * cos(glm::radians(pitch));
+
+    cameraFront = glm::normalize(cameraFront);
+    lastX = xPos, lastY = yPos;
+}
+
+
+int main(int argc, char **argv) {
+    bool compress = true;
+    BlockFormat format = BlockFormat::BC1;
+    int quality = 1, threads = encoderThreads();
+    for (int i = 1; i < argc; ++i) {
+        if (!std::strcmp(argv[i], "--bench"))
+            return runBench("./image2d.tex", threads);
+        if (!std::strcmp(argv[i], "--format") && i + 1 < argc) {
+            ++i;
+            compress = std::strcmp(argv[i], "none") != 0;
+            format = !std::strcmp(argv[i], "bc3") ? BlockFormat::BC3 : !std::strcmp(argv[i], "bc7") ? BlockFormat::BC7 : BlockFormat::BC1;
+        } else if (!std::strcmp(argv[i], "--quality") && i + 1 < argc) {
+            quality = std::min(std::max(std::atoi(argv[++i]), 0), 2);
+        } else if (!std::strcmp(argv[i], "--threads") && i + 1 < argc) {
+            threads = std::max(1, std::atoi(argv[++i]));
+        }
+    }
+
+    if (glfwInit() != GLFW_TRUE) {
+        glfwTerminate();
+        std::cerr << "Failed to initialize GLFW";
+        return EXIT_FAILURE;
+    }
+    // setting OpenGL version to 3.3
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+    GLFWwindow *win = glfwCreateWindow(800, 600, "This is a hello window!", NULL, NULL);
+    // setting 'context' for OpenGL, i.e. where to draw on current thread
+    glfwMakeContextCurrent(win);
+    // all it does is fetches us the implemented functions of OpenGL
+    if (glewInit() != GLEW_OK) {
+        glfwTerminate();
+        std::cerr << "Failed to initialize GLEW\n";
+        return EXIT_FAILURE;
+    }
+    int screenWidth, screenHeight;
+    glfwGetFramebufferSize(win, &screenWidth, &screenHeight);
+    glViewport(0, 0, screenWidth, screenHeight);
+
+    glEnable(GL_DEPTH_TEST);
+    float triangle_data[] = {
+        //   vertpos   //  //   normal   //  //texcord//
+    -0.5f, -0.5f, -0.5f,  0.0f,  0.0f, -1.0f,  0.0f, 0.0f,
+     0.5f, -0.5f, -0.5f,  0.0f,  0.0f, -1.0f,  1.0f, 0.0f,
+     0.5f,  0.5f, -0.5f,  0.0f,  0.0f, -1.0f,  1.0f, 1.0f,
+     0.5f,  0.5f, -0.5f,  0.0f,  0.0f, -1.0f,  1.0f, 1.0f,
+    -0.5f,  0.5f, -0.5f,  0.0f,  0.0f, -1.0f,  0.0f, 1.0f,
+    -0.5f, -0.5f, -0.5f,  0.0f,  0.0f, -1.0f,  0.0f, 0.0f,
+
+    -0.5f, -0.5f,  0.5f,  0.0f,  0.0f,  1.0f,  0.0f, 0.0f,
+     0.5f, -0.5f,  0.5f,  0.0f,  0.0f,  1.0f,  1.0f, 0.0f,
+     0.5f,  0.5f,  0.5f,  0.0f,  0.0f,  1.0f,  1.0f, 1.0f,
+     0.5f,  0.5f,  0.5f,  0.0f,  0.0f,  1.0f,  1.0f, 1.0f,
+    -0.5f,  0.5f,  0.5f,  0.0f,  0.0f,  1.0f,  0.0f, 1.0f,
+    -0.5f, -0.5f,  0.5f,  0.0f,  0.0f,  1.0f,  0.0f, 0.0f,
+
+    -0.5f,  0.5f,  0.5f, -1.0f,  0.0f,  0.0f,  1.0f, 0.0f,
+    -0.5f,  0.5f, -0.5f, -1.0f,  0.0f,  0.0f,  1.0f, 1.0f,
+    -0.5f, -0.5f, -0.5f, -1.0f,  0.0f,  0.0f,  0.0f, 1.0f,
+    -0.5f, -0.5f, -0.5f, -1.0f,  0.0f,  0.0f,  0.0f, 1.0f,
+    -0.5f, -0.5f,  0.5f, -1.0f,  0.0f,  0.0f,  0.0f, 0.0f,
+    -0.5f,  0.5f,  0.5f, -1.0f,  0.0f,  0.0f,  1.0f, 0.0f,
+
+     0.5f,  0.5f,  0.5f,  1.0f,  0.0f,  0.0f,  1.0f, 0.0f,
+     0.5f,  0.5f, -0.5f,  1.0f,  0.0f,  0.0f,  1.0f, 1.0f,
+     0.5f, -0.5f, -0.5f,  1.0f,  0.0f,  0.0f,  0.0f, 1.0f,
+     0.5f, -0.5f, -0.5f,  1.0f,  0.0f,  0.0f,  0.0f, 1.0f,
+     0.5f, -0.5f,  0.5f,  1.0f,  0.0f,  0.0f,  0.0f, 0.0f,
+     0.5f,  0.5f,  0.5f,  1.0f,  0.0f,  0.0f,  1.0f, 0.0f,
+
+    -0.5f, -0.5f, -0.5f,  0.0f, -1.0f,  0.0f,  0.0f, 1.0f,
+     0.5f, -0.5f, -0.5f,  0.0f, -1.0f,  0.0f,  1.0f, 1.0f,
+     0.5f, -0.5f,  0.5f,  0.0f, -1.0f,  0.0f,  1.0f, 0.0f,
+     0.5f, -0.5f,  0.5f,  0.0f, -1.0f,  0.0f,  1.0f, 0.0f,
+    -0.5f, -0.5f,  0.5f,  0.0f, -1.0f,  0.0f,  0.0f, 0.0f,
+    -0.5f, -0.5f, -0.5f,  0.0f, -1.0f,  0.0f,  0.0f, 1.0f,
+
+    -0.5f,  0.5f, -0.5f,  0.0f,  1.0f,  0.0f,  0.0f, 1.0f,
+     0.5f,  0.5f, -0.5f,  0.0f,  1.0f,  0.0f,  1.0f, 1.0f,
+     0.5f,  0.5f,  0.5f,  0.0f,  1.0f,  0.0f,  1.0f, 0.0f,
+     0.5f,  0.5f,  0.5f,  0.0f,  1.0f,  0.0f,  1.0f, 0.0f,
+    -0.5f,  0.5f,  0.5f,  0.0f,  1.0f,  0.0f,  0.0f, 0.0f,
+    -0.5f,  0.5f, -0.5f,  0.0f,  1.0f,  0.0f,  0.0f, 1.0f
+        
+    };
+
+
+    glm::vec3 cameraPos(0.f, 0.f, 3.f);
+    cameraFront = glm::vec3(0.f,0.f,-1.f);
+    glm::vec3 cameraUp(0.,1.,0.f);
+    
+
+    Texture2D tex;
+    bool compressed = false;
+    if (compress && compressedFormatSupported(format)) {
+        int width, height;
+        std::vector<uint8_t> rgba = loadRGBA("./image2d.tex", width, height, false);
+        std::unique_ptr<BlockEncoder> encoder = makeEncoder(true);
+        encoder->bc7Quality = quality;
+        CompressedImage image = compressImage(rgba.data(), width, height, format, *encoder, threads);
+        std::vector<uint8_t> decoded = decompressImage(image);
+        std::cout << blockFormatName(format) << ": " << width * height / image.encodeMs / 1e3 << " MPix/s on " << threads
+                  << " threads, " << psnr(rgba, decoded, 0, 3) << " dB, " << image.blocks.size() / 1024 << "KB instead of "
+                  << width * height * 3 / 1024 << "KB\n";
+        compressed = tex.generateCompressed(image);
+    } else if (compress) {
+        std::cerr << blockFormatName(format) << " isn't available, the texture stays uncompressed\n";
+    }
+    if (!compressed)
+        tex.generate2DTex("./image2d.tex");
+    tex.bind();
+
+    GLuint vbo = 0;
+    glGenBuffers(1, &vbo); 
+    glBindBuffer(GL_ARRAY_BUFFER, vbo);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(triangle_data), triangle_data, GL_STATIC_DRAW);
+
+    GLuint vao = 0;
+    glGenVertexArrays(1, &vao);
+    glBindVertexArray(vao);
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)0);
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)(6 * sizeof(float)));
+    glEnableVertexAttribArray(1);
+    glVertexAttribPointer(2, 3, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)(3 * sizeof(float)));
+    glEnableVertexAttribArray(2);
+
+    VertexShader vs;
+    FragmentShader fs;
+    vs.setSource("./vertex.glsl");
+    fs.setSource("./frag.glsl");
+    Program prog;
+    prog.AttachShaders({&vs, &fs});
+
+    prog.UseProgram();
+    prog.setInt("tex", 0);
+
+    glm::mat4 view; // = glm::translate(glm::mat4(1.f), glm::vec3(0.f,0.f,-3.f));
+       
+
+    glm::mat4 proj = glm::perspective(glm::radians(45.f), float(screenWidth) / screenHeight, 0.1f, 100.f);
+
+    prog.setMat4("proj", proj);
+    prog.setMat4("view", view);
+
+    glfwSetCursorPosCallback(win, mouseMovement); 
+    glfwSetInputMode(win, GLFW_CURSOR, GLFW_CURSOR_DISABLED);  
+    
+    while (!glfwWindowShouldClose(win)) {
+        processInput(win, cameraPos, cameraFront, cameraUp);
+        view = glm::lookAt(cameraPos, cameraFront + cameraPos, cameraUp);
+
+        prog.UseProgram();
+        prog.setMat4("view", view);
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+        glBindVertexArray(vao);
+        tex.bind();
+        prog.setMat4("model", glm::rotate(glm::mat4(1.f), float(glfwGetTime()), glm::vec3(0.5f, 1.f, 0.f)));
+        glDrawArrays(GL_TRIANGLES, 0, 36);
+
+        // polls different kinds of events, for example, when we close an application, it fetches that event
+        // or it fetches events like movement of the window.
+        // Without it you can neither move the window or close the window
+        glfwPollEvents();
+        // have you drawn the image, it is stored in the buffer. You can now swap this buffer with main buffer
+        // so the image appears
+        glfwSwapBuffers(win);
+    }
+    glfwTerminate();
+    
+    std::cout << "Window should close now!\n";
+
+    return EXIT_SUCCESS;
+
+}
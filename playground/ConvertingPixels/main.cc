@@ -0,0 +1,988 @@
+#include <GL/glew.h>
+
+#include <GLFW/glfw3.h>
+#include <algorithm>
+#include <cfloat>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <immintrin.h>
+#include <random>
+#include <string>
+#include <vector>
+#include <glm/ext/matrix_clip_space.hpp>
+#include <glm/ext/matrix_transform.hpp>
+#include <glm/geometric.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/ext/matrix_float4x4.hpp>
+#include <glm/gtc/type_ptr.hpp>
+#include <glm/glm.hpp>
+#include <glm/trigonometric.hpp>
+#define STB_IMAGE_IMPLEMENTATION
+#include <stb/stb_image.h>
+#include <iostream>
+
+class Shader {
+    std::string src; 
+protected:
+    const char *getsrc() {
+        return src.data();
+    }
+    GLuint shader_id = 0;
+    bool isCompiled = false;
+protected:
+    virtual const char *getClassName() = 0;
+    GLint getCompilationStatus(GLuint shader_id) {
+        int status;
+        glGetShaderiv(shader_id, GL_COMPILE_STATUS, &status);
+        return status;
+    }
+    void sendError() {
+        char buffer[1024];
+        glGetShaderInfoLog(shader_id, 1024, NULL, buffer);
+        std::cerr << "ERROR::" << getClassName() << " - " << buffer;
+    }
+public:
+    virtual void compile() = 0;
+    void setSource(const char *s) {
+        std::ifstream sourceFile(s);
+        if (!sourceFile.is_open())
+            return;
+        char buffer[8192];
+        while (sourceFile.read(buffer, 8192)) {
+            src.append(buffer, 8192);
+        }
+        if (!sourceFile.eof()) {
+            src.clear();
+            return;
+        }
+        src.append(buffer, sourceFile.gcount());
+    }
+    friend class Program;
+};
+
+
+class VertexShader : public Shader {
+    virtual const char *getClassName() override {
+        return "VertexShader";
+    }
+public:
+    virtual void compile() override {
+        if (shader_id)
+            glDeleteShader(shader_id);
+        shader_id = glCreateShader(GL_VERTEX_SHADER);
+        const char *src = getsrc();
+        glShaderSource(shader_id, 1, &src, NULL);
+        glCompileShader(shader_id);
+        if (!getCompilationStatus(shader_id)) {
+            sendError();
+        }
+        isCompiled = true;
+    }
+};
+
+class FragmentShader : public Shader {
+    const char *getClassName() override {
+        return "FragmentShader";
+    }
+public:
+    virtual void compile() override {
+        if (shader_id)
+            glDeleteShader(shader_id);
+        shader_id = glCreateShader(GL_FRAGMENT_SHADER);
+        const char *src = getsrc();
+        glShaderSource(shader_id, 1, &src, NULL);
+        glCompileShader(shader_id);
+        if (!getCompilationStatus(shader_id)) {
+            sendError();
+        }
+        isCompiled = true;
+    }
+};
+
+
+class Program {
+    GLuint program_id = 0;
+    void sendError() {
+        char buffer[1024];
+        glGetProgramInfoLog(program_id, 1024, NULL, buffer);
+        std::cerr << "ERROR::PROGRAM: " << " - " << buffer;
+    }
+    bool linkStatus() {
+        int status = 0;
+        glGetProgramiv(program_id, GL_LINK_STATUS, &status);
+        return status;
+    }
+public:
+    Program() {
+        program_id = glCreateProgram();
+    }
+    ~Program() {
+        glDeleteProgram(program_id);
+    }
+    void AttachShaders(std::initializer_list<Shader*> shaders) {
+        auto i = shaders.begin();
+        while (i != shaders.end()) {
+            if (!(*i)->isCompiled)
+                (*i)->compile();
+            glAttachShader(program_id, (*i)->shader_id);
+            ++i;
+        }
+        glLinkProgram(program_id);
+        if (!linkStatus()) {
+            sendError();
+        }
+    }
+    void UseProgram() {
+        glUseProgram(program_id);
+    }
+    void setMat4(const char *locName, const glm::mat4 &mat) {
+        int location = glGetUniformLocation(program_id, locName);
+        if (location == -1)
+            return;
+        glUniformMatrix4fv(location, 1, GL_FALSE, glm::value_ptr(mat));
+    }
+    void setInt(const char *locName, int value) {
+        int location = glGetUniformLocation(program_id, locName);
+        if (location == -1)
+            return;
+        glUniform1i(location, value);
+    }
+    void setFloat(const char *locName, float value) {
+        int location = glGetUniformLocation(program_id, locName);
+        if (location == -1)
+            return;
+        glUniform1f(location, value);
+    }
+    void setVec3(const char *locName, const glm::vec3 &vec) {
+        int location = glGetUniformLocation(program_id, locName);
+        if (location == -1)
+            return;
+        glUniform3f(location, vec.x, vec.y, vec.z);
+    }
+    void setVec4(const char *locName, const glm::vec4 &vec) {
+        int location = glGetUniformLocation(program_id, locName);
+        if (location == -1)
+            return;
+        glUniform4f(location, vec.x, vec.y, vec.z, vec.w);
+    }
+};
+
+
+
+
+// ---------------------------------------------------------------------------------------------------------
+// pixel conversion kernels for getting decoded images into the shape GL wants. every kernel has a plain
+// scalar version, which is the reference, and a SIMD one picked at runtime when the CPU has it: SSSE3 for the
+// byte shuffling ones, AVX2 for the sRGB ones since those need gathers. the SIMD versions do the exact same
+// arithmetic as the scalar ones, so their output has to match bit for bit, --bench checks that
+// ---------------------------------------------------------------------------------------------------------
+
+// sRGB <-> linear by the book, used to build the tables and to measure how far off the fast versions are
+float srgbToLinearExact(float c) {
+    return c <= 0.04045f ? c / 12.92f : std::pow((c + 0.055f) / 1.055f, 2.4f);
+}
+
+float linearToSrgbExact(float l) {
+    l = std::min(std::max(l, 0.f), 1.f);
+    return l <= 0.0031308f ? l * 12.92f : 1.055f * std::pow(l, 1.f / 2.4f) - 0.055f;
+}
+
+// sRGB to linear is a lookup, there are only 256 inputs
+struct SrgbDecodeTable {
+    float values[256];
+    SrgbDecodeTable() {
+        for (int i = 0; i < 256; ++i)
+            values[i] = srgbToLinearExact(i / 255.f);
+    }
+};
+
+// linear to sRGB goes the other way, from a float. the float's exponent and the top 3 bits of its mantissa
+// pick one of 104 pieces (13 octaves down from 1, everything darker comes out as 0), and the next 8 bits of
+// the mantissa go through a straight line fitted to the curve over that piece. off by at most one from
+// rounding the exact curve, and all in integers, so it is the same in every lane
+struct SrgbEncodeTable {
+    static constexpr uint32_t MIN_BITS = (127 - 13) << 23;  // 2^-13
+    static constexpr uint32_t ALMOST_ONE_BITS = 0x3f7fffff;
+    uint32_t pieces[104];  // bias in the high half, slope in the low one
+    SrgbEncodeTable() {
+        for (uint32_t piece = 0; piece < 104; ++piece) {
+            // least squares over the 256 steps of the piece, at the middle of each. the + 0.5 is the rounding
+            double sumT = 0., sumY = 0., sumTT = 0., sumTY = 0.;
+            for (uint32_t t = 0; t < 256; ++t) {
+                uint32_t bits = MIN_BITS + (piece << 20) + (t << 12) + (1 << 11);
+                float l;
+                std::memcpy(&l, &bits, 4);
+                double y = (255. * linearToSrgbExact(l) + 0.5) * 65536.;
+                sumT += t;
+                sumY += y;
+                sumTT += double(t) * t;
+                sumTY += t * y;
+            }
+            double slope = (256. * sumTY - sumT * sumY) / (256. * sumTT - sumT * sumT);
+            double bias = (sumY - slope * sumT) / 256.;
+            pieces[piece] = uint32_t(std::lround(bias / 512.)) << 16 | uint32_t(std::lround(slope));
+        }
+    }
+};
+
+const SrgbDecodeTable srgbDecodeTable;
+const SrgbEncodeTable srgbEncodeTable;
+
+inline uint8_t linearToSrgb8(float l) {
+    float clamped, almostOne, min;
+    uint32_t bits = SrgbEncodeTable::ALMOST_ONE_BITS;
+    std::memcpy(&almostOne, &bits, 4);
+    bits = SrgbEncodeTable::MIN_BITS;
+    std::memcpy(&min, &bits, 4);
+    // written to behave like maxps/minps, NaN ends up as 0
+    clamped = l > min ? l : min;
+    clamped = clamped < almostOne ? clamped : almostOne;
+    std::memcpy(&bits, &clamped, 4);
+    uint32_t piece = srgbEncodeTable.pieces[(bits - SrgbEncodeTable::MIN_BITS) >> 20];
+    uint32_t bias = (piece >> 16) << 9, slope = piece & 0xffff, t = (bits >> 12) & 0xff;
+    return uint8_t((bias + slope * t) >> 16);
+}
+
+// alpha is linear in both directions
+inline uint8_t alphaToByte(float a) {
+    a = a > 0.f ? a : 0.f;
+    a = a < 1.f ? a : 1.f;
+    return uint8_t(int(a * 255.f + 0.5f));
+}
+
+// c * a / 255, rounded. exact for every pair of bytes, without dividing
+inline uint8_t mulDiv255(uint32_t c, uint32_t a) {
+    uint32_t x = c * a + 128;
+    return uint8_t((x + (x >> 8)) >> 8);
+}
+
+
+void expandToRGBAScalar(const uint8_t *src, uint8_t *dst, size_t count, int channels) {
+    for (size_t i = 0; i < count; ++i, src += channels, dst += 4) {
+        switch (channels) {
+        case 1:
+            dst[0] = dst[1] = dst[2] = src[0];
+            dst[3] = 255;
+            break;
+        case 2:
+            dst[0] = dst[1] = dst[2] = src[0];
+            dst[3] = src[1];
+            break;
+        case 3:
+            dst[0] = src[0];
+            dst[1] = src[1];
+            dst[2] = src[2];
+            dst[3] = 255;
+            break;
+        default:
+            std::memcpy(dst, src, 4);
+        }
+    }
+}
+
+void flipRowsScalar(uint8_t *pixels, int height, size_t rowBytes) {
+    for (int y = 0; y < height / 2; ++y) {
+        uint8_t *top = pixels + y * rowBytes, *bottom = pixels + (height - 1 - y) * rowBytes;
+        for (size_t i = 0; i < rowBytes; ++i)
+            std::swap(top[i], bottom[i]);
+    }
+}
+
+// dst channel i = src channel order[i], in place is fine
+void swizzleRGBAScalar(const uint8_t *src, uint8_t *dst, size_t count, const uint8_t order[4]) {
+    for (size_t i = 0; i < count; ++i, src += 4, dst += 4) {
+        uint8_t px[4] = {src[order[0]], src[order[1]], src[order[2]], src[order[3]]};
+        std::memcpy(dst, px, 4);
+    }
+}
+
+void premultiplyAlphaScalar(uint8_t *pixels, size_t count) {
+    for (size_t i = 0; i < count; ++i, pixels += 4) {
+        pixels[0] = mulDiv255(pixels[0], pixels[3]);
+        pixels[1] = mulDiv255(pixels[1], pixels[3]);
+        pixels[2] = mulDiv255(pixels[2], pixels[3]);
+    }
+}
+
+void srgbToLinearScalar(const uint8_t *src, float *dst, size_t count) {
+    for (size_t i = 0; i < count; ++i, src += 4, dst += 4) {
+        dst[0] = srgbDecodeTable.values[src[0]];
+        dst[1] = srgbDecodeTable.values[src[1]];
+        dst[2] = srgbDecodeTable.values[src[2]];
+        dst[3] = float(src[3]) * (1.f / 255.f);
+    }
+}
+
+void linearToSrgbScalar(const float *src, uint8_t *dst, size_t count) {
+    for (size_t i = 0; i < count; ++i, src += 4, dst += 4) {
+        dst[0] = linearToSrgb8(src[0]);
+        dst[1] = linearToSrgb8(src[1]);
+        dst[2] = linearToSrgb8(src[2]);
+        dst[3] = alphaToByte(src[3]);
+    }
+}
+
+
+#if defined(__x86_64__) || defined(__i386__)
+#define PIXEL_KERNELS_X86 1
+
+// the shuffle for the group-th 16 bytes out of 16 bytes of a 1 or 2 channel image
+__m128i expandMask(int channels, int group) {
+    alignas(16) int8_t mask[16];
+    for (int i = 0; i < 4; ++i) {
+        int src = channels == 1 ? group * 4 + i : group * 8 + i * 2;
+        mask[i * 4] = mask[i * 4 + 1] = mask[i * 4 + 2] = int8_t(src);
+        mask[i * 4 + 3] = channels == 1 ? -1 : int8_t(src + 1);
+    }
+    return _mm_load_si128(reinterpret_cast<const __m128i*>(mask));
+}
+
+__attribute__((target("ssse3")))
+void expandToRGBASsse3(const uint8_t *src, uint8_t *dst, size_t count, int channels) {
+    size_t i = 0;
+    const __m128i opaque = _mm_set1_epi32(int(0xff000000));
+    if (channels == 3) {
+        // 16 pixels are 48 bytes in and 64 out. each 16 bytes out takes 12 bytes in, lined up by alignr
+        const __m128i mask = _mm_setr_epi8(0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1);
+        for (; i + 16 <= count; i += 16, src += 48, dst += 64) {
+            __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src));
+            __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 16));
+            __m128i c = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 32));
+            __m128i *out = reinterpret_cast<__m128i*>(dst);
+            _mm_storeu_si128(out, _mm_or_si128(_mm_shuffle_epi8(a, mask), opaque));
+            _mm_storeu_si128(out + 1, _mm_or_si128(_mm_shuffle_epi8(_mm_alignr_epi8(b, a, 12), mask), opaque));
+            _mm_storeu_si128(out + 2, _mm_or_si128(_mm_shuffle_epi8(_mm_alignr_epi8(c, b, 8), mask), opaque));
+            _mm_storeu_si128(out + 3, _mm_or_si128(_mm_shuffle_epi8(_mm_srli_si128(c, 4), mask), opaque));
+        }
+    } else if (channels == 1) {
+        const __m128i masks[4] = {expandMask(1, 0), expandMask(1, 1), expandMask(1, 2), expandMask(1, 3)};
+        for (; i + 16 <= count; i += 16, src += 16, dst += 64) {
+            __m128i in = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src));
+            __m128i *out = reinterpret_cast<__m128i*>(dst);
+            for (int g = 0; g < 4; ++g)
+                _mm_storeu_si128(out + g, _mm_or_si128(_mm_shuffle_epi8(in, masks[g]), opaque));
+        }
+    } else if (channels == 2) {
+        const __m128i m0 = expandMask(2, 0), m1 = expandMask(2, 1);
+        for (; i + 8 <= count; i += 8, src += 16, dst += 32) {
+            __m128i in = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src));
+            __m128i *out = reinterpret_cast<__m128i*>(dst);
+            _mm_storeu_si128(out, _mm_shuffle_epi8(in, m0));
+            _mm_storeu_si128(out + 1, _mm_shuffle_epi8(in, m1));
+        }
+    } else {
+        std::memcpy(dst, src, count * 4);
+        return;
+    }
+    expandToRGBAScalar(src, dst, count - i, channels);
+}
+
+__attribute__((target("ssse3")))
+void flipRowsSsse3(uint8_t *pixels, int height, size_t rowBytes) {
+    for (int y = 0; y < height / 2; ++y) {
+        uint8_t *top = pixels + y * rowBytes, *bottom = pixels + (height - 1 - y) * rowBytes;
+        size_t i = 0;
+        for (; i + 16 <= rowBytes; i += 16) {
+            __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(top + i));
+            __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(bottom + i));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(top + i), b);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(bottom + i), a);
+        }
+        for (; i < rowBytes; ++i)
+            std::swap(top[i], bottom[i]);
+    }
+}
+
+__attribute__((target("ssse3")))
+void swizzleRGBASsse3(const uint8_t *src, uint8_t *dst, size_t count, const uint8_t order[4]) {
+    alignas(16) int8_t mask[16];
+    for (int i = 0; i < 16; ++i)
+        mask[i] = int8_t(i / 4 * 4 + order[i % 4]);
+    const __m128i shuffle = _mm_load_si128(reinterpret_cast<const __m128i*>(mask));
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4, src += 16, dst += 16)
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst), _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src)), shuffle));
+    swizzleRGBAScalar(src, dst, count - i, order);
+}
+
+__attribute__((target("ssse3")))
+void premultiplyAlphaSsse3(uint8_t *pixels, size_t count) {
+    // alpha of each pixel spread over its color channels as 16 bit lanes, and 255 for the alpha lane itself,
+    // which mulDiv255 leaves alone
+    const __m128i alphaLow = _mm_setr_epi8(3, -1, 3, -1, 3, -1, -1, -1, 7, -1, 7, -1, 7, -1, -1, -1);
+    const __m128i alphaHigh = _mm_setr_epi8(11, -1, 11, -1, 11, -1, -1, -1, 15, -1, 15, -1, 15, -1, -1, -1);
+    const __m128i alphaLane = _mm_setr_epi16(0, 0, 0, 255, 0, 0, 0, 255);
+    const __m128i zero = _mm_setzero_si128(), half = _mm_set1_epi16(128);
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4, pixels += 16) {
+        __m128i px = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pixels));
+        __m128i lo = _mm_unpacklo_epi8(px, zero), hi = _mm_unpackhi_epi8(px, zero);
+        lo = _mm_add_epi16(_mm_mullo_epi16(lo, _mm_or_si128(_mm_shuffle_epi8(px, alphaLow), alphaLane)), half);
+        hi = _mm_add_epi16(_mm_mullo_epi16(hi, _mm_or_si128(_mm_shuffle_epi8(px, alphaHigh), alphaLane)), half);
+        lo = _mm_srli_epi16(_mm_add_epi16(lo, _mm_srli_epi16(lo, 8)), 8);
+        hi = _mm_srli_epi16(_mm_add_epi16(hi, _mm_srli_epi16(hi, 8)), 8);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(pixels), _mm_packus_epi16(lo, hi));
+    }
+    premultiplyAlphaScalar(pixels, count - i);
+}
+
+__attribute__((target("avx2")))
+void srgbToLinearAvx2(const uint8_t *src, float *dst, size_t count) {
+    const __m256 toUnit = _mm256_set1_ps(1.f / 255.f);
+    size_t i = 0;
+    // two pixels per 8 lanes, the alpha lanes are blended in from a plain conversion
+    for (; i + 2 <= count; i += 2, src += 8, dst += 8) {
+        __m256i bytes = _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(src)));
+        __m256 color = _mm256_i32gather_ps(srgbDecodeTable.values, bytes, 4);
+        __m256 alpha = _mm256_mul_ps(_mm256_cvtepi32_ps(bytes), toUnit);
+        _mm256_storeu_ps(dst, _mm256_blend_ps(color, alpha, 0x88));
+    }
+    srgbToLinearScalar(src, dst, count - i);
+}
+
+__attribute__((target("avx2")))
+void linearToSrgbAvx2(const float *src, uint8_t *dst, size_t count) {
+    const __m256 almostOne = _mm256_castsi256_ps(_mm256_set1_epi32(SrgbEncodeTable::ALMOST_ONE_BITS));
+    const __m256i minBits = _mm256_set1_epi32(SrgbEncodeTable::MIN_BITS);
+    const __m256 zero = _mm256_setzero_ps(), one = _mm256_set1_ps(1.f), scale = _mm256_set1_ps(255.f), half = _mm256_set1_ps(.5f);
+    const __m256i low16 = _mm256_set1_epi32(0xffff), low8 = _mm256_set1_epi32(0xff);
+    // the low byte of every lane to the bottom of its 128 bit half
+    const __m256i gatherBytes = _mm256_setr_epi8(0, 4, 8, 12, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+                                                 0, 4, 8, 12, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1);
+    size_t i = 0;
+    for (; i + 2 <= count; i += 2, src += 8, dst += 8) {
+        __m256 l = _mm256_loadu_ps(src);
+        // maxps gives the second operand for NaN, like the scalar version
+        __m256 clamped = _mm256_min_ps(_mm256_max_ps(l, _mm256_castsi256_ps(minBits)), almostOne);
+        __m256i bits = _mm256_castps_si256(clamped);
+        __m256i piece = _mm256_i32gather_epi32(reinterpret_cast<const int*>(srgbEncodeTable.pieces), _mm256_srli_epi32(_mm256_sub_epi32(bits, minBits), 20), 4);
+        __m256i bias = _mm256_slli_epi32(_mm256_srli_epi32(piece, 16), 9);
+        __m256i t = _mm256_and_si256(_mm256_srli_epi32(bits, 12), low8);
+        __m256i color = _mm256_srli_epi32(_mm256_add_epi32(bias, _mm256_mullo_epi32(_mm256_and_si256(piece, low16), t)), 16);
+        __m256 a = _mm256_min_ps(_mm256_max_ps(l, zero), one);
+        __m256i alpha = _mm256_cvttps_epi32(_mm256_add_ps(_mm256_mul_ps(a, scale), half));
+        __m256i packed = _mm256_shuffle_epi8(_mm256_blend_epi32(color, alpha, 0x88), gatherBytes);
+        uint32_t first = uint32_t(_mm256_cvtsi256_si32(packed)), second = uint32_t(_mm_cvtsi128_si32(_mm256_extracti128_si256(packed, 1)));
+        std::memcpy(dst, &first, 4);
+        std::memcpy(dst + 4, &second, 4);
+    }
+    linearToSrgbScalar(src, dst, count - i);
+}
+#endif
+
+
+// what the texture loading goes through, the fastest versions this CPU can run
+struct PixelKernels {
+    void (*expandToRGBA)(const uint8_t *src, uint8_t *dst, size_t count, int channels) = expandToRGBAScalar;
+    void (*flipRows)(uint8_t *pixels, int height, size_t rowBytes) = flipRowsScalar;
+    void (*swizzleRGBA)(const uint8_t *src, uint8_t *dst, size_t count, const uint8_t order[4]) = swizzleRGBAScalar;
+    void (*premultiplyAlpha)(uint8_t *pixels, size_t count) = premultiplyAlphaScalar;
+    void (*srgbToLinear)(const uint8_t *src, float *dst, size_t count) = srgbToLinearScalar;
+    void (*linearToSrgb)(const float *src, uint8_t *dst, size_t count) = linearToSrgbScalar;
+    std::string name = "scalar";
+};
+
+PixelKernels scalarPixelKernels() {
+    return PixelKernels();
+}
+
+PixelKernels bestPixelKernels() {
+    PixelKernels kernels;
+#ifdef PIXEL_KERNELS_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("ssse3")) {
+        kernels.expandToRGBA = expandToRGBASsse3;
+        kernels.flipRows = flipRowsSsse3;
+        kernels.swizzleRGBA = swizzleRGBASsse3;
+        kernels.premultiplyAlpha = premultiplyAlphaSsse3;
+        kernels.name = "ssse3";
+    }
+    if (__builtin_cpu_supports("avx2")) {
+        kernels.srgbToLinear = srgbToLinearAvx2;
+        kernels.linearToSrgb = linearToSrgbAvx2;
+        kernels.name += "+avx2";
+    }
+#endif
+    return kernels;
+}
+
+PixelKernels pixelKernels;
+
+
+// the biggest GL_UNPACK_ALIGNMENT the rows of an image satisfy. GL's default is 4, which is wrong for any
+// 1, 2 or 3 channel image whose row isn't a multiple of 4 bytes, and the texture comes out sheared
+GLint unpackAlignment(const void *pixels, size_t rowBytes) {
+    uintptr_t bits = reinterpret_cast<uintptr_t>(pixels) | rowBytes;
+    for (GLint alignment : {8, 4, 2})
+        if (bits % alignment == 0)
+            return alignment;
+    return 1;
+}
+
+
+class Texture2D {
+    GLuint tex_id;
+public:
+    // stb gives the rows top first with however many channels the file has. they are flipped to bottom first
+    // and, unless convert is off, made into RGBA8 on the CPU. with it off the channels are uploaded as they are
+    // and it's the unpack alignment that has to be right
+    void generate2DTex(const char *image_path, bool convert = true, bool premultiply = false) {
+        int width, height, nChannels;
+        stbi_set_flip_vertically_on_load(false);
+        uint8_t *raw_image = stbi_load(image_path, &width, &height, &nChannels, 0);
+        if (!raw_image) {
+            std::cerr << "ERROR::TEXTURE - can't load " << image_path << "\n";
+            return;
+        }
+        const size_t count = size_t(width) * height;
+        uint8_t *pixels = raw_image;
+        std::vector<uint8_t> rgba;
+        int channels = nChannels;
+        if (convert && nChannels != 4) {
+            rgba.resize(count * 4);
+            pixelKernels.expandToRGBA(raw_image, rgba.data(), count, nChannels);
+            pixels = rgba.data();
+            channels = 4;
+        }
+        pixelKernels.flipRows(pixels, height, size_t(width) * channels);
+        if (premultiply && channels == 4)
+            pixelKernels.premultiplyAlpha(pixels, count);
+
+        float borderColor[] = {1.f, 1.f, 1.f, 1.f};
+        glGenTextures(1, &tex_id);
+        glBindTexture(GL_TEXTURE_2D, tex_id);
+        // what to do when primitive is bigger than the texture
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_BORDER);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_BORDER);
+        glTexParameterfv(GL_TEXTURE_2D, GL_TEXTURE_BORDER_COLOR, borderColor);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        static const GLenum formats[] = {GL_RED, GL_RG, GL_RGB, GL_RGBA};
+        static const GLenum internalFormats[] = {GL_R8, GL_RG8, GL_RGB8, GL_RGBA8};
+        if (channels <= 2) {
+            // grey, or grey and alpha, read as such by the shader
+            GLint swizzle[] = {GL_RED, GL_RED, GL_RED, channels == 2 ? GL_GREEN : GL_ONE};
+            glTexParameteriv(GL_TEXTURE_2D, GL_TEXTURE_SWIZZLE_RGBA, swizzle);
+        }
+        glPixelStorei(GL_UNPACK_ALIGNMENT, unpackAlignment(pixels, size_t(width) * channels));
+        // glTexImage2D(TARGET_TYPE, IM_MIPMAP_LEVEL, TARGET_NRCHANNELS, SRC_WIDTH, SRC_HEIGHT, LEGACY_0, SRC_NRCHANNELS, SRC_DATA_TYPE, SRC_DATA);
+        glTexImage2D(GL_TEXTURE_2D, 0, internalFormats[channels - 1], width, height, 0, formats[channels - 1], GL_UNSIGNED_BYTE, pixels);
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+        stbi_image_free(raw_image);
+    }
+    void bind() {
+        glBindTexture(GL_TEXTURE_2D, tex_id);
+    }
+};
+
+
+// ---------------------------------------------------------------------------------------------------------
+// --bench: every kernel, scalar against SIMD, on the same random image. the outputs are compared byte for
+// byte, over the whole image and over short runs that end in the scalar tails
+// ---------------------------------------------------------------------------------------------------------
+
+template <typename Run>
+double bestMs(int repeats, Run run) {
+    double best = 1e30;
+    for (int r = 0; r < repeats; ++r) {
+        auto start = std::chrono::steady_clock::now();
+        run();
+        best = std::min(best, std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+    }
+    return best;
+}
+
+struct KernelReport {
+    const char *name;
+    double scalarMs, simdMs;
+    size_t bytes;       // read and written by one run
+    size_t mismatches;  // bytes that differ
+};
+
+void printReport(const KernelReport &r) {
+    std::printf("%-22s scalar %8.1f MB/s  simd %8.1f MB/s  x%5.2f  %s\n", r.name, r.bytes / r.scalarMs / 1e3,
+                r.bytes / r.simdMs / 1e3, r.scalarMs / r.simdMs, r.mismatches ? "MISMATCH" : "bit exact");
+    if (r.mismatches)
+        std::printf("%-22s %zu bytes differ\n", "", r.mismatches);
+}
+
+size_t countMismatches(const void *a, const void *b, size_t bytes) {
+    const uint8_t *x = static_cast<const uint8_t*>(a), *y = static_cast<const uint8_t*>(b);
+    size_t n = 0;
+    for (size_t i = 0; i < bytes; ++i)
+        n += x[i] != y[i];
+    return n;
+}
+
+int runBench(int side) {
+    const PixelKernels scalar = scalarPixelKernels(), simd = bestPixelKernels();
+    const size_t count = size_t(side) * side;
+    const int repeats = 10;
+    std::printf("%dx%d pixels, %s kernels against scalar, best of %d\n", side, side, simd.name.c_str(), repeats);
+
+    std::mt19937 rng(42);
+    std::vector<uint8_t> bytes(count * 4 + 64);
+    for (uint8_t &b : bytes)
+        b = uint8_t(rng());
+    // mostly in range, a bit outside it on both ends, and the odd NaN and infinity
+    std::vector<float> linear(count * 4 + 16);
+    std::uniform_real_distribution<float> unit(-0.05f, 1.05f);
+    for (float &f : linear)
+        f = unit(rng);
+    for (size_t i = 0; i < linear.size(); i += 997)
+        linear[i] = (i / 997) % 3 == 0 ? NAN : (i / 997) % 3 == 1 ? INFINITY : -INFINITY;
+    // plus every float between 0 and 1 that the encoder can tell apart, once
+    for (uint32_t i = 0; i < 104 * 256 && i < count * 4; ++i) {
+        uint32_t bits = SrgbEncodeTable::MIN_BITS + (i << 12);
+        std::memcpy(&linear[i], &bits, 4);
+    }
+
+    std::vector<uint8_t> outA(count * 4), outB(count * 4);
+    std::vector<float> floatA(count * 4), floatB(count * 4);
+    // short runs to get every tail length, compared as they go
+    const size_t SHORT = 67;
+    auto tails = [&](auto runScalar, auto runSimd, size_t outBytes) {
+        size_t n = 0;
+        for (size_t len = 1; len <= SHORT; ++len) {
+            std::fill(outA.begin(), outA.begin() + SHORT * outBytes, 0);
+            std::fill(outB.begin(), outB.begin() + SHORT * outBytes, 0);
+            runScalar(len);
+            runSimd(len);
+            n += countMismatches(outA.data(), outB.data(), SHORT * outBytes);
+        }
+        return n;
+    };
+    std::vector<KernelReport> reports;
+    bool exact = true;
+
+    for (int channels = 1; channels <= 3; ++channels) {
+        static const char *names[] = {"grey to rgba", "grey alpha to rgba", "rgb to rgba"};
+        KernelReport r = {names[channels - 1], 0., 0., count * (channels + 4), 0};
+        r.scalarMs = bestMs(repeats, [&] { scalar.expandToRGBA(bytes.data(), outA.data(), count, channels); });
+        r.simdMs = bestMs(repeats, [&] { simd.expandToRGBA(bytes.data(), outB.data(), count, channels); });
+        r.mismatches = countMismatches(outA.data(), outB.data(), count * 4);
+        r.mismatches += tails([&](size_t n) { scalar.expandToRGBA(bytes.data(), outA.data(), n, channels); },
+                              [&](size_t n) { simd.expandToRGBA(bytes.data(), outB.data(), n, channels); }, 4);
+        reports.push_back(r);
+    }
+    {
+        KernelReport r = {"flip rows", 0., 0., count * 8, 0};
+        std::copy(bytes.begin(), bytes.begin() + count * 4, outA.begin());
+        std::copy(bytes.begin(), bytes.begin() + count * 4, outB.begin());
+        // an odd number of flips, so both end up flipped
+        r.scalarMs = bestMs(repeats + 1, [&] { scalar.flipRows(outA.data(), side, size_t(side) * 4); });
+        r.simdMs = bestMs(repeats + 1, [&] { simd.flipRows(outB.data(), side, size_t(side) * 4); });
+        r.mismatches = countMismatches(outA.data(), outB.data(), count * 4);
+        // rows that aren't a multiple of 16 bytes, like an RGB image's
+        for (size_t rowBytes = 1; rowBytes <= 50; rowBytes += 7) {
+            std::copy(bytes.begin(), bytes.begin() + rowBytes * 5, outA.begin());
+            std::copy(bytes.begin(), bytes.begin() + rowBytes * 5, outB.begin());
+            scalar.flipRows(outA.data(), 5, rowBytes);
+            simd.flipRows(outB.data(), 5, rowBytes);
+            r.mismatches += countMismatches(outA.data(), outB.data(), rowBytes * 5);
+        }
+        reports.push_back(r);
+    }
+    {
+        const uint8_t bgra[4] = {2, 1, 0, 3};
+        KernelReport r = {"swizzle bgra", 0., 0., count * 8, 0};
+        r.scalarMs = bestMs(repeats, [&] { scalar.swizzleRGBA(bytes.data(), outA.data(), count, bgra); });
+        r.simdMs = bestMs(repeats, [&] { simd.swizzleRGBA(bytes.data(), outB.data(), count, bgra); });
+        r.mismatches = countMismatches(outA.data(), outB.data(), count * 4);
+        const uint8_t abgr[4] = {3, 2, 1, 0};
+        r.mismatches += tails([&](size_t n) { scalar.swizzleRGBA(bytes.data(), outA.data(), n, abgr); },
+                              [&](size_t n) { simd.swizzleRGBA(bytes.data(), outB.data(), n, abgr); }, 4);
+        reports.push_back(r);
+    }
+    {
+        KernelReport r = {"premultiply alpha", 0., 0., count * 8, 0};
+        // in place, so every run starts over from a copy. the copy is timed in both
+        r.scalarMs = bestMs(repeats, [&] {
+            std::memcpy(outA.data(), bytes.data(), count * 4);
+            scalar.premultiplyAlpha(outA.data(), count);
+        });
+        r.simdMs = bestMs(repeats, [&] {
+            std::memcpy(outB.data(), bytes.data(), count * 4);
+            simd.premultiplyAlpha(outB.data(), count);
+        });
+        r.mismatches = countMismatches(outA.data(), outB.data(), count * 4);
+        r.mismatches += tails([&](size_t n) { std::memcpy(outA.data(), bytes.data(), n * 4); scalar.premultiplyAlpha(outA.data(), n); },
+                              [&](size_t n) { std::memcpy(outB.data(), bytes.data(), n * 4); simd.premultiplyAlpha(outB.data(), n); }, 4);
+        // and it has to actually be round(c * a / 255)
+        for (uint32_t c = 0; c < 256; ++c)
+            for (uint32_t a = 0; a < 256; ++a)
+                if (mulDiv255(c, a) != (c * a * 2 + 255) / 510)
+                    ++r.mismatches;
+        reports.push_back(r);
+    }
+    {
+        KernelReport r = {"srgb to linear", 0., 0., count * 20, 0};
+        r.scalarMs = bestMs(repeats, [&] { scalar.srgbToLinear(bytes.data(), floatA.data(), count); });
+        r.simdMs = bestMs(repeats, [&] { simd.srgbToLinear(bytes.data(), floatB.data(), count); });
+        r.mismatches = countMismatches(floatA.data(), floatB.data(), count * 16);
+        for (size_t len = 1; len <= SHORT; ++len) {
+            std::fill(floatA.begin(), floatA.begin() + SHORT * 4, 0.f);
+            std::fill(floatB.begin(), floatB.begin() + SHORT * 4, 0.f);
+            scalar.srgbToLinear(bytes.data(), floatA.data(), len);
+            simd.srgbToLinear(bytes.data(), floatB.data(), len);
+            r.mismatches += countMismatches(floatA.data(), floatB.data(), SHORT * 16);
+        }
+        reports.push_back(r);
+    }
+    {
+        KernelReport r = {"linear to srgb", 0., 0., count * 20, 0};
+        r.scalarMs = bestMs(repeats, [&] { scalar.linearToSrgb(linear.data(), outA.data(), count); });
+        r.simdMs = bestMs(repeats, [&] { simd.linearToSrgb(linear.data(), outB.data(), count); });
+        r.mismatches = countMismatches(outA.data(), outB.data(), count * 4);
+        r.mismatches += tails([&](size_t n) { scalar.linearToSrgb(linear.data(), outA.data(), n); },
+                              [&](size_t n) { simd.linearToSrgb(linear.data(), outB.data(), n); }, 4);
+        reports.push_back(r);
+    }
+    for (const KernelReport &r : reports) {
+        printReport(r);
+        exact = exact && !r.mismatches;
+    }
+
+    // how far the encoder is from the exact curve, and whether every byte survives the round trip
+    int worst = 0;
+    size_t off = 0, samples = 0, roundTrip = 0;
+    for (uint32_t i = 0; i <= 1 << 20; ++i, ++samples) {
+        float l = float(i) / float(1 << 20);
+        int exactByte = int(linearToSrgbExact(l) * 255.f + 0.5f);
+        int diff = std::abs(int(linearToSrgb8(l)) - exactByte);
+        worst = std::max(worst, diff);
+        off += diff != 0;
+    }
+    for (int i = 0; i < 256; ++i)
+        roundTrip += linearToSrgb8(srgbDecodeTable.values[i]) != i;
+    std::printf("linear to srgb against the exact curve: off by at most %d, %.2f%% of %zu samples not the nearest byte, "
+                "%zu of 256 bytes don't survive the round trip\n", worst, 100. * off / samples, samples, roundTrip);
+    if (!exact)
+        std::printf("SIMD and scalar kernels disagree\n");
+    return exact ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+
+void processInput(GLFWwindow *window, glm::vec3 &cameraPos, glm::vec3 &cameraFront, glm::vec3 &cameraUp)
+{
+
+    const float cameraSpeed = 0.05f; // adjust accordingly
+    if (glfwGetKey(window, GLFW_KEY_W) == GLFW_PRESS)
+        cameraPos += cameraSpeed * cameraFront;
+    if (glfwGetKey(window, GLFW_KEY_S) == GLFW_PRESS)
+        cameraPos -= cameraSpeed * cameraFront;
+    if (glfwGetKey(window, GLFW_KEY_A) == GLFW_PRESS)
+        cameraPos -= glm::normalize(glm::cross(cameraFront, cameraUp)) * cameraSpeed;
+    if (glfwGetKey(window, GLFW_KEY_D) == GLFW_PRESS)
+        cameraPos += glm::normalize(glm::cross(cameraFront, cameraUp)) * cameraSpeed;
+    if (glfwGetKey(window, GLFW_KEY_UP) == GLFW_PRESS)
+        cameraPos += glm::normalize(glm::cross(cameraFront, cameraUp)) * cameraSpeed;
+
+}
+
+// true only on the frame the key went down
+bool keyPressed(GLFWwindow *window, int key) {
+    static bool down[GLFW_KEY_LAST + 1] = {};
+    bool now = glfwGetKey(window, key) == GLFW_PRESS;
+    bool pressed = now && !down[key];
+    down[key] = now;
+    return pressed;
+}
+
+
+float yaw = -90.f;
+float pitch = 0.f;
+glm::vec3 cameraFront;
+
+void mouseMovement(GLFWwindow *window, double xPos, double yPos) {
+    static float lastX = xPos, lastY = yPos;
+    float xOffset = xPos - lastX;
+    float yOffset = lastY - yPos;
+    
+    constexpr float sensitivity = 0.05f;
+    xOffset *= sensitivity;
+    yOffset *= sensitivity;
+
+    yaw += xOffset;
+    pitch += yOffset;
+
+    if (std::abs(pitch) > 89.f) // don't ever do it this way. I am lazy
+        pitch = std::abs(pitch) / pitch * 89.f;
+
+    cameraFront.x = cos(glm::radians(yaw)) * cos(glm::radians(pitch));
+    cameraFront.y = sin(glm::radians(pitch));
+    cameraFront.z = sin(glm::radians(yaw)) * cos(glm::radians(pitch));
+
+    cameraFront = glm::normalize(cameraFront);
+    lastX = xPos, lastY = yPos;
+}
+
+
+int main(int argc, char **argv) {
+    bool convert = true, scalar = false, premultiply = false;
+    for (int i = 1; i < argc; ++i) {
+        if (!std::strcmp(argv[i], "--bench"))
+            return runBench(i + 1 < argc ? std::atoi(argv[i + 1]) : 2048);
+        if (!std::strcmp(argv[i], "--raw"))
+            convert = false;
+        else if (!std::strcmp(argv[i], "--scalar"))
+            scalar = true;
+        else if (!std::strcmp(argv[i], "--premultiply"))
+            premultiply = true;
+    }
+    pixelKernels = scalar ? scalarPixelKernels() : bestPixelKernels();
+    std::cout << "pixel kernels: " << pixelKernels.name << "\n";
+
+    if (glfwInit() != GLFW_TRUE) {
+        glfwTerminate();
+        std::cerr << "Failed to initialize GLFW";
+        return EXIT_FAILURE;
+    }
+    // setting OpenGL version to 3.3
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+    GLFWwindow *win = glfwCreateWindow(800, 600, "This is a hello window!", NULL, NULL);
+    // setting 'context' for OpenGL, i.e. where to draw on current thread
+    glfwMakeContextCurrent(win);
+    // all it does is fetches us the implemented functions of OpenGL
+    if (glewInit() != GLEW_OK) {
+        glfwTerminate();
+        std::cerr << "Failed to initialize GLEW\n";
+        return EXIT_FAILURE;
+    }
+    int screenWidth, screenHeight;
+    glfwGetFramebufferSize(win, &screenWidth, &screenHeight);
+    glViewport(0, 0, screenWidth, screenHeight);
+
+    glEnable(GL_DEPTH_TEST);
+    float triangle_data[] = {
+        //   vertpos   //  //   normal   //  //texcord//
+    -0.5f, -0.5f, -0.5f,  0.0f,  0.0f, -1.0f,  0.0f, 0.0f,
+     0.5f, -0.5f, -0.5f,  0.0f,  0.0f, -1.0f,  1.0f, 0.0f,
+     0.5f,  0.5f, -0.5f,  0.0f,  0.0f, -1.0f,  1.0f, 1.0f,
+     0.5f,  0.5f, -0.5f,  0.0f,  0.0f, -1.0f,  1.0f, 1.0f,
+    -0.5f,  0.5f, -0.5f,  0.0f,  0.0f, -1.0f,  0.0f, 1.0f,
+    -0.5f, -0.5f, -0.5f,  0.0f,  0.0f, -1.0f,  0.0f, 0.0f,
+
+    -0.5f, -0.5f,  0.5f,  0.0f,  0.0f,  1.0f,  0.0f, 0.0f,
+     0.5f, -0.5f,  0.5f,  0.0f,  0.0f,  1.0f,  1.0f, 0.0f,
+     0.5f,  0.5f,  0.5f,  0.0f,  0.0f,  1.0f,  1.0f, 1.0f,
+     0.5f,  0.5f,  0.5f,  0.0f,  0.0f,  1.0f,  1.0f, 1.0f,
+    -0.5f,  0.5f,  0.5f,  0.0f,  0.0f,  1.0f,  0.0f, 1.0f,
+    -0.5f, -0.5f,  0.5f,  0.0f,  0.0f,  1.0f,  0.0f, 0.0f,
+
+    -0.5f,  0.5f,  0.5f, -1.0f,  0.0f,  0.0f,  1.0f, 0.0f,
+    -0.5f,  0.5f, -0.5f, -1.0f,  0.0f,  0.0f,  1.0f, 1.0f,
+    -0.5f, -0.5f, -0.5f, -1.0f,  0.0f,  0.0f,  0.0f, 1.0f,
+    -0.5f, -0.5f, -0.5f, -1.0f,  0.0f,  0.0f,  0.0f, 1.0f,
+    -0.5f, -0.5f,  0.5f, -1.0f,  0.0f,  0.0f,  0.0f, 0.0f,
+    -0.5f,  0.5f,  0.5f, -1.0f,  0.0f,  0.0f,  1.0f, 0.0f,
+
+     0.5f,  0.5f,  0.5f,  1.0f,  0.0f,  0.0f,  1.0f, 0.0f,
+     0.5f,  0.5f, -0.5f,  1.0f,  0.0f,  0.0f,  1.0f, 1.0f,
+     0.5f, -0.5f, -0.5f,  1.0f,  0.0f,  0.0f,  0.0f, 1.0f,
+     0.5f, -0.5f, -0.5f,  1.0f,  0.0f,  0.0f,  0.0f, 1.0f,
+     0.5f, -0.5f,  0.5f,  1.0f,  0.0f,  0.0f,  0.0f, 0.0f,
+     0.5f,  0.5f,  0.5f,  1.0f,  0.0f,  0.0f,  1.0f, 0.0f,
+
+    -0.5f, -0.5f, -0.5f,  0.0f, -1.0f,  0.0f,  0.0f, 1.0f,
+     0.5f, -0.5f, -0.5f,  0.0f, -1.0f,  0.0f,  1.0f, 1.0f,
+     0.5f, -0.5f,  0.5f,  0.0f, -1.0f,  0.0f,  1.0f, 0.0f,
+     0.5f, -0.5f,  0.5f,  0.0f, -1.0f,  0.0f,  1.0f, 0.0f,
+    -0.5f, -0.5f,  0.5f,  0.0f, -1.0f,  0.0f,  0.0f, 0.0f,
+    -0.5f, -0.5f, -0.5f,  0.0f, -1.0f,  0.0f,  0.0f, 1.0f,
+
+    -0.5f,  0.5f, -0.5f,  0.0f,  1.0f,  0.0f,  0.0f, 1.0f,
+     0.5f,  0.5f, -0.5f,  0.0f,  1.0f,  0.0f,  1.0f, 1.0f,
+     0.5f,  0.5f,  0.5f,  0.0f,  1.0f,  0.0f,  1.0f, 0.0f,
+     0.5f,  0.5f,  0.5f,  0.0f,  1.0f,  0.0f,  1.0f, 0.0f,
+    -0.5f,  0.5f,  0.5f,  0.0f,  1.0f,  0.0f,  0.0f, 0.0f,
+    -0.5f,  0.5f, -0.5f,  0.0f,  1.0f,  0.0f,  0.0f, 1.0f
+        
+    };
+
+
+    glm::vec3 cameraPos(0.f, 0.f, 3.f);
+    cameraFront = glm::vec3(0.f,0.f,-1.f);
+    glm::vec3 cameraUp(0.,1.,0.f);
+    
+
+    auto loadStart = std::chrono::steady_clock::now();
+    Texture2D tex;
+    tex.generate2DTex("./image2d.tex", convert, premultiply);
+    tex.bind();
+    std::cout << "texture loaded in " << std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - loadStart).count()
+              << "ms, " << (convert ? "converted to rgba8" : "uploaded as decoded") << "\n";
+    if (premultiply) {
+        // premultiplied colors blend with ONE instead of SRC_ALPHA
+        glEnable(GL_BLEND);
+        glBlendFunc(GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
+    }
+
+    GLuint vbo = 0;
+    glGenBuffers(1, &vbo); 
+    glBindBuffer(GL_ARRAY_BUFFER, vbo);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(triangle_data), triangle_data, GL_STATIC_DRAW);
+
+    GLuint vao = 0;
+    glGenVertexArrays(1, &vao);
+    glBindVertexArray(vao);
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)0);
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)(6 * sizeof(float)));
+    glEnableVertexAttribArray(1);
+    glVertexAttribPointer(2, 3, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)(3 * sizeof(float)));
+    glEnableVertexAttribArray(2);
+
+    VertexShader vs;
+    FragmentShader fs;
+    vs.setSource("./vertex.glsl");
+    fs.setSource("./frag.glsl");
+    Program prog;
+    prog.AttachShaders({&vs, &fs});
+
+    prog.UseProgram();
+    prog.setInt("tex", 0);
+
+    glm::mat4 view; // = glm::translate(glm::mat4(1.f), glm::vec3(0.f,0.f,-3.f));
+       
+
+    glm::mat4 proj = glm::perspective(glm::radians(45.f), float(screenWidth) / screenHeight, 0.1f, 100.f);
+
+    prog.setMat4("proj", proj);
+    prog.setMat4("view", view);
+
+    glfwSetCursorPosCallback(win, mouseMovement); 
+    glfwSetInputMode(win, GLFW_CURSOR, GLFW_CURSOR_DISABLED);  
+    
+    while (!glfwWindowShouldClose(win)) {
+        processInput(win, cameraPos, cameraFront, cameraUp);
+        view = glm::lookAt(cameraPos, cameraFront + cameraPos, cameraUp);
+
+        prog.UseProgram();
+        prog.setMat4("view", view);
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+        glBindVertexArray(vao);
+        tex.bind();
+        prog.setMat4("model", glm::rotate(glm::mat4(1.f), float(glfwGetTime()), glm::vec3(0.5f, 1.f, 0.f)));
+        glDrawArrays(GL_TRIANGLES, 0, 36);
+
+        // polls different kinds of events, for example, when we close an application, it fetches that event
+        // or it fetches events like movement of the window.
+        // Without it you can neither move the window or close the window
+        glfwPollEvents();
+        // have you drawn the image, it is stored in the buffer. You can now swap this buffer with main buffer
+        // so the image appears
+        glfwSwapBuffers(win);
+    }
+    glfwTerminate();
+    
+    std::cout << "Window should close now!\n";
+
+    return EXIT_SUCCESS;
+
+}
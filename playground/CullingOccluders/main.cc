@@ -0,0 +1,822 @@
+#include <GL/glew.h>
+
+#include <GLFW/glfw3.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <vector>
+#include <glm/ext/matrix_clip_space.hpp>
+#include <glm/ext/matrix_transform.hpp>
+#include <glm/geometric.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/ext/matrix_float4x4.hpp>
+#include <glm/gtc/type_ptr.hpp>
+#include <glm/glm.hpp>
+#include <glm/trigonometric.hpp>
+#define STB_IMAGE_IMPLEMENTATION
+#include <stb/stb_image.h>
+#include <iostream>
+
+class Shader {
+    std::string src; 
+protected:
+    const char *getsrc() {
+        return src.data();
+    }
+    GLuint shader_id = 0;
+    bool isCompiled = false;
+protected:
+    virtual const char *getClassName() = 0;
+    GLint getCompilationStatus(GLuint shader_id) {
+        int status;
+        glGetShaderiv(shader_id, GL_COMPILE_STATUS, &status);
+        return status;
+    }
+    void sendError() {
+        char buffer[1024];
+        glGetShaderInfoLog(shader_id, 1024, NULL, buffer);
+        std::cerr << "ERROR::" << getClassName() << " - " << buffer;
+    }
+public:
+    virtual void compile() = 0;
+    void setSource(const char *s) {
+        std::ifstream sourceFile(s);
+        if (!sourceFile.is_open())
+            return;
+        char buffer[8192];
+        while (sourceFile.read(buffer, 8192)) {
+            src.append(buffer, 8192);
+        }
+        if (!sourceFile.eof()) {
+            src.clear();
+            return;
+        }
+        src.append(buffer, sourceFile.gcount());
+    }
+    friend class Program;
+};
+
+
+class VertexShader : public Shader {
+    virtual const char *getClassName() override {
+        return "VertexShader";
+    }
+public:
+    virtual void compile() override {
+        if (shader_id)
+            glDeleteShader(shader_id);
+        shader_id = glCreateShader(GL_VERTEX_SHADER);
+        const char *src = getsrc();
+        glShaderSource(shader_id, 1, &src, NULL);
+        glCompileShader(shader_id);
+        if (!getCompilationStatus(shader_id)) {
+            sendError();
+        }
+        isCompiled = true;
+    }
+};
+
+class FragmentShader : public Shader {
+    const char *getClassName() override {
+        return "FragmentShader";
+    }
+public:
+    virtual void compile() override {
+        if (shader_id)
+            glDeleteShader(shader_id);
+        shader_id = glCreateShader(GL_FRAGMENT_SHADER);
+        const char *src = getsrc();
+        glShaderSource(shader_id, 1, &src, NULL);
+        glCompileShader(shader_id);
+        if (!getCompilationStatus(shader_id)) {
+            sendError();
+        }
+        isCompiled = true;
+    }
+};
+
+
+class Program {
+    GLuint program_id = 0;
+    void sendError() {
+        char buffer[1024];
+        glGetProgramInfoLog(program_id, 1024, NULL, buffer);
+        std::cerr << "ERROR::PROGRAM: " << " - " << buffer;
+    }
+    bool linkStatus() {
+        int status = 0;
+        glGetProgramiv(program_id, GL_LINK_STATUS, &status);
+        return status;
+    }
+public:
+    Program() {
+        program_id = glCreateProgram();
+    }
+    ~Program() {
+        glDeleteProgram(program_id);
+    }
+    void AttachShaders(std::initializer_list<Shader*> shaders) {
+        auto i = shaders.begin();
+        while (i != shaders.end()) {
+            if (!(*i)->isCompiled)
+                (*i)->compile();
+            glAttachShader(program_id, (*i)->shader_id);
+            ++i;
+        }
+        glLinkProgram(program_id);
+        if (!linkStatus()) {
+            sendError();
+        }
+    }
+    void UseProgram() {
+        glUseProgram(program_id);
+    }
+    void setMat4(const char *locName, const glm::mat4 &mat) {
+        int location = glGetUniformLocation(program_id, locName);
+        if (location == -1)
+            return;
+        glUniformMatrix4fv(location, 1, GL_FALSE, glm::value_ptr(mat));
+    }
+};
+
+
+class Texture2D {
+    GLuint tex_id;
+public:
+    void generate2DTex(const char *image_path) {
+        int width, height, nChannels;
+        stbi_set_flip_vertically_on_load(true);
+        uint8_t *raw_image = stbi_load(image_path, &width, &height, &nChannels, 0);
+        float borderColor[] = {1.f, 1.f, 1.f, 1.f};
+        glGenTextures(1, &tex_id);
+        glBindTexture(GL_TEXTURE_2D, tex_id);
+        // what to do when primitive is bigger than the texture
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_BORDER);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_BORDER);
+        glTexParameterfv(GL_TEXTURE_2D, GL_TEXTURE_BORDER_COLOR, borderColor);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        // glTexImage2D(TARGET_TYPE, IM_MIPMAP_LEVEL, TARGET_NRCHANNELS, SRC_WIDTH, SRC_HEIGHT, LEGACY_0, SRC_NRCHANNELS, SRC_DATA_TYPE, SRC_DATA);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, width, height, 0, GL_RGB, GL_UNSIGNED_BYTE, raw_image);
+        stbi_image_free(raw_image);
+    }
+    void bind() {
+        glBindTexture(GL_TEXTURE_2D, tex_id);
+    }
+};
+
+
+// a handful of threads that split loops between them, the calling thread helps out
+class WorkerPool {
+    std::vector<std::thread> threads;
+    std::mutex mutex;
+    std::condition_variable wake, finished;
+    const std::function<void(size_t, size_t)> *job = nullptr;
+    size_t jobCount = 0;
+    size_t jobChunk = 1;
+    std::atomic<size_t> next{0};
+    int busy = 0;
+    uint64_t generation = 0;
+    bool quit = false;
+
+    void work() {
+        size_t begin;
+        while ((begin = next.fetch_add(jobChunk)) < jobCount)
+            (*job)(begin, std::min(begin + jobChunk, jobCount));
+    }
+public:
+    explicit WorkerPool(unsigned count = std::thread::hardware_concurrency()) {
+        for (unsigned i = 1; i < std::max(count, 1u); ++i) {
+            threads.emplace_back([this] {
+                uint64_t seen = 0;
+                std::unique_lock<std::mutex> lock(mutex);
+                while (true) {
+                    wake.wait(lock, [&] { return quit || generation != seen; });
+                    if (quit)
+                        return;
+                    seen = generation;
+                    lock.unlock();
+                    work();
+                    lock.lock();
+                    if (--busy == 0)
+                        finished.notify_one();
+                }
+            });
+        }
+    }
+    ~WorkerPool() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            quit = true;
+        }
+        wake.notify_all();
+        for (std::thread &t : threads)
+            t.join();
+    }
+    size_t size() const {
+        return threads.size() + 1;
+    }
+    // calls fn(begin, end) on ranges of at most chunk items until [0, count) is covered, returns when all are done
+    void parallelFor(size_t count, size_t chunk, const std::function<void(size_t, size_t)> &fn) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            job = &fn;
+            jobCount = count;
+            jobChunk = std::max<size_t>(chunk, 1);
+            next = 0;
+            busy = threads.size();
+            ++generation;
+        }
+        wake.notify_all();
+        work();
+        std::unique_lock<std::mutex> lock(mutex);
+        finished.wait(lock, [&] { return busy == 0; });
+    }
+};
+
+
+struct AABB {
+    glm::vec3 min;
+    glm::vec3 max;
+};
+
+// triangles of a box, counter clockwise seen from outside
+const uint8_t BOX_INDICES[36] = {
+    0, 2, 1,  1, 2, 3,   // -z
+    4, 5, 6,  5, 7, 6,   // +z
+    0, 1, 4,  1, 5, 4,   // -y
+    2, 6, 3,  3, 6, 7,   // +y
+    0, 4, 2,  2, 4, 6,   // -x
+    1, 3, 5,  3, 7, 5    // +x
+};
+
+glm::vec3 boxCorner(const AABB &box, int corner) {
+    return glm::vec3(corner & 1 ? box.max.x : box.min.x,
+                     corner & 2 ? box.max.y : box.min.y,
+                     corner & 4 ? box.max.z : box.min.z);
+}
+
+
+// gcc vector types, same trick as the transform kernels: the rasterizer is written once and
+// compiled for 4 wide SSE (always there on x86-64) and 8 wide AVX2, picked at runtime
+#pragma GCC diagnostic ignored "-Wpsabi"
+typedef float f32x4 __attribute__((vector_size(16)));
+typedef float f32x8 __attribute__((vector_size(32)));
+
+#define RASTER_INLINE __attribute__((always_inline)) inline
+
+template <typename V>
+RASTER_INLINE V laneOffsets() {
+    V v;
+    for (size_t i = 0; i < sizeof(V) / sizeof(float); ++i)
+        v[i] = float(i);
+    return v;
+}
+
+struct ScreenTriangle {
+    float x[3], y[3], z[3];
+    int minY, maxY;
+};
+
+// low resolution depth buffer for occlusion tests. depth is z/w remapped to [0, 1], 1 is the far plane.
+// every TILE x TILE tile also keeps the nearest and farthest depth in it, so most tests never look at pixels
+class OcclusionBuffer {
+public:
+    static constexpr int WIDTH = 320;
+    static constexpr int HEIGHT = 240;
+    static constexpr int TILE = 8;
+    static constexpr int TILES_X = WIDTH / TILE;
+    static constexpr int TILES_Y = HEIGHT / TILE;
+    // an occluder box makes at most 12 triangles, twice that if the near plane cuts them
+    static constexpr int MAX_TRIANGLES_PER_OCCLUDER = 24;
+private:
+    std::vector<float> depth = std::vector<float>(WIDTH * HEIGHT, 1.f);
+    std::vector<float> tileMin = std::vector<float>(TILES_X * TILES_Y, 1.f);
+    std::vector<float> tileMax = std::vector<float>(TILES_X * TILES_Y, 1.f);
+    std::vector<ScreenTriangle> triangles;
+    std::vector<int> triangleCounts;
+    void (*rasterizeRows)(OcclusionBuffer &buffer, int rowBegin, int rowEnd);
+
+    template <typename V>
+    RASTER_INLINE static void rasterize(OcclusionBuffer &buffer, int rowBegin, int rowEnd);
+    static void rasterizeSSE(OcclusionBuffer &buffer, int rowBegin, int rowEnd);
+    static void rasterizeAVX2(OcclusionBuffer &buffer, int rowBegin, int rowEnd);
+
+    void setupOccluder(const glm::mat4 &viewProj, const AABB &box, ScreenTriangle *out, int &count);
+public:
+    OcclusionBuffer() {
+        __builtin_cpu_init();
+        rasterizeRows = __builtin_cpu_supports("avx2") ? rasterizeAVX2 : rasterizeSSE;
+    }
+    void render(const glm::mat4 &viewProj, const std::vector<AABB> &occluders, WorkerPool &pool);
+    bool isVisible(const glm::mat4 &viewProj, const AABB &box) const;
+};
+
+// clip space triangle against the near plane (w > epsilon, close enough to z > -w for culling),
+// then to screen space. we keep pixel centers at +0.5, y goes up like in NDC
+void OcclusionBuffer::setupOccluder(const glm::mat4 &viewProj, const AABB &box, ScreenTriangle *out, int &count) {
+    constexpr float NEAR_W = 1e-3f;
+    glm::vec4 clip[8];
+    for (int c = 0; c < 8; ++c)
+        clip[c] = viewProj * glm::vec4(boxCorner(box, c), 1.f);
+    count = 0;
+    auto emit = [&](const glm::vec4 &a, const glm::vec4 &b, const glm::vec4 &c) {
+        ScreenTriangle &t = out[count];
+        const glm::vec4 *v[3] = {&a, &b, &c};
+        float minY = HEIGHT, maxY = 0.f;
+        for (int i = 0; i < 3; ++i) {
+            t.x[i] = (v[i]->x / v[i]->w * 0.5f + 0.5f) * WIDTH;
+            t.y[i] = (v[i]->y / v[i]->w * 0.5f + 0.5f) * HEIGHT;
+            t.z[i] = v[i]->z / v[i]->w * 0.5f + 0.5f;
+            minY = std::min(minY, t.y[i]);
+            maxY = std::max(maxY, t.y[i]);
+        }
+        // back facing or degenerate, the front of the box covers it anyway
+        float area = (t.x[1] - t.x[0]) * (t.y[2] - t.y[0]) - (t.x[2] - t.x[0]) * (t.y[1] - t.y[0]);
+        if (area <= 0.f)
+            return;
+        t.minY = std::max(0, int(std::floor(minY)));
+        t.maxY = std::min(HEIGHT - 1, int(std::ceil(maxY)));
+        if (t.minY <= t.maxY)
+            ++count;
+    };
+    for (int i = 0; i < 36; i += 3) {
+        glm::vec4 in[3] = {clip[BOX_INDICES[i]], clip[BOX_INDICES[i + 1]], clip[BOX_INDICES[i + 2]]};
+        glm::vec4 poly[4];
+        int n = 0;
+        for (int e = 0; e < 3; ++e) {
+            const glm::vec4 &a = in[e], &b = in[(e + 1) % 3];
+            if (a.w > NEAR_W)
+                poly[n++] = a;
+            if ((a.w > NEAR_W) != (b.w > NEAR_W))
+                poly[n++] = a + (b - a) * ((NEAR_W - a.w) / (b.w - a.w));
+        }
+        if (n >= 3)
+            emit(poly[0], poly[1], poly[2]);
+        if (n == 4)
+            emit(poly[0], poly[2], poly[3]);
+    }
+}
+
+template <typename V>
+void OcclusionBuffer::rasterize(OcclusionBuffer &buffer, int rowBegin, int rowEnd) {
+    constexpr int W = sizeof(V) / sizeof(float);
+    const V offsets = laneOffsets<V>();
+    const int pixelBegin = rowBegin * TILE, pixelEnd = rowEnd * TILE;
+    for (size_t o = 0; o < buffer.triangleCounts.size(); ++o) {
+        const ScreenTriangle *tris = &buffer.triangles[o * MAX_TRIANGLES_PER_OCCLUDER];
+        for (int t = 0; t < buffer.triangleCounts[o]; ++t) {
+            const ScreenTriangle &tri = tris[t];
+            const int y0 = std::max(tri.minY, pixelBegin), y1 = std::min(tri.maxY, pixelEnd - 1);
+            if (y0 > y1)
+                continue;
+            float minX = std::min({tri.x[0], tri.x[1], tri.x[2]}), maxX = std::max({tri.x[0], tri.x[1], tri.x[2]});
+            const int x0 = std::max(0, int(std::floor(minX))) & ~(W - 1);
+            const int x1 = std::min(WIDTH - 1, int(std::ceil(maxX)));
+            if (x0 > x1)
+                continue;
+            // edge functions: e_i(x, y) = a_i * x + b_i * y + c_i, positive inside
+            float a[3], b[3], c[3];
+            for (int e = 0; e < 3; ++e) {
+                int i = (e + 1) % 3, j = (e + 2) % 3;
+                a[e] = tri.y[i] - tri.y[j];
+                b[e] = tri.x[j] - tri.x[i];
+                c[e] = tri.x[i] * tri.y[j] - tri.x[j] * tri.y[i];
+            }
+            const float invArea = 1.f / (c[0] + c[1] + c[2]);
+            // depth is affine in screen space: z = za * x + zb * y + zc
+            float za = 0.f, zb = 0.f, zc = 0.f;
+            for (int e = 0; e < 3; ++e) {
+                za += a[e] * tri.z[e] * invArea;
+                zb += b[e] * tri.z[e] * invArea;
+                zc += c[e] * tri.z[e] * invArea;
+            }
+            for (int y = y0; y <= y1; ++y) {
+                const float py = y + 0.5f;
+                float *row = &buffer.depth[y * WIDTH];
+                for (int x = x0; x <= x1; x += W) {
+                    const V px = offsets + (x + 0.5f);
+                    const V e0 = px * a[0] + (b[0] * py + c[0]);
+                    const V e1 = px * a[1] + (b[1] * py + c[1]);
+                    const V e2 = px * a[2] + (b[2] * py + c[2]);
+                    const V z = px * za + (zb * py + zc);
+                    V d;
+                    std::memcpy(&d, row + x, sizeof(V));
+                    d = ((e0 >= 0) & (e1 >= 0) & (e2 >= 0) & (z < d)) ? z : d;
+                    std::memcpy(row + x, &d, sizeof(V));
+                }
+            }
+        }
+    }
+    // refresh the min/max of the tiles we own
+    for (int ty = rowBegin; ty < rowEnd; ++ty) {
+        for (int tx = 0; tx < TILES_X; ++tx) {
+            float lo = 1.f, hi = 0.f;
+            for (int y = ty * TILE; y < (ty + 1) * TILE; ++y) {
+                for (int x = tx * TILE; x < (tx + 1) * TILE; ++x) {
+                    lo = std::min(lo, buffer.depth[y * WIDTH + x]);
+                    hi = std::max(hi, buffer.depth[y * WIDTH + x]);
+                }
+            }
+            buffer.tileMin[ty * TILES_X + tx] = lo;
+            buffer.tileMax[ty * TILES_X + tx] = hi;
+        }
+    }
+}
+
+void OcclusionBuffer::rasterizeSSE(OcclusionBuffer &buffer, int rowBegin, int rowEnd) {
+    rasterize<f32x4>(buffer, rowBegin, rowEnd);
+}
+
+__attribute__((target("avx2"))) void OcclusionBuffer::rasterizeAVX2(OcclusionBuffer &buffer, int rowBegin, int rowEnd) {
+    rasterize<f32x8>(buffer, rowBegin, rowEnd);
+}
+
+void OcclusionBuffer::render(const glm::mat4 &viewProj, const std::vector<AABB> &occluders, WorkerPool &pool) {
+    triangles.resize(occluders.size() * MAX_TRIANGLES_PER_OCCLUDER);
+    triangleCounts.resize(occluders.size());
+    pool.parallelFor(occluders.size(), 8, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i)
+            setupOccluder(viewProj, occluders[i], &triangles[i * MAX_TRIANGLES_PER_OCCLUDER], triangleCounts[i]);
+    });
+    // every worker owns whole rows of tiles, so nobody writes the same pixel
+    pool.parallelFor(TILES_Y, 1, [&](size_t begin, size_t end) {
+        std::fill(depth.begin() + begin * TILE * WIDTH, depth.begin() + end * TILE * WIDTH, 1.f);
+        rasterizeRows(*this, begin, end);
+    });
+}
+
+// conservative: false only when the box is outside the frustum or definitely behind the occluders
+bool OcclusionBuffer::isVisible(const glm::mat4 &viewProj, const AABB &box) const {
+    glm::vec4 clip[8];
+    for (int c = 0; c < 8; ++c)
+        clip[c] = viewProj * glm::vec4(boxCorner(box, c), 1.f);
+    // frustum: all corners outside one plane
+    for (int axis = 0; axis < 3; ++axis) {
+        bool allBelow = true, allAbove = true;
+        for (int c = 0; c < 8; ++c) {
+            allBelow = allBelow && clip[c][axis] < -clip[c].w;
+            allAbove = allAbove && clip[c][axis] > clip[c].w;
+        }
+        if (allBelow || allAbove)
+            return false;
+    }
+    float minX = 1.f, minY = 1.f, maxX = -1.f, maxY = -1.f, minZ = 1.f;
+    for (int c = 0; c < 8; ++c) {
+        // crosses the near plane, too close to bother
+        if (clip[c].w <= 1e-3f)
+            return true;
+        float x = clip[c].x / clip[c].w, y = clip[c].y / clip[c].w;
+        minX = std::min(minX, x), maxX = std::max(maxX, x);
+        minY = std::min(minY, y), maxY = std::max(maxY, y);
+        minZ = std::min(minZ, clip[c].z / clip[c].w * 0.5f + 0.5f);
+    }
+    const int px0 = std::max(0, int(std::floor((minX * 0.5f + 0.5f) * WIDTH)));
+    const int px1 = std::min(WIDTH - 1, int(std::ceil((maxX * 0.5f + 0.5f) * WIDTH)));
+    const int py0 = std::max(0, int(std::floor((minY * 0.5f + 0.5f) * HEIGHT)));
+    const int py1 = std::min(HEIGHT - 1, int(std::ceil((maxY * 0.5f + 0.5f) * HEIGHT)));
+    for (int ty = py0 / TILE; ty <= py1 / TILE; ++ty) {
+        for (int tx = px0 / TILE; tx <= px1 / TILE; ++tx) {
+            const int tile = ty * TILES_X + tx;
+            if (minZ <= tileMin[tile])
+                return true;
+            if (minZ >= tileMax[tile])
+                continue;
+            // the box is somewhere between the nearest and farthest thing in this tile, look closer
+            for (int y = std::max(py0, ty * TILE); y <= std::min(py1, ty * TILE + TILE - 1); ++y)
+                for (int x = std::max(px0, tx * TILE); x <= std::min(px1, tx * TILE + TILE - 1); ++x)
+                    if (minZ < depth[y * WIDTH + x])
+                        return true;
+        }
+    }
+    return false;
+}
+
+
+// a city: a grid of blocks with one building each, streets in between
+constexpr int CITY_BLOCKS = 64;
+constexpr float BLOCK_SIZE = 5.f;
+constexpr float STREET_WIDTH = 2.f;
+
+std::vector<AABB> buildCity() {
+    std::mt19937 rng(42);
+    std::uniform_real_distribution<float> height(2.f, 20.f);
+    std::vector<AABB> buildings;
+    for (int z = 0; z < CITY_BLOCKS; ++z) {
+        for (int x = 0; x < CITY_BLOCKS; ++x) {
+            glm::vec3 corner(x * BLOCK_SIZE + STREET_WIDTH / 2, 0.f, -z * BLOCK_SIZE - STREET_WIDTH / 2);
+            glm::vec3 size(BLOCK_SIZE - STREET_WIDTH, height(rng), -(BLOCK_SIZE - STREET_WIDTH));
+            buildings.push_back({glm::min(corner, corner + size), glm::max(corner, corner + size)});
+        }
+    }
+    return buildings;
+}
+
+// the buildings that hide the most: big on screen and close to the camera
+void selectOccluders(const std::vector<AABB> &buildings, const glm::vec3 &cameraPos, const glm::vec3 &cameraFront,
+                     size_t maxOccluders, std::vector<AABB> &occluders) {
+    std::vector<std::pair<float, size_t>> scored;
+    for (size_t i = 0; i < buildings.size(); ++i) {
+        glm::vec3 center = (buildings[i].min + buildings[i].max) * 0.5f;
+        glm::vec3 toBox = center - cameraPos;
+        float distance = glm::length(toBox);
+        glm::vec3 size = buildings[i].max - buildings[i].min;
+        float radius = glm::length(size) * 0.5f;
+        if (glm::dot(toBox, cameraFront) < -radius)
+            continue;
+        scored.push_back({radius * radius / std::max(distance * distance, 1e-2f), i});
+    }
+    size_t n = std::min(maxOccluders, scored.size());
+    std::partial_sort(scored.begin(), scored.begin() + n, scored.end(), std::greater<std::pair<float, size_t>>());
+    occluders.clear();
+    for (size_t i = 0; i < n; ++i)
+        occluders.push_back(buildings[scored[i].second]);
+}
+
+struct CullStats {
+    size_t total = 0;
+    size_t inFrustum = 0;
+    size_t drawn = 0;
+    double rasterMs = 0.;
+    double testMs = 0.;
+};
+
+constexpr size_t MAX_OCCLUDERS = 64;
+
+// fills visible[i] for every building, 0 if it can be skipped
+CullStats cullCity(const std::vector<AABB> &buildings, const glm::mat4 &viewProj, const glm::vec3 &cameraPos, const glm::vec3 &cameraFront,
+                   OcclusionBuffer &buffer, WorkerPool &pool, std::vector<AABB> &occluders, std::vector<uint8_t> &visible) {
+    CullStats stats;
+    stats.total = buildings.size();
+    auto start = std::chrono::steady_clock::now();
+    selectOccluders(buildings, cameraPos, cameraFront, MAX_OCCLUDERS, occluders);
+    buffer.render(viewProj, occluders, pool);
+    auto rastered = std::chrono::steady_clock::now();
+    visible.resize(buildings.size());
+    std::atomic<size_t> drawn{0};
+    pool.parallelFor(buildings.size(), 256, [&](size_t begin, size_t end) {
+        size_t count = 0;
+        for (size_t i = begin; i < end; ++i) {
+            visible[i] = buffer.isVisible(viewProj, buildings[i]);
+            count += visible[i];
+        }
+        drawn += count;
+    });
+    auto tested = std::chrono::steady_clock::now();
+    stats.drawn = drawn;
+    stats.rasterMs = std::chrono::duration<double, std::milli>(rastered - start).count();
+    stats.testMs = std::chrono::duration<double, std::milli>(tested - rastered).count();
+    return stats;
+}
+
+size_t countInFrustum(const std::vector<AABB> &buildings, const glm::mat4 &viewProj) {
+    OcclusionBuffer empty;
+    size_t count = 0;
+    for (const AABB &box : buildings)
+        count += empty.isVisible(viewProj, box);
+    return count;
+}
+
+// ./main --bench: walk down a street without a window and report what the culling saves and costs
+int runBenchmark() {
+    std::vector<AABB> buildings = buildCity();
+    WorkerPool pool;
+    OcclusionBuffer buffer;
+    std::vector<AABB> occluders;
+    std::vector<uint8_t> visible;
+    const glm::mat4 proj = glm::perspective(glm::radians(45.f), 800 / 600.f, 0.1f, 500.f);
+    constexpr int FRAMES = 300;
+    double frustumDraws = 0., drawn = 0., raster = 0., test = 0.;
+    for (int f = 0; f < FRAMES; ++f) {
+        // street level, walking down the street between the 10th and 11th column of blocks
+        glm::vec3 pos(10 * BLOCK_SIZE, 1.7f, -f * 0.5f);
+        glm::vec3 front = glm::normalize(glm::vec3(std::sin(f * 0.02f) * 0.5f, 0.f, -1.f));
+        glm::mat4 viewProj = proj * glm::lookAt(pos, pos + front, glm::vec3(0.f, 1.f, 0.f));
+        CullStats stats = cullCity(buildings, viewProj, pos, front, buffer, pool, occluders, visible);
+        frustumDraws += countInFrustum(buildings, viewProj);
+        drawn += stats.drawn;
+        raster += stats.rasterMs;
+        test += stats.testMs;
+    }
+    std::cout << buildings.size() << " buildings, " << pool.size() << " threads\n"
+              << "draw calls with frustum culling: " << frustumDraws / FRAMES << "\n"
+              << "draw calls with occlusion culling: " << drawn / FRAMES
+              << " (" << 100. * (1. - drawn / frustumDraws) << "% fewer)\n"
+              << "occluder raster: " << raster / FRAMES << "ms, occludee tests: " << test / FRAMES << "ms per frame\n";
+    return EXIT_SUCCESS;
+}
+
+
+void processInput(GLFWwindow *window, glm::vec3 &cameraPos, glm::vec3 &cameraFront, glm::vec3 &cameraUp)
+{
+
+    const float cameraSpeed = 0.05f; // adjust accordingly
+    if (glfwGetKey(window, GLFW_KEY_W) == GLFW_PRESS)
+        cameraPos += cameraSpeed * cameraFront;
+    if (glfwGetKey(window, GLFW_KEY_S) == GLFW_PRESS)
+        cameraPos -= cameraSpeed * cameraFront;
+    if (glfwGetKey(window, GLFW_KEY_A) == GLFW_PRESS)
+        cameraPos -= glm::normalize(glm::cross(cameraFront, cameraUp)) * cameraSpeed;
+    if (glfwGetKey(window, GLFW_KEY_D) == GLFW_PRESS)
+        cameraPos += glm::normalize(glm::cross(cameraFront, cameraUp)) * cameraSpeed;
+    if (glfwGetKey(window, GLFW_KEY_UP) == GLFW_PRESS)
+        cameraPos += glm::normalize(glm::cross(cameraFront, cameraUp)) * cameraSpeed;
+
+}
+
+
+float yaw = -90.f;
+float pitch = 0.f;
+glm::vec3 cameraFront;
+
+void mouseMovement(GLFWwindow *window, double xPos, double yPos) {
+    static float lastX = xPos, lastY = yPos;
+    float xOffset = xPos - lastX;
+    float yOffset = lastY - yPos;
+    
+    constexpr float sensitivity = 0.05f;
+    xOffset *= sensitivity;
+    yOffset *= sensitivity;
+
+    yaw += xOffset;
+    pitch += yOffset;
+
+    if (std::abs(pitch) > 89.f) // don't ever do it this way. I am lazy
+        pitch = std::abs(pitch) / pitch * 89.f;
+
+    cameraFront.x = cos(glm::radians(yaw)) * cos(glm::radians(pitch));
+    cameraFront.y = sin(glm::radians(pitch));
+    cameraFront.z = sin(glm::radians(yaw)) * cos(glm::radians(pitch));
+
+    cameraFront = glm::normalize(cameraFront);
+    lastX = xPos, lastY = yPos;
+}
+
+
+
+
+
+int main(int argc, char **argv) {
+    if (argc > 1 && !std::strcmp(argv[1], "--bench"))
+        return runBenchmark();
+
+    if (glfwInit() != GLFW_TRUE) {
+        glfwTerminate();
+        std::cerr << "Failed to initialize GLFW";
+        return EXIT_FAILURE;
+    }
+    // setting OpenGL version to 3.3
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+    GLFWwindow *win = glfwCreateWindow(600, 600, "This is a hello window!", NULL, NULL);
+    glViewport(0, 0, 600, 600);
+    // setting 'context' for OpenGL, i.e. where to draw on current thread
+    glfwMakeContextCurrent(win);
+    // all it does is fetches us the implemented functions of OpenGL
+    if (glewInit() != GLEW_OK) {
+        glfwTerminate();
+        std::cerr << "Failed to initialize GLEW\n";
+        return EXIT_FAILURE;
+    }
+
+    glEnable(GL_DEPTH_TEST);
+    float triangle_data[] = {
+        //   vertpos   //  //texcord//
+    -0.5f, -0.5f, -0.5f,  0.0f, 0.0f,
+     0.5f, -0.5f, -0.5f,  1.0f, 0.0f,
+     0.5f,  0.5f, -0.5f,  1.0f, 1.0f,
+     0.5f,  0.5f, -0.5f,  1.0f, 1.0f,
+    -0.5f,  0.5f, -0.5f,  0.0f, 1.0f,
+    -0.5f, -0.5f, -0.5f,  0.0f, 0.0f,
+
+    -0.5f, -0.5f,  0.5f,  0.0f, 0.0f,
+     0.5f, -0.5f,  0.5f,  1.0f, 0.0f,
+     0.5f,  0.5f,  0.5f,  1.0f, 1.0f,
+     0.5f,  0.5f,  0.5f,  1.0f, 1.0f,
+    -0.5f,  0.5f,  0.5f,  0.0f, 1.0f,
+    -0.5f, -0.5f,  0.5f,  0.0f, 0.0f,
+
+    -0.5f,  0.5f,  0.5f,  1.0f, 0.0f,
+    -0.5f,  0.5f, -0.5f,  1.0f, 1.0f,
+    -0.5f, -0.5f, -0.5f,  0.0f, 1.0f,
+    -0.5f, -0.5f, -0.5f,  0.0f, 1.0f,
+    -0.5f, -0.5f,  0.5f,  0.0f, 0.0f,
+    -0.5f,  0.5f,  0.5f,  1.0f, 0.0f,
+
+     0.5f,  0.5f,  0.5f,  1.0f, 0.0f,
+     0.5f,  0.5f, -0.5f,  1.0f, 1.0f,
+     0.5f, -0.5f, -0.5f,  0.0f, 1.0f,
+     0.5f, -0.5f, -0.5f,  0.0f, 1.0f,
+     0.5f, -0.5f,  0.5f,  0.0f, 0.0f,
+     0.5f,  0.5f,  0.5f,  1.0f, 0.0f,
+
+    -0.5f, -0.5f, -0.5f,  0.0f, 1.0f,
+     0.5f, -0.5f, -0.5f,  1.0f, 1.0f,
+     0.5f, -0.5f,  0.5f,  1.0f, 0.0f,
+     0.5f, -0.5f,  0.5f,  1.0f, 0.0f,
+    -0.5f, -0.5f,  0.5f,  0.0f, 0.0f,
+    -0.5f, -0.5f, -0.5f,  0.0f, 1.0f,
+
+    -0.5f,  0.5f, -0.5f,  0.0f, 1.0f,
+     0.5f,  0.5f, -0.5f,  1.0f, 1.0f,
+     0.5f,  0.5f,  0.5f,  1.0f, 0.0f,
+     0.5f,  0.5f,  0.5f,  1.0f, 0.0f,
+    -0.5f,  0.5f,  0.5f,  0.0f, 0.0f,
+    -0.5f,  0.5f, -0.5f,  0.0f, 1.0f
+        
+    };
+
+
+    // start in a street at the edge of the city, looking down it
+    glm::vec3 cameraPos(10 * BLOCK_SIZE, 1.7f, 3.f);
+    cameraFront = glm::vec3(0.f,0.f,-1.f);
+    glm::vec3 cameraUp(0.,1.,0.f);
+    
+
+    Texture2D tex;
+    tex.generate2DTex("./image2d.tex");
+    tex.bind();
+
+    GLuint vbo = 0;
+    glGenBuffers(1, &vbo); 
+    glBindBuffer(GL_ARRAY_BUFFER, vbo);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(triangle_data), triangle_data, GL_STATIC_DRAW);
+
+    GLuint vao = 0;
+    glGenVertexArrays(1, &vao);
+    glBindVertexArray(vao);
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)0);
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)(3 * sizeof(float)));
+    glEnableVertexAttribArray(1);
+
+    VertexShader vs;
+    FragmentShader fs;
+    vs.setSource("./vertex.glsl");
+    fs.setSource("./frag.glsl");
+    Program prog;
+    prog.AttachShaders({&vs, &fs});
+    prog.UseProgram();
+
+
+    std::vector<AABB> buildings = buildCity();
+    WorkerPool pool;
+    OcclusionBuffer occlusion;
+    std::vector<AABB> occluders;
+    std::vector<uint8_t> visible;
+    double lastReport = glfwGetTime();
+
+    glm::mat4 view; // = glm::translate(glm::mat4(1.f), glm::vec3(0.f,0.f,-3.f));
+       
+
+    glm::mat4 proj = glm::perspective(glm::radians(45.f), 800 / 600.f, 0.1f, 500.f);
+
+    prog.setMat4("proj", proj);
+    prog.setMat4("view", view);
+
+    glfwSetCursorPosCallback(win, mouseMovement); 
+    glfwSetInputMode(win, GLFW_CURSOR, GLFW_CURSOR_DISABLED);  
+    
+    while (!glfwWindowShouldClose(win)) {
+        processInput(win, cameraPos, cameraFront, cameraUp);
+        view = glm::lookAt(cameraPos, cameraFront + cameraPos, cameraUp);
+
+        prog.setMat4("view", view);
+        CullStats stats = cullCity(buildings, proj * view, cameraPos, cameraFront, occlusion, pool, occluders, visible);
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+        for (size_t i = 0; i < buildings.size(); ++i) {
+            if (!visible[i])
+                continue;
+            glm::mat4 model = glm::translate(glm::mat4(1.f), (buildings[i].min + buildings[i].max) * 0.5f);
+            model = glm::scale(model, buildings[i].max - buildings[i].min);
+            prog.setMat4("model", model);
+            glDrawArrays(GL_TRIANGLES, 0, 36);
+        }
+        if (glfwGetTime() - lastReport > 1.) {
+            lastReport = glfwGetTime();
+            std::cout << "drew " << stats.drawn << " of " << stats.total << " buildings, occluder raster "
+                      << stats.rasterMs << "ms, occludee tests " << stats.testMs << "ms\n";
+        }
+        // polls different kinds of events, for example, when we close an application, it fetches that event
+        // or it fetches events like movement of the window.
+        // Without it you can neither move the window or close the window
+        glfwPollEvents();
+        // have you drawn the image, it is stored in the buffer. You can now swap this buffer with main buffer
+        // so the image appears
+        glfwSwapBuffers(win);
+    }
+    glfwTerminate();
+    
+    std::cout << "Window should close now!\n";
+
+    return EXIT_SUCCESS;
+
+}
@@ -0,0 +1,10 @@
+#version 330 core
+
+out vec4 FragColor;
+in vec3 normal;
+in vec3 color;
+
+void main() {
+    float light = 0.25 + 0.75 * max(dot(normalize(normal), normalize(vec3(0.4, 1.0, 0.3))), 0.0);
+    FragColor = vec4(color * light, 1.0);
+}
@@ -0,0 +1,34 @@
+#version 430 core
+
+layout(location = 0) in vec3 aPos;
+layout(location = 2) in vec3 aNormal;
+// from the visible list cull.comp wrote, baseInstance of the draw command picks where in it we start
+layout(location = 3) in uint aInstance;
+
+out vec3 normal;
+out vec3 color;
+
+struct Instance {
+    vec4 posScale;
+    uint mesh;
+    float radius;
+};
+
+layout(std430, binding = 0) readonly buffer Instances {
+    Instance instances[];
+};
+
+uniform mat4 proj;
+uniform mat4 view;
+
+vec3 instanceColor(uint id) {
+    uint h = id * 2654435761u;
+    return vec3((h >> 8) & 255u, (h >> 16) & 255u, (h >> 24) & 255u) / 255.0 * 0.6 + 0.4;
+}
+
+void main() {
+    vec4 posScale = instances[aInstance].posScale;
+    gl_Position = proj * view * vec4(aPos * posScale.w + posScale.xyz, 1.0);
+    normal = aNormal;
+    color = instanceColor(aInstance);
+}
@@ -0,0 +1,824 @@
+#include <GL/glew.h>
+
+#include <GLFW/glfw3.h>
+#include <algorithm>
+#include <cfloat>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+#include <glm/ext/matrix_clip_space.hpp>
+#include <glm/ext/matrix_transform.hpp>
+#include <glm/geometric.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/ext/matrix_float4x4.hpp>
+#include <glm/gtc/type_ptr.hpp>
+#include <glm/glm.hpp>
+#include <glm/trigonometric.hpp>
+#include <iostream>
+
+class Shader {
+    std::string src; 
+protected:
+    const char *getsrc() {
+        return src.data();
+    }
+    GLuint shader_id = 0;
+    bool isCompiled = false;
+protected:
+    virtual const char *getClassName() = 0;
+    GLint getCompilationStatus(GLuint shader_id) {
+        int status;
+        glGetShaderiv(shader_id, GL_COMPILE_STATUS, &status);
+        return status;
+    }
+    void sendError() {
+        char buffer[1024];
+        glGetShaderInfoLog(shader_id, 1024, NULL, buffer);
+        std::cerr << "ERROR::" << getClassName() << " - " << buffer;
+    }
+public:
+    virtual void compile() = 0;
+    void setSource(const char *s) {
+        std::ifstream sourceFile(s);
+        if (!sourceFile.is_open())
+            return;
+        char buffer[8192];
+        while (sourceFile.read(buffer, 8192)) {
+            src.append(buffer, 8192);
+        }
+        if (!sourceFile.eof()) {
+            src.clear();
+            return;
+        }
+        src.append(buffer, sourceFile.gcount());
+    }
+    friend class Program;
+};
+
+
+class VertexShader : public Shader {
+    virtual const char *getClassName() override {
+        return "VertexShader";
+    }
+public:
+    virtual void compile() override {
+        if (shader_id)
+            glDeleteShader(shader_id);
+        shader_id = glCreateShader(GL_VERTEX_SHADER);
+        const char *src = getsrc();
+        glShaderSource(shader_id, 1, &src, NULL);
+        glCompileShader(shader_id);
+        if (!getCompilationStatus(shader_id)) {
+            sendError();
+        }
+        isCompiled = true;
+    }
+};
+
+class FragmentShader : public Shader {
+    const char *getClassName() override {
+        return "FragmentShader";
+    }
+public:
+    virtual void compile() override {
+        if (shader_id)
+            glDeleteShader(shader_id);
+        shader_id = glCreateShader(GL_FRAGMENT_SHADER);
+        const char *src = getsrc();
+        glShaderSource(shader_id, 1, &src, NULL);
+        glCompileShader(shader_id);
+        if (!getCompilationStatus(shader_id)) {
+            sendError();
+        }
+        isCompiled = true;
+    }
+};
+
+class ComputeShader : public Shader {
+    const char *getClassName() override {
+        return "ComputeShader";
+    }
+public:
+    virtual void compile() override {
+        if (shader_id)
+            glDeleteShader(shader_id);
+        shader_id = glCreateShader(GL_COMPUTE_SHADER);
+        const char *src = getsrc();
+        glShaderSource(shader_id, 1, &src, NULL);
+        glCompileShader(shader_id);
+        if (!getCompilationStatus(shader_id)) {
+            sendError();
+        }
+        isCompiled = true;
+    }
+};
+
+
+class Program {
+    GLuint program_id = 0;
+    void sendError() {
+        char buffer[1024];
+        glGetProgramInfoLog(program_id, 1024, NULL, buffer);
+        std::cerr << "ERROR::PROGRAM: " << " - " << buffer;
+    }
+    bool linkStatus() {
+        int status = 0;
+        glGetProgramiv(program_id, GL_LINK_STATUS, &status);
+        return status;
+    }
+public:
+    Program() {
+        program_id = glCreateProgram();
+    }
+    ~Program() {
+        glDeleteProgram(program_id);
+    }
+    void AttachShaders(std::initializer_list<Shader*> shaders) {
+        auto i = shaders.begin();
+        while (i != shaders.end()) {
+            if (!(*i)->isCompiled)
+                (*i)->compile();
+            glAttachShader(program_id, (*i)->shader_id);
+            ++i;
+        }
+        glLinkProgram(program_id);
+        if (!linkStatus()) {
+            sendError();
+        }
+    }
+    void UseProgram() {
+        glUseProgram(program_id);
+    }
+    void setMat4(const char *locName, const glm::mat4 &mat) {
+        int location = glGetUniformLocation(program_id, locName);
+        if (location == -1)
+            return;
+        glUniformMatrix4fv(location, 1, GL_FALSE, glm::value_ptr(mat));
+    }
+    void setInt(const char *locName, int value) {
+        int location = glGetUniformLocation(program_id, locName);
+        if (location == -1)
+            return;
+        glUniform1i(location, value);
+    }
+    void setFloat(const char *locName, float value) {
+        int location = glGetUniformLocation(program_id, locName);
+        if (location == -1)
+            return;
+        glUniform1f(location, value);
+    }
+    void setVec3(const char *locName, const glm::vec3 &vec) {
+        int location = glGetUniformLocation(program_id, locName);
+        if (location == -1)
+            return;
+        glUniform3f(location, vec.x, vec.y, vec.z);
+    }
+    void setVec4(const char *locName, const glm::vec4 &vec) {
+        int location = glGetUniformLocation(program_id, locName);
+        if (location == -1)
+            return;
+        glUniform4f(location, vec.x, vec.y, vec.z, vec.w);
+    }
+    void setVec4v(const char *locName, const glm::vec4 *vecs, int count) {
+        int location = glGetUniformLocation(program_id, locName);
+        if (location == -1)
+            return;
+        glUniform4fv(location, count, glm::value_ptr(vecs[0]));
+    }
+};
+
+
+// GPU time of a stretch of commands, without waiting for it. there are a few queries in flight and
+// we only read the one that was issued QUERIES frames ago, which has long finished by then
+class GpuTimer {
+    static constexpr int QUERIES = 4;
+    GLuint queries[QUERIES] = {};
+    int frame = 0;
+public:
+    GpuTimer() {
+        glGenQueries(QUERIES, queries);
+    }
+    ~GpuTimer() {
+        glDeleteQueries(QUERIES, queries);
+    }
+    void begin() {
+        glBeginQuery(GL_TIME_ELAPSED, queries[frame % QUERIES]);
+    }
+    // returns the milliseconds of an older frame, or a negative value if there is none yet
+    double end() {
+        glEndQuery(GL_TIME_ELAPSED);
+        ++frame;
+        if (frame < QUERIES)
+            return -1.;
+        GLuint oldest = queries[frame % QUERIES];
+        GLint available = 0;
+        glGetQueryObjectiv(oldest, GL_QUERY_RESULT_AVAILABLE, &available);
+        if (!available)
+            return -1.;
+        GLuint64 ns = 0;
+        glGetQueryObjectui64v(oldest, GL_QUERY_RESULT, &ns);
+        return ns / 1e6;
+    }
+};
+
+
+// ---------------------------------------------------------------------------------------------------------
+// all meshes in one vertex buffer and one index buffer. a mesh is just a range of indices and the vertex
+// its indices count from, which is exactly what a DrawElementsIndirectCommand needs
+// ---------------------------------------------------------------------------------------------------------
+
+struct MeshVertex {
+    glm::vec3 pos;
+    glm::vec3 normal;
+};
+
+struct MeshRange {
+    uint32_t firstIndex;
+    uint32_t indexCount;
+    int32_t baseVertex;
+    float radius;  // bounding sphere around the origin
+};
+
+class MeshPool {
+public:
+    std::vector<MeshVertex> vertices;
+    std::vector<uint32_t> indices;
+    std::vector<MeshRange> meshes;
+
+    // the vertices of a new mesh go through add(), its indices through index() counting from 0
+    uint32_t begin() {
+        meshes.push_back({uint32_t(indices.size()), 0, int32_t(vertices.size()), 0.f});
+        return meshes.size() - 1;
+    }
+    uint32_t add(const glm::vec3 &pos, const glm::vec3 &normal) {
+        MeshRange &mesh = meshes.back();
+        mesh.radius = std::max(mesh.radius, glm::length(pos));
+        vertices.push_back({pos, glm::normalize(normal)});
+        return vertices.size() - 1 - mesh.baseVertex;
+    }
+    void index(uint32_t a, uint32_t b, uint32_t c) {
+        indices.insert(indices.end(), {a, b, c});
+        meshes.back().indexCount += 3;
+    }
+};
+
+void addCube(MeshPool &pool) {
+    pool.begin();
+    for (int axis = 0; axis < 3; ++axis) {
+        for (float side : {-1.f, 1.f}) {
+            glm::vec3 n(0.f), u(0.f), v(0.f);
+            n[axis] = side;
+            u[(axis + 1) % 3] = 1.f;
+            v[(axis + 2) % 3] = 1.f;
+            if (side < 0.f)
+                std::swap(u, v);
+            uint32_t a = pool.add((n + -u + -v) * 0.5f, n), b = pool.add((n + u + -v) * 0.5f, n);
+            uint32_t c = pool.add((n + u + v) * 0.5f, n), d = pool.add((n + -u + v) * 0.5f, n);
+            pool.index(a, b, c);
+            pool.index(a, c, d);
+        }
+    }
+}
+
+void addSphere(MeshPool &pool, int rings, int segments) {
+    pool.begin();
+    for (int r = 0; r <= rings; ++r) {
+        float theta = glm::pi<float>() * r / rings;
+        for (int s = 0; s <= segments; ++s) {
+            float phi = 2.f * glm::pi<float>() * s / segments;
+            glm::vec3 p(std::sin(theta) * std::cos(phi), std::cos(theta), std::sin(theta) * std::sin(phi));
+            pool.add(p * 0.5f, p);
+        }
+    }
+    for (int r = 0; r < rings; ++r) {
+        for (int s = 0; s < segments; ++s) {
+            uint32_t a = r * (segments + 1) + s, b = a + segments + 1;
+            pool.index(a, a + 1, b);
+            pool.index(a + 1, b + 1, b);
+        }
+    }
+}
+
+void addTorus(MeshPool &pool, int rings, int sides) {
+    pool.begin();
+    const float major = 0.35f, minor = 0.15f;
+    for (int r = 0; r <= rings; ++r) {
+        float u = 2.f * glm::pi<float>() * r / rings;
+        glm::vec3 center(std::cos(u) * major, 0.f, std::sin(u) * major);
+        for (int s = 0; s <= sides; ++s) {
+            float v = 2.f * glm::pi<float>() * s / sides;
+            glm::vec3 n(std::cos(u) * std::cos(v), std::sin(v), std::sin(u) * std::cos(v));
+            pool.add(center + n * minor, n);
+        }
+    }
+    for (int r = 0; r < rings; ++r) {
+        for (int s = 0; s < sides; ++s) {
+            uint32_t a = r * (sides + 1) + s, b = a + sides + 1;
+            pool.index(a, a + 1, b);
+            pool.index(a + 1, b + 1, b);
+        }
+    }
+}
+
+void addOctahedron(MeshPool &pool) {
+    pool.begin();
+    const glm::vec3 axes[6] = {{0.5f, 0.f, 0.f}, {-0.5f, 0.f, 0.f}, {0.f, 0.5f, 0.f}, {0.f, -0.5f, 0.f}, {0.f, 0.f, 0.5f}, {0.f, 0.f, -0.5f}};
+    for (int x : {0, 1}) {
+        for (int y : {2, 3}) {
+            for (int z : {4, 5}) {
+                glm::vec3 a = axes[x], b = axes[y], c = axes[z];
+                glm::vec3 n = a + b + c;
+                // keep the winding counter clockwise seen from outside
+                if (glm::dot(glm::cross(b - a, c - a), n) < 0.f)
+                    std::swap(b, c);
+                uint32_t i = pool.add(a, n), j = pool.add(b, n), k = pool.add(c, n);
+                pool.index(i, j, k);
+            }
+        }
+    }
+}
+
+
+// ---------------------------------------------------------------------------------------------------------
+// instances and culling. the same sphere against frustum test runs on the CPU for the 3.3 path and as a
+// reference, and in cull.comp for the 4.3 path
+// ---------------------------------------------------------------------------------------------------------
+
+// std430 in cull.comp and indirect_vertex.glsl
+struct Instance {
+    glm::vec4 posScale;  // xyz position, w scale
+    uint32_t mesh;
+    float radius;        // of the scaled mesh
+    uint32_t pad[2];
+};
+
+// laid out the way glMultiDrawElementsIndirect reads it
+struct DrawElementsIndirectCommand {
+    uint32_t count;
+    uint32_t instanceCount;
+    uint32_t firstIndex;
+    int32_t baseVertex;
+    uint32_t baseInstance;
+};
+
+// instances of one mesh are next to each other, so each mesh's visible list can start at its first instance
+std::vector<Instance> buildInstances(const MeshPool &pool, int count, std::vector<uint32_t> &firstOfMesh) {
+    std::mt19937 rng(1234);
+    std::uniform_real_distribution<float> spread(-150.f, 150.f), height(-20.f, 20.f), scale(0.5f, 2.5f);
+    std::vector<Instance> instances;
+    firstOfMesh.clear();
+    for (uint32_t mesh = 0; mesh < pool.meshes.size(); ++mesh) {
+        firstOfMesh.push_back(instances.size());
+        int perMesh = count / pool.meshes.size() + (mesh < count % pool.meshes.size());
+        for (int i = 0; i < perMesh; ++i) {
+            Instance inst = {};
+            inst.posScale = glm::vec4(spread(rng), height(rng), spread(rng), scale(rng));
+            inst.mesh = mesh;
+            inst.radius = pool.meshes[mesh].radius * inst.posScale.w;
+            instances.push_back(inst);
+        }
+    }
+    return instances;
+}
+
+// the six planes of proj * view, pointing inwards and normalized so dot(plane, p) is a distance
+void frustumPlanes(const glm::mat4 &viewProj, glm::vec4 planes[6]) {
+    for (int i = 0; i < 3; ++i) {
+        for (int side = 0; side < 2; ++side) {
+            glm::vec4 &p = planes[i * 2 + side];
+            for (int c = 0; c < 4; ++c)
+                p[c] = viewProj[c][3] + (side ? -viewProj[c][i] : viewProj[c][i]);
+            p = p * (1.f / glm::length(glm::vec3(p)));
+        }
+    }
+}
+
+// how far inside the frustum the sphere is, negative when it is completely outside of some plane
+float sphereInside(const glm::vec4 planes[6], const Instance &inst) {
+    float inside = FLT_MAX;
+    for (int i = 0; i < 6; ++i)
+        inside = std::min(inside, glm::dot(glm::vec3(planes[i]), glm::vec3(inst.posScale)) + planes[i].w + inst.radius);
+    return inside;
+}
+
+// the CPU path: visible instance indices, per mesh
+void cullOnCpu(const glm::vec4 planes[6], const std::vector<Instance> &instances, size_t meshCount, std::vector<std::vector<uint32_t>> &visible) {
+    visible.assign(meshCount, {});
+    for (uint32_t i = 0; i < instances.size(); ++i)
+        if (sphereInside(planes, instances[i]) >= 0.f)
+            visible[instances[i].mesh].push_back(i);
+}
+
+
+// the 4.3 path. cull.comp goes through all instances, bumps instanceCount of the mesh's command for each one
+// that survives and writes its index into the visible list. the visible list is an instanced vertex attribute,
+// so baseInstance of each command points the mesh's draws at its own part of the list, and the vertex shader
+// looks everything else up in the instance buffer. the CPU sends one dispatch and one draw, whatever is in view
+class IndirectRenderer {
+    GLuint instance_ssbo = 0, command_buffer = 0, visible_buffer = 0;
+    std::vector<DrawElementsIndirectCommand> resetCommands;
+    Program *cull;
+    size_t instanceCount;
+public:
+    static constexpr int GROUP_SIZE = 64;  // local_size_x in cull.comp
+
+    IndirectRenderer(Program *cull, const MeshPool &pool, const std::vector<Instance> &instances, const std::vector<uint32_t> &firstOfMesh)
+        : cull(cull), instanceCount(instances.size()) {
+        for (size_t m = 0; m < pool.meshes.size(); ++m) {
+            const MeshRange &mesh = pool.meshes[m];
+            resetCommands.push_back({mesh.indexCount, 0, mesh.firstIndex, mesh.baseVertex, firstOfMesh[m]});
+        }
+        glGenBuffers(1, &instance_ssbo);
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, instance_ssbo);
+        glBufferData(GL_SHADER_STORAGE_BUFFER, instances.size() * sizeof(Instance), instances.data(), GL_STATIC_DRAW);
+        glGenBuffers(1, &command_buffer);
+        glBindBuffer(GL_DRAW_INDIRECT_BUFFER, command_buffer);
+        glBufferData(GL_DRAW_INDIRECT_BUFFER, resetCommands.size() * sizeof(DrawElementsIndirectCommand), resetCommands.data(), GL_DYNAMIC_DRAW);
+        glGenBuffers(1, &visible_buffer);
+        glBindBuffer(GL_ARRAY_BUFFER, visible_buffer);
+        glBufferData(GL_ARRAY_BUFFER, instances.size() * sizeof(uint32_t), NULL, GL_DYNAMIC_DRAW);
+    }
+    ~IndirectRenderer() {
+        glDeleteBuffers(1, &instance_ssbo);
+        glDeleteBuffers(1, &command_buffer);
+        glDeleteBuffers(1, &visible_buffer);
+    }
+    IndirectRenderer(const IndirectRenderer&) = delete;
+    IndirectRenderer &operator=(const IndirectRenderer&) = delete;
+
+    // the visible list as attribute 3 of the bound vertex array, one value per instance
+    void setupVertexArray() {
+        glBindBuffer(GL_ARRAY_BUFFER, visible_buffer);
+        glVertexAttribIPointer(3, 1, GL_UNSIGNED_INT, sizeof(uint32_t), (void*)0);
+        glVertexAttribDivisor(3, 1);
+        glEnableVertexAttribArray(3);
+    }
+    void cullOnGpu(const glm::vec4 planes[6]) {
+        glBindBuffer(GL_DRAW_INDIRECT_BUFFER, command_buffer);
+        glBufferSubData(GL_DRAW_INDIRECT_BUFFER, 0, resetCommands.size() * sizeof(DrawElementsIndirectCommand), resetCommands.data());
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, instance_ssbo);
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 1, command_buffer);
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 2, visible_buffer);
+        cull->UseProgram();
+        cull->setVec4v("planes", planes, 6);
+        cull->setInt("instanceCount", instanceCount);
+        glDispatchCompute((instanceCount + GROUP_SIZE - 1) / GROUP_SIZE, 1, 1);
+        // the draw reads the commands, the vertex stage reads the visible list as an attribute, and readBack()
+        // gets both with glGetBufferSubData
+        glMemoryBarrier(GL_COMMAND_BARRIER_BIT | GL_VERTEX_ATTRIB_ARRAY_BARRIER_BIT | GL_SHADER_STORAGE_BARRIER_BIT |
+                        GL_BUFFER_UPDATE_BARRIER_BIT);
+    }
+    void draw(Program &prog) {
+        prog.UseProgram();
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, instance_ssbo);
+        glBindBuffer(GL_DRAW_INDIRECT_BUFFER, command_buffer);
+        glMultiDrawElementsIndirect(GL_TRIANGLES, GL_UNSIGNED_INT, (void*)0, resetCommands.size(), 0);
+    }
+    // what the last cullOnGpu() came up with, per mesh. waits for the GPU, only for checking
+    void readBack(std::vector<std::vector<uint32_t>> &visible) {
+        std::vector<DrawElementsIndirectCommand> commands(resetCommands.size());
+        glBindBuffer(GL_DRAW_INDIRECT_BUFFER, command_buffer);
+        glGetBufferSubData(GL_DRAW_INDIRECT_BUFFER, 0, commands.size() * sizeof(DrawElementsIndirectCommand), commands.data());
+        std::vector<uint32_t> ids(instanceCount);
+        glBindBuffer(GL_ARRAY_BUFFER, visible_buffer);
+        glGetBufferSubData(GL_ARRAY_BUFFER, 0, ids.size() * sizeof(uint32_t), ids.data());
+        visible.assign(commands.size(), {});
+        for (size_t m = 0; m < commands.size(); ++m) {
+            visible[m].assign(ids.begin() + commands[m].baseInstance, ids.begin() + commands[m].baseInstance + commands[m].instanceCount);
+            // atomics hand out the slots in whatever order the invocations ran
+            std::sort(visible[m].begin(), visible[m].end());
+        }
+    }
+    size_t drawCount() const {
+        return resetCommands.size();
+    }
+};
+
+// the 3.3 path: what survived cullOnCpu(), one glDrawElementsBaseVertex per instance
+size_t drawOnCpu(Program &prog, const MeshPool &pool, const std::vector<Instance> &instances, const std::vector<std::vector<uint32_t>> &visible) {
+    prog.UseProgram();
+    size_t draws = 0;
+    for (size_t m = 0; m < visible.size(); ++m) {
+        const MeshRange &mesh = pool.meshes[m];
+        for (uint32_t i : visible[m]) {
+            prog.setVec4("posScale", instances[i].posScale);
+            prog.setInt("instanceId", i);
+            glDrawElementsBaseVertex(GL_TRIANGLES, mesh.indexCount, GL_UNSIGNED_INT, (void*)(mesh.firstIndex * sizeof(uint32_t)), mesh.baseVertex);
+            ++draws;
+        }
+    }
+    return draws;
+}
+
+
+// ./main --verify [instances]
+// culls from a bunch of random cameras on the GPU and on the CPU and compares the visible sets. spheres that
+// touch a plane within float noise may go either way and don't count as a mismatch
+int runVerify(IndirectRenderer &indirect, const std::vector<Instance> &instances, size_t meshCount) {
+    constexpr int CAMERAS = 64;
+    std::mt19937 rng(77);
+    std::uniform_real_distribution<float> pos(-120.f, 120.f), angle(0.f, 2.f * glm::pi<float>()), tilt(-0.5f, 0.5f);
+    glm::mat4 proj = glm::perspective(glm::radians(45.f), 800 / 600.f, 0.1f, 150.f);
+    std::vector<std::vector<uint32_t>> cpu, gpu;
+    size_t mismatches = 0, borderline = 0, visibleTotal = 0;
+    double cpuMs = 0., gpuMs = 0.;
+    for (int c = 0; c < CAMERAS; ++c) {
+        glm::vec3 eye(pos(rng), pos(rng) * 0.1f, pos(rng));
+        float yaw = angle(rng), pitch = tilt(rng);
+        glm::vec3 front(std::cos(yaw) * std::cos(pitch), std::sin(pitch), std::sin(yaw) * std::cos(pitch));
+        glm::vec4 planes[6];
+        frustumPlanes(proj * glm::lookAt(eye, eye + front, glm::vec3(0.f, 1.f, 0.f)), planes);
+
+        auto start = std::chrono::steady_clock::now();
+        cullOnCpu(planes, instances, meshCount, cpu);
+        cpuMs += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        start = std::chrono::steady_clock::now();
+        indirect.cullOnGpu(planes);
+        glFinish();
+        gpuMs += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        indirect.readBack(gpu);
+
+        for (size_t m = 0; m < meshCount; ++m) {
+            visibleTotal += cpu[m].size();
+            std::vector<uint32_t> onlyOne;
+            std::set_symmetric_difference(cpu[m].begin(), cpu[m].end(), gpu[m].begin(), gpu[m].end(), std::back_inserter(onlyOne));
+            for (uint32_t i : onlyOne) {
+                if (std::abs(sphereInside(planes, instances[i])) < 1e-3f * (1.f + instances[i].radius)) {
+                    ++borderline;
+                    continue;
+                }
+                if (mismatches++ < 10)
+                    std::cout << "camera " << c << ": instance " << i << " is " << (std::binary_search(cpu[m].begin(), cpu[m].end(), i) ? "visible" : "culled")
+                              << " on the CPU but not on the GPU\n";
+            }
+        }
+    }
+    std::cout << instances.size() << " instances, " << CAMERAS << " cameras, " << double(visibleTotal) / CAMERAS << " visible on average\n"
+              << "cull: " << cpuMs / CAMERAS << "ms cpu, " << gpuMs / CAMERAS << "ms gpu dispatch and wait\n"
+              << (mismatches ? "MISMATCH: " : "visible sets match, ") << mismatches << " differences, " << borderline << " on a plane\n";
+    return mismatches ? EXIT_FAILURE : EXIT_SUCCESS;
+}
+
+
+void processInput(GLFWwindow *window, glm::vec3 &cameraPos, glm::vec3 &cameraFront, glm::vec3 &cameraUp)
+{
+
+    const float cameraSpeed = 0.3f; // adjust accordingly
+    if (glfwGetKey(window, GLFW_KEY_W) == GLFW_PRESS)
+        cameraPos += cameraSpeed * cameraFront;
+    if (glfwGetKey(window, GLFW_KEY_S) == GLFW_PRESS)
+        cameraPos -= cameraSpeed * cameraFront;
+    if (glfwGetKey(window, GLFW_KEY_A) == GLFW_PRESS)
+        cameraPos -= glm::normalize(glm::cross(cameraFront, cameraUp)) * cameraSpeed;
+    if (glfwGetKey(window, GLFW_KEY_D) == GLFW_PRESS)
+        cameraPos += glm::normalize(glm::cross(cameraFront, cameraUp)) * cameraSpeed;
+    if (glfwGetKey(window, GLFW_KEY_UP) == GLFW_PRESS)
+        cameraPos += glm::normalize(glm::cross(cameraFront, cameraUp)) * cameraSpeed;
+
+}
+
+// true only on the frame the key went down
+bool keyPressed(GLFWwindow *window, int key) {
+    static bool down[GLFW_KEY_LAST + 1] = {};
+    bool now = glfwGetKey(window, key) == GLFW_PRESS;
+    bool pressed = now && !down[key];
+    down[key] = now;
+    return pressed;
+}
+
+
+float yaw = -90.f;
+float pitch = 0.f;
+glm::vec3 cameraFront;
+
+void mouseMovement(GLFWwindow *window, double xPos, double yPos) {
+    static float lastX = xPos, lastY = yPos;
+    float xOffset = xPos - lastX;
+    float yOffset = lastY - yPos;
+    
+    constexpr float sensitivity = 0.05f;
+    xOffset *= sensitivity;
+    yOffset *= sensitivity;
+
+    yaw += xOffset;
+    pitch += yOffset;
+
+    if (std::abs(pitch) > 89.f) // don't ever do it this way. I am lazy
+        pitch = std::abs(pitch) / pitch * 89.f;
+
+    cameraFront.x = cos(glm::radians(yaw)) * cos(glm::radians(pitch));
+    cameraFront.y = sin(glm::radians(pitch));
+    cameraFront.z = sin(glm::radians(yaw)) * cos(glm::radians(pitch));
+
+    cameraFront = glm::normalize(cameraFront);
+    lastX = xPos, lastY = yPos;
+}
+
+
+// ./main                     GPU culling and one indirect draw when the driver does 4.3, the CPU path otherwise
+// ./main --gl33              always the CPU path
+// ./main --verify [count]    compares GPU and CPU culling, needs 4.3. works on Mesa's llvmpipe
+int main(int argc, char **argv) {
+    bool verify = false, forceCpu = false;
+    int instanceCount = 20000;
+    for (int i = 1; i < argc; ++i) {
+        if (!std::strcmp(argv[i], "--verify"))
+            verify = true;
+        else if (!std::strcmp(argv[i], "--gl33"))
+            forceCpu = true;
+        else
+            instanceCount = std::max(std::atoi(argv[i]), 1);
+    }
+
+    if (glfwInit() != GLFW_TRUE) {
+        glfwTerminate();
+        std::cerr << "Failed to initialize GLFW";
+        return EXIT_FAILURE;
+    }
+    if (verify)
+        glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+    // compute shaders and glMultiDrawElementsIndirect are 4.3. if we can't get that, 3.3 as everywhere else
+    GLFWwindow *win = NULL;
+    if (!forceCpu) {
+        glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 4);
+        glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+        glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+        win = glfwCreateWindow(800, 600, "This is a hello window!", NULL, NULL);
+    }
+    if (!win) {
+        // setting OpenGL version to 3.3
+        glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+        glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+        win = glfwCreateWindow(800, 600, "This is a hello window!", NULL, NULL);
+    }
+    // setting 'context' for OpenGL, i.e. where to draw on current thread
+    glfwMakeContextCurrent(win);
+    // all it does is fetches us the implemented functions of OpenGL
+    if (glewInit() != GLEW_OK) {
+        glfwTerminate();
+        std::cerr << "Failed to initialize GLEW\n";
+        return EXIT_FAILURE;
+    }
+    bool gpuDriven = !forceCpu && GLEW_VERSION_4_3;
+    if (verify && !gpuDriven) {
+        glfwTerminate();
+        std::cerr << "ERROR::INDIRECT - --verify needs a GL 4.3 context\n";
+        return EXIT_FAILURE;
+    }
+    glfwSwapInterval(0);
+    int screenWidth, screenHeight;
+    glfwGetFramebufferSize(win, &screenWidth, &screenHeight);
+    glViewport(0, 0, screenWidth, screenHeight);
+
+    glEnable(GL_DEPTH_TEST);
+    glEnable(GL_CULL_FACE);
+
+    MeshPool pool;
+    addCube(pool);
+    addSphere(pool, 12, 16);
+    addTorus(pool, 24, 12);
+    addOctahedron(pool);
+    std::vector<uint32_t> firstOfMesh;
+    std::vector<Instance> instances = buildInstances(pool, instanceCount, firstOfMesh);
+
+    GLuint vbo = 0, ebo = 0;
+    glGenBuffers(1, &vbo); 
+    glBindBuffer(GL_ARRAY_BUFFER, vbo);
+    glBufferData(GL_ARRAY_BUFFER, pool.vertices.size() * sizeof(MeshVertex), pool.vertices.data(), GL_STATIC_DRAW);
+
+    GLuint vao = 0;
+    glGenVertexArrays(1, &vao);
+    glBindVertexArray(vao);
+    glGenBuffers(1, &ebo);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ebo);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, pool.indices.size() * sizeof(uint32_t), pool.indices.data(), GL_STATIC_DRAW);
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(MeshVertex), (void*)offsetof(MeshVertex, pos));
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(2, 3, GL_FLOAT, GL_FALSE, sizeof(MeshVertex), (void*)offsetof(MeshVertex, normal));
+    glEnableVertexAttribArray(2);
+
+    VertexShader vs;
+    FragmentShader fs;
+    vs.setSource("./vertex.glsl");
+    fs.setSource("./frag.glsl");
+    Program cpuProg;
+    cpuProg.AttachShaders({&vs, &fs});
+
+    Program indirectProg, cull;
+    std::unique_ptr<IndirectRenderer> indirect;
+    if (gpuDriven) {
+        VertexShader indirectVs;
+        indirectVs.setSource("./indirect_vertex.glsl");
+        indirectProg.AttachShaders({&indirectVs, &fs});
+        ComputeShader cs;
+        cs.setSource("./cull.comp");
+        cull.AttachShaders({&cs});
+        indirect.reset(new IndirectRenderer(&cull, pool, instances, firstOfMesh));
+        glBindVertexArray(vao);
+        indirect->setupVertexArray();
+    }
+    std::cout << (gpuDriven ? "GPU culling, one glMultiDrawElementsIndirect" : "CPU culling, one draw per instance") << ", "
+              << instances.size() << " instances of " << pool.meshes.size() << " meshes\n";
+
+    if (verify) {
+        int result = runVerify(*indirect, instances, pool.meshes.size());
+        indirect.reset();
+        glfwTerminate();
+        return result;
+    }
+
+    glm::vec3 cameraPos(0.f, 5.f, 0.f);
+    cameraFront = glm::vec3(0.f,0.f,-1.f);
+    glm::vec3 cameraUp(0.,1.,0.f);
+
+    glm::mat4 view;
+    glm::mat4 proj = glm::perspective(glm::radians(45.f), float(screenWidth) / screenHeight, 0.1f, 150.f);
+
+    for (Program *prog : {&cpuProg, &indirectProg}) {
+        prog->UseProgram();
+        prog->setMat4("proj", proj);
+    }
+
+    glfwSetCursorPosCallback(win, mouseMovement); 
+    glfwSetInputMode(win, GLFW_CURSOR, GLFW_CURSOR_DISABLED);  
+
+    std::vector<std::vector<uint32_t>> visible;
+    GpuTimer timer;
+    double lastReport = glfwGetTime(), cpuMs = 0., gpuMs = 0.;
+    int frames = 0, gpuSamples = 0;
+    size_t draws = 0, visibleCount = 0;
+    
+    while (!glfwWindowShouldClose(win)) {
+        processInput(win, cameraPos, cameraFront, cameraUp);
+        view = glm::lookAt(cameraPos, cameraFront + cameraPos, cameraUp);
+        // G switches between the two paths when both are there
+        if (keyPressed(win, GLFW_KEY_G) && indirect)
+            gpuDriven = !gpuDriven;
+        Program &prog = gpuDriven ? indirectProg : cpuProg;
+        glm::vec4 planes[6];
+        frustumPlanes(proj * view, planes);
+
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+        auto start = std::chrono::steady_clock::now();
+        timer.begin();
+        if (gpuDriven) {
+            indirect->cullOnGpu(planes);
+            prog.UseProgram();
+            prog.setMat4("view", view);
+            glBindVertexArray(vao);
+            indirect->draw(prog);
+            draws += indirect->drawCount();
+        } else {
+            cullOnCpu(planes, instances, pool.meshes.size(), visible);
+            for (const std::vector<uint32_t> &v : visible)
+                visibleCount += v.size();
+            prog.UseProgram();
+            prog.setMat4("view", view);
+            glBindVertexArray(vao);
+            draws += drawOnCpu(prog, pool, instances, visible);
+        }
+        double ms = timer.end();
+        cpuMs += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        if (ms >= 0.) {
+            gpuMs += ms;
+            ++gpuSamples;
+        }
+
+        ++frames;
+        if (glfwGetTime() - lastReport > 1.) {
+            lastReport = glfwGetTime();
+            std::cout << (gpuDriven ? "indirect: " : "cpu: ") << cpuMs / frames << "ms cpu, " << (gpuSamples ? gpuMs / gpuSamples : 0.)
+                      << "ms gpu, " << double(draws) / frames << " draw calls per frame";
+            // the GPU path doesn't know how much it drew without reading it back, which is the point
+            if (!gpuDriven)
+                std::cout << ", " << double(visibleCount) / frames << " visible";
+            std::cout << "\n";
+            frames = gpuSamples = 0;
+            draws = visibleCount = 0;
+            cpuMs = gpuMs = 0.;
+        }
+        // polls different kinds of events, for example, when we close an application, it fetches that event
+        // or it fetches events like movement of the window.
+        // Without it you can neither move the window or close the window
+        glfwPollEvents();
+        // have you drawn the image, it is stored in the buffer. You can now swap this buffer with main buffer
+        // so the image appears
+        glfwSwapBuffers(win);
+    }
+    indirect.reset();
+    glfwTerminate();
+    
+    std::cout << "Window should close now!\n";
+
+    return EXIT_SUCCESS;
+
+}
@@ -0,0 +1,24 @@
+#version 330 core
+
+layout(location = 0) in vec3 aPos;
+layout(location = 2) in vec3 aNormal;
+
+out vec3 normal;
+out vec3 color;
+
+uniform mat4 proj;
+uniform mat4 view;
+uniform vec4 posScale;
+uniform int instanceId;
+
+// the same as in indirect_vertex.glsl, so both paths look alike
+vec3 instanceColor(uint id) {
+    uint h = id * 2654435761u;
+    return vec3((h >> 8) & 255u, (h >> 16) & 255u, (h >> 24) & 255u) / 255.0 * 0.6 + 0.4;
+}
+
+void main() {
+    gl_Position = proj * view * vec4(aPos * posScale.w + posScale.xyz, 1.0);
+    normal = aNormal;
+    color = instanceColor(uint(instanceId));
+}
@@ -0,0 +1,956 @@
+#include <GL/glew.h>
+
+#include <GLFW/glfw3.h>
+#include <algorithm>
+#include <cstdarg>
+#include <cstddef>
+#include <cfloat>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <random>
+#include <vector>
+#include <glm/ext/matrix_clip_space.hpp>
+#include <glm/ext/matrix_transform.hpp>
+#include <glm/geometric.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/ext/matrix_float4x4.hpp>
+#include <glm/gtc/type_ptr.hpp>
+#include <glm/glm.hpp>
+#include <glm/trigonometric.hpp>
+#define STB_IMAGE_IMPLEMENTATION
+#include <stb/stb_image.h>
+#include <iostream>
+
+// ---------------------------------------------------------------------------------------------------------
+// counters the overlay shows. every GL call in this file goes through GL() or one of the wrappers below, so
+// they're counted where they happen. the per-frame counts are reset at the start of every frame
+// ---------------------------------------------------------------------------------------------------------
+
+struct FrameCounters {
+    size_t drawCalls = 0, glCalls = 0, triangles = 0;
+    // everything this program put on the GPU, buffers and textures
+    size_t gpuBytes = 0;
+};
+
+FrameCounters counters;
+
+#define GL(call) (++counters.glCalls, call)
+
+void countedBufferData(GLenum target, size_t size, const void *data, GLenum usage) {
+    ++counters.glCalls;
+    glBufferData(target, size, data, usage);
+    counters.gpuBytes += size;
+}
+
+// level 0 of a 2D texture from unsigned bytes. counted at the size of the pixels handed over, what the
+// driver pads them to is its business
+void countedTexImage2D(GLint internalFormat, GLsizei width, GLsizei height, GLenum format, const void *pixels) {
+    ++counters.glCalls;
+    glTexImage2D(GL_TEXTURE_2D, 0, internalFormat, width, height, 0, format, GL_UNSIGNED_BYTE, pixels);
+    size_t channels = format == GL_RED ? 1 : format == GL_RG ? 2 : format == GL_RGB ? 3 : 4;
+    counters.gpuBytes += size_t(width) * height * channels;
+}
+
+void countedDrawArrays(GLenum mode, GLint first, GLsizei count) {
+    ++counters.glCalls;
+    glDrawArrays(mode, first, count);
+    ++counters.drawCalls;
+    counters.triangles += mode == GL_TRIANGLES ? count / 3 : 0;
+}
+
+void countedDrawElements(GLenum mode, GLsizei count, GLenum type, size_t offset) {
+    ++counters.glCalls;
+    glDrawElements(mode, count, type, (void*)offset);
+    ++counters.drawCalls;
+    counters.triangles += mode == GL_TRIANGLES ? count / 3 : 0;
+}
+
+
+class Shader {
+    std::string src; 
+protected:
+    const char *getsrc() {
+        return src.data();
+    }
+    GLuint shader_id = 0;
+    bool isCompiled = false;
+protected:
+    virtual const char *getClassName() = 0;
+    GLint getCompilationStatus(GLuint shader_id) {
+        int status;
+        GL(glGetShaderiv(shader_id, GL_COMPILE_STATUS, &status));
+        return status;
+    }
+    void sendError() {
+        char buffer[1024];
+        GL(glGetShaderInfoLog(shader_id, 1024, NULL, buffer));
+        std::cerr << "ERROR::" << getClassName() << " - " << buffer;
+    }
+public:
+    virtual void compile() = 0;
+    void setSource(const char *s) {
+        std::ifstream sourceFile(s);
+        if (!sourceFile.is_open())
+            return;
+        char buffer[8192];
+        while (sourceFile.read(buffer, 8192)) {
+            src.append(buffer, 8192);
+        }
+        if (!sourceFile.eof()) {
+            src.clear();
+            return;
+        }
+        src.append(buffer, sourceFile.gcount());
+    }
+    friend class Program;
+};
+
+
+class VertexShader : public Shader {
+    virtual const char *getClassName() override {
+        return "VertexShader";
+    }
+public:
+    virtual void compile() override {
+        if (shader_id)
+            GL(glDeleteShader(shader_id));
+        shader_id = GL(glCreateShader(GL_VERTEX_SHADER));
+        const char *src = getsrc();
+        GL(glShaderSource(shader_id, 1, &src, NULL));
+        GL(glCompileShader(shader_id));
+        if (!getCompilationStatus(shader_id)) {
+            sendError();
+        }
+        isCompiled = true;
+    }
+};
+
+class FragmentShader : public Shader {
+    const char *getClassName() override {
+        return "FragmentShader";
+    }
+public:
+    virtual void compile() override {
+        if (shader_id)
+            GL(glDeleteShader(shader_id));
+        shader_id = GL(glCreateShader(GL_FRAGMENT_SHADER));
+        const char *src = getsrc();
+        GL(glShaderSource(shader_id, 1, &src, NULL));
+        GL(glCompileShader(shader_id));
+        if (!getCompilationStatus(shader_id)) {
+            sendError();
+        }
+        isCompiled = true;
+    }
+};
+
+
+class Program {
+    GLuint program_id = 0;
+    void sendError() {
+        char buffer[1024];
+        GL(glGetProgramInfoLog(program_id, 1024, NULL, buffer));
+        std::cerr << "ERROR::PROGRAM: " << " - " << buffer;
+    }
+    bool linkStatus() {
+        int status = 0;
+        GL(glGetProgramiv(program_id, GL_LINK_STATUS, &status));
+        return status;
+    }
+public:
+    Program() {
+        program_id = GL(glCreateProgram());
+    }
+    ~Program() {
+        GL(glDeleteProgram(program_id));
+    }
+    void AttachShaders(std::initializer_list<Shader*> shaders) {
+        auto i = shaders.begin();
+        while (i != shaders.end()) {
+            if (!(*i)->isCompiled)
+                (*i)->compile();
+            GL(glAttachShader(program_id, (*i)->shader_id));
+            ++i;
+        }
+        GL(glLinkProgram(program_id));
+        if (!linkStatus()) {
+            sendError();
+        }
+    }
+    void UseProgram() {
+        GL(glUseProgram(program_id));
+    }
+    void setMat4(const char *locName, const glm::mat4 &mat) {
+        int location = GL(glGetUniformLocation(program_id, locName));
+        if (location == -1)
+            return;
+        GL(glUniformMatrix4fv(location, 1, GL_FALSE, glm::value_ptr(mat)));
+    }
+    void setInt(const char *locName, int value) {
+        int location = GL(glGetUniformLocation(program_id, locName));
+        if (location == -1)
+            return;
+        GL(glUniform1i(location, value));
+    }
+    void setFloat(const char *locName, float value) {
+        int location = GL(glGetUniformLocation(program_id, locName));
+        if (location == -1)
+            return;
+        GL(glUniform1f(location, value));
+    }
+    void setVec2(const char *locName, const glm::vec2 &vec) {
+        int location = GL(glGetUniformLocation(program_id, locName));
+        if (location == -1)
+            return;
+        GL(glUniform2f(location, vec.x, vec.y));
+    }
+    void setVec3(const char *locName, const glm::vec3 &vec) {
+        int location = GL(glGetUniformLocation(program_id, locName));
+        if (location == -1)
+            return;
+        GL(glUniform3f(location, vec.x, vec.y, vec.z));
+    }
+    void setVec4(const char *locName, const glm::vec4 &vec) {
+        int location = GL(glGetUniformLocation(program_id, locName));
+        if (location == -1)
+            return;
+        GL(glUniform4f(location, vec.x, vec.y, vec.z, vec.w));
+    }
+};
+
+
+class Texture2D {
+    GLuint tex_id;
+public:
+    void generate2DTex(const char *image_path) {
+        int width, height, nChannels;
+        stbi_set_flip_vertically_on_load(true);
+        uint8_t *raw_image = stbi_load(image_path, &width, &height, &nChannels, 0);
+        float borderColor[] = {1.f, 1.f, 1.f, 1.f};
+        GL(glGenTextures(1, &tex_id));
+        GL(glBindTexture(GL_TEXTURE_2D, tex_id));
+        // what to do when primitive is bigger than the texture
+        GL(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_BORDER));
+        GL(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_BORDER));
+        GL(glTexParameterfv(GL_TEXTURE_2D, GL_TEXTURE_BORDER_COLOR, borderColor));
+        GL(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST));
+        GL(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR));
+        // glTexImage2D(TARGET_TYPE, IM_MIPMAP_LEVEL, TARGET_NRCHANNELS, SRC_WIDTH, SRC_HEIGHT, LEGACY_0, SRC_NRCHANNELS, SRC_DATA_TYPE, SRC_DATA);
+        countedTexImage2D(GL_RGB, width, height, GL_RGB, raw_image);
+        stbi_image_free(raw_image);
+    }
+    void bind() {
+        GL(glBindTexture(GL_TEXTURE_2D, tex_id));
+    }
+};
+
+
+struct DriverMemoryInfo {
+    const char *source = nullptr;  // null when neither extension is there
+    size_t totalKB = 0, freeKB = 0;
+};
+
+DriverMemoryInfo queryDriverMemory() {
+    DriverMemoryInfo info;
+    if (GLEW_NVX_gpu_memory_info) {
+        GLint total = 0, available = 0;
+        GL(glGetIntegerv(GL_GPU_MEMORY_INFO_DEDICATED_VIDMEM_NVX, &total));
+        GL(glGetIntegerv(GL_GPU_MEMORY_INFO_CURRENT_AVAILABLE_VIDMEM_NVX, &available));
+        info.source = "NVX";
+        info.totalKB = size_t(total);
+        info.freeKB = size_t(available);
+    } else if (GLEW_ATI_meminfo) {
+        // free in the pool, largest free block, and the same two for shared memory
+        GLint texture[4] = {};
+        GL(glGetIntegerv(GL_TEXTURE_FREE_MEMORY_ATI, texture));
+        info.source = "ATI";
+        info.freeKB = size_t(texture[0]);
+    }
+    return info;
+}
+
+class GpuTimer {
+    static constexpr int QUERIES = 4;
+    GLuint queries[QUERIES] = {};
+    int frame = 0;
+public:
+    GpuTimer() {
+        GL(glGenQueries(QUERIES, queries));
+    }
+    ~GpuTimer() {
+        GL(glDeleteQueries(QUERIES, queries));
+    }
+    void begin() {
+        GL(glBeginQuery(GL_TIME_ELAPSED, queries[frame % QUERIES]));
+    }
+    // returns the milliseconds of an older frame, or a negative value if there is none yet
+    double end() {
+        GL(glEndQuery(GL_TIME_ELAPSED));
+        ++frame;
+        if (frame < QUERIES)
+            return -1.;
+        GLuint oldest = queries[frame % QUERIES];
+        GLint available = 0;
+        GL(glGetQueryObjectiv(oldest, GL_QUERY_RESULT_AVAILABLE, &available));
+        if (!available)
+            return -1.;
+        GLuint64 ns = 0;
+        GL(glGetQueryObjectui64v(oldest, GL_QUERY_RESULT, &ns));
+        return ns / 1e6;
+    }
+};
+
+
+// ---------------------------------------------------------------------------------------------------------
+// the overlay. a 5x7 font is baked once into a small single channel atlas, 16 x 6 cells of 8x8 texels,
+// the last cell solid so boxes and lines can use the same texture. a frame's text, boxes and lines are
+// all quads appended to one vertex array, which goes up in one glBufferSubData and is drawn with one
+// glDrawElements against a prebuilt quad index buffer
+// ---------------------------------------------------------------------------------------------------------
+
+constexpr int GLYPH_WIDTH = 5, GLYPH_HEIGHT = 7;
+constexpr int ATLAS_CELL = 8, ATLAS_COLUMNS = 16, ATLAS_ROWS = 6;
+constexpr int ATLAS_WIDTH = ATLAS_CELL * ATLAS_COLUMNS, ATLAS_HEIGHT = ATLAS_CELL * ATLAS_ROWS;
+constexpr int FIRST_GLYPH = 32, GLYPH_COUNT = 95;
+constexpr int SOLID_CELL = GLYPH_COUNT;
+
+// ascii 32 to 126, a row a byte from the top, the leftmost pixel in bit 4
+const uint8_t FONT_5X7[GLYPH_COUNT * GLYPH_HEIGHT] = {
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,  // space
+    0x04, 0x04, 0x04, 0x04, 0x04, 0x00, 0x04,  // !
+    0x0a, 0x0a, 0x0a, 0x00, 0x00, 0x00, 0x00,  // "
+    0x0a, 0x0a, 0x1f, 0x0a, 0x1f, 0x0a, 0x0a,  // #
+    0x04, 0x0f, 0x14, 0x0e, 0x05, 0x1e, 0x04,  // $
+    0x18, 0x19, 0x02, 0x04, 0x08, 0x13, 0x03,  // %
+    0x0c, 0x12, 0x14, 0x08, 0x15, 0x12, 0x0d,  // &
+    0x04, 0x04, 0x08, 0x00, 0x00, 0x00, 0x00,  // quote
+    0x02, 0x04, 0x08, 0x08, 0x08, 0x04, 0x02,  // (
+    0x08, 0x04, 0x02, 0x02, 0x02, 0x04, 0x08,  // )
+    0x00, 0x04, 0x15, 0x0e, 0x15, 0x04, 0x00,  // *
+    0x00, 0x04, 0x04, 0x1f, 0x04, 0x04, 0x00,  // +
+    0x00, 0x00, 0x00, 0x00, 0x0c, 0x04, 0x08,  // ,
+    0x00, 0x00, 0x00, 0x1f, 0x00, 0x00, 0x00,  // -
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x0c, 0x0c,  // .
+    0x00, 0x01, 0x02, 0x04, 0x08, 0x10, 0x00,  // /
+    0x0e, 0x11, 0x13, 0x15, 0x19, 0x11, 0x0e,  // 0
+    0x04, 0x0c, 0x04, 0x04, 0x04, 0x04, 0x0e,  // 1
+    0x0e, 0x11, 0x01, 0x02, 0x04, 0x08, 0x1f,  // 2
+    0x1f, 0x02, 0x04, 0x02, 0x01, 0x11, 0x0e,  // 3
+    0x02, 0x06, 0x0a, 0x12, 0x1f, 0x02, 0x02,  // 4
+    0x1f, 0x10, 0x1e, 0x01, 0x01, 0x11, 0x0e,  // 5
+    0x06, 0x08, 0x10, 0x1e, 0x11, 0x11, 0x0e,  // 6
+    0x1f, 0x01, 0x02, 0x04, 0x08, 0x08, 0x08,  // 7
+    0x0e, 0x11, 0x11, 0x0e, 0x11, 0x11, 0x0e,  // 8
+    0x0e, 0x11, 0x11, 0x0f, 0x01, 0x02, 0x0c,  // 9
+    0x00, 0x0c, 0x0c, 0x00, 0x0c, 0x0c, 0x00,  // :
+    0x00, 0x0c, 0x0c, 0x00, 0x0c, 0x04, 0x08,  // ;
+    0x02, 0x04, 0x08, 0x10, 0x08, 0x04, 0x02,  // <
+    0x00, 0x00, 0x1f, 0x00, 0x1f, 0x00, 0x00,  // =
+    0x08, 0x04, 0x02, 0x01, 0x02, 0x04, 0x08,  // >
+    0x0e, 0x11, 0x01, 0x02, 0x04, 0x00, 0x04,  // ?
+    0x0e, 0x11, 0x01, 0x0d, 0x15, 0x15, 0x0e,  // @
+    0x0e, 0x11, 0x11, 0x11, 0x1f, 0x11, 0x11,  // A
+    0x1e, 0x11, 0x11, 0x1e, 0x11, 0x11, 0x1e,  // B
+    0x0e, 0x11, 0x10, 0x10, 0x10, 0x11, 0x0e,  // C
+    0x1c, 0x12, 0x11, 0x11, 0x11, 0x12, 0x1c,  // D
+    0x1f, 0x10, 0x10, 0x1e, 0x10, 0x10, 0x1f,  // E
+    0x1f, 0x10, 0x10, 0x1e, 0x10, 0x10, 0x10,  // F
+    0x0e, 0x11, 0x10, 0x17, 0x11, 0x11, 0x0f,  // G
+    0x11, 0x11, 0x11, 0x1f, 0x11, 0x11, 0x11,  // H
+    0x0e, 0x04, 0x04, 0x04, 0x04, 0x04, 0x0e,  // I
+    0x07, 0x02, 0x02, 0x02, 0x02, 0x12, 0x0c,  // J
+    0x11, 0x12, 0x14, 0x18, 0x14, 0x12, 0x11,  // K
+    0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x1f,  // L
+    0x11, 0x1b, 0x15, 0x15, 0x11, 0x11, 0x11,  // M
+    0x11, 0x11, 0x19, 0x15, 0x13, 0x11, 0x11,  // N
+    0x0e, 0x11, 0x11, 0x11, 0x11, 0x11, 0x0e,  // O
+    0x1e, 0x11, 0x11, 0x1e, 0x10, 0x10, 0x10,  // P
+    0x0e, 0x11, 0x11, 0x11, 0x15, 0x12, 0x0d,  // Q
+    0x1e, 0x11, 0x11, 0x1e, 0x14, 0x12, 0x11,  // R
+    0x0f, 0x10, 0x10, 0x0e, 0x01, 0x01, 0x1e,  // S
+    0x1f, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04,  // T
+    0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x0e,  // U
+    0x11, 0x11, 0x11, 0x11, 0x11, 0x0a, 0x04,  // V
+    0x11, 0x11, 0x11, 0x15, 0x15, 0x15, 0x0a,  // W
+    0x11, 0x11, 0x0a, 0x04, 0x0a, 0x11, 0x11,  // X
+    0x11, 0x11, 0x11, 0x0a, 0x04, 0x04, 0x04,  // Y
+    0x1f, 0x01, 0x02, 0x04, 0x08, 0x10, 0x1f,  // Z
+    0x0e, 0x08, 0x08, 0x08, 0x08, 0x08, 0x0e,  // [
+    0x00, 0x10, 0x08, 0x04, 0x02, 0x01, 0x00,  // backslash
+    0x0e, 0x02, 0x02, 0x02, 0x02, 0x02, 0x0e,  // ]
+    0x04, 0x0a, 0x11, 0x00, 0x00, 0x00, 0x00,  // ^
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x1f,  // _
+    0x08, 0x04, 0x02, 0x00, 0x00, 0x00, 0x00,  // `
+    0x00, 0x00, 0x0e, 0x01, 0x0f, 0x11, 0x0f,  // a
+    0x10, 0x10, 0x16, 0x19, 0x11, 0x11, 0x1e,  // b
+    0x00, 0x00, 0x0e, 0x10, 0x10, 0x11, 0x0e,  // c
+    0x01, 0x01, 0x0d, 0x13, 0x11, 0x11, 0x0f,  // d
+    0x00, 0x00, 0x0e, 0x11, 0x1f, 0x10, 0x0e,  // e
+    0x06, 0x09, 0x08, 0x1c, 0x08, 0x08, 0x08,  // f
+    0x00, 0x0f, 0x11, 0x11, 0x0f, 0x01, 0x0e,  // g
+    0x10, 0x10, 0x16, 0x19, 0x11, 0x11, 0x11,  // h
+    0x04, 0x00, 0x0c, 0x04, 0x04, 0x04, 0x0e,  // i
+    0x02, 0x00, 0x06, 0x02, 0x02, 0x12, 0x0c,  // j
+    0x10, 0x10, 0x12, 0x14, 0x18, 0x14, 0x12,  // k
+    0x0c, 0x04, 0x04, 0x04, 0x04, 0x04, 0x0e,  // l
+    0x00, 0x00, 0x1a, 0x15, 0x15, 0x11, 0x11,  // m
+    0x00, 0x00, 0x16, 0x19, 0x11, 0x11, 0x11,  // n
+    0x00, 0x00, 0x0e, 0x11, 0x11, 0x11, 0x0e,  // o
+    0x00, 0x00, 0x1e, 0x11, 0x1e, 0x10, 0x10,  // p
+    0x00, 0x00, 0x0d, 0x13, 0x0f, 0x01, 0x01,  // q
+    0x00, 0x00, 0x16, 0x19, 0x10, 0x10, 0x10,  // r
+    0x00, 0x00, 0x0e, 0x10, 0x0e, 0x01, 0x1e,  // s
+    0x08, 0x08, 0x1c, 0x08, 0x08, 0x09, 0x06,  // t
+    0x00, 0x00, 0x11, 0x11, 0x11, 0x13, 0x0d,  // u
+    0x00, 0x00, 0x11, 0x11, 0x11, 0x0a, 0x04,  // v
+    0x00, 0x00, 0x11, 0x11, 0x15, 0x15, 0x0a,  // w
+    0x00, 0x00, 0x11, 0x0a, 0x04, 0x0a, 0x11,  // x
+    0x00, 0x00, 0x11, 0x11, 0x0f, 0x01, 0x0e,  // y
+    0x00, 0x00, 0x1f, 0x02, 0x04, 0x08, 0x1f,  // z
+    0x02, 0x04, 0x04, 0x08, 0x04, 0x04, 0x02,  // {
+    0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04,  // |
+    0x08, 0x04, 0x04, 0x02, 0x04, 0x04, 0x08,  // }
+    0x00, 0x00, 0x08, 0x15, 0x02, 0x00, 0x00,  // ~
+};
+
+std::vector<uint8_t> bakeGlyphAtlas() {
+    std::vector<uint8_t> atlas(ATLAS_WIDTH * ATLAS_HEIGHT, 0);
+    for (int glyph = 0; glyph < GLYPH_COUNT; ++glyph) {
+        int cellX = glyph % ATLAS_COLUMNS * ATLAS_CELL, cellY = glyph / ATLAS_COLUMNS * ATLAS_CELL;
+        for (int y = 0; y < GLYPH_HEIGHT; ++y)
+            for (int x = 0; x < GLYPH_WIDTH; ++x)
+                if (FONT_5X7[glyph * GLYPH_HEIGHT + y] & (0x10 >> x))
+                    atlas[(cellY + y) * ATLAS_WIDTH + cellX + x] = 255;
+    }
+    int cellX = SOLID_CELL % ATLAS_COLUMNS * ATLAS_CELL, cellY = SOLID_CELL / ATLAS_COLUMNS * ATLAS_CELL;
+    for (int y = 0; y < ATLAS_CELL; ++y)
+        std::memset(&atlas[(cellY + y) * ATLAS_WIDTH + cellX], 255, ATLAS_CELL);
+    return atlas;
+}
+
+// 16 bytes: pixels from the top left, texels of the atlas, and a color
+struct OverlayVertex {
+    float x, y;
+    uint16_t u, v;
+    uint32_t color;
+};
+
+constexpr uint32_t rgba(uint8_t r, uint8_t g, uint8_t b, uint8_t a = 255) {
+    return uint32_t(r) | uint32_t(g) << 8 | uint32_t(b) << 16 | uint32_t(a) << 24;
+}
+
+// builds one frame of overlay quads on the CPU. no GL in here, so --bench can time it on its own
+class OverlayBatch {
+    std::vector<OverlayVertex> vertices;
+    size_t maxQuads;
+public:
+    float scale = 2.f;  // screen pixels per font pixel
+    size_t dropped = 0;  // quads that didn't fit this frame
+
+    explicit OverlayBatch(size_t maxQuads) : maxQuads(maxQuads) {
+        vertices.reserve(maxQuads * 4);
+    }
+    void clear() {
+        vertices.clear();
+        dropped = 0;
+    }
+    size_t quadCount() const {
+        return vertices.size() / 4;
+    }
+    const OverlayVertex *data() const {
+        return vertices.data();
+    }
+    // corners in the order the index buffer wants them: top left, top right, bottom left, bottom right
+    void quad(float x0, float y0, float x1, float y1, int u0, int v0, int u1, int v1, uint32_t color) {
+        if (vertices.size() >= maxQuads * 4) {
+            ++dropped;
+            return;
+        }
+        vertices.push_back({x0, y0, uint16_t(u0), uint16_t(v0), color});
+        vertices.push_back({x1, y0, uint16_t(u1), uint16_t(v0), color});
+        vertices.push_back({x0, y1, uint16_t(u0), uint16_t(v1), color});
+        vertices.push_back({x1, y1, uint16_t(u1), uint16_t(v1), color});
+    }
+    void rect(float x, float y, float w, float h, uint32_t color) {
+        int u = SOLID_CELL % ATLAS_COLUMNS * ATLAS_CELL, v = SOLID_CELL / ATLAS_COLUMNS * ATLAS_CELL;
+        // the middle of the solid cell, so filtering never reaches a neighbour
+        quad(x, y, x + w, y + h, u + 2, v + 2, u + 6, v + 6, color);
+    }
+    // a line is a thin quad along it
+    void line(float x0, float y0, float x1, float y1, uint32_t color, float width = 1.f) {
+        float dx = x1 - x0, dy = y1 - y0, length = std::sqrt(dx * dx + dy * dy);
+        if (length <= 0.f)
+            return;
+        float nx = -dy / length * width * 0.5f, ny = dx / length * width * 0.5f;
+        if (vertices.size() >= maxQuads * 4) {
+            ++dropped;
+            return;
+        }
+        uint16_t u = SOLID_CELL % ATLAS_COLUMNS * ATLAS_CELL + 4, v = SOLID_CELL / ATLAS_COLUMNS * ATLAS_CELL + 4;
+        vertices.push_back({x0 + nx, y0 + ny, u, v, color});
+        vertices.push_back({x1 + nx, y1 + ny, u, v, color});
+        vertices.push_back({x0 - nx, y0 - ny, u, v, color});
+        vertices.push_back({x1 - nx, y1 - ny, u, v, color});
+    }
+    // returns the x after the last character. '\n' starts a new line at x
+    float text(float x, float y, uint32_t color, const char *s) {
+        const float advance = (GLYPH_WIDTH + 1) * scale, lineHeight = (GLYPH_HEIGHT + 2) * scale;
+        float penX = x;
+        for (; *s; ++s) {
+            int c = (unsigned char)*s;
+            if (c == '\n') {
+                penX = x;
+                y += lineHeight;
+                continue;
+            }
+            if (c != ' ') {
+                int glyph = c >= FIRST_GLYPH && c < FIRST_GLYPH + GLYPH_COUNT ? c - FIRST_GLYPH : '?' - FIRST_GLYPH;
+                int u = glyph % ATLAS_COLUMNS * ATLAS_CELL, v = glyph / ATLAS_COLUMNS * ATLAS_CELL;
+                quad(penX, y, penX + GLYPH_WIDTH * scale, y + GLYPH_HEIGHT * scale, u, v, u + GLYPH_WIDTH, v + GLYPH_HEIGHT, color);
+            }
+            penX += advance;
+        }
+        return penX;
+    }
+    float textf(float x, float y, uint32_t color, const char *format, ...) __attribute__((format(printf, 5, 6))) {
+        char buffer[256];
+        va_list args;
+        va_start(args, format);
+        std::vsnprintf(buffer, sizeof(buffer), format, args);
+        va_end(args);
+        return text(x, y, color, buffer);
+    }
+    float lineHeight() const {
+        return (GLYPH_HEIGHT + 2) * scale;
+    }
+    // values[(first + i) % count] for i in [0, count), oldest first, scaled so top is full height. the
+    // budget line is drawn across at its value
+    void graph(float x, float y, float w, float h, const float *values, size_t count, size_t first, float top, float budget) {
+        rect(x, y, w, h, rgba(0, 0, 0, 160));
+        float step = w / float(count > 1 ? count - 1 : 1);
+        auto at = [&](size_t i) { return y + h - std::min(values[(first + i) % count] / top, 1.f) * h; };
+        float lastY = at(0);
+        for (size_t i = 1; i < count; ++i) {
+            float nextY = at(i);
+            float value = values[(first + i) % count];
+            line(x + (i - 1) * step, lastY, x + i * step, nextY, value > budget ? rgba(255, 80, 60) : rgba(120, 255, 120));
+            lastY = nextY;
+        }
+        float budgetY = y + h - std::min(budget / top, 1.f) * h;
+        line(x, budgetY, x + w, budgetY, rgba(255, 255, 0, 160));
+    }
+};
+
+// the GL side: the atlas, the streaming vertex buffer, the quad indices and the program
+class DebugOverlay {
+    GLuint atlas_id = 0, vao_id = 0, vbo_id = 0, ebo_id = 0;
+    size_t maxQuads;
+    Program prog;
+public:
+    explicit DebugOverlay(size_t maxQuads) : maxQuads(maxQuads) {
+        std::vector<uint8_t> atlas = bakeGlyphAtlas();
+        GL(glGenTextures(1, &atlas_id));
+        GL(glBindTexture(GL_TEXTURE_2D, atlas_id));
+        GL(glPixelStorei(GL_UNPACK_ALIGNMENT, 1));
+        countedTexImage2D(GL_R8, ATLAS_WIDTH, ATLAS_HEIGHT, GL_RED, atlas.data());
+        GL(glPixelStorei(GL_UNPACK_ALIGNMENT, 4));
+        // whole font pixels, the text is drawn at integer scales
+        GL(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST));
+        GL(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST));
+        GL(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE));
+        GL(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE));
+
+        GL(glGenVertexArrays(1, &vao_id));
+        GL(glBindVertexArray(vao_id));
+        GL(glGenBuffers(1, &vbo_id));
+        GL(glBindBuffer(GL_ARRAY_BUFFER, vbo_id));
+        countedBufferData(GL_ARRAY_BUFFER, maxQuads * 4 * sizeof(OverlayVertex), NULL, GL_STREAM_DRAW);
+        // every quad is the same two triangles, so the indices are made once for the most quads there can be
+        std::vector<uint32_t> indices(maxQuads * 6);
+        for (uint32_t q = 0; q < maxQuads; ++q) {
+            const uint32_t corners[6] = {0, 2, 1, 1, 2, 3};
+            for (int i = 0; i < 6; ++i)
+                indices[q * 6 + i] = q * 4 + corners[i];
+        }
+        GL(glGenBuffers(1, &ebo_id));
+        GL(glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ebo_id));
+        countedBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(uint32_t), indices.data(), GL_STATIC_DRAW);
+        GL(glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, sizeof(OverlayVertex), (void*)offsetof(OverlayVertex, x)));
+        GL(glEnableVertexAttribArray(0));
+        // texels as they are, the shader divides by the atlas size
+        GL(glVertexAttribPointer(1, 2, GL_UNSIGNED_SHORT, GL_FALSE, sizeof(OverlayVertex), (void*)offsetof(OverlayVertex, u)));
+        GL(glEnableVertexAttribArray(1));
+        GL(glVertexAttribPointer(2, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(OverlayVertex), (void*)offsetof(OverlayVertex, color)));
+        GL(glEnableVertexAttribArray(2));
+        GL(glBindVertexArray(0));
+
+        VertexShader vs;
+        FragmentShader fs;
+        vs.setSource("./overlay_vertex.glsl");
+        fs.setSource("./overlay_frag.glsl");
+        prog.AttachShaders({&vs, &fs});
+        prog.UseProgram();
+        prog.setInt("atlas", 0);
+        prog.setVec2("atlasSize", glm::vec2(ATLAS_WIDTH, ATLAS_HEIGHT));
+    }
+    ~DebugOverlay() {
+        GL(glDeleteBuffers(1, &ebo_id));
+        GL(glDeleteBuffers(1, &vbo_id));
+        GL(glDeleteVertexArrays(1, &vao_id));
+        GL(glDeleteTextures(1, &atlas_id));
+    }
+    DebugOverlay(const DebugOverlay&) = delete;
+    DebugOverlay &operator=(const DebugOverlay&) = delete;
+
+    // on top of whatever is in the framebuffer, in one draw
+    void draw(const OverlayBatch &batch, int screenWidth, int screenHeight) {
+        size_t quads = std::min(batch.quadCount(), maxQuads);
+        if (!quads)
+            return;
+        GL(glBindBuffer(GL_ARRAY_BUFFER, vbo_id));
+        // orphaning: the driver hands us fresh memory instead of waiting for last frame's draw to finish
+        GL(glBufferData(GL_ARRAY_BUFFER, maxQuads * 4 * sizeof(OverlayVertex), NULL, GL_STREAM_DRAW));
+        GL(glBufferSubData(GL_ARRAY_BUFFER, 0, quads * 4 * sizeof(OverlayVertex), batch.data()));
+        GL(glDisable(GL_DEPTH_TEST));
+        GL(glEnable(GL_BLEND));
+        GL(glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA));
+        prog.UseProgram();
+        prog.setVec2("screenSize", glm::vec2(screenWidth, screenHeight));
+        GL(glActiveTexture(GL_TEXTURE0));
+        GL(glBindTexture(GL_TEXTURE_2D, atlas_id));
+        GL(glBindVertexArray(vao_id));
+        countedDrawElements(GL_TRIANGLES, GLsizei(quads * 6), GL_UNSIGNED_INT, 0);
+        GL(glBindVertexArray(0));
+        GL(glDisable(GL_BLEND));
+        GL(glEnable(GL_DEPTH_TEST));
+    }
+};
+
+
+// what the HUD shows. frame times are kept for the last FRAME_HISTORY frames for the graph
+constexpr size_t FRAME_HISTORY = 240;
+
+struct HudState {
+    float frameMs[FRAME_HISTORY] = {};
+    size_t newest = 0;
+    FrameCounters last;  // the previous frame's, this one's are still counting
+    double overlayCpuMs = 0., overlayGpuMs = 0.;
+    DriverMemoryInfo driver;
+
+    void push(float ms) {
+        newest = (newest + 1) % FRAME_HISTORY;
+        frameMs[newest] = ms;
+    }
+};
+
+void buildHud(OverlayBatch &batch, const HudState &hud, int screenWidth) {
+    const float pad = 8.f, width = std::min(420.f, screenWidth - 2 * pad);
+    batch.clear();
+    float worst = 0.f, sum = 0.f;
+    for (float ms : hud.frameMs) {
+        worst = std::max(worst, ms);
+        sum += ms;
+    }
+    const float lh = batch.lineHeight();
+    batch.rect(pad - 4.f, pad - 4.f, width + 8.f, lh * 7 + 88.f, rgba(0, 0, 0, 120));
+    float y = pad;
+    batch.textf(pad, y, rgba(255, 255, 255), "frame %5.2f ms  avg %5.2f  worst %5.2f", hud.frameMs[hud.newest], sum / FRAME_HISTORY, worst);
+    y += lh;
+    batch.graph(pad, y, width, 80.f, hud.frameMs, FRAME_HISTORY, (hud.newest + 1) % FRAME_HISTORY, 33.3f, 16.7f);
+    y += 84.f;
+    batch.textf(pad, y, rgba(200, 220, 255), "draws %zu  gl calls %zu", hud.last.drawCalls, hud.last.glCalls);
+    y += lh;
+    batch.textf(pad, y, rgba(200, 220, 255), "triangles %zu", hud.last.triangles);
+    y += lh;
+    batch.textf(pad, y, rgba(255, 220, 160), "gpu memory %.2f MB ours", hud.last.gpuBytes / (1024. * 1024.));
+    y += lh;
+    if (hud.driver.source && hud.driver.totalKB)
+        batch.textf(pad, y, rgba(255, 220, 160), "driver %s: %zu of %zu MB free", hud.driver.source, hud.driver.freeKB / 1024, hud.driver.totalKB / 1024);
+    else if (hud.driver.source)
+        batch.textf(pad, y, rgba(255, 220, 160), "driver %s: %zu MB free", hud.driver.source, hud.driver.freeKB / 1024);
+    else
+        batch.text(pad, y, rgba(160, 160, 160), "driver: no memory info extension");
+    y += lh;
+    batch.textf(pad, y, rgba(160, 255, 160), "overlay cpu %.3f ms  gpu %.3f ms", hud.overlayCpuMs, hud.overlayGpuMs);
+    y += lh;
+    batch.text(pad, y, rgba(160, 160, 160), "H: hide  +/-: cubes");
+}
+
+
+// --bench: builds the HUD over and over, the CPU part of the overlay's cost
+int runBench(int frames) {
+    OverlayBatch batch(4096);
+    HudState hud;
+    std::mt19937 rng(1);
+    std::uniform_real_distribution<float> jitter(12.f, 22.f);
+    for (size_t i = 0; i < FRAME_HISTORY; ++i)
+        hud.push(jitter(rng));
+    hud.last.drawCalls = 1001;
+    hud.last.glCalls = 3017;
+    hud.last.triangles = 12012;
+    hud.last.gpuBytes = 5u << 20;
+
+    std::vector<uint8_t> atlas;
+    auto start = std::chrono::steady_clock::now();
+    atlas = bakeGlyphAtlas();
+    double bakeMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    start = std::chrono::steady_clock::now();
+    for (int frame = 0; frame < frames; ++frame) {
+        hud.push(jitter(rng));
+        buildHud(batch, hud, 1280);
+    }
+    double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    std::printf("atlas %dx%d, %zu bytes, baked in %.3f ms\n", ATLAS_WIDTH, ATLAS_HEIGHT, atlas.size(), bakeMs);
+    std::printf("hud: %zu quads, %zu bytes of vertices a frame, built in %.4f ms a frame over %d frames\n", batch.quadCount(),
+                batch.quadCount() * 4 * sizeof(OverlayVertex), ms / frames, frames);
+    return batch.dropped ? EXIT_FAILURE : EXIT_SUCCESS;
+}
+
+
+void processInput(GLFWwindow *window, glm::vec3 &cameraPos, glm::vec3 &cameraFront, glm::vec3 &cameraUp)
+{
+
+    const float cameraSpeed = 0.05f; // adjust accordingly
+    if (glfwGetKey(window, GLFW_KEY_W) == GLFW_PRESS)
+        cameraPos += cameraSpeed * cameraFront;
+    if (glfwGetKey(window, GLFW_KEY_S) == GLFW_PRESS)
+        cameraPos -= cameraSpeed * cameraFront;
+    if (glfwGetKey(window, GLFW_KEY_A) == GLFW_PRESS)
+        cameraPos -= glm::normalize(glm::cross(cameraFront, cameraUp)) * cameraSpeed;
+    if (glfwGetKey(window, GLFW_KEY_D) == GLFW_PRESS)
+        cameraPos += glm::normalize(glm::cross(cameraFront, cameraUp)) * cameraSpeed;
+    if (glfwGetKey(window, GLFW_KEY_UP) == GLFW_PRESS)
+        cameraPos += glm::normalize(glm::cross(cameraFront, cameraUp)) * cameraSpeed;
+
+}
+
+// true only on the frame the key went down
+bool keyPressed(GLFWwindow *window, int key) {
+    static bool down[GLFW_KEY_LAST + 1] = {};
+    bool now = glfwGetKey(window, key) == GLFW_PRESS;
+    bool pressed = now && !down[key];
+    down[key] = now;
+    return pressed;
+}
+
+
+float yaw = -90.f;
+float pitch = 0.f;
+glm::vec3 cameraFront;
+
+void mouseMovement(GLFWwindow *window, double xPos, double yPos) {
+    static float lastX = xPos, lastY = yPos;
+    float xOffset = xPos - lastX;
+    float yOffset = lastY - yPos;
+    
+    constexpr float sensitivity = 0.05f;
+    xOffset *= sensitivity;
+    yOffset *= sensitivity;
+
+    yaw += xOffset;
+    pitch += yOffset;
+
+    if (std::abs(pitch) > 89.f) // don't ever do it this way. I am lazy
+        pitch = std::abs(pitch) / pitch * 89.f;
+
+    cameraFront.x = cos(glm::radians(yaw)) * cos(glm::radians(pitch));
+    cameraFront.y = sin(glm::radians(pitch));
+    cameraFront.z = sin(glm::radians(yaw)) * cos(glm::radians(pitch));
+
+    cameraFront = glm::normalize(cameraFront);
+    lastX = xPos, lastY = yPos;
+}
+
+
+int main(int argc, char **argv) {
+    for (int i = 1; i < argc; ++i)
+        if (!std::strcmp(argv[i], "--bench"))
+            return runBench(i + 1 < argc ? std::max(1, std::atoi(argv[i + 1])) : 100000);
+
+    if (glfwInit() != GLFW_TRUE) {
+        glfwTerminate();
+        std::cerr << "Failed to initialize GLFW";
+        return EXIT_FAILURE;
+    }
+    // setting OpenGL version to 3.3
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+    GLFWwindow *win = glfwCreateWindow(800, 600, "This is a hello window!", NULL, NULL);
+    // setting 'context' for OpenGL, i.e. where to draw on current thread
+    glfwMakeContextCurrent(win);
+    // all it does is fetches us the implemented functions of OpenGL
+    if (glewInit() != GLEW_OK) {
+        glfwTerminate();
+        std::cerr << "Failed to initialize GLEW\n";
+        return EXIT_FAILURE;
+    }
+    int screenWidth, screenHeight;
+    glfwGetFramebufferSize(win, &screenWidth, &screenHeight);
+    GL(glViewport(0, 0, screenWidth, screenHeight));
+
+    GL(glEnable(GL_DEPTH_TEST));
+    float triangle_data[] = {
+        //   vertpos   //  //   normal   //  //texcord//
+    -0.5f, -0.5f, -0.5f,  0.0f,  0.0f, -1.0f,  0.0f, 0.0f,
+     0.5f, -0.5f, -0.5f,  0.0f,  0.0f, -1.0f,  1.0f, 0.0f,
+     0.5f,  0.5f, -0.5f,  0.0f,  0.0f, -1.0f,  1.0f, 1.0f,
+     0.5f,  0.5f, -0.5f,  0.0f,  0.0f, -1.0f,  1.0f, 1.0f,
+    -0.5f,  0.5f, -0.5f,  0.0f,  0.0f, -1.0f,  0.0f, 1.0f,
+    -0.5f, -0.5f, -0.5f,  0.0f,  0.0f, -1.0f,  0.0f, 0.0f,
+
+    -0.5f, -0.5f,  0.5f,  0.0f,  0.0f,  1.0f,  0.0f, 0.0f,
+     0.5f, -0.5f,  0.5f,  0.0f,  0.0f,  1.0f,  1.0f, 0.0f,
+     0.5f,  0.5f,  0.5f,  0.0f,  0.0f,  1.0f,  1.0f, 1.0f,
+     0.5f,  0.5f,  0.5f,  0.0f,  0.0f,  1.0f,  1.0f, 1.0f,
+    -0.5f,  0.5f,  0.5f,  0.0f,  0.0f,  1.0f,  0.0f, 1.0f,
+    -0.5f, -0.5f,  0.5f,  0.0f,  0.0f,  1.0f,  0.0f, 0.0f,
+
+    -0.5f,  0.5f,  0.5f, -1.0f,  0.0f,  0.0f,  1.0f, 0.0f,
+    -0.5f,  0.5f, -0.5f, -1.0f,  0.0f,  0.0f,  1.0f, 1.0f,
+    -0.5f, -0.5f, -0.5f, -1.0f,  0.0f,  0.0f,  0.0f, 1.0f,
+    -0.5f, -0.5f, -0.5f, -1.0f,  0.0f,  0.0f,  0.0f, 1.0f,
+    -0.5f, -0.5f,  0.5f, -1.0f,  0.0f,  0.0f,  0.0f, 0.0f,
+    -0.5f,  0.5f,  0.5f, -1.0f,  0.0f,  0.0f,  1.0f, 0.0f,
+
+     0.5f,  0.5f,  0.5f,  1.0f,  0.0f,  0.0f,  1.0f, 0.0f,
+     0.5f,  0.5f, -0.5f,  1.0f,  0.0f,  0.0f,  1.0f, 1.0f,
+     0.5f, -0.5f, -0.5f,  1.0f,  0.0f,  0.0f,  0.0f, 1.0f,
+     0.5f, -0.5f, -0.5f,  1.0f,  0.0f,  0.0f,  0.0f, 1.0f,
+     0.5f, -0.5f,  0.5f,  1.0f,  0.0f,  0.0f,  0.0f, 0.0f,
+     0.5f,  0.5f,  0.5f,  1.0f,  0.0f,  0.0f,  1.0f, 0.0f,
+
+    -0.5f, -0.5f, -0.5f,  0.0f, -1.0f,  0.0f,  0.0f, 1.0f,
+     0.5f, -0.5f, -0.5f,  0.0f, -1.0f,  0.0f,  1.0f, 1.0f,
+     0.5f, -0.5f,  0.5f,  0.0f, -1.0f,  0.0f,  1.0f, 0.0f,
+     0.5f, -0.5f,  0.5f,  0.0f, -1.0f,  0.0f,  1.0f, 0.0f,
+    -0.5f, -0.5f,  0.5f,  0.0f, -1.0f,  0.0f,  0.0f, 0.0f,
+    -0.5f, -0.5f, -0.5f,  0.0f, -1.0f,  0.0f,  0.0f, 1.0f,
+
+    -0.5f,  0.5f, -0.5f,  0.0f,  1.0f,  0.0f,  0.0f, 1.0f,
+     0.5f,  0.5f, -0.5f,  0.0f,  1.0f,  0.0f,  1.0f, 1.0f,
+     0.5f,  0.5f,  0.5f,  0.0f,  1.0f,  0.0f,  1.0f, 0.0f,
+     0.5f,  0.5f,  0.5f,  0.0f,  1.0f,  0.0f,  1.0f, 0.0f,
+    -0.5f,  0.5f,  0.5f,  0.0f,  1.0f,  0.0f,  0.0f, 0.0f,
+    -0.5f,  0.5f, -0.5f,  0.0f,  1.0f,  0.0f,  0.0f, 1.0f
+        
+    };
+
+
+    glm::vec3 cameraPos(0.f, 0.f, 3.f);
+    cameraFront = glm::vec3(0.f,0.f,-1.f);
+    glm::vec3 cameraUp(0.,1.,0.f);
+
+    Texture2D tex;
+    tex.generate2DTex("./image2d.tex");
+    tex.bind();
+
+    GLuint vbo = 0;
+    GL(glGenBuffers(1, &vbo)); 
+    GL(glBindBuffer(GL_ARRAY_BUFFER, vbo));
+    countedBufferData(GL_ARRAY_BUFFER, sizeof(triangle_data), triangle_data, GL_STATIC_DRAW);
+
+    GLuint vao = 0;
+    GL(glGenVertexArrays(1, &vao));
+    GL(glBindVertexArray(vao));
+    GL(glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)0));
+    GL(glEnableVertexAttribArray(0));
+    GL(glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)(6 * sizeof(float))));
+    GL(glEnableVertexAttribArray(1));
+    GL(glVertexAttribPointer(2, 3, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)(3 * sizeof(float))));
+    GL(glEnableVertexAttribArray(2));
+
+    VertexShader vs;
+    FragmentShader fs;
+    vs.setSource("./vertex.glsl");
+    fs.setSource("./frag.glsl");
+    Program prog;
+    prog.AttachShaders({&vs, &fs});
+
+    prog.UseProgram();
+    prog.setInt("tex", 0);
+
+    DebugOverlay overlay(4096);
+    OverlayBatch batch(4096);
+    HudState hud;
+    GpuTimer overlayTimer;
+    bool showHud = true;
+    // a draw call per cube, so there's something to count
+    int cubes = 500;
+
+    glfwSetCursorPosCallback(win, mouseMovement); 
+    glfwSetInputMode(win, GLFW_CURSOR, GLFW_CURSOR_DISABLED);  
+
+    double lastFrame = glfwGetTime(), lastDriverQuery = 0.;
+    
+    while (!glfwWindowShouldClose(win)) {
+        double now = glfwGetTime();
+        hud.push(float((now - lastFrame) * 1000.));
+        lastFrame = now;
+        hud.last = counters;
+        counters.drawCalls = counters.glCalls = counters.triangles = 0;
+
+        processInput(win, cameraPos, cameraFront, cameraUp);
+        if (keyPressed(win, GLFW_KEY_H))
+            showHud = !showHud;
+        if (keyPressed(win, GLFW_KEY_EQUAL))
+            cubes = std::min(cubes * 2, 64000);
+        if (keyPressed(win, GLFW_KEY_MINUS))
+            cubes = std::max(cubes / 2, 1);
+
+        glm::mat4 view = glm::lookAt(cameraPos, cameraPos + cameraFront, cameraUp);
+        glfwGetFramebufferSize(win, &screenWidth, &screenHeight);
+        glm::mat4 proj = glm::perspective(glm::radians(45.f), screenHeight > 0 ? float(screenWidth) / screenHeight : 1.f, 0.1f, 200.f);
+
+        prog.UseProgram();
+        prog.setMat4("view", view);
+        prog.setMat4("proj", proj);
+        GL(glViewport(0, 0, screenWidth, screenHeight));
+        GL(glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT));
+        GL(glBindVertexArray(vao));
+        tex.bind();
+        const int side = int(std::ceil(std::sqrt(float(cubes))));
+        for (int i = 0; i < cubes; ++i) {
+            glm::vec3 pos((i % side - side / 2) * 1.5f, 0.f, -(i / side) * 1.5f);
+            glm::mat4 model = glm::rotate(glm::translate(glm::mat4(1.f), pos), float(now) + i * 0.1f, glm::vec3(0.f, 1.f, 0.f));
+            prog.setMat4("model", model);
+            countedDrawArrays(GL_TRIANGLES, 0, 36);
+        }
+
+        if (showHud) {
+            // driver queries can be slow, twice a second is plenty
+            if (now - lastDriverQuery > 0.5) {
+                hud.driver = queryDriverMemory();
+                lastDriverQuery = now;
+            }
+            auto overlayStart = std::chrono::steady_clock::now();
+            overlayTimer.begin();
+            buildHud(batch, hud, screenWidth);
+            overlay.draw(batch, screenWidth, screenHeight);
+            double gpuMs = overlayTimer.end();
+            if (gpuMs >= 0.)
+                hud.overlayGpuMs = gpuMs;
+            hud.overlayCpuMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - overlayStart).count();
+        }
+
+        // polls different kinds of events, for example, when we close an application, it fetches that event
+        // or it fetches events like movement of the window.
+        // Without it you can neither move the window or close the window
+        glfwPollEvents();
+        // have you drawn the image, it is stored in the buffer. You can now swap this buffer with main buffer
+        // so the image appears
+        glfwSwapBuffers(win);
+    }
+    GL(glDeleteBuffers(1, &vbo));
+    GL(glDeleteVertexArrays(1, &vao));
+    glfwTerminate();
+    
+    std::cout << "Window should close now!\n";
+
+    return EXIT_SUCCESS;
+
+}
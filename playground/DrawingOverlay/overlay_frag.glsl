@@ -0,0 +1,15 @@
+#version 330 core
+
+out vec4 FragColor;
+in vec2 texCoord;
+in vec4 color;
+
+// coverage in red, 0 or 1
+uniform sampler2D atlas;
+
+void main() {
+    float coverage = texture(atlas, texCoord).r;
+    if (coverage == 0.0)
+        discard;
+    FragColor = vec4(color.rgb, color.a * coverage);
+}
@@ -0,0 +1,21 @@
+#version 330 core
+
+// pixels from the top left corner of the screen
+layout(location = 0) in vec2 aPos;
+// texels of the glyph atlas
+layout(location = 1) in vec2 aTexel;
+layout(location = 2) in vec4 aColor;
+
+out vec2 texCoord;
+out vec4 color;
+
+uniform vec2 screenSize;
+uniform vec2 atlasSize;
+
+
+void main() {
+    vec2 ndc = aPos / screenSize * 2.0 - 1.0;
+    gl_Position = vec4(ndc.x, -ndc.y, 0.0, 1.0);
+    texCoord = aTexel / atlasSize;
+    color = aColor;
+}
@@ -0,0 +1,710 @@
+#include <GL/glew.h>
+
+#include <GLFW/glfw3.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <queue>
+#include <random>
+#include <tuple>
+#include <vector>
+#include <glm/ext/matrix_clip_space.hpp>
+#include <glm/ext/matrix_transform.hpp>
+#include <glm/geometric.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/ext/matrix_float4x4.hpp>
+#include <glm/gtc/type_ptr.hpp>
+#include <glm/glm.hpp>
+#include <glm/trigonometric.hpp>
+#define STB_IMAGE_IMPLEMENTATION
+#include <stb/stb_image.h>
+#include <iostream>
+
+class Shader {
+    std::string src; 
+protected:
+    const char *getsrc() {
+        return src.data();
+    }
+    GLuint shader_id = 0;
+    bool isCompiled = false;
+protected:
+    virtual const char *getClassName() = 0;
+    GLint getCompilationStatus(GLuint shader_id) {
+        int status;
+        glGetShaderiv(shader_id, GL_COMPILE_STATUS, &status);
+        return status;
+    }
+    void sendError() {
+        char buffer[1024];
+        glGetShaderInfoLog(shader_id, 1024, NULL, buffer);
+        std::cerr << "ERROR::" << getClassName() << " - " << buffer;
+    }
+public:
+    virtual void compile() = 0;
+    void setSource(const char *s) {
+        std::ifstream sourceFile(s);
+        if (!sourceFile.is_open())
+            return;
+        char buffer[8192];
+        while (sourceFile.read(buffer, 8192)) {
+            src.append(buffer, 8192);
+        }
+        if (!sourceFile.eof()) {
+            src.clear();
+            return;
+        }
+        src.append(buffer, sourceFile.gcount());
+    }
+    friend class Program;
+};
+
+
+class VertexShader : public Shader {
+    virtual const char *getClassName() override {
+        return "VertexShader";
+    }
+public:
+    virtual void compile() override {
+        if (shader_id)
+            glDeleteShader(shader_id);
+        shader_id = glCreateShader(GL_VERTEX_SHADER);
+        const char *src = getsrc();
+        glShaderSource(shader_id, 1, &src, NULL);
+        glCompileShader(shader_id);
+        if (!getCompilationStatus(shader_id)) {
+            sendError();
+        }
+        isCompiled = true;
+    }
+};
+
+class FragmentShader : public Shader {
+    const char *getClassName() override {
+        return "FragmentShader";
+    }
+public:
+    virtual void compile() override {
+        if (shader_id)
+            glDeleteShader(shader_id);
+        shader_id = glCreateShader(GL_FRAGMENT_SHADER);
+        const char *src = getsrc();
+        glShaderSource(shader_id, 1, &src, NULL);
+        glCompileShader(shader_id);
+        if (!getCompilationStatus(shader_id)) {
+            sendError();
+        }
+        isCompiled = true;
+    }
+};
+
+
+class Program {
+    GLuint program_id = 0;
+    void sendError() {
+        char buffer[1024];
+        glGetProgramInfoLog(program_id, 1024, NULL, buffer);
+        std::cerr << "ERROR::PROGRAM: " << " - " << buffer;
+    }
+    bool linkStatus() {
+        int status = 0;
+        glGetProgramiv(program_id, GL_LINK_STATUS, &status);
+        return status;
+    }
+public:
+    Program() {
+        program_id = glCreateProgram();
+    }
+    ~Program() {
+        glDeleteProgram(program_id);
+    }
+    void AttachShaders(std::initializer_list<Shader*> shaders) {
+        auto i = shaders.begin();
+        while (i != shaders.end()) {
+            if (!(*i)->isCompiled)
+                (*i)->compile();
+            glAttachShader(program_id, (*i)->shader_id);
+            ++i;
+        }
+        glLinkProgram(program_id);
+        if (!linkStatus()) {
+            sendError();
+        }
+    }
+    void UseProgram() {
+        glUseProgram(program_id);
+    }
+    void setMat4(const char *locName, const glm::mat4 &mat) {
+        int location = glGetUniformLocation(program_id, locName);
+        if (location == -1)
+            return;
+        glUniformMatrix4fv(location, 1, GL_FALSE, glm::value_ptr(mat));
+    }
+};
+
+
+class Texture2D {
+    GLuint tex_id;
+public:
+    void generate2DTex(const char *image_path) {
+        int width, height, nChannels;
+        stbi_set_flip_vertically_on_load(true);
+        uint8_t *raw_image = stbi_load(image_path, &width, &height, &nChannels, 0);
+        float borderColor[] = {1.f, 1.f, 1.f, 1.f};
+        glGenTextures(1, &tex_id);
+        glBindTexture(GL_TEXTURE_2D, tex_id);
+        // what to do when primitive is bigger than the texture
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_BORDER);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_BORDER);
+        glTexParameterfv(GL_TEXTURE_2D, GL_TEXTURE_BORDER_COLOR, borderColor);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        // glTexImage2D(TARGET_TYPE, IM_MIPMAP_LEVEL, TARGET_NRCHANNELS, SRC_WIDTH, SRC_HEIGHT, LEGACY_0, SRC_NRCHANNELS, SRC_DATA_TYPE, SRC_DATA);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, width, height, 0, GL_RGB, GL_UNSIGNED_BYTE, raw_image);
+        stbi_image_free(raw_image);
+    }
+    void bind() {
+        glBindTexture(GL_TEXTURE_2D, tex_id);
+    }
+};
+
+
+struct Vertex {
+    glm::vec3 pos;
+    glm::vec2 uv;
+};
+
+// one LOD is a range of the shared index buffer, all LODs use the same vertices
+struct MeshLOD {
+    uint32_t indexOffset;
+    uint32_t indexCount;
+    float error;  // world space distance the surface may have moved compared to the base mesh
+};
+
+struct LODMesh {
+    std::vector<Vertex> vertices;
+    std::vector<uint32_t> indices;  // base mesh first, then every LOD after it
+    std::vector<MeshLOD> lods;
+    float radius = 0.f;
+};
+
+// uv sphere, the u = 0 / u = 1 column is duplicated so it has a real uv seam
+void buildSphere(int rings, int segments, std::vector<Vertex> &vertices, std::vector<uint32_t> &indices) {
+    for (int r = 0; r <= rings; ++r) {
+        float theta = glm::pi<float>() * r / rings;
+        for (int s = 0; s <= segments; ++s) {
+            float phi = 2.f * glm::pi<float>() * s / segments;
+            // the ring at the seam gets the exact same position, sin(2pi) isn't exactly 0
+            if (s == segments)
+                phi = 0.f;
+            glm::vec3 pos(std::sin(theta) * std::cos(phi), std::cos(theta), std::sin(theta) * std::sin(phi));
+            if (r == 0 || r == rings)
+                pos = glm::vec3(0.f, r == 0 ? 1.f : -1.f, 0.f);
+            vertices.push_back({pos, glm::vec2(float(s) / segments, 1.f - float(r) / rings)});
+        }
+    }
+    for (int r = 0; r < rings; ++r) {
+        for (int s = 0; s < segments; ++s) {
+            uint32_t a = r * (segments + 1) + s, b = a + segments + 1;
+            if (r != 0)
+                indices.insert(indices.end(), {a, a + 1, b});
+            if (r != rings - 1)
+                indices.insert(indices.end(), {a + 1, b + 1, b});
+        }
+    }
+}
+
+
+// quadric error metric, Garland & Heckbert: sum of squared distances to a set of planes
+struct Quadric {
+    double a[10] = {};  // upper triangle of the symmetric 4x4 matrix
+
+    void addPlane(const glm::vec3 &n, float d) {
+        const double p[4] = {n.x, n.y, n.z, d};
+        int k = 0;
+        for (int i = 0; i < 4; ++i)
+            for (int j = i; j < 4; ++j)
+                a[k++] += p[i] * p[j];
+    }
+    void add(const Quadric &q) {
+        for (int i = 0; i < 10; ++i)
+            a[i] += q.a[i];
+    }
+    double error(const glm::vec3 &v) const {
+        const double p[4] = {v.x, v.y, v.z, 1.};
+        double e = 0.;
+        int k = 0;
+        for (int i = 0; i < 4; ++i)
+            for (int j = i; j < 4; ++j)
+                e += (i == j ? 1. : 2.) * a[k++] * p[i] * p[j];
+        return std::max(e, 0.);
+    }
+};
+
+// half edge collapse simplifier. vertices are never moved or created, one vertex just gets merged
+// into a neighbour, so uvs stay exact and every LOD can share the base vertex buffer.
+// uv seams (two vertices at the same position) may only collapse along the seam, and both sides
+// collapse together; anything else on an open border or shared by more copies stays put
+class Simplifier {
+    enum Kind : uint8_t { MANIFOLD, SEAM, LOCKED };
+
+    const std::vector<Vertex> &vertices;
+    std::vector<uint32_t> tris;               // 3 per triangle, rewritten as vertices collapse
+    std::vector<uint8_t> triAlive;
+    std::vector<std::vector<uint32_t>> vertTris;
+    std::vector<uint32_t> posId;              // vertices at the same position share a quadric
+    std::vector<Quadric> quadrics;
+    std::vector<Kind> kind;
+    std::vector<uint32_t> twin;               // the other side of a seam vertex
+    std::vector<uint8_t> removed;
+    size_t liveTriangles = 0;
+
+    struct Candidate {
+        double cost;
+        uint32_t from, to;
+        bool operator<(const Candidate &o) const {
+            return cost > o.cost;
+        }
+    };
+    std::priority_queue<Candidate> heap;
+
+    bool sharesTriangle(uint32_t v, uint32_t u) const {
+        for (uint32_t t : vertTris[v]) {
+            if (!triAlive[t])
+                continue;
+            for (int i = 0; i < 3; ++i)
+                if (tris[t * 3 + i] == u)
+                    return true;
+        }
+        return false;
+    }
+    // no triangle around v may flip when v moves onto u
+    bool flips(uint32_t v, uint32_t u) const {
+        const glm::vec3 &target = vertices[u].pos;
+        for (uint32_t t : vertTris[v]) {
+            if (!triAlive[t])
+                continue;
+            const uint32_t *tri = &tris[t * 3];
+            if (tri[0] == u || tri[1] == u || tri[2] == u)
+                continue;
+            glm::vec3 p[3], q[3];
+            for (int i = 0; i < 3; ++i) {
+                p[i] = vertices[tri[i]].pos;
+                q[i] = tri[i] == v ? target : p[i];
+            }
+            glm::vec3 before = glm::cross(p[1] - p[0], p[2] - p[0]);
+            glm::vec3 after = glm::cross(q[1] - q[0], q[2] - q[0]);
+            if (glm::dot(before, after) <= 0.25f * glm::length(before) * glm::length(after))
+                return true;
+        }
+        return false;
+    }
+    // returns a negative cost if v can't go to u
+    double cost(uint32_t v, uint32_t u) const {
+        if (removed[v] || removed[u] || kind[v] == LOCKED || !sharesTriangle(v, u))
+            return -1.;
+        if (kind[v] == SEAM) {
+            // along the seam only, and the other side has to be able to follow
+            if (kind[u] != SEAM || !sharesTriangle(twin[v], twin[u]) || flips(twin[v], twin[u]))
+                return -1.;
+        }
+        if (flips(v, u))
+            return -1.;
+        Quadric q = quadrics[posId[v]];
+        q.add(quadrics[posId[u]]);
+        return q.error(vertices[u].pos);
+    }
+    void push(uint32_t v, uint32_t u) {
+        double c = cost(v, u);
+        if (c >= 0.)
+            heap.push({c, v, u});
+    }
+    void collapse(uint32_t v, uint32_t u) {
+        for (uint32_t t : vertTris[v]) {
+            if (!triAlive[t])
+                continue;
+            uint32_t *tri = &tris[t * 3];
+            for (int i = 0; i < 3; ++i)
+                if (tri[i] == v)
+                    tri[i] = u;
+            if (tri[0] == tri[1] || tri[1] == tri[2] || tri[0] == tri[2]) {
+                triAlive[t] = 0;
+                --liveTriangles;
+            } else {
+                vertTris[u].push_back(t);
+            }
+        }
+        vertTris[v].clear();
+        removed[v] = 1;
+    }
+    void pushNeighbours(uint32_t u) {
+        // (duplicates in the heap are fine, stale entries get thrown away when they come up)
+        for (uint32_t t : vertTris[u]) {
+            if (!triAlive[t])
+                continue;
+            for (int i = 0; i < 3; ++i) {
+                uint32_t n = tris[t * 3 + i];
+                if (n == u)
+                    continue;
+                push(n, u);
+                push(u, n);
+            }
+        }
+    }
+public:
+    Simplifier(const std::vector<Vertex> &vertices, const uint32_t *indices, size_t indexCount)
+        : vertices(vertices), tris(indices, indices + indexCount), triAlive(indexCount / 3, 1),
+          vertTris(vertices.size()), posId(vertices.size()), kind(vertices.size(), MANIFOLD),
+          twin(vertices.size(), UINT32_MAX), removed(vertices.size(), 0), liveTriangles(indexCount / 3) {
+        // weld by exact position
+        std::map<std::tuple<float, float, float>, uint32_t> positions;
+        std::vector<std::vector<uint32_t>> copies;
+        for (uint32_t v = 0; v < vertices.size(); ++v) {
+            auto key = std::make_tuple(vertices[v].pos.x, vertices[v].pos.y, vertices[v].pos.z);
+            auto it = positions.emplace(key, uint32_t(copies.size())).first;
+            if (it->second == copies.size())
+                copies.emplace_back();
+            posId[v] = it->second;
+            copies[it->second].push_back(v);
+        }
+        quadrics.resize(copies.size());
+        std::map<std::pair<uint32_t, uint32_t>, int> edgeUse;
+        for (uint32_t t = 0; t < triAlive.size(); ++t) {
+            const uint32_t *tri = &tris[t * 3];
+            glm::vec3 n = glm::cross(vertices[tri[1]].pos - vertices[tri[0]].pos, vertices[tri[2]].pos - vertices[tri[0]].pos);
+            if (glm::length(n) > 0.f) {
+                n = glm::normalize(n);
+                float d = -glm::dot(n, vertices[tri[0]].pos);
+                for (int i = 0; i < 3; ++i)
+                    quadrics[posId[tri[i]]].addPlane(n, d);
+            }
+            for (int i = 0; i < 3; ++i) {
+                vertTris[tri[i]].push_back(t);
+                uint32_t a = tri[i], b = tri[(i + 1) % 3];
+                ++edgeUse[{std::min(a, b), std::max(a, b)}];
+            }
+        }
+        std::vector<uint8_t> onBorder(vertices.size(), 0);
+        for (const auto &e : edgeUse) {
+            if (e.second == 1)
+                onBorder[e.first.first] = onBorder[e.first.second] = 1;
+        }
+        for (uint32_t v = 0; v < vertices.size(); ++v) {
+            const std::vector<uint32_t> &same = copies[posId[v]];
+            if (same.size() == 1)
+                kind[v] = onBorder[v] ? LOCKED : MANIFOLD;
+            else if (same.size() == 2 && onBorder[same[0]] && onBorder[same[1]])
+                kind[v] = SEAM, twin[v] = same[0] == v ? same[1] : same[0];
+            else
+                kind[v] = LOCKED;
+        }
+        for (uint32_t t = 0; t < triAlive.size(); ++t)
+            for (int i = 0; i < 3; ++i)
+                push(tris[t * 3 + i], tris[t * 3 + (i + 1) % 3]), push(tris[t * 3 + (i + 1) % 3], tris[t * 3 + i]);
+    }
+
+    // keeps collapsing the cheapest edge until we are at targetTriangles or nothing is left that is allowed.
+    // returns the worst error we had to accept (as a distance)
+    float simplify(size_t targetTriangles, std::vector<uint32_t> &out) {
+        double worst = 0.;
+        while (liveTriangles > targetTriangles && !heap.empty()) {
+            Candidate c = heap.top();
+            heap.pop();
+            double now = cost(c.from, c.to);
+            if (now < 0.)
+                continue;
+            if (now > c.cost * 1.0001 + 1e-12) {
+                // got worse since it was pushed, put it back where it belongs
+                heap.push({now, c.from, c.to});
+                continue;
+            }
+            worst = std::max(worst, now);
+            uint32_t v = c.from, u = c.to;
+            uint32_t tv = twin[v], tu = twin[u];
+            quadrics[posId[u]].add(quadrics[posId[v]]);
+            collapse(v, u);
+            if (kind[v] == SEAM)
+                collapse(tv, tu);
+            pushNeighbours(u);
+            if (kind[v] == SEAM)
+                pushNeighbours(tu);
+        }
+        out.clear();
+        for (uint32_t t = 0; t < triAlive.size(); ++t)
+            if (triAlive[t])
+                out.insert(out.end(), &tris[t * 3], &tris[t * 3] + 3);
+        return std::sqrt(worst);
+    }
+};
+
+// each LOD has about half the triangles of the previous one, down to a few hundred.
+// later LODs continue from the earlier ones, so errors only grow down the chain
+void generateLODs(LODMesh &mesh, int maxLods = 6) {
+    const size_t baseCount = mesh.indices.size();
+    mesh.lods.clear();
+    mesh.lods.push_back({0, uint32_t(baseCount), 0.f});
+    Simplifier simplifier(mesh.vertices, mesh.indices.data(), baseCount);
+    std::vector<uint32_t> lod;
+    size_t triangles = baseCount / 3;
+    for (int i = 1; i < maxLods && triangles > 256; ++i) {
+        float error = simplifier.simplify(triangles / 2, lod);
+        if (lod.size() / 3 >= triangles)
+            break;
+        triangles = lod.size() / 3;
+        mesh.lods.push_back({uint32_t(mesh.indices.size()), uint32_t(lod.size()), std::max(error, mesh.lods.back().error)});
+        mesh.indices.insert(mesh.indices.end(), lod.begin(), lod.end());
+    }
+    mesh.radius = 0.f;
+    for (const Vertex &v : mesh.vertices)
+        mesh.radius = std::max(mesh.radius, glm::length(v.pos));
+}
+
+
+// how many pixels an error of `error` world units is at `distance` from the camera
+float projectedError(float error, float distance, float screenHeight, float fovY) {
+    return error / std::max(distance, 1e-3f) * screenHeight / (2.f * std::tan(fovY * 0.5f));
+}
+
+// picks the coarsest LOD whose error stays under the threshold. to avoid popping back and forth when
+// an object sits right at a switch distance, we only go coarser once the next LOD is comfortably
+// (HYSTERESIS) below the threshold, and only go finer once the current one is above it
+constexpr float LOD_THRESHOLD_PIXELS = 1.f;
+constexpr float LOD_HYSTERESIS = 0.75f;
+
+int selectLOD(const LODMesh &mesh, int current, float distance, float screenHeight, float fovY) {
+    auto pixels = [&](int lod) {
+        return projectedError(mesh.lods[lod].error, distance, screenHeight, fovY);
+    };
+    while (current > 0 && pixels(current) > LOD_THRESHOLD_PIXELS)
+        --current;
+    while (current + 1 < int(mesh.lods.size()) && pixels(current + 1) < LOD_THRESHOLD_PIXELS * LOD_HYSTERESIS)
+        ++current;
+    return current;
+}
+
+
+// ./main --bench: generates the LOD chain, then flies through a field of spheres and compares
+// triangle counts and LOD switches with and without LODs / hysteresis
+int runBenchmark() {
+    LODMesh mesh;
+    buildSphere(128, 256, mesh.vertices, mesh.indices);
+    auto start = std::chrono::steady_clock::now();
+    generateLODs(mesh);
+    double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    std::cout << "generated " << mesh.lods.size() << " LODs in " << ms << "ms\n";
+    for (size_t i = 0; i < mesh.lods.size(); ++i)
+        std::cout << "  LOD" << i << ": " << mesh.lods[i].indexCount / 3 << " triangles, error " << mesh.lods[i].error << "\n";
+
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<float> spread(-300.f, 300.f);
+    std::vector<glm::vec3> instances(1000);
+    for (glm::vec3 &p : instances)
+        p = glm::vec3(spread(rng), spread(rng) * 0.1f, spread(rng));
+    std::vector<int> lodWith(instances.size(), 0), lodWithout(instances.size(), 0);
+    const float fovY = glm::radians(45.f), height = 600.f;
+    double full = 0., drawn = 0.;
+    float worstPixels = 0.f;
+    size_t switchesWith = 0, switchesWithout = 0;
+    constexpr int FRAMES = 600;
+    for (int f = 0; f < FRAMES; ++f) {
+        // back and forth along a line, slowly enough that objects hover around switch distances
+        glm::vec3 camera(std::sin(f * 0.01f) * 250.f, 0.f, 0.f);
+        for (size_t i = 0; i < instances.size(); ++i) {
+            float distance = std::max(glm::length(instances[i] - camera) - mesh.radius, 0.1f);
+            int lod = selectLOD(mesh, lodWith[i], distance, height, fovY);
+            switchesWith += lod != lodWith[i];
+            lodWith[i] = lod;
+            // the same thing without hysteresis: coarsest LOD under the threshold
+            int plain = 0;
+            while (plain + 1 < int(mesh.lods.size()) && projectedError(mesh.lods[plain + 1].error, distance, height, fovY) < LOD_THRESHOLD_PIXELS)
+                ++plain;
+            switchesWithout += plain != lodWithout[i];
+            lodWithout[i] = plain;
+            full += mesh.lods[0].indexCount / 3;
+            drawn += mesh.lods[lod].indexCount / 3;
+            worstPixels = std::max(worstPixels, projectedError(mesh.lods[lod].error, distance, height, fovY));
+        }
+    }
+    std::cout << "triangles per frame: " << drawn / FRAMES << " instead of " << full / FRAMES
+              << " (" << 100. * drawn / full << "%)\n"
+              << "worst projected error: " << worstPixels << "px (threshold " << LOD_THRESHOLD_PIXELS << "px)\n"
+              << "LOD switches: " << switchesWith << " with hysteresis, " << switchesWithout << " without\n";
+    return worstPixels <= LOD_THRESHOLD_PIXELS ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+
+void processInput(GLFWwindow *window, glm::vec3 &cameraPos, glm::vec3 &cameraFront, glm::vec3 &cameraUp)
+{
+
+    const float cameraSpeed = 0.05f; // adjust accordingly
+    if (glfwGetKey(window, GLFW_KEY_W) == GLFW_PRESS)
+        cameraPos += cameraSpeed * cameraFront;
+    if (glfwGetKey(window, GLFW_KEY_S) == GLFW_PRESS)
+        cameraPos -= cameraSpeed * cameraFront;
+    if (glfwGetKey(window, GLFW_KEY_A) == GLFW_PRESS)
+        cameraPos -= glm::normalize(glm::cross(cameraFront, cameraUp)) * cameraSpeed;
+    if (glfwGetKey(window, GLFW_KEY_D) == GLFW_PRESS)
+        cameraPos += glm::normalize(glm::cross(cameraFront, cameraUp)) * cameraSpeed;
+    if (glfwGetKey(window, GLFW_KEY_UP) == GLFW_PRESS)
+        cameraPos += glm::normalize(glm::cross(cameraFront, cameraUp)) * cameraSpeed;
+
+}
+
+
+float yaw = -90.f;
+float pitch = 0.f;
+glm::vec3 cameraFront;
+
+void mouseMovement(GLFWwindow *window, double xPos, double yPos) {
+    static float lastX = xPos, lastY = yPos;
+    float xOffset = xPos - lastX;
+    float yOffset = lastY - yPos;
+    
+    constexpr float sensitivity = 0.05f;
+    xOffset *= sensitivity;
+    yOffset *= sensitivity;
+
+    yaw += xOffset;
+    pitch += yOffset;
+
+    if (std::abs(pitch) > 89.f) // don't ever do it this way. I am lazy
+        pitch = std::abs(pitch) / pitch * 89.f;
+
+    cameraFront.x = cos(glm::radians(yaw)) * cos(glm::radians(pitch));
+    cameraFront.y = sin(glm::radians(pitch));
+    cameraFront.z = sin(glm::radians(yaw)) * cos(glm::radians(pitch));
+
+    cameraFront = glm::normalize(cameraFront);
+    lastX = xPos, lastY = yPos;
+}
+
+
+
+
+
+int main(int argc, char **argv) {
+    if (argc > 1 && !std::strcmp(argv[1], "--bench"))
+        return runBenchmark();
+
+    if (glfwInit() != GLFW_TRUE) {
+        glfwTerminate();
+        std::cerr << "Failed to initialize GLFW";
+        return EXIT_FAILURE;
+    }
+    // setting OpenGL version to 3.3
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+    GLFWwindow *win = glfwCreateWindow(600, 600, "This is a hello window!", NULL, NULL);
+    glViewport(0, 0, 600, 600);
+    // setting 'context' for OpenGL, i.e. where to draw on current thread
+    glfwMakeContextCurrent(win);
+    // all it does is fetches us the implemented functions of OpenGL
+    if (glewInit() != GLEW_OK) {
+        glfwTerminate();
+        std::cerr << "Failed to initialize GLEW\n";
+        return EXIT_FAILURE;
+    }
+
+    glEnable(GL_DEPTH_TEST);
+    glm::vec3 cameraPos(0.f, 0.f, 3.f);
+    cameraFront = glm::vec3(0.f,0.f,-1.f);
+    glm::vec3 cameraUp(0.,1.,0.f);
+    
+
+    Texture2D tex;
+    tex.generate2DTex("./image2d.tex");
+    tex.bind();
+
+    LODMesh sphere;
+    buildSphere(128, 256, sphere.vertices, sphere.indices);
+    generateLODs(sphere);
+
+    GLuint vbo = 0;
+    glGenBuffers(1, &vbo); 
+    glBindBuffer(GL_ARRAY_BUFFER, vbo);
+    glBufferData(GL_ARRAY_BUFFER, sphere.vertices.size() * sizeof(Vertex), sphere.vertices.data(), GL_STATIC_DRAW);
+
+    // the base mesh and all the LODs live in one index buffer
+    GLuint ebo = 0;
+    glGenBuffers(1, &ebo);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ebo);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, sphere.indices.size() * sizeof(uint32_t), sphere.indices.data(), GL_STATIC_DRAW);
+    
+    GLuint vao = 0;
+    glGenVertexArrays(1, &vao);
+    glBindVertexArray(vao);
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, pos));
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, uv));
+    glEnableVertexAttribArray(1);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ebo); // don't forget to bind ebo, because it uses vao to find ebo, vbo and attrib pointers
+
+    // a field of spheres, most of them far away
+    std::vector<glm::vec3> instances;
+    for (int z = 0; z < 40; ++z)
+        for (int x = 0; x < 40; ++x)
+            instances.push_back(glm::vec3((x - 20) * 6.f, 0.f, -z * 6.f));
+    std::vector<int> instanceLod(instances.size(), 0);
+    double lastReport = glfwGetTime();
+
+    VertexShader vs;
+    FragmentShader fs;
+    vs.setSource("./vertex.glsl");
+    fs.setSource("./frag.glsl");
+    Program prog;
+    prog.AttachShaders({&vs, &fs});
+    prog.UseProgram();
+
+
+    glm::mat4 view; // = glm::translate(glm::mat4(1.f), glm::vec3(0.f,0.f,-3.f));
+       
+
+    const float fovY = glm::radians(45.f);
+    glm::mat4 proj = glm::perspective(fovY, 800 / 600.f, 0.1f, 500.f);
+
+    prog.setMat4("proj", proj);
+    prog.setMat4("view", view);
+
+    glfwSetCursorPosCallback(win, mouseMovement); 
+    glfwSetInputMode(win, GLFW_CURSOR, GLFW_CURSOR_DISABLED);  
+    
+    while (!glfwWindowShouldClose(win)) {
+        processInput(win, cameraPos, cameraFront, cameraUp);
+        view = glm::lookAt(cameraPos, cameraFront + cameraPos, cameraUp);
+
+        prog.setMat4("view", view);
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+        size_t triangles = 0;
+        for (size_t i = 0; i < instances.size(); ++i) {
+            float distance = std::max(glm::length(instances[i] - cameraPos) - sphere.radius, 0.1f);
+            instanceLod[i] = selectLOD(sphere, instanceLod[i], distance, 600.f, fovY);
+            const MeshLOD &lod = sphere.lods[instanceLod[i]];
+            prog.setMat4("model", glm::translate(glm::mat4(1.f), instances[i]));
+            glDrawElements(GL_TRIANGLES, lod.indexCount, GL_UNSIGNED_INT, (void*)(lod.indexOffset * sizeof(uint32_t)));
+            triangles += lod.indexCount / 3;
+        }
+        if (glfwGetTime() - lastReport > 1.) {
+            lastReport = glfwGetTime();
+            std::cout << triangles << " triangles, " << instances.size() * (sphere.lods[0].indexCount / 3) << " without LODs\n";
+        }
+        // polls different kinds of events, for example, when we close an application, it fetches that event
+        // or it fetches events like movement of the window.
+        // Without it you can neither move the window or close the window
+        glfwPollEvents();
+        // have you drawn the image, it is stored in the buffer. You can now swap this buffer with main buffer
+        // so the image appears
+        glfwSwapBuffers(win);
+    }
+    glfwTerminate();
+    
+    std::cout << "Window should close now!\n";
+
+    return EXIT_SUCCESS;
+
+}
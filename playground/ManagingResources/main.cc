@@ -0,0 +1,769 @@
+#include <GL/glew.h>
+
+#include <GLFW/glfw3.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <fstream>
+#include <string>
+#include <utility>
+#include <vector>
+#include <glm/ext/matrix_clip_space.hpp>
+#include <glm/ext/matrix_transform.hpp>
+#include <glm/geometric.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/ext/matrix_float4x4.hpp>
+#include <glm/gtc/type_ptr.hpp>
+#include <glm/glm.hpp>
+#include <glm/trigonometric.hpp>
+#define STB_IMAGE_IMPLEMENTATION
+#include <stb/stb_image.h>
+#include <iostream>
+
+
+// ---------------------------------------------------------------------------------------------------------
+// owning handles. every GL object lives in exactly one handle, handles can be moved but not copied, and the
+// object goes away when its handle does. nothing calls glDelete* by hand anymore
+// ---------------------------------------------------------------------------------------------------------
+
+enum GLObjectKind {
+    GL_OBJECT_BUFFER,
+    GL_OBJECT_VERTEX_ARRAY,
+    GL_OBJECT_TEXTURE,
+    GL_OBJECT_FRAMEBUFFER,
+    GL_OBJECT_RENDERBUFFER,
+    GL_OBJECT_SAMPLER,
+    GL_OBJECT_QUERY,
+    GL_OBJECT_SHADER,
+    GL_OBJECT_PROGRAM,
+    GL_OBJECT_SYNC,
+    GL_OBJECT_KINDS
+};
+
+const char *glObjectName(GLObjectKind kind) {
+    static const char *names[GL_OBJECT_KINDS] = {"buffer", "vertex array", "texture", "framebuffer", "renderbuffer",
+                                                 "sampler", "query", "shader", "program", "sync"};
+    return names[kind];
+}
+
+// how many of each kind were made and deleted. whatever is left over at shutdown leaked
+struct GLObjectCounts {
+    size_t created[GL_OBJECT_KINDS] = {};
+    size_t deleted[GL_OBJECT_KINDS] = {};
+    size_t live(GLObjectKind kind) const {
+        return created[kind] - deleted[kind];
+    }
+    size_t live() const {
+        size_t total = 0;
+        for (int i = 0; i < GL_OBJECT_KINDS; ++i)
+            total += live(GLObjectKind(i));
+        return total;
+    }
+    // prints what is still alive, returns false if anything is
+    bool reportLeaks() const {
+        bool clean = true;
+        for (int i = 0; i < GL_OBJECT_KINDS; ++i) {
+            if (!live(GLObjectKind(i)))
+                continue;
+            std::cerr << "ERROR::LEAK - " << live(GLObjectKind(i)) << " " << glObjectName(GLObjectKind(i))
+                      << " objects were never deleted (" << created[i] << " created)\n";
+            clean = false;
+        }
+        return clean;
+    }
+};
+
+GLObjectCounts glObjectCounts;
+
+void deleteGLObject(GLObjectKind kind, GLuint id) {
+    switch (kind) {
+    case GL_OBJECT_BUFFER:       glDeleteBuffers(1, &id); break;
+    case GL_OBJECT_VERTEX_ARRAY: glDeleteVertexArrays(1, &id); break;
+    case GL_OBJECT_TEXTURE:      glDeleteTextures(1, &id); break;
+    case GL_OBJECT_FRAMEBUFFER:  glDeleteFramebuffers(1, &id); break;
+    case GL_OBJECT_RENDERBUFFER: glDeleteRenderbuffers(1, &id); break;
+    case GL_OBJECT_SAMPLER:      glDeleteSamplers(1, &id); break;
+    case GL_OBJECT_QUERY:        glDeleteQueries(1, &id); break;
+    case GL_OBJECT_SHADER:       glDeleteShader(id); break;
+    case GL_OBJECT_PROGRAM:      glDeleteProgram(id); break;
+    default: return;  // syncs are pointers, FenceSync deletes its own
+    }
+    ++glObjectCounts.deleted[kind];
+}
+
+GLuint genGLObject(GLObjectKind kind) {
+    GLuint id = 0;
+    switch (kind) {
+    case GL_OBJECT_BUFFER:       glGenBuffers(1, &id); break;
+    case GL_OBJECT_VERTEX_ARRAY: glGenVertexArrays(1, &id); break;
+    case GL_OBJECT_TEXTURE:      glGenTextures(1, &id); break;
+    case GL_OBJECT_FRAMEBUFFER:  glGenFramebuffers(1, &id); break;
+    case GL_OBJECT_RENDERBUFFER: glGenRenderbuffers(1, &id); break;
+    case GL_OBJECT_SAMPLER:      glGenSamplers(1, &id); break;
+    case GL_OBJECT_QUERY:        glGenQueries(1, &id); break;
+    case GL_OBJECT_PROGRAM:      id = glCreateProgram(); break;
+    default: break;  // shaders need a type, see ShaderHandle
+    }
+    return id;
+}
+
+
+// a glFenceSync, owned the same way
+class FenceSync {
+    GLsync sync = nullptr;
+public:
+    FenceSync() = default;
+    FenceSync(const FenceSync&) = delete;
+    FenceSync &operator=(const FenceSync&) = delete;
+    FenceSync(FenceSync &&other) noexcept : sync(other.sync) {
+        other.sync = nullptr;
+    }
+    FenceSync &operator=(FenceSync &&other) noexcept {
+        if (this != &other) {
+            reset();
+            sync = other.sync;
+            other.sync = nullptr;
+        }
+        return *this;
+    }
+    ~FenceSync() {
+        reset();
+    }
+    // signals once the GPU got through everything submitted before it
+    static FenceSync insert() {
+        FenceSync fence;
+        fence.sync = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        if (fence.sync)
+            ++glObjectCounts.created[GL_OBJECT_SYNC];
+        return fence;
+    }
+    // never waits
+    bool signaled() const {
+        if (!sync)
+            return true;
+        GLenum status = glClientWaitSync(sync, 0, 0);
+        if (status == GL_WAIT_FAILED) {
+            std::cerr << "ERROR::FENCE - glClientWaitSync failed\n";
+            return true;
+        }
+        return status == GL_ALREADY_SIGNALED || status == GL_CONDITION_SATISFIED;
+    }
+    void reset() {
+        if (!sync)
+            return;
+        glDeleteSync(sync);
+        ++glObjectCounts.deleted[GL_OBJECT_SYNC];
+        sync = nullptr;
+    }
+};
+
+
+// objects the GPU may still be using. a frame's worth of them waits behind a fence and is deleted once the
+// fence signals, so dropping a texture that the last frame drew with neither stalls nor pulls it out from
+// under the draw. only the main thread with the context current touches this
+class DeletionQueue {
+    struct Retired {
+        GLObjectKind kind;
+        GLuint id;
+    };
+    struct Batch {
+        FenceSync fence;
+        std::vector<Retired> objects;
+    };
+    std::vector<Retired> current;
+    std::deque<Batch> batches;
+    size_t waiting = 0;
+public:
+    size_t deferred = 0, freed = 0;
+
+    DeletionQueue() = default;
+    DeletionQueue(const DeletionQueue&) = delete;
+    DeletionQueue &operator=(const DeletionQueue&) = delete;
+    ~DeletionQueue() {
+        flush();
+    }
+    void retire(GLObjectKind kind, GLuint id) {
+        current.push_back({kind, id});
+        ++deferred;
+    }
+    // after the frame's draws went in: everything retired so far waits for them
+    void endFrame() {
+        if (current.empty())
+            return;
+        waiting += current.size();
+        batches.push_back({FenceSync::insert(), std::move(current)});
+        current.clear();
+    }
+    // deletes the batches the GPU is done with. the fences signal in order, so stop at the first one that didn't
+    void collect() {
+        while (!batches.empty() && batches.front().fence.signaled()) {
+            for (const Retired &r : batches.front().objects)
+                deleteGLObject(r.kind, r.id);
+            waiting -= batches.front().objects.size();
+            freed += batches.front().objects.size();
+            batches.pop_front();
+        }
+    }
+    // at shutdown, or before the context goes away
+    void flush() {
+        if (current.empty() && batches.empty())
+            return;
+        // the last batch's fence has to go in before the finish, or it's only submitted after it and collect()
+        // finds it unsignaled
+        endFrame();
+        glFinish();
+        collect();
+    }
+    size_t pending() const {
+        return waiting + current.size();
+    }
+    size_t pendingFences() const {
+        return batches.size();
+    }
+};
+
+// when set, handles hand their objects to it instead of deleting them right away
+DeletionQueue *deletionQueue = nullptr;
+
+
+template<GLObjectKind Kind>
+class GLHandle {
+    GLuint id = 0;
+public:
+    GLHandle() = default;
+    // takes over an object that was made somewhere else
+    explicit GLHandle(GLuint id) : id(id) {
+        if (id)
+            ++glObjectCounts.created[Kind];
+    }
+    static GLHandle create() {
+        return GLHandle(genGLObject(Kind));
+    }
+    GLHandle(const GLHandle&) = delete;
+    GLHandle &operator=(const GLHandle&) = delete;
+    GLHandle(GLHandle &&other) noexcept : id(other.id) {
+        other.id = 0;
+    }
+    GLHandle &operator=(GLHandle &&other) noexcept {
+        if (this != &other) {
+            reset();
+            id = other.id;
+            other.id = 0;
+        }
+        return *this;
+    }
+    ~GLHandle() {
+        reset();
+    }
+    void reset() {
+        if (!id)
+            return;
+        if (deletionQueue)
+            deletionQueue->retire(Kind, id);
+        else
+            deleteGLObject(Kind, id);
+        id = 0;
+    }
+    GLuint get() const {
+        return id;
+    }
+    explicit operator bool() const {
+        return id != 0;
+    }
+};
+
+using BufferHandle = GLHandle<GL_OBJECT_BUFFER>;
+using VertexArrayHandle = GLHandle<GL_OBJECT_VERTEX_ARRAY>;
+using TextureHandle = GLHandle<GL_OBJECT_TEXTURE>;
+using FramebufferHandle = GLHandle<GL_OBJECT_FRAMEBUFFER>;
+using RenderbufferHandle = GLHandle<GL_OBJECT_RENDERBUFFER>;
+using SamplerHandle = GLHandle<GL_OBJECT_SAMPLER>;
+using QueryHandle = GLHandle<GL_OBJECT_QUERY>;
+using ShaderHandle = GLHandle<GL_OBJECT_SHADER>;
+using ProgramHandle = GLHandle<GL_OBJECT_PROGRAM>;
+
+
+class Shader {
+    std::string src;
+protected:
+    const char *getsrc() {
+        return src.data();
+    }
+    ShaderHandle shader;
+    bool isCompiled = false;
+protected:
+    virtual const char *getClassName() = 0;
+    GLint getCompilationStatus(GLuint shader_id) {
+        int status;
+        glGetShaderiv(shader_id, GL_COMPILE_STATUS, &status);
+        return status;
+    }
+    void sendError() {
+        char buffer[1024];
+        glGetShaderInfoLog(shader.get(), 1024, NULL, buffer);
+        std::cerr << "ERROR::" << getClassName() << " - " << buffer;
+    }
+    void compile(GLenum type) {
+        // the old one, if any, is deleted by the handle
+        shader = ShaderHandle(glCreateShader(type));
+        const char *src = getsrc();
+        glShaderSource(shader.get(), 1, &src, NULL);
+        glCompileShader(shader.get());
+        if (!getCompilationStatus(shader.get())) {
+            sendError();
+        }
+        isCompiled = true;
+    }
+public:
+    virtual ~Shader() = default;
+    virtual void compile() = 0;
+    void setSource(const char *s) {
+        std::ifstream sourceFile(s);
+        if (!sourceFile.is_open())
+            return;
+        src.clear();
+        isCompiled = false;
+        char buffer[8192];
+        while (sourceFile.read(buffer, 8192)) {
+            src.append(buffer, 8192);
+        }
+        if (!sourceFile.eof()) {
+            src.clear();
+            return;
+        }
+        src.append(buffer, sourceFile.gcount());
+    }
+    // a linked program keeps its own copy of the code, the stage isn't needed after that
+    void release() {
+        shader.reset();
+        isCompiled = false;
+    }
+    friend class Program;
+};
+
+
+class VertexShader : public Shader {
+    virtual const char *getClassName() override {
+        return "VertexShader";
+    }
+public:
+    virtual void compile() override {
+        Shader::compile(GL_VERTEX_SHADER);
+    }
+};
+
+class FragmentShader : public Shader {
+    const char *getClassName() override {
+        return "FragmentShader";
+    }
+public:
+    virtual void compile() override {
+        Shader::compile(GL_FRAGMENT_SHADER);
+    }
+};
+
+
+class Program {
+    ProgramHandle program;
+    void sendError() {
+        char buffer[1024];
+        glGetProgramInfoLog(program.get(), 1024, NULL, buffer);
+        std::cerr << "ERROR::PROGRAM: " << " - " << buffer;
+    }
+public:
+    Program() : program(ProgramHandle::create()) {}
+    bool linkStatus() {
+        int status = 0;
+        glGetProgramiv(program.get(), GL_LINK_STATUS, &status);
+        return status;
+    }
+    void AttachShaders(std::initializer_list<Shader*> shaders) {
+        auto i = shaders.begin();
+        while (i != shaders.end()) {
+            if (!(*i)->isCompiled)
+                (*i)->compile();
+            glAttachShader(program.get(), (*i)->shader.get());
+            ++i;
+        }
+        glLinkProgram(program.get());
+        if (!linkStatus()) {
+            sendError();
+        }
+        // detached shaders are deleted as soon as their handles let go of them
+        for (Shader *shader : shaders)
+            glDetachShader(program.get(), shader->shader.get());
+    }
+    void UseProgram() {
+        glUseProgram(program.get());
+    }
+    void setMat4(const char *locName, const glm::mat4 &mat) {
+        int location = glGetUniformLocation(program.get(), locName);
+        if (location == -1)
+            return;
+        glUniformMatrix4fv(location, 1, GL_FALSE, glm::value_ptr(mat));
+    }
+    void setInt(const char *locName, int value) {
+        int location = glGetUniformLocation(program.get(), locName);
+        if (location == -1)
+            return;
+        glUniform1i(location, value);
+    }
+    void setFloat(const char *locName, float value) {
+        int location = glGetUniformLocation(program.get(), locName);
+        if (location == -1)
+            return;
+        glUniform1f(location, value);
+    }
+};
+
+
+class Texture2D {
+    TextureHandle tex;
+public:
+    void generate2DTex(const char *image_path) {
+        int width, height, nChannels;
+        stbi_set_flip_vertically_on_load(true);
+        uint8_t *raw_image = stbi_load(image_path, &width, &height, &nChannels, 0);
+        float borderColor[] = {1.f, 1.f, 1.f, 1.f};
+        tex = TextureHandle::create();
+        glBindTexture(GL_TEXTURE_2D, tex.get());
+        // what to do when primitive is bigger than the texture
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_BORDER);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_BORDER);
+        glTexParameterfv(GL_TEXTURE_2D, GL_TEXTURE_BORDER_COLOR, borderColor);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        // glTexImage2D(TARGET_TYPE, IM_MIPMAP_LEVEL, TARGET_NRCHANNELS, SRC_WIDTH, SRC_HEIGHT, LEGACY_0, SRC_NRCHANNELS, SRC_DATA_TYPE, SRC_DATA);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, width, height, 0, GL_RGB, GL_UNSIGNED_BYTE, raw_image);
+        stbi_image_free(raw_image);
+    }
+    // a generated checkerboard, for things that come and go
+    void generateChecker(int size, const glm::vec3 &color) {
+        std::vector<uint8_t> pixels(size * size * 3);
+        for (int y = 0; y < size; ++y) {
+            for (int x = 0; x < size; ++x) {
+                float shade = ((x / 8 + y / 8) & 1) ? 1.f : 0.4f;
+                for (int c = 0; c < 3; ++c)
+                    pixels[(y * size + x) * 3 + c] = uint8_t(255.f * shade * color[c]);
+            }
+        }
+        tex = TextureHandle::create();
+        glBindTexture(GL_TEXTURE_2D, tex.get());
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, size, size, 0, GL_RGB, GL_UNSIGNED_BYTE, pixels.data());
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    }
+    void bind() {
+        glBindTexture(GL_TEXTURE_2D, tex.get());
+    }
+};
+
+
+// a cube that was "streamed in": its own texture, vertex buffer and vertex array. dropping it drops all three
+struct StreamedCube {
+    Texture2D tex;
+    BufferHandle vbo;
+    VertexArrayHandle vao;
+    glm::vec3 pos;
+};
+
+StreamedCube streamCube(const float *vertices, size_t size, int serial) {
+    StreamedCube cube;
+    float hue = serial * 0.61803f;
+    cube.tex.generateChecker(64, glm::vec3(0.5f + 0.5f * std::sin(hue * 6.28f), 0.5f + 0.5f * std::sin(hue * 6.28f + 2.1f),
+                                           0.5f + 0.5f * std::sin(hue * 6.28f + 4.2f)));
+    cube.vbo = BufferHandle::create();
+    glBindBuffer(GL_ARRAY_BUFFER, cube.vbo.get());
+    glBufferData(GL_ARRAY_BUFFER, size, vertices, GL_STATIC_DRAW);
+    cube.vao = VertexArrayHandle::create();
+    glBindVertexArray(cube.vao.get());
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)0);
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)(6 * sizeof(float)));
+    glEnableVertexAttribArray(1);
+    float angle = serial * 0.9f;
+    cube.pos = glm::vec3(std::cos(angle) * 3.f, std::sin(serial * 0.37f), std::sin(angle) * 3.f - 4.f);
+    return cube;
+}
+
+
+void processInput(GLFWwindow *window, glm::vec3 &cameraPos, glm::vec3 &cameraFront, glm::vec3 &cameraUp)
+{
+
+    const float cameraSpeed = 0.05f; // adjust accordingly
+    if (glfwGetKey(window, GLFW_KEY_W) == GLFW_PRESS)
+        cameraPos += cameraSpeed * cameraFront;
+    if (glfwGetKey(window, GLFW_KEY_S) == GLFW_PRESS)
+        cameraPos -= cameraSpeed * cameraFront;
+    if (glfwGetKey(window, GLFW_KEY_A) == GLFW_PRESS)
+        cameraPos -= glm::normalize(glm::cross(cameraFront, cameraUp)) * cameraSpeed;
+    if (glfwGetKey(window, GLFW_KEY_D) == GLFW_PRESS)
+        cameraPos += glm::normalize(glm::cross(cameraFront, cameraUp)) * cameraSpeed;
+    if (glfwGetKey(window, GLFW_KEY_UP) == GLFW_PRESS)
+        cameraPos += glm::normalize(glm::cross(cameraFront, cameraUp)) * cameraSpeed;
+
+}
+
+// true only on the frame the key went down
+bool keyPressed(GLFWwindow *window, int key) {
+    static bool down[GLFW_KEY_LAST + 1] = {};
+    bool now = glfwGetKey(window, key) == GLFW_PRESS;
+    bool pressed = now && !down[key];
+    down[key] = now;
+    return pressed;
+}
+
+
+float yaw = -90.f;
+float pitch = 0.f;
+glm::vec3 cameraFront;
+
+void mouseMovement(GLFWwindow *window, double xPos, double yPos) {
+    static float lastX = xPos, lastY = yPos;
+    float xOffset = xPos - lastX;
+    float yOffset = lastY - yPos;
+
+    constexpr float sensitivity = 0.05f;
+    xOffset *= sensitivity;
+    yOffset *= sensitivity;
+
+    yaw += xOffset;
+    pitch += yOffset;
+
+    if (std::abs(pitch) > 89.f) // don't ever do it this way. I am lazy
+        pitch = std::abs(pitch) / pitch * 89.f;
+
+    cameraFront.x = cos(glm::radians(yaw)) * cos(glm::radians(pitch));
+    cameraFront.y = sin(glm::radians(pitch));
+    cameraFront.z = sin(glm::radians(yaw)) * cos(glm::radians(pitch));
+
+    cameraFront = glm::normalize(cameraFront);
+    lastX = xPos, lastY = yPos;
+}
+
+
+// everything that owns GL objects lives in here, so all of it is gone by the time main() counts leaks
+void run(GLFWwindow *win, int screenWidth, int screenHeight) {
+    float triangle_data[] = {
+        //   vertpos   //  //   normal   //  //texcord//
+    -0.5f, -0.5f, -0.5f,  0.0f,  0.0f, -1.0f,  0.0f, 0.0f,
+     0.5f, -0.5f, -0.5f,  0.0f,  0.0f, -1.0f,  1.0f, 0.0f,
+     0.5f,  0.5f, -0.5f,  0.0f,  0.0f, -1.0f,  1.0f, 1.0f,
+     0.5f,  0.5f, -0.5f,  0.0f,  0.0f, -1.0f,  1.0f, 1.0f,
+    -0.5f,  0.5f, -0.5f,  0.0f,  0.0f, -1.0f,  0.0f, 1.0f,
+    -0.5f, -0.5f, -0.5f,  0.0f,  0.0f, -1.0f,  0.0f, 0.0f,
+
+    -0.5f, -0.5f,  0.5f,  0.0f,  0.0f,  1.0f,  0.0f, 0.0f,
+     0.5f, -0.5f,  0.5f,  0.0f,  0.0f,  1.0f,  1.0f, 0.0f,
+     0.5f,  0.5f,  0.5f,  0.0f,  0.0f,  1.0f,  1.0f, 1.0f,
+     0.5f,  0.5f,  0.5f,  0.0f,  0.0f,  1.0f,  1.0f, 1.0f,
+    -0.5f,  0.5f,  0.5f,  0.0f,  0.0f,  1.0f,  0.0f, 1.0f,
+    -0.5f, -0.5f,  0.5f,  0.0f,  0.0f,  1.0f,  0.0f, 0.0f,
+
+    -0.5f,  0.5f,  0.5f, -1.0f,  0.0f,  0.0f,  1.0f, 0.0f,
+    -0.5f,  0.5f, -0.5f, -1.0f,  0.0f,  0.0f,  1.0f, 1.0f,
+    -0.5f, -0.5f, -0.5f, -1.0f,  0.0f,  0.0f,  0.0f, 1.0f,
+    -0.5f, -0.5f, -0.5f, -1.0f,  0.0f,  0.0f,  0.0f, 1.0f,
+    -0.5f, -0.5f,  0.5f, -1.0f,  0.0f,  0.0f,  0.0f, 0.0f,
+    -0.5f,  0.5f,  0.5f, -1.0f,  0.0f,  0.0f,  1.0f, 0.0f,
+
+     0.5f,  0.5f,  0.5f,  1.0f,  0.0f,  0.0f,  1.0f, 0.0f,
+     0.5f,  0.5f, -0.5f,  1.0f,  0.0f,  0.0f,  1.0f, 1.0f,
+     0.5f, -0.5f, -0.5f,  1.0f,  0.0f,  0.0f,  0.0f, 1.0f,
+     0.5f, -0.5f, -0.5f,  1.0f,  0.0f,  0.0f,  0.0f, 1.0f,
+     0.5f, -0.5f,  0.5f,  1.0f,  0.0f,  0.0f,  0.0f, 0.0f,
+     0.5f,  0.5f,  0.5f,  1.0f,  0.0f,  0.0f,  1.0f, 0.0f,
+
+    -0.5f, -0.5f, -0.5f,  0.0f, -1.0f,  0.0f,  0.0f, 1.0f,
+     0.5f, -0.5f, -0.5f,  0.0f, -1.0f,  0.0f,  1.0f, 1.0f,
+     0.5f, -0.5f,  0.5f,  0.0f, -1.0f,  0.0f,  1.0f, 0.0f,
+     0.5f, -0.5f,  0.5f,  0.0f, -1.0f,  0.0f,  1.0f, 0.0f,
+    -0.5f, -0.5f,  0.5f,  0.0f, -1.0f,  0.0f,  0.0f, 0.0f,
+    -0.5f, -0.5f, -0.5f,  0.0f, -1.0f,  0.0f,  0.0f, 1.0f,
+
+    -0.5f,  0.5f, -0.5f,  0.0f,  1.0f,  0.0f,  0.0f, 1.0f,
+     0.5f,  0.5f, -0.5f,  0.0f,  1.0f,  0.0f,  1.0f, 1.0f,
+     0.5f,  0.5f,  0.5f,  0.0f,  1.0f,  0.0f,  1.0f, 0.0f,
+     0.5f,  0.5f,  0.5f,  0.0f,  1.0f,  0.0f,  1.0f, 0.0f,
+    -0.5f,  0.5f,  0.5f,  0.0f,  1.0f,  0.0f,  0.0f, 0.0f,
+    -0.5f,  0.5f, -0.5f,  0.0f,  1.0f,  0.0f,  0.0f, 1.0f
+
+    };
+
+
+    glm::vec3 cameraPos(0.f, 0.f, 3.f);
+    cameraFront = glm::vec3(0.f,0.f,-1.f);
+    glm::vec3 cameraUp(0.,1.,0.f);
+
+
+    Texture2D tex;
+    tex.generate2DTex("./image2d.tex");
+    tex.bind();
+
+    BufferHandle vbo = BufferHandle::create();
+    glBindBuffer(GL_ARRAY_BUFFER, vbo.get());
+    glBufferData(GL_ARRAY_BUFFER, sizeof(triangle_data), triangle_data, GL_STATIC_DRAW);
+
+    VertexArrayHandle vao = VertexArrayHandle::create();
+    glBindVertexArray(vao.get());
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)0);
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)(6 * sizeof(float)));
+    glEnableVertexAttribArray(1);
+
+    VertexShader vs;
+    FragmentShader fs;
+    vs.setSource("./vertex.glsl");
+    fs.setSource("./frag.glsl");
+    Program prog;
+    prog.AttachShaders({&vs, &fs});
+    vs.release();
+    fs.release();
+
+    prog.UseProgram();
+    prog.setInt("tex", 0);
+
+    glm::mat4 view; // = glm::translate(glm::mat4(1.f), glm::vec3(0.f,0.f,-3.f));
+
+
+    glm::mat4 proj = glm::perspective(glm::radians(45.f), float(screenWidth) / screenHeight, 0.1f, 100.f);
+
+    prog.setMat4("proj", proj);
+    prog.setMat4("view", view);
+
+    glfwSetCursorPosCallback(win, mouseMovement);
+    glfwSetInputMode(win, GLFW_CURSOR, GLFW_CURSOR_DISABLED);
+
+    // a cube comes in every few frames and the oldest one goes, like assets streaming around a moving camera
+    constexpr size_t RESIDENT_CUBES = 12;
+    std::deque<StreamedCube> cubes;
+    int serial = 0, framesPerCube = 6;
+    bool streaming = true;
+
+    double lastReport = glfwGetTime(), collectMs = 0., worstCollectMs = 0.;
+    int frames = 0;
+    size_t lastFreed = 0;
+
+    while (!glfwWindowShouldClose(win)) {
+        processInput(win, cameraPos, cameraFront, cameraUp);
+        view = glm::lookAt(cameraPos, cameraFront + cameraPos, cameraUp);
+
+        // free what the GPU is done with. this only ever asks the fences, it doesn't wait on them
+        auto start = std::chrono::steady_clock::now();
+        deletionQueue->collect();
+        double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        collectMs += ms;
+        worstCollectMs = std::max(worstCollectMs, ms);
+
+        // P stops streaming, R reloads the shaders, the old program is deleted once no frame uses it anymore
+        if (keyPressed(win, GLFW_KEY_P))
+            streaming = !streaming;
+        if (keyPressed(win, GLFW_KEY_R)) {
+            VertexShader newVs;
+            FragmentShader newFs;
+            newVs.setSource("./vertex.glsl");
+            newFs.setSource("./frag.glsl");
+            Program reloaded;
+            reloaded.AttachShaders({&newVs, &newFs});
+            if (reloaded.linkStatus()) {
+                prog = std::move(reloaded);
+                prog.UseProgram();
+                prog.setInt("tex", 0);
+                prog.setMat4("proj", proj);
+            }
+        }
+        if (streaming && serial++ % framesPerCube == 0) {
+            cubes.push_back(streamCube(triangle_data, sizeof(triangle_data), serial));
+            if (cubes.size() > RESIDENT_CUBES)
+                cubes.pop_front();
+        }
+
+        prog.UseProgram();
+        prog.setMat4("view", view);
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+        glActiveTexture(GL_TEXTURE0);
+        glBindVertexArray(vao.get());
+        tex.bind();
+        prog.setMat4("model", glm::mat4(1.f));
+        glDrawArrays(GL_TRIANGLES, 0, 36);
+        for (StreamedCube &cube : cubes) {
+            glBindVertexArray(cube.vao.get());
+            cube.tex.bind();
+            prog.setMat4("model", glm::scale(glm::translate(glm::mat4(1.f), cube.pos), glm::vec3(0.5f)));
+            glDrawArrays(GL_TRIANGLES, 0, 36);
+        }
+        // what got dropped this frame may be in the draws above, it waits for this frame's fence
+        deletionQueue->endFrame();
+
+        ++frames;
+        if (glfwGetTime() - lastReport > 1.) {
+            lastReport = glfwGetTime();
+            std::cout << glObjectCounts.live() << " GL objects alive ("
+                      << glObjectCounts.live(GL_OBJECT_TEXTURE) << " textures, " << glObjectCounts.live(GL_OBJECT_BUFFER)
+                      << " buffers, " << glObjectCounts.live(GL_OBJECT_VERTEX_ARRAY) << " vertex arrays, "
+                      << glObjectCounts.live(GL_OBJECT_SYNC) << " fences), " << deletionQueue->pending()
+                      << " waiting to be deleted behind " << deletionQueue->pendingFences() << " fences, "
+                      << deletionQueue->freed - lastFreed << " freed, collect " << collectMs / frames << "ms average, "
+                      << worstCollectMs << "ms worst" << (streaming ? "" : " (streaming paused)") << "\n";
+            lastFreed = deletionQueue->freed;
+            frames = 0;
+            collectMs = worstCollectMs = 0.;
+        }
+        // polls different kinds of events, for example, when we close an application, it fetches that event
+        // or it fetches events like movement of the window.
+        // Without it you can neither move the window or close the window
+        glfwPollEvents();
+        // have you drawn the image, it is stored in the buffer. You can now swap this buffer with main buffer
+        // so the image appears
+        glfwSwapBuffers(win);
+    }
+}
+
+
+int main() {
+    if (glfwInit() != GLFW_TRUE) {
+        glfwTerminate();
+        std::cerr << "Failed to initialize GLFW";
+        return EXIT_FAILURE;
+    }
+    // setting OpenGL version to 3.3
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+    GLFWwindow *win = glfwCreateWindow(800, 600, "This is a hello window!", NULL, NULL);
+    // setting 'context' for OpenGL, i.e. where to draw on current thread
+    glfwMakeContextCurrent(win);
+    // all it does is fetches us the implemented functions of OpenGL
+    if (glewInit() != GLEW_OK) {
+        glfwTerminate();
+        std::cerr << "Failed to initialize GLEW\n";
+        return EXIT_FAILURE;
+    }
+    int screenWidth, screenHeight;
+    glfwGetFramebufferSize(win, &screenWidth, &screenHeight);
+    glViewport(0, 0, screenWidth, screenHeight);
+
+    glEnable(GL_DEPTH_TEST);
+
+    bool clean;
+    {
+        DeletionQueue deletions;
+        deletionQueue = &deletions;
+        run(win, screenWidth, screenHeight);
+        // the handles are all gone, but what they retired last may still be waiting
+        deletions.flush();
+        deletionQueue = nullptr;
+        std::cout << deletions.deferred << " GL objects went through the deletion queue\n";
+        clean = glObjectCounts.reportLeaks();
+    }
+    glfwTerminate();
+
+    std::cout << "Window should close now!\n";
+
+    return clean ? EXIT_SUCCESS : EXIT_FAILURE;
+
+}
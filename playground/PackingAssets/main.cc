@@ -0,0 +1,1202 @@
+#include <GL/glew.h>
+
+#include <GLFW/glfw3.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+#include <fstream>
+#include <glm/ext/matrix_clip_space.hpp>
+#include <glm/ext/matrix_transform.hpp>
+#include <glm/geometric.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/ext/matrix_float4x4.hpp>
+#include <glm/gtc/type_ptr.hpp>
+#include <glm/glm.hpp>
+#include <glm/trigonometric.hpp>
+#define STB_IMAGE_IMPLEMENTATION
+#include <stb/stb_image.h>
+#include <iostream>
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+class VirtualFS;
+
+class Shader {
+    std::string src; 
+protected:
+    const char *getsrc() {
+        return src.data();
+    }
+    GLuint shader_id = 0;
+    bool isCompiled = false;
+protected:
+    virtual const char *getClassName() = 0;
+    GLint getCompilationStatus(GLuint shader_id) {
+        int status;
+        glGetShaderiv(shader_id, GL_COMPILE_STATUS, &status);
+        return status;
+    }
+    void sendError() {
+        char buffer[1024];
+        glGetShaderInfoLog(shader_id, 1024, NULL, buffer);
+        std::cerr << "ERROR::" << getClassName() << " - " << buffer;
+    }
+public:
+    virtual void compile() = 0;
+    void setSource(const char *s) {
+        std::ifstream sourceFile(s);
+        if (!sourceFile.is_open())
+            return;
+        char buffer[8192];
+        while (sourceFile.read(buffer, 8192)) {
+            src.append(buffer, 8192);
+        }
+        if (!sourceFile.eof()) {
+            src.clear();
+            return;
+        }
+        src.append(buffer, sourceFile.gcount());
+    }
+    void setSource(const VirtualFS &fs, const char *s);
+    friend class Program;
+};
+
+
+class VertexShader : public Shader {
+    virtual const char *getClassName() override {
+        return "VertexShader";
+    }
+public:
+    virtual void compile() override {
+        if (shader_id)
+            glDeleteShader(shader_id);
+        shader_id = glCreateShader(GL_VERTEX_SHADER);
+        const char *src = getsrc();
+        glShaderSource(shader_id, 1, &src, NULL);
+        glCompileShader(shader_id);
+        if (!getCompilationStatus(shader_id)) {
+            sendError();
+        }
+        isCompiled = true;
+    }
+};
+
+class FragmentShader : public Shader {
+    const char *getClassName() override {
+        return "FragmentShader";
+    }
+public:
+    virtual void compile() override {
+        if (shader_id)
+            glDeleteShader(shader_id);
+        shader_id = glCreateShader(GL_FRAGMENT_SHADER);
+        const char *src = getsrc();
+        glShaderSource(shader_id, 1, &src, NULL);
+        glCompileShader(shader_id);
+        if (!getCompilationStatus(shader_id)) {
+            sendError();
+        }
+        isCompiled = true;
+    }
+};
+
+
+class Program {
+    GLuint program_id = 0;
+    void sendError() {
+        char buffer[1024];
+        glGetProgramInfoLog(program_id, 1024, NULL, buffer);
+        std::cerr << "ERROR::PROGRAM: " << " - " << buffer;
+    }
+    bool linkStatus() {
+        int status = 0;
+        glGetProgramiv(program_id, GL_LINK_STATUS, &status);
+        return status;
+    }
+public:
+    Program() {
+        program_id = glCreateProgram();
+    }
+    ~Program() {
+        glDeleteProgram(program_id);
+    }
+    void AttachShaders(std::initializer_list<Shader*> shaders) {
+        auto i = shaders.begin();
+        while (i != shaders.end()) {
+            if (!(*i)->isCompiled)
+                (*i)->compile();
+            glAttachShader(program_id, (*i)->shader_id);
+            ++i;
+        }
+        glLinkProgram(program_id);
+        if (!linkStatus()) {
+            sendError();
+        }
+    }
+    void UseProgram() {
+        glUseProgram(program_id);
+    }
+    void setMat4(const char *locName, const glm::mat4 &mat) {
+        int location = glGetUniformLocation(program_id, locName);
+        if (location == -1)
+            return;
+        glUniformMatrix4fv(location, 1, GL_FALSE, glm::value_ptr(mat));
+    }
+};
+
+
+class Texture2D {
+    GLuint tex_id;
+    void upload(const uint8_t *raw_image, int width, int height) {
+        float borderColor[] = {1.f, 1.f, 1.f, 1.f};
+        glGenTextures(1, &tex_id);
+        glBindTexture(GL_TEXTURE_2D, tex_id);
+        // what to do when primitive is bigger than the texture
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_BORDER);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_BORDER);
+        glTexParameterfv(GL_TEXTURE_2D, GL_TEXTURE_BORDER_COLOR, borderColor);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        // glTexImage2D(TARGET_TYPE, IM_MIPMAP_LEVEL, TARGET_NRCHANNELS, SRC_WIDTH, SRC_HEIGHT, LEGACY_0, SRC_NRCHANNELS, SRC_DATA_TYPE, SRC_DATA);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, width, height, 0, GL_RGB, GL_UNSIGNED_BYTE, raw_image);
+    }
+public:
+    void generate2DTex(const char *image_path) {
+        int width, height, nChannels;
+        stbi_set_flip_vertically_on_load(true);
+        uint8_t *raw_image = stbi_load(image_path, &width, &height, &nChannels, 0);
+        upload(raw_image, width, height);
+        stbi_image_free(raw_image);
+    }
+    void generate2DTex(const VirtualFS &fs, const char *image_path);
+    void bind() {
+        glBindTexture(GL_TEXTURE_2D, tex_id);
+    }
+};
+// a handful of threads that split loops between them, the calling thread helps out
+class WorkerPool {
+    std::vector<std::thread> threads;
+    std::mutex mutex;
+    std::condition_variable wake, finished;
+    const std::function<void(size_t, size_t)> *job = nullptr;
+    size_t jobCount = 0;
+    size_t jobChunk = 1;
+    std::atomic<size_t> next{0};
+    int busy = 0;
+    uint64_t generation = 0;
+    bool quit = false;
+
+    void work() {
+        size_t begin;
+        while ((begin = next.fetch_add(jobChunk)) < jobCount)
+            (*job)(begin, std::min(begin + jobChunk, jobCount));
+    }
+public:
+    explicit WorkerPool(unsigned count = std::thread::hardware_concurrency()) {
+        for (unsigned i = 1; i < std::max(count, 1u); ++i) {
+            threads.emplace_back([this] {
+                uint64_t seen = 0;
+                std::unique_lock<std::mutex> lock(mutex);
+                while (true) {
+                    wake.wait(lock, [&] { return quit || generation != seen; });
+                    if (quit)
+                        return;
+                    seen = generation;
+                    lock.unlock();
+                    work();
+                    lock.lock();
+                    if (--busy == 0)
+                        finished.notify_one();
+                }
+            });
+        }
+    }
+    ~WorkerPool() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            quit = true;
+        }
+        wake.notify_all();
+        for (std::thread &t : threads)
+            t.join();
+    }
+    size_t size() const {
+        return threads.size() + 1;
+    }
+    // calls fn(begin, end) on ranges of at most chunk items until [0, count) is covered, returns when all are done
+    void parallelFor(size_t count, size_t chunk, const std::function<void(size_t, size_t)> &fn) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            job = &fn;
+            jobCount = count;
+            jobChunk = std::max<size_t>(chunk, 1);
+            next = 0;
+            busy = threads.size();
+            ++generation;
+        }
+        wake.notify_all();
+        work();
+        std::unique_lock<std::mutex> lock(mutex);
+        finished.wait(lock, [&] { return busy == 0; });
+    }
+};
+
+uint64_t alignUp(uint64_t value, uint64_t alignment) {
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+
+// ---------------------------------------------------------------------------------------------------------
+// lz4 block format, https://github.com/lz4/lz4/blob/dev/doc/lz4_Block_format.md
+// a sequence is: token (literal length << 4 | match length - 4), more literal length bytes, literals,
+// 2 byte little endian offset, more match length bytes. the last sequence only has literals
+// ---------------------------------------------------------------------------------------------------------
+
+namespace lz4 {
+
+constexpr int MIN_MATCH = 4;
+// the format wants the last 5 bytes to be literals and no match to start in the last 12
+constexpr int LAST_LITERALS = 5;
+constexpr int MF_LIMIT = 12;
+constexpr int HASH_BITS = 16;
+
+size_t compressBound(size_t size) {
+    return size + size / 255 + 16;
+}
+
+inline uint32_t read32(const uint8_t *p) {
+    uint32_t v;
+    std::memcpy(&v, p, 4);
+    return v;
+}
+
+inline uint32_t hash(uint32_t sequence) {
+    return (sequence * 2654435761u) >> (32 - HASH_BITS);
+}
+
+inline uint8_t *writeLength(uint8_t *out, size_t length) {
+    while (length >= 255) {
+        *out++ = 255;
+        length -= 255;
+    }
+    *out++ = uint8_t(length);
+    return out;
+}
+
+// greedy single pass, one hash table entry per 4 byte sequence. dst needs compressBound(size) bytes
+size_t compress(const uint8_t *src, size_t size, uint8_t *dst) {
+    std::vector<uint32_t> table(size_t(1) << HASH_BITS, 0);
+    const uint8_t *ip = src, *anchor = src;
+    const uint8_t *const end = src + size;
+    const uint8_t *const matchLimit = end - LAST_LITERALS;
+    uint8_t *op = dst;
+
+    if (size >= MF_LIMIT + 1) {
+        const uint8_t *const inputLimit = end - MF_LIMIT;
+        ++ip;
+        while (ip < inputLimit) {
+            const uint32_t h = hash(read32(ip));
+            const uint8_t *ref = src + table[h];
+            table[h] = ip - src;
+            if (ip - ref > 65535 || ref >= ip || read32(ref) != read32(ip)) {
+                ++ip;
+                continue;
+            }
+            // grow the match backwards over literals that match too
+            while (ip > anchor && ref > src && ip[-1] == ref[-1])
+                --ip, --ref;
+            const uint8_t *matchEnd = ip + MIN_MATCH, *refEnd = ref + MIN_MATCH;
+            while (matchEnd < matchLimit && *matchEnd == *refEnd)
+                ++matchEnd, ++refEnd;
+
+            const size_t literals = ip - anchor, matchLength = matchEnd - ip - MIN_MATCH;
+            uint8_t *token = op++;
+            *token = uint8_t((literals >= 15 ? 15 : literals) << 4 | (matchLength >= 15 ? 15 : matchLength));
+            if (literals >= 15)
+                op = writeLength(op, literals - 15);
+            std::memcpy(op, anchor, literals);
+            op += literals;
+            const uint16_t offset = ip - ref;
+            *op++ = offset & 0xFF;
+            *op++ = offset >> 8;
+            if (matchLength >= 15)
+                op = writeLength(op, matchLength - 15);
+
+            ip = anchor = matchEnd;
+            if (ip < inputLimit)
+                table[hash(read32(ip - 2))] = ip - 2 - src;
+        }
+    }
+    const size_t literals = end - anchor;
+    *op++ = uint8_t((literals >= 15 ? 15 : literals) << 4);
+    if (literals >= 15)
+        op = writeLength(op, literals - 15);
+    std::memcpy(op, anchor, literals);
+    op += literals;
+    return op - dst;
+}
+
+// returns false on anything that doesn't decode to exactly dstSize bytes, never reads or writes out of bounds
+bool decompress(const uint8_t *src, size_t srcSize, uint8_t *dst, size_t dstSize) {
+    const uint8_t *ip = src, *const ipEnd = src + srcSize;
+    uint8_t *op = dst, *const opEnd = dst + dstSize;
+    auto readLength = [&](size_t &length) {
+        uint8_t b;
+        do {
+            if (ip >= ipEnd)
+                return false;
+            b = *ip++;
+            length += b;
+        } while (b == 255);
+        return true;
+    };
+    while (ip < ipEnd) {
+        const uint8_t token = *ip++;
+        size_t literals = token >> 4;
+        if (literals == 15 && !readLength(literals))
+            return false;
+        if (literals > size_t(ipEnd - ip) || literals > size_t(opEnd - op))
+            return false;
+        if (literals <= 32 && ipEnd - ip >= 32 && opEnd - op >= 32) {
+            // short runs are the common case, two fixed size copies beat a call into memcpy
+            std::memcpy(op, ip, 16);
+            std::memcpy(op + 16, ip + 16, 16);
+        } else {
+            std::memcpy(op, ip, literals);
+        }
+        ip += literals, op += literals;
+        if (ip == ipEnd)
+            break;  // last sequence
+
+        if (ipEnd - ip < 2)
+            return false;
+        const size_t offset = ip[0] | ip[1] << 8;
+        ip += 2;
+        size_t matchLength = token & 15;
+        if (matchLength == 15 && !readLength(matchLength))
+            return false;
+        matchLength += MIN_MATCH;
+        if (offset == 0 || offset > size_t(op - dst) || matchLength > size_t(opEnd - op))
+            return false;
+        // a match closer than its length repeats the last offset bytes. whatever we copied is that pattern too,
+        // so the distance we can copy in one go doubles every round
+        const uint8_t *ref = op - offset;
+        if (offset >= 16 && opEnd - op >= ptrdiff_t(matchLength) + 16) {
+            // far enough back that 16 byte steps never read what they are writing, and there is room to overshoot
+            uint8_t *const matchEnd = op + matchLength;
+            do {
+                std::memcpy(op, ref, 16);
+                op += 16, ref += 16;
+            } while (op < matchEnd);
+            op = matchEnd;
+            continue;
+        }
+        while (matchLength) {
+            const size_t n = std::min<size_t>(matchLength, op - ref);
+            std::memcpy(op, ref, n);
+            op += n, matchLength -= n;
+        }
+    }
+    return op == opEnd;
+}
+
+} // namespace lz4
+
+
+// ---------------------------------------------------------------------------------------------------------
+// the archive. one file holding all assets, each cut into CHUNK_SIZE pieces compressed on their own, so a
+// big asset can be decompressed on several threads. assets are found by the hash of their path through
+// a sorted index, no directory walking or string compares unless two paths share a hash
+//
+//   ArchiveHeader
+//   chunk data
+//   ArchiveEntry[entryCount]     sorted by hash
+//   ArchiveChunk[chunkCount]
+//   path strings
+// ---------------------------------------------------------------------------------------------------------
+
+constexpr char ARCHIVE_MAGIC[4] = {'A', 'G', 'P', 'K'};
+constexpr uint32_t ARCHIVE_VERSION = 1;
+constexpr uint32_t ARCHIVE_CHUNK_SIZE = 64 * 1024;
+
+struct ArchiveHeader {
+    char magic[4];
+    uint32_t version;
+    uint32_t entryCount;
+    uint32_t chunkCount;
+    uint32_t chunkSize;
+    uint32_t padding;
+    uint64_t entryOffset;
+    uint64_t chunkOffset;
+    uint64_t stringOffset;
+    uint64_t fileSize;
+};
+static_assert(sizeof(ArchiveHeader) == 56, "ArchiveHeader layout is part of the file format");
+
+struct ArchiveEntry {
+    uint64_t hash;
+    uint32_t pathOffset, pathLength;  // into the string table
+    uint64_t size;
+    uint32_t firstChunk, chunkCount;
+};
+static_assert(sizeof(ArchiveEntry) == 32, "ArchiveEntry layout is part of the file format");
+
+struct ArchiveChunk {
+    uint64_t offset;
+    uint32_t compressedSize;  // == size means it didn't compress and is stored as is
+    uint32_t size;
+};
+static_assert(sizeof(ArchiveChunk) == 16, "ArchiveChunk layout is part of the file format");
+
+// "./shaders\a.glsl" and "shaders/a.glsl" are the same asset
+std::string normalizePath(const char *path) {
+    std::string out;
+    for (const char *c = path; *c; ++c) {
+        char ch = *c == '\\' ? '/' : *c;
+        if (ch == '/' && (out.empty() || out.back() == '/'))
+            continue;
+        out += ch;
+        if (out == "./" || (out.size() >= 3 && !out.compare(out.size() - 3, 3, "/./")))
+            out.resize(out.size() - 2);
+    }
+    return out;
+}
+
+uint64_t hashPath(const std::string &path) {
+    uint64_t h = 0xcbf29ce484222325ull;
+    for (char c : path) {
+        h ^= uint8_t(c);
+        h *= 0x100000001b3ull;
+    }
+    return h;
+}
+
+bool readWholeFile(const char *path, std::string &out) {
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (!file.is_open())
+        return false;
+    out.resize(file.tellg());
+    file.seekg(0);
+    return bool(file.read(&out[0], out.size()));
+}
+
+// adds files and everything below directories to paths
+void collectFiles(const std::string &path, std::vector<std::string> &paths) {
+    DIR *dir = opendir(path.c_str());
+    if (!dir) {
+        paths.push_back(path);
+        return;
+    }
+    while (dirent *e = readdir(dir)) {
+        if (!std::strcmp(e->d_name, ".") || !std::strcmp(e->d_name, ".."))
+            continue;
+        collectFiles(path + "/" + e->d_name, paths);
+    }
+    closedir(dir);
+}
+
+// ./main --pack out.pak files or directories...
+// chunks are compressed on all cores, the archive is written next to out and renamed when complete
+bool packArchive(const std::string &outPath, const std::vector<std::string> &inputs, WorkerPool &pool, bool verbose = true) {
+    std::vector<std::string> files;
+    for (const std::string &in : inputs)
+        collectFiles(in, files);
+
+    struct Pending {
+        std::string path;
+        std::string data;
+        uint32_t firstChunk, chunkCount;
+    };
+    std::vector<Pending> assets;
+    std::vector<std::string> seen;
+    size_t totalChunks = 0;
+    for (const std::string &file : files) {
+        Pending p;
+        p.path = normalizePath(file.c_str());
+        if (std::find(seen.begin(), seen.end(), p.path) != seen.end())
+            continue;
+        if (!readWholeFile(file.c_str(), p.data)) {
+            std::cerr << "ERROR::PACK - can't read " << file << "\n";
+            return false;
+        }
+        p.firstChunk = totalChunks;
+        p.chunkCount = (p.data.size() + ARCHIVE_CHUNK_SIZE - 1) / ARCHIVE_CHUNK_SIZE;
+        totalChunks += p.chunkCount;
+        seen.push_back(p.path);
+        assets.push_back(std::move(p));
+    }
+
+    // compress every chunk of every asset in parallel, then lay them out one after another
+    struct Job {
+        const uint8_t *src;
+        uint32_t size;
+    };
+    std::vector<Job> jobs;
+    jobs.reserve(totalChunks);
+    for (const Pending &p : assets)
+        for (uint32_t c = 0; c < p.chunkCount; ++c)
+            jobs.push_back({reinterpret_cast<const uint8_t*>(p.data.data()) + size_t(c) * ARCHIVE_CHUNK_SIZE,
+                            uint32_t(std::min<size_t>(ARCHIVE_CHUNK_SIZE, p.data.size() - size_t(c) * ARCHIVE_CHUNK_SIZE))});
+    std::vector<std::vector<uint8_t>> compressed(jobs.size());
+    pool.parallelFor(jobs.size(), 4, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            std::vector<uint8_t> &out = compressed[i];
+            out.resize(lz4::compressBound(jobs[i].size));
+            size_t n = lz4::compress(jobs[i].src, jobs[i].size, out.data());
+            // not worth it, store it and skip the decompression
+            if (n >= jobs[i].size)
+                out.assign(jobs[i].src, jobs[i].src + jobs[i].size);
+            else
+                out.resize(n);
+        }
+    });
+
+    const std::string tmpPath = outPath + ".tmp";
+    std::ofstream out(tmpPath, std::ios::binary | std::ios::trunc);
+    if (!out.is_open()) {
+        std::cerr << "ERROR::PACK - can't write " << outPath << "\n";
+        return false;
+    }
+    ArchiveHeader header = {};
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    std::vector<ArchiveChunk> chunks(jobs.size());
+    uint64_t offset = sizeof(header);
+    for (size_t i = 0; i < jobs.size(); ++i) {
+        chunks[i] = {offset, uint32_t(compressed[i].size()), jobs[i].size};
+        out.write(reinterpret_cast<const char*>(compressed[i].data()), compressed[i].size());
+        offset += compressed[i].size();
+    }
+
+    std::vector<ArchiveEntry> entries;
+    std::string strings;
+    for (const Pending &p : assets) {
+        ArchiveEntry e = {hashPath(p.path), uint32_t(strings.size()), uint32_t(p.path.size()), p.data.size(), p.firstChunk, p.chunkCount};
+        entries.push_back(e);
+        strings += p.path;
+    }
+    std::sort(entries.begin(), entries.end(), [](const ArchiveEntry &a, const ArchiveEntry &b) {
+        return a.hash < b.hash;
+    });
+    const uint64_t entryOffset = alignUp(offset, 8);
+    out.write("\0\0\0\0\0\0\0", entryOffset - offset);
+    out.write(reinterpret_cast<const char*>(entries.data()), entries.size() * sizeof(ArchiveEntry));
+    out.write(reinterpret_cast<const char*>(chunks.data()), chunks.size() * sizeof(ArchiveChunk));
+    out.write(strings.data(), strings.size());
+
+    std::memcpy(header.magic, ARCHIVE_MAGIC, 4);
+    header.version = ARCHIVE_VERSION;
+    header.entryCount = entries.size();
+    header.chunkCount = chunks.size();
+    header.chunkSize = ARCHIVE_CHUNK_SIZE;
+    header.entryOffset = entryOffset;
+    header.chunkOffset = entryOffset + entries.size() * sizeof(ArchiveEntry);
+    header.stringOffset = header.chunkOffset + chunks.size() * sizeof(ArchiveChunk);
+    header.fileSize = header.stringOffset + strings.size();
+    out.seekp(0);
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    out.close();
+    if (!out || std::rename(tmpPath.c_str(), outPath.c_str()) != 0) {
+        std::cerr << "ERROR::PACK - can't write " << outPath << "\n";
+        std::remove(tmpPath.c_str());
+        return false;
+    }
+    if (verbose) {
+        size_t raw = 0;
+        for (const Pending &p : assets)
+            raw += p.data.size();
+        std::cout << outPath << ": " << assets.size() << " assets, " << raw / 1024 << "KB -> " << header.fileSize / 1024 << "KB\n";
+    }
+    return true;
+}
+
+
+// count things of sizeof(T) at offset fit in size bytes. every value comes out of the file, so written as
+// subtractions that can't wrap around instead of sums that can
+template <typename T>
+bool fitsIn(uint64_t size, uint64_t offset, uint64_t count) {
+    return offset <= size && count <= (size - offset) / sizeof(T);
+}
+
+// a mapped archive
+class Archive {
+    int fd = -1;
+    const uint8_t *base = nullptr;
+    size_t size = 0;
+    const ArchiveHeader *header = nullptr;
+    const ArchiveEntry *entries = nullptr;
+    const ArchiveChunk *chunks = nullptr;
+    const char *strings = nullptr;
+
+    bool fail(const char *path, const char *what) {
+        std::cerr << "ERROR::ARCHIVE - " << path << ": " << what << "\n";
+        close();
+        return false;
+    }
+public:
+    Archive() = default;
+    Archive(const Archive&) = delete;
+    Archive &operator=(const Archive&) = delete;
+    ~Archive() {
+        close();
+    }
+    bool open(const char *path) {
+        close();
+        fd = ::open(path, O_RDONLY);
+        if (fd < 0)
+            return fail(path, "can't open");
+        struct stat st;
+        if (fstat(fd, &st) != 0 || size_t(st.st_size) < sizeof(ArchiveHeader))
+            return fail(path, "too small to be an archive");
+        size = st.st_size;
+        void *mapped = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (mapped == MAP_FAILED)
+            return fail(path, "mmap failed");
+        base = static_cast<const uint8_t*>(mapped);
+        header = reinterpret_cast<const ArchiveHeader*>(base);
+        if (std::memcmp(header->magic, ARCHIVE_MAGIC, 4))
+            return fail(path, "not an archive");
+        if (header->version != ARCHIVE_VERSION)
+            return fail(path, "packed with another version, pack it again");
+        if (header->fileSize != size || header->entryOffset % 8 || header->chunkOffset % 8
+            || !fitsIn<ArchiveEntry>(size, header->entryOffset, header->entryCount)
+            || !fitsIn<ArchiveChunk>(size, header->chunkOffset, header->chunkCount)
+            || header->stringOffset > size)
+            return fail(path, "tables don't fit in the file");
+        entries = reinterpret_cast<const ArchiveEntry*>(base + header->entryOffset);
+        chunks = reinterpret_cast<const ArchiveChunk*>(base + header->chunkOffset);
+        strings = reinterpret_cast<const char*>(base + header->stringOffset);
+        // checked once here, so lookups and reads don't have to
+        for (uint32_t i = 0; i < header->entryCount; ++i) {
+            const ArchiveEntry &e = entries[i];
+            if (e.firstChunk > header->chunkCount || e.chunkCount > header->chunkCount - e.firstChunk
+                || !fitsIn<char>(size - header->stringOffset, e.pathOffset, e.pathLength))
+                return fail(path, "entry out of range");
+            uint64_t total = 0;
+            for (uint32_t c = e.firstChunk; c < e.firstChunk + e.chunkCount; ++c) {
+                const ArchiveChunk &chunk = chunks[c];
+                if (chunk.offset > header->entryOffset || chunk.compressedSize > header->entryOffset - chunk.offset
+                    || chunk.size > header->chunkSize)
+                    return fail(path, "chunk out of range");
+                // a chunk is read to its index times chunkSize, so only the last one may be short
+                if (c + 1 < e.firstChunk + e.chunkCount && chunk.size != header->chunkSize)
+                    return fail(path, "chunk shorter than the chunk size");
+                total += chunk.size;
+            }
+            if (total != e.size)
+                return fail(path, "chunk sizes don't add up");
+        }
+        return true;
+    }
+    void close() {
+        if (base)
+            munmap(const_cast<uint8_t*>(base), size);
+        if (fd >= 0)
+            ::close(fd);
+        fd = -1, base = nullptr, size = 0, header = nullptr;
+    }
+    bool isOpen() const {
+        return base != nullptr;
+    }
+    // binary search on the hash, then make sure it really is that path
+    const ArchiveEntry *find(const std::string &normalized) const {
+        if (!base)
+            return nullptr;
+        const uint64_t h = hashPath(normalized);
+        const ArchiveEntry *end = entries + header->entryCount;
+        const ArchiveEntry *e = std::lower_bound(entries, end, h, [](const ArchiveEntry &a, uint64_t h) {
+            return a.hash < h;
+        });
+        for (; e != end && e->hash == h; ++e)
+            if (e->pathLength == normalized.size() && !std::memcmp(strings + e->pathOffset, normalized.data(), e->pathLength))
+                return e;
+        return nullptr;
+    }
+    const ArchiveChunk &chunk(uint32_t i) const {
+        return chunks[i];
+    }
+    uint32_t chunkSize() const {
+        return header->chunkSize;
+    }
+    // chunk i of an entry into dst, which has room for chunk.size bytes
+    bool readChunk(const ArchiveChunk &c, uint8_t *dst) const {
+        if (c.compressedSize == c.size) {
+            std::memcpy(dst, base + c.offset, c.size);
+            return true;
+        }
+        return lz4::decompress(base + c.offset, c.compressedSize, dst, c.size);
+    }
+};
+
+
+// where assets come from: a mounted archive first, loose files next to the executable if it isn't in there.
+// big assets and batches are decompressed chunk by chunk on the worker pool
+class VirtualFS {
+    Archive archive;
+    WorkerPool *pool;
+public:
+    explicit VirtualFS(WorkerPool *pool = nullptr) : pool(pool) {}
+    bool mount(const char *archivePath) {
+        return archive.open(archivePath);
+    }
+    bool read(const char *path, std::string &out) const {
+        std::vector<std::string> outs(1);
+        if (!readBatch({path}, outs))
+            return false;
+        out.swap(outs[0]);
+        return true;
+    }
+    // reads all of paths, all their chunks are spread over the pool together
+    bool readBatch(const std::vector<std::string> &paths, std::vector<std::string> &out) const {
+        out.resize(paths.size());
+        struct Job {
+            const ArchiveChunk *chunk;
+            uint8_t *dst;
+        };
+        std::vector<Job> jobs;
+        bool ok = true;
+        for (size_t i = 0; i < paths.size(); ++i) {
+            const ArchiveEntry *e = archive.find(normalizePath(paths[i].c_str()));
+            if (!e) {
+                if (!readWholeFile(paths[i].c_str(), out[i])) {
+                    std::cerr << "ERROR::VFS - " << paths[i] << " is neither in the archive nor a file\n";
+                    ok = false;
+                }
+                continue;
+            }
+            out[i].resize(e->size);
+            uint8_t *dst = reinterpret_cast<uint8_t*>(&out[i][0]);
+            for (uint32_t c = 0; c < e->chunkCount; ++c)
+                jobs.push_back({&archive.chunk(e->firstChunk + c), dst + size_t(c) * archive.chunkSize()});
+        }
+        std::atomic<bool> corrupt{false};
+        auto decode = [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i)
+                if (!archive.readChunk(*jobs[i].chunk, jobs[i].dst))
+                    corrupt = true;
+        };
+        // not worth waking anyone for a chunk or two
+        if (pool && jobs.size() > 2)
+            pool->parallelFor(jobs.size(), 4, decode);
+        else
+            decode(0, jobs.size());
+        if (corrupt) {
+            std::cerr << "ERROR::VFS - corrupt chunk in the archive\n";
+            return false;
+        }
+        return ok;
+    }
+};
+
+
+// the asset versions of Shader::setSource and Texture2D::generate2DTex
+void Shader::setSource(const VirtualFS &fs, const char *s) {
+    if (!fs.read(s, src))
+        src.clear();
+}
+
+void Texture2D::generate2DTex(const VirtualFS &fs, const char *image_path) {
+    std::string file;
+    if (!fs.read(image_path, file))
+        return;
+    int width, height, nChannels;
+    stbi_set_flip_vertically_on_load(true);
+    uint8_t *raw_image = stbi_load_from_memory(reinterpret_cast<const uint8_t*>(file.data()), file.size(), &width, &height, &nChannels, 0);
+    upload(raw_image, width, height);
+    stbi_image_free(raw_image);
+}
+
+
+// drops the file from the page cache, so the next read really goes to the disk
+void evictFromCache(const char *path) {
+    int fd = ::open(path, O_RDONLY);
+    if (fd < 0)
+        return;
+    fdatasync(fd);
+    posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+    ::close(fd);
+}
+
+double millisecondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+// broken copies of a good archive, each with one table value picked to get past a careless bounds check.
+// every one of them has to be turned away by open()
+bool rejectsCraftedArchives(const std::string &goodPath) {
+    std::string good;
+    if (!readWholeFile(goodPath.c_str(), good))
+        return false;
+    auto header = [](std::string &bytes) { return reinterpret_cast<ArchiveHeader*>(&bytes[0]); };
+    auto chunk = [&](std::string &bytes, size_t i) { return reinterpret_cast<ArchiveChunk*>(&bytes[header(bytes)->chunkOffset] + i * sizeof(ArchiveChunk)); };
+    auto entry = [&](std::string &bytes, size_t i) { return reinterpret_cast<ArchiveEntry*>(&bytes[header(bytes)->entryOffset] + i * sizeof(ArchiveEntry)); };
+    struct Crafted {
+        const char *what;
+        std::function<void(std::string&)> damage;
+    };
+    const Crafted crafted[] = {
+        // offset + count * size wraps around to something small
+        {"entry table wrapping past 2^64", [&](std::string &b) { header(b)->entryOffset = 0 - uint64_t(header(b)->entryCount) * sizeof(ArchiveEntry); }},
+        {"chunk table wrapping past 2^64", [&](std::string &b) { header(b)->chunkOffset = 0 - uint64_t(header(b)->chunkCount) * sizeof(ArchiveChunk); }},
+        {"chunk data wrapping past 2^64", [&](std::string &b) { chunk(b, 0)->offset = 0 - uint64_t(chunk(b, 0)->compressedSize); }},
+        {"entry past the chunk table", [&](std::string &b) { entry(b, 0)->firstChunk = header(b)->chunkCount; }},
+        // a short chunk in the middle would have the next one written past the end of the asset
+        {"short chunk before the last", [&](std::string &b) {
+            for (uint32_t i = 0; i < header(b)->entryCount; ++i) {
+                ArchiveEntry *e = entry(b, i);
+                if (e->chunkCount > 1) {
+                    chunk(b, e->firstChunk)->size -= 1;
+                    chunk(b, e->firstChunk + e->chunkCount - 1)->size += 1;
+                    return;
+                }
+            }
+        }},
+    };
+    const std::string badPath = goodPath + ".bad";
+    bool ok = true;
+    for (const Crafted &c : crafted) {
+        std::string bad = good;
+        c.damage(bad);
+        std::ofstream(badPath, std::ios::binary).write(bad.data(), bad.size());
+        Archive archive;
+        if (archive.open(badPath.c_str())) {
+            std::cerr << "ERROR::ARCHIVE - accepted a crafted archive: " << c.what << "\n";
+            ok = false;
+        }
+    }
+    std::remove(badPath.c_str());
+    std::cout << "crafted archives: " << (ok ? "all rejected" : "NOT all rejected") << "\n";
+    return ok;
+}
+
+// ./main --bench [assets]
+// writes a pile of shader-like text files and texture-like binaries, packs them, and then loads all of them
+// with a cold page cache: one open/read per loose file, against the archive on one thread and on the pool
+int runBenchmark(size_t count) {
+    const std::string dir = "./bench_assets";
+    mkdir(dir.c_str(), 0755);
+    std::mt19937 rng(99);
+    std::string shader;
+    if (!readWholeFile("./vertex.glsl", shader))
+        shader = "void main() {}\n";
+    std::vector<std::string> paths, expected;
+    size_t rawBytes = 0;
+    for (size_t i = 0; i < count; ++i) {
+        std::string data;
+        std::string path;
+        if (i % 10 < 7) {
+            // text compresses well, a few variants of a shader with a changing define
+            path = dir + "/shader" + std::to_string(i) + ".glsl";
+            int copies = 1 + rng() % 8;
+            for (int c = 0; c < copies; ++c)
+                data += "#define VARIANT " + std::to_string(rng() % 1000) + "\n" + shader;
+        } else {
+            // gradients with some noise, somewhere between a texture and a random blob
+            path = dir + "/texture" + std::to_string(i) + ".bin";
+            int side = 128 << (rng() % 3);
+            data.resize(side * side * 3);
+            for (int p = 0; p < side * side; ++p)
+                for (int c = 0; c < 3; ++c)
+                    data[p * 3 + c] = char(((p % side) * (c + 1) + (p / side)) / 4 + (rng() % 8 == 0 ? rng() % 4 : 0));
+        }
+        std::ofstream(path, std::ios::binary).write(data.data(), data.size());
+        paths.push_back(path);
+        rawBytes += data.size();
+        expected.push_back(std::move(data));
+    }
+    WorkerPool pool;
+    const std::string archivePath = "./bench.pak";
+    auto start = std::chrono::steady_clock::now();
+    if (!packArchive(archivePath, {dir}, pool))
+        return EXIT_FAILURE;
+    std::cout << "packed on " << pool.size() << " threads in " << millisecondsSince(start) << "ms\n";
+    if (!rejectsCraftedArchives(archivePath))
+        return EXIT_FAILURE;
+
+    auto evictAll = [&] {
+        for (const std::string &p : paths)
+            evictFromCache(p.c_str());
+        evictFromCache(archivePath.c_str());
+    };
+    bool ok = true;
+    auto check = [&](const std::vector<std::string> &got, const char *what) {
+        for (size_t i = 0; i < count; ++i) {
+            if (got[i] != expected[i]) {
+                std::cout << what << ": MISMATCH in " << paths[i] << "\n";
+                ok = false;
+                return;
+            }
+        }
+    };
+
+    std::vector<std::string> loaded(count);
+    evictAll();
+    start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < count; ++i)
+        readWholeFile(paths[i].c_str(), loaded[i]);
+    const double looseMs = millisecondsSince(start);
+    check(loaded, "loose files");
+
+    double archiveMs[2];
+    for (int parallel = 0; parallel < 2; ++parallel) {
+        evictAll();
+        start = std::chrono::steady_clock::now();
+        VirtualFS fs(parallel ? &pool : nullptr);
+        if (!fs.mount(archivePath.c_str()) || !fs.readBatch(paths, loaded))
+            return EXIT_FAILURE;
+        archiveMs[parallel] = millisecondsSince(start);
+        check(loaded, parallel ? "archive, pool" : "archive, one thread");
+    }
+    // same again with everything cached, that's just the decompression
+    start = std::chrono::steady_clock::now();
+    {
+        VirtualFS fs(&pool);
+        if (!fs.mount(archivePath.c_str()) || !fs.readBatch(paths, loaded))
+            return EXIT_FAILURE;
+    }
+    const double warmMs = millisecondsSince(start);
+    std::cout << count << " assets, " << rawBytes / 1024 << "KB, cold cache:\n"
+              << "  loose files:          " << looseMs << "ms\n"
+              << "  archive, one thread:  " << archiveMs[0] << "ms\n"
+              << "  archive, pool:        " << archiveMs[1] << "ms\n"
+              << "archive with a warm cache: " << warmMs << "ms, " << rawBytes / warmMs / 1e3 << " MB/s\n";
+
+    for (const std::string &p : paths)
+        std::remove(p.c_str());
+    rmdir(dir.c_str());
+    std::remove(archivePath.c_str());
+    return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+
+void processInput(GLFWwindow *window, glm::vec3 &cameraPos, glm::vec3 &cameraFront, glm::vec3 &cameraUp)
+{
+
+    const float cameraSpeed = 0.05f; // adjust accordingly
+    if (glfwGetKey(window, GLFW_KEY_W) == GLFW_PRESS)
+        cameraPos += cameraSpeed * cameraFront;
+    if (glfwGetKey(window, GLFW_KEY_S) == GLFW_PRESS)
+        cameraPos -= cameraSpeed * cameraFront;
+    if (glfwGetKey(window, GLFW_KEY_A) == GLFW_PRESS)
+        cameraPos -= glm::normalize(glm::cross(cameraFront, cameraUp)) * cameraSpeed;
+    if (glfwGetKey(window, GLFW_KEY_D) == GLFW_PRESS)
+        cameraPos += glm::normalize(glm::cross(cameraFront, cameraUp)) * cameraSpeed;
+    if (glfwGetKey(window, GLFW_KEY_UP) == GLFW_PRESS)
+        cameraPos += glm::normalize(glm::cross(cameraFront, cameraUp)) * cameraSpeed;
+
+}
+
+float yaw = -90.f;
+float pitch = 0.f;
+glm::vec3 cameraFront;
+
+void mouseMovement(GLFWwindow *window, double xPos, double yPos) {
+    static float lastX = xPos, lastY = yPos;
+    float xOffset = xPos - lastX;
+    float yOffset = lastY - yPos;
+    
+    constexpr float sensitivity = 0.05f;
+    xOffset *= sensitivity;
+    yOffset *= sensitivity;
+
+    yaw += xOffset;
+    pitch += yOffset;
+
+    if (std::abs(pitch) > 89.f) // don't ever do it this way. I am lazy
+        pitch = std::abs(pitch) / pitch * 89.f;
+
+    cameraFront.x = cos(glm::radians(yaw)) * cos(glm::radians(pitch));
+    cameraFront.y = sin(glm::radians(pitch));
+    cameraFront.z = sin(glm::radians(yaw)) * cos(glm::radians(pitch));
+
+    cameraFront = glm::normalize(cameraFront);
+    lastX = xPos, lastY = yPos;
+}
+
+
+
+
+
+int main(int argc, char **argv) {
+    if (argc > 2 && !std::strcmp(argv[1], "--pack")) {
+        WorkerPool pool;
+        return packArchive(argv[2], std::vector<std::string>(argv + 3, argv + argc), pool) ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+    if (argc > 1 && !std::strcmp(argv[1], "--bench"))
+        return runBenchmark(argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 1000);
+
+    // ./main [archive], pack one with ./main --pack assets.pak vertex.glsl frag.glsl image2d.tex.
+    // whatever isn't in it still comes from loose files
+    WorkerPool pool;
+    VirtualFS assets(&pool);
+    const char *archivePath = argc > 1 ? argv[1] : "./assets.pak";
+    if (access(archivePath, R_OK) == 0 && assets.mount(archivePath))
+        std::cout << "assets from " << archivePath << "\n";
+
+    if (glfwInit() != GLFW_TRUE) {
+        glfwTerminate();
+        std::cerr << "Failed to initialize GLFW";
+        return EXIT_FAILURE;
+    }
+    // setting OpenGL version to 3.3
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+    GLFWwindow *win = glfwCreateWindow(600, 600, "This is a hello window!", NULL, NULL);
+    glViewport(0, 0, 600, 600);
+    // setting 'context' for OpenGL, i.e. where to draw on current thread
+    glfwMakeContextCurrent(win);
+    // all it does is fetches us the implemented functions of OpenGL
+    if (glewInit() != GLEW_OK) {
+        glfwTerminate();
+        std::cerr << "Failed to initialize GLEW\n";
+        return EXIT_FAILURE;
+    }
+
+    glEnable(GL_DEPTH_TEST);
+    float triangle_data[] = {
+        //   vertpos   //  //texcord//
+    -0.5f, -0.5f, -0.5f,  0.0f, 0.0f,
+     0.5f, -0.5f, -0.5f,  1.0f, 0.0f,
+     0.5f,  0.5f, -0.5f,  1.0f, 1.0f,
+     0.5f,  0.5f, -0.5f,  1.0f, 1.0f,
+    -0.5f,  0.5f, -0.5f,  0.0f, 1.0f,
+    -0.5f, -0.5f, -0.5f,  0.0f, 0.0f,
+
+    -0.5f, -0.5f,  0.5f,  0.0f, 0.0f,
+     0.5f, -0.5f,  0.5f,  1.0f, 0.0f,
+     0.5f,  0.5f,  0.5f,  1.0f, 1.0f,
+     0.5f,  0.5f,  0.5f,  1.0f, 1.0f,
+    -0.5f,  0.5f,  0.5f,  0.0f, 1.0f,
+    -0.5f, -0.5f,  0.5f,  0.0f, 0.0f,
+
+    -0.5f,  0.5f,  0.5f,  1.0f, 0.0f,
+    -0.5f,  0.5f, -0.5f,  1.0f, 1.0f,
+    -0.5f, -0.5f, -0.5f,  0.0f, 1.0f,
+    -0.5f, -0.5f, -0.5f,  0.0f, 1.0f,
+    -0.5f, -0.5f,  0.5f,  0.0f, 0.0f,
+    -0.5f,  0.5f,  0.5f,  1.0f, 0.0f,
+
+     0.5f,  0.5f,  0.5f,  1.0f, 0.0f,
+     0.5f,  0.5f, -0.5f,  1.0f, 1.0f,
+     0.5f, -0.5f, -0.5f,  0.0f, 1.0f,
+     0.5f, -0.5f, -0.5f,  0.0f, 1.0f,
+     0.5f, -0.5f,  0.5f,  0.0f, 0.0f,
+     0.5f,  0.5f,  0.5f,  1.0f, 0.0f,
+
+    -0.5f, -0.5f, -0.5f,  0.0f, 1.0f,
+     0.5f, -0.5f, -0.5f,  1.0f, 1.0f,
+     0.5f, -0.5f,  0.5f,  1.0f, 0.0f,
+     0.5f, -0.5f,  0.5f,  1.0f, 0.0f,
+    -0.5f, -0.5f,  0.5f,  0.0f, 0.0f,
+    -0.5f, -0.5f, -0.5f,  0.0f, 1.0f,
+
+    -0.5f,  0.5f, -0.5f,  0.0f, 1.0f,
+     0.5f,  0.5f, -0.5f,  1.0f, 1.0f,
+     0.5f,  0.5f,  0.5f,  1.0f, 0.0f,
+     0.5f,  0.5f,  0.5f,  1.0f, 0.0f,
+    -0.5f,  0.5f,  0.5f,  0.0f, 0.0f,
+    -0.5f,  0.5f, -0.5f,  0.0f, 1.0f
+        
+    };
+
+
+    glm::vec3 cameraPos(0.f, 0.f, 3.f);
+    cameraFront = glm::vec3(0.f,0.f,-1.f);
+    glm::vec3 cameraUp(0.,1.,0.f);
+    
+
+    Texture2D tex;
+    tex.generate2DTex(assets, "./image2d.tex");
+    tex.bind();
+
+    GLuint vbo = 0;
+    glGenBuffers(1, &vbo); 
+    glBindBuffer(GL_ARRAY_BUFFER, vbo);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(triangle_data), triangle_data, GL_STATIC_DRAW);
+
+    GLuint ebo = 0;
+    GLuint index_array[] = {
+        // front
+        0, 1, 3,
+        1, 2, 3,
+        //back
+        4, 5, 6,
+        4, 6, 7,
+        // left-facing
+        2, 3, 7,
+        2, 6, 7,
+        // right-facing
+        0, 1, 4,
+        1, 4, 5
+        
+    };
+    glGenBuffers(1, &ebo);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ebo);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(index_array), index_array, GL_STATIC_DRAW);
+    
+    GLuint vao = 0;
+    glGenVertexArrays(1, &vao);
+    glBindVertexArray(vao);
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)0);
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)(3 * sizeof(float)));
+    glEnableVertexAttribArray(1);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ebo); // don't forget to bind ebo, because it uses vao to find ebo, vbo and attrib pointers
+
+    VertexShader vs;
+    FragmentShader fs;
+    vs.setSource(assets, "./vertex.glsl");
+    fs.setSource(assets, "./frag.glsl");
+    Program prog;
+    prog.AttachShaders({&vs, &fs});
+    prog.UseProgram();
+
+
+    glm::mat4 model(1.f);
+    model = glm::rotate(model, glm::radians(-55.f), glm::vec3(1.f, 0.f, 0.f));
+
+    glm::mat4 view; // = glm::translate(glm::mat4(1.f), glm::vec3(0.f,0.f,-3.f));
+       
+
+    glm::mat4 proj = glm::perspective(glm::radians(45.f), 800 / 600.f, 0.1f, 100.f);
+
+    prog.setMat4("model", model);
+    prog.setMat4("proj", proj);
+    prog.setMat4("view", view);
+
+    glfwSetCursorPosCallback(win, mouseMovement); 
+    glfwSetInputMode(win, GLFW_CURSOR, GLFW_CURSOR_DISABLED);  
+    
+    while (!glfwWindowShouldClose(win)) {
+        processInput(win, cameraPos, cameraFront, cameraUp);
+        view = glm::lookAt(cameraPos, cameraFront + cameraPos, cameraUp);
+
+        prog.setMat4("view", view);
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+        glDrawArrays(GL_TRIANGLES, 0, 36);
+        // polls different kinds of events, for example, when we close an application, it fetches that event
+        // or it fetches events like movement of the window.
+        // Without it you can neither move the window or close the window
+        glfwPollEvents();
+        // have you drawn the image, it is stored in the buffer. You can now swap this buffer with main buffer
+        // so the image appears
+        glfwSwapBuffers(win);
+    }
+    glfwTerminate();
+    
+    std::cout << "Window should close now!\n";
+
+    return EXIT_SUCCESS;
+
+}
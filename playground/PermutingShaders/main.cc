@@ -0,0 +1,682 @@
+#include <GL/glew.h>
+
+#include <GLFW/glfw3.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <glm/ext/matrix_clip_space.hpp>
+#include <glm/ext/matrix_transform.hpp>
+#include <glm/geometric.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/ext/matrix_float4x4.hpp>
+#include <glm/gtc/type_ptr.hpp>
+#include <glm/glm.hpp>
+#include <glm/trigonometric.hpp>
+#define STB_IMAGE_IMPLEMENTATION
+#include <stb/stb_image.h>
+#include <iostream>
+
+class Shader {
+    std::string src; 
+protected:
+    const char *getsrc() {
+        return src.data();
+    }
+    GLuint shader_id = 0;
+    bool isCompiled = false;
+protected:
+    virtual const char *getClassName() = 0;
+    GLint getCompilationStatus(GLuint shader_id) {
+        int status;
+        glGetShaderiv(shader_id, GL_COMPILE_STATUS, &status);
+        return status;
+    }
+    void sendError() {
+        char buffer[1024];
+        glGetShaderInfoLog(shader_id, 1024, NULL, buffer);
+        std::cerr << "ERROR::" << getClassName() << " - " << buffer;
+    }
+public:
+    // variants are built and thrown away in a loop here, so the stages have to go with them
+    virtual ~Shader() {
+        if (shader_id)
+            glDeleteShader(shader_id);
+    }
+    virtual void compile() = 0;
+    void setSource(const char *s) {
+        std::ifstream sourceFile(s);
+        if (!sourceFile.is_open())
+            return;
+        char buffer[8192];
+        while (sourceFile.read(buffer, 8192)) {
+            src.append(buffer, 8192);
+        }
+        if (!sourceFile.eof()) {
+            src.clear();
+            return;
+        }
+        src.append(buffer, sourceFile.gcount());
+    }
+    void setSourceText(std::string text) {
+        src = std::move(text);
+        isCompiled = false;
+    }
+    friend class Program;
+};
+
+
+class VertexShader : public Shader {
+    virtual const char *getClassName() override {
+        return "VertexShader";
+    }
+public:
+    virtual void compile() override {
+        if (shader_id)
+            glDeleteShader(shader_id);
+        shader_id = glCreateShader(GL_VERTEX_SHADER);
+        const char *src = getsrc();
+        glShaderSource(shader_id, 1, &src, NULL);
+        glCompileShader(shader_id);
+        if (!getCompilationStatus(shader_id)) {
+            sendError();
+        }
+        isCompiled = true;
+    }
+};
+
+class FragmentShader : public Shader {
+    const char *getClassName() override {
+        return "FragmentShader";
+    }
+public:
+    virtual void compile() override {
+        if (shader_id)
+            glDeleteShader(shader_id);
+        shader_id = glCreateShader(GL_FRAGMENT_SHADER);
+        const char *src = getsrc();
+        glShaderSource(shader_id, 1, &src, NULL);
+        glCompileShader(shader_id);
+        if (!getCompilationStatus(shader_id)) {
+            sendError();
+        }
+        isCompiled = true;
+    }
+};
+
+
+class Program {
+    GLuint program_id = 0;
+    void sendError() {
+        char buffer[1024];
+        glGetProgramInfoLog(program_id, 1024, NULL, buffer);
+        std::cerr << "ERROR::PROGRAM: " << " - " << buffer;
+    }
+public:
+    bool linkStatus() {
+        int status = 0;
+        glGetProgramiv(program_id, GL_LINK_STATUS, &status);
+        return status;
+    }
+    Program() {
+        program_id = glCreateProgram();
+    }
+    ~Program() {
+        glDeleteProgram(program_id);
+    }
+    void AttachShaders(std::initializer_list<Shader*> shaders) {
+        auto i = shaders.begin();
+        while (i != shaders.end()) {
+            if (!(*i)->isCompiled)
+                (*i)->compile();
+            glAttachShader(program_id, (*i)->shader_id);
+            ++i;
+        }
+        glLinkProgram(program_id);
+        if (!linkStatus()) {
+            sendError();
+        }
+    }
+    void UseProgram() {
+        glUseProgram(program_id);
+    }
+    void setMat4(const char *locName, const glm::mat4 &mat) {
+        int location = glGetUniformLocation(program_id, locName);
+        if (location == -1)
+            return;
+        glUniformMatrix4fv(location, 1, GL_FALSE, glm::value_ptr(mat));
+    }
+    void setInt(const char *locName, int value) {
+        int location = glGetUniformLocation(program_id, locName);
+        if (location == -1)
+            return;
+        glUniform1i(location, value);
+    }
+    void setFloat(const char *locName, float value) {
+        int location = glGetUniformLocation(program_id, locName);
+        if (location == -1)
+            return;
+        glUniform1f(location, value);
+    }
+    void setVec3(const char *locName, const glm::vec3 &vec) {
+        int location = glGetUniformLocation(program_id, locName);
+        if (location == -1)
+            return;
+        glUniform3f(location, vec.x, vec.y, vec.z);
+    }
+    void setVec4(const char *locName, const glm::vec4 &vec) {
+        int location = glGetUniformLocation(program_id, locName);
+        if (location == -1)
+            return;
+        glUniform4f(location, vec.x, vec.y, vec.z, vec.w);
+    }
+};
+
+
+class Texture2D {
+    GLuint tex_id;
+public:
+    void generate2DTex(const char *image_path) {
+        int width, height, nChannels;
+        stbi_set_flip_vertically_on_load(true);
+        uint8_t *raw_image = stbi_load(image_path, &width, &height, &nChannels, 0);
+        float borderColor[] = {1.f, 1.f, 1.f, 1.f};
+        glGenTextures(1, &tex_id);
+        glBindTexture(GL_TEXTURE_2D, tex_id);
+        // what to do when primitive is bigger than the texture
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_BORDER);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_BORDER);
+        glTexParameterfv(GL_TEXTURE_2D, GL_TEXTURE_BORDER_COLOR, borderColor);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        // glTexImage2D(TARGET_TYPE, IM_MIPMAP_LEVEL, TARGET_NRCHANNELS, SRC_WIDTH, SRC_HEIGHT, LEGACY_0, SRC_NRCHANNELS, SRC_DATA_TYPE, SRC_DATA);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, width, height, 0, GL_RGB, GL_UNSIGNED_BYTE, raw_image);
+        stbi_image_free(raw_image);
+    }
+    void bind() {
+        glBindTexture(GL_TEXTURE_2D, tex_id);
+    }
+};
+
+
+
+// ---------------------------------------------------------------------------------------------------------
+// shader permutations. a family is one vertex and one fragment source with #ifdef blocks, and it declares
+// what can be switched with "#pragma feature NAME" lines. a variant is a bitmask of those features, bit i
+// being the i-th declared one, and its source is the family's with a #define per set bit right after #version.
+// variants are compiled the first time they are asked for and kept by key
+// ---------------------------------------------------------------------------------------------------------
+
+using VariantKey = uint32_t;
+
+class ShaderFamily {
+    std::string familyName;
+    std::string vertexSource, fragmentSource;
+    std::vector<std::string> features;
+
+    static bool readFile(const char *path, std::string &out) {
+        std::ifstream file(path, std::ios::binary);
+        if (!file.is_open())
+            return false;
+        std::ostringstream text;
+        text << file.rdbuf();
+        out = text.str();
+        return true;
+    }
+    // collects the "#pragma feature" lines and empties them, so the compiler never sees them.
+    // the lines themselves stay, which keeps the line numbers in compile errors right
+    bool declareFeatures(std::string &src) {
+        size_t pos = 0;
+        while ((pos = src.find("#pragma feature", pos)) != std::string::npos) {
+            size_t end = src.find('\n', pos);
+            if (end == std::string::npos)
+                end = src.size();
+            std::istringstream line(src.substr(pos + 15, end - pos - 15));
+            std::string name;
+            while (line >> name) {
+                if (std::find(features.begin(), features.end(), name) != features.end())
+                    continue;  // declared by the other stage already
+                if (features.size() == 32) {
+                    std::cerr << "ERROR::SHADER_FAMILY - " << familyName << " has more than 32 features\n";
+                    return false;
+                }
+                features.push_back(name);
+            }
+            src.erase(pos, end - pos);
+        }
+        return true;
+    }
+    std::string generate(const std::string &src, VariantKey key) const {
+        // #version has to stay the first thing in the source
+        size_t afterVersion = 0;
+        if (src.compare(0, 8, "#version") == 0) {
+            afterVersion = src.find('\n');
+            afterVersion = afterVersion == std::string::npos ? src.size() : afterVersion + 1;
+        }
+        std::string out = src.substr(0, afterVersion);
+        for (size_t i = 0; i < features.size(); ++i)
+            if (key & (1u << i))
+                out += "#define " + features[i] + " 1\n";
+        // error messages should point at the lines of the file, not of the generated source
+        out += "#line " + std::to_string(afterVersion ? 2 : 1) + "\n";
+        out.append(src, afterVersion, std::string::npos);
+        return out;
+    }
+public:
+    bool load(const char *name, const char *vertexPath, const char *fragmentPath) {
+        familyName = name;
+        features.clear();
+        if (!readFile(vertexPath, vertexSource) || !readFile(fragmentPath, fragmentSource)) {
+            std::cerr << "ERROR::SHADER_FAMILY - can't read " << vertexPath << " or " << fragmentPath << "\n";
+            return false;
+        }
+        return declareFeatures(vertexSource) && declareFeatures(fragmentSource);
+    }
+    const std::string &name() const {
+        return familyName;
+    }
+    const std::vector<std::string> &featureNames() const {
+        return features;
+    }
+    // ok is cleared for names the family doesn't declare, those bits are left out
+    VariantKey key(const std::vector<std::string> &names, bool *ok = nullptr) const {
+        VariantKey key = 0;
+        for (const std::string &name : names) {
+            auto it = std::find(features.begin(), features.end(), name);
+            if (it == features.end()) {
+                std::cerr << "ERROR::SHADER_FAMILY - " << familyName << " has no feature " << name << "\n";
+                if (ok)
+                    *ok = false;
+                continue;
+            }
+            key |= 1u << (it - features.begin());
+        }
+        return key;
+    }
+    std::string describe(VariantKey key) const {
+        std::string out;
+        for (size_t i = 0; i < features.size(); ++i) {
+            if (!(key & (1u << i)))
+                continue;
+            if (!out.empty())
+                out += ' ';
+            out += features[i];
+        }
+        return out.empty() ? "(none)" : out;
+    }
+    std::string vertex(VariantKey key) const {
+        return generate(vertexSource, key);
+    }
+    std::string fragment(VariantKey key) const {
+        return generate(fragmentSource, key);
+    }
+};
+
+
+class ShaderVariantCache {
+    std::vector<const ShaderFamily*> families;
+    struct Variant {
+        std::unique_ptr<Program> program;
+        bool used = false;
+    };
+    // family index in the high half, variant key in the low one
+    std::unordered_map<uint64_t, Variant> programs;
+    std::vector<std::pair<const ShaderFamily*, VariantKey>> used;
+
+    uint64_t cacheKey(const ShaderFamily &family, VariantKey key) const {
+        size_t index = std::find(families.begin(), families.end(), &family) - families.begin();
+        return uint64_t(index) << 32 | key;
+    }
+    Variant &build(const ShaderFamily &family, VariantKey key) {
+        auto start = std::chrono::steady_clock::now();
+        VertexShader vs;
+        FragmentShader fs;
+        vs.setSourceText(family.vertex(key));
+        fs.setSourceText(family.fragment(key));
+        std::unique_ptr<Program> prog(new Program());
+        prog->AttachShaders({&vs, &fs});
+        if (!prog->linkStatus())
+            std::cerr << "ERROR::SHADER_VARIANT - " << family.name() << " [" << family.describe(key) << "] didn't build\n";
+        buildMs += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        ++builds;
+        Variant &variant = programs[cacheKey(family, key)];
+        variant.program = std::move(prog);
+        return variant;
+    }
+public:
+    size_t hits = 0, builds = 0;
+    double buildMs = 0.;
+
+    void addFamily(const ShaderFamily *family) {
+        families.push_back(family);
+    }
+    size_t size() const {
+        return programs.size();
+    }
+    // builds the variant on first use. the first time every variant is asked for it also goes on the list
+    // writeManifest() saves, the manifest is what prewarm() builds up front next time
+    Program &get(const ShaderFamily &family, VariantKey key) {
+        auto it = programs.find(cacheKey(family, key));
+        if (it != programs.end())
+            ++hits;
+        Variant &variant = it != programs.end() ? it->second : build(family, key);
+        if (!variant.used) {
+            variant.used = true;
+            used.push_back({&family, key});
+        }
+        return *variant.program;
+    }
+    // builds every variant in the manifest, a line per variant: the family name and its feature names.
+    // names rather than keys, so adding a feature to a family doesn't turn old manifests into garbage
+    size_t prewarm(const char *path) {
+        std::ifstream manifest(path);
+        if (!manifest.is_open())
+            return 0;
+        size_t built = 0;
+        std::string line;
+        while (std::getline(manifest, line)) {
+            std::istringstream words(line);
+            std::string familyName, feature;
+            if (!(words >> familyName) || familyName[0] == '#')
+                continue;
+            auto family = std::find_if(families.begin(), families.end(), [&](const ShaderFamily *f) { return f->name() == familyName; });
+            if (family == families.end()) {
+                std::cerr << "ERROR::SHADER_MANIFEST - no shader family " << familyName << "\n";
+                continue;
+            }
+            std::vector<std::string> names;
+            while (words >> feature)
+                names.push_back(feature);
+            bool ok = true;
+            VariantKey key = (*family)->key(names, &ok);
+            if (!ok || programs.count(cacheKey(**family, key)))
+                continue;
+            build(**family, key);
+            ++built;
+        }
+        return built;
+    }
+    // what was actually used this run, in the order it was first needed
+    bool writeManifest(const char *path) const {
+        std::ofstream manifest(path, std::ios::trunc);
+        if (!manifest.is_open()) {
+            std::cerr << "ERROR::SHADER_MANIFEST - can't write " << path << "\n";
+            return false;
+        }
+        manifest << "# shader variants the last run used: family and features, built at startup along with shaders.manifest\n";
+        for (const auto &variant : used) {
+            manifest << variant.first->name();
+            for (size_t i = 0; i < variant.first->featureNames().size(); ++i)
+                if (variant.second & (1u << i))
+                    manifest << ' ' << variant.first->featureNames()[i];
+            manifest << "\n";
+        }
+        return bool(manifest);
+    }
+};
+
+
+void processInput(GLFWwindow *window, glm::vec3 &cameraPos, glm::vec3 &cameraFront, glm::vec3 &cameraUp)
+{
+
+    const float cameraSpeed = 0.05f; // adjust accordingly
+    if (glfwGetKey(window, GLFW_KEY_W) == GLFW_PRESS)
+        cameraPos += cameraSpeed * cameraFront;
+    if (glfwGetKey(window, GLFW_KEY_S) == GLFW_PRESS)
+        cameraPos -= cameraSpeed * cameraFront;
+    if (glfwGetKey(window, GLFW_KEY_A) == GLFW_PRESS)
+        cameraPos -= glm::normalize(glm::cross(cameraFront, cameraUp)) * cameraSpeed;
+    if (glfwGetKey(window, GLFW_KEY_D) == GLFW_PRESS)
+        cameraPos += glm::normalize(glm::cross(cameraFront, cameraUp)) * cameraSpeed;
+    if (glfwGetKey(window, GLFW_KEY_UP) == GLFW_PRESS)
+        cameraPos += glm::normalize(glm::cross(cameraFront, cameraUp)) * cameraSpeed;
+
+}
+
+// true only on the frame the key went down
+bool keyPressed(GLFWwindow *window, int key) {
+    static bool down[GLFW_KEY_LAST + 1] = {};
+    bool now = glfwGetKey(window, key) == GLFW_PRESS;
+    bool pressed = now && !down[key];
+    down[key] = now;
+    return pressed;
+}
+
+
+float yaw = -90.f;
+float pitch = 0.f;
+glm::vec3 cameraFront;
+
+void mouseMovement(GLFWwindow *window, double xPos, double yPos) {
+    static float lastX = xPos, lastY = yPos;
+    float xOffset = xPos - lastX;
+    float yOffset = lastY - yPos;
+    
+    constexpr float sensitivity = 0.05f;
+    xOffset *= sensitivity;
+    yOffset *= sensitivity;
+
+    yaw += xOffset;
+    pitch += yOffset;
+
+    if (std::abs(pitch) > 89.f) // don't ever do it this way. I am lazy
+        pitch = std::abs(pitch) / pitch * 89.f;
+
+    cameraFront.x = cos(glm::radians(yaw)) * cos(glm::radians(pitch));
+    cameraFront.y = sin(glm::radians(pitch));
+    cameraFront.z = sin(glm::radians(yaw)) * cos(glm::radians(pitch));
+
+    cameraFront = glm::normalize(cameraFront);
+    lastX = xPos, lastY = yPos;
+}
+
+
+struct SceneCube {
+    glm::vec3 pos;
+    std::vector<std::string> features;
+};
+
+
+// ./main                      a row of cubes, each drawn with another variant of the uber shader
+// ./main --print [features]   prints the sources of a variant, e.g. --print TRANSFORM TEXTURE
+int main(int argc, char **argv) {
+    // the committed manifest is the seed, what a run actually used goes next to it and stays out of git
+    const char *manifestPath = "./shaders.manifest";
+    const char *learnedManifestPath = "./shaders.manifest.learned";
+    ShaderFamily uber;
+    if (argc > 1 && !std::strcmp(argv[1], "--print")) {
+        if (!uber.load("uber", "./uber_vertex.glsl", "./uber_frag.glsl"))
+            return EXIT_FAILURE;
+        bool ok = true;
+        VariantKey key = uber.key(std::vector<std::string>(argv + 2, argv + argc), &ok);
+        std::cout << "features:";
+        for (const std::string &name : uber.featureNames())
+            std::cout << " " << name;
+        std::cout << "\nkey 0x" << std::hex << key << std::dec << " [" << uber.describe(key) << "]\n"
+                  << "---- vertex ----\n" << uber.vertex(key) << "---- fragment ----\n" << uber.fragment(key);
+        return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+
+    if (glfwInit() != GLFW_TRUE) {
+        glfwTerminate();
+        std::cerr << "Failed to initialize GLFW";
+        return EXIT_FAILURE;
+    }
+    // setting OpenGL version to 3.3
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+    GLFWwindow *win = glfwCreateWindow(800, 600, "This is a hello window!", NULL, NULL);
+    // setting 'context' for OpenGL, i.e. where to draw on current thread
+    glfwMakeContextCurrent(win);
+    // all it does is fetches us the implemented functions of OpenGL
+    if (glewInit() != GLEW_OK) {
+        glfwTerminate();
+        std::cerr << "Failed to initialize GLEW\n";
+        return EXIT_FAILURE;
+    }
+    int screenWidth, screenHeight;
+    glfwGetFramebufferSize(win, &screenWidth, &screenHeight);
+    glViewport(0, 0, screenWidth, screenHeight);
+
+    glEnable(GL_DEPTH_TEST);
+    float triangle_data[] = {
+        //   vertpos   //  //   normal   //  //texcord//
+    -0.5f, -0.5f, -0.5f,  0.0f,  0.0f, -1.0f,  0.0f, 0.0f,
+     0.5f, -0.5f, -0.5f,  0.0f,  0.0f, -1.0f,  1.0f, 0.0f,
+     0.5f,  0.5f, -0.5f,  0.0f,  0.0f, -1.0f,  1.0f, 1.0f,
+     0.5f,  0.5f, -0.5f,  0.0f,  0.0f, -1.0f,  1.0f, 1.0f,
+    -0.5f,  0.5f, -0.5f,  0.0f,  0.0f, -1.0f,  0.0f, 1.0f,
+    -0.5f, -0.5f, -0.5f,  0.0f,  0.0f, -1.0f,  0.0f, 0.0f,
+
+    -0.5f, -0.5f,  0.5f,  0.0f,  0.0f,  1.0f,  0.0f, 0.0f,
+     0.5f, -0.5f,  0.5f,  0.0f,  0.0f,  1.0f,  1.0f, 0.0f,
+     0.5f,  0.5f,  0.5f,  0.0f,  0.0f,  1.0f,  1.0f, 1.0f,
+     0.5f,  0.5f,  0.5f,  0.0f,  0.0f,  1.0f,  1.0f, 1.0f,
+    -0.5f,  0.5f,  0.5f,  0.0f,  0.0f,  1.0f,  0.0f, 1.0f,
+    -0.5f, -0.5f,  0.5f,  0.0f,  0.0f,  1.0f,  0.0f, 0.0f,
+
+    -0.5f,  0.5f,  0.5f, -1.0f,  0.0f,  0.0f,  1.0f, 0.0f,
+    -0.5f,  0.5f, -0.5f, -1.0f,  0.0f,  0.0f,  1.0f, 1.0f,
+    -0.5f, -0.5f, -0.5f, -1.0f,  0.0f,  0.0f,  0.0f, 1.0f,
+    -0.5f, -0.5f, -0.5f, -1.0f,  0.0f,  0.0f,  0.0f, 1.0f,
+    -0.5f, -0.5f,  0.5f, -1.0f,  0.0f,  0.0f,  0.0f, 0.0f,
+    -0.5f,  0.5f,  0.5f, -1.0f,  0.0f,  0.0f,  1.0f, 0.0f,
+
+     0.5f,  0.5f,  0.5f,  1.0f,  0.0f,  0.0f,  1.0f, 0.0f,
+     0.5f,  0.5f, -0.5f,  1.0f,  0.0f,  0.0f,  1.0f, 1.0f,
+     0.5f, -0.5f, -0.5f,  1.0f,  0.0f,  0.0f,  0.0f, 1.0f,
+     0.5f, -0.5f, -0.5f,  1.0f,  0.0f,  0.0f,  0.0f, 1.0f,
+     0.5f, -0.5f,  0.5f,  1.0f,  0.0f,  0.0f,  0.0f, 0.0f,
+     0.5f,  0.5f,  0.5f,  1.0f,  0.0f,  0.0f,  1.0f, 0.0f,
+
+    -0.5f, -0.5f, -0.5f,  0.0f, -1.0f,  0.0f,  0.0f, 1.0f,
+     0.5f, -0.5f, -0.5f,  0.0f, -1.0f,  0.0f,  1.0f, 1.0f,
+     0.5f, -0.5f,  0.5f,  0.0f, -1.0f,  0.0f,  1.0f, 0.0f,
+     0.5f, -0.5f,  0.5f,  0.0f, -1.0f,  0.0f,  1.0f, 0.0f,
+    -0.5f, -0.5f,  0.5f,  0.0f, -1.0f,  0.0f,  0.0f, 0.0f,
+    -0.5f, -0.5f, -0.5f,  0.0f, -1.0f,  0.0f,  0.0f, 1.0f,
+
+    -0.5f,  0.5f, -0.5f,  0.0f,  1.0f,  0.0f,  0.0f, 1.0f,
+     0.5f,  0.5f, -0.5f,  0.0f,  1.0f,  0.0f,  1.0f, 1.0f,
+     0.5f,  0.5f,  0.5f,  0.0f,  1.0f,  0.0f,  1.0f, 0.0f,
+     0.5f,  0.5f,  0.5f,  0.0f,  1.0f,  0.0f,  1.0f, 0.0f,
+    -0.5f,  0.5f,  0.5f,  0.0f,  1.0f,  0.0f,  0.0f, 0.0f,
+    -0.5f,  0.5f, -0.5f,  0.0f,  1.0f,  0.0f,  0.0f, 1.0f
+        
+    };
+
+
+    glm::vec3 cameraPos(0.f, 0.f, 3.f);
+    cameraFront = glm::vec3(0.f,0.f,-1.f);
+    glm::vec3 cameraUp(0.,1.,0.f);
+    
+
+    Texture2D tex;
+    tex.generate2DTex("./image2d.tex");
+    glActiveTexture(GL_TEXTURE1);
+    tex.bind();
+    glActiveTexture(GL_TEXTURE0);
+    tex.bind();
+
+    GLuint vbo = 0;
+    glGenBuffers(1, &vbo); 
+    glBindBuffer(GL_ARRAY_BUFFER, vbo);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(triangle_data), triangle_data, GL_STATIC_DRAW);
+
+    GLuint vao = 0;
+    glGenVertexArrays(1, &vao);
+    glBindVertexArray(vao);
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)0);
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)(6 * sizeof(float)));
+    glEnableVertexAttribArray(1);
+    glVertexAttribPointer(2, 3, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)(3 * sizeof(float)));
+    glEnableVertexAttribArray(2);
+
+    if (!uber.load("uber", "./uber_vertex.glsl", "./uber_frag.glsl")) {
+        glfwTerminate();
+        return EXIT_FAILURE;
+    }
+    ShaderVariantCache variants;
+    variants.addFamily(&uber);
+    size_t prewarmed = variants.prewarm(manifestPath);
+    prewarmed += variants.prewarm(learnedManifestPath);
+    std::cout << "prewarmed " << prewarmed << " of " << (1u << uber.featureNames().size()) << " possible variants from "
+              << manifestPath << " and " << learnedManifestPath << " in " << variants.buildMs << "ms\n";
+    const size_t buildsAtStart = variants.builds;
+
+    std::vector<SceneCube> cubes = {
+        {glm::vec3(-3.f, 0.f, -4.f), {"TRANSFORM", "TEXTURE"}},
+        {glm::vec3(-1.5f, 0.f, -4.f), {"TRANSFORM", "VERTEX_COLOR"}},
+        {glm::vec3(0.f, 0.f, -4.f), {"TRANSFORM", "TEXTURE", "LIGHTING"}},
+        {glm::vec3(1.5f, 0.f, -4.f), {"TRANSFORM", "TEXTURE", "SECOND_TEXTURE"}},
+        {glm::vec3(3.f, 0.f, -4.f), {"TRANSFORM", "VERTEX_COLOR", "TEXTURE", "LIGHTING"}},
+    };
+    std::vector<VariantKey> keys;
+    for (const SceneCube &cube : cubes)
+        keys.push_back(uber.key(cube.features));
+    // 1-4 switch the features of the middle cube, variants nobody asked for before get built right then
+    const char *toggles[] = {"VERTEX_COLOR", "TEXTURE", "LIGHTING", "SECOND_TEXTURE"};
+
+    glm::mat4 view; // = glm::translate(glm::mat4(1.f), glm::vec3(0.f,0.f,-3.f));
+       
+
+    glm::mat4 proj = glm::perspective(glm::radians(45.f), float(screenWidth) / screenHeight, 0.1f, 100.f);
+
+    glfwSetCursorPosCallback(win, mouseMovement); 
+    glfwSetInputMode(win, GLFW_CURSOR, GLFW_CURSOR_DISABLED);  
+
+    double lastReport = glfwGetTime();
+    
+    while (!glfwWindowShouldClose(win)) {
+        processInput(win, cameraPos, cameraFront, cameraUp);
+        view = glm::lookAt(cameraPos, cameraFront + cameraPos, cameraUp);
+        for (int i = 0; i < 4; ++i)
+            if (keyPressed(win, GLFW_KEY_1 + i))
+                keys[2] ^= uber.key({toggles[i]});
+
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+        for (size_t i = 0; i < cubes.size(); ++i) {
+            Program &prog = variants.get(uber, keys[i]);
+            prog.UseProgram();
+            // uniforms a variant doesn't have are skipped by the setters
+            prog.setMat4("proj", proj);
+            prog.setMat4("view", view);
+            prog.setMat4("model", glm::rotate(glm::translate(glm::mat4(1.f), cubes[i].pos), float(glfwGetTime()) * 0.5f, glm::vec3(0.5f, 1.f, 0.f)));
+            prog.setInt("tex", 0);
+            prog.setInt("tex2", 1);
+            prog.setFloat("blend", 0.5f + 0.5f * std::sin(glfwGetTime()));
+            glDrawArrays(GL_TRIANGLES, 0, 36);
+        }
+
+        if (glfwGetTime() - lastReport > 1.) {
+            lastReport = glfwGetTime();
+            std::cout << variants.size() << " variants built, " << variants.builds - buildsAtStart << " of them while running, "
+                      << variants.hits << " cache hits, " << variants.buildMs << "ms compiling in total, middle cube ["
+                      << uber.describe(keys[2]) << "]\n";
+        }
+        // polls different kinds of events, for example, when we close an application, it fetches that event
+        // or it fetches events like movement of the window.
+        // Without it you can neither move the window or close the window
+        glfwPollEvents();
+        // have you drawn the image, it is stored in the buffer. You can now swap this buffer with main buffer
+        // so the image appears
+        glfwSwapBuffers(win);
+    }
+    // next time, build up front what this run ended up using
+    variants.writeManifest(learnedManifestPath);
+    glfwTerminate();
+    
+    std::cout << "Window should close now!\n";
+
+    return EXIT_SUCCESS;
+
+}
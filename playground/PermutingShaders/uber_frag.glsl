@@ -0,0 +1,35 @@
+#version 330 core
+#pragma feature SECOND_TEXTURE
+
+out vec4 FragColor;
+#ifdef VERTEX_COLOR
+in vec4 color;
+#endif
+#ifdef TEXTURE
+in vec2 texCoord;
+uniform sampler2D tex;
+#ifdef SECOND_TEXTURE
+uniform sampler2D tex2;
+uniform float blend;
+#endif
+#endif
+#ifdef LIGHTING
+in vec3 worldNormal;
+#endif
+
+void main() {
+    vec4 result = vec4(1.0);
+#ifdef TEXTURE
+    result = texture(tex, texCoord);
+#ifdef SECOND_TEXTURE
+    result = mix(result, texture(tex2, texCoord.yx), blend);
+#endif
+#endif
+#ifdef VERTEX_COLOR
+    result *= color;
+#endif
+#ifdef LIGHTING
+    result.rgb *= 0.25 + 0.75 * max(dot(normalize(worldNormal), normalize(vec3(0.4, 1.0, 0.3))), 0.0);
+#endif
+    FragColor = result;
+}
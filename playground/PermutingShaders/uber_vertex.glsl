@@ -0,0 +1,44 @@
+#version 330 core
+#pragma feature TRANSFORM VERTEX_COLOR TEXTURE LIGHTING
+
+layout(location = 0) in vec3 aPos;
+layout(location = 1) in vec2 aTexCoord;
+layout(location = 2) in vec3 aNormal;
+
+#ifdef VERTEX_COLOR
+out vec4 color;
+#endif
+#ifdef TEXTURE
+out vec2 texCoord;
+#endif
+#ifdef LIGHTING
+out vec3 worldNormal;
+#endif
+
+#ifdef TRANSFORM
+uniform mat4 proj;
+uniform mat4 view;
+uniform mat4 model;
+#endif
+
+
+void main() {
+#ifdef TRANSFORM
+    gl_Position = proj * view * model * vec4(aPos, 1.0);
+#else
+    gl_Position = vec4(aPos, 1.0);
+#endif
+#ifdef VERTEX_COLOR
+    color = vec4(aPos + 0.5, 1.0f);
+#endif
+#ifdef TEXTURE
+    texCoord = aTexCoord;
+#endif
+#ifdef LIGHTING
+#ifdef TRANSFORM
+    worldNormal = mat3(model) * aNormal;
+#else
+    worldNormal = aNormal;
+#endif
+#endif
+}
@@ -0,0 +1,850 @@
+#include <GL/glew.h>
+
+#include <GLFW/glfw3.h>
+#include <algorithm>
+#include <cfloat>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <random>
+#include <vector>
+#include <glm/ext/matrix_clip_space.hpp>
+#include <glm/ext/matrix_transform.hpp>
+#include <glm/geometric.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/quaternion.hpp>
+#include <glm/ext/matrix_float4x4.hpp>
+#include <glm/gtc/type_ptr.hpp>
+#include <glm/glm.hpp>
+#include <glm/trigonometric.hpp>
+#define STB_IMAGE_IMPLEMENTATION
+#include <stb/stb_image.h>
+#include <iostream>
+
+class Shader {
+    std::string src; 
+protected:
+    const char *getsrc() {
+        return src.data();
+    }
+    GLuint shader_id = 0;
+    bool isCompiled = false;
+protected:
+    virtual const char *getClassName() = 0;
+    GLint getCompilationStatus(GLuint shader_id) {
+        int status;
+        glGetShaderiv(shader_id, GL_COMPILE_STATUS, &status);
+        return status;
+    }
+    void sendError() {
+        char buffer[1024];
+        glGetShaderInfoLog(shader_id, 1024, NULL, buffer);
+        std::cerr << "ERROR::" << getClassName() << " - " << buffer;
+    }
+public:
+    virtual void compile() = 0;
+    void setSource(const char *s) {
+        std::ifstream sourceFile(s);
+        if (!sourceFile.is_open())
+            return;
+        char buffer[8192];
+        while (sourceFile.read(buffer, 8192)) {
+            src.append(buffer, 8192);
+        }
+        if (!sourceFile.eof()) {
+            src.clear();
+            return;
+        }
+        src.append(buffer, sourceFile.gcount());
+    }
+    friend class Program;
+};
+
+
+class VertexShader : public Shader {
+    virtual const char *getClassName() override {
+        return "VertexShader";
+    }
+public:
+    virtual void compile() override {
+        if (shader_id)
+            glDeleteShader(shader_id);
+        shader_id = glCreateShader(GL_VERTEX_SHADER);
+        const char *src = getsrc();
+        glShaderSource(shader_id, 1, &src, NULL);
+        glCompileShader(shader_id);
+        if (!getCompilationStatus(shader_id)) {
+            sendError();
+        }
+        isCompiled = true;
+    }
+};
+
+class FragmentShader : public Shader {
+    const char *getClassName() override {
+        return "FragmentShader";
+    }
+public:
+    virtual void compile() override {
+        if (shader_id)
+            glDeleteShader(shader_id);
+        shader_id = glCreateShader(GL_FRAGMENT_SHADER);
+        const char *src = getsrc();
+        glShaderSource(shader_id, 1, &src, NULL);
+        glCompileShader(shader_id);
+        if (!getCompilationStatus(shader_id)) {
+            sendError();
+        }
+        isCompiled = true;
+    }
+};
+
+
+class Program {
+    GLuint program_id = 0;
+    void sendError() {
+        char buffer[1024];
+        glGetProgramInfoLog(program_id, 1024, NULL, buffer);
+        std::cerr << "ERROR::PROGRAM: " << " - " << buffer;
+    }
+    bool linkStatus() {
+        int status = 0;
+        glGetProgramiv(program_id, GL_LINK_STATUS, &status);
+        return status;
+    }
+public:
+    Program() {
+        program_id = glCreateProgram();
+    }
+    ~Program() {
+        glDeleteProgram(program_id);
+    }
+    void AttachShaders(std::initializer_list<Shader*> shaders) {
+        auto i = shaders.begin();
+        while (i != shaders.end()) {
+            if (!(*i)->isCompiled)
+                (*i)->compile();
+            glAttachShader(program_id, (*i)->shader_id);
+            ++i;
+        }
+        glLinkProgram(program_id);
+        if (!linkStatus()) {
+            sendError();
+        }
+    }
+    void UseProgram() {
+        glUseProgram(program_id);
+    }
+    void setMat4(const char *locName, const glm::mat4 &mat) {
+        int location = glGetUniformLocation(program_id, locName);
+        if (location == -1)
+            return;
+        glUniformMatrix4fv(location, 1, GL_FALSE, glm::value_ptr(mat));
+    }
+    void setInt(const char *locName, int value) {
+        int location = glGetUniformLocation(program_id, locName);
+        if (location == -1)
+            return;
+        glUniform1i(location, value);
+    }
+    void setFloat(const char *locName, float value) {
+        int location = glGetUniformLocation(program_id, locName);
+        if (location == -1)
+            return;
+        glUniform1f(location, value);
+    }
+    void setVec3(const char *locName, const glm::vec3 &vec) {
+        int location = glGetUniformLocation(program_id, locName);
+        if (location == -1)
+            return;
+        glUniform3f(location, vec.x, vec.y, vec.z);
+    }
+    void setVec4(const char *locName, const glm::vec4 &vec) {
+        int location = glGetUniformLocation(program_id, locName);
+        if (location == -1)
+            return;
+        glUniform4f(location, vec.x, vec.y, vec.z, vec.w);
+    }
+};
+
+
+class Texture2D {
+    GLuint tex_id;
+public:
+    void generate2DTex(const char *image_path) {
+        int width, height, nChannels;
+        stbi_set_flip_vertically_on_load(true);
+        uint8_t *raw_image = stbi_load(image_path, &width, &height, &nChannels, 0);
+        float borderColor[] = {1.f, 1.f, 1.f, 1.f};
+        glGenTextures(1, &tex_id);
+        glBindTexture(GL_TEXTURE_2D, tex_id);
+        // what to do when primitive is bigger than the texture
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_BORDER);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_BORDER);
+        glTexParameterfv(GL_TEXTURE_2D, GL_TEXTURE_BORDER_COLOR, borderColor);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        // glTexImage2D(TARGET_TYPE, IM_MIPMAP_LEVEL, TARGET_NRCHANNELS, SRC_WIDTH, SRC_HEIGHT, LEGACY_0, SRC_NRCHANNELS, SRC_DATA_TYPE, SRC_DATA);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, width, height, 0, GL_RGB, GL_UNSIGNED_BYTE, raw_image);
+        stbi_image_free(raw_image);
+    }
+    void bind() {
+        glBindTexture(GL_TEXTURE_2D, tex_id);
+    }
+};
+
+
+
+// ---------------------------------------------------------------------------------------------------------
+// transform hierarchy. every node has a local position, rotation and scale and maybe a parent, and its world
+// matrix is the parent's world matrix times its local one. the nodes are kept in depth-first order, parents
+// before their children, so a node's whole subtree is the range right after it. setting a local transform
+// only marks the node, and update() recomputes the marked subtrees and nothing else. a scene where nothing
+// moved costs nothing to update
+// ---------------------------------------------------------------------------------------------------------
+
+using NodeId = uint32_t;
+constexpr uint32_t NO_NODE = UINT32_MAX;
+const glm::quat NO_ROTATION(1.f, 0.f, 0.f, 0.f);
+
+struct Aabb {
+    glm::vec3 min = glm::vec3(0.f), max = glm::vec3(0.f);
+};
+
+// the box around a box moved by an affine matrix: the center moves, the extent goes through |rotation and scale|
+Aabb transformAabb(const glm::mat4 &m, const Aabb &box) {
+    glm::vec3 center = (box.min + box.max) * 0.5f, extent = (box.max - box.min) * 0.5f;
+    glm::vec3 worldCenter = glm::vec3(m * glm::vec4(center, 1.f)), worldExtent(0.f);
+    for (int axis = 0; axis < 3; ++axis)
+        for (int i = 0; i < 3; ++i)
+            worldExtent[axis] += std::fabs(m[i][axis]) * extent[i];
+    Aabb out;
+    out.min = worldCenter - worldExtent;
+    out.max = worldCenter + worldExtent;
+    return out;
+}
+
+glm::mat4 composeTRS(const glm::vec3 &position, const glm::quat &rotation, const glm::vec3 &scale) {
+    glm::mat3 r = glm::mat3_cast(rotation);
+    glm::mat4 m;
+    m[0] = glm::vec4(r[0] * scale.x, 0.f);
+    m[1] = glm::vec4(r[1] * scale.y, 0.f);
+    m[2] = glm::vec4(r[2] * scale.z, 0.f);
+    m[3] = glm::vec4(position, 1.f);
+    return m;
+}
+
+
+class TransformHierarchy {
+    // by position in depth-first order
+    std::vector<uint32_t> parent;        // NO_NODE for roots
+    std::vector<uint32_t> subtreeSize;   // the node and everything under it
+    std::vector<glm::vec3> position, scale;
+    std::vector<glm::quat> rotation;
+    std::vector<Aabb> localBounds, worldBounds;
+    std::vector<glm::mat4> world;
+    std::vector<NodeId> idAt;
+    std::vector<uint8_t> marked;
+    // by id, ids stay the same when the order changes
+    std::vector<uint32_t> indexOf;
+
+    std::vector<uint32_t> dirty;  // marked positions, unsorted
+    bool reordered = false;       // nodes were added since the last update
+    uint32_t changeBegin = 0, changeEnd = 0;
+
+    // puts the nodes back into depth-first order, roots in the order they were added. every array is
+    // permuted the same way
+    void reorder() {
+        const uint32_t n = uint32_t(parent.size());
+        std::vector<uint32_t> firstChild(n, NO_NODE), nextSibling(n, NO_NODE), order;
+        order.reserve(n);
+        // children in reverse so the lists come out in the order they were added
+        for (uint32_t i = n; i-- > 0;) {
+            if (parent[i] == NO_NODE)
+                continue;
+            nextSibling[i] = firstChild[parent[i]];
+            firstChild[parent[i]] = i;
+        }
+        std::vector<uint32_t> stack;
+        for (uint32_t root = 0; root < n; ++root) {
+            if (parent[root] != NO_NODE)
+                continue;
+            stack.push_back(root);
+            while (!stack.empty()) {
+                uint32_t node = stack.back();
+                stack.pop_back();
+                order.push_back(node);
+                // pushed backwards so the first child is visited first
+                size_t firstPushed = stack.size();
+                for (uint32_t child = firstChild[node]; child != NO_NODE; child = nextSibling[child])
+                    stack.push_back(child);
+                std::reverse(stack.begin() + firstPushed, stack.end());
+            }
+        }
+        std::vector<uint32_t> newIndex(n);
+        for (uint32_t i = 0; i < n; ++i)
+            newIndex[order[i]] = i;
+        auto permute = [&](auto &values) {
+            auto old = values;
+            for (uint32_t i = 0; i < n; ++i)
+                values[i] = old[order[i]];
+        };
+        permute(parent);
+        for (uint32_t &p : parent)
+            if (p != NO_NODE)
+                p = newIndex[p];
+        permute(position);
+        permute(scale);
+        permute(rotation);
+        permute(localBounds);
+        permute(idAt);
+        for (uint32_t i = 0; i < n; ++i)
+            indexOf[idAt[i]] = i;
+        // subtree sizes, children first
+        std::fill(subtreeSize.begin(), subtreeSize.end(), 1);
+        for (uint32_t i = n; i-- > 0;)
+            if (parent[i] != NO_NODE)
+                subtreeSize[parent[i]] += subtreeSize[i];
+        // everything gets recomputed after this, which is every root's subtree
+        std::fill(marked.begin(), marked.end(), 0);
+        dirty.clear();
+        for (uint32_t i = 0; i < n; i += subtreeSize[i])
+            mark(i);
+    }
+    void mark(uint32_t index) {
+        if (!marked[index]) {
+            marked[index] = 1;
+            dirty.push_back(index);
+        }
+    }
+public:
+    // the work the last update did
+    uint32_t recomputed = 0;
+
+    NodeId add(NodeId parentId, const glm::vec3 &pos, const glm::quat &rot = NO_ROTATION, const glm::vec3 &s = glm::vec3(1.f),
+               const Aabb &bounds = Aabb()) {
+        NodeId id = NodeId(indexOf.size());
+        indexOf.push_back(uint32_t(parent.size()));
+        parent.push_back(parentId == NO_NODE ? NO_NODE : indexOf[parentId]);
+        subtreeSize.push_back(1);
+        position.push_back(pos);
+        rotation.push_back(rot);
+        scale.push_back(s);
+        localBounds.push_back(bounds);
+        worldBounds.emplace_back();
+        world.emplace_back(1.f);
+        idAt.push_back(id);
+        marked.push_back(0);
+        reordered = true;
+        return id;
+    }
+    size_t size() const {
+        return parent.size();
+    }
+    void setPosition(NodeId id, const glm::vec3 &pos) {
+        uint32_t i = indexOf[id];
+        position[i] = pos;
+        mark(i);
+    }
+    void setRotation(NodeId id, const glm::quat &rot) {
+        uint32_t i = indexOf[id];
+        rotation[i] = rot;
+        mark(i);
+    }
+    void setScale(NodeId id, const glm::vec3 &s) {
+        uint32_t i = indexOf[id];
+        scale[i] = s;
+        mark(i);
+    }
+    const glm::vec3 &getPosition(NodeId id) const {
+        return position[indexOf[id]];
+    }
+    const glm::quat &getRotation(NodeId id) const {
+        return rotation[indexOf[id]];
+    }
+    // only up to date after update()
+    const glm::mat4 &worldMatrix(NodeId id) const {
+        return world[indexOf[id]];
+    }
+    const Aabb &bounds(NodeId id) const {
+        return worldBounds[indexOf[id]];
+    }
+    // all the world matrices, in the order they are stored
+    const glm::mat4 *worldMatrices() const {
+        return world.data();
+    }
+    // the range of stored positions the last update() wrote to, empty if nothing moved
+    uint32_t changedBegin() const {
+        return changeBegin;
+    }
+    uint32_t changedEnd() const {
+        return changeEnd;
+    }
+    // true when the order changed, and with it where every matrix is stored
+    bool update() {
+        bool wasReordered = reordered;
+        if (reordered) {
+            reorder();
+            reordered = false;
+        }
+        recomputed = 0;
+        changeBegin = changeEnd = 0;
+        if (dirty.empty())
+            return wasReordered;
+        // in order, so a marked node inside a subtree that was just done is skipped
+        std::sort(dirty.begin(), dirty.end());
+        changeBegin = dirty.front();
+        uint32_t doneUntil = 0;
+        for (uint32_t root : dirty) {
+            marked[root] = 0;
+            if (root < doneUntil)
+                continue;
+            const uint32_t end = root + subtreeSize[root];
+            for (uint32_t i = root; i < end; ++i) {
+                glm::mat4 local = composeTRS(position[i], rotation[i], scale[i]);
+                world[i] = parent[i] == NO_NODE ? local : world[parent[i]] * local;
+                worldBounds[i] = transformAabb(world[i], localBounds[i]);
+                marked[i] = 0;
+            }
+            recomputed += end - root;
+            doneUntil = end;
+            changeEnd = std::max(changeEnd, end);
+        }
+        dirty.clear();
+        return wasReordered;
+    }
+    // every world matrix from scratch, what update() would have to do without the marks. for comparing
+    void updateAll() {
+        for (uint32_t i = 0; i < parent.size(); ++i) {
+            glm::mat4 local = composeTRS(position[i], rotation[i], scale[i]);
+            world[i] = parent[i] == NO_NODE ? local : world[parent[i]] * local;
+            worldBounds[i] = transformAabb(world[i], localBounds[i]);
+        }
+    }
+};
+
+
+// view and projection, rebuilt only when something they come from changes
+class CachedCamera {
+    glm::vec3 position = glm::vec3(0.f), front = glm::vec3(0.f, 0.f, -1.f), up = glm::vec3(0.f, 1.f, 0.f);
+    float fovy = glm::radians(45.f), aspect = 1.f, zNear = 0.1f, zFar = 100.f;
+    glm::mat4 viewMatrix = glm::mat4(1.f), projMatrix = glm::mat4(1.f);
+    bool viewDirty = true, projDirty = true;
+public:
+    size_t viewBuilds = 0, projBuilds = 0;
+    // bumped every time an input of either matrix changes, for anything that keeps derived data like uniforms
+    // or frustum planes. it starts out changed
+    uint64_t version = 1;
+
+    void lookAlong(const glm::vec3 &pos, const glm::vec3 &dir, const glm::vec3 &upDir) {
+        if (pos == position && dir == front && upDir == up)
+            return;
+        position = pos;
+        front = dir;
+        up = upDir;
+        viewDirty = true;
+        ++version;
+    }
+    void setPerspective(float fovyRadians, float aspectRatio, float nearPlane, float farPlane) {
+        if (fovyRadians == fovy && aspectRatio == aspect && nearPlane == zNear && farPlane == zFar)
+            return;
+        fovy = fovyRadians;
+        aspect = aspectRatio;
+        zNear = nearPlane;
+        zFar = farPlane;
+        projDirty = true;
+        ++version;
+    }
+    const glm::mat4 &view() {
+        if (viewDirty) {
+            viewMatrix = glm::lookAt(position, position + front, up);
+            viewDirty = false;
+            ++viewBuilds;
+        }
+        return viewMatrix;
+    }
+    const glm::mat4 &proj() {
+        if (projDirty) {
+            projMatrix = glm::perspective(fovy, aspect, zNear, zFar);
+            projDirty = false;
+            ++projBuilds;
+        }
+        return projMatrix;
+    }
+};
+
+
+// ---------------------------------------------------------------------------------------------------------
+// the scene: systems of a sun, planets around it and moons around the planets. a few of the systems turn,
+// the rest stand still
+// ---------------------------------------------------------------------------------------------------------
+
+struct SolarSystems {
+    std::vector<NodeId> suns, planets;
+    int planetsPerSun = 10, moonsPerPlanet = 99;
+};
+
+SolarSystems buildSystems(TransformHierarchy &scene, int nodes) {
+    SolarSystems systems;
+    const int perSystem = 1 + systems.planetsPerSun * (1 + systems.moonsPerPlanet);
+    const int count = std::max(1, nodes / perSystem);
+    const int side = int(std::ceil(std::sqrt(float(count))));
+    const Aabb unitCube = {glm::vec3(-0.5f), glm::vec3(0.5f)};
+    for (int s = 0; s < count; ++s) {
+        glm::vec3 at((s % side - side / 2) * 12.f, 0.f, -(s / side) * 12.f - 10.f);
+        NodeId sun = scene.add(NO_NODE, at, NO_ROTATION, glm::vec3(1.f), unitCube);
+        systems.suns.push_back(sun);
+        for (int p = 0; p < systems.planetsPerSun; ++p) {
+            float angle = p * 2.f * glm::pi<float>() / systems.planetsPerSun;
+            glm::vec3 orbit(std::cos(angle) * (2.f + p * 0.4f), 0.f, std::sin(angle) * (2.f + p * 0.4f));
+            NodeId planet = scene.add(sun, orbit, glm::angleAxis(angle, glm::vec3(0.f, 1.f, 0.f)), glm::vec3(0.4f), unitCube);
+            systems.planets.push_back(planet);
+            for (int m = 0; m < systems.moonsPerPlanet; ++m) {
+                float a = m * 2.f * glm::pi<float>() / systems.moonsPerPlanet;
+                glm::vec3 moon(std::cos(a) * 1.5f, std::sin(a * 3.f) * 0.3f, std::sin(a) * 1.5f);
+                scene.add(planet, moon, NO_ROTATION, glm::vec3(0.15f), unitCube);
+            }
+        }
+    }
+    return systems;
+}
+
+// the first few suns spin and their first planet too
+void animateSystems(TransformHierarchy &scene, const SolarSystems &systems, int moving, float time) {
+    for (int s = 0; s < moving && s < int(systems.suns.size()); ++s) {
+        scene.setRotation(systems.suns[s], glm::angleAxis(time * 0.3f + s, glm::vec3(0.f, 1.f, 0.f)));
+        scene.setRotation(systems.planets[s * systems.planetsPerSun], glm::angleAxis(time * 2.f, glm::vec3(0.f, 1.f, 0.f)));
+    }
+}
+
+
+// --bench: update cost of the hierarchy by how much of it changed, against recomputing everything, and a
+// check that the two agree
+template <typename Run>
+double averageMs(int repeats, Run run) {
+    auto start = std::chrono::steady_clock::now();
+    for (int r = 0; r < repeats; ++r)
+        run(r);
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count() / repeats;
+}
+
+int runBench(int nodes) {
+    TransformHierarchy scene;
+    SolarSystems systems = buildSystems(scene, nodes);
+    scene.update();
+    std::printf("%zu nodes, %zu systems of %d\n", scene.size(), systems.suns.size(), 1 + systems.planetsPerSun * (1 + systems.moonsPerPlanet));
+
+    const int repeats = 200;
+    double ms = averageMs(repeats, [&](int) { scene.update(); });
+    std::printf("nothing moved          %9.4f ms  %7u nodes recomputed\n", ms, scene.recomputed);
+    NodeId leaf = NodeId(scene.size() - 1);
+    ms = averageMs(repeats, [&](int r) {
+        scene.setPosition(leaf, glm::vec3(r * 0.001f, 0.f, 0.f));
+        scene.update();
+    });
+    std::printf("one moon               %9.4f ms  %7u nodes recomputed\n", ms, scene.recomputed);
+    ms = averageMs(repeats, [&](int r) {
+        animateSystems(scene, systems, 10, r * 0.016f);
+        scene.update();
+    });
+    std::printf("10 systems turning     %9.4f ms  %7u nodes recomputed\n", ms, scene.recomputed);
+    ms = averageMs(repeats / 10, [&](int r) {
+        for (NodeId sun : systems.suns)
+            scene.setRotation(sun, glm::angleAxis(r * 0.01f, glm::vec3(0.f, 1.f, 0.f)));
+        scene.update();
+    });
+    std::printf("every system turning   %9.4f ms  %7u nodes recomputed\n", ms, scene.recomputed);
+    ms = averageMs(repeats / 10, [&](int) { scene.updateAll(); });
+    std::printf("recompute everything   %9.4f ms  %7zu nodes recomputed\n", ms, scene.size());
+
+    // random changes all over, then the lazy result has to be what a full recompute gives
+    std::mt19937 rng(7);
+    std::vector<glm::mat4> lazy(scene.size());
+    size_t wrong = 0;
+    for (int round = 0; round < 20; ++round) {
+        for (int i = 0; i < 50; ++i) {
+            NodeId id = NodeId(rng() % scene.size());
+            if (rng() % 2)
+                scene.setPosition(id, scene.getPosition(id) + glm::vec3(0.01f, 0.f, 0.f));
+            else
+                scene.setRotation(id, glm::angleAxis(float(rng() % 628) / 100.f, glm::vec3(0.f, 1.f, 0.f)));
+        }
+        scene.update();
+        std::copy(scene.worldMatrices(), scene.worldMatrices() + scene.size(), lazy.begin());
+        scene.updateAll();
+        for (size_t i = 0; i < scene.size(); ++i)
+            wrong += lazy[i] != scene.worldMatrices()[i];
+    }
+    std::printf("lazy against full recompute after random edits: %s\n", wrong ? "DIFFERENT" : "identical");
+
+    CachedCamera camera;
+    camera.setPerspective(glm::radians(45.f), 4.f / 3.f, 0.1f, 100.f);
+    for (int frame = 0; frame < 1000; ++frame) {
+        camera.lookAlong(glm::vec3(0.f, 0.f, frame < 500 ? 3.f : 3.f + (frame % 10) * 0.1f), glm::vec3(0.f, 0.f, -1.f), glm::vec3(0.f, 1.f, 0.f));
+        camera.view();
+        camera.proj();
+    }
+    std::printf("camera over 1000 frames, still for 500: %zu view and %zu projection builds\n", camera.viewBuilds, camera.projBuilds);
+    return wrong ? EXIT_FAILURE : EXIT_SUCCESS;
+}
+
+
+void processInput(GLFWwindow *window, glm::vec3 &cameraPos, glm::vec3 &cameraFront, glm::vec3 &cameraUp)
+{
+
+    const float cameraSpeed = 0.05f; // adjust accordingly
+    if (glfwGetKey(window, GLFW_KEY_W) == GLFW_PRESS)
+        cameraPos += cameraSpeed * cameraFront;
+    if (glfwGetKey(window, GLFW_KEY_S) == GLFW_PRESS)
+        cameraPos -= cameraSpeed * cameraFront;
+    if (glfwGetKey(window, GLFW_KEY_A) == GLFW_PRESS)
+        cameraPos -= glm::normalize(glm::cross(cameraFront, cameraUp)) * cameraSpeed;
+    if (glfwGetKey(window, GLFW_KEY_D) == GLFW_PRESS)
+        cameraPos += glm::normalize(glm::cross(cameraFront, cameraUp)) * cameraSpeed;
+    if (glfwGetKey(window, GLFW_KEY_UP) == GLFW_PRESS)
+        cameraPos += glm::normalize(glm::cross(cameraFront, cameraUp)) * cameraSpeed;
+
+}
+
+// true only on the frame the key went down
+bool keyPressed(GLFWwindow *window, int key) {
+    static bool down[GLFW_KEY_LAST + 1] = {};
+    bool now = glfwGetKey(window, key) == GLFW_PRESS;
+    bool pressed = now && !down[key];
+    down[key] = now;
+    return pressed;
+}
+
+
+float yaw = -90.f;
+float pitch = 0.f;
+glm::vec3 cameraFront;
+
+void mouseMovement(GLFWwindow *window, double xPos, double yPos) {
+    static float lastX = xPos, lastY = yPos;
+    float xOffset = xPos - lastX;
+    float yOffset = lastY - yPos;
+    
+    constexpr float sensitivity = 0.05f;
+    xOffset *= sensitivity;
+    yOffset *= sensitivity;
+
+    yaw += xOffset;
+    pitch += yOffset;
+
+    if (std::abs(pitch) > 89.f) // don't ever do it this way. I am lazy
+        pitch = std::abs(pitch) / pitch * 89.f;
+
+    cameraFront.x = cos(glm::radians(yaw)) * cos(glm::radians(pitch));
+    cameraFront.y = sin(glm::radians(pitch));
+    cameraFront.z = sin(glm::radians(yaw)) * cos(glm::radians(pitch));
+
+    cameraFront = glm::normalize(cameraFront);
+    lastX = xPos, lastY = yPos;
+}
+
+
+int main(int argc, char **argv) {
+    int nodes = 100000;
+    for (int i = 1; i < argc; ++i) {
+        if (!std::strcmp(argv[i], "--bench"))
+            return runBench(i + 1 < argc ? std::atoi(argv[i + 1]) : nodes);
+        if (!std::strcmp(argv[i], "--nodes") && i + 1 < argc)
+            nodes = std::max(1, std::atoi(argv[++i]));
+    }
+
+    if (glfwInit() != GLFW_TRUE) {
+        glfwTerminate();
+        std::cerr << "Failed to initialize GLFW";
+        return EXIT_FAILURE;
+    }
+    // setting OpenGL version to 3.3
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+    GLFWwindow *win = glfwCreateWindow(800, 600, "This is a hello window!", NULL, NULL);
+    // setting 'context' for OpenGL, i.e. where to draw on current thread
+    glfwMakeContextCurrent(win);
+    // all it does is fetches us the implemented functions of OpenGL
+    if (glewInit() != GLEW_OK) {
+        glfwTerminate();
+        std::cerr << "Failed to initialize GLEW\n";
+        return EXIT_FAILURE;
+    }
+    int screenWidth, screenHeight;
+    glfwGetFramebufferSize(win, &screenWidth, &screenHeight);
+    glViewport(0, 0, screenWidth, screenHeight);
+
+    glEnable(GL_DEPTH_TEST);
+    float triangle_data[] = {
+        //   vertpos   //  //   normal   //  //texcord//
+    -0.5f, -0.5f, -0.5f,  0.0f,  0.0f, -1.0f,  0.0f, 0.0f,
+     0.5f, -0.5f, -0.5f,  0.0f,  0.0f, -1.0f,  1.0f, 0.0f,
+     0.5f,  0.5f, -0.5f,  0.0f,  0.0f, -1.0f,  1.0f, 1.0f,
+     0.5f,  0.5f, -0.5f,  0.0f,  0.0f, -1.0f,  1.0f, 1.0f,
+    -0.5f,  0.5f, -0.5f,  0.0f,  0.0f, -1.0f,  0.0f, 1.0f,
+    -0.5f, -0.5f, -0.5f,  0.0f,  0.0f, -1.0f,  0.0f, 0.0f,
+
+    -0.5f, -0.5f,  0.5f,  0.0f,  0.0f,  1.0f,  0.0f, 0.0f,
+     0.5f, -0.5f,  0.5f,  0.0f,  0.0f,  1.0f,  1.0f, 0.0f,
+     0.5f,  0.5f,  0.5f,  0.0f,  0.0f,  1.0f,  1.0f, 1.0f,
+     0.5f,  0.5f,  0.5f,  0.0f,  0.0f,  1.0f,  1.0f, 1.0f,
+    -0.5f,  0.5f,  0.5f,  0.0f,  0.0f,  1.0f,  0.0f, 1.0f,
+    -0.5f, -0.5f,  0.5f,  0.0f,  0.0f,  1.0f,  0.0f, 0.0f,
+
+    -0.5f,  0.5f,  0.5f, -1.0f,  0.0f,  0.0f,  1.0f, 0.0f,
+    -0.5f,  0.5f, -0.5f, -1.0f,  0.0f,  0.0f,  1.0f, 1.0f,
+    -0.5f, -0.5f, -0.5f, -1.0f,  0.0f,  0.0f,  0.0f, 1.0f,
+    -0.5f, -0.5f, -0.5f, -1.0f,  0.0f,  0.0f,  0.0f, 1.0f,
+    -0.5f, -0.5f,  0.5f, -1.0f,  0.0f,  0.0f,  0.0f, 0.0f,
+    -0.5f,  0.5f,  0.5f, -1.0f,  0.0f,  0.0f,  1.0f, 0.0f,
+
+     0.5f,  0.5f,  0.5f,  1.0f,  0.0f,  0.0f,  1.0f, 0.0f,
+     0.5f,  0.5f, -0.5f,  1.0f,  0.0f,  0.0f,  1.0f, 1.0f,
+     0.5f, -0.5f, -0.5f,  1.0f,  0.0f,  0.0f,  0.0f, 1.0f,
+     0.5f, -0.5f, -0.5f,  1.0f,  0.0f,  0.0f,  0.0f, 1.0f,
+     0.5f, -0.5f,  0.5f,  1.0f,  0.0f,  0.0f,  0.0f, 0.0f,
+     0.5f,  0.5f,  0.5f,  1.0f,  0.0f,  0.0f,  1.0f, 0.0f,
+
+    -0.5f, -0.5f, -0.5f,  0.0f, -1.0f,  0.0f,  0.0f, 1.0f,
+     0.5f, -0.5f, -0.5f,  0.0f, -1.0f,  0.0f,  1.0f, 1.0f,
+     0.5f, -0.5f,  0.5f,  0.0f, -1.0f,  0.0f,  1.0f, 0.0f,
+     0.5f, -0.5f,  0.5f,  0.0f, -1.0f,  0.0f,  1.0f, 0.0f,
+    -0.5f, -0.5f,  0.5f,  0.0f, -1.0f,  0.0f,  0.0f, 0.0f,
+    -0.5f, -0.5f, -0.5f,  0.0f, -1.0f,  0.0f,  0.0f, 1.0f,
+
+    -0.5f,  0.5f, -0.5f,  0.0f,  1.0f,  0.0f,  0.0f, 1.0f,
+     0.5f,  0.5f, -0.5f,  0.0f,  1.0f,  0.0f,  1.0f, 1.0f,
+     0.5f,  0.5f,  0.5f,  0.0f,  1.0f,  0.0f,  1.0f, 0.0f,
+     0.5f,  0.5f,  0.5f,  0.0f,  1.0f,  0.0f,  1.0f, 0.0f,
+    -0.5f,  0.5f,  0.5f,  0.0f,  1.0f,  0.0f,  0.0f, 0.0f,
+    -0.5f,  0.5f, -0.5f,  0.0f,  1.0f,  0.0f,  0.0f, 1.0f
+        
+    };
+
+
+    glm::vec3 cameraPos(0.f, 0.f, 3.f);
+    cameraFront = glm::vec3(0.f,0.f,-1.f);
+    glm::vec3 cameraUp(0.,1.,0.f);
+    
+
+    Texture2D tex;
+    tex.generate2DTex("./image2d.tex");
+    tex.bind();
+
+    TransformHierarchy scene;
+    SolarSystems systems = buildSystems(scene, nodes);
+    scene.update();
+    std::cout << scene.size() << " nodes\n";
+
+    GLuint vbo = 0;
+    glGenBuffers(1, &vbo); 
+    glBindBuffer(GL_ARRAY_BUFFER, vbo);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(triangle_data), triangle_data, GL_STATIC_DRAW);
+
+    GLuint vao = 0;
+    glGenVertexArrays(1, &vao);
+    glBindVertexArray(vao);
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)0);
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)(6 * sizeof(float)));
+    glEnableVertexAttribArray(1);
+    glVertexAttribPointer(2, 3, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)(3 * sizeof(float)));
+    glEnableVertexAttribArray(2);
+
+    // the world matrices, in hierarchy order, one per cube instance. only the range update() touched is
+    // sent again each frame
+    GLuint instanceVbo = 0;
+    glGenBuffers(1, &instanceVbo);
+    glBindBuffer(GL_ARRAY_BUFFER, instanceVbo);
+    glBufferData(GL_ARRAY_BUFFER, scene.size() * sizeof(glm::mat4), scene.worldMatrices(), GL_DYNAMIC_DRAW);
+    for (int column = 0; column < 4; ++column) {
+        glVertexAttribPointer(3 + column, 4, GL_FLOAT, GL_FALSE, sizeof(glm::mat4), (void*)(column * sizeof(glm::vec4)));
+        glEnableVertexAttribArray(3 + column);
+        glVertexAttribDivisor(3 + column, 1);
+    }
+
+    VertexShader vs;
+    FragmentShader fs;
+    vs.setSource("./vertex.glsl");
+    fs.setSource("./frag.glsl");
+    Program prog;
+    prog.AttachShaders({&vs, &fs});
+
+    prog.UseProgram();
+    prog.setInt("tex", 0);
+
+    CachedCamera camera;
+    uint64_t cameraVersion = 0;
+
+    glfwSetCursorPosCallback(win, mouseMovement); 
+    glfwSetInputMode(win, GLFW_CURSOR, GLFW_CURSOR_DISABLED);  
+
+    std::cout << "T: turn every system instead of 10\n";
+    bool turnAll = false;
+    double lastReport = glfwGetTime(), updateMs = 0.;
+    size_t frames = 0, recomputed = 0, uploaded = 0;
+    
+    while (!glfwWindowShouldClose(win)) {
+        processInput(win, cameraPos, cameraFront, cameraUp);
+        camera.lookAlong(cameraPos, cameraFront, cameraUp);
+        glfwGetFramebufferSize(win, &screenWidth, &screenHeight);
+        if (screenWidth > 0 && screenHeight > 0)
+            camera.setPerspective(glm::radians(45.f), float(screenWidth) / screenHeight, 0.1f, 500.f);
+
+        if (keyPressed(win, GLFW_KEY_T))
+            turnAll = !turnAll;
+        animateSystems(scene, systems, turnAll ? int(systems.suns.size()) : 10, float(glfwGetTime()));
+        auto start = std::chrono::steady_clock::now();
+        bool reordered = scene.update();
+        updateMs += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        recomputed += scene.recomputed;
+
+        glBindBuffer(GL_ARRAY_BUFFER, instanceVbo);
+        uint32_t begin = reordered ? 0 : scene.changedBegin(), end = reordered ? uint32_t(scene.size()) : scene.changedEnd();
+        if (end > begin) {
+            glBufferSubData(GL_ARRAY_BUFFER, begin * sizeof(glm::mat4), (end - begin) * sizeof(glm::mat4), scene.worldMatrices() + begin);
+            uploaded += end - begin;
+        }
+
+        prog.UseProgram();
+        // the uniforms keep their values between frames, so they're only set when the camera changed
+        if (camera.version != cameraVersion) {
+            prog.setMat4("view", camera.view());
+            prog.setMat4("proj", camera.proj());
+            cameraVersion = camera.version;
+        }
+        glViewport(0, 0, screenWidth, screenHeight);
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+        glBindVertexArray(vao);
+        tex.bind();
+        glDrawArraysInstanced(GL_TRIANGLES, 0, 36, GLsizei(scene.size()));
+
+        // polls different kinds of events, for example, when we close an application, it fetches that event
+        // or it fetches events like movement of the window.
+        // Without it you can neither move the window or close the window
+        glfwPollEvents();
+        // have you drawn the image, it is stored in the buffer. You can now swap this buffer with main buffer
+        // so the image appears
+        glfwSwapBuffers(win);
+
+        ++frames;
+        if (glfwGetTime() - lastReport > 1.) {
+            lastReport = glfwGetTime();
+            std::cout << "transforms: " << updateMs / frames << "ms a frame, " << recomputed / frames << " of " << scene.size()
+                      << " nodes recomputed and " << uploaded / frames << " matrices uploaded a frame, "
+                      << camera.viewBuilds << " view matrix builds so far\n";
+            frames = recomputed = uploaded = 0;
+            updateMs = 0.;
+        }
+    }
+    glDeleteBuffers(1, &instanceVbo);
+    glfwTerminate();
+    
+    std::cout << "Window should close now!\n";
+
+    return EXIT_SUCCESS;
+
+}
@@ -0,0 +1,17 @@
+#version 330 core
+
+layout(location = 0) in vec3 aPos;
+layout(location = 1) in vec2 aTexCoord;
+// a world matrix per instance, straight out of the hierarchy
+layout(location = 3) in mat4 aModel;
+
+out vec2 texCoord;
+
+uniform mat4 proj;
+uniform mat4 view;
+
+
+void main() {
+    gl_Position = proj * view * aModel * vec4(aPos, 1.0);
+    texCoord = aTexCoord;
+}
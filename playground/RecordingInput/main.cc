@@ -0,0 +1,599 @@
+#include <GL/glew.h>
+
+#include <GLFW/glfw3.h>
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <glm/ext/matrix_clip_space.hpp>
+#include <glm/ext/matrix_transform.hpp>
+#include <glm/geometric.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/ext/matrix_float4x4.hpp>
+#include <glm/gtc/type_ptr.hpp>
+#include <glm/glm.hpp>
+#include <glm/trigonometric.hpp>
+#define STB_IMAGE_IMPLEMENTATION
+#include <stb/stb_image.h>
+#include <iostream>
+#include <vector>
+
+class Shader {
+    std::string src; 
+protected:
+    const char *getsrc() {
+        return src.data();
+    }
+    GLuint shader_id = 0;
+    bool isCompiled = false;
+protected:
+    virtual const char *getClassName() = 0;
+    GLint getCompilationStatus(GLuint shader_id) {
+        int status;
+        glGetShaderiv(shader_id, GL_COMPILE_STATUS, &status);
+        return status;
+    }
+    void sendError() {
+        char buffer[1024];
+        glGetShaderInfoLog(shader_id, 1024, NULL, buffer);
+        std::cerr << "ERROR::" << getClassName() << " - " << buffer;
+    }
+public:
+    virtual void compile() = 0;
+    void setSource(const char *s) {
+        std::ifstream sourceFile(s);
+        if (!sourceFile.is_open())
+            return;
+        char buffer[8192];
+        while (sourceFile.read(buffer, 8192)) {
+            src.append(buffer, 8192);
+        }
+        if (!sourceFile.eof()) {
+            src.clear();
+            return;
+        }
+        src.append(buffer, sourceFile.gcount());
+    }
+    friend class Program;
+};
+
+
+class VertexShader : public Shader {
+    virtual const char *getClassName() override {
+        return "VertexShader";
+    }
+public:
+    virtual void compile() override {
+        if (shader_id)
+            glDeleteShader(shader_id);
+        shader_id = glCreateShader(GL_VERTEX_SHADER);
+        const char *src = getsrc();
+        glShaderSource(shader_id, 1, &src, NULL);
+        glCompileShader(shader_id);
+        if (!getCompilationStatus(shader_id)) {
+            sendError();
+        }
+        isCompiled = true;
+    }
+};
+
+class FragmentShader : public Shader {
+    const char *getClassName() override {
+        return "FragmentShader";
+    }
+public:
+    virtual void compile() override {
+        if (shader_id)
+            glDeleteShader(shader_id);
+        shader_id = glCreateShader(GL_FRAGMENT_SHADER);
+        const char *src = getsrc();
+        glShaderSource(shader_id, 1, &src, NULL);
+        glCompileShader(shader_id);
+        if (!getCompilationStatus(shader_id)) {
+            sendError();
+        }
+        isCompiled = true;
+    }
+};
+
+
+class Program {
+    GLuint program_id = 0;
+    void sendError() {
+        char buffer[1024];
+        glGetProgramInfoLog(program_id, 1024, NULL, buffer);
+        std::cerr << "ERROR::PROGRAM: " << " - " << buffer;
+    }
+    bool linkStatus() {
+        int status = 0;
+        glGetProgramiv(program_id, GL_LINK_STATUS, &status);
+        return status;
+    }
+public:
+    Program() {
+        program_id = glCreateProgram();
+    }
+    ~Program() {
+        glDeleteProgram(program_id);
+    }
+    void AttachShaders(std::initializer_list<Shader*> shaders) {
+        auto i = shaders.begin();
+        while (i != shaders.end()) {
+            if (!(*i)->isCompiled)
+                (*i)->compile();
+            glAttachShader(program_id, (*i)->shader_id);
+            ++i;
+        }
+        glLinkProgram(program_id);
+        if (!linkStatus()) {
+            sendError();
+        }
+    }
+    void UseProgram() {
+        glUseProgram(program_id);
+    }
+    void setMat4(const char *locName, const glm::mat4 &mat) {
+        int location = glGetUniformLocation(program_id, locName);
+        if (location == -1)
+            return;
+        glUniformMatrix4fv(location, 1, GL_FALSE, glm::value_ptr(mat));
+    }
+};
+
+
+class Texture2D {
+    GLuint tex_id;
+public:
+    void generate2DTex(const char *image_path) {
+        int width, height, nChannels;
+        stbi_set_flip_vertically_on_load(true);
+        uint8_t *raw_image = stbi_load(image_path, &width, &height, &nChannels, 0);
+        float borderColor[] = {1.f, 1.f, 1.f, 1.f};
+        glGenTextures(1, &tex_id);
+        glBindTexture(GL_TEXTURE_2D, tex_id);
+        // what to do when primitive is bigger than the texture
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_BORDER);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_BORDER);
+        glTexParameterfv(GL_TEXTURE_2D, GL_TEXTURE_BORDER_COLOR, borderColor);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        // glTexImage2D(TARGET_TYPE, IM_MIPMAP_LEVEL, TARGET_NRCHANNELS, SRC_WIDTH, SRC_HEIGHT, LEGACY_0, SRC_NRCHANNELS, SRC_DATA_TYPE, SRC_DATA);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, width, height, 0, GL_RGB, GL_UNSIGNED_BYTE, raw_image);
+        stbi_image_free(raw_image);
+    }
+    void bind() {
+        glBindTexture(GL_TEXTURE_2D, tex_id);
+    }
+};
+
+// everything the simulation needs from the keyboard and the mouse in one tick.
+// live mode fills it from GLFW, replay mode fills it from a recording
+struct InputState {
+    enum : uint8_t {
+        KEY_W = 1 << 0,
+        KEY_S = 1 << 1,
+        KEY_A = 1 << 2,
+        KEY_D = 1 << 3,
+        KEY_UP = 1 << 4,
+    };
+    uint8_t keys = 0;
+    float mouseDx = 0.f;
+    float mouseDy = 0.f;
+};
+
+struct CameraState {
+    glm::vec3 pos;
+    glm::vec3 front;
+    glm::vec3 up;
+    float yaw = -90.f;
+    float pitch = 0.f;
+};
+
+// FNV-1a over the raw bits of the camera, so even 1 ulp of drift shows up
+uint32_t cameraChecksum(const CameraState &cam) {
+    const float values[] = {
+        cam.pos.x, cam.pos.y, cam.pos.z,
+        cam.front.x, cam.front.y, cam.front.z,
+        cam.yaw, cam.pitch
+    };
+    uint32_t hash = 2166136261u;
+    const uint8_t *bytes = reinterpret_cast<const uint8_t*>(values);
+    for (size_t i = 0; i < sizeof(values); ++i) {
+        hash ^= bytes[i];
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+// the simulation runs at a fixed rate so the same input always gives the same camera
+constexpr uint32_t TICK_RATE = 60;
+constexpr float TICK_DT = 1.f / TICK_RATE;
+
+void processInput(const InputState &input, CameraState &cam)
+{
+    // mouse first, so WASD moves along the direction we are looking at this tick
+    constexpr float sensitivity = 0.05f;
+    cam.yaw += input.mouseDx * sensitivity;
+    cam.pitch += input.mouseDy * sensitivity;
+
+    if (std::abs(cam.pitch) > 89.f) // don't ever do it this way. I am lazy
+        cam.pitch = std::abs(cam.pitch) / cam.pitch * 89.f;
+
+    cam.front.x = cos(glm::radians(cam.yaw)) * cos(glm::radians(cam.pitch));
+    cam.front.y = sin(glm::radians(cam.pitch));
+    cam.front.z = sin(glm::radians(cam.yaw)) * cos(glm::radians(cam.pitch));
+    cam.front = glm::normalize(cam.front);
+
+    const float cameraSpeed = 3.f * TICK_DT; // same 0.05 per step as before, now per tick
+    if (input.keys & InputState::KEY_W)
+        cam.pos += cameraSpeed * cam.front;
+    if (input.keys & InputState::KEY_S)
+        cam.pos -= cameraSpeed * cam.front;
+    if (input.keys & InputState::KEY_A)
+        cam.pos -= glm::normalize(glm::cross(cam.front, cam.up)) * cameraSpeed;
+    if (input.keys & InputState::KEY_D)
+        cam.pos += glm::normalize(glm::cross(cam.front, cam.up)) * cameraSpeed;
+    if (input.keys & InputState::KEY_UP)
+        cam.pos += glm::normalize(glm::cross(cam.front, cam.up)) * cameraSpeed;
+}
+
+
+// the cursor callback only accumulates deltas, they get consumed once per tick
+float pendingDx = 0.f;
+float pendingDy = 0.f;
+
+void mouseMovement(GLFWwindow *window, double xPos, double yPos) {
+    static float lastX = xPos, lastY = yPos;
+    pendingDx += xPos - lastX;
+    pendingDy += lastY - yPos;
+    lastX = xPos, lastY = yPos;
+}
+
+InputState pollInput(GLFWwindow *window) {
+    InputState input;
+    if (glfwGetKey(window, GLFW_KEY_W) == GLFW_PRESS)
+        input.keys |= InputState::KEY_W;
+    if (glfwGetKey(window, GLFW_KEY_S) == GLFW_PRESS)
+        input.keys |= InputState::KEY_S;
+    if (glfwGetKey(window, GLFW_KEY_A) == GLFW_PRESS)
+        input.keys |= InputState::KEY_A;
+    if (glfwGetKey(window, GLFW_KEY_D) == GLFW_PRESS)
+        input.keys |= InputState::KEY_D;
+    if (glfwGetKey(window, GLFW_KEY_UP) == GLFW_PRESS)
+        input.keys |= InputState::KEY_UP;
+    input.mouseDx = pendingDx;
+    input.mouseDy = pendingDy;
+    pendingDx = pendingDy = 0.f;
+    return input;
+}
+
+
+// on-disk layout of a recording:
+//   InputRecordHeader
+//   InputRecordTick * tickCount
+// everything is little endian, which is whatever we run on anyway
+struct InputRecordHeader {
+    char magic[4] = {'A', 'G', 'I', 'R'};
+    uint32_t version = 1;
+    uint32_t tickRate = TICK_RATE;
+    uint32_t tickCount = 0;
+};
+
+struct InputRecordTick {
+    uint32_t timestampUs; // wall clock since the recording started, just for reference
+    uint8_t keys;
+    uint8_t pad[3];
+    float mouseDx;
+    float mouseDy;
+    uint32_t cameraHash;  // checksum of the camera *after* this tick was applied
+};
+static_assert(sizeof(InputRecordTick) == 20, "recording format changed");
+
+class InputRecorder {
+    std::ofstream file;
+    InputRecordHeader header;
+public:
+    bool open(const char *path) {
+        file.open(path, std::ios::binary | std::ios::trunc);
+        if (!file.is_open())
+            return false;
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        return true;
+    }
+    void write(uint32_t timestampUs, const InputState &input, uint32_t cameraHash) {
+        InputRecordTick tick = {};
+        tick.timestampUs = timestampUs;
+        tick.keys = input.keys;
+        tick.mouseDx = input.mouseDx;
+        tick.mouseDy = input.mouseDy;
+        tick.cameraHash = cameraHash;
+        file.write(reinterpret_cast<const char*>(&tick), sizeof(tick));
+        ++header.tickCount;
+    }
+    ~InputRecorder() {
+        if (!file.is_open())
+            return;
+        // now that we know how many ticks there are, patch the header
+        file.seekp(0);
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    }
+};
+
+class InputPlayer {
+    std::vector<InputRecordTick> ticks;
+    size_t cursor = 0;
+    uint32_t firstDivergence = UINT32_MAX;
+    uint32_t divergentTicks = 0;
+public:
+    bool open(const char *path) {
+        std::ifstream file(path, std::ios::binary);
+        if (!file.is_open())
+            return false;
+        InputRecordHeader header, expected;
+        if (!file.read(reinterpret_cast<char*>(&header), sizeof(header)))
+            return false;
+        if (std::memcmp(header.magic, expected.magic, 4) || header.version != expected.version) {
+            std::cerr << "ERROR::REPLAY - " << path << " is not a recording we understand\n";
+            return false;
+        }
+        if (header.tickRate != TICK_RATE) {
+            std::cerr << "ERROR::REPLAY - recorded at " << header.tickRate << "Hz, we tick at " << TICK_RATE << "Hz\n";
+            return false;
+        }
+        ticks.resize(header.tickCount);
+        if (!file.read(reinterpret_cast<char*>(ticks.data()), ticks.size() * sizeof(InputRecordTick))) {
+            std::cerr << "ERROR::REPLAY - " << path << " is truncated\n";
+            return false;
+        }
+        return true;
+    }
+    bool finished() const {
+        return cursor >= ticks.size();
+    }
+    InputState next() {
+        const InputRecordTick &tick = ticks[cursor];
+        InputState input;
+        input.keys = tick.keys;
+        input.mouseDx = tick.mouseDx;
+        input.mouseDy = tick.mouseDy;
+        return input;
+    }
+    // call after the tick returned by next() was simulated
+    void verify(uint32_t cameraHash) {
+        if (ticks[cursor].cameraHash != cameraHash) {
+            if (firstDivergence == UINT32_MAX)
+                firstDivergence = cursor;
+            ++divergentTicks;
+        }
+        ++cursor;
+    }
+    bool report() const {
+        if (!divergentTicks) {
+            std::cout << "replay: " << ticks.size() << " ticks, camera matched on every tick\n";
+            return true;
+        }
+        std::cout << "replay: camera DIVERGED on " << divergentTicks << " of " << ticks.size()
+                  << " ticks, first at tick " << firstDivergence << "\n";
+        return false;
+    }
+};
+
+// collects per-frame times so two builds can be compared on the same flythrough
+class FrameTimeLog {
+    std::vector<float> ms;
+public:
+    void add(double seconds) {
+        ms.push_back(seconds * 1000.);
+    }
+    void report() {
+        if (ms.empty())
+            return;
+        std::vector<float> sorted = ms;
+        std::sort(sorted.begin(), sorted.end());
+        double sum = 0.;
+        for (float t : sorted)
+            sum += t;
+        std::cout << "frames: " << sorted.size()
+                  << "  avg " << sum / sorted.size() << "ms"
+                  << "  p50 " << sorted[sorted.size() / 2] << "ms"
+                  << "  p99 " << sorted[sorted.size() * 99 / 100] << "ms"
+                  << "  max " << sorted.back() << "ms\n";
+    }
+};
+
+
+
+int main(int argc, char **argv) {
+    // ./main                 - play normally
+    // ./main --record file   - play normally and write every tick of input to file
+    // ./main --replay file   - ignore the keyboard and mouse, play file back one tick per frame
+    const char *recordPath = nullptr;
+    const char *replayPath = nullptr;
+    for (int i = 1; i + 1 < argc; ++i) {
+        if (!std::strcmp(argv[i], "--record"))
+            recordPath = argv[++i];
+        else if (!std::strcmp(argv[i], "--replay"))
+            replayPath = argv[++i];
+    }
+
+    InputRecorder recorder;
+    InputPlayer player;
+    if (recordPath && !recorder.open(recordPath)) {
+        std::cerr << "Failed to open " << recordPath << " for recording\n";
+        return EXIT_FAILURE;
+    }
+    if (replayPath && !player.open(replayPath)) {
+        std::cerr << "Failed to open " << replayPath << " for replay\n";
+        return EXIT_FAILURE;
+    }
+
+    if (glfwInit() != GLFW_TRUE) {
+        glfwTerminate();
+        std::cerr << "Failed to initialize GLFW";
+        return EXIT_FAILURE;
+    }
+    // setting OpenGL version to 3.3
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+    GLFWwindow *win = glfwCreateWindow(600, 600, "This is a hello window!", NULL, NULL);
+    glViewport(0, 0, 600, 600);
+    // setting 'context' for OpenGL, i.e. where to draw on current thread
+    glfwMakeContextCurrent(win);
+    // all it does is fetches us the implemented functions of OpenGL
+    if (glewInit() != GLEW_OK) {
+        glfwTerminate();
+        std::cerr << "Failed to initialize GLEW\n";
+        return EXIT_FAILURE;
+    }
+    // when replaying we want the real cost of a frame, not the vsync interval
+    if (replayPath)
+        glfwSwapInterval(0);
+
+    glEnable(GL_DEPTH_TEST);
+    float triangle_data[] = {
+        //   vertpos   //  //texcord//
+    -0.5f, -0.5f, -0.5f,  0.0f, 0.0f,
+     0.5f, -0.5f, -0.5f,  1.0f, 0.0f,
+     0.5f,  0.5f, -0.5f,  1.0f, 1.0f,
+     0.5f,  0.5f, -0.5f,  1.0f, 1.0f,
+    -0.5f,  0.5f, -0.5f,  0.0f, 1.0f,
+    -0.5f, -0.5f, -0.5f,  0.0f, 0.0f,
+
+    -0.5f, -0.5f,  0.5f,  0.0f, 0.0f,
+     0.5f, -0.5f,  0.5f,  1.0f, 0.0f,
+     0.5f,  0.5f,  0.5f,  1.0f, 1.0f,
+     0.5f,  0.5f,  0.5f,  1.0f, 1.0f,
+    -0.5f,  0.5f,  0.5f,  0.0f, 1.0f,
+    -0.5f, -0.5f,  0.5f,  0.0f, 0.0f,
+
+    -0.5f,  0.5f,  0.5f,  1.0f, 0.0f,
+    -0.5f,  0.5f, -0.5f,  1.0f, 1.0f,
+    -0.5f, -0.5f, -0.5f,  0.0f, 1.0f,
+    -0.5f, -0.5f, -0.5f,  0.0f, 1.0f,
+    -0.5f, -0.5f,  0.5f,  0.0f, 0.0f,
+    -0.5f,  0.5f,  0.5f,  1.0f, 0.0f,
+
+     0.5f,  0.5f,  0.5f,  1.0f, 0.0f,
+     0.5f,  0.5f, -0.5f,  1.0f, 1.0f,
+     0.5f, -0.5f, -0.5f,  0.0f, 1.0f,
+     0.5f, -0.5f, -0.5f,  0.0f, 1.0f,
+     0.5f, -0.5f,  0.5f,  0.0f, 0.0f,
+     0.5f,  0.5f,  0.5f,  1.0f, 0.0f,
+
+    -0.5f, -0.5f, -0.5f,  0.0f, 1.0f,
+     0.5f, -0.5f, -0.5f,  1.0f, 1.0f,
+     0.5f, -0.5f,  0.5f,  1.0f, 0.0f,
+     0.5f, -0.5f,  0.5f,  1.0f, 0.0f,
+    -0.5f, -0.5f,  0.5f,  0.0f, 0.0f,
+    -0.5f, -0.5f, -0.5f,  0.0f, 1.0f,
+
+    -0.5f,  0.5f, -0.5f,  0.0f, 1.0f,
+     0.5f,  0.5f, -0.5f,  1.0f, 1.0f,
+     0.5f,  0.5f,  0.5f,  1.0f, 0.0f,
+     0.5f,  0.5f,  0.5f,  1.0f, 0.0f,
+    -0.5f,  0.5f,  0.5f,  0.0f, 0.0f,
+    -0.5f,  0.5f, -0.5f,  0.0f, 1.0f
+
+    };
+
+
+    CameraState cam;
+    cam.pos = glm::vec3(0.f, 0.f, 3.f);
+    cam.front = glm::vec3(0.f, 0.f, -1.f);
+    cam.up = glm::vec3(0.f, 1.f, 0.f);
+
+
+    Texture2D tex;
+    tex.generate2DTex("./image2d.tex");
+    tex.bind();
+
+    GLuint vbo = 0;
+    glGenBuffers(1, &vbo);
+    glBindBuffer(GL_ARRAY_BUFFER, vbo);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(triangle_data), triangle_data, GL_STATIC_DRAW);
+
+    GLuint vao = 0;
+    glGenVertexArrays(1, &vao);
+    glBindVertexArray(vao);
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)0);
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)(3 * sizeof(float)));
+    glEnableVertexAttribArray(1);
+
+    VertexShader vs;
+    FragmentShader fs;
+    vs.setSource("./vertex.glsl");
+    fs.setSource("./frag.glsl");
+    Program prog;
+    prog.AttachShaders({&vs, &fs});
+    prog.UseProgram();
+
+
+    glm::mat4 model(1.f);
+    model = glm::rotate(model, glm::radians(-55.f), glm::vec3(1.f, 0.f, 0.f));
+
+    glm::mat4 view;
+
+    glm::mat4 proj = glm::perspective(glm::radians(45.f), 800 / 600.f, 0.1f, 100.f);
+
+    prog.setMat4("model", model);
+    prog.setMat4("proj", proj);
+
+    if (!replayPath) {
+        glfwSetCursorPosCallback(win, mouseMovement);
+        glfwSetInputMode(win, GLFW_CURSOR, GLFW_CURSOR_DISABLED);
+    }
+
+    FrameTimeLog frameTimes;
+    const double startTime = glfwGetTime();
+    double lastFrame = startTime;
+    double accumulator = 0.;
+
+    while (!glfwWindowShouldClose(win)) {
+        const double now = glfwGetTime();
+        const double frameTime = now - lastFrame;
+        lastFrame = now;
+
+        if (replayPath) {
+            // exactly one tick per frame, so frame N of every run draws the same camera
+            if (player.finished())
+                break;
+            frameTimes.add(frameTime);
+            processInput(player.next(), cam);
+            player.verify(cameraChecksum(cam));
+        } else {
+            accumulator += frameTime;
+            while (accumulator >= TICK_DT) {
+                InputState input = pollInput(win);
+                processInput(input, cam);
+                if (recordPath)
+                    recorder.write(uint32_t((now - startTime) * 1e6), input, cameraChecksum(cam));
+                accumulator -= TICK_DT;
+            }
+        }
+        view = glm::lookAt(cam.pos, cam.front + cam.pos, cam.up);
+
+        prog.setMat4("view", view);
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+        glDrawArrays(GL_TRIANGLES, 0, 36);
+        // polls different kinds of events, for example, when we close an application, it fetches that event
+        // or it fetches events like movement of the window.
+        // Without it you can neither move the window or close the window
+        glfwPollEvents();
+        // have you drawn the image, it is stored in the buffer. You can now swap this buffer with main buffer
+        // so the image appears
+        glfwSwapBuffers(win);
+    }
+    glfwTerminate();
+
+    std::cout << "Window should close now!\n";
+
+    if (replayPath) {
+        frameTimes.report();
+        return player.report() ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+
+}
@@ -0,0 +1,18 @@
+#version 330 core
+
+layout(location = 0) in vec3 aPos;
+layout(location = 1) in vec2 aTexCoord;
+
+out vec4 color;
+out vec2 texCoord;
+
+uniform mat4 proj;
+uniform mat4 view;
+uniform mat4 model;
+
+
+void main() {
+    gl_Position = proj * view * model * vec4(aPos, 1.0);
+    color = vec4(aPos, 1.0f);
+    texCoord = aTexCoord;
+}
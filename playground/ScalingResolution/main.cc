@@ -0,0 +1,573 @@
+#include <GL/glew.h>
+
+#include <GLFW/glfw3.h>
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <glm/ext/matrix_clip_space.hpp>
+#include <glm/ext/matrix_transform.hpp>
+#include <glm/geometric.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/ext/matrix_float4x4.hpp>
+#include <glm/gtc/type_ptr.hpp>
+#include <glm/glm.hpp>
+#include <glm/trigonometric.hpp>
+#define STB_IMAGE_IMPLEMENTATION
+#include <stb/stb_image.h>
+#include <iostream>
+
+class Shader {
+    std::string src; 
+protected:
+    const char *getsrc() {
+        return src.data();
+    }
+    GLuint shader_id = 0;
+    bool isCompiled = false;
+protected:
+    virtual const char *getClassName() = 0;
+    GLint getCompilationStatus(GLuint shader_id) {
+        int status;
+        glGetShaderiv(shader_id, GL_COMPILE_STATUS, &status);
+        return status;
+    }
+    void sendError() {
+        char buffer[1024];
+        glGetShaderInfoLog(shader_id, 1024, NULL, buffer);
+        std::cerr << "ERROR::" << getClassName() << " - " << buffer;
+    }
+public:
+    virtual void compile() = 0;
+    void setSource(const char *s) {
+        std::ifstream sourceFile(s);
+        if (!sourceFile.is_open())
+            return;
+        char buffer[8192];
+        while (sourceFile.read(buffer, 8192)) {
+            src.append(buffer, 8192);
+        }
+        if (!sourceFile.eof()) {
+            src.clear();
+            return;
+        }
+        src.append(buffer, sourceFile.gcount());
+    }
+    friend class Program;
+};
+
+
+class VertexShader : public Shader {
+    virtual const char *getClassName() override {
+        return "VertexShader";
+    }
+public:
+    virtual void compile() override {
+        if (shader_id)
+            glDeleteShader(shader_id);
+        shader_id = glCreateShader(GL_VERTEX_SHADER);
+        const char *src = getsrc();
+        glShaderSource(shader_id, 1, &src, NULL);
+        glCompileShader(shader_id);
+        if (!getCompilationStatus(shader_id)) {
+            sendError();
+        }
+        isCompiled = true;
+    }
+};
+
+class FragmentShader : public Shader {
+    const char *getClassName() override {
+        return "FragmentShader";
+    }
+public:
+    virtual void compile() override {
+        if (shader_id)
+            glDeleteShader(shader_id);
+        shader_id = glCreateShader(GL_FRAGMENT_SHADER);
+        const char *src = getsrc();
+        glShaderSource(shader_id, 1, &src, NULL);
+        glCompileShader(shader_id);
+        if (!getCompilationStatus(shader_id)) {
+            sendError();
+        }
+        isCompiled = true;
+    }
+};
+
+
+class Program {
+    GLuint program_id = 0;
+    void sendError() {
+        char buffer[1024];
+        glGetProgramInfoLog(program_id, 1024, NULL, buffer);
+        std::cerr << "ERROR::PROGRAM: " << " - " << buffer;
+    }
+    bool linkStatus() {
+        int status = 0;
+        glGetProgramiv(program_id, GL_LINK_STATUS, &status);
+        return status;
+    }
+public:
+    Program() {
+        program_id = glCreateProgram();
+    }
+    ~Program() {
+        glDeleteProgram(program_id);
+    }
+    void AttachShaders(std::initializer_list<Shader*> shaders) {
+        auto i = shaders.begin();
+        while (i != shaders.end()) {
+            if (!(*i)->isCompiled)
+                (*i)->compile();
+            glAttachShader(program_id, (*i)->shader_id);
+            ++i;
+        }
+        glLinkProgram(program_id);
+        if (!linkStatus()) {
+            sendError();
+        }
+    }
+    void UseProgram() {
+        glUseProgram(program_id);
+    }
+    void setMat4(const char *locName, const glm::mat4 &mat) {
+        int location = glGetUniformLocation(program_id, locName);
+        if (location == -1)
+            return;
+        glUniformMatrix4fv(location, 1, GL_FALSE, glm::value_ptr(mat));
+    }
+};
+
+
+class Texture2D {
+    GLuint tex_id;
+public:
+    void generate2DTex(const char *image_path) {
+        int width, height, nChannels;
+        stbi_set_flip_vertically_on_load(true);
+        uint8_t *raw_image = stbi_load(image_path, &width, &height, &nChannels, 0);
+        float borderColor[] = {1.f, 1.f, 1.f, 1.f};
+        glGenTextures(1, &tex_id);
+        glBindTexture(GL_TEXTURE_2D, tex_id);
+        // what to do when primitive is bigger than the texture
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_BORDER);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_BORDER);
+        glTexParameterfv(GL_TEXTURE_2D, GL_TEXTURE_BORDER_COLOR, borderColor);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        // glTexImage2D(TARGET_TYPE, IM_MIPMAP_LEVEL, TARGET_NRCHANNELS, SRC_WIDTH, SRC_HEIGHT, LEGACY_0, SRC_NRCHANNELS, SRC_DATA_TYPE, SRC_DATA);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, width, height, 0, GL_RGB, GL_UNSIGNED_BYTE, raw_image);
+        stbi_image_free(raw_image);
+    }
+    void bind() {
+        glBindTexture(GL_TEXTURE_2D, tex_id);
+    }
+};
+
+
+// an offscreen render target: color texture + depth, optionally multisampled.
+// with samples > 1 we draw into multisampled renderbuffers and resolve() copies them into the texture
+class Framebuffer {
+    GLuint fbo_id = 0;
+    GLuint color_tex = 0;
+    GLuint depth_rbo = 0;
+    // only with msaa
+    GLuint msaa_fbo = 0;
+    GLuint msaa_color_rbo = 0;
+    GLuint msaa_depth_rbo = 0;
+    int width = 0, height = 0, samples = 1;
+
+    void release() {
+        glDeleteFramebuffers(1, &fbo_id);
+        glDeleteFramebuffers(1, &msaa_fbo);
+        glDeleteTextures(1, &color_tex);
+        GLuint rbos[] = {depth_rbo, msaa_color_rbo, msaa_depth_rbo};
+        glDeleteRenderbuffers(3, rbos);
+        fbo_id = color_tex = depth_rbo = msaa_fbo = msaa_color_rbo = msaa_depth_rbo = 0;
+    }
+    bool checkStatus(const char *what) {
+        GLenum status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
+        if (status == GL_FRAMEBUFFER_COMPLETE)
+            return true;
+        std::cerr << "ERROR::FRAMEBUFFER - " << what << " is incomplete: 0x" << std::hex << status << std::dec << "\n";
+        return false;
+    }
+public:
+    Framebuffer() = default;
+    Framebuffer(const Framebuffer&) = delete;
+    Framebuffer &operator=(const Framebuffer&) = delete;
+    ~Framebuffer() {
+        release();
+    }
+    bool create(int w, int h, int msaaSamples = 1) {
+        release();
+        width = w, height = h, samples = msaaSamples;
+
+        // don't steal the texture binding from whoever was drawing
+        GLint previousTexture = 0;
+        glGetIntegerv(GL_TEXTURE_BINDING_2D, &previousTexture);
+        glGenTextures(1, &color_tex);
+        glBindTexture(GL_TEXTURE_2D, color_tex);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, NULL);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        glBindTexture(GL_TEXTURE_2D, previousTexture);
+
+        glGenRenderbuffers(1, &depth_rbo);
+        glBindRenderbuffer(GL_RENDERBUFFER, depth_rbo);
+        glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, width, height);
+
+        glGenFramebuffers(1, &fbo_id);
+        glBindFramebuffer(GL_FRAMEBUFFER, fbo_id);
+        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, color_tex, 0);
+        glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, depth_rbo);
+        bool ok = checkStatus("render target");
+
+        if (samples > 1) {
+            glGenRenderbuffers(1, &msaa_color_rbo);
+            glBindRenderbuffer(GL_RENDERBUFFER, msaa_color_rbo);
+            glRenderbufferStorageMultisample(GL_RENDERBUFFER, samples, GL_RGBA8, width, height);
+            glGenRenderbuffers(1, &msaa_depth_rbo);
+            glBindRenderbuffer(GL_RENDERBUFFER, msaa_depth_rbo);
+            glRenderbufferStorageMultisample(GL_RENDERBUFFER, samples, GL_DEPTH24_STENCIL8, width, height);
+
+            glGenFramebuffers(1, &msaa_fbo);
+            glBindFramebuffer(GL_FRAMEBUFFER, msaa_fbo);
+            glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, msaa_color_rbo);
+            glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, msaa_depth_rbo);
+            ok = checkStatus("msaa render target") && ok;
+        }
+        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+        return ok;
+    }
+    void resize(int w, int h) {
+        if (w != width || h != height)
+            create(w, h, samples);
+    }
+    // draws go here until someone binds another framebuffer
+    void bind() {
+        glBindFramebuffer(GL_FRAMEBUFFER, samples > 1 ? msaa_fbo : fbo_id);
+    }
+    // msaa samples -> texture, only the part we actually drew into
+    void resolve(int w, int h) {
+        if (samples <= 1)
+            return;
+        glBindFramebuffer(GL_READ_FRAMEBUFFER, msaa_fbo);
+        glBindFramebuffer(GL_DRAW_FRAMEBUFFER, fbo_id);
+        glBlitFramebuffer(0, 0, w, h, 0, 0, w, h, GL_COLOR_BUFFER_BIT, GL_NEAREST);
+    }
+    // stretches the (w, h) corner of the color texture over the whole target, 0 is the window
+    void blitTo(GLuint target, int w, int h, int targetWidth, int targetHeight) {
+        glBindFramebuffer(GL_READ_FRAMEBUFFER, fbo_id);
+        glBindFramebuffer(GL_DRAW_FRAMEBUFFER, target);
+        glBlitFramebuffer(0, 0, w, h, 0, 0, targetWidth, targetHeight, GL_COLOR_BUFFER_BIT, GL_LINEAR);
+    }
+    GLuint colorTexture() const {
+        return color_tex;
+    }
+    int getWidth() const {
+        return width;
+    }
+    int getHeight() const {
+        return height;
+    }
+};
+
+
+// GPU time of a stretch of commands, without waiting for it. there are a few queries in flight and
+// we only read the one that was issued QUERIES frames ago, which has long finished by then
+class GpuTimer {
+    static constexpr int QUERIES = 4;
+    GLuint queries[QUERIES] = {};
+    int frame = 0;
+public:
+    GpuTimer() {
+        glGenQueries(QUERIES, queries);
+    }
+    ~GpuTimer() {
+        glDeleteQueries(QUERIES, queries);
+    }
+    void begin() {
+        glBeginQuery(GL_TIME_ELAPSED, queries[frame % QUERIES]);
+    }
+    // returns the milliseconds of an older frame, or a negative value if there is none yet
+    double end() {
+        glEndQuery(GL_TIME_ELAPSED);
+        ++frame;
+        if (frame < QUERIES)
+            return -1.;
+        GLuint oldest = queries[frame % QUERIES];
+        GLint available = 0;
+        glGetQueryObjectiv(oldest, GL_QUERY_RESULT_AVAILABLE, &available);
+        if (!available)
+            return -1.;
+        GLuint64 ns = 0;
+        glGetQueryObjectui64v(oldest, GL_QUERY_RESULT, &ns);
+        return ns / 1e6;
+    }
+};
+
+
+// picks the render scale from the measured GPU time. cost goes with the pixel count, i.e. scale squared,
+// so the scale that would hit the budget is scale * sqrt(budget / time). we only move part of the way
+// there each frame, and leave a small dead zone so it doesn't hunt around the budget
+class DynamicResolution {
+    float budgetMs;
+    float scale = 1.f;
+    float minScale, maxScale;
+    float smoothedMs = 0.f;
+public:
+    explicit DynamicResolution(float budgetMs, float minScale = 0.5f, float maxScale = 1.f)
+        : budgetMs(budgetMs), minScale(minScale), maxScale(maxScale) {}
+
+    void update(double gpuMs) {
+        if (gpuMs < 0.)
+            return;
+        smoothedMs = smoothedMs == 0.f ? gpuMs : glm::mix(smoothedMs, float(gpuMs), 0.2f);
+        float ratio = budgetMs / std::max(smoothedMs, 0.01f);
+        if (ratio > 0.9f && ratio < 1.05f)
+            return;
+        float wanted = scale * std::sqrt(ratio);
+        // drop quickly when we are over budget, come back slowly
+        float rate = ratio < 1.f ? 0.5f : 0.1f;
+        scale = glm::clamp(glm::mix(scale, wanted, rate), minScale, maxScale);
+    }
+    float getScale() const {
+        return scale;
+    }
+    float gpuMs() const {
+        return smoothedMs;
+    }
+};
+
+
+int windowWidth = 800, windowHeight = 600;
+
+void resizeEvent(GLFWwindow *, int width, int height) {
+    windowWidth = width, windowHeight = height;
+}
+
+
+void processInput(GLFWwindow *window, glm::vec3 &cameraPos, glm::vec3 &cameraFront, glm::vec3 &cameraUp)
+{
+
+    const float cameraSpeed = 0.05f; // adjust accordingly
+    if (glfwGetKey(window, GLFW_KEY_W) == GLFW_PRESS)
+        cameraPos += cameraSpeed * cameraFront;
+    if (glfwGetKey(window, GLFW_KEY_S) == GLFW_PRESS)
+        cameraPos -= cameraSpeed * cameraFront;
+    if (glfwGetKey(window, GLFW_KEY_A) == GLFW_PRESS)
+        cameraPos -= glm::normalize(glm::cross(cameraFront, cameraUp)) * cameraSpeed;
+    if (glfwGetKey(window, GLFW_KEY_D) == GLFW_PRESS)
+        cameraPos += glm::normalize(glm::cross(cameraFront, cameraUp)) * cameraSpeed;
+    if (glfwGetKey(window, GLFW_KEY_UP) == GLFW_PRESS)
+        cameraPos += glm::normalize(glm::cross(cameraFront, cameraUp)) * cameraSpeed;
+
+}
+
+
+float yaw = -90.f;
+float pitch = 0.f;
+glm::vec3 cameraFront;
+
+void mouseMovement(GLFWwindow *window, double xPos, double yPos) {
+    static float lastX = xPos, lastY = yPos;
+    float xOffset = xPos - lastX;
+    float yOffset = lastY - yPos;
+    
+    constexpr float sensitivity = 0.05f;
+    xOffset *= sensitivity;
+    yOffset *= sensitivity;
+
+    yaw += xOffset;
+    pitch += yOffset;
+
+    if (std::abs(pitch) > 89.f) // don't ever do it this way. I am lazy
+        pitch = std::abs(pitch) / pitch * 89.f;
+
+    cameraFront.x = cos(glm::radians(yaw)) * cos(glm::radians(pitch));
+    cameraFront.y = sin(glm::radians(pitch));
+    cameraFront.z = sin(glm::radians(yaw)) * cos(glm::radians(pitch));
+
+    cameraFront = glm::normalize(cameraFront);
+    lastX = xPos, lastY = yPos;
+}
+
+
+
+
+
+int main(int argc, char **argv) {
+    // ./main [budget in ms], how long the scene pass may take on the GPU
+    const float budgetMs = argc > 1 ? std::atof(argv[1]) : 8.f;
+
+    if (glfwInit() != GLFW_TRUE) {
+        glfwTerminate();
+        std::cerr << "Failed to initialize GLFW";
+        return EXIT_FAILURE;
+    }
+    // setting OpenGL version to 3.3
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+    GLFWwindow *win = glfwCreateWindow(windowWidth, windowHeight, "This is a hello window!", NULL, NULL);
+    // setting 'context' for OpenGL, i.e. where to draw on current thread
+    glfwMakeContextCurrent(win);
+    // the framebuffer isn't always the window size (hidpi), ask for it instead of assuming
+    glfwGetFramebufferSize(win, &windowWidth, &windowHeight);
+    glfwSetFramebufferSizeCallback(win, resizeEvent);
+    // all it does is fetches us the implemented functions of OpenGL
+    if (glewInit() != GLEW_OK) {
+        glfwTerminate();
+        std::cerr << "Failed to initialize GLEW\n";
+        return EXIT_FAILURE;
+    }
+
+    glEnable(GL_DEPTH_TEST);
+    float triangle_data[] = {
+        //   vertpos   //  //texcord//
+    -0.5f, -0.5f, -0.5f,  0.0f, 0.0f,
+     0.5f, -0.5f, -0.5f,  1.0f, 0.0f,
+     0.5f,  0.5f, -0.5f,  1.0f, 1.0f,
+     0.5f,  0.5f, -0.5f,  1.0f, 1.0f,
+    -0.5f,  0.5f, -0.5f,  0.0f, 1.0f,
+    -0.5f, -0.5f, -0.5f,  0.0f, 0.0f,
+
+    -0.5f, -0.5f,  0.5f,  0.0f, 0.0f,
+     0.5f, -0.5f,  0.5f,  1.0f, 0.0f,
+     0.5f,  0.5f,  0.5f,  1.0f, 1.0f,
+     0.5f,  0.5f,  0.5f,  1.0f, 1.0f,
+    -0.5f,  0.5f,  0.5f,  0.0f, 1.0f,
+    -0.5f, -0.5f,  0.5f,  0.0f, 0.0f,
+
+    -0.5f,  0.5f,  0.5f,  1.0f, 0.0f,
+    -0.5f,  0.5f, -0.5f,  1.0f, 1.0f,
+    -0.5f, -0.5f, -0.5f,  0.0f, 1.0f,
+    -0.5f, -0.5f, -0.5f,  0.0f, 1.0f,
+    -0.5f, -0.5f,  0.5f,  0.0f, 0.0f,
+    -0.5f,  0.5f,  0.5f,  1.0f, 0.0f,
+
+     0.5f,  0.5f,  0.5f,  1.0f, 0.0f,
+     0.5f,  0.5f, -0.5f,  1.0f, 1.0f,
+     0.5f, -0.5f, -0.5f,  0.0f, 1.0f,
+     0.5f, -0.5f, -0.5f,  0.0f, 1.0f,
+     0.5f, -0.5f,  0.5f,  0.0f, 0.0f,
+     0.5f,  0.5f,  0.5f,  1.0f, 0.0f,
+
+    -0.5f, -0.5f, -0.5f,  0.0f, 1.0f,
+     0.5f, -0.5f, -0.5f,  1.0f, 1.0f,
+     0.5f, -0.5f,  0.5f,  1.0f, 0.0f,
+     0.5f, -0.5f,  0.5f,  1.0f, 0.0f,
+    -0.5f, -0.5f,  0.5f,  0.0f, 0.0f,
+    -0.5f, -0.5f, -0.5f,  0.0f, 1.0f,
+
+    -0.5f,  0.5f, -0.5f,  0.0f, 1.0f,
+     0.5f,  0.5f, -0.5f,  1.0f, 1.0f,
+     0.5f,  0.5f,  0.5f,  1.0f, 0.0f,
+     0.5f,  0.5f,  0.5f,  1.0f, 0.0f,
+    -0.5f,  0.5f,  0.5f,  0.0f, 0.0f,
+    -0.5f,  0.5f, -0.5f,  0.0f, 1.0f
+        
+    };
+
+
+    glm::vec3 cameraPos(0.f, 0.f, 3.f);
+    cameraFront = glm::vec3(0.f,0.f,-1.f);
+    glm::vec3 cameraUp(0.,1.,0.f);
+    
+
+    Texture2D tex;
+    tex.generate2DTex("./image2d.tex");
+    tex.bind();
+
+    GLuint vbo = 0;
+    glGenBuffers(1, &vbo); 
+    glBindBuffer(GL_ARRAY_BUFFER, vbo);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(triangle_data), triangle_data, GL_STATIC_DRAW);
+
+    GLuint vao = 0;
+    glGenVertexArrays(1, &vao);
+    glBindVertexArray(vao);
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)0);
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)(3 * sizeof(float)));
+    glEnableVertexAttribArray(1);
+
+    VertexShader vs;
+    FragmentShader fs;
+    vs.setSource("./vertex.glsl");
+    fs.setSource("./frag.glsl");
+    Program prog;
+    prog.AttachShaders({&vs, &fs});
+    prog.UseProgram();
+
+
+    glm::mat4 view; // = glm::translate(glm::mat4(1.f), glm::vec3(0.f,0.f,-3.f));
+       
+
+    glm::mat4 proj;
+
+    // the scene goes into here, at whatever fraction of the window size we can afford, then gets stretched
+    // over the window. the target stays at full size, lower scales just use a corner of it
+    Framebuffer sceneTarget;
+    sceneTarget.create(windowWidth, windowHeight, 4);
+    GpuTimer gpuTimer;
+    DynamicResolution resolution(budgetMs);
+    double lastReport = glfwGetTime();
+
+    glfwSetCursorPosCallback(win, mouseMovement); 
+    glfwSetInputMode(win, GLFW_CURSOR, GLFW_CURSOR_DISABLED);  
+    
+    while (!glfwWindowShouldClose(win)) {
+        processInput(win, cameraPos, cameraFront, cameraUp);
+        view = glm::lookAt(cameraPos, cameraFront + cameraPos, cameraUp);
+
+        prog.setMat4("view", view);
+        proj = glm::perspective(glm::radians(45.f), float(windowWidth) / std::max(windowHeight, 1), 0.1f, 100.f);
+        prog.setMat4("proj", proj);
+
+        sceneTarget.resize(windowWidth, windowHeight);
+        const int renderWidth = std::max(1, int(windowWidth * resolution.getScale()));
+        const int renderHeight = std::max(1, int(windowHeight * resolution.getScale()));
+
+        gpuTimer.begin();
+        sceneTarget.bind();
+        glViewport(0, 0, renderWidth, renderHeight);
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+        // hold P for a load spike: the same grid drawn many times over, nearly all overdraw
+        const int layers = glfwGetKey(win, GLFW_KEY_P) == GLFW_PRESS ? 40 : 1;
+        for (int layer = 0; layer < layers; ++layer) {
+            for (int z = 0; z < 10; ++z) {
+                for (int x = 0; x < 10; ++x) {
+                    glm::mat4 model = glm::translate(glm::mat4(1.f), glm::vec3(x * 1.5f - 7.f, -1.f, -z * 1.5f - layer * 0.01f));
+                    prog.setMat4("model", model);
+                    glDrawArrays(GL_TRIANGLES, 0, 36);
+                }
+            }
+        }
+        sceneTarget.resolve(renderWidth, renderHeight);
+        sceneTarget.blitTo(0, renderWidth, renderHeight, windowWidth, windowHeight);
+        resolution.update(gpuTimer.end());
+
+        if (glfwGetTime() - lastReport > 1.) {
+            lastReport = glfwGetTime();
+            std::cout << "scene " << resolution.gpuMs() << "ms on the GPU (budget " << budgetMs << "ms), rendering at "
+                      << renderWidth << "x" << renderHeight << " (" << int(resolution.getScale() * 100) << "%)\n";
+        }
+        // polls different kinds of events, for example, when we close an application, it fetches that event
+        // or it fetches events like movement of the window.
+        // Without it you can neither move the window or close the window
+        glfwPollEvents();
+        // have you drawn the image, it is stored in the buffer. You can now swap this buffer with main buffer
+        // so the image appears
+        glfwSwapBuffers(win);
+    }
+    glfwTerminate();
+    
+    std::cout << "Window should close now!\n";
+
+    return EXIT_SUCCESS;
+
+}
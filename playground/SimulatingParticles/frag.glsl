@@ -0,0 +1,14 @@
+#version 330 core
+
+out vec4 FragColor;
+in vec2 texCoord;
+in vec2 corner;
+in float fade;
+
+uniform sampler2D tex;
+
+void main() {
+    // round and soft edged, and fading out as it gets old
+    float edge = 1.0 - smoothstep(0.3, 0.5, length(corner));
+    FragColor = vec4(texture(tex, texCoord).rgb, edge * fade * 0.6);
+}
@@ -0,0 +1,886 @@
+#include <GL/glew.h>
+
+#include <GLFW/glfw3.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <immintrin.h>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+#include <glm/ext/matrix_clip_space.hpp>
+#include <glm/ext/matrix_transform.hpp>
+#include <glm/geometric.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/ext/matrix_float4x4.hpp>
+#include <glm/gtc/type_ptr.hpp>
+#include <glm/glm.hpp>
+#include <glm/trigonometric.hpp>
+#define STB_IMAGE_IMPLEMENTATION
+#include <stb/stb_image.h>
+#include <iostream>
+
+class Shader {
+    std::string src; 
+protected:
+    const char *getsrc() {
+        return src.data();
+    }
+    GLuint shader_id = 0;
+    bool isCompiled = false;
+protected:
+    virtual const char *getClassName() = 0;
+    GLint getCompilationStatus(GLuint shader_id) {
+        int status;
+        glGetShaderiv(shader_id, GL_COMPILE_STATUS, &status);
+        return status;
+    }
+    void sendError() {
+        char buffer[1024];
+        glGetShaderInfoLog(shader_id, 1024, NULL, buffer);
+        std::cerr << "ERROR::" << getClassName() << " - " << buffer;
+    }
+public:
+    virtual void compile() = 0;
+    void setSource(const char *s) {
+        std::ifstream sourceFile(s);
+        if (!sourceFile.is_open())
+            return;
+        char buffer[8192];
+        while (sourceFile.read(buffer, 8192)) {
+            src.append(buffer, 8192);
+        }
+        if (!sourceFile.eof()) {
+            src.clear();
+            return;
+        }
+        src.append(buffer, sourceFile.gcount());
+    }
+    friend class Program;
+};
+
+
+class VertexShader : public Shader {
+    virtual const char *getClassName() override {
+        return "VertexShader";
+    }
+public:
+    virtual void compile() override {
+        if (shader_id)
+            glDeleteShader(shader_id);
+        shader_id = glCreateShader(GL_VERTEX_SHADER);
+        const char *src = getsrc();
+        glShaderSource(shader_id, 1, &src, NULL);
+        glCompileShader(shader_id);
+        if (!getCompilationStatus(shader_id)) {
+            sendError();
+        }
+        isCompiled = true;
+    }
+};
+
+class FragmentShader : public Shader {
+    const char *getClassName() override {
+        return "FragmentShader";
+    }
+public:
+    virtual void compile() override {
+        if (shader_id)
+            glDeleteShader(shader_id);
+        shader_id = glCreateShader(GL_FRAGMENT_SHADER);
+        const char *src = getsrc();
+        glShaderSource(shader_id, 1, &src, NULL);
+        glCompileShader(shader_id);
+        if (!getCompilationStatus(shader_id)) {
+            sendError();
+        }
+        isCompiled = true;
+    }
+};
+
+
+class Program {
+    GLuint program_id = 0;
+    void sendError() {
+        char buffer[1024];
+        glGetProgramInfoLog(program_id, 1024, NULL, buffer);
+        std::cerr << "ERROR::PROGRAM: " << " - " << buffer;
+    }
+    bool linkStatus() {
+        int status = 0;
+        glGetProgramiv(program_id, GL_LINK_STATUS, &status);
+        return status;
+    }
+public:
+    Program() {
+        program_id = glCreateProgram();
+    }
+    ~Program() {
+        glDeleteProgram(program_id);
+    }
+    void AttachShaders(std::initializer_list<Shader*> shaders) {
+        auto i = shaders.begin();
+        while (i != shaders.end()) {
+            if (!(*i)->isCompiled)
+                (*i)->compile();
+            glAttachShader(program_id, (*i)->shader_id);
+            ++i;
+        }
+        glLinkProgram(program_id);
+        if (!linkStatus()) {
+            sendError();
+        }
+    }
+    void UseProgram() {
+        glUseProgram(program_id);
+    }
+    void setMat4(const char *locName, const glm::mat4 &mat) {
+        int location = glGetUniformLocation(program_id, locName);
+        if (location == -1)
+            return;
+        glUniformMatrix4fv(location, 1, GL_FALSE, glm::value_ptr(mat));
+    }
+    void setInt(const char *locName, int value) {
+        int location = glGetUniformLocation(program_id, locName);
+        if (location == -1)
+            return;
+        glUniform1i(location, value);
+    }
+    void setFloat(const char *locName, float value) {
+        int location = glGetUniformLocation(program_id, locName);
+        if (location == -1)
+            return;
+        glUniform1f(location, value);
+    }
+    void setVec3(const char *locName, const glm::vec3 &vec) {
+        int location = glGetUniformLocation(program_id, locName);
+        if (location == -1)
+            return;
+        glUniform3f(location, vec.x, vec.y, vec.z);
+    }
+    void setVec4(const char *locName, const glm::vec4 &vec) {
+        int location = glGetUniformLocation(program_id, locName);
+        if (location == -1)
+            return;
+        glUniform4f(location, vec.x, vec.y, vec.z, vec.w);
+    }
+};
+
+
+class Texture2D {
+    GLuint tex_id;
+public:
+    void generate2DTex(const char *image_path) {
+        int width, height, nChannels;
+        stbi_set_flip_vertically_on_load(true);
+        uint8_t *raw_image = stbi_load(image_path, &width, &height, &nChannels, 0);
+        float borderColor[] = {1.f, 1.f, 1.f, 1.f};
+        glGenTextures(1, &tex_id);
+        glBindTexture(GL_TEXTURE_2D, tex_id);
+        // what to do when primitive is bigger than the texture
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_BORDER);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_BORDER);
+        glTexParameterfv(GL_TEXTURE_2D, GL_TEXTURE_BORDER_COLOR, borderColor);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        // glTexImage2D(TARGET_TYPE, IM_MIPMAP_LEVEL, TARGET_NRCHANNELS, SRC_WIDTH, SRC_HEIGHT, LEGACY_0, SRC_NRCHANNELS, SRC_DATA_TYPE, SRC_DATA);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, width, height, 0, GL_RGB, GL_UNSIGNED_BYTE, raw_image);
+        stbi_image_free(raw_image);
+    }
+    void bind() {
+        glBindTexture(GL_TEXTURE_2D, tex_id);
+    }
+};
+
+
+// a handful of threads that split loops between them, the calling thread helps out
+class WorkerPool {
+    std::vector<std::thread> threads;
+    std::mutex mutex;
+    std::condition_variable wake, finished;
+    const std::function<void(size_t, size_t)> *job = nullptr;
+    size_t jobCount = 0;
+    size_t jobChunk = 1;
+    std::atomic<size_t> next{0};
+    int busy = 0;
+    uint64_t generation = 0;
+    bool quit = false;
+
+    void work() {
+        size_t begin;
+        while ((begin = next.fetch_add(jobChunk)) < jobCount)
+            (*job)(begin, std::min(begin + jobChunk, jobCount));
+    }
+public:
+    explicit WorkerPool(unsigned count = std::thread::hardware_concurrency()) {
+        for (unsigned i = 1; i < std::max(count, 1u); ++i) {
+            threads.emplace_back([this] {
+                uint64_t seen = 0;
+                std::unique_lock<std::mutex> lock(mutex);
+                while (true) {
+                    wake.wait(lock, [&] { return quit || generation != seen; });
+                    if (quit)
+                        return;
+                    seen = generation;
+                    lock.unlock();
+                    work();
+                    lock.lock();
+                    if (--busy == 0)
+                        finished.notify_one();
+                }
+            });
+        }
+    }
+    ~WorkerPool() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            quit = true;
+        }
+        wake.notify_all();
+        for (std::thread &t : threads)
+            t.join();
+    }
+    size_t size() const {
+        return threads.size() + 1;
+    }
+    // calls fn(begin, end) on ranges of at most chunk items until [0, count) is covered, returns when all are done
+    void parallelFor(size_t count, size_t chunk, const std::function<void(size_t, size_t)> &fn) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            job = &fn;
+            jobCount = count;
+            jobChunk = std::max<size_t>(chunk, 1);
+            next = 0;
+            busy = threads.size();
+            ++generation;
+        }
+        wake.notify_all();
+        work();
+        std::unique_lock<std::mutex> lock(mutex);
+        finished.wait(lock, [&] { return busy == 0; });
+    }
+};
+
+
+// ---------------------------------------------------------------------------------------------------------
+// particles. every property is its own array (structure of arrays), so a kernel loads 8 particles' x with
+// one instruction and no lane is wasted on a field it doesn't need. a frame is: emit new particles at the
+// end, update all of them (forces, integration, aging) in parallel chunks, then compact the living ones
+// into the other set of arrays, also in parallel, each chunk knowing from the update where its survivors
+// go. the GPU reads the position and age arrays as they are, there's no packing step
+// ---------------------------------------------------------------------------------------------------------
+
+enum ParticleStream { PX, PY, PZ, VX, VY, VZ, AGE, LIFE, STREAM_COUNT };
+
+struct ParticleParams {
+    float dt;
+    float gravity = 9.81f;
+    float drag = 0.4f;        // fraction of the velocity lost per second
+    float swirl = 1.5f;       // sideways pull around the y axis
+    float restitution = 0.5f; // velocity kept when bouncing off the ground
+};
+
+// per frame constants, worked out once instead of per particle
+struct ParticleStep {
+    float dt, damping, swirlDt, gravityDt, restitution;
+    explicit ParticleStep(const ParticleParams &p)
+        : dt(p.dt), damping(std::max(0.f, 1.f - p.drag * p.dt)), swirlDt(p.swirl * p.dt), gravityDt(p.gravity * p.dt), restitution(p.restitution) {}
+};
+
+// updates particles [begin, end) in place, returns how many are still alive
+size_t updateParticlesScalar(float *const *s, size_t begin, size_t end, const ParticleStep &step) {
+    size_t alive = 0;
+    for (size_t i = begin; i < end; ++i) {
+        float px = s[PX][i], py = s[PY][i], pz = s[PZ][i];
+        // the swirl pushes at right angles to the way from the axis
+        float vx = (s[VX][i] - pz * step.swirlDt) * step.damping;
+        float vy = (s[VY][i] - step.gravityDt) * step.damping;
+        float vz = (s[VZ][i] + px * step.swirlDt) * step.damping;
+        px += vx * step.dt;
+        py += vy * step.dt;
+        pz += vz * step.dt;
+        if (py < 0.f) {
+            py = -py;
+            vy = -vy * step.restitution;
+        }
+        float age = s[AGE][i] + step.dt;
+        s[PX][i] = px, s[PY][i] = py, s[PZ][i] = pz;
+        s[VX][i] = vx, s[VY][i] = vy, s[VZ][i] = vz;
+        s[AGE][i] = age;
+        alive += age < s[LIFE][i];
+    }
+    return alive;
+}
+
+// copies the living particles of [begin, end) to dst, starting at out
+void compactParticlesScalar(const float *const *src, float *const *dst, size_t begin, size_t end, size_t out) {
+    for (size_t i = begin; i < end; ++i) {
+        if (!(src[AGE][i] < src[LIFE][i]))
+            continue;
+        for (int stream = 0; stream < STREAM_COUNT; ++stream)
+            dst[stream][out] = src[stream][i];
+        ++out;
+    }
+}
+
+
+#if defined(__x86_64__) || defined(__i386__)
+#define PARTICLE_KERNELS_X86 1
+
+__attribute__((target("avx2,fma")))
+size_t updateParticlesAvx2(float *const *s, size_t begin, size_t end, const ParticleStep &step) {
+    const __m256 dt = _mm256_set1_ps(step.dt), damping = _mm256_set1_ps(step.damping);
+    const __m256 swirlDt = _mm256_set1_ps(step.swirlDt), gravityDt = _mm256_set1_ps(step.gravityDt);
+    const __m256 restitution = _mm256_set1_ps(-step.restitution), zero = _mm256_setzero_ps();
+    const __m256 signBit = _mm256_set1_ps(-0.f);
+    size_t alive = 0, i = begin;
+    for (; i + 8 <= end; i += 8) {
+        __m256 px = _mm256_loadu_ps(s[PX] + i), py = _mm256_loadu_ps(s[PY] + i), pz = _mm256_loadu_ps(s[PZ] + i);
+        __m256 vx = _mm256_mul_ps(_mm256_fnmadd_ps(pz, swirlDt, _mm256_loadu_ps(s[VX] + i)), damping);
+        __m256 vy = _mm256_mul_ps(_mm256_sub_ps(_mm256_loadu_ps(s[VY] + i), gravityDt), damping);
+        __m256 vz = _mm256_mul_ps(_mm256_fmadd_ps(px, swirlDt, _mm256_loadu_ps(s[VZ] + i)), damping);
+        px = _mm256_fmadd_ps(vx, dt, px);
+        py = _mm256_fmadd_ps(vy, dt, py);
+        pz = _mm256_fmadd_ps(vz, dt, pz);
+        // under the ground: mirror the position and bounce, without a branch
+        __m256 below = _mm256_cmp_ps(py, zero, _CMP_LT_OQ);
+        py = _mm256_xor_ps(py, _mm256_and_ps(below, signBit));
+        vy = _mm256_blendv_ps(vy, _mm256_mul_ps(vy, restitution), below);
+        __m256 age = _mm256_add_ps(_mm256_loadu_ps(s[AGE] + i), dt);
+        _mm256_storeu_ps(s[PX] + i, px);
+        _mm256_storeu_ps(s[PY] + i, py);
+        _mm256_storeu_ps(s[PZ] + i, pz);
+        _mm256_storeu_ps(s[VX] + i, vx);
+        _mm256_storeu_ps(s[VY] + i, vy);
+        _mm256_storeu_ps(s[VZ] + i, vz);
+        _mm256_storeu_ps(s[AGE] + i, age);
+        alive += __builtin_popcount(_mm256_movemask_ps(_mm256_cmp_ps(age, _mm256_loadu_ps(s[LIFE] + i), _CMP_LT_OQ)));
+    }
+    // the scalar tail is plain SSE code, and SSE after AVX with the upper halves still dirty pays a
+    // transition penalty on every instruction, until something clears them. gcc doesn't before a tail call
+    _mm256_zeroupper();
+    return alive + updateParticlesScalar(s, i, end, step);
+}
+
+// for every 8 bit mask of living lanes, the lanes to gather so the living ones end up first
+struct LeftPackTable {
+    alignas(32) uint32_t lanes[256][8];
+    LeftPackTable() {
+        for (int mask = 0; mask < 256; ++mask) {
+            int n = 0;
+            for (int lane = 0; lane < 8; ++lane)
+                if (mask & (1 << lane))
+                    lanes[mask][n++] = lane;
+            while (n < 8)
+                lanes[mask][n++] = 0;
+        }
+    }
+};
+
+const LeftPackTable leftPack;
+
+// the same, 8 particles at a time: the living lanes are packed to the front with one permute per stream
+// and stored as a full vector, the dead lanes after them get overwritten by the next store. the stores
+// that would run past this chunk's part of dst, which belongs to another thread, are masked
+__attribute__((target("avx2,fma")))
+void compactParticlesAvx2(const float *const *src, float *const *dst, size_t begin, size_t end, size_t out, size_t outEnd) {
+    size_t i = begin;
+    for (; i + 8 <= end; i += 8) {
+        int mask = _mm256_movemask_ps(_mm256_cmp_ps(_mm256_loadu_ps(src[AGE] + i), _mm256_loadu_ps(src[LIFE] + i), _CMP_LT_OQ));
+        if (!mask)
+            continue;
+        const int n = __builtin_popcount(mask);
+        const __m256i lanes = _mm256_load_si256(reinterpret_cast<const __m256i*>(leftPack.lanes[mask]));
+        if (out + 8 <= outEnd) {
+            for (int stream = 0; stream < STREAM_COUNT; ++stream)
+                _mm256_storeu_ps(dst[stream] + out, _mm256_permutevar8x32_ps(_mm256_loadu_ps(src[stream] + i), lanes));
+        } else {
+            const __m256i keep = _mm256_cmpgt_epi32(_mm256_set1_epi32(n), _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7));
+            for (int stream = 0; stream < STREAM_COUNT; ++stream)
+                _mm256_maskstore_ps(dst[stream] + out, keep, _mm256_permutevar8x32_ps(_mm256_loadu_ps(src[stream] + i), lanes));
+        }
+        out += n;
+    }
+    _mm256_zeroupper();
+    compactParticlesScalar(src, dst, i, end, out);
+}
+#endif
+
+struct ParticleKernels {
+    size_t (*update)(float *const *s, size_t begin, size_t end, const ParticleStep &step) = updateParticlesScalar;
+    void (*compact)(const float *const *src, float *const *dst, size_t begin, size_t end, size_t out, size_t outEnd) =
+        [](const float *const *src, float *const *dst, size_t begin, size_t end, size_t out, size_t) {
+            compactParticlesScalar(src, dst, begin, end, out);
+        };
+    std::string name = "scalar";
+};
+
+ParticleKernels bestParticleKernels() {
+    ParticleKernels kernels;
+#ifdef PARTICLE_KERNELS_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) {
+        kernels.update = updateParticlesAvx2;
+        kernels.compact = compactParticlesAvx2;
+        kernels.name = "avx2";
+    }
+#endif
+    return kernels;
+}
+
+// a fountain: particles start in a small disc at the origin and shoot up in a cone
+struct Emitter {
+    glm::vec3 position = glm::vec3(0.f);
+    float radius = 0.3f;
+    float speedMin = 7.f, speedMax = 11.f;
+    float spread = 0.35f;  // sideways speed per unit of upwards speed
+    float lifeMin = 2.f, lifeMax = 4.f;
+    float rate = 300000.f;  // particles a second
+};
+
+struct ParticleTimings {
+    double emit = 0., update = 0., compact = 0.;
+};
+
+class ParticleSystem {
+    // two sets of arrays, compaction reads one and writes the other
+    std::vector<float> streams[2][STREAM_COUNT];
+    int front = 0;
+    size_t count = 0, maxCount;
+    std::vector<size_t> chunkAlive;
+    float emitDebt = 0.f;
+    uint32_t rngState = 0x9e3779b9u;
+    ParticleKernels kernels;
+
+    float random() {
+        // xorshift32, plenty for particles and much cheaper than the standard engines
+        rngState ^= rngState << 13;
+        rngState ^= rngState >> 17;
+        rngState ^= rngState << 5;
+        return (rngState >> 8) * (1.f / 16777216.f);
+    }
+public:
+    // multiples of 8, so only the very last chunk has a scalar tail
+    static constexpr size_t CHUNK = 16384;
+
+    ParticleSystem(size_t maxCount, ParticleKernels kernels) : maxCount(maxCount), kernels(std::move(kernels)) {
+        for (auto &set : streams)
+            for (std::vector<float> &stream : set)
+                stream.resize(maxCount);
+        chunkAlive.resize((maxCount + CHUNK - 1) / CHUNK);
+    }
+    size_t size() const {
+        return count;
+    }
+    size_t capacity() const {
+        return maxCount;
+    }
+    const char *kernelName() const {
+        return kernels.name.c_str();
+    }
+    const float *stream(ParticleStream s) const {
+        return streams[front][s].data();
+    }
+
+    size_t emit(const Emitter &emitter, float dt) {
+        emitDebt += emitter.rate * dt;
+        size_t n = std::min(size_t(emitDebt), maxCount - count);
+        emitDebt -= float(size_t(emitDebt));
+        std::vector<float> *s = streams[front];
+        for (size_t i = count; i < count + n; ++i) {
+            float angle = random() * 2.f * glm::pi<float>(), r = emitter.radius * std::sqrt(random());
+            s[PX][i] = emitter.position.x + r * std::cos(angle);
+            s[PY][i] = emitter.position.y;
+            s[PZ][i] = emitter.position.z + r * std::sin(angle);
+            float up = emitter.speedMin + (emitter.speedMax - emitter.speedMin) * random();
+            float side = angle + (random() - 0.5f);
+            s[VX][i] = std::cos(side) * up * emitter.spread * random();
+            s[VY][i] = up;
+            s[VZ][i] = std::sin(side) * up * emitter.spread * random();
+            s[AGE][i] = 0.f;
+            s[LIFE][i] = emitter.lifeMin + (emitter.lifeMax - emitter.lifeMin) * random();
+        }
+        count += n;
+        return n;
+    }
+
+    // one frame: emit, update, compact. the two parallel passes split the particles the same way
+    ParticleTimings simulate(const Emitter &emitter, const ParticleParams &params, WorkerPool &pool) {
+        ParticleTimings timings;
+        auto now = [] { return std::chrono::steady_clock::now(); };
+        auto ms = [](auto from, auto to) { return std::chrono::duration<double, std::milli>(to - from).count(); };
+
+        auto start = now();
+        emit(emitter, params.dt);
+        auto emitted = now();
+
+        const ParticleStep step(params);
+        float *src[STREAM_COUNT], *dst[STREAM_COUNT];
+        for (int s = 0; s < STREAM_COUNT; ++s) {
+            src[s] = streams[front][s].data();
+            dst[s] = streams[1 - front][s].data();
+        }
+        pool.parallelFor(count, CHUNK, [&](size_t begin, size_t end) {
+            chunkAlive[begin / CHUNK] = kernels.update(src, begin, end, step);
+        });
+        auto updated = now();
+
+        // where every chunk's survivors start, then each chunk moves its own
+        const size_t chunks = (count + CHUNK - 1) / CHUNK;
+        std::vector<size_t> chunkOut(chunks + 1, 0);
+        for (size_t c = 0; c < chunks; ++c)
+            chunkOut[c + 1] = chunkOut[c] + chunkAlive[c];
+        pool.parallelFor(count, CHUNK, [&](size_t begin, size_t end) {
+            size_t c = begin / CHUNK;
+            kernels.compact(src, dst, begin, end, chunkOut[c], chunkOut[c + 1]);
+        });
+        count = chunkOut[chunks];
+        front = 1 - front;
+        auto compacted = now();
+
+        timings.emit = ms(start, emitted);
+        timings.update = ms(emitted, updated);
+        timings.compact = ms(updated, compacted);
+        return timings;
+    }
+};
+
+
+class GpuTimer {
+    static constexpr int QUERIES = 4;
+    GLuint queries[QUERIES] = {};
+    int frame = 0;
+public:
+    GpuTimer() {
+        glGenQueries(QUERIES, queries);
+    }
+    ~GpuTimer() {
+        glDeleteQueries(QUERIES, queries);
+    }
+    void begin() {
+        glBeginQuery(GL_TIME_ELAPSED, queries[frame % QUERIES]);
+    }
+    // returns the milliseconds of an older frame, or a negative value if there is none yet
+    double end() {
+        glEndQuery(GL_TIME_ELAPSED);
+        ++frame;
+        if (frame < QUERIES)
+            return -1.;
+        GLuint oldest = queries[frame % QUERIES];
+        GLint available = 0;
+        glGetQueryObjectiv(oldest, GL_QUERY_RESULT_AVAILABLE, &available);
+        if (!available)
+            return -1.;
+        GLuint64 ns = 0;
+        glGetQueryObjectui64v(oldest, GL_QUERY_RESULT, &ns);
+        return ns / 1e6;
+    }
+};
+
+
+// --bench: fills the system to its steady state and times the stages, AVX2 against scalar and one thread
+// against all of them. the AVX2 kernels are checked against the scalar ones on the same particles first
+int runBench(size_t maxParticles, int frames) {
+    ParticleParams params;
+    params.dt = 1.f / 60.f;
+    Emitter emitter;
+    // enough to keep it nearly full: the rate times the average lifetime
+    emitter.rate = maxParticles / ((emitter.lifeMin + emitter.lifeMax) * 0.5f);
+    const ParticleKernels simd = bestParticleKernels();
+
+    {
+        WorkerPool pool;
+        ParticleSystem a(maxParticles, ParticleKernels()), b(maxParticles, simd);
+        for (int frame = 0; frame < 120; ++frame) {
+            a.simulate(emitter, params, pool);
+            b.simulate(emitter, params, pool);
+        }
+        // fused multiply adds round once where the scalar code rounds twice, so close rather than equal
+        float worst = 0.f;
+        for (size_t i = 0; i < std::min(a.size(), b.size()); ++i)
+            for (int s = 0; s < STREAM_COUNT; ++s)
+                worst = std::max(worst, std::fabs(a.stream(ParticleStream(s))[i] - b.stream(ParticleStream(s))[i]));
+        std::printf("%s against scalar after 2 seconds: %zu and %zu particles, largest difference %g\n", simd.name.c_str(), b.size(), a.size(), worst);
+        if (a.size() != b.size() || worst > 1e-2f) {
+            std::cerr << "ERROR::PARTICLES - the " << simd.name << " kernels don't match the scalar ones\n";
+            return EXIT_FAILURE;
+        }
+    }
+
+    struct Run {
+        const char *label;
+        bool simd;
+        unsigned threads;
+    };
+    const unsigned all = std::max(1u, std::thread::hardware_concurrency());
+    std::vector<Run> runs = {{"scalar, 1 thread", false, 1}, {"simd,   1 thread", true, 1}};
+    if (all > 1)
+        runs.insert(runs.end(), {{"scalar, all threads", false, all}, {"simd,   all threads", true, all}});
+    for (const Run &run : runs) {
+        WorkerPool pool(run.threads);
+        ParticleSystem system(maxParticles, run.simd ? simd : ParticleKernels());
+        // warm up: 4 seconds fills it up to where the oldest start dying
+        for (int frame = 0; frame < 240; ++frame)
+            system.simulate(emitter, params, pool);
+        ParticleTimings total;
+        size_t particles = 0;
+        for (int frame = 0; frame < frames; ++frame) {
+            ParticleTimings t = system.simulate(emitter, params, pool);
+            total.emit += t.emit;
+            total.update += t.update;
+            total.compact += t.compact;
+            particles += system.size();
+        }
+        std::printf("%-20s %s: %7zu particles, emit %6.3f ms, update %6.3f ms, compact %6.3f ms, %6.3f ms a frame\n",
+                    run.label, system.kernelName(), particles / frames, total.emit / frames, total.update / frames,
+                    total.compact / frames, (total.emit + total.update + total.compact) / frames);
+    }
+    return EXIT_SUCCESS;
+}
+
+
+void processInput(GLFWwindow *window, glm::vec3 &cameraPos, glm::vec3 &cameraFront, glm::vec3 &cameraUp)
+{
+
+    const float cameraSpeed = 0.05f; // adjust accordingly
+    if (glfwGetKey(window, GLFW_KEY_W) == GLFW_PRESS)
+        cameraPos += cameraSpeed * cameraFront;
+    if (glfwGetKey(window, GLFW_KEY_S) == GLFW_PRESS)
+        cameraPos -= cameraSpeed * cameraFront;
+    if (glfwGetKey(window, GLFW_KEY_A) == GLFW_PRESS)
+        cameraPos -= glm::normalize(glm::cross(cameraFront, cameraUp)) * cameraSpeed;
+    if (glfwGetKey(window, GLFW_KEY_D) == GLFW_PRESS)
+        cameraPos += glm::normalize(glm::cross(cameraFront, cameraUp)) * cameraSpeed;
+    if (glfwGetKey(window, GLFW_KEY_UP) == GLFW_PRESS)
+        cameraPos += glm::normalize(glm::cross(cameraFront, cameraUp)) * cameraSpeed;
+
+}
+
+// true only on the frame the key went down
+bool keyPressed(GLFWwindow *window, int key) {
+    static bool down[GLFW_KEY_LAST + 1] = {};
+    bool now = glfwGetKey(window, key) == GLFW_PRESS;
+    bool pressed = now && !down[key];
+    down[key] = now;
+    return pressed;
+}
+
+
+float yaw = -90.f;
+float pitch = 0.f;
+glm::vec3 cameraFront;
+
+void mouseMovement(GLFWwindow *window, double xPos, double yPos) {
+    static float lastX = xPos, lastY = yPos;
+    float xOffset = xPos - lastX;
+    float yOffset = lastY - yPos;
+    
+    constexpr float sensitivity = 0.05f;
+    xOffset *= sensitivity;
+    yOffset *= sensitivity;
+
+    yaw += xOffset;
+    pitch += yOffset;
+
+    if (std::abs(pitch) > 89.f) // don't ever do it this way. I am lazy
+        pitch = std::abs(pitch) / pitch * 89.f;
+
+    cameraFront.x = cos(glm::radians(yaw)) * cos(glm::radians(pitch));
+    cameraFront.y = sin(glm::radians(pitch));
+    cameraFront.z = sin(glm::radians(yaw)) * cos(glm::radians(pitch));
+
+    cameraFront = glm::normalize(cameraFront);
+    lastX = xPos, lastY = yPos;
+}
+
+
+int main(int argc, char **argv) {
+    size_t maxParticles = 1000000;
+    unsigned threads = std::max(1u, std::thread::hardware_concurrency());
+    bool scalar = false;
+    for (int i = 1; i < argc; ++i) {
+        if (!std::strcmp(argv[i], "--bench"))
+            return runBench(i + 1 < argc ? size_t(std::max(8, std::atoi(argv[i + 1]))) : maxParticles, 300);
+        if (!std::strcmp(argv[i], "--particles") && i + 1 < argc)
+            maxParticles = size_t(std::max(8, std::atoi(argv[++i])));
+        else if (!std::strcmp(argv[i], "--threads") && i + 1 < argc)
+            threads = unsigned(std::max(1, std::atoi(argv[++i])));
+        else if (!std::strcmp(argv[i], "--scalar"))
+            scalar = true;
+    }
+
+    if (glfwInit() != GLFW_TRUE) {
+        glfwTerminate();
+        std::cerr << "Failed to initialize GLFW";
+        return EXIT_FAILURE;
+    }
+    // setting OpenGL version to 3.3
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+    GLFWwindow *win = glfwCreateWindow(800, 600, "This is a hello window!", NULL, NULL);
+    // setting 'context' for OpenGL, i.e. where to draw on current thread
+    glfwMakeContextCurrent(win);
+    // all it does is fetches us the implemented functions of OpenGL
+    if (glewInit() != GLEW_OK) {
+        glfwTerminate();
+        std::cerr << "Failed to initialize GLEW\n";
+        return EXIT_FAILURE;
+    }
+    int screenWidth, screenHeight;
+    glfwGetFramebufferSize(win, &screenWidth, &screenHeight);
+    glViewport(0, 0, screenWidth, screenHeight);
+
+    glEnable(GL_DEPTH_TEST);
+    glm::vec3 cameraPos(0.f, 0.f, 3.f);
+    cameraFront = glm::vec3(0.f,0.f,-1.f);
+    glm::vec3 cameraUp(0.,1.,0.f);
+
+    Texture2D tex;
+    tex.generate2DTex("./image2d.tex");
+    tex.bind();
+
+    WorkerPool pool(threads);
+    ParticleSystem particles(maxParticles, scalar ? ParticleKernels() : bestParticleKernels());
+    Emitter emitter;
+    emitter.rate = maxParticles / ((emitter.lifeMin + emitter.lifeMax) * 0.5f);
+    ParticleParams params;
+    std::cout << maxParticles << " particles at most, " << particles.kernelName() << " kernels on " << pool.size() << " threads\n";
+
+    // one corner of the billboard per vertex, the shader turns it to face the camera
+    float quad_data[] = {
+        -0.5f, -0.5f,  0.0f, 0.0f,
+         0.5f, -0.5f,  1.0f, 0.0f,
+        -0.5f,  0.5f,  0.0f, 1.0f,
+         0.5f,  0.5f,  1.0f, 1.0f
+    };
+
+    GLuint vao = 0;
+    glGenVertexArrays(1, &vao);
+    glBindVertexArray(vao);
+
+    GLuint vbo = 0;
+    glGenBuffers(1, &vbo); 
+    glBindBuffer(GL_ARRAY_BUFFER, vbo);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(quad_data), quad_data, GL_STATIC_DRAW);
+    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void*)0);
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void*)(2 * sizeof(float)));
+    glEnableVertexAttribArray(1);
+
+    // the particle arrays go up as they are, one after the other in one buffer, each its own attribute
+    const ParticleStream uploaded[] = {PX, PY, PZ, AGE, LIFE};
+    const size_t uploadedCount = sizeof(uploaded) / sizeof(uploaded[0]);
+    GLuint instanceVbo = 0;
+    glGenBuffers(1, &instanceVbo);
+    glBindBuffer(GL_ARRAY_BUFFER, instanceVbo);
+    glBufferData(GL_ARRAY_BUFFER, uploadedCount * maxParticles * sizeof(float), NULL, GL_STREAM_DRAW);
+    for (size_t i = 0; i < uploadedCount; ++i) {
+        glVertexAttribPointer(3 + i, 1, GL_FLOAT, GL_FALSE, sizeof(float), (void*)(i * maxParticles * sizeof(float)));
+        glEnableVertexAttribArray(3 + i);
+        glVertexAttribDivisor(3 + i, 1);
+    }
+
+    VertexShader vs;
+    FragmentShader fs;
+    vs.setSource("./vertex.glsl");
+    fs.setSource("./frag.glsl");
+    Program prog;
+    prog.AttachShaders({&vs, &fs});
+
+    prog.UseProgram();
+    prog.setInt("tex", 0);
+
+    GpuTimer drawTimer;
+    cameraPos = glm::vec3(0.f, 6.f, 22.f);
+
+    glfwSetCursorPosCallback(win, mouseMovement); 
+    glfwSetInputMode(win, GLFW_CURSOR, GLFW_CURSOR_DISABLED);  
+
+    double lastFrame = glfwGetTime(), lastReport = lastFrame;
+    ParticleTimings total;
+    double uploadMs = 0., drawMs = 0.;
+    size_t frames = 0, drawSamples = 0;
+    
+    while (!glfwWindowShouldClose(win)) {
+        double now = glfwGetTime();
+        // a long frame shouldn't throw everything through the floor
+        params.dt = float(std::min(now - lastFrame, 1. / 20.));
+        lastFrame = now;
+        processInput(win, cameraPos, cameraFront, cameraUp);
+
+        ParticleTimings t = particles.simulate(emitter, params, pool);
+        total.emit += t.emit;
+        total.update += t.update;
+        total.compact += t.compact;
+
+        auto uploadStart = std::chrono::steady_clock::now();
+        glBindBuffer(GL_ARRAY_BUFFER, instanceVbo);
+        // orphaned, so the driver doesn't wait for last frame's draw to be done with it
+        glBufferData(GL_ARRAY_BUFFER, uploadedCount * maxParticles * sizeof(float), NULL, GL_STREAM_DRAW);
+        for (size_t i = 0; i < uploadedCount; ++i)
+            glBufferSubData(GL_ARRAY_BUFFER, i * maxParticles * sizeof(float), particles.size() * sizeof(float), particles.stream(uploaded[i]));
+        uploadMs += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - uploadStart).count();
+
+        glm::mat4 view = glm::lookAt(cameraPos, cameraPos + cameraFront, cameraUp);
+        glfwGetFramebufferSize(win, &screenWidth, &screenHeight);
+        glm::mat4 proj = glm::perspective(glm::radians(45.f), screenHeight > 0 ? float(screenWidth) / screenHeight : 1.f, 0.1f, 200.f);
+
+        prog.UseProgram();
+        prog.setMat4("view", view);
+        prog.setMat4("proj", proj);
+        glViewport(0, 0, screenWidth, screenHeight);
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+        glBindVertexArray(vao);
+        tex.bind();
+        // added up and never hidden behind each other, so no sorting and no depth writes
+        glEnable(GL_BLEND);
+        glBlendFunc(GL_SRC_ALPHA, GL_ONE);
+        glDepthMask(GL_FALSE);
+        drawTimer.begin();
+        glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, GLsizei(particles.size()));
+        double gpuMs = drawTimer.end();
+        if (gpuMs >= 0.) {
+            drawMs += gpuMs;
+            ++drawSamples;
+        }
+        glDepthMask(GL_TRUE);
+        glDisable(GL_BLEND);
+
+        // polls different kinds of events, for example, when we close an application, it fetches that event
+        // or it fetches events like movement of the window.
+        // Without it you can neither move the window or close the window
+        glfwPollEvents();
+        // have you drawn the image, it is stored in the buffer. You can now swap this buffer with main buffer
+        // so the image appears
+        glfwSwapBuffers(win);
+
+        ++frames;
+        if (now - lastReport > 1.) {
+            lastReport = now;
+            std::printf("%zu particles: emit %.3fms, update %.3fms, compact %.3fms, upload %.3fms, draw %.3fms on the GPU\n",
+                        particles.size(), total.emit / frames, total.update / frames, total.compact / frames, uploadMs / frames,
+                        drawSamples ? drawMs / drawSamples : 0.);
+            total = ParticleTimings();
+            uploadMs = drawMs = 0.;
+            frames = drawSamples = 0;
+        }
+    }
+    glDeleteBuffers(1, &instanceVbo);
+    glDeleteBuffers(1, &vbo);
+    glDeleteVertexArrays(1, &vao);
+    glfwTerminate();
+    
+    std::cout << "Window should close now!\n";
+
+    return EXIT_SUCCESS;
+
+}
@@ -0,0 +1,32 @@
+#version 330 core
+
+// the corner of the billboard
+layout(location = 0) in vec2 aCorner;
+layout(location = 1) in vec2 aTexCoord;
+// straight from the particle arrays, one float each
+layout(location = 3) in float aX;
+layout(location = 4) in float aY;
+layout(location = 5) in float aZ;
+layout(location = 6) in float aAge;
+layout(location = 7) in float aLife;
+
+out vec2 texCoord;
+out vec2 corner;
+out float fade;
+
+uniform mat4 proj;
+uniform mat4 view;
+
+
+void main() {
+    float t = clamp(aAge / aLife, 0.0, 1.0);
+    float size = mix(0.04, 0.12, t);
+    // the rows of the view rotation are the camera's right and up in world space
+    vec3 right = vec3(view[0][0], view[1][0], view[2][0]);
+    vec3 up = vec3(view[0][1], view[1][1], view[2][1]);
+    vec3 pos = vec3(aX, aY, aZ) + (right * aCorner.x + up * aCorner.y) * size;
+    gl_Position = proj * view * vec4(pos, 1.0);
+    texCoord = aTexCoord;
+    corner = aCorner;
+    fade = 1.0 - t;
+}
@@ -0,0 +1,14 @@
+#version 330 core
+
+out vec4 FragColor;
+in vec2 texCoord;
+in vec3 normal;
+
+uniform sampler2D tex;
+// the material's color
+uniform vec4 tint;
+
+void main() {
+    float light = 0.4 + 0.6 * max(dot(normalize(normal), normalize(vec3(0.3, 1.0, 0.5))), 0.0);
+    FragColor = texture(tex, texCoord) * tint * vec4(vec3(light), 1.0);
+}
@@ -0,0 +1,995 @@
+#include <GL/glew.h>
+
+#include <GLFW/glfw3.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cstddef>
+#include <cfloat>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <glm/ext/matrix_clip_space.hpp>
+#include <glm/ext/matrix_transform.hpp>
+#include <glm/geometric.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/ext/matrix_float4x4.hpp>
+#include <glm/gtc/type_ptr.hpp>
+#include <glm/glm.hpp>
+#include <glm/trigonometric.hpp>
+#define STB_IMAGE_IMPLEMENTATION
+#include <stb/stb_image.h>
+#include <iostream>
+
+class Shader {
+    std::string src; 
+protected:
+    const char *getsrc() {
+        return src.data();
+    }
+    GLuint shader_id = 0;
+    bool isCompiled = false;
+protected:
+    virtual const char *getClassName() = 0;
+    GLint getCompilationStatus(GLuint shader_id) {
+        int status;
+        glGetShaderiv(shader_id, GL_COMPILE_STATUS, &status);
+        return status;
+    }
+    void sendError() {
+        char buffer[1024];
+        glGetShaderInfoLog(shader_id, 1024, NULL, buffer);
+        std::cerr << "ERROR::" << getClassName() << " - " << buffer;
+    }
+public:
+    virtual void compile() = 0;
+    void setSource(const char *s) {
+        std::ifstream sourceFile(s);
+        if (!sourceFile.is_open())
+            return;
+        char buffer[8192];
+        while (sourceFile.read(buffer, 8192)) {
+            src.append(buffer, 8192);
+        }
+        if (!sourceFile.eof()) {
+            src.clear();
+            return;
+        }
+        src.append(buffer, sourceFile.gcount());
+    }
+    friend class Program;
+};
+
+
+class VertexShader : public Shader {
+    virtual const char *getClassName() override {
+        return "VertexShader";
+    }
+public:
+    virtual void compile() override {
+        if (shader_id)
+            glDeleteShader(shader_id);
+        shader_id = glCreateShader(GL_VERTEX_SHADER);
+        const char *src = getsrc();
+        glShaderSource(shader_id, 1, &src, NULL);
+        glCompileShader(shader_id);
+        if (!getCompilationStatus(shader_id)) {
+            sendError();
+        }
+        isCompiled = true;
+    }
+};
+
+class FragmentShader : public Shader {
+    const char *getClassName() override {
+        return "FragmentShader";
+    }
+public:
+    virtual void compile() override {
+        if (shader_id)
+            glDeleteShader(shader_id);
+        shader_id = glCreateShader(GL_FRAGMENT_SHADER);
+        const char *src = getsrc();
+        glShaderSource(shader_id, 1, &src, NULL);
+        glCompileShader(shader_id);
+        if (!getCompilationStatus(shader_id)) {
+            sendError();
+        }
+        isCompiled = true;
+    }
+};
+
+
+class Program {
+    GLuint program_id = 0;
+    void sendError() {
+        char buffer[1024];
+        glGetProgramInfoLog(program_id, 1024, NULL, buffer);
+        std::cerr << "ERROR::PROGRAM: " << " - " << buffer;
+    }
+    bool linkStatus() {
+        int status = 0;
+        glGetProgramiv(program_id, GL_LINK_STATUS, &status);
+        return status;
+    }
+public:
+    Program() {
+        program_id = glCreateProgram();
+    }
+    ~Program() {
+        glDeleteProgram(program_id);
+    }
+    void AttachShaders(std::initializer_list<Shader*> shaders) {
+        auto i = shaders.begin();
+        while (i != shaders.end()) {
+            if (!(*i)->isCompiled)
+                (*i)->compile();
+            glAttachShader(program_id, (*i)->shader_id);
+            ++i;
+        }
+        glLinkProgram(program_id);
+        if (!linkStatus()) {
+            sendError();
+        }
+    }
+    void UseProgram() {
+        glUseProgram(program_id);
+    }
+    void setMat4(const char *locName, const glm::mat4 &mat) {
+        int location = glGetUniformLocation(program_id, locName);
+        if (location == -1)
+            return;
+        glUniformMatrix4fv(location, 1, GL_FALSE, glm::value_ptr(mat));
+    }
+    void setInt(const char *locName, int value) {
+        int location = glGetUniformLocation(program_id, locName);
+        if (location == -1)
+            return;
+        glUniform1i(location, value);
+    }
+    void setFloat(const char *locName, float value) {
+        int location = glGetUniformLocation(program_id, locName);
+        if (location == -1)
+            return;
+        glUniform1f(location, value);
+    }
+    void setVec3(const char *locName, const glm::vec3 &vec) {
+        int location = glGetUniformLocation(program_id, locName);
+        if (location == -1)
+            return;
+        glUniform3f(location, vec.x, vec.y, vec.z);
+    }
+    void setVec4(const char *locName, const glm::vec4 &vec) {
+        int location = glGetUniformLocation(program_id, locName);
+        if (location == -1)
+            return;
+        glUniform4f(location, vec.x, vec.y, vec.z, vec.w);
+    }
+};
+
+
+class Texture2D {
+    GLuint tex_id;
+public:
+    void generate2DTex(const char *image_path) {
+        int width, height, nChannels;
+        stbi_set_flip_vertically_on_load(true);
+        uint8_t *raw_image = stbi_load(image_path, &width, &height, &nChannels, 0);
+        float borderColor[] = {1.f, 1.f, 1.f, 1.f};
+        glGenTextures(1, &tex_id);
+        glBindTexture(GL_TEXTURE_2D, tex_id);
+        // what to do when primitive is bigger than the texture
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_BORDER);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_BORDER);
+        glTexParameterfv(GL_TEXTURE_2D, GL_TEXTURE_BORDER_COLOR, borderColor);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        // glTexImage2D(TARGET_TYPE, IM_MIPMAP_LEVEL, TARGET_NRCHANNELS, SRC_WIDTH, SRC_HEIGHT, LEGACY_0, SRC_NRCHANNELS, SRC_DATA_TYPE, SRC_DATA);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, width, height, 0, GL_RGB, GL_UNSIGNED_BYTE, raw_image);
+        stbi_image_free(raw_image);
+    }
+    void bind() {
+        glBindTexture(GL_TEXTURE_2D, tex_id);
+    }
+};
+
+
+// dropping the file from the page cache, so a load reads it from the disk like the first start after boot would
+void evictFromCache(const char *path) {
+    int fd = ::open(path, O_RDONLY);
+    if (fd < 0)
+        return;
+    fdatasync(fd);
+    posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+    ::close(fd);
+}
+
+
+// ---------------------------------------------------------------------------------------------------------
+// the scene as it comes from the content side: entities with a parent, a local transform, a mesh and a
+// material by name. building what the renderer needs out of that (meshes, world matrices, bounds, draws
+// grouped by mesh and material) is what startup would do every time without a snapshot
+// ---------------------------------------------------------------------------------------------------------
+
+struct Aabb {
+    glm::vec3 min = glm::vec3(0.f), max = glm::vec3(0.f);
+};
+
+Aabb transformAabb(const glm::mat4 &m, const Aabb &box) {
+    glm::vec3 center = (box.min + box.max) * 0.5f, extent = (box.max - box.min) * 0.5f;
+    glm::vec3 worldCenter = glm::vec3(m * glm::vec4(center, 1.f)), worldExtent(0.f);
+    for (int axis = 0; axis < 3; ++axis)
+        for (int i = 0; i < 3; ++i)
+            worldExtent[axis] += std::fabs(m[i][axis]) * extent[i];
+    Aabb out;
+    out.min = worldCenter - worldExtent;
+    out.max = worldCenter + worldExtent;
+    return out;
+}
+
+struct SourceEntity {
+    int32_t parent;  // -1 for none, always an earlier entity
+    glm::vec3 position, rotationAxis, scale;
+    float angle;
+    std::string mesh, material;
+};
+
+struct SourceScene {
+    std::vector<SourceEntity> entities;
+};
+
+// the lesson's scene is always generated from this seed, only the count changes
+constexpr uint32_t SCENE_SEED = 1;
+
+// a town of blocks: every 50th entity is a block that the next 49 stand on
+SourceScene generateSourceScene(size_t count, uint32_t seed) {
+    static const char *meshes[] = {"cube", "sphere", "column"};
+    static const char *materials[] = {"brick", "stone", "moss", "roof"};
+    SourceScene scene;
+    scene.entities.reserve(count);
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<float> unit(0.f, 1.f);
+    const int side = int(std::ceil(std::sqrt(count / 50.f)));
+    int32_t block = -1;
+    for (size_t i = 0; i < count; ++i) {
+        SourceEntity e;
+        if (i % 50 == 0) {
+            size_t b = i / 50;
+            e.parent = -1;
+            e.position = glm::vec3((b % side - side / 2) * 12.f, 0.f, -float(b / side) * 12.f);
+            e.rotationAxis = glm::vec3(0.f, 1.f, 0.f);
+            e.angle = unit(rng) * 0.3f;
+            e.scale = glm::vec3(10.f, 0.2f, 10.f);
+            e.mesh = "cube";
+            e.material = "stone";
+            block = int32_t(i);
+        } else {
+            // in the block's space, which is squashed, so the children undo its scale
+            e.parent = block;
+            e.position = glm::vec3(unit(rng) - 0.5f, 1.f + unit(rng) * 10.f, unit(rng) - 0.5f) * glm::vec3(0.9f, 1.f, 0.9f);
+            e.rotationAxis = glm::normalize(glm::vec3(unit(rng) - 0.5f, 1.f, unit(rng) - 0.5f));
+            e.angle = unit(rng) * 6.28f;
+            float s = 0.2f + unit(rng) * 0.6f;
+            e.scale = glm::vec3(s / 10.f, s / 0.2f, s / 10.f);
+            e.mesh = meshes[rng() % 3];
+            e.material = materials[rng() % 4];
+        }
+        scene.entities.push_back(e);
+    }
+    return scene;
+}
+
+// meshes are position, normal and texture coordinates, the same layout as the cube
+struct MeshData {
+    std::string name;
+    std::vector<float> vertices;
+    std::vector<uint32_t> indices;
+    Aabb bounds;
+};
+
+MeshData makeMesh(const std::string &name) {
+    MeshData mesh;
+    mesh.name = name;
+    const int rings = name == "sphere" ? 16 : 1, segments = name == "cube" ? 4 : 16;
+    // a cube is a 4 sided column, rotated so its sides face the axes
+    const float radius = name == "cube" ? 0.7071f : 0.5f, turn = name == "cube" ? glm::pi<float>() / 4.f : 0.f;
+    for (int r = 0; r <= rings; ++r) {
+        for (int s = 0; s <= segments; ++s) {
+            float phi = 2.f * glm::pi<float>() * s / segments + turn;
+            float y, ring, ny;
+            if (name == "sphere") {
+                float theta = glm::pi<float>() * r / rings;
+                y = 0.5f * std::cos(theta);
+                ring = std::sin(theta);
+                ny = std::cos(theta);
+            } else {
+                y = r ? 0.5f : -0.5f;
+                ring = 1.f;
+                ny = 0.f;
+            }
+            float x = std::cos(phi) * ring, z = std::sin(phi) * ring;
+            float vertex[8] = {x * radius, y, z * radius, x, ny, z, float(s) / segments, float(r) / rings};
+            mesh.vertices.insert(mesh.vertices.end(), vertex, vertex + 8);
+        }
+    }
+    for (int r = 0; r < rings; ++r) {
+        for (int s = 0; s < segments; ++s) {
+            uint32_t a = r * (segments + 1) + s, b = a + segments + 1;
+            uint32_t quad[6] = {a, b, a + 1, a + 1, b, b + 1};
+            mesh.indices.insert(mesh.indices.end(), quad, quad + 6);
+        }
+    }
+    for (size_t i = 0; i < mesh.vertices.size(); i += 8) {
+        glm::vec3 p(mesh.vertices[i], mesh.vertices[i + 1], mesh.vertices[i + 2]);
+        mesh.bounds.min = i ? glm::min(mesh.bounds.min, p) : p;
+        mesh.bounds.max = i ? glm::max(mesh.bounds.max, p) : p;
+    }
+    return mesh;
+}
+
+struct MaterialData {
+    std::string name, texture;
+    glm::vec4 color;
+};
+
+MaterialData makeMaterial(const std::string &name) {
+    if (name == "brick")
+        return {name, "./image2d.tex", glm::vec4(0.8f, 0.4f, 0.3f, 1.f)};
+    if (name == "moss")
+        return {name, "./image2d.tex", glm::vec4(0.4f, 0.7f, 0.3f, 1.f)};
+    if (name == "roof")
+        return {name, "./image2d.tex", glm::vec4(0.5f, 0.5f, 0.8f, 1.f)};
+    return {name, "./image2d.tex", glm::vec4(0.7f, 0.7f, 0.7f, 1.f)};
+}
+
+// instances of one mesh with one material, a contiguous range of entities
+struct DrawRange {
+    uint32_t mesh, material, first, count;
+};
+
+// what the renderer wants. entities are sorted by mesh and material, so each draw is one instanced call
+struct BuiltScene {
+    std::vector<MeshData> meshes;
+    std::vector<MaterialData> materials;
+    std::vector<int32_t> parents;
+    std::vector<glm::mat4> locals, worlds;
+    std::vector<Aabb> bounds;
+    std::vector<DrawRange> draws;
+    Aabb sceneBounds;
+};
+
+BuiltScene buildScene(const SourceScene &source) {
+    BuiltScene built;
+    std::unordered_map<std::string, uint32_t> meshIndex, materialIndex;
+    const size_t n = source.entities.size();
+    std::vector<uint32_t> meshOf(n), materialOf(n);
+    std::vector<glm::mat4> worlds(n), locals(n);
+    for (size_t i = 0; i < n; ++i) {
+        const SourceEntity &e = source.entities[i];
+        auto mesh = meshIndex.find(e.mesh);
+        if (mesh == meshIndex.end()) {
+            mesh = meshIndex.emplace(e.mesh, uint32_t(built.meshes.size())).first;
+            built.meshes.push_back(makeMesh(e.mesh));
+        }
+        auto material = materialIndex.find(e.material);
+        if (material == materialIndex.end()) {
+            material = materialIndex.emplace(e.material, uint32_t(built.materials.size())).first;
+            built.materials.push_back(makeMaterial(e.material));
+        }
+        meshOf[i] = mesh->second;
+        materialOf[i] = material->second;
+        locals[i] = glm::scale(glm::rotate(glm::translate(glm::mat4(1.f), e.position), e.angle, e.rotationAxis), e.scale);
+        worlds[i] = e.parent < 0 ? locals[i] : worlds[e.parent] * locals[i];
+    }
+    // grouped for drawing, parents renumbered to match
+    std::vector<uint32_t> order(n), newIndex(n);
+    for (uint32_t i = 0; i < n; ++i)
+        order[i] = i;
+    std::stable_sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) {
+        return meshOf[a] != meshOf[b] ? meshOf[a] < meshOf[b] : materialOf[a] < materialOf[b];
+    });
+    for (uint32_t i = 0; i < n; ++i)
+        newIndex[order[i]] = i;
+    built.parents.resize(n);
+    built.locals.resize(n);
+    built.worlds.resize(n);
+    built.bounds.resize(n);
+    for (uint32_t i = 0; i < n; ++i) {
+        uint32_t from = order[i];
+        int32_t parent = source.entities[from].parent;
+        built.parents[i] = parent < 0 ? -1 : int32_t(newIndex[parent]);
+        built.locals[i] = locals[from];
+        built.worlds[i] = worlds[from];
+        built.bounds[i] = transformAabb(worlds[from], built.meshes[meshOf[from]].bounds);
+        built.sceneBounds.min = i ? glm::min(built.sceneBounds.min, built.bounds[i].min) : built.bounds[i].min;
+        built.sceneBounds.max = i ? glm::max(built.sceneBounds.max, built.bounds[i].max) : built.bounds[i].max;
+        if (built.draws.empty() || built.draws.back().mesh != meshOf[from] || built.draws.back().material != materialOf[from])
+            built.draws.push_back({meshOf[from], materialOf[from], i, 0});
+        ++built.draws.back().count;
+    }
+    return built;
+}
+
+
+// ---------------------------------------------------------------------------------------------------------
+// the snapshot: a BuiltScene laid out in one file the way it sits in memory. nothing in it is a pointer,
+// every reference is an offset from where the reference itself is stored, so the file works wherever it
+// gets mapped. loading is one mmap, a check that every offset stays inside the file, and turning the
+// handful of section offsets into pointers. nothing is parsed or copied per entity
+// ---------------------------------------------------------------------------------------------------------
+
+constexpr char SNAPSHOT_MAGIC[4] = {'A', 'G', 'S', 'N'};
+constexpr uint32_t SNAPSHOT_VERSION = 2;
+constexpr size_t SNAPSHOT_ALIGNMENT = 64;
+
+// count elements starting offset bytes from this very object
+template <typename T>
+struct RelArray {
+    int64_t offset;
+    uint64_t count;
+    const T *get() const {
+        return reinterpret_cast<const T*>(reinterpret_cast<const char*>(this) + offset);
+    }
+    // inside [begin, end) and aligned for T
+    bool valid(const char *begin, const char *end) const {
+        const char *first = reinterpret_cast<const char*>(this) + offset;
+        if (first < begin || first > end || reinterpret_cast<uintptr_t>(first) % alignof(T))
+            return false;
+        return count <= uint64_t(end - first) / sizeof(T);
+    }
+};
+
+struct SnapshotMesh {
+    RelArray<char> name;
+    RelArray<float> vertices;
+    RelArray<uint32_t> indices;
+    Aabb bounds;
+};
+
+struct SnapshotMaterial {
+    RelArray<char> name, texture;
+    glm::vec4 color;
+};
+
+struct SnapshotHeader {
+    char magic[4];
+    uint32_t version;
+    uint64_t fileSize;
+    // what the source scene was generated from, a snapshot of some other scene is stale
+    uint64_t sourceEntities;
+    uint32_t sourceSeed;
+    RelArray<SnapshotMesh> meshes;
+    RelArray<SnapshotMaterial> materials;
+    RelArray<DrawRange> draws;
+    RelArray<int32_t> parents;
+    RelArray<glm::mat4> locals, worlds;
+    RelArray<Aabb> bounds;
+    Aabb sceneBounds;
+};
+
+// appends sections to a byte buffer and links RelArrays to them. positions rather than pointers, the
+// buffer moves as it grows
+class SnapshotWriter {
+    std::vector<char> bytes;
+public:
+    template <typename T>
+    size_t reserve(size_t count = 1) {
+        size_t at = (bytes.size() + SNAPSHOT_ALIGNMENT - 1) / SNAPSHOT_ALIGNMENT * SNAPSHOT_ALIGNMENT;
+        bytes.resize(at + count * sizeof(T), 0);
+        return at;
+    }
+    template <typename T>
+    T *at(size_t position) {
+        return reinterpret_cast<T*>(bytes.data() + position);
+    }
+    // field is where the RelArray is, data where its elements are
+    template <typename T>
+    void link(size_t field, size_t data, size_t count) {
+        RelArray<T> *rel = at<RelArray<T>>(field);
+        rel->offset = int64_t(data) - int64_t(field);
+        rel->count = count;
+    }
+    template <typename T>
+    void array(size_t field, const T *values, size_t count) {
+        size_t data = reserve<T>(count);
+        if (count)
+            std::memcpy(bytes.data() + data, values, count * sizeof(T));
+        link<T>(field, data, count);
+    }
+    const std::vector<char> &data() const {
+        return bytes;
+    }
+};
+
+bool writeSnapshot(const BuiltScene &scene, size_t sourceEntities, uint32_t sourceSeed, const char *path) {
+    SnapshotWriter w;
+    const size_t header = w.reserve<SnapshotHeader>();
+    const size_t meshes = w.reserve<SnapshotMesh>(scene.meshes.size());
+    const size_t materials = w.reserve<SnapshotMaterial>(scene.materials.size());
+    w.link<SnapshotMesh>(header + offsetof(SnapshotHeader, meshes), meshes, scene.meshes.size());
+    w.link<SnapshotMaterial>(header + offsetof(SnapshotHeader, materials), materials, scene.materials.size());
+    for (size_t i = 0; i < scene.meshes.size(); ++i) {
+        const MeshData &mesh = scene.meshes[i];
+        const size_t at = meshes + i * sizeof(SnapshotMesh);
+        w.array(at + offsetof(SnapshotMesh, name), mesh.name.c_str(), mesh.name.size() + 1);
+        w.array(at + offsetof(SnapshotMesh, vertices), mesh.vertices.data(), mesh.vertices.size());
+        w.array(at + offsetof(SnapshotMesh, indices), mesh.indices.data(), mesh.indices.size());
+        w.at<SnapshotMesh>(at)->bounds = mesh.bounds;
+    }
+    for (size_t i = 0; i < scene.materials.size(); ++i) {
+        const MaterialData &material = scene.materials[i];
+        const size_t at = materials + i * sizeof(SnapshotMaterial);
+        w.array(at + offsetof(SnapshotMaterial, name), material.name.c_str(), material.name.size() + 1);
+        w.array(at + offsetof(SnapshotMaterial, texture), material.texture.c_str(), material.texture.size() + 1);
+        w.at<SnapshotMaterial>(at)->color = material.color;
+    }
+    w.array(header + offsetof(SnapshotHeader, draws), scene.draws.data(), scene.draws.size());
+    w.array(header + offsetof(SnapshotHeader, parents), scene.parents.data(), scene.parents.size());
+    w.array(header + offsetof(SnapshotHeader, locals), scene.locals.data(), scene.locals.size());
+    w.array(header + offsetof(SnapshotHeader, worlds), scene.worlds.data(), scene.worlds.size());
+    w.array(header + offsetof(SnapshotHeader, bounds), scene.bounds.data(), scene.bounds.size());
+    SnapshotHeader *h = w.at<SnapshotHeader>(header);
+    std::memcpy(h->magic, SNAPSHOT_MAGIC, 4);
+    h->version = SNAPSHOT_VERSION;
+    h->fileSize = w.data().size();
+    h->sourceEntities = sourceEntities;
+    h->sourceSeed = sourceSeed;
+    h->sceneBounds = scene.sceneBounds;
+
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    out.write(w.data().data(), w.data().size());
+    out.close();
+    if (!out) {
+        std::cerr << "ERROR::SNAPSHOT - can't write " << path << "\n";
+        return false;
+    }
+    return true;
+}
+
+// a mapped snapshot. the pointers point into the mapping and are good for as long as this lives
+class SceneSnapshot {
+    void *mapping = MAP_FAILED;
+    size_t mappedSize = 0;
+
+    bool fail(const char *path, const char *why) {
+        std::cerr << "ERROR::SNAPSHOT - " << path << " " << why << "\n";
+        close();
+        return false;
+    }
+public:
+    const SnapshotHeader *header = nullptr;
+    const SnapshotMesh *meshes = nullptr;
+    const SnapshotMaterial *materials = nullptr;
+    const DrawRange *draws = nullptr;
+    const int32_t *parents = nullptr;
+    const glm::mat4 *locals = nullptr, *worlds = nullptr;
+    const Aabb *bounds = nullptr;
+    size_t entityCount = 0, meshCount = 0, materialCount = 0, drawCount = 0;
+
+    SceneSnapshot() = default;
+    SceneSnapshot(const SceneSnapshot&) = delete;
+    SceneSnapshot &operator=(const SceneSnapshot&) = delete;
+    ~SceneSnapshot() {
+        close();
+    }
+    bool open(const char *path) {
+        close();
+        int fd = ::open(path, O_RDONLY);
+        if (fd < 0)
+            return false;  // not an error, there just isn't one yet
+        struct stat st;
+        if (fstat(fd, &st) != 0 || size_t(st.st_size) < sizeof(SnapshotHeader)) {
+            ::close(fd);
+            return fail(path, "is too small to be a snapshot");
+        }
+        mappedSize = size_t(st.st_size);
+        mapping = mmap(nullptr, mappedSize, PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd);
+        if (mapping == MAP_FAILED)
+            return fail(path, "can't be mapped");
+        const char *begin = static_cast<const char*>(mapping), *end = begin + mappedSize;
+        header = reinterpret_cast<const SnapshotHeader*>(begin);
+        if (std::memcmp(header->magic, SNAPSHOT_MAGIC, 4) || header->version != SNAPSHOT_VERSION || header->fileSize != mappedSize)
+            return fail(path, "is not a snapshot of this version");
+        // the fixups. everything is checked before anything is followed
+        const SnapshotHeader &h = *header;
+        if (!h.meshes.valid(begin, end) || !h.materials.valid(begin, end) || !h.draws.valid(begin, end) || !h.parents.valid(begin, end) ||
+            !h.locals.valid(begin, end) || !h.worlds.valid(begin, end) || !h.bounds.valid(begin, end))
+            return fail(path, "has a section outside the file");
+        entityCount = h.parents.count;
+        if (h.locals.count != entityCount || h.worlds.count != entityCount || h.bounds.count != entityCount)
+            return fail(path, "has sections of different lengths");
+        meshes = h.meshes.get();
+        materials = h.materials.get();
+        draws = h.draws.get();
+        parents = h.parents.get();
+        locals = h.locals.get();
+        worlds = h.worlds.get();
+        bounds = h.bounds.get();
+        meshCount = h.meshes.count;
+        materialCount = h.materials.count;
+        drawCount = h.draws.count;
+        for (size_t i = 0; i < meshCount; ++i) {
+            const SnapshotMesh &m = meshes[i];
+            if (!m.name.valid(begin, end) || !m.vertices.valid(begin, end) || !m.indices.valid(begin, end) || !m.name.count || m.name.get()[m.name.count - 1])
+                return fail(path, "has a broken mesh");
+        }
+        for (size_t i = 0; i < materialCount; ++i) {
+            const SnapshotMaterial &m = materials[i];
+            if (!m.name.valid(begin, end) || !m.texture.valid(begin, end) || !m.name.count || !m.texture.count ||
+                m.name.get()[m.name.count - 1] || m.texture.get()[m.texture.count - 1])
+                return fail(path, "has a broken material");
+        }
+        for (size_t i = 0; i < drawCount; ++i)
+            if (draws[i].mesh >= meshCount || draws[i].material >= materialCount || draws[i].first + uint64_t(draws[i].count) > entityCount)
+                return fail(path, "has a draw outside the scene");
+        // the whole thing is going to be read front to back by the upload. madvise takes one advice at a time
+        madvise(mapping, mappedSize, MADV_SEQUENTIAL);
+        madvise(mapping, mappedSize, MADV_WILLNEED);
+        return true;
+    }
+    void close() {
+        if (mapping != MAP_FAILED)
+            munmap(mapping, mappedSize);
+        mapping = MAP_FAILED;
+        mappedSize = 0;
+        header = nullptr;
+        entityCount = meshCount = materialCount = drawCount = 0;
+    }
+    size_t bytes() const {
+        return mappedSize;
+    }
+};
+
+
+// --bench: rebuilding from the source data against mapping the snapshot, both up to the point where the
+// world matrices could be handed to GL. touching every page is part of the snapshot's time, mapping
+// alone doesn't read anything
+double touch(const void *data, size_t bytes) {
+    const volatile char *p = static_cast<const char*>(data);
+    double sum = 0.;
+    for (size_t i = 0; i < bytes; i += 4096)
+        sum += p[i];
+    return sum;
+}
+
+int runBench(size_t count, const char *path) {
+    auto now = [] { return std::chrono::steady_clock::now(); };
+    auto ms = [](auto from, auto to) { return std::chrono::duration<double, std::milli>(to - from).count(); };
+
+    auto start = now();
+    SourceScene source = generateSourceScene(count, SCENE_SEED);
+    auto generated = now();
+    BuiltScene built = buildScene(source);
+    auto builtAt = now();
+    std::printf("%zu entities, %zu meshes, %zu materials, %zu draws\n", built.worlds.size(), built.meshes.size(), built.materials.size(), built.draws.size());
+    std::printf("source data:  %8.1f ms to generate (not counted), %8.1f ms to build\n", ms(start, generated), ms(generated, builtAt));
+    if (!writeSnapshot(built, count, SCENE_SEED, path))
+        return EXIT_FAILURE;
+    auto written = now();
+
+    bool same = true;
+    for (int cold = 1; cold >= 0; --cold) {
+        if (cold)
+            evictFromCache(path);
+        auto mapStart = now();
+        SceneSnapshot snapshot;
+        if (!snapshot.open(path))
+            return EXIT_FAILURE;
+        auto mapped = now();
+        touch(snapshot.header, snapshot.bytes());
+        auto touched = now();
+        std::printf("snapshot %s: %8.3f ms to map and fix up, %8.1f ms with every page read, %.1f MB\n", cold ? "cold" : "warm",
+                    ms(mapStart, mapped), ms(mapStart, touched), snapshot.bytes() / 1e6);
+        same = same && snapshot.entityCount == built.worlds.size() &&
+               !std::memcmp(snapshot.worlds, built.worlds.data(), built.worlds.size() * sizeof(glm::mat4)) &&
+               !std::memcmp(snapshot.bounds, built.bounds.data(), built.bounds.size() * sizeof(Aabb)) &&
+               !std::memcmp(snapshot.draws, built.draws.data(), built.draws.size() * sizeof(DrawRange));
+    }
+    std::printf("writing took %.1f ms, snapshot %s the built scene\n", ms(builtAt, written), same ? "matches" : "DOES NOT match");
+    std::remove(path);
+    return same ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+
+// what drawing needs, the same whether it came from the source data or a snapshot
+struct MeshView {
+    const float *vertices;
+    size_t floatCount;
+    const uint32_t *indices;
+    size_t indexCount;
+};
+
+struct SceneView {
+    std::vector<MeshView> meshes;
+    std::vector<glm::vec4> colors;
+    const DrawRange *draws = nullptr;
+    size_t drawCount = 0;
+    const glm::mat4 *worlds = nullptr;
+    size_t entityCount = 0;
+    Aabb sceneBounds;
+};
+
+SceneView viewOf(const BuiltScene &scene) {
+    SceneView view;
+    for (const MeshData &mesh : scene.meshes)
+        view.meshes.push_back({mesh.vertices.data(), mesh.vertices.size(), mesh.indices.data(), mesh.indices.size()});
+    for (const MaterialData &material : scene.materials)
+        view.colors.push_back(material.color);
+    view.draws = scene.draws.data();
+    view.drawCount = scene.draws.size();
+    view.worlds = scene.worlds.data();
+    view.entityCount = scene.worlds.size();
+    view.sceneBounds = scene.sceneBounds;
+    return view;
+}
+
+SceneView viewOf(const SceneSnapshot &snapshot) {
+    SceneView view;
+    for (size_t i = 0; i < snapshot.meshCount; ++i) {
+        const SnapshotMesh &mesh = snapshot.meshes[i];
+        view.meshes.push_back({mesh.vertices.get(), mesh.vertices.count, mesh.indices.get(), mesh.indices.count});
+    }
+    for (size_t i = 0; i < snapshot.materialCount; ++i)
+        view.colors.push_back(snapshot.materials[i].color);
+    view.draws = snapshot.draws;
+    view.drawCount = snapshot.drawCount;
+    view.worlds = snapshot.worlds;
+    view.entityCount = snapshot.entityCount;
+    view.sceneBounds = snapshot.header->sceneBounds;
+    return view;
+}
+
+
+void processInput(GLFWwindow *window, glm::vec3 &cameraPos, glm::vec3 &cameraFront, glm::vec3 &cameraUp)
+{
+
+    const float cameraSpeed = 0.05f; // adjust accordingly
+    if (glfwGetKey(window, GLFW_KEY_W) == GLFW_PRESS)
+        cameraPos += cameraSpeed * cameraFront;
+    if (glfwGetKey(window, GLFW_KEY_S) == GLFW_PRESS)
+        cameraPos -= cameraSpeed * cameraFront;
+    if (glfwGetKey(window, GLFW_KEY_A) == GLFW_PRESS)
+        cameraPos -= glm::normalize(glm::cross(cameraFront, cameraUp)) * cameraSpeed;
+    if (glfwGetKey(window, GLFW_KEY_D) == GLFW_PRESS)
+        cameraPos += glm::normalize(glm::cross(cameraFront, cameraUp)) * cameraSpeed;
+    if (glfwGetKey(window, GLFW_KEY_UP) == GLFW_PRESS)
+        cameraPos += glm::normalize(glm::cross(cameraFront, cameraUp)) * cameraSpeed;
+
+}
+
+// true only on the frame the key went down
+bool keyPressed(GLFWwindow *window, int key) {
+    static bool down[GLFW_KEY_LAST + 1] = {};
+    bool now = glfwGetKey(window, key) == GLFW_PRESS;
+    bool pressed = now && !down[key];
+    down[key] = now;
+    return pressed;
+}
+
+
+float yaw = -90.f;
+float pitch = 0.f;
+glm::vec3 cameraFront;
+
+void mouseMovement(GLFWwindow *window, double xPos, double yPos) {
+    static float lastX = xPos, lastY = yPos;
+    float xOffset = xPos - lastX;
+    float yOffset = lastY - yPos;
+    
+    constexpr float sensitivity = 0.05f;
+    xOffset *= sensitivity;
+    yOffset *= sensitivity;
+
+    yaw += xOffset;
+    pitch += yOffset;
+
+    if (std::abs(pitch) > 89.f) // don't ever do it this way. I am lazy
+        pitch = std::abs(pitch) / pitch * 89.f;
+
+    cameraFront.x = cos(glm::radians(yaw)) * cos(glm::radians(pitch));
+    cameraFront.y = sin(glm::radians(pitch));
+    cameraFront.z = sin(glm::radians(yaw)) * cos(glm::radians(pitch));
+
+    cameraFront = glm::normalize(cameraFront);
+    lastX = xPos, lastY = yPos;
+}
+
+
+int main(int argc, char **argv) {
+    // time to first frame counts from here
+    auto programStart = std::chrono::steady_clock::now();
+    size_t entities = 1000000;
+    const char *snapshotPath = "./scene.snap";
+    bool fromSource = false;
+    for (int i = 1; i < argc; ++i) {
+        if (!std::strcmp(argv[i], "--bench"))
+            return runBench(i + 1 < argc ? size_t(std::atoll(argv[i + 1])) : entities, "./bench.snap");
+        if (!std::strcmp(argv[i], "--entities") && i + 1 < argc)
+            entities = std::max<size_t>(1, std::atoll(argv[++i]));
+        else if (!std::strcmp(argv[i], "--snapshot") && i + 1 < argc)
+            snapshotPath = argv[++i];
+        else if (!std::strcmp(argv[i], "--source"))
+            fromSource = true;
+    }
+
+    if (glfwInit() != GLFW_TRUE) {
+        glfwTerminate();
+        std::cerr << "Failed to initialize GLFW";
+        return EXIT_FAILURE;
+    }
+    // setting OpenGL version to 3.3
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+    GLFWwindow *win = glfwCreateWindow(800, 600, "This is a hello window!", NULL, NULL);
+    // setting 'context' for OpenGL, i.e. where to draw on current thread
+    glfwMakeContextCurrent(win);
+    // all it does is fetches us the implemented functions of OpenGL
+    if (glewInit() != GLEW_OK) {
+        glfwTerminate();
+        std::cerr << "Failed to initialize GLEW\n";
+        return EXIT_FAILURE;
+    }
+    int screenWidth, screenHeight;
+    glfwGetFramebufferSize(win, &screenWidth, &screenHeight);
+    glViewport(0, 0, screenWidth, screenHeight);
+
+    glEnable(GL_DEPTH_TEST);
+
+    glm::vec3 cameraPos(0.f, 0.f, 3.f);
+    cameraFront = glm::vec3(0.f,0.f,-1.f);
+    glm::vec3 cameraUp(0.,1.,0.f);
+
+    Texture2D tex;
+    tex.generate2DTex("./image2d.tex");
+    tex.bind();
+
+    // the snapshot if there's a good one, otherwise the scene is built from the source data and a snapshot
+    // written for next time
+    SceneSnapshot snapshot;
+    BuiltScene built;
+    SceneView scene;
+    auto loadStart = std::chrono::steady_clock::now();
+    bool mapped = !fromSource && snapshot.open(snapshotPath);
+    if (mapped && (snapshot.header->sourceEntities != entities || snapshot.header->sourceSeed != SCENE_SEED)) {
+        std::cout << snapshotPath << " is of a different scene (" << snapshot.header->sourceEntities << " entities), rebuilding it\n";
+        snapshot.close();
+        mapped = false;
+    }
+    if (mapped) {
+        scene = viewOf(snapshot);
+        std::cout << "mapped " << snapshotPath << ", " << snapshot.bytes() / 1000000 << "MB\n";
+    } else {
+        built = buildScene(generateSourceScene(entities, SCENE_SEED));
+        scene = viewOf(built);
+        std::cout << "built the scene from source data\n";
+        if (!fromSource && writeSnapshot(built, entities, SCENE_SEED, snapshotPath))
+            std::cout << "wrote " << snapshotPath << "\n";
+    }
+    double loadMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - loadStart).count();
+    std::cout << scene.entityCount << " entities in " << scene.drawCount << " draws, loaded in " << loadMs << "ms\n";
+
+    // all the meshes in one vertex and one index buffer, each draw picks its mesh with a base vertex
+    std::vector<GLint> baseVertex(scene.meshes.size());
+    std::vector<size_t> firstIndex(scene.meshes.size());
+    size_t vertexFloats = 0, indexCount = 0;
+    for (size_t i = 0; i < scene.meshes.size(); ++i) {
+        baseVertex[i] = GLint(vertexFloats / 8);
+        firstIndex[i] = indexCount;
+        vertexFloats += scene.meshes[i].floatCount;
+        indexCount += scene.meshes[i].indexCount;
+    }
+
+    GLuint vao = 0;
+    glGenVertexArrays(1, &vao);
+    glBindVertexArray(vao);
+
+    GLuint vbo = 0, ebo = 0;
+    glGenBuffers(1, &vbo); 
+    glBindBuffer(GL_ARRAY_BUFFER, vbo);
+    glBufferData(GL_ARRAY_BUFFER, vertexFloats * sizeof(float), NULL, GL_STATIC_DRAW);
+    glGenBuffers(1, &ebo);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ebo);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, indexCount * sizeof(uint32_t), NULL, GL_STATIC_DRAW);
+    for (size_t i = 0; i < scene.meshes.size(); ++i) {
+        const MeshView &mesh = scene.meshes[i];
+        glBufferSubData(GL_ARRAY_BUFFER, baseVertex[i] * 8 * sizeof(float), mesh.floatCount * sizeof(float), mesh.vertices);
+        glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, firstIndex[i] * sizeof(uint32_t), mesh.indexCount * sizeof(uint32_t), mesh.indices);
+    }
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)0);
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)(6 * sizeof(float)));
+    glEnableVertexAttribArray(1);
+    glVertexAttribPointer(2, 3, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)(3 * sizeof(float)));
+    glEnableVertexAttribArray(2);
+
+    // the world matrices go up straight from the mapping. a draw points the instance attributes at its range
+    GLuint instanceVbo = 0;
+    glGenBuffers(1, &instanceVbo);
+    glBindBuffer(GL_ARRAY_BUFFER, instanceVbo);
+    glBufferData(GL_ARRAY_BUFFER, scene.entityCount * sizeof(glm::mat4), scene.worlds, GL_STATIC_DRAW);
+    for (int column = 0; column < 4; ++column) {
+        glEnableVertexAttribArray(3 + column);
+        glVertexAttribDivisor(3 + column, 1);
+    }
+
+    VertexShader vs;
+    FragmentShader fs;
+    vs.setSource("./vertex.glsl");
+    fs.setSource("./frag.glsl");
+    Program prog;
+    prog.AttachShaders({&vs, &fs});
+
+    prog.UseProgram();
+    prog.setInt("tex", 0);
+
+    // start above the middle of the town, looking along it
+    glm::vec3 center = (scene.sceneBounds.min + scene.sceneBounds.max) * 0.5f;
+    cameraPos = glm::vec3(center.x, scene.sceneBounds.max.y + 20.f, scene.sceneBounds.max.z + 20.f);
+
+    glfwSetCursorPosCallback(win, mouseMovement); 
+    glfwSetInputMode(win, GLFW_CURSOR, GLFW_CURSOR_DISABLED);  
+
+    bool firstFrame = true;
+    
+    while (!glfwWindowShouldClose(win)) {
+        processInput(win, cameraPos, cameraFront, cameraUp);
+
+        glm::mat4 view = glm::lookAt(cameraPos, cameraPos + cameraFront, cameraUp);
+        glfwGetFramebufferSize(win, &screenWidth, &screenHeight);
+        glm::mat4 proj = glm::perspective(glm::radians(45.f), screenHeight > 0 ? float(screenWidth) / screenHeight : 1.f, 0.1f, 2000.f);
+
+        prog.UseProgram();
+        prog.setMat4("view", view);
+        prog.setMat4("proj", proj);
+        glViewport(0, 0, screenWidth, screenHeight);
+        glClearColor(0.55f, 0.7f, 0.85f, 1.f);
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+        glBindVertexArray(vao);
+        glBindBuffer(GL_ARRAY_BUFFER, instanceVbo);
+        tex.bind();
+        for (size_t i = 0; i < scene.drawCount; ++i) {
+            const DrawRange &draw = scene.draws[i];
+            for (int column = 0; column < 4; ++column)
+                glVertexAttribPointer(3 + column, 4, GL_FLOAT, GL_FALSE, sizeof(glm::mat4),
+                                      (void*)(draw.first * sizeof(glm::mat4) + column * sizeof(glm::vec4)));
+            prog.setVec4("tint", scene.colors[draw.material]);
+            glDrawElementsInstancedBaseVertex(GL_TRIANGLES, GLsizei(scene.meshes[draw.mesh].indexCount), GL_UNSIGNED_INT,
+                                              (void*)(firstIndex[draw.mesh] * sizeof(uint32_t)), GLsizei(draw.count), baseVertex[draw.mesh]);
+        }
+
+        // polls different kinds of events, for example, when we close an application, it fetches that event
+        // or it fetches events like movement of the window.
+        // Without it you can neither move the window or close the window
+        glfwPollEvents();
+        // have you drawn the image, it is stored in the buffer. You can now swap this buffer with main buffer
+        // so the image appears
+        glfwSwapBuffers(win);
+
+        if (firstFrame) {
+            // glFinish so the upload is really done, not just queued
+            glFinish();
+            std::cout << "time to first frame: "
+                      << std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - programStart).count() << "ms\n";
+            firstFrame = false;
+        }
+    }
+    glDeleteBuffers(1, &instanceVbo);
+    glDeleteBuffers(1, &ebo);
+    glDeleteBuffers(1, &vbo);
+    glfwTerminate();
+    
+    std::cout << "Window should close now!\n";
+
+    return EXIT_SUCCESS;
+
+}
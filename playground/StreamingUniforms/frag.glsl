@@ -0,0 +1,31 @@
+#version 330 core
+
+out vec4 FragColor;
+in vec2 texCoord;
+in vec3 worldPos;
+in vec3 worldNormal;
+
+uniform sampler2D tex;
+
+layout(std140) uniform FrameData {
+    mat4 view;
+    mat4 proj;
+    vec4 cameraPosTime;
+};
+
+layout(std140) uniform DrawData {
+    mat4 model;
+    mat4 normalMatrix;
+    vec4 color;
+    vec4 params;
+};
+
+void main() {
+    vec3 n = normalize(worldNormal);
+    vec3 l = normalize(vec3(0.4, 1.0, 0.3));
+    vec3 v = normalize(cameraPosTime.xyz - worldPos);
+    float spec = pow(max(dot(n, normalize(l + v)), 0.0), params.x);
+    float pulse = 0.85 + 0.15 * sin(cameraPosTime.w * 3.0 + params.y);
+    vec3 albedo = texture(tex, texCoord).rgb * color.rgb * pulse;
+    FragColor = vec4(albedo * (0.2 + 0.8 * max(dot(n, l), 0.0)) + vec3(0.3 * spec), 1.0);
+}
@@ -0,0 +1,796 @@
+#include <GL/glew.h>
+
+#include <GLFW/glfw3.h>
+#include <algorithm>
+#include <cfloat>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <vector>
+#include <glm/ext/matrix_clip_space.hpp>
+#include <glm/ext/matrix_transform.hpp>
+#include <glm/geometric.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/ext/matrix_float4x4.hpp>
+#include <glm/gtc/type_ptr.hpp>
+#include <glm/glm.hpp>
+#include <glm/trigonometric.hpp>
+#define STB_IMAGE_IMPLEMENTATION
+#include <stb/stb_image.h>
+#include <iostream>
+
+class Shader {
+    std::string src; 
+protected:
+    const char *getsrc() {
+        return src.data();
+    }
+    GLuint shader_id = 0;
+    bool isCompiled = false;
+protected:
+    virtual const char *getClassName() = 0;
+    GLint getCompilationStatus(GLuint shader_id) {
+        int status;
+        glGetShaderiv(shader_id, GL_COMPILE_STATUS, &status);
+        return status;
+    }
+    void sendError() {
+        char buffer[1024];
+        glGetShaderInfoLog(shader_id, 1024, NULL, buffer);
+        std::cerr << "ERROR::" << getClassName() << " - " << buffer;
+    }
+public:
+    virtual void compile() = 0;
+    void setSource(const char *s) {
+        std::ifstream sourceFile(s);
+        if (!sourceFile.is_open())
+            return;
+        char buffer[8192];
+        while (sourceFile.read(buffer, 8192)) {
+            src.append(buffer, 8192);
+        }
+        if (!sourceFile.eof()) {
+            src.clear();
+            return;
+        }
+        src.append(buffer, sourceFile.gcount());
+    }
+    friend class Program;
+};
+
+
+class VertexShader : public Shader {
+    virtual const char *getClassName() override {
+        return "VertexShader";
+    }
+public:
+    virtual void compile() override {
+        if (shader_id)
+            glDeleteShader(shader_id);
+        shader_id = glCreateShader(GL_VERTEX_SHADER);
+        const char *src = getsrc();
+        glShaderSource(shader_id, 1, &src, NULL);
+        glCompileShader(shader_id);
+        if (!getCompilationStatus(shader_id)) {
+            sendError();
+        }
+        isCompiled = true;
+    }
+};
+
+class FragmentShader : public Shader {
+    const char *getClassName() override {
+        return "FragmentShader";
+    }
+public:
+    virtual void compile() override {
+        if (shader_id)
+            glDeleteShader(shader_id);
+        shader_id = glCreateShader(GL_FRAGMENT_SHADER);
+        const char *src = getsrc();
+        glShaderSource(shader_id, 1, &src, NULL);
+        glCompileShader(shader_id);
+        if (!getCompilationStatus(shader_id)) {
+            sendError();
+        }
+        isCompiled = true;
+    }
+};
+
+
+class Program {
+    GLuint program_id = 0;
+    void sendError() {
+        char buffer[1024];
+        glGetProgramInfoLog(program_id, 1024, NULL, buffer);
+        std::cerr << "ERROR::PROGRAM: " << " - " << buffer;
+    }
+    bool linkStatus() {
+        int status = 0;
+        glGetProgramiv(program_id, GL_LINK_STATUS, &status);
+        return status;
+    }
+public:
+    // GL calls made by the setters below, a glGetUniformLocation and a glUniform* each
+    static inline size_t uniformCalls = 0;
+
+    Program() {
+        program_id = glCreateProgram();
+    }
+    ~Program() {
+        glDeleteProgram(program_id);
+    }
+    void AttachShaders(std::initializer_list<Shader*> shaders) {
+        auto i = shaders.begin();
+        while (i != shaders.end()) {
+            if (!(*i)->isCompiled)
+                (*i)->compile();
+            glAttachShader(program_id, (*i)->shader_id);
+            ++i;
+        }
+        glLinkProgram(program_id);
+        if (!linkStatus()) {
+            sendError();
+        }
+    }
+    void UseProgram() {
+        glUseProgram(program_id);
+    }
+    void setMat4(const char *locName, const glm::mat4 &mat) {
+        int location = glGetUniformLocation(program_id, locName);
+        if (location == -1) {
+            ++uniformCalls;
+            return;
+        }
+        glUniformMatrix4fv(location, 1, GL_FALSE, glm::value_ptr(mat));
+        uniformCalls += 2;
+    }
+    void setInt(const char *locName, int value) {
+        int location = glGetUniformLocation(program_id, locName);
+        if (location == -1) {
+            ++uniformCalls;
+            return;
+        }
+        glUniform1i(location, value);
+        uniformCalls += 2;
+    }
+    void setFloat(const char *locName, float value) {
+        int location = glGetUniformLocation(program_id, locName);
+        if (location == -1) {
+            ++uniformCalls;
+            return;
+        }
+        glUniform1f(location, value);
+        uniformCalls += 2;
+    }
+    void setVec3(const char *locName, const glm::vec3 &vec) {
+        int location = glGetUniformLocation(program_id, locName);
+        if (location == -1) {
+            ++uniformCalls;
+            return;
+        }
+        glUniform3f(location, vec.x, vec.y, vec.z);
+        uniformCalls += 2;
+    }
+    void setVec4(const char *locName, const glm::vec4 &vec) {
+        int location = glGetUniformLocation(program_id, locName);
+        if (location == -1) {
+            ++uniformCalls;
+            return;
+        }
+        glUniform4f(location, vec.x, vec.y, vec.z, vec.w);
+        uniformCalls += 2;
+    }
+    // GL 3.3 has no layout(binding = n) for blocks, so the binding point is set from here
+    void bindUniformBlock(const char *blockName, GLuint binding) {
+        GLuint index = glGetUniformBlockIndex(program_id, blockName);
+        if (index == GL_INVALID_INDEX) {
+            std::cerr << "ERROR::PROGRAM - no uniform block " << blockName << "\n";
+            return;
+        }
+        glUniformBlockBinding(program_id, index, binding);
+    }
+};
+
+
+class Texture2D {
+    GLuint tex_id;
+public:
+    void generate2DTex(const char *image_path) {
+        int width, height, nChannels;
+        stbi_set_flip_vertically_on_load(true);
+        uint8_t *raw_image = stbi_load(image_path, &width, &height, &nChannels, 0);
+        float borderColor[] = {1.f, 1.f, 1.f, 1.f};
+        glGenTextures(1, &tex_id);
+        glBindTexture(GL_TEXTURE_2D, tex_id);
+        // what to do when primitive is bigger than the texture
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_BORDER);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_BORDER);
+        glTexParameterfv(GL_TEXTURE_2D, GL_TEXTURE_BORDER_COLOR, borderColor);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        // glTexImage2D(TARGET_TYPE, IM_MIPMAP_LEVEL, TARGET_NRCHANNELS, SRC_WIDTH, SRC_HEIGHT, LEGACY_0, SRC_NRCHANNELS, SRC_DATA_TYPE, SRC_DATA);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, width, height, 0, GL_RGB, GL_UNSIGNED_BYTE, raw_image);
+        stbi_image_free(raw_image);
+    }
+    void bind() {
+        glBindTexture(GL_TEXTURE_2D, tex_id);
+    }
+};
+
+
+// GPU time of a stretch of commands, without waiting for it. there are a few queries in flight and
+// we only read the one that was issued QUERIES frames ago, which has long finished by then
+class GpuTimer {
+    static constexpr int QUERIES = 4;
+    GLuint queries[QUERIES] = {};
+    int frame = 0;
+public:
+    GpuTimer() {
+        glGenQueries(QUERIES, queries);
+    }
+    ~GpuTimer() {
+        glDeleteQueries(QUERIES, queries);
+    }
+    void begin() {
+        glBeginQuery(GL_TIME_ELAPSED, queries[frame % QUERIES]);
+    }
+    // returns the milliseconds of an older frame, or a negative value if there is none yet
+    double end() {
+        glEndQuery(GL_TIME_ELAPSED);
+        ++frame;
+        if (frame < QUERIES)
+            return -1.;
+        GLuint oldest = queries[frame % QUERIES];
+        GLint available = 0;
+        glGetQueryObjectiv(oldest, GL_QUERY_RESULT_AVAILABLE, &available);
+        if (!available)
+            return -1.;
+        GLuint64 ns = 0;
+        glGetQueryObjectui64v(oldest, GL_QUERY_RESULT, &ns);
+        return ns / 1e6;
+    }
+};
+
+
+// ---------------------------------------------------------------------------------------------------------
+// uniforms through buffers. what every draw shares sits in one small block that is written once a frame and
+// bound once. what belongs to a single draw is copied into a big ring buffer and picked with one
+// glBindBufferRange per draw, instead of a glGetUniformLocation and glUniform* per value
+// ---------------------------------------------------------------------------------------------------------
+
+// both blocks are std140 in the shaders, so vec3s are padded out to vec4 here
+struct FrameUniforms {
+    glm::mat4 view;
+    glm::mat4 proj;
+    glm::vec4 cameraPosTime;  // xyz camera position, w seconds
+};
+
+struct DrawUniforms {
+    glm::mat4 model;
+    glm::mat4 normalMatrix;
+    glm::vec4 color;
+    glm::vec4 params;  // x shininess, y pulse phase
+};
+
+enum UniformBinding : GLuint {
+    FRAME_BINDING = 0,
+    DRAW_BINDING = 1
+};
+
+
+// the shared per frame block
+class FrameUniformBuffer {
+    GLuint ubo_id = 0;
+public:
+    size_t calls = 0;
+
+    FrameUniformBuffer() {
+        glGenBuffers(1, &ubo_id);
+        glBindBuffer(GL_UNIFORM_BUFFER, ubo_id);
+        glBufferData(GL_UNIFORM_BUFFER, sizeof(FrameUniforms), NULL, GL_DYNAMIC_DRAW);
+        // stays bound for good, every program reads its FrameData block from here
+        glBindBufferBase(GL_UNIFORM_BUFFER, FRAME_BINDING, ubo_id);
+    }
+    ~FrameUniformBuffer() {
+        glDeleteBuffers(1, &ubo_id);
+    }
+    FrameUniformBuffer(const FrameUniformBuffer&) = delete;
+    FrameUniformBuffer &operator=(const FrameUniformBuffer&) = delete;
+    void update(const FrameUniforms &frame) {
+        glBindBuffer(GL_UNIFORM_BUFFER, ubo_id);
+        glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(frame), &frame);
+        calls += 2;
+    }
+};
+
+
+// one buffer split in FRAMES parts, each frame writes into the next part. a part is only written again once
+// the fence placed after the frame that used it has signaled, so the GPU never reads something half
+// overwritten, and the mapping is unsynchronized so the driver doesn't wait for anything either
+class UniformRing {
+public:
+    static constexpr int FRAMES = 3;
+private:
+    GLuint ubo_id = 0;
+    GLsync fences[FRAMES] = {};
+    size_t partSize;
+    size_t alignment = 256;
+    int part = 0;
+    size_t head = 0;
+    char *mapped = nullptr;
+    bool full = false;
+public:
+    // calls: GL calls made, stalls: frames that had to wait for the GPU to let go of their part
+    size_t calls = 0, stalls = 0, overflows = 0;
+
+    explicit UniformRing(size_t partSize) : partSize(partSize) {
+        // glBindBufferRange offsets have to be multiples of this, 256 on most desktop GPUs
+        GLint align = 0;
+        glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &align);
+        if (align > 0)
+            alignment = align;
+        this->partSize = (partSize + alignment - 1) / alignment * alignment;
+        glGenBuffers(1, &ubo_id);
+        glBindBuffer(GL_UNIFORM_BUFFER, ubo_id);
+        glBufferData(GL_UNIFORM_BUFFER, FRAMES * this->partSize, NULL, GL_STREAM_DRAW);
+    }
+    ~UniformRing() {
+        for (GLsync fence : fences)
+            if (fence)
+                glDeleteSync(fence);
+        glDeleteBuffers(1, &ubo_id);
+    }
+    UniformRing(const UniformRing&) = delete;
+    UniformRing &operator=(const UniformRing&) = delete;
+
+    size_t stride(size_t size) const {
+        return (size + alignment - 1) / alignment * alignment;
+    }
+    // maps this frame's part. waits only if the GPU is FRAMES frames behind
+    void begin() {
+        if (GLsync fence = fences[part]) {
+            if (glClientWaitSync(fence, 0, 0) == GL_TIMEOUT_EXPIRED) {
+                ++stalls;
+                glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000000);
+            }
+            glDeleteSync(fence);
+            fences[part] = nullptr;
+            calls += 2;
+        }
+        glBindBuffer(GL_UNIFORM_BUFFER, ubo_id);
+        mapped = static_cast<char*>(glMapBufferRange(GL_UNIFORM_BUFFER, part * partSize, partSize,
+            GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_UNSYNCHRONIZED_BIT | GL_MAP_FLUSH_EXPLICIT_BIT));
+        calls += 2;
+        head = 0;
+        full = false;
+        if (!mapped)
+            std::cerr << "ERROR::UNIFORM_RING - glMapBufferRange failed\n";
+    }
+    // copies data into the ring and returns its offset in the buffer, or -1 when this frame's part is full
+    GLintptr push(const void *data, size_t size) {
+        if (!mapped || head + size > partSize) {
+            if (!full)
+                ++overflows;
+            full = true;
+            return -1;
+        }
+        std::memcpy(mapped + head, data, size);
+        GLintptr offset = part * partSize + head;
+        head += stride(size);
+        return offset;
+    }
+    template<typename T>
+    GLintptr push(const T &data) {
+        return push(&data, sizeof(T));
+    }
+    // hands what was written to GL, call before drawing with it
+    void end() {
+        if (!mapped)
+            return;
+        glFlushMappedBufferRange(GL_UNIFORM_BUFFER, 0, std::min(head, partSize));
+        glUnmapBuffer(GL_UNIFORM_BUFFER);
+        mapped = nullptr;
+        calls += 2;
+    }
+    void bind(GLuint binding, GLintptr offset, size_t size) {
+        glBindBufferRange(GL_UNIFORM_BUFFER, binding, ubo_id, offset, size);
+        ++calls;
+    }
+    // after the last draw reading this part
+    void finishFrame() {
+        fences[part] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        ++calls;
+        part = (part + 1) % FRAMES;
+    }
+};
+
+
+struct SceneObject {
+    glm::vec3 pos;
+    glm::vec3 axis;
+    float spin;
+    glm::vec4 color;
+    glm::vec4 params;
+};
+
+std::vector<SceneObject> buildScene(int side) {
+    std::vector<SceneObject> objects;
+    for (int z = 0; z < side; ++z) {
+        for (int x = 0; x < side; ++x) {
+            SceneObject o;
+            o.pos = glm::vec3((x - side * 0.5f) * 1.5f, std::sin(x * 0.4f) * std::cos(z * 0.3f), -z * 1.5f - 3.f);
+            o.axis = glm::normalize(glm::vec3(std::sin(x * 1.3f) + 0.1f, 1.f, std::cos(z * 0.7f)));
+            o.spin = 0.3f + 0.05f * ((x * 7 + z * 13) % 17);
+            o.color = glm::vec4(0.5f + 0.5f * std::sin(x * 0.3f), 0.5f + 0.5f * std::sin(z * 0.2f + 2.f), 0.5f + 0.5f * std::sin((x + z) * 0.1f + 4.f), 1.f);
+            o.params = glm::vec4(8.f + (x + z) % 56, (x * 31 + z * 17) % 100 * 0.0628f, 0.f, 0.f);
+            objects.push_back(o);
+        }
+    }
+    return objects;
+}
+
+void objectUniforms(const SceneObject &o, float time, DrawUniforms &out) {
+    out.model = glm::rotate(glm::translate(glm::mat4(1.f), o.pos), time * o.spin, o.axis);
+    out.normalMatrix = glm::transpose(glm::inverse(out.model));
+    out.color = o.color;
+    out.params = o.params;
+}
+
+// the old way: every value through Program's setters
+void drawWithUniforms(Program &prog, const std::vector<SceneObject> &objects, const FrameUniforms &frame, float time) {
+    prog.UseProgram();
+    prog.setMat4("view", frame.view);
+    prog.setMat4("proj", frame.proj);
+    prog.setVec4("cameraPosTime", frame.cameraPosTime);
+    DrawUniforms draw;
+    for (const SceneObject &o : objects) {
+        objectUniforms(o, time, draw);
+        prog.setMat4("model", draw.model);
+        prog.setMat4("normalMatrix", draw.normalMatrix);
+        prog.setVec4("color", draw.color);
+        prog.setVec4("params", draw.params);
+        glDrawArrays(GL_TRIANGLES, 0, 36);
+    }
+}
+
+// the new way: write everything first, then one range bind per draw
+void drawWithRing(Program &prog, UniformRing &ring, FrameUniformBuffer &frameBuffer, const std::vector<SceneObject> &objects,
+                  const FrameUniforms &frame, float time, std::vector<GLintptr> &offsets) {
+    frameBuffer.update(frame);
+    ring.begin();
+    offsets.resize(objects.size());
+    DrawUniforms draw;
+    for (size_t i = 0; i < objects.size(); ++i) {
+        objectUniforms(objects[i], time, draw);
+        offsets[i] = ring.push(draw);
+    }
+    ring.end();
+    prog.UseProgram();
+    for (size_t i = 0; i < objects.size(); ++i) {
+        if (offsets[i] < 0)
+            break;  // the part was too small, the rest of the objects don't get drawn this frame
+        ring.bind(DRAW_BINDING, offsets[i], sizeof(DrawUniforms));
+        glDrawArrays(GL_TRIANGLES, 0, 36);
+    }
+    ring.finishFrame();
+}
+
+
+void processInput(GLFWwindow *window, glm::vec3 &cameraPos, glm::vec3 &cameraFront, glm::vec3 &cameraUp)
+{
+
+    const float cameraSpeed = 0.05f; // adjust accordingly
+    if (glfwGetKey(window, GLFW_KEY_W) == GLFW_PRESS)
+        cameraPos += cameraSpeed * cameraFront;
+    if (glfwGetKey(window, GLFW_KEY_S) == GLFW_PRESS)
+        cameraPos -= cameraSpeed * cameraFront;
+    if (glfwGetKey(window, GLFW_KEY_A) == GLFW_PRESS)
+        cameraPos -= glm::normalize(glm::cross(cameraFront, cameraUp)) * cameraSpeed;
+    if (glfwGetKey(window, GLFW_KEY_D) == GLFW_PRESS)
+        cameraPos += glm::normalize(glm::cross(cameraFront, cameraUp)) * cameraSpeed;
+    if (glfwGetKey(window, GLFW_KEY_UP) == GLFW_PRESS)
+        cameraPos += glm::normalize(glm::cross(cameraFront, cameraUp)) * cameraSpeed;
+
+}
+
+// true only on the frame the key went down
+bool keyPressed(GLFWwindow *window, int key) {
+    static bool down[GLFW_KEY_LAST + 1] = {};
+    bool now = glfwGetKey(window, key) == GLFW_PRESS;
+    bool pressed = now && !down[key];
+    down[key] = now;
+    return pressed;
+}
+
+
+float yaw = -90.f;
+float pitch = 0.f;
+glm::vec3 cameraFront;
+
+void mouseMovement(GLFWwindow *window, double xPos, double yPos) {
+    static float lastX = xPos, lastY = yPos;
+    float xOffset = xPos - lastX;
+    float yOffset = lastY - yPos;
+    
+    constexpr float sensitivity = 0.05f;
+    xOffset *= sensitivity;
+    yOffset *= sensitivity;
+
+    yaw += xOffset;
+    pitch += yOffset;
+
+    if (std::abs(pitch) > 89.f) // don't ever do it this way. I am lazy
+        pitch = std::abs(pitch) / pitch * 89.f;
+
+    cameraFront.x = cos(glm::radians(yaw)) * cos(glm::radians(pitch));
+    cameraFront.y = sin(glm::radians(pitch));
+    cameraFront.z = sin(glm::radians(yaw)) * cos(glm::radians(pitch));
+
+    cameraFront = glm::normalize(cameraFront);
+    lastX = xPos, lastY = yPos;
+}
+
+
+// ./main --bench [cubes per side]
+// draws the same scene both ways in a hidden window without vsync, and reports GL calls for uniforms, CPU and
+// GPU time per frame. also reads back one frame of each and checks they came out the same
+int runBenchmark(GLFWwindow *win, Program &uniformProg, Program &blockProg, int side) {
+    constexpr int FRAMES = 300;
+    std::vector<SceneObject> objects = buildScene(side);
+    UniformRing ring(objects.size() * sizeof(DrawUniforms) * 4);
+    FrameUniformBuffer frameBuffer;
+    std::vector<GLintptr> offsets;
+    FrameUniforms frame;
+    frame.view = glm::lookAt(glm::vec3(0.f, 12.f, 10.f), glm::vec3(0.f, 0.f, -side * 0.75f), glm::vec3(0.f, 1.f, 0.f));
+    frame.proj = glm::perspective(glm::radians(45.f), 800 / 600.f, 0.1f, 200.f);
+    frame.cameraPosTime = glm::vec4(0.f, 12.f, 10.f, 0.f);
+    std::cout << objects.size() << " cubes, " << sizeof(DrawUniforms) << " bytes of uniforms each, "
+              << ring.stride(sizeof(DrawUniforms)) << " with alignment\n";
+
+    std::vector<uint8_t> images[2];
+    for (int ringPath = 0; ringPath < 2; ++ringPath) {
+        GpuTimer timer;
+        double cpuMs = 0., gpuMs = 0.;
+        int gpuSamples = 0;
+        size_t calls = 0;
+        for (int i = 0; i < FRAMES; ++i) {
+            float time = i / 60.f;
+            frame.cameraPosTime.w = time;
+            glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+            size_t before = Program::uniformCalls + ring.calls + frameBuffer.calls;
+            auto start = std::chrono::steady_clock::now();
+            timer.begin();
+            if (ringPath)
+                drawWithRing(blockProg, ring, frameBuffer, objects, frame, time, offsets);
+            else
+                drawWithUniforms(uniformProg, objects, frame, time);
+            double ms = timer.end();
+            cpuMs += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+            calls += Program::uniformCalls + ring.calls + frameBuffer.calls - before;
+            if (ms >= 0.) {
+                gpuMs += ms;
+                ++gpuSamples;
+            }
+            glfwSwapBuffers(win);
+            glfwPollEvents();
+        }
+        // one more at a fixed time to compare
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+        frame.cameraPosTime.w = 1.f;
+        if (ringPath)
+            drawWithRing(blockProg, ring, frameBuffer, objects, frame, 1.f, offsets);
+        else
+            drawWithUniforms(uniformProg, objects, frame, 1.f);
+        images[ringPath].resize(800 * 600 * 4);
+        glReadPixels(0, 0, 800, 600, GL_RGBA, GL_UNSIGNED_BYTE, images[ringPath].data());
+
+        std::cout << (ringPath ? "uniform ring:      " : "glUniform per draw: ") << double(calls) / FRAMES << " uniform calls, "
+                  << cpuMs / FRAMES << "ms cpu, " << (gpuSamples ? gpuMs / gpuSamples : 0.) << "ms gpu per frame";
+        if (ringPath)
+            std::cout << ", " << ring.stalls << " stalls, " << ring.overflows << " overflows";
+        std::cout << "\n";
+    }
+    size_t different = 0;
+    for (size_t i = 0; i < images[0].size(); ++i)
+        different += std::abs(int(images[0][i]) - int(images[1][i])) > 1;
+    std::cout << (different ? "images DIFFER in " : "images match, ") << different << " channels\n";
+    return different ? EXIT_FAILURE : EXIT_SUCCESS;
+}
+
+
+int main(int argc, char **argv) {
+    const bool bench = argc > 1 && !std::strcmp(argv[1], "--bench");
+
+    if (glfwInit() != GLFW_TRUE) {
+        glfwTerminate();
+        std::cerr << "Failed to initialize GLFW";
+        return EXIT_FAILURE;
+    }
+    // setting OpenGL version to 3.3
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+    if (bench)
+        glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+    GLFWwindow *win = glfwCreateWindow(800, 600, "This is a hello window!", NULL, NULL);
+    // setting 'context' for OpenGL, i.e. where to draw on current thread
+    glfwMakeContextCurrent(win);
+    // all it does is fetches us the implemented functions of OpenGL
+    if (glewInit() != GLEW_OK) {
+        glfwTerminate();
+        std::cerr << "Failed to initialize GLEW\n";
+        return EXIT_FAILURE;
+    }
+    // we want the real cost of a frame, not the vsync interval
+    glfwSwapInterval(0);
+    int screenWidth, screenHeight;
+    glfwGetFramebufferSize(win, &screenWidth, &screenHeight);
+    glViewport(0, 0, screenWidth, screenHeight);
+
+    glEnable(GL_DEPTH_TEST);
+    float triangle_data[] = {
+        //   vertpos   //  //   normal   //  //texcord//
+    -0.5f, -0.5f, -0.5f,  0.0f,  0.0f, -1.0f,  0.0f, 0.0f,
+     0.5f, -0.5f, -0.5f,  0.0f,  0.0f, -1.0f,  1.0f, 0.0f,
+     0.5f,  0.5f, -0.5f,  0.0f,  0.0f, -1.0f,  1.0f, 1.0f,
+     0.5f,  0.5f, -0.5f,  0.0f,  0.0f, -1.0f,  1.0f, 1.0f,
+    -0.5f,  0.5f, -0.5f,  0.0f,  0.0f, -1.0f,  0.0f, 1.0f,
+    -0.5f, -0.5f, -0.5f,  0.0f,  0.0f, -1.0f,  0.0f, 0.0f,
+
+    -0.5f, -0.5f,  0.5f,  0.0f,  0.0f,  1.0f,  0.0f, 0.0f,
+     0.5f, -0.5f,  0.5f,  0.0f,  0.0f,  1.0f,  1.0f, 0.0f,
+     0.5f,  0.5f,  0.5f,  0.0f,  0.0f,  1.0f,  1.0f, 1.0f,
+     0.5f,  0.5f,  0.5f,  0.0f,  0.0f,  1.0f,  1.0f, 1.0f,
+    -0.5f,  0.5f,  0.5f,  0.0f,  0.0f,  1.0f,  0.0f, 1.0f,
+    -0.5f, -0.5f,  0.5f,  0.0f,  0.0f,  1.0f,  0.0f, 0.0f,
+
+    -0.5f,  0.5f,  0.5f, -1.0f,  0.0f,  0.0f,  1.0f, 0.0f,
+    -0.5f,  0.5f, -0.5f, -1.0f,  0.0f,  0.0f,  1.0f, 1.0f,
+    -0.5f, -0.5f, -0.5f, -1.0f,  0.0f,  0.0f,  0.0f, 1.0f,
+    -0.5f, -0.5f, -0.5f, -1.0f,  0.0f,  0.0f,  0.0f, 1.0f,
+    -0.5f, -0.5f,  0.5f, -1.0f,  0.0f,  0.0f,  0.0f, 0.0f,
+    -0.5f,  0.5f,  0.5f, -1.0f,  0.0f,  0.0f,  1.0f, 0.0f,
+
+     0.5f,  0.5f,  0.5f,  1.0f,  0.0f,  0.0f,  1.0f, 0.0f,
+     0.5f,  0.5f, -0.5f,  1.0f,  0.0f,  0.0f,  1.0f, 1.0f,
+     0.5f, -0.5f, -0.5f,  1.0f,  0.0f,  0.0f,  0.0f, 1.0f,
+     0.5f, -0.5f, -0.5f,  1.0f,  0.0f,  0.0f,  0.0f, 1.0f,
+     0.5f, -0.5f,  0.5f,  1.0f,  0.0f,  0.0f,  0.0f, 0.0f,
+     0.5f,  0.5f,  0.5f,  1.0f,  0.0f,  0.0f,  1.0f, 0.0f,
+
+    -0.5f, -0.5f, -0.5f,  0.0f, -1.0f,  0.0f,  0.0f, 1.0f,
+     0.5f, -0.5f, -0.5f,  0.0f, -1.0f,  0.0f,  1.0f, 1.0f,
+     0.5f, -0.5f,  0.5f,  0.0f, -1.0f,  0.0f,  1.0f, 0.0f,
+     0.5f, -0.5f,  0.5f,  0.0f, -1.0f,  0.0f,  1.0f, 0.0f,
+    -0.5f, -0.5f,  0.5f,  0.0f, -1.0f,  0.0f,  0.0f, 0.0f,
+    -0.5f, -0.5f, -0.5f,  0.0f, -1.0f,  0.0f,  0.0f, 1.0f,
+
+    -0.5f,  0.5f, -0.5f,  0.0f,  1.0f,  0.0f,  0.0f, 1.0f,
+     0.5f,  0.5f, -0.5f,  0.0f,  1.0f,  0.0f,  1.0f, 1.0f,
+     0.5f,  0.5f,  0.5f,  0.0f,  1.0f,  0.0f,  1.0f, 0.0f,
+     0.5f,  0.5f,  0.5f,  0.0f,  1.0f,  0.0f,  1.0f, 0.0f,
+    -0.5f,  0.5f,  0.5f,  0.0f,  1.0f,  0.0f,  0.0f, 0.0f,
+    -0.5f,  0.5f, -0.5f,  0.0f,  1.0f,  0.0f,  0.0f, 1.0f
+        
+    };
+
+
+    glm::vec3 cameraPos(0.f, 4.f, 6.f);
+    cameraFront = glm::normalize(glm::vec3(0.f,-0.3f,-1.f));
+    glm::vec3 cameraUp(0.,1.,0.f);
+    
+
+    Texture2D tex;
+    tex.generate2DTex("./image2d.tex");
+    tex.bind();
+
+    GLuint vbo = 0;
+    glGenBuffers(1, &vbo); 
+    glBindBuffer(GL_ARRAY_BUFFER, vbo);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(triangle_data), triangle_data, GL_STATIC_DRAW);
+
+    GLuint vao = 0;
+    glGenVertexArrays(1, &vao);
+    glBindVertexArray(vao);
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)0);
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)(6 * sizeof(float)));
+    glEnableVertexAttribArray(1);
+    glVertexAttribPointer(2, 3, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)(3 * sizeof(float)));
+    glEnableVertexAttribArray(2);
+
+    VertexShader vs;
+    FragmentShader fs;
+    vs.setSource("./vertex.glsl");
+    fs.setSource("./frag.glsl");
+    Program blockProg;
+    blockProg.AttachShaders({&vs, &fs});
+    blockProg.bindUniformBlock("FrameData", FRAME_BINDING);
+    blockProg.bindUniformBlock("DrawData", DRAW_BINDING);
+    blockProg.UseProgram();
+    blockProg.setInt("tex", 0);
+
+    VertexShader uniformVs;
+    FragmentShader uniformFs;
+    uniformVs.setSource("./uniform_vertex.glsl");
+    uniformFs.setSource("./uniform_frag.glsl");
+    Program uniformProg;
+    uniformProg.AttachShaders({&uniformVs, &uniformFs});
+    uniformProg.UseProgram();
+    uniformProg.setInt("tex", 0);
+
+    if (bench) {
+        int result = runBenchmark(win, uniformProg, blockProg, argc > 2 ? std::atoi(argv[2]) : 48);
+        glfwTerminate();
+        return result;
+    }
+
+    std::vector<SceneObject> objects = buildScene(48);
+    UniformRing ring(objects.size() * sizeof(DrawUniforms) * 4);
+    FrameUniformBuffer frameBuffer;
+    std::vector<GLintptr> offsets;
+    FrameUniforms frame;
+    frame.proj = glm::perspective(glm::radians(45.f), float(screenWidth) / screenHeight, 0.1f, 200.f);
+    bool useRing = true;
+
+    glfwSetCursorPosCallback(win, mouseMovement); 
+    glfwSetInputMode(win, GLFW_CURSOR, GLFW_CURSOR_DISABLED);  
+
+    GpuTimer timer;
+    double lastReport = glfwGetTime(), cpuMs = 0., gpuMs = 0.;
+    int frames = 0, gpuSamples = 0;
+    size_t calls = 0;
+    
+    while (!glfwWindowShouldClose(win)) {
+        processInput(win, cameraPos, cameraFront, cameraUp);
+        // U switches between the ring and one glUniform per value
+        if (keyPressed(win, GLFW_KEY_U))
+            useRing = !useRing;
+        float time = glfwGetTime();
+        frame.view = glm::lookAt(cameraPos, cameraFront + cameraPos, cameraUp);
+        frame.cameraPosTime = glm::vec4(cameraPos, time);
+
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+        size_t before = Program::uniformCalls + ring.calls + frameBuffer.calls;
+        auto start = std::chrono::steady_clock::now();
+        timer.begin();
+        if (useRing)
+            drawWithRing(blockProg, ring, frameBuffer, objects, frame, time, offsets);
+        else
+            drawWithUniforms(uniformProg, objects, frame, time);
+        double ms = timer.end();
+        cpuMs += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        calls += Program::uniformCalls + ring.calls + frameBuffer.calls - before;
+        if (ms >= 0.) {
+            gpuMs += ms;
+            ++gpuSamples;
+        }
+
+        ++frames;
+        if (glfwGetTime() - lastReport > 1.) {
+            lastReport = glfwGetTime();
+            std::cout << (useRing ? "uniform ring: " : "glUniform per draw: ") << double(calls) / frames << " uniform calls, "
+                      << cpuMs / frames << "ms cpu, " << (gpuSamples ? gpuMs / gpuSamples : 0.) << "ms gpu per frame, "
+                      << ring.stalls << " ring stalls\n";
+            frames = gpuSamples = 0;
+            calls = 0;
+            cpuMs = gpuMs = 0.;
+        }
+        // polls different kinds of events, for example, when we close an application, it fetches that event
+        // or it fetches events like movement of the window.
+        // Without it you can neither move the window or close the window
+        glfwPollEvents();
+        // have you drawn the image, it is stored in the buffer. You can now swap this buffer with main buffer
+        // so the image appears
+        glfwSwapBuffers(win);
+    }
+    glfwTerminate();
+    
+    std::cout << "Window should close now!\n";
+
+    return EXIT_SUCCESS;
+
+}
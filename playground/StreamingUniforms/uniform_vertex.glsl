@@ -0,0 +1,25 @@
+#version 330 core
+
+layout(location = 0) in vec3 aPos;
+layout(location = 1) in vec2 aTexCoord;
+layout(location = 2) in vec3 aNormal;
+
+out vec2 texCoord;
+out vec3 worldPos;
+out vec3 worldNormal;
+
+// the same as vertex.glsl with plain uniforms, for comparing
+uniform mat4 view;
+uniform mat4 proj;
+uniform vec4 cameraPosTime;
+uniform mat4 model;
+uniform mat4 normalMatrix;
+
+
+void main() {
+    vec4 pos = model * vec4(aPos, 1.0);
+    gl_Position = proj * view * pos;
+    worldPos = pos.xyz;
+    worldNormal = mat3(normalMatrix) * aNormal;
+    texCoord = aTexCoord;
+}
@@ -0,0 +1,33 @@
+#version 330 core
+
+layout(location = 0) in vec3 aPos;
+layout(location = 1) in vec2 aTexCoord;
+layout(location = 2) in vec3 aNormal;
+
+out vec2 texCoord;
+out vec3 worldPos;
+out vec3 worldNormal;
+
+// written once a frame, see FrameUniforms
+layout(std140) uniform FrameData {
+    mat4 view;
+    mat4 proj;
+    vec4 cameraPosTime;
+};
+
+// a slice of the uniform ring, rebound for every draw. see DrawUniforms
+layout(std140) uniform DrawData {
+    mat4 model;
+    mat4 normalMatrix;
+    vec4 color;
+    vec4 params;
+};
+
+
+void main() {
+    vec4 pos = model * vec4(aPos, 1.0);
+    gl_Position = proj * view * pos;
+    worldPos = pos.xyz;
+    worldNormal = mat3(normalMatrix) * aNormal;
+    texCoord = aTexCoord;
+}
@@ -0,0 +1,14 @@
+#version 330 core
+
+out vec4 FragColor;
+in vec2 texCoord;
+in vec3 normal;
+in float height;
+
+uniform sampler2D tex;
+
+void main() {
+    vec3 ground = mix(vec3(0.3, 0.5, 0.2), vec3(0.9, 0.9, 0.85), clamp((height - 2.0) / 7.0, 0.0, 1.0));
+    float light = 0.3 + 0.7 * max(dot(normalize(normal), normalize(vec3(0.4, 1.0, 0.3))), 0.0);
+    FragColor = vec4(texture(tex, texCoord).rgb * ground * light, 1.0);
+}
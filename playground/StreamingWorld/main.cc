@@ -0,0 +1,1111 @@
+#include <GL/glew.h>
+
+#include <GLFW/glfw3.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <glm/ext/matrix_clip_space.hpp>
+#include <glm/ext/matrix_transform.hpp>
+#include <glm/geometric.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/ext/matrix_float4x4.hpp>
+#include <glm/gtc/type_ptr.hpp>
+#include <glm/glm.hpp>
+#include <glm/trigonometric.hpp>
+#define STB_IMAGE_IMPLEMENTATION
+#include <stb/stb_image.h>
+#include <iostream>
+#include <fcntl.h>
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+class Shader {
+    std::string src; 
+protected:
+    const char *getsrc() {
+        return src.data();
+    }
+    GLuint shader_id = 0;
+    bool isCompiled = false;
+protected:
+    virtual const char *getClassName() = 0;
+    GLint getCompilationStatus(GLuint shader_id) {
+        int status;
+        glGetShaderiv(shader_id, GL_COMPILE_STATUS, &status);
+        return status;
+    }
+    void sendError() {
+        char buffer[1024];
+        glGetShaderInfoLog(shader_id, 1024, NULL, buffer);
+        std::cerr << "ERROR::" << getClassName() << " - " << buffer;
+    }
+public:
+    virtual void compile() = 0;
+    void setSource(const char *s) {
+        std::ifstream sourceFile(s);
+        if (!sourceFile.is_open())
+            return;
+        char buffer[8192];
+        while (sourceFile.read(buffer, 8192)) {
+            src.append(buffer, 8192);
+        }
+        if (!sourceFile.eof()) {
+            src.clear();
+            return;
+        }
+        src.append(buffer, sourceFile.gcount());
+    }
+    friend class Program;
+};
+
+
+class VertexShader : public Shader {
+    virtual const char *getClassName() override {
+        return "VertexShader";
+    }
+public:
+    virtual void compile() override {
+        if (shader_id)
+            glDeleteShader(shader_id);
+        shader_id = glCreateShader(GL_VERTEX_SHADER);
+        const char *src = getsrc();
+        glShaderSource(shader_id, 1, &src, NULL);
+        glCompileShader(shader_id);
+        if (!getCompilationStatus(shader_id)) {
+            sendError();
+        }
+        isCompiled = true;
+    }
+};
+
+class FragmentShader : public Shader {
+    const char *getClassName() override {
+        return "FragmentShader";
+    }
+public:
+    virtual void compile() override {
+        if (shader_id)
+            glDeleteShader(shader_id);
+        shader_id = glCreateShader(GL_FRAGMENT_SHADER);
+        const char *src = getsrc();
+        glShaderSource(shader_id, 1, &src, NULL);
+        glCompileShader(shader_id);
+        if (!getCompilationStatus(shader_id)) {
+            sendError();
+        }
+        isCompiled = true;
+    }
+};
+
+
+class Program {
+    GLuint program_id = 0;
+    void sendError() {
+        char buffer[1024];
+        glGetProgramInfoLog(program_id, 1024, NULL, buffer);
+        std::cerr << "ERROR::PROGRAM: " << " - " << buffer;
+    }
+    bool linkStatus() {
+        int status = 0;
+        glGetProgramiv(program_id, GL_LINK_STATUS, &status);
+        return status;
+    }
+public:
+    Program() {
+        program_id = glCreateProgram();
+    }
+    ~Program() {
+        glDeleteProgram(program_id);
+    }
+    void AttachShaders(std::initializer_list<Shader*> shaders) {
+        auto i = shaders.begin();
+        while (i != shaders.end()) {
+            if (!(*i)->isCompiled)
+                (*i)->compile();
+            glAttachShader(program_id, (*i)->shader_id);
+            ++i;
+        }
+        glLinkProgram(program_id);
+        if (!linkStatus()) {
+            sendError();
+        }
+    }
+    void UseProgram() {
+        glUseProgram(program_id);
+    }
+    void setMat4(const char *locName, const glm::mat4 &mat) {
+        int location = glGetUniformLocation(program_id, locName);
+        if (location == -1)
+            return;
+        glUniformMatrix4fv(location, 1, GL_FALSE, glm::value_ptr(mat));
+    }
+    void setInt(const char *locName, int value) {
+        int location = glGetUniformLocation(program_id, locName);
+        if (location == -1)
+            return;
+        glUniform1i(location, value);
+    }
+    void setFloat(const char *locName, float value) {
+        int location = glGetUniformLocation(program_id, locName);
+        if (location == -1)
+            return;
+        glUniform1f(location, value);
+    }
+    void setVec3(const char *locName, const glm::vec3 &vec) {
+        int location = glGetUniformLocation(program_id, locName);
+        if (location == -1)
+            return;
+        glUniform3f(location, vec.x, vec.y, vec.z);
+    }
+    void setVec4(const char *locName, const glm::vec4 &vec) {
+        int location = glGetUniformLocation(program_id, locName);
+        if (location == -1)
+            return;
+        glUniform4f(location, vec.x, vec.y, vec.z, vec.w);
+    }
+};
+
+
+class Texture2D {
+    GLuint tex_id;
+public:
+    void generate2DTex(const char *image_path) {
+        int width, height, nChannels;
+        stbi_set_flip_vertically_on_load(true);
+        uint8_t *raw_image = stbi_load(image_path, &width, &height, &nChannels, 0);
+        float borderColor[] = {1.f, 1.f, 1.f, 1.f};
+        glGenTextures(1, &tex_id);
+        glBindTexture(GL_TEXTURE_2D, tex_id);
+        // what to do when primitive is bigger than the texture
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_BORDER);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_BORDER);
+        glTexParameterfv(GL_TEXTURE_2D, GL_TEXTURE_BORDER_COLOR, borderColor);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        // glTexImage2D(TARGET_TYPE, IM_MIPMAP_LEVEL, TARGET_NRCHANNELS, SRC_WIDTH, SRC_HEIGHT, LEGACY_0, SRC_NRCHANNELS, SRC_DATA_TYPE, SRC_DATA);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, width, height, 0, GL_RGB, GL_UNSIGNED_BYTE, raw_image);
+        stbi_image_free(raw_image);
+    }
+    void bind() {
+        glBindTexture(GL_TEXTURE_2D, tex_id);
+    }
+};
+
+
+void evictFromCache(const char *path) {
+    int fd = ::open(path, O_RDONLY);
+    if (fd < 0)
+        return;
+    fdatasync(fd);
+    posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+    ::close(fd);
+}
+
+
+// ---------------------------------------------------------------------------------------------------------
+// the world on disk: a CHUNKS_X x CHUNKS_Z grid of square chunks, each one a fixed size record of instances
+// starting on a 4KB boundary, so chunk i is at dataOffset + i * chunkStride and nothing has to be looked up
+// ---------------------------------------------------------------------------------------------------------
+
+constexpr char WORLD_MAGIC[4] = {'A', 'G', 'W', 'D'};
+constexpr uint32_t WORLD_VERSION = 1;
+
+struct WorldHeader {
+    char magic[4];
+    uint32_t version;
+    uint32_t chunksX, chunksZ;
+    float chunkSize;            // meters
+    uint32_t instancesPerChunk;
+    uint32_t chunkBytes;        // instancesPerChunk * sizeof(ChunkInstance)
+    uint32_t chunkStride;       // chunkBytes rounded up to 4KB
+    uint64_t dataOffset;
+};
+
+// a column of the terrain, xyz of its top center and how tall it is
+struct ChunkInstance {
+    float x, y, z, height;
+};
+
+constexpr int CHUNK_SIDE = 32;  // instances per chunk edge
+
+float terrainHeight(float x, float z) {
+    return 4.f + 3.f * std::sin(x * 0.05f) * std::cos(z * 0.04f) + 1.5f * std::sin(x * 0.13f + z * 0.11f) + 0.5f * std::cos(z * 0.31f);
+}
+
+// ./main --generate [chunks per side]
+bool generateWorld(const char *path, uint32_t chunks) {
+    WorldHeader header = {};
+    std::memcpy(header.magic, WORLD_MAGIC, 4);
+    header.version = WORLD_VERSION;
+    header.chunksX = header.chunksZ = chunks;
+    header.chunkSize = 16.f;
+    header.instancesPerChunk = CHUNK_SIDE * CHUNK_SIDE;
+    header.chunkBytes = header.instancesPerChunk * sizeof(ChunkInstance);
+    header.chunkStride = (header.chunkBytes + 4095) / 4096 * 4096;
+    header.dataOffset = 4096;
+
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out.is_open()) {
+        std::cerr << "ERROR::WORLD - can't write " << path << "\n";
+        return false;
+    }
+    std::vector<char> page(header.dataOffset, 0);
+    std::memcpy(page.data(), &header, sizeof(header));
+    out.write(page.data(), page.size());
+    std::vector<char> record(header.chunkStride, 0);
+    const float spacing = header.chunkSize / CHUNK_SIDE;
+    for (uint32_t cz = 0; cz < chunks; ++cz) {
+        for (uint32_t cx = 0; cx < chunks; ++cx) {
+            ChunkInstance *instances = reinterpret_cast<ChunkInstance*>(record.data());
+            for (int i = 0; i < CHUNK_SIDE * CHUNK_SIDE; ++i) {
+                float x = cx * header.chunkSize + (i % CHUNK_SIDE + 0.5f) * spacing;
+                float z = cz * header.chunkSize + (i / CHUNK_SIDE + 0.5f) * spacing;
+                float h = terrainHeight(x, z);
+                instances[i] = {x, h, z, h};
+            }
+            out.write(record.data(), record.size());
+        }
+    }
+    out.close();
+    if (!out) {
+        std::cerr << "ERROR::WORLD - can't write " << path << "\n";
+        return false;
+    }
+    return true;
+}
+
+
+// ---------------------------------------------------------------------------------------------------------
+// asynchronous reads. submit() never blocks, poll() returns whatever finished since the last call
+// ---------------------------------------------------------------------------------------------------------
+
+struct ReadRequest {
+    int fd;
+    uint64_t offset;
+    uint32_t size;
+    void *dst;
+    uint64_t userData;
+};
+
+struct ReadCompletion {
+    uint64_t userData;
+    int result;  // bytes read or -errno
+};
+
+class AsyncReader {
+public:
+    virtual ~AsyncReader() = default;
+    virtual const char *name() const = 0;
+    // how many more requests submit() takes right now
+    virtual size_t capacity() const = 0;
+    // returns how many of the requests, from the front, are now in flight. the rest were never started
+    virtual size_t submit(const ReadRequest *requests, size_t count) = 0;
+    virtual size_t poll(std::vector<ReadCompletion> &out) = 0;
+};
+
+// io_uring through the raw syscalls, there is no liburing here. one submission per batch, completions are
+// read straight out of the shared ring without a syscall
+class UringReader : public AsyncReader {
+    int ring_fd = -1;
+    unsigned entries = 0;
+    void *sqRing = nullptr, *cqRing = nullptr;
+    size_t sqRingSize = 0, cqRingSize = 0;
+    io_uring_sqe *sqes = nullptr;
+    unsigned *sqHead, *sqTail, *sqMask, *sqArray;
+    unsigned *cqHead, *cqTail, *cqMask;
+    io_uring_cqe *cqes;
+    size_t inFlight = 0;
+
+    static int setup(unsigned entries, io_uring_params *params) {
+        return syscall(__NR_io_uring_setup, entries, params);
+    }
+    static int enter(int fd, unsigned toSubmit, unsigned minComplete, unsigned flags) {
+        return syscall(__NR_io_uring_enter, fd, toSubmit, minComplete, flags, nullptr, 0);
+    }
+public:
+    UringReader() = default;
+    UringReader(const UringReader&) = delete;
+    UringReader &operator=(const UringReader&) = delete;
+    ~UringReader() {
+        if (sqes)
+            munmap(sqes, entries * sizeof(io_uring_sqe));
+        if (cqRing && cqRing != sqRing)
+            munmap(cqRing, cqRingSize);
+        if (sqRing)
+            munmap(sqRing, sqRingSize);
+        if (ring_fd >= 0)
+            close(ring_fd);
+    }
+    // fails on kernels without io_uring or when a sandbox filters it out, the caller falls back then
+    bool create(unsigned queueDepth) {
+        io_uring_params params;
+        std::memset(&params, 0, sizeof(params));
+        ring_fd = setup(queueDepth, &params);
+        if (ring_fd < 0)
+            return false;
+        entries = params.sq_entries;
+        sqRingSize = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+        cqRingSize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+        // newer kernels map both rings in one go
+        const bool single = params.features & IORING_FEAT_SINGLE_MMAP;
+        if (single)
+            sqRingSize = cqRingSize = std::max(sqRingSize, cqRingSize);
+        sqRing = mmap(nullptr, sqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd, IORING_OFF_SQ_RING);
+        if (sqRing == MAP_FAILED) {
+            sqRing = nullptr;
+            return false;
+        }
+        cqRing = single ? sqRing : mmap(nullptr, cqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd, IORING_OFF_CQ_RING);
+        if (cqRing == MAP_FAILED) {
+            cqRing = nullptr;
+            return false;
+        }
+        void *sqeMemory = mmap(nullptr, entries * sizeof(io_uring_sqe), PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd, IORING_OFF_SQES);
+        if (sqeMemory == MAP_FAILED)
+            return false;
+        sqes = static_cast<io_uring_sqe*>(sqeMemory);
+
+        char *sq = static_cast<char*>(sqRing), *cq = static_cast<char*>(cqRing);
+        sqHead = reinterpret_cast<unsigned*>(sq + params.sq_off.head);
+        sqTail = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+        sqMask = reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+        sqArray = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+        cqHead = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+        cqTail = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+        cqMask = reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+        cqes = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+        return true;
+    }
+    const char *name() const override {
+        return "io_uring";
+    }
+    // the completion ring is twice as big, so keeping this many in flight can never overflow it
+    size_t capacity() const override {
+        return entries - inFlight;
+    }
+    size_t submit(const ReadRequest *requests, size_t count) override {
+        count = std::min(count, capacity());
+        const unsigned first = *sqTail;
+        unsigned tail = first;
+        for (size_t i = 0; i < count; ++i) {
+            const unsigned index = tail & *sqMask;
+            io_uring_sqe &sqe = sqes[index];
+            std::memset(&sqe, 0, sizeof(sqe));
+            sqe.opcode = IORING_OP_READ;
+            sqe.fd = requests[i].fd;
+            sqe.off = requests[i].offset;
+            sqe.addr = reinterpret_cast<uint64_t>(requests[i].dst);
+            sqe.len = requests[i].size;
+            sqe.user_data = requests[i].userData;
+            sqArray[index] = index;
+            ++tail;
+        }
+        // the kernel may look at the entries as soon as it sees the new tail
+        __atomic_store_n(sqTail, tail, __ATOMIC_RELEASE);
+        int submitted = enter(ring_fd, count, 0, 0);
+        if (submitted < 0) {
+            std::cerr << "ERROR::URING - io_uring_enter: " << std::strerror(errno) << "\n";
+            submitted = 0;
+        }
+        // without SQPOLL the kernel only takes entries inside io_uring_enter, and it takes them in order. whatever
+        // it didn't take is pulled back out of the ring, otherwise the next enter would start those reads into
+        // slots the caller has already handed to someone else
+        if (size_t(submitted) < count)
+            __atomic_store_n(sqTail, first + unsigned(submitted), __ATOMIC_RELEASE);
+        inFlight += submitted;
+        return submitted;
+    }
+    size_t poll(std::vector<ReadCompletion> &out) override {
+        unsigned head = *cqHead;
+        const unsigned tail = __atomic_load_n(cqTail, __ATOMIC_ACQUIRE);
+        size_t count = 0;
+        for (; head != tail; ++head, ++count) {
+            const io_uring_cqe &cqe = cqes[head & *cqMask];
+            out.push_back({cqe.user_data, cqe.res});
+        }
+        __atomic_store_n(cqHead, head, __ATOMIC_RELEASE);
+        inFlight -= count;
+        return count;
+    }
+};
+
+// the same with plain blocking preads on a few threads
+class PreadReader : public AsyncReader {
+    std::vector<std::thread> threads;
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::deque<ReadRequest> queue;
+    std::vector<ReadCompletion> done;
+    size_t maxInFlight;
+    size_t inFlight = 0;
+    bool quit = false;
+
+    void work() {
+        std::unique_lock<std::mutex> lock(mutex);
+        while (true) {
+            wake.wait(lock, [&] { return quit || !queue.empty(); });
+            if (quit)
+                return;
+            ReadRequest request = queue.front();
+            queue.pop_front();
+            lock.unlock();
+            size_t total = 0;
+            int result = 0;
+            while (total < request.size) {
+                ssize_t n = pread(request.fd, static_cast<char*>(request.dst) + total, request.size - total, request.offset + total);
+                if (n < 0 && errno == EINTR)
+                    continue;
+                if (n <= 0) {
+                    result = n < 0 ? -errno : int(total);
+                    break;
+                }
+                total += n;
+                result = total;
+            }
+            lock.lock();
+            done.push_back({request.userData, result});
+        }
+    }
+public:
+    PreadReader(unsigned threadCount, size_t maxInFlight) : maxInFlight(maxInFlight) {
+        for (unsigned i = 0; i < threadCount; ++i)
+            threads.emplace_back(&PreadReader::work, this);
+    }
+    ~PreadReader() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            quit = true;
+        }
+        wake.notify_all();
+        for (std::thread &t : threads)
+            t.join();
+    }
+    const char *name() const override {
+        return "pread pool";
+    }
+    size_t capacity() const override {
+        return maxInFlight - inFlight;
+    }
+    size_t submit(const ReadRequest *requests, size_t count) override {
+        count = std::min(count, capacity());
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            queue.insert(queue.end(), requests, requests + count);
+        }
+        inFlight += count;
+        wake.notify_all();
+        return count;
+    }
+    size_t poll(std::vector<ReadCompletion> &out) override {
+        size_t count;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            count = done.size();
+            out.insert(out.end(), done.begin(), done.end());
+            done.clear();
+        }
+        inFlight -= count;
+        return count;
+    }
+};
+
+std::unique_ptr<AsyncReader> createReader(bool allowUring, size_t queueDepth) {
+    if (allowUring) {
+        std::unique_ptr<UringReader> uring(new UringReader());
+        if (uring->create(queueDepth))
+            return uring;
+        std::cerr << "WARNING::STREAMING - io_uring is not available, using preads on threads\n";
+    }
+    return std::unique_ptr<AsyncReader>(new PreadReader(4, queueDepth));
+}
+
+
+// ---------------------------------------------------------------------------------------------------------
+// streaming. chunks near the camera are read into fixed slots of one staging block, handed to the upload
+// queue when the read completes and dropped again when the camera is far enough away. nothing in here ever
+// waits for the disk, a chunk that isn't there yet just isn't drawn
+// ---------------------------------------------------------------------------------------------------------
+
+struct StreamingStats {
+    size_t requested = 0, completed = 0, failed = 0, evicted = 0, cancelled = 0, uploaded = 0;
+    size_t queueDepthSum = 0, queueDepthMax = 0, frames = 0;
+    double latencySum = 0., latencyMax = 0.;  // ms, submit to completion seen
+    uint64_t bytes = 0;
+    void reset() {
+        *this = StreamingStats();
+    }
+};
+
+class WorldStreamer {
+public:
+    enum State : uint8_t { UNLOADED, LOADING, READY, RESIDENT };
+private:
+    struct Chunk {
+        State state = UNLOADED;
+        bool cancelled = false;  // left the load radius while its read was in flight
+        int slot = -1;
+        std::chrono::steady_clock::time_point submitted;
+    };
+    int fd = -1;
+    WorldHeader header = {};
+    std::unique_ptr<AsyncReader> reader;
+    std::vector<Chunk> chunks;
+    char *staging = nullptr;
+    std::vector<int> freeSlots;
+    std::vector<uint32_t> resident;
+    std::deque<uint32_t> uploadQueue;
+    std::vector<ReadCompletion> completions;
+    std::vector<ReadRequest> batch;
+    struct Candidate {
+        float priority;
+        uint32_t chunk;
+    };
+    std::vector<Candidate> candidates;
+    size_t slotCount;
+    size_t pending = 0;  // reads in flight
+    float loadRadius, evictRadius;
+
+    // closer is better, and things in front of the camera count as up to twice as close as things behind it
+    float priority(uint32_t chunk, const glm::vec3 &cameraPos, const glm::vec3 &cameraFront) const {
+        glm::vec3 center = chunkCenter(chunk);
+        glm::vec3 toChunk = glm::vec3(center.x - cameraPos.x, 0.f, center.z - cameraPos.z);
+        float distance = glm::length(toChunk);
+        if (distance < header.chunkSize)
+            return distance;
+        glm::vec3 flatFront = glm::vec3(cameraFront.x, 0.f, cameraFront.z);
+        float facing = glm::length(flatFront) > 1e-3f ? glm::dot(toChunk / distance, glm::normalize(flatFront)) : 0.f;
+        return distance * (0.75f - 0.25f * facing);
+    }
+    float distanceTo(uint32_t chunk, const glm::vec3 &cameraPos) const {
+        glm::vec3 center = chunkCenter(chunk);
+        return glm::length(glm::vec3(center.x - cameraPos.x, 0.f, center.z - cameraPos.z));
+    }
+    void release(uint32_t chunk) {
+        Chunk &c = chunks[chunk];
+        freeSlots.push_back(c.slot);
+        c.slot = -1;
+        c.state = UNLOADED;
+        c.cancelled = false;
+    }
+public:
+    StreamingStats stats;
+
+    WorldStreamer(size_t slots, float loadRadius, float evictRadius)
+        : slotCount(slots), loadRadius(loadRadius), evictRadius(evictRadius) {}
+    WorldStreamer(const WorldStreamer&) = delete;
+    WorldStreamer &operator=(const WorldStreamer&) = delete;
+    ~WorldStreamer() {
+        // the reads still in flight write into staging, let them land first
+        if (reader) {
+            while (pending) {
+                completions.clear();
+                size_t n = reader->poll(completions);
+                pending -= n;
+                if (!n)
+                    std::this_thread::yield();
+            }
+        }
+        reader.reset();
+        std::free(staging);
+        if (fd >= 0)
+            close(fd);
+    }
+    bool open(const char *path, bool allowUring, size_t queueDepth) {
+        fd = ::open(path, O_RDONLY);
+        if (fd < 0 || pread(fd, &header, sizeof(header), 0) != sizeof(header)) {
+            std::cerr << "ERROR::STREAMING - can't read " << path << ", make one with --generate\n";
+            return false;
+        }
+        if (std::memcmp(header.magic, WORLD_MAGIC, 4) || header.version != WORLD_VERSION
+            || header.chunkBytes != header.instancesPerChunk * sizeof(ChunkInstance) || header.chunkStride < header.chunkBytes) {
+            std::cerr << "ERROR::STREAMING - " << path << " is not a world of this version\n";
+            return false;
+        }
+        struct stat st;
+        if (fstat(fd, &st) != 0 || uint64_t(st.st_size) < header.dataOffset + uint64_t(header.chunksX) * header.chunksZ * header.chunkStride) {
+            std::cerr << "ERROR::STREAMING - " << path << " is truncated\n";
+            return false;
+        }
+        reader = createReader(allowUring, queueDepth);
+        chunks.assign(header.chunksX * header.chunksZ, Chunk());
+        // page aligned slots, so the reads could go O_DIRECT without changing anything here
+        if (posix_memalign(reinterpret_cast<void**>(&staging), 4096, slotCount * header.chunkStride) != 0) {
+            staging = nullptr;
+            std::cerr << "ERROR::STREAMING - out of memory for " << slotCount << " slots\n";
+            return false;
+        }
+        for (int i = slotCount - 1; i >= 0; --i)
+            freeSlots.push_back(i);
+        return true;
+    }
+    const WorldHeader &world() const {
+        return header;
+    }
+    const char *readerName() const {
+        return reader->name();
+    }
+    glm::vec3 chunkCenter(uint32_t chunk) const {
+        return glm::vec3(((chunk % header.chunksX) + 0.5f) * header.chunkSize, 0.f, ((chunk / header.chunksX) + 0.5f) * header.chunkSize);
+    }
+    State state(uint32_t chunk) const {
+        return chunks[chunk].state;
+    }
+    int slot(uint32_t chunk) const {
+        return chunks[chunk].slot;
+    }
+    const std::vector<uint32_t> &residentChunks() const {
+        return resident;
+    }
+    size_t inFlight() const {
+        return pending;
+    }
+
+    // once per frame: collect finished reads, drop far chunks, queue reads for the best missing ones
+    void update(const glm::vec3 &cameraPos, const glm::vec3 &cameraFront);
+    // hands up to budget ready chunks to upload(slot, data, size) and makes them drawable
+    template<typename Upload>
+    size_t drainUploads(size_t budget, Upload &&upload) {
+        size_t count = 0;
+        while (count < budget && !uploadQueue.empty()) {
+            uint32_t chunk = uploadQueue.front();
+            uploadQueue.pop_front();
+            Chunk &c = chunks[chunk];
+            if (c.state != READY)
+                continue;  // evicted while it waited
+            upload(c.slot, staging + size_t(c.slot) * header.chunkStride, header.chunkBytes);
+            c.state = RESIDENT;
+            resident.push_back(chunk);
+            ++count;
+        }
+        stats.uploaded += count;
+        return count;
+    }
+};
+
+void WorldStreamer::update(const glm::vec3 &cameraPos, const glm::vec3 &cameraFront) {
+    const auto now = std::chrono::steady_clock::now();
+    completions.clear();
+    pending -= reader->poll(completions);
+    for (const ReadCompletion &done : completions) {
+        Chunk &c = chunks[done.userData];
+        double ms = std::chrono::duration<double, std::milli>(now - c.submitted).count();
+        stats.latencySum += ms;
+        stats.latencyMax = std::max(stats.latencyMax, ms);
+        if (done.result != int(header.chunkBytes)) {
+            std::cerr << "ERROR::STREAMING - reading chunk " << done.userData << " failed: "
+                      << (done.result < 0 ? std::strerror(-done.result) : "short read") << "\n";
+            ++stats.failed;
+            release(done.userData);
+            continue;
+        }
+        ++stats.completed;
+        stats.bytes += done.result;
+        if (c.cancelled) {
+            ++stats.cancelled;
+            release(done.userData);
+            continue;
+        }
+        c.state = READY;
+        uploadQueue.push_back(done.userData);
+    }
+
+    // drop what is far away. the evict radius is bigger than the load radius, so walking along a chunk
+    // border doesn't load and drop the same chunks over and over
+    for (size_t i = 0; i < resident.size();) {
+        if (distanceTo(resident[i], cameraPos) > evictRadius) {
+            release(resident[i]);
+            resident[i] = resident.back();
+            resident.pop_back();
+            ++stats.evicted;
+        } else {
+            ++i;
+        }
+    }
+    for (uint32_t i : uploadQueue) {
+        if (chunks[i].state == READY && distanceTo(i, cameraPos) > evictRadius) {
+            release(i);
+            ++stats.evicted;
+        }
+    }
+
+    // everything missing inside the load radius, best first
+    candidates.clear();
+    const int reach = int(std::ceil(loadRadius / header.chunkSize));
+    const int cx = int(std::floor(cameraPos.x / header.chunkSize)), cz = int(std::floor(cameraPos.z / header.chunkSize));
+    for (int z = std::max(cz - reach, 0); z <= std::min(cz + reach, int(header.chunksZ) - 1); ++z) {
+        for (int x = std::max(cx - reach, 0); x <= std::min(cx + reach, int(header.chunksX) - 1); ++x) {
+            uint32_t chunk = z * header.chunksX + x;
+            Chunk &c = chunks[chunk];
+            if (c.state == LOADING && c.cancelled && distanceTo(chunk, cameraPos) <= loadRadius)
+                c.cancelled = false;  // came back before the read finished
+            if (c.state != UNLOADED || distanceTo(chunk, cameraPos) > loadRadius)
+                continue;
+            candidates.push_back({priority(chunk, cameraPos, cameraFront), chunk});
+        }
+    }
+    // reads in flight for chunks we went away from are useless now, their data is thrown away when it arrives
+    for (uint32_t chunk = 0; chunk < chunks.size(); ++chunk)
+        if (chunks[chunk].state == LOADING && !chunks[chunk].cancelled && distanceTo(chunk, cameraPos) > evictRadius)
+            chunks[chunk].cancelled = true;
+
+    const size_t wanted = std::min(candidates.size(), reader->capacity());
+    std::partial_sort(candidates.begin(), candidates.begin() + wanted, candidates.end(), [](const Candidate &a, const Candidate &b) {
+        return a.priority < b.priority;
+    });
+    batch.clear();
+    for (size_t i = 0; i < wanted && !freeSlots.empty(); ++i) {
+        const uint32_t chunk = candidates[i].chunk;
+        Chunk &c = chunks[chunk];
+        c.slot = freeSlots.back();
+        freeSlots.pop_back();
+        c.state = LOADING;
+        c.submitted = now;
+        batch.push_back({fd, header.dataOffset + uint64_t(chunk) * header.chunkStride, header.chunkBytes,
+                         staging + size_t(c.slot) * header.chunkStride, chunk});
+    }
+    if (!batch.empty()) {
+        // the ones that got in stay LOADING until their completion shows up, the rest go back to UNLOADED
+        const size_t submitted = reader->submit(batch.data(), batch.size());
+        stats.requested += submitted;
+        pending += submitted;
+        for (size_t i = submitted; i < batch.size(); ++i)
+            release(batch[i].userData);
+    }
+    const size_t depth = inFlight();
+    stats.queueDepthSum += depth;
+    stats.queueDepthMax = std::max(stats.queueDepthMax, depth);
+    ++stats.frames;
+}
+
+
+// ./main --bench [uring|pread] [frames]
+// flies over the world at 60 fps with a cold page cache and nothing drawn, the upload is a memcpy.
+// reports how long update() takes at worst, how deep the queue got, read latency and how often a chunk
+// right next to the camera wasn't there yet
+int runBenchmark(const char *worldPath, const std::vector<bool> &backends, int frames) {
+    for (bool uring : backends) {
+        evictFromCache(worldPath);
+        WorldStreamer streamer(512, 160.f, 192.f);
+        if (!streamer.open(worldPath, uring, 64))
+            return EXIT_FAILURE;
+        const WorldHeader &world = streamer.world();
+        std::vector<char> gpu(512 * size_t(world.chunkBytes));
+        const float worldSize = world.chunksX * world.chunkSize;
+
+        double worstUpdate = 0., totalUpdate = 0.;
+        size_t missing = 0, checked = 0;
+        auto frameStart = std::chrono::steady_clock::now();
+        for (int frame = 0; frame < frames; ++frame) {
+            // a wide circle at 60m/s, looking where we go
+            float t = frame / 60.f;
+            float angle = t * 60.f / (worldSize * 0.35f);
+            glm::vec3 cameraPos(worldSize * (0.5f + 0.35f * std::cos(angle)), 20.f, worldSize * (0.5f + 0.35f * std::sin(angle)));
+            glm::vec3 cameraFront = glm::normalize(glm::vec3(-std::sin(angle), -0.3f, std::cos(angle)));
+
+            auto start = std::chrono::steady_clock::now();
+            streamer.update(cameraPos, cameraFront);
+            streamer.drainUploads(32, [&](int slot, const char *data, size_t size) {
+                std::memcpy(gpu.data() + size_t(slot) * size, data, size);
+            });
+            double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+            totalUpdate += ms;
+            worstUpdate = std::max(worstUpdate, ms);
+
+            // the 3x3 chunks around the camera should always be there once we got going
+            if (frame > 60) {
+                int cx = int(cameraPos.x / world.chunkSize), cz = int(cameraPos.z / world.chunkSize);
+                for (int z = cz - 1; z <= cz + 1; ++z) {
+                    for (int x = cx - 1; x <= cx + 1; ++x) {
+                        ++checked;
+                        missing += streamer.state(z * world.chunksX + x) != WorldStreamer::RESIDENT;
+                    }
+                }
+            }
+            frameStart += std::chrono::microseconds(16667);
+            std::this_thread::sleep_until(frameStart);
+        }
+        const StreamingStats &s = streamer.stats;
+        std::cout << streamer.readerName() << ": " << s.completed << " chunks read (" << s.bytes / (1024 * 1024) << "MB), "
+                  << s.evicted << " evicted, " << s.cancelled << " thrown away, " << s.failed << " failed\n"
+                  << "  update: " << totalUpdate / frames << "ms average, " << worstUpdate << "ms worst\n"
+                  << "  queue depth: " << double(s.queueDepthSum) / s.frames << " average, " << s.queueDepthMax << " max\n"
+                  << "  latency: " << s.latencySum / std::max<size_t>(s.completed + s.failed, 1) << "ms average, " << s.latencyMax << "ms max\n"
+                  << "  chunks next to the camera missing: " << missing << " of " << checked << "\n";
+    }
+    return EXIT_SUCCESS;
+}
+
+
+
+void processInput(GLFWwindow *window, glm::vec3 &cameraPos, glm::vec3 &cameraFront, glm::vec3 &cameraUp)
+{
+
+    // the world is a kilometer across, shift flies fast enough to outrun the disk
+    const float cameraSpeed = glfwGetKey(window, GLFW_KEY_LEFT_SHIFT) == GLFW_PRESS ? 2.f : 0.3f;
+    if (glfwGetKey(window, GLFW_KEY_W) == GLFW_PRESS)
+        cameraPos += cameraSpeed * cameraFront;
+    if (glfwGetKey(window, GLFW_KEY_S) == GLFW_PRESS)
+        cameraPos -= cameraSpeed * cameraFront;
+    if (glfwGetKey(window, GLFW_KEY_A) == GLFW_PRESS)
+        cameraPos -= glm::normalize(glm::cross(cameraFront, cameraUp)) * cameraSpeed;
+    if (glfwGetKey(window, GLFW_KEY_D) == GLFW_PRESS)
+        cameraPos += glm::normalize(glm::cross(cameraFront, cameraUp)) * cameraSpeed;
+    if (glfwGetKey(window, GLFW_KEY_UP) == GLFW_PRESS)
+        cameraPos += glm::normalize(glm::cross(cameraFront, cameraUp)) * cameraSpeed;
+
+}
+
+
+float yaw = -90.f;
+float pitch = 0.f;
+glm::vec3 cameraFront;
+
+void mouseMovement(GLFWwindow *window, double xPos, double yPos) {
+    static float lastX = xPos, lastY = yPos;
+    float xOffset = xPos - lastX;
+    float yOffset = lastY - yPos;
+    
+    constexpr float sensitivity = 0.05f;
+    xOffset *= sensitivity;
+    yOffset *= sensitivity;
+
+    yaw += xOffset;
+    pitch += yOffset;
+
+    if (std::abs(pitch) > 89.f) // don't ever do it this way. I am lazy
+        pitch = std::abs(pitch) / pitch * 89.f;
+
+    cameraFront.x = cos(glm::radians(yaw)) * cos(glm::radians(pitch));
+    cameraFront.y = sin(glm::radians(pitch));
+    cameraFront.z = sin(glm::radians(yaw)) * cos(glm::radians(pitch));
+
+    cameraFront = glm::normalize(cameraFront);
+    lastX = xPos, lastY = yPos;
+}
+
+
+
+
+
+// ./main                  walk around, the world is streamed in around you
+// ./main --pread          the same without io_uring
+// ./main --generate [n]   writes world.bin with n x n chunks
+// ./main --bench [uring|pread] [frames]
+int main(int argc, char **argv) {
+    const char *worldPath = "./world.bin";
+    if (argc > 1 && !std::strcmp(argv[1], "--generate"))
+        return generateWorld(worldPath, argc > 2 ? std::atoi(argv[2]) : 64) ? EXIT_SUCCESS : EXIT_FAILURE;
+    if (argc > 1 && !std::strcmp(argv[1], "--bench")) {
+        std::vector<bool> backends = {true, false};
+        if (argc > 2 && !std::strcmp(argv[2], "uring"))
+            backends = {true};
+        if (argc > 2 && !std::strcmp(argv[2], "pread"))
+            backends = {false};
+        struct stat st;
+        if (stat(worldPath, &st) != 0 && !generateWorld(worldPath, 64))
+            return EXIT_FAILURE;
+        return runBenchmark(worldPath, backends, argc > 3 ? std::atoi(argv[3]) : 1800);
+    }
+    const bool useUring = !(argc > 1 && !std::strcmp(argv[1], "--pread"));
+    struct stat st;
+    if (stat(worldPath, &st) != 0 && !generateWorld(worldPath, 64))
+        return EXIT_FAILURE;
+
+    if (glfwInit() != GLFW_TRUE) {
+        glfwTerminate();
+        std::cerr << "Failed to initialize GLFW";
+        return EXIT_FAILURE;
+    }
+    // setting OpenGL version to 3.3
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+    GLFWwindow *win = glfwCreateWindow(800, 600, "This is a hello window!", NULL, NULL);
+    // setting 'context' for OpenGL, i.e. where to draw on current thread
+    glfwMakeContextCurrent(win);
+    // all it does is fetches us the implemented functions of OpenGL
+    if (glewInit() != GLEW_OK) {
+        glfwTerminate();
+        std::cerr << "Failed to initialize GLEW\n";
+        return EXIT_FAILURE;
+    }
+    int screenWidth, screenHeight;
+    glfwGetFramebufferSize(win, &screenWidth, &screenHeight);
+    glViewport(0, 0, screenWidth, screenHeight);
+
+    glEnable(GL_DEPTH_TEST);
+    float triangle_data[] = {
+        //   vertpos   //  //   normal   //  //texcord//
+    -0.5f, -0.5f, -0.5f,  0.0f,  0.0f, -1.0f,  0.0f, 0.0f,
+     0.5f, -0.5f, -0.5f,  0.0f,  0.0f, -1.0f,  1.0f, 0.0f,
+     0.5f,  0.5f, -0.5f,  0.0f,  0.0f, -1.0f,  1.0f, 1.0f,
+     0.5f,  0.5f, -0.5f,  0.0f,  0.0f, -1.0f,  1.0f, 1.0f,
+    -0.5f,  0.5f, -0.5f,  0.0f,  0.0f, -1.0f,  0.0f, 1.0f,
+    -0.5f, -0.5f, -0.5f,  0.0f,  0.0f, -1.0f,  0.0f, 0.0f,
+
+    -0.5f, -0.5f,  0.5f,  0.0f,  0.0f,  1.0f,  0.0f, 0.0f,
+     0.5f, -0.5f,  0.5f,  0.0f,  0.0f,  1.0f,  1.0f, 0.0f,
+     0.5f,  0.5f,  0.5f,  0.0f,  0.0f,  1.0f,  1.0f, 1.0f,
+     0.5f,  0.5f,  0.5f,  0.0f,  0.0f,  1.0f,  1.0f, 1.0f,
+    -0.5f,  0.5f,  0.5f,  0.0f,  0.0f,  1.0f,  0.0f, 1.0f,
+    -0.5f, -0.5f,  0.5f,  0.0f,  0.0f,  1.0f,  0.0f, 0.0f,
+
+    -0.5f,  0.5f,  0.5f, -1.0f,  0.0f,  0.0f,  1.0f, 0.0f,
+    -0.5f,  0.5f, -0.5f, -1.0f,  0.0f,  0.0f,  1.0f, 1.0f,
+    -0.5f, -0.5f, -0.5f, -1.0f,  0.0f,  0.0f,  0.0f, 1.0f,
+    -0.5f, -0.5f, -0.5f, -1.0f,  0.0f,  0.0f,  0.0f, 1.0f,
+    -0.5f, -0.5f,  0.5f, -1.0f,  0.0f,  0.0f,  0.0f, 0.0f,
+    -0.5f,  0.5f,  0.5f, -1.0f,  0.0f,  0.0f,  1.0f, 0.0f,
+
+     0.5f,  0.5f,  0.5f,  1.0f,  0.0f,  0.0f,  1.0f, 0.0f,
+     0.5f,  0.5f, -0.5f,  1.0f,  0.0f,  0.0f,  1.0f, 1.0f,
+     0.5f, -0.5f, -0.5f,  1.0f,  0.0f,  0.0f,  0.0f, 1.0f,
+     0.5f, -0.5f, -0.5f,  1.0f,  0.0f,  0.0f,  0.0f, 1.0f,
+     0.5f, -0.5f,  0.5f,  1.0f,  0.0f,  0.0f,  0.0f, 0.0f,
+     0.5f,  0.5f,  0.5f,  1.0f,  0.0f,  0.0f,  1.0f, 0.0f,
+
+    -0.5f, -0.5f, -0.5f,  0.0f, -1.0f,  0.0f,  0.0f, 1.0f,
+     0.5f, -0.5f, -0.5f,  0.0f, -1.0f,  0.0f,  1.0f, 1.0f,
+     0.5f, -0.5f,  0.5f,  0.0f, -1.0f,  0.0f,  1.0f, 0.0f,
+     0.5f, -0.5f,  0.5f,  0.0f, -1.0f,  0.0f,  1.0f, 0.0f,
+    -0.5f, -0.5f,  0.5f,  0.0f, -1.0f,  0.0f,  0.0f, 0.0f,
+    -0.5f, -0.5f, -0.5f,  0.0f, -1.0f,  0.0f,  0.0f, 1.0f,
+
+    -0.5f,  0.5f, -0.5f,  0.0f,  1.0f,  0.0f,  0.0f, 1.0f,
+     0.5f,  0.5f, -0.5f,  0.0f,  1.0f,  0.0f,  1.0f, 1.0f,
+     0.5f,  0.5f,  0.5f,  0.0f,  1.0f,  0.0f,  1.0f, 0.0f,
+     0.5f,  0.5f,  0.5f,  0.0f,  1.0f,  0.0f,  1.0f, 0.0f,
+    -0.5f,  0.5f,  0.5f,  0.0f,  1.0f,  0.0f,  0.0f, 0.0f,
+    -0.5f,  0.5f, -0.5f,  0.0f,  1.0f,  0.0f,  0.0f, 1.0f
+        
+    };
+
+
+    constexpr size_t SLOTS = 512;
+    WorldStreamer streamer(SLOTS, 160.f, 192.f);
+    if (!streamer.open(worldPath, useUring, 64)) {
+        glfwTerminate();
+        return EXIT_FAILURE;
+    }
+    const WorldHeader &world = streamer.world();
+    std::cout << "streaming " << world.chunksX << "x" << world.chunksZ << " chunks with " << streamer.readerName() << "\n";
+
+    glm::vec3 cameraPos(world.chunksX * world.chunkSize * 0.5f, 20.f, world.chunksZ * world.chunkSize * 0.5f);
+    cameraFront = glm::vec3(0.f,0.f,-1.f);
+    glm::vec3 cameraUp(0.,1.,0.f);
+    
+
+    Texture2D tex;
+    tex.generate2DTex("./image2d.tex");
+    tex.bind();
+
+    GLuint vbo = 0;
+    glGenBuffers(1, &vbo); 
+    glBindBuffer(GL_ARRAY_BUFFER, vbo);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(triangle_data), triangle_data, GL_STATIC_DRAW);
+
+    GLuint vao = 0;
+    glGenVertexArrays(1, &vao);
+    glBindVertexArray(vao);
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)0);
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)(6 * sizeof(float)));
+    glEnableVertexAttribArray(1);
+    glVertexAttribPointer(2, 3, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)(3 * sizeof(float)));
+    glEnableVertexAttribArray(2);
+
+    // one slot per staging slot, a chunk is uploaded into the slot it was read into
+    GLuint instance_vbo = 0;
+    glGenBuffers(1, &instance_vbo);
+    glBindBuffer(GL_ARRAY_BUFFER, instance_vbo);
+    glBufferData(GL_ARRAY_BUFFER, SLOTS * world.chunkBytes, NULL, GL_DYNAMIC_DRAW);
+    glVertexAttribDivisor(3, 1);
+    glEnableVertexAttribArray(3);
+
+    VertexShader vs;
+    FragmentShader fs;
+    vs.setSource("./vertex.glsl");
+    fs.setSource("./frag.glsl");
+    Program prog;
+    prog.AttachShaders({&vs, &fs});
+
+    prog.UseProgram();
+    prog.setInt("tex", 0);
+    prog.setFloat("spacing", world.chunkSize / CHUNK_SIDE);
+
+    glm::mat4 view; // = glm::translate(glm::mat4(1.f), glm::vec3(0.f,0.f,-3.f));
+       
+
+    glm::mat4 proj = glm::perspective(glm::radians(45.f), float(screenWidth) / screenHeight, 0.1f, 400.f);
+
+    prog.setMat4("proj", proj);
+    prog.setMat4("view", view);
+
+    glfwSetCursorPosCallback(win, mouseMovement); 
+    glfwSetInputMode(win, GLFW_CURSOR, GLFW_CURSOR_DISABLED);  
+
+    double lastReport = glfwGetTime(), updateMs = 0., worstUpdateMs = 0.;
+    int frames = 0;
+    
+    while (!glfwWindowShouldClose(win)) {
+        processInput(win, cameraPos, cameraFront, cameraUp);
+        view = glm::lookAt(cameraPos, cameraFront + cameraPos, cameraUp);
+
+        // never waits: whatever finished reading is uploaded, a few chunks a frame so a burst of
+        // completions doesn't turn into one long frame
+        auto start = std::chrono::steady_clock::now();
+        streamer.update(cameraPos, cameraFront);
+        streamer.drainUploads(16, [&](int slot, const char *data, size_t size) {
+            glBufferSubData(GL_ARRAY_BUFFER, slot * size, size, data);
+        });
+        double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        updateMs += ms;
+        worstUpdateMs = std::max(worstUpdateMs, ms);
+
+        prog.UseProgram();
+        prog.setMat4("view", view);
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+        for (uint32_t chunk : streamer.residentChunks()) {
+            glVertexAttribPointer(3, 4, GL_FLOAT, GL_FALSE, sizeof(ChunkInstance), (void*)(size_t(streamer.slot(chunk)) * world.chunkBytes));
+            glDrawArraysInstanced(GL_TRIANGLES, 0, 36, world.instancesPerChunk);
+        }
+
+        ++frames;
+        if (glfwGetTime() - lastReport > 1.) {
+            lastReport = glfwGetTime();
+            StreamingStats &s = streamer.stats;
+            std::cout << streamer.readerName() << ": " << streamer.residentChunks().size() << " chunks resident, queue depth "
+                      << streamer.inFlight() << " (" << (s.frames ? double(s.queueDepthSum) / s.frames : 0.) << " average, "
+                      << s.queueDepthMax << " max), latency " << s.latencySum / std::max<size_t>(s.completed + s.failed, 1)
+                      << "ms average, " << s.latencyMax << "ms max, " << s.bytes / (1024. * 1024.) << "MB/s, update "
+                      << updateMs / frames << "ms average, " << worstUpdateMs << "ms worst\n";
+            s.reset();
+            frames = 0;
+            updateMs = worstUpdateMs = 0.;
+        }
+        // polls different kinds of events, for example, when we close an application, it fetches that event
+        // or it fetches events like movement of the window.
+        // Without it you can neither move the window or close the window
+        glfwPollEvents();
+        // have you drawn the image, it is stored in the buffer. You can now swap this buffer with main buffer
+        // so the image appears
+        glfwSwapBuffers(win);
+    }
+    glfwTerminate();
+    
+    std::cout << "Window should close now!\n";
+
+    return EXIT_SUCCESS;
+
+}
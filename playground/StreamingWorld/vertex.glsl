@@ -0,0 +1,25 @@
+#version 330 core
+
+layout(location = 0) in vec3 aPos;
+layout(location = 1) in vec2 aTexCoord;
+layout(location = 2) in vec3 aNormal;
+// one per column: xyz of its top center and its height
+layout(location = 3) in vec4 aInstance;
+
+out vec2 texCoord;
+out vec3 normal;
+out float height;
+
+uniform mat4 proj;
+uniform mat4 view;
+uniform float spacing;
+
+
+void main() {
+    // the unit cube stretched into a column standing on y = 0
+    vec3 pos = vec3(aPos.x * spacing + aInstance.x, (aPos.y + 0.5) * aInstance.w, aPos.z * spacing + aInstance.z);
+    gl_Position = proj * view * vec4(pos, 1.0);
+    texCoord = aTexCoord;
+    normal = aNormal;
+    height = aInstance.y;
+}
@@ -0,0 +1,916 @@
+#include <GL/glew.h>
+
+#include <GLFW/glfw3.h>
+#include <algorithm>
+#include <cfloat>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <fstream>
+#include <iomanip>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <glm/ext/matrix_clip_space.hpp>
+#include <glm/ext/matrix_transform.hpp>
+#include <glm/geometric.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/ext/matrix_float4x4.hpp>
+#include <glm/gtc/type_ptr.hpp>
+#include <glm/glm.hpp>
+#include <glm/trigonometric.hpp>
+#define STB_IMAGE_IMPLEMENTATION
+#include <stb/stb_image.h>
+#include <iostream>
+
+class Shader {
+    std::string src; 
+protected:
+    const char *getsrc() {
+        return src.data();
+    }
+    GLuint shader_id = 0;
+    bool isCompiled = false;
+protected:
+    virtual const char *getClassName() = 0;
+    GLint getCompilationStatus(GLuint shader_id) {
+        int status;
+        glGetShaderiv(shader_id, GL_COMPILE_STATUS, &status);
+        return status;
+    }
+    void sendError() {
+        char buffer[1024];
+        glGetShaderInfoLog(shader_id, 1024, NULL, buffer);
+        std::cerr << "ERROR::" << getClassName() << " - " << buffer;
+    }
+public:
+    virtual void compile() = 0;
+    void setSource(const char *s) {
+        std::ifstream sourceFile(s);
+        if (!sourceFile.is_open())
+            return;
+        char buffer[8192];
+        while (sourceFile.read(buffer, 8192)) {
+            src.append(buffer, 8192);
+        }
+        if (!sourceFile.eof()) {
+            src.clear();
+            return;
+        }
+        src.append(buffer, sourceFile.gcount());
+    }
+    friend class Program;
+};
+
+
+class VertexShader : public Shader {
+    virtual const char *getClassName() override {
+        return "VertexShader";
+    }
+public:
+    virtual void compile() override {
+        if (shader_id)
+            glDeleteShader(shader_id);
+        shader_id = glCreateShader(GL_VERTEX_SHADER);
+        const char *src = getsrc();
+        glShaderSource(shader_id, 1, &src, NULL);
+        glCompileShader(shader_id);
+        if (!getCompilationStatus(shader_id)) {
+            sendError();
+        }
+        isCompiled = true;
+    }
+};
+
+class FragmentShader : public Shader {
+    const char *getClassName() override {
+        return "FragmentShader";
+    }
+public:
+    virtual void compile() override {
+        if (shader_id)
+            glDeleteShader(shader_id);
+        shader_id = glCreateShader(GL_FRAGMENT_SHADER);
+        const char *src = getsrc();
+        glShaderSource(shader_id, 1, &src, NULL);
+        glCompileShader(shader_id);
+        if (!getCompilationStatus(shader_id)) {
+            sendError();
+        }
+        isCompiled = true;
+    }
+};
+
+
+class Program {
+    GLuint program_id = 0;
+    void sendError() {
+        char buffer[1024];
+        glGetProgramInfoLog(program_id, 1024, NULL, buffer);
+        std::cerr << "ERROR::PROGRAM: " << " - " << buffer;
+    }
+    bool linkStatus() {
+        int status = 0;
+        glGetProgramiv(program_id, GL_LINK_STATUS, &status);
+        return status;
+    }
+public:
+    Program() {
+        program_id = glCreateProgram();
+    }
+    ~Program() {
+        glDeleteProgram(program_id);
+    }
+    void AttachShaders(std::initializer_list<Shader*> shaders) {
+        auto i = shaders.begin();
+        while (i != shaders.end()) {
+            if (!(*i)->isCompiled)
+                (*i)->compile();
+            glAttachShader(program_id, (*i)->shader_id);
+            ++i;
+        }
+        glLinkProgram(program_id);
+        if (!linkStatus()) {
+            sendError();
+        }
+    }
+    void UseProgram() {
+        glUseProgram(program_id);
+    }
+    void setMat4(const char *locName, const glm::mat4 &mat) {
+        int location = glGetUniformLocation(program_id, locName);
+        if (location == -1)
+            return;
+        glUniformMatrix4fv(location, 1, GL_FALSE, glm::value_ptr(mat));
+    }
+    void setInt(const char *locName, int value) {
+        int location = glGetUniformLocation(program_id, locName);
+        if (location == -1)
+            return;
+        glUniform1i(location, value);
+    }
+    void setFloat(const char *locName, float value) {
+        int location = glGetUniformLocation(program_id, locName);
+        if (location == -1)
+            return;
+        glUniform1f(location, value);
+    }
+    void setVec3(const char *locName, const glm::vec3 &vec) {
+        int location = glGetUniformLocation(program_id, locName);
+        if (location == -1)
+            return;
+        glUniform3f(location, vec.x, vec.y, vec.z);
+    }
+    void setVec4(const char *locName, const glm::vec4 &vec) {
+        int location = glGetUniformLocation(program_id, locName);
+        if (location == -1)
+            return;
+        glUniform4f(location, vec.x, vec.y, vec.z, vec.w);
+    }
+    void bindUniformBlock(const char *blockName, GLuint binding) {
+        GLuint index = glGetUniformBlockIndex(program_id, blockName);
+        if (index == GL_INVALID_INDEX) {
+            std::cerr << "ERROR::PROGRAM - no uniform block " << blockName << "\n";
+            return;
+        }
+        glUniformBlockBinding(program_id, index, binding);
+    }
+};
+
+
+
+
+// ---------------------------------------------------------------------------------------------------------
+// GPU memory accounting. GL doesn't say how much memory anything takes, so the engine goes through the
+// functions below instead of calling glBufferData, glTexImage2D and glRenderbufferStorage itself, and the
+// tracker writes down the size each one was given, under a category and a label. the numbers are what we
+// asked for, drivers pad and align on top of that, which is why the driver's own count is shown next to them
+// when it has one
+// ---------------------------------------------------------------------------------------------------------
+
+enum GpuMemoryCategory {
+    GPU_MEMORY_VERTEX,
+    GPU_MEMORY_INDEX,
+    GPU_MEMORY_UNIFORM,
+    GPU_MEMORY_TEXTURE,
+    GPU_MEMORY_RENDER_TARGET,
+    GPU_MEMORY_CATEGORIES
+};
+
+const char *gpuMemoryCategoryName(GpuMemoryCategory category) {
+    static const char *names[GPU_MEMORY_CATEGORIES] = {"vertex", "index", "uniform", "texture", "render target"};
+    return names[category];
+}
+
+std::string formatBytes(size_t bytes) {
+    char text[32];
+    if (bytes >= size_t(1) << 20)
+        std::snprintf(text, sizeof(text), "%.1fMB", bytes / double(1 << 20));
+    else
+        std::snprintf(text, sizeof(text), "%.1fKB", bytes / 1024.);
+    return text;
+}
+
+
+class GpuMemoryTracker {
+public:
+    // buffers, textures and renderbuffers are numbered separately, so the kind is part of the key
+    enum ObjectKind { BUFFER, TEXTURE, RENDERBUFFER };
+private:
+    static constexpr int MAX_LEVELS = 16;
+    struct Allocation {
+        GpuMemoryCategory category;
+        std::string label;
+        size_t bytes = 0;
+        size_t levels[MAX_LEVELS] = {};  // textures, per mip level
+    };
+    std::unordered_map<uint64_t, Allocation> allocations;
+    size_t live[GPU_MEMORY_CATEGORIES] = {}, peak[GPU_MEMORY_CATEGORIES] = {};
+    size_t budget[GPU_MEMORY_CATEGORIES] = {};  // 0 is no budget
+    size_t liveTotal = 0, peakTotal = 0, totalBudget = 0;
+    bool over[GPU_MEMORY_CATEGORIES + 1] = {};
+
+    static uint64_t key(ObjectKind kind, GLuint id) {
+        return uint64_t(kind) << 32 | id;
+    }
+    void add(GpuMemoryCategory category, size_t bytes) {
+        live[category] += bytes;
+        liveTotal += bytes;
+        peak[category] = std::max(peak[category], live[category]);
+        peakTotal = std::max(peakTotal, liveTotal);
+        // only the crossing is reported, not every allocation made while over
+        for (int i = 0; i <= GPU_MEMORY_CATEGORIES; ++i) {
+            size_t limit = i < GPU_MEMORY_CATEGORIES ? budget[i] : totalBudget;
+            size_t used = i < GPU_MEMORY_CATEGORIES ? live[i] : liveTotal;
+            bool isOver = limit && used > limit;
+            if (isOver && !over[i]) {
+                ++budgetOverruns;
+                std::cerr << "ERROR::GPU_MEMORY - " << (i < GPU_MEMORY_CATEGORIES ? gpuMemoryCategoryName(GpuMemoryCategory(i)) : "total")
+                          << " is over its budget, " << formatBytes(used) << " of " << formatBytes(limit) << "\n";
+            }
+            over[i] = isOver;
+        }
+    }
+    // the over flags are left alone here, a resize takes the old size off before adding the new one and
+    // shouldn't count as going over again
+    void remove(GpuMemoryCategory category, size_t bytes) {
+        live[category] -= bytes;
+        liveTotal -= bytes;
+    }
+public:
+    size_t budgetOverruns = 0;
+
+    void setBudget(GpuMemoryCategory category, size_t bytes) {
+        budget[category] = bytes;
+    }
+    void setTotalBudget(size_t bytes) {
+        totalBudget = bytes;
+    }
+    // a new size for an object, whatever it had before is replaced. level is for textures, -1 replaces all
+    // of the texture's levels with one number
+    void record(ObjectKind kind, GLuint id, GpuMemoryCategory category, size_t bytes, const char *label, int level = 0) {
+        Allocation &a = allocations[key(kind, id)];
+        if (a.bytes)
+            remove(a.category, a.bytes);
+        if (level < 0 || a.category != category)
+            std::fill(std::begin(a.levels), std::end(a.levels), 0);
+        a.category = category;
+        if (label)
+            a.label = label;
+        if (kind == TEXTURE && level >= 0 && level < MAX_LEVELS) {
+            a.levels[level] = bytes;
+            a.bytes = 0;
+            for (size_t levelBytes : a.levels)
+                a.bytes += levelBytes;
+        } else {
+            a.bytes = bytes;
+        }
+        add(category, a.bytes);
+    }
+    void release(ObjectKind kind, GLuint id) {
+        auto it = allocations.find(key(kind, id));
+        if (it == allocations.end())
+            return;
+        GpuMemoryCategory category = it->second.category;
+        remove(category, it->second.bytes);
+        allocations.erase(it);
+        over[category] = budget[category] && live[category] > budget[category];
+        over[GPU_MEMORY_CATEGORIES] = totalBudget && liveTotal > totalBudget;
+    }
+    size_t bytes(ObjectKind kind, GLuint id) const {
+        auto it = allocations.find(key(kind, id));
+        return it == allocations.end() ? 0 : it->second.bytes;
+    }
+    size_t levelBytes(GLuint texture, int level) const {
+        auto it = allocations.find(key(TEXTURE, texture));
+        return it == allocations.end() || level >= MAX_LEVELS ? 0 : it->second.levels[level];
+    }
+    size_t liveBytes() const {
+        return liveTotal;
+    }
+    size_t liveBytes(GpuMemoryCategory category) const {
+        return live[category];
+    }
+    size_t count() const {
+        return allocations.size();
+    }
+    bool withinBudget() const {
+        for (bool isOver : over)
+            if (isOver)
+                return false;
+        return true;
+    }
+    // one line, for the window title
+    std::string summary() const {
+        std::string out = "GPU " + formatBytes(liveTotal) + " (peak " + formatBytes(peakTotal) + ")";
+        for (int i = 0; i < GPU_MEMORY_CATEGORIES; ++i)
+            out += std::string(" | ") + gpuMemoryCategoryName(GpuMemoryCategory(i)) + " " + formatBytes(live[i]);
+        return out;
+    }
+    void report(std::ostream &out, size_t largest = 8) const {
+        out << "gpu memory: " << formatBytes(liveTotal) << " live in " << allocations.size() << " objects, peak " << formatBytes(peakTotal);
+        if (totalBudget)
+            out << ", budget " << formatBytes(totalBudget);
+        out << "\n";
+        for (int i = 0; i < GPU_MEMORY_CATEGORIES; ++i) {
+            out << "  " << std::left << std::setw(14) << gpuMemoryCategoryName(GpuMemoryCategory(i)) << std::right << std::setw(10)
+                << formatBytes(live[i]) << "  peak " << std::setw(10) << formatBytes(peak[i]);
+            if (budget[i])
+                out << "  budget " << formatBytes(budget[i]) << (live[i] > budget[i] ? "  OVER" : "");
+            out << "\n";
+        }
+        std::vector<const Allocation*> sorted;
+        for (const auto &a : allocations)
+            sorted.push_back(&a.second);
+        largest = std::min(largest, sorted.size());
+        std::partial_sort(sorted.begin(), sorted.begin() + largest, sorted.end(), [](const Allocation *a, const Allocation *b) {
+            return a->bytes > b->bytes;
+        });
+        out << "  largest:\n";
+        for (size_t i = 0; i < largest; ++i)
+            out << "    " << std::setw(10) << formatBytes(sorted[i]->bytes) << "  " << std::left << std::setw(14)
+                << gpuMemoryCategoryName(sorted[i]->category) << std::right << sorted[i]->label << "\n";
+    }
+    // whatever is still recorded, at shutdown everything should have been released
+    bool reportLeaks() const {
+        for (const auto &a : allocations)
+            std::cerr << "ERROR::GPU_MEMORY - " << a.second.label << " (" << formatBytes(a.second.bytes) << ") was never freed\n";
+        return allocations.empty();
+    }
+};
+
+GpuMemoryTracker gpuMemory;
+
+
+// bytes per texel of the uncompressed formats the lessons use. RGB8 and RGB16F are counted as stored,
+// most drivers keep them as 4 channels though
+size_t texelBytes(GLint internalFormat) {
+    switch (internalFormat) {
+    case GL_R8: case GL_RED: return 1;
+    case GL_RG8: case GL_RG: case GL_R16F: case GL_DEPTH_COMPONENT16: return 2;
+    case GL_RGB8: case GL_RGB: case GL_SRGB8: return 3;
+    case GL_RGB16F: return 6;
+    case GL_RGBA16F: case GL_RG32F: return 8;
+    case GL_RGB32F: return 12;
+    case GL_RGBA32F: return 16;
+    default: return 4;  // RGBA8, SRGB8_ALPHA8, R32F, the 24 and 32 bit depth formats and depth-stencil
+    }
+}
+
+GpuMemoryCategory bufferCategory(GLenum target) {
+    switch (target) {
+    case GL_ELEMENT_ARRAY_BUFFER: return GPU_MEMORY_INDEX;
+    case GL_UNIFORM_BUFFER: return GPU_MEMORY_UNIFORM;
+    default: return GPU_MEMORY_VERTEX;
+    }
+}
+
+// the label also goes to GL where it can take one, so it shows up in graphics debuggers
+void labelObject(GLenum identifier, GLuint id, const char *label) {
+    if (label && GLEW_VERSION_4_3)
+        glObjectLabel(identifier, id, -1, label);
+}
+
+void gpuBufferData(GLuint buffer, GLenum target, GLsizeiptr size, const void *data, GLenum usage, const char *label) {
+    glBindBuffer(target, buffer);
+    glBufferData(target, size, data, usage);
+    gpuMemory.record(GpuMemoryTracker::BUFFER, buffer, bufferCategory(target), size_t(size), label);
+    labelObject(GL_BUFFER, buffer, label);
+}
+
+void gpuTexImage2D(GLuint texture, GLint level, GLint internalFormat, GLsizei width, GLsizei height, GLenum format, GLenum type,
+                   const void *pixels, const char *label, GpuMemoryCategory category = GPU_MEMORY_TEXTURE) {
+    glBindTexture(GL_TEXTURE_2D, texture);
+    glTexImage2D(GL_TEXTURE_2D, level, internalFormat, width, height, 0, format, type, pixels);
+    gpuMemory.record(GpuMemoryTracker::TEXTURE, texture, category, size_t(width) * height * texelBytes(internalFormat), label, level);
+    labelObject(GL_TEXTURE, texture, label);
+}
+
+// every level below 0 down to 1x1, each a quarter of the one above
+void gpuGenerateMipmap(GLuint texture, GpuMemoryCategory category = GPU_MEMORY_TEXTURE) {
+    glBindTexture(GL_TEXTURE_2D, texture);
+    glGenerateMipmap(GL_TEXTURE_2D);
+    GLint width = 0, height = 0;
+    glGetTexLevelParameteriv(GL_TEXTURE_2D, 0, GL_TEXTURE_WIDTH, &width);
+    glGetTexLevelParameteriv(GL_TEXTURE_2D, 0, GL_TEXTURE_HEIGHT, &height);
+    size_t level0 = gpuMemory.levelBytes(texture, 0);
+    if (!level0 || !width || !height)
+        return;
+    const size_t perTexel = level0 / (size_t(width) * height);
+    for (int level = 1; width > 1 || height > 1; ++level) {
+        width = std::max(1, width / 2);
+        height = std::max(1, height / 2);
+        gpuMemory.record(GpuMemoryTracker::TEXTURE, texture, category, size_t(width) * height * perTexel, nullptr, level);
+    }
+}
+
+void gpuRenderbufferStorage(GLuint renderbuffer, GLenum internalFormat, GLsizei width, GLsizei height, const char *label) {
+    glBindRenderbuffer(GL_RENDERBUFFER, renderbuffer);
+    glRenderbufferStorage(GL_RENDERBUFFER, internalFormat, width, height);
+    gpuMemory.record(GpuMemoryTracker::RENDERBUFFER, renderbuffer, GPU_MEMORY_RENDER_TARGET, size_t(width) * height * texelBytes(internalFormat), label);
+    labelObject(GL_RENDERBUFFER, renderbuffer, label);
+}
+
+void gpuDeleteBuffer(GLuint &buffer) {
+    gpuMemory.release(GpuMemoryTracker::BUFFER, buffer);
+    glDeleteBuffers(1, &buffer);
+    buffer = 0;
+}
+
+void gpuDeleteTexture(GLuint &texture) {
+    gpuMemory.release(GpuMemoryTracker::TEXTURE, texture);
+    glDeleteTextures(1, &texture);
+    texture = 0;
+}
+
+void gpuDeleteRenderbuffer(GLuint &renderbuffer) {
+    gpuMemory.release(GpuMemoryTracker::RENDERBUFFER, renderbuffer);
+    glDeleteRenderbuffers(1, &renderbuffer);
+    renderbuffer = 0;
+}
+
+
+// what the driver says, through the NVIDIA or the AMD extension. the AMD one only tells what is free
+struct DriverMemoryInfo {
+    const char *source = nullptr;  // null when neither extension is there
+    size_t totalKB = 0, freeKB = 0;
+};
+
+DriverMemoryInfo queryDriverMemory() {
+    DriverMemoryInfo info;
+    if (GLEW_NVX_gpu_memory_info) {
+        GLint total = 0, available = 0;
+        glGetIntegerv(GL_GPU_MEMORY_INFO_DEDICATED_VIDMEM_NVX, &total);
+        glGetIntegerv(GL_GPU_MEMORY_INFO_CURRENT_AVAILABLE_VIDMEM_NVX, &available);
+        info.source = "GL_NVX_gpu_memory_info";
+        info.totalKB = size_t(total);
+        info.freeKB = size_t(available);
+    } else if (GLEW_ATI_meminfo) {
+        // free in the pool, largest free block, and the same two for shared memory
+        GLint texture[4] = {};
+        glGetIntegerv(GL_TEXTURE_FREE_MEMORY_ATI, texture);
+        info.source = "GL_ATI_meminfo";
+        info.freeKB = size_t(texture[0]);
+    }
+    return info;
+}
+
+void reportDriverMemory(std::ostream &out, const DriverMemoryInfo &atStart) {
+    DriverMemoryInfo now = queryDriverMemory();
+    if (!now.source) {
+        out << "  driver: no memory info extension\n";
+        return;
+    }
+    out << "  driver (" << now.source << "): " << formatBytes(now.freeKB * 1024) << " free";
+    if (now.totalKB)
+        out << " of " << formatBytes(now.totalKB * 1024);
+    // free memory also moves with other programs, so this is only roughly what we took
+    long long usedKB = (long long)atStart.freeKB - (long long)now.freeKB;
+    out << ", " << (usedKB < 0 ? "-" : "") << formatBytes(size_t(std::llabs(usedKB)) * 1024) << " used since start against "
+        << formatBytes(gpuMemory.liveBytes()) << " tracked\n";
+}
+
+
+class Texture2D {
+    GLuint tex_id = 0;
+public:
+    void generate2DTex(const char *image_path) {
+        int width, height, nChannels;
+        stbi_set_flip_vertically_on_load(true);
+        uint8_t *raw_image = stbi_load(image_path, &width, &height, &nChannels, 4);
+        if (!raw_image) {
+            std::cerr << "ERROR::TEXTURE - can't load " << image_path << "\n";
+            return;
+        }
+        glGenTextures(1, &tex_id);
+        glBindTexture(GL_TEXTURE_2D, tex_id);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        gpuTexImage2D(tex_id, 0, GL_RGBA8, width, height, GL_RGBA, GL_UNSIGNED_BYTE, raw_image, image_path);
+        gpuGenerateMipmap(tex_id);
+        stbi_image_free(raw_image);
+    }
+    void release() {
+        gpuDeleteTexture(tex_id);
+    }
+    void bind() {
+        glBindTexture(GL_TEXTURE_2D, tex_id);
+    }
+};
+
+
+// the scene is drawn into this and then blitted to the window, so there's a render target to account for.
+// it follows the window's size, and each resize shows up as the same objects getting new sizes
+struct RenderTarget {
+    GLuint fbo = 0, color = 0, depth = 0;
+    int width = 0, height = 0;
+    void resize(int w, int h) {
+        if (w == width && h == height)
+            return;
+        width = w;
+        height = h;
+        if (!fbo) {
+            glGenFramebuffers(1, &fbo);
+            glGenTextures(1, &color);
+            glGenRenderbuffers(1, &depth);
+        }
+        gpuTexImage2D(color, 0, GL_RGBA16F, w, h, GL_RGBA, GL_FLOAT, nullptr, "scene color", GPU_MEMORY_RENDER_TARGET);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        gpuRenderbufferStorage(depth, GL_DEPTH24_STENCIL8, w, h, "scene depth");
+        glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, color, 0);
+        glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, depth);
+        if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+            std::cerr << "ERROR::FRAMEBUFFER - scene target is incomplete\n";
+        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    }
+    void release() {
+        gpuDeleteTexture(color);
+        gpuDeleteRenderbuffer(depth);
+        glDeleteFramebuffers(1, &fbo);
+        fbo = 0;
+        width = height = 0;
+    }
+};
+
+
+// --budget category=MB, with total as the category for everything together
+bool parseBudget(const char *arg) {
+    const char *eq = std::strchr(arg, '=');
+    if (!eq)
+        return false;
+    std::string name(arg, eq - arg);
+    size_t bytes = size_t(std::atof(eq + 1) * (1 << 20));
+    if (name == "total") {
+        gpuMemory.setTotalBudget(bytes);
+        return true;
+    }
+    for (int i = 0; i < GPU_MEMORY_CATEGORIES; ++i) {
+        std::string category = gpuMemoryCategoryName(GpuMemoryCategory(i));
+        std::replace(category.begin(), category.end(), ' ', '_');
+        if (name == category) {
+            gpuMemory.setBudget(GpuMemoryCategory(i), bytes);
+            return true;
+        }
+    }
+    return false;
+}
+
+
+// position, normal and texture coordinates per vertex, the same layout as the cube
+std::vector<float> makeSphereVertices(int rings, int segments) {
+    std::vector<float> vertices(size_t(rings + 1) * (segments + 1) * 8);
+    float *v = vertices.data();
+    for (int r = 0; r <= rings; ++r) {
+        float theta = glm::pi<float>() * r / rings;
+        for (int s = 0; s <= segments; ++s) {
+            float phi = 2.f * glm::pi<float>() * s / segments;
+            float nx = std::sin(theta) * std::cos(phi), ny = std::cos(theta), nz = std::sin(theta) * std::sin(phi);
+            float vertex[8] = {nx * 0.5f, ny * 0.5f, nz * 0.5f, nx, ny, nz, float(s) / segments, 1.f - float(r) / rings};
+            std::memcpy(v, vertex, sizeof(vertex));
+            v += 8;
+        }
+    }
+    return vertices;
+}
+
+std::vector<uint32_t> makeSphereIndices(int rings, int segments) {
+    std::vector<uint32_t> indices(size_t(rings) * segments * 6);
+    uint32_t *i = indices.data();
+    for (int r = 0; r < rings; ++r) {
+        for (int s = 0; s < segments; ++s) {
+            uint32_t a = r * (segments + 1) + s, b = a + segments + 1;
+            uint32_t quad[6] = {a, a + 1, b, a + 1, b + 1, b};
+            std::memcpy(i, quad, sizeof(quad));
+            i += 6;
+        }
+    }
+    return indices;
+}
+
+
+
+void processInput(GLFWwindow *window, glm::vec3 &cameraPos, glm::vec3 &cameraFront, glm::vec3 &cameraUp)
+{
+
+    const float cameraSpeed = 0.05f; // adjust accordingly
+    if (glfwGetKey(window, GLFW_KEY_W) == GLFW_PRESS)
+        cameraPos += cameraSpeed * cameraFront;
+    if (glfwGetKey(window, GLFW_KEY_S) == GLFW_PRESS)
+        cameraPos -= cameraSpeed * cameraFront;
+    if (glfwGetKey(window, GLFW_KEY_A) == GLFW_PRESS)
+        cameraPos -= glm::normalize(glm::cross(cameraFront, cameraUp)) * cameraSpeed;
+    if (glfwGetKey(window, GLFW_KEY_D) == GLFW_PRESS)
+        cameraPos += glm::normalize(glm::cross(cameraFront, cameraUp)) * cameraSpeed;
+    if (glfwGetKey(window, GLFW_KEY_UP) == GLFW_PRESS)
+        cameraPos += glm::normalize(glm::cross(cameraFront, cameraUp)) * cameraSpeed;
+
+}
+
+// true only on the frame the key went down
+bool keyPressed(GLFWwindow *window, int key) {
+    static bool down[GLFW_KEY_LAST + 1] = {};
+    bool now = glfwGetKey(window, key) == GLFW_PRESS;
+    bool pressed = now && !down[key];
+    down[key] = now;
+    return pressed;
+}
+
+
+float yaw = -90.f;
+float pitch = 0.f;
+glm::vec3 cameraFront;
+
+void mouseMovement(GLFWwindow *window, double xPos, double yPos) {
+    static float lastX = xPos, lastY = yPos;
+    float xOffset = xPos - lastX;
+    float yOffset = lastY - yPos;
+    
+    constexpr float sensitivity = 0.05f;
+    xOffset *= sensitivity;
+    yOffset *= sensitivity;
+
+    yaw += xOffset;
+    pitch += yOffset;
+
+    if (std::abs(pitch) > 89.f) // don't ever do it this way. I am lazy
+        pitch = std::abs(pitch) / pitch * 89.f;
+
+    cameraFront.x = cos(glm::radians(yaw)) * cos(glm::radians(pitch));
+    cameraFront.y = sin(glm::radians(pitch));
+    cameraFront.z = sin(glm::radians(yaw)) * cos(glm::radians(pitch));
+
+    cameraFront = glm::normalize(cameraFront);
+    lastX = xPos, lastY = yPos;
+}
+
+
+int main(int argc, char **argv) {
+    bool strict = false;
+    for (int i = 1; i < argc; ++i) {
+        if (!std::strcmp(argv[i], "--budget") && i + 1 < argc) {
+            if (!parseBudget(argv[++i]))
+                std::cerr << "ERROR::GPU_MEMORY - budgets look like texture=256, render_target=64 or total=512 (MB)\n";
+        } else if (!std::strcmp(argv[i], "--strict")) {
+            strict = true;
+        }
+    }
+
+    if (glfwInit() != GLFW_TRUE) {
+        glfwTerminate();
+        std::cerr << "Failed to initialize GLFW";
+        return EXIT_FAILURE;
+    }
+    // setting OpenGL version to 3.3
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+    GLFWwindow *win = glfwCreateWindow(800, 600, "This is a hello window!", NULL, NULL);
+    // setting 'context' for OpenGL, i.e. where to draw on current thread
+    glfwMakeContextCurrent(win);
+    // all it does is fetches us the implemented functions of OpenGL
+    if (glewInit() != GLEW_OK) {
+        glfwTerminate();
+        std::cerr << "Failed to initialize GLEW\n";
+        return EXIT_FAILURE;
+    }
+    int screenWidth, screenHeight;
+    glfwGetFramebufferSize(win, &screenWidth, &screenHeight);
+    glViewport(0, 0, screenWidth, screenHeight);
+
+    // before we allocate anything, to compare against later
+    const DriverMemoryInfo driverAtStart = queryDriverMemory();
+
+    glEnable(GL_DEPTH_TEST);
+    float triangle_data[] = {
+        //   vertpos   //  //   normal   //  //texcord//
+    -0.5f, -0.5f, -0.5f,  0.0f,  0.0f, -1.0f,  0.0f, 0.0f,
+     0.5f, -0.5f, -0.5f,  0.0f,  0.0f, -1.0f,  1.0f, 0.0f,
+     0.5f,  0.5f, -0.5f,  0.0f,  0.0f, -1.0f,  1.0f, 1.0f,
+     0.5f,  0.5f, -0.5f,  0.0f,  0.0f, -1.0f,  1.0f, 1.0f,
+    -0.5f,  0.5f, -0.5f,  0.0f,  0.0f, -1.0f,  0.0f, 1.0f,
+    -0.5f, -0.5f, -0.5f,  0.0f,  0.0f, -1.0f,  0.0f, 0.0f,
+
+    -0.5f, -0.5f,  0.5f,  0.0f,  0.0f,  1.0f,  0.0f, 0.0f,
+     0.5f, -0.5f,  0.5f,  0.0f,  0.0f,  1.0f,  1.0f, 0.0f,
+     0.5f,  0.5f,  0.5f,  0.0f,  0.0f,  1.0f,  1.0f, 1.0f,
+     0.5f,  0.5f,  0.5f,  0.0f,  0.0f,  1.0f,  1.0f, 1.0f,
+    -0.5f,  0.5f,  0.5f,  0.0f,  0.0f,  1.0f,  0.0f, 1.0f,
+    -0.5f, -0.5f,  0.5f,  0.0f,  0.0f,  1.0f,  0.0f, 0.0f,
+
+    -0.5f,  0.5f,  0.5f, -1.0f,  0.0f,  0.0f,  1.0f, 0.0f,
+    -0.5f,  0.5f, -0.5f, -1.0f,  0.0f,  0.0f,  1.0f, 1.0f,
+    -0.5f, -0.5f, -0.5f, -1.0f,  0.0f,  0.0f,  0.0f, 1.0f,
+    -0.5f, -0.5f, -0.5f, -1.0f,  0.0f,  0.0f,  0.0f, 1.0f,
+    -0.5f, -0.5f,  0.5f, -1.0f,  0.0f,  0.0f,  0.0f, 0.0f,
+    -0.5f,  0.5f,  0.5f, -1.0f,  0.0f,  0.0f,  1.0f, 0.0f,
+
+     0.5f,  0.5f,  0.5f,  1.0f,  0.0f,  0.0f,  1.0f, 0.0f,
+     0.5f,  0.5f, -0.5f,  1.0f,  0.0f,  0.0f,  1.0f, 1.0f,
+     0.5f, -0.5f, -0.5f,  1.0f,  0.0f,  0.0f,  0.0f, 1.0f,
+     0.5f, -0.5f, -0.5f,  1.0f,  0.0f,  0.0f,  0.0f, 1.0f,
+     0.5f, -0.5f,  0.5f,  1.0f,  0.0f,  0.0f,  0.0f, 0.0f,
+     0.5f,  0.5f,  0.5f,  1.0f,  0.0f,  0.0f,  1.0f, 0.0f,
+
+    -0.5f, -0.5f, -0.5f,  0.0f, -1.0f,  0.0f,  0.0f, 1.0f,
+     0.5f, -0.5f, -0.5f,  0.0f, -1.0f,  0.0f,  1.0f, 1.0f,
+     0.5f, -0.5f,  0.5f,  0.0f, -1.0f,  0.0f,  1.0f, 0.0f,
+     0.5f, -0.5f,  0.5f,  0.0f, -1.0f,  0.0f,  1.0f, 0.0f,
+    -0.5f, -0.5f,  0.5f,  0.0f, -1.0f,  0.0f,  0.0f, 0.0f,
+    -0.5f, -0.5f, -0.5f,  0.0f, -1.0f,  0.0f,  0.0f, 1.0f,
+
+    -0.5f,  0.5f, -0.5f,  0.0f,  1.0f,  0.0f,  0.0f, 1.0f,
+     0.5f,  0.5f, -0.5f,  0.0f,  1.0f,  0.0f,  1.0f, 1.0f,
+     0.5f,  0.5f,  0.5f,  0.0f,  1.0f,  0.0f,  1.0f, 0.0f,
+     0.5f,  0.5f,  0.5f,  0.0f,  1.0f,  0.0f,  1.0f, 0.0f,
+    -0.5f,  0.5f,  0.5f,  0.0f,  1.0f,  0.0f,  0.0f, 0.0f,
+    -0.5f,  0.5f, -0.5f,  0.0f,  1.0f,  0.0f,  0.0f, 1.0f
+        
+    };
+
+
+    glm::vec3 cameraPos(0.f, 0.f, 3.f);
+    cameraFront = glm::vec3(0.f,0.f,-1.f);
+    glm::vec3 cameraUp(0.,1.,0.f);
+    
+
+    Texture2D tex;
+    tex.generate2DTex("./image2d.tex");
+
+    GLuint vbo = 0;
+    glGenBuffers(1, &vbo); 
+    gpuBufferData(vbo, GL_ARRAY_BUFFER, sizeof(triangle_data), triangle_data, GL_STATIC_DRAW, "cube vertices");
+
+    GLuint vao = 0;
+    glGenVertexArrays(1, &vao);
+    glBindVertexArray(vao);
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)0);
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)(6 * sizeof(float)));
+    glEnableVertexAttribArray(1);
+    glVertexAttribPointer(2, 3, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)(3 * sizeof(float)));
+    glEnableVertexAttribArray(2);
+
+    // and a sphere, for something in the index category
+    const int RINGS = 64, SEGMENTS = 128;
+    std::vector<float> sphereVertices = makeSphereVertices(RINGS, SEGMENTS);
+    std::vector<uint32_t> sphereIndices = makeSphereIndices(RINGS, SEGMENTS);
+    GLuint sphereVbo = 0, sphereEbo = 0, sphereVao = 0;
+    glGenBuffers(1, &sphereVbo);
+    glGenBuffers(1, &sphereEbo);
+    glGenVertexArrays(1, &sphereVao);
+    glBindVertexArray(sphereVao);
+    gpuBufferData(sphereVbo, GL_ARRAY_BUFFER, sphereVertices.size() * sizeof(float), sphereVertices.data(), GL_STATIC_DRAW, "sphere vertices");
+    gpuBufferData(sphereEbo, GL_ELEMENT_ARRAY_BUFFER, sphereIndices.size() * sizeof(uint32_t), sphereIndices.data(), GL_STATIC_DRAW, "sphere indices");
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)0);
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)(6 * sizeof(float)));
+    glEnableVertexAttribArray(1);
+    glVertexAttribPointer(2, 3, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)(3 * sizeof(float)));
+    glEnableVertexAttribArray(2);
+    glBindVertexArray(0);
+
+    VertexShader vs;
+    FragmentShader fs;
+    vs.setSource("./vertex.glsl");
+    fs.setSource("./frag.glsl");
+    Program prog;
+    prog.AttachShaders({&vs, &fs});
+
+    prog.UseProgram();
+    prog.setInt("tex", 0);
+    prog.bindUniformBlock("Camera", 0);
+
+    GLuint cameraUbo = 0;
+    glGenBuffers(1, &cameraUbo);
+    gpuBufferData(cameraUbo, GL_UNIFORM_BUFFER, 2 * sizeof(glm::mat4), nullptr, GL_DYNAMIC_DRAW, "camera");
+    glBindBufferBase(GL_UNIFORM_BUFFER, 0, cameraUbo);
+
+    glm::mat4 view; // = glm::translate(glm::mat4(1.f), glm::vec3(0.f,0.f,-3.f));
+
+    RenderTarget target;
+    target.resize(screenWidth, screenHeight);
+
+    // N streams in another big texture and B drops the oldest, to watch the totals and the peaks move
+    const int STREAMED_SIZE = 2048;
+    std::deque<GLuint> streamed;
+    int streamedCount = 0;
+    std::vector<uint8_t> streamedPixels(size_t(STREAMED_SIZE) * STREAMED_SIZE * 4);
+    for (size_t i = 0; i < streamedPixels.size(); ++i)
+        streamedPixels[i] = uint8_t((i / 4 % STREAMED_SIZE) ^ (i / 4 / STREAMED_SIZE));
+
+    glfwSetCursorPosCallback(win, mouseMovement); 
+    glfwSetInputMode(win, GLFW_CURSOR, GLFW_CURSOR_DISABLED);  
+
+    std::cout << "N/B: stream a texture in/out, M: print the memory report\n";
+    double lastReport = glfwGetTime();
+    
+    while (!glfwWindowShouldClose(win)) {
+        processInput(win, cameraPos, cameraFront, cameraUp);
+        view = glm::lookAt(cameraPos, cameraFront + cameraPos, cameraUp);
+
+        if (keyPressed(win, GLFW_KEY_N)) {
+            GLuint id = 0;
+            glGenTextures(1, &id);
+            std::string label = "streamed texture " + std::to_string(streamedCount++);
+            gpuTexImage2D(id, 0, GL_RGBA8, STREAMED_SIZE, STREAMED_SIZE, GL_RGBA, GL_UNSIGNED_BYTE, streamedPixels.data(), label.c_str());
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+            gpuGenerateMipmap(id);
+            streamed.push_back(id);
+        }
+        if (keyPressed(win, GLFW_KEY_B) && !streamed.empty()) {
+            gpuDeleteTexture(streamed.front());
+            streamed.pop_front();
+        }
+        if (keyPressed(win, GLFW_KEY_M)) {
+            gpuMemory.report(std::cout);
+            reportDriverMemory(std::cout, driverAtStart);
+        }
+
+        glfwGetFramebufferSize(win, &screenWidth, &screenHeight);
+        if (screenWidth > 0 && screenHeight > 0)
+            target.resize(screenWidth, screenHeight);
+        glm::mat4 camera[2] = {glm::perspective(glm::radians(45.f), float(target.width) / target.height, 0.1f, 100.f), view};
+        glBindBuffer(GL_UNIFORM_BUFFER, cameraUbo);
+        glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(camera), camera);
+
+        glBindFramebuffer(GL_FRAMEBUFFER, target.fbo);
+        glViewport(0, 0, target.width, target.height);
+        prog.UseProgram();
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+        tex.bind();
+        glBindVertexArray(vao);
+        prog.setMat4("model", glm::rotate(glm::translate(glm::mat4(1.f), glm::vec3(-1.f, 0.f, -3.f)), float(glfwGetTime()), glm::vec3(0.5f, 1.f, 0.f)));
+        glDrawArrays(GL_TRIANGLES, 0, 36);
+        glBindVertexArray(sphereVao);
+        prog.setMat4("model", glm::translate(glm::mat4(1.f), glm::vec3(1.f, 0.f, -3.f)));
+        glDrawElements(GL_TRIANGLES, GLsizei(sphereIndices.size()), GL_UNSIGNED_INT, 0);
+        glBindFramebuffer(GL_READ_FRAMEBUFFER, target.fbo);
+        glBindFramebuffer(GL_DRAW_FRAMEBUFFER, 0);
+        glBlitFramebuffer(0, 0, target.width, target.height, 0, 0, screenWidth, screenHeight, GL_COLOR_BUFFER_BIT, GL_NEAREST);
+        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+        // polls different kinds of events, for example, when we close an application, it fetches that event
+        // or it fetches events like movement of the window.
+        // Without it you can neither move the window or close the window
+        glfwPollEvents();
+        // have you drawn the image, it is stored in the buffer. You can now swap this buffer with main buffer
+        // so the image appears
+        glfwSwapBuffers(win);
+
+        // the window title is the overlay
+        if (glfwGetTime() - lastReport > 1.) {
+            lastReport = glfwGetTime();
+            glfwSetWindowTitle(win, gpuMemory.summary().c_str());
+        }
+    }
+    gpuMemory.report(std::cout);
+    reportDriverMemory(std::cout, driverAtStart);
+    const bool withinBudget = !gpuMemory.budgetOverruns;
+    if (!withinBudget)
+        std::cout << "went over a budget " << gpuMemory.budgetOverruns << " times\n";
+
+    for (GLuint &id : streamed)
+        gpuDeleteTexture(id);
+    target.release();
+    tex.release();
+    gpuDeleteBuffer(vbo);
+    gpuDeleteBuffer(sphereVbo);
+    gpuDeleteBuffer(sphereEbo);
+    gpuDeleteBuffer(cameraUbo);
+    glDeleteVertexArrays(1, &vao);
+    glDeleteVertexArrays(1, &sphereVao);
+    gpuMemory.reportLeaks();
+    glfwTerminate();
+    
+    std::cout << "Window should close now!\n";
+
+    return strict && !withinBudget ? EXIT_FAILURE : EXIT_SUCCESS;
+
+}
@@ -0,0 +1,19 @@
+#version 330 core
+
+layout(location = 0) in vec3 aPos;
+layout(location = 1) in vec2 aTexCoord;
+
+out vec2 texCoord;
+
+// one buffer for every draw, written once a frame
+layout(std140) uniform Camera {
+    mat4 proj;
+    mat4 view;
+};
+uniform mat4 model;
+
+
+void main() {
+    gl_Position = proj * view * model * vec4(aPos, 1.0);
+    texCoord = aTexCoord;
+}
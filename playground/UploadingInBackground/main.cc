@@ -0,0 +1,812 @@
+#include <GL/glew.h>
+
+#include <GLFW/glfw3.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <fstream>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <glm/ext/matrix_clip_space.hpp>
+#include <glm/ext/matrix_transform.hpp>
+#include <glm/geometric.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/ext/matrix_float4x4.hpp>
+#include <glm/gtc/type_ptr.hpp>
+#include <glm/glm.hpp>
+#include <glm/trigonometric.hpp>
+#define STB_IMAGE_IMPLEMENTATION
+#include <stb/stb_image.h>
+#include <iostream>
+
+class Shader {
+    std::string src; 
+protected:
+    const char *getsrc() {
+        return src.data();
+    }
+    GLuint shader_id = 0;
+    bool isCompiled = false;
+protected:
+    virtual const char *getClassName() = 0;
+    GLint getCompilationStatus(GLuint shader_id) {
+        int status;
+        glGetShaderiv(shader_id, GL_COMPILE_STATUS, &status);
+        return status;
+    }
+    void sendError() {
+        char buffer[1024];
+        glGetShaderInfoLog(shader_id, 1024, NULL, buffer);
+        std::cerr << "ERROR::" << getClassName() << " - " << buffer;
+    }
+public:
+    virtual void compile() = 0;
+    void setSource(const char *s) {
+        std::ifstream sourceFile(s);
+        if (!sourceFile.is_open())
+            return;
+        char buffer[8192];
+        while (sourceFile.read(buffer, 8192)) {
+            src.append(buffer, 8192);
+        }
+        if (!sourceFile.eof()) {
+            src.clear();
+            return;
+        }
+        src.append(buffer, sourceFile.gcount());
+    }
+    friend class Program;
+};
+
+
+class VertexShader : public Shader {
+    virtual const char *getClassName() override {
+        return "VertexShader";
+    }
+public:
+    virtual void compile() override {
+        if (shader_id)
+            glDeleteShader(shader_id);
+        shader_id = glCreateShader(GL_VERTEX_SHADER);
+        const char *src = getsrc();
+        glShaderSource(shader_id, 1, &src, NULL);
+        glCompileShader(shader_id);
+        if (!getCompilationStatus(shader_id)) {
+            sendError();
+        }
+        isCompiled = true;
+    }
+};
+
+class FragmentShader : public Shader {
+    const char *getClassName() override {
+        return "FragmentShader";
+    }
+public:
+    virtual void compile() override {
+        if (shader_id)
+            glDeleteShader(shader_id);
+        shader_id = glCreateShader(GL_FRAGMENT_SHADER);
+        const char *src = getsrc();
+        glShaderSource(shader_id, 1, &src, NULL);
+        glCompileShader(shader_id);
+        if (!getCompilationStatus(shader_id)) {
+            sendError();
+        }
+        isCompiled = true;
+    }
+};
+
+
+class Program {
+    GLuint program_id = 0;
+    void sendError() {
+        char buffer[1024];
+        glGetProgramInfoLog(program_id, 1024, NULL, buffer);
+        std::cerr << "ERROR::PROGRAM: " << " - " << buffer;
+    }
+    bool linkStatus() {
+        int status = 0;
+        glGetProgramiv(program_id, GL_LINK_STATUS, &status);
+        return status;
+    }
+public:
+    Program() {
+        program_id = glCreateProgram();
+    }
+    ~Program() {
+        glDeleteProgram(program_id);
+    }
+    void AttachShaders(std::initializer_list<Shader*> shaders) {
+        auto i = shaders.begin();
+        while (i != shaders.end()) {
+            if (!(*i)->isCompiled)
+                (*i)->compile();
+            glAttachShader(program_id, (*i)->shader_id);
+            ++i;
+        }
+        glLinkProgram(program_id);
+        if (!linkStatus()) {
+            sendError();
+        }
+    }
+    void UseProgram() {
+        glUseProgram(program_id);
+    }
+    void setMat4(const char *locName, const glm::mat4 &mat) {
+        int location = glGetUniformLocation(program_id, locName);
+        if (location == -1)
+            return;
+        glUniformMatrix4fv(location, 1, GL_FALSE, glm::value_ptr(mat));
+    }
+    void setInt(const char *locName, int value) {
+        int location = glGetUniformLocation(program_id, locName);
+        if (location == -1)
+            return;
+        glUniform1i(location, value);
+    }
+    void setFloat(const char *locName, float value) {
+        int location = glGetUniformLocation(program_id, locName);
+        if (location == -1)
+            return;
+        glUniform1f(location, value);
+    }
+    void setVec3(const char *locName, const glm::vec3 &vec) {
+        int location = glGetUniformLocation(program_id, locName);
+        if (location == -1)
+            return;
+        glUniform3f(location, vec.x, vec.y, vec.z);
+    }
+    void setVec4(const char *locName, const glm::vec4 &vec) {
+        int location = glGetUniformLocation(program_id, locName);
+        if (location == -1)
+            return;
+        glUniform4f(location, vec.x, vec.y, vec.z, vec.w);
+    }
+};
+
+
+class Texture2D {
+    GLuint tex_id;
+public:
+    void generate2DTex(const char *image_path) {
+        int width, height, nChannels;
+        stbi_set_flip_vertically_on_load(true);
+        uint8_t *raw_image = stbi_load(image_path, &width, &height, &nChannels, 0);
+        float borderColor[] = {1.f, 1.f, 1.f, 1.f};
+        glGenTextures(1, &tex_id);
+        glBindTexture(GL_TEXTURE_2D, tex_id);
+        // what to do when primitive is bigger than the texture
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_BORDER);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_BORDER);
+        glTexParameterfv(GL_TEXTURE_2D, GL_TEXTURE_BORDER_COLOR, borderColor);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        // glTexImage2D(TARGET_TYPE, IM_MIPMAP_LEVEL, TARGET_NRCHANNELS, SRC_WIDTH, SRC_HEIGHT, LEGACY_0, SRC_NRCHANNELS, SRC_DATA_TYPE, SRC_DATA);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, width, height, 0, GL_RGB, GL_UNSIGNED_BYTE, raw_image);
+        stbi_image_free(raw_image);
+    }
+    void bind() {
+        glBindTexture(GL_TEXTURE_2D, tex_id);
+    }
+};
+
+
+
+// ---------------------------------------------------------------------------------------------------------
+// uploads on a second thread. it has its own context from a hidden window sharing objects with the main one,
+// so the textures and buffers it makes can be drawn with by the render thread. the render thread only picks
+// up finished objects, and only once the fence placed after their upload has signaled. vertex arrays are
+// not shared between contexts, those are made by the render thread when a buffer arrives
+// ---------------------------------------------------------------------------------------------------------
+
+struct UploadJob {
+    enum Kind { TEXTURE_FILE, TEXTURE_PIXELS, BUFFER };
+    Kind kind = BUFFER;
+    uint64_t id = 0;
+    std::string path;            // TEXTURE_FILE
+    int width = 0, height = 0;   // TEXTURE_PIXELS, rgba8
+    std::vector<uint8_t> bytes;  // TEXTURE_PIXELS and BUFFER
+    // runs on the upload thread before anything else, to make the data without holding up the render thread
+    std::function<void(UploadJob&)> prepare;
+};
+
+struct UploadResult {
+    uint64_t id = 0;
+    UploadJob::Kind kind = UploadJob::BUFFER;
+    GLuint object = 0;
+    GLsync fence = nullptr;
+    int width = 0, height = 0;
+    size_t bytes = 0;
+    double ms = 0.;  // preparing, decoding and uploading
+    bool ok = false;
+};
+
+// the GL side of a job, on whichever thread has a context current
+void performUpload(UploadJob &job, UploadResult &result) {
+    auto start = std::chrono::steady_clock::now();
+    if (job.prepare)
+        job.prepare(job);
+    result.id = job.id;
+    result.kind = job.kind;
+    if (job.kind == UploadJob::BUFFER) {
+        // through the copy target whatever the buffer is for: this context has no vertex array bound, and
+        // binding GL_ELEMENT_ARRAY_BUFFER without one is an error in a core profile
+        glGenBuffers(1, &result.object);
+        glBindBuffer(GL_COPY_WRITE_BUFFER, result.object);
+        glBufferData(GL_COPY_WRITE_BUFFER, job.bytes.size(), job.bytes.data(), GL_STATIC_DRAW);
+        glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+        result.bytes = job.bytes.size();
+        result.ok = true;
+    } else {
+        const uint8_t *pixels = job.bytes.data();
+        uint8_t *decoded = nullptr;
+        if (job.kind == UploadJob::TEXTURE_FILE) {
+            int channels;
+            decoded = stbi_load(job.path.c_str(), &job.width, &job.height, &channels, 4);
+            if (!decoded)
+                std::cerr << "ERROR::UPLOAD - can't load " << job.path << "\n";
+            pixels = decoded;
+        }
+        if (pixels) {
+            glGenTextures(1, &result.object);
+            glBindTexture(GL_TEXTURE_2D, result.object);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+            glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, job.width, job.height, 0, GL_RGBA, GL_UNSIGNED_BYTE, pixels);
+            glGenerateMipmap(GL_TEXTURE_2D);
+            glBindTexture(GL_TEXTURE_2D, 0);
+            result.width = job.width;
+            result.height = job.height;
+            result.bytes = size_t(job.width) * job.height * 4;
+            result.ok = true;
+        }
+        stbi_image_free(decoded);
+    }
+    // the render thread waits for this before touching the object. the flush makes sure the fence actually
+    // gets to the GPU, otherwise another context could wait on it forever
+    result.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    glFlush();
+    job.bytes = std::vector<uint8_t>();
+    result.ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+
+class BackgroundUploader {
+    GLFWwindow *context = nullptr;
+    std::thread thread;
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::deque<UploadJob> jobs;
+    std::vector<UploadResult> uploaded;
+    std::vector<UploadResult> waiting;  // render thread only: uploaded, fence not signaled yet
+    bool quit = false;
+
+    void work() {
+        glfwMakeContextCurrent(context);
+        std::unique_lock<std::mutex> lock(mutex);
+        while (true) {
+            wake.wait(lock, [&] { return quit || !jobs.empty(); });
+            if (quit)
+                break;
+            UploadJob job = std::move(jobs.front());
+            jobs.pop_front();
+            lock.unlock();
+            UploadResult result;
+            performUpload(job, result);
+            lock.lock();
+            uploaded.push_back(result);
+        }
+        lock.unlock();
+        glfwMakeContextCurrent(NULL);
+    }
+public:
+    size_t submitted = 0, finished = 0;
+    double uploadMs = 0.;  // spent on the upload thread
+
+    BackgroundUploader() = default;
+    BackgroundUploader(const BackgroundUploader&) = delete;
+    BackgroundUploader &operator=(const BackgroundUploader&) = delete;
+    // glfw windows can only be made on the main thread, so this has to be called from there
+    bool start(GLFWwindow *shareWith) {
+        glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+        context = glfwCreateWindow(1, 1, "uploads", NULL, shareWith);
+        glfwWindowHint(GLFW_VISIBLE, GLFW_TRUE);
+        if (!context) {
+            std::cerr << "ERROR::UPLOAD - can't create a shared context\n";
+            return false;
+        }
+        thread = std::thread(&BackgroundUploader::work, this);
+        return true;
+    }
+    ~BackgroundUploader() {
+        stop();
+    }
+    // main thread, with the main context current and before glfwTerminate(). objects that were not
+    // handed out yet are deleted
+    void stop() {
+        if (!context)
+            return;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            quit = true;
+        }
+        wake.notify_all();
+        thread.join();
+        for (std::vector<UploadResult> *results : {&uploaded, &waiting}) {
+            for (UploadResult &r : *results) {
+                glDeleteSync(r.fence);
+                if (r.kind == UploadJob::BUFFER)
+                    glDeleteBuffers(1, &r.object);
+                else
+                    glDeleteTextures(1, &r.object);
+            }
+        }
+        uploaded.clear();
+        waiting.clear();
+        glfwDestroyWindow(context);
+        context = nullptr;
+    }
+    void submit(UploadJob job) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            jobs.push_back(std::move(job));
+        }
+        ++submitted;
+        wake.notify_one();
+    }
+    size_t queued() {
+        std::lock_guard<std::mutex> lock(mutex);
+        return jobs.size();
+    }
+    // render thread, once a frame: whatever is uploaded and done on the GPU. never waits
+    void collect(std::vector<UploadResult> &ready) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            waiting.insert(waiting.end(), uploaded.begin(), uploaded.end());
+            uploaded.clear();
+        }
+        for (size_t i = 0; i < waiting.size();) {
+            GLenum status = glClientWaitSync(waiting[i].fence, 0, 0);
+            if (status == GL_TIMEOUT_EXPIRED) {
+                ++i;
+                continue;
+            }
+            if (status == GL_WAIT_FAILED)
+                std::cerr << "ERROR::UPLOAD - waiting for upload " << waiting[i].id << " failed\n";
+            glDeleteSync(waiting[i].fence);
+            waiting[i].fence = nullptr;
+            uploadMs += waiting[i].ms;
+            ++finished;
+            ready.push_back(waiting[i]);
+            waiting[i] = waiting.back();
+            waiting.pop_back();
+        }
+    }
+};
+
+
+// ---------------------------------------------------------------------------------------------------------
+// something heavy to load: a big procedural texture with mipmaps and a finely tessellated sphere
+// ---------------------------------------------------------------------------------------------------------
+
+void makeTexture(UploadJob &job, int size, uint32_t seed) {
+    job.kind = UploadJob::TEXTURE_PIXELS;
+    job.width = job.height = size;
+    job.bytes.resize(size_t(size) * size * 4);
+    const float fx = 0.01f + (seed % 7) * 0.004f, fy = 0.013f + (seed % 5) * 0.003f;
+    for (int y = 0; y < size; ++y) {
+        for (int x = 0; x < size; ++x) {
+            uint8_t *p = &job.bytes[(size_t(y) * size + x) * 4];
+            float v = 0.5f + 0.25f * std::sin(x * fx + seed) + 0.25f * std::cos(y * fy + std::sin(x * 0.002f) * 3.f);
+            p[0] = uint8_t(255.f * v);
+            p[1] = uint8_t(255.f * (1.f - v) * ((seed & 1) ? 1.f : 0.6f));
+            p[2] = uint8_t(128.f + 127.f * std::sin(v * 6.f + seed));
+            p[3] = 255;
+        }
+    }
+}
+
+// position, normal and texture coordinates per vertex, the same layout as the cube
+void makeSphereVertices(UploadJob &job, int rings, int segments) {
+    job.kind = UploadJob::BUFFER;
+    job.bytes.resize(size_t(rings + 1) * (segments + 1) * 8 * sizeof(float));
+    float *v = reinterpret_cast<float*>(job.bytes.data());
+    for (int r = 0; r <= rings; ++r) {
+        float theta = glm::pi<float>() * r / rings;
+        for (int s = 0; s <= segments; ++s) {
+            float phi = 2.f * glm::pi<float>() * s / segments;
+            float nx = std::sin(theta) * std::cos(phi), ny = std::cos(theta), nz = std::sin(theta) * std::sin(phi);
+            float vertex[8] = {nx * 0.5f, ny * 0.5f, nz * 0.5f, nx, ny, nz, float(s) / segments, 1.f - float(r) / rings};
+            std::memcpy(v, vertex, sizeof(vertex));
+            v += 8;
+        }
+    }
+}
+
+void makeSphereIndices(UploadJob &job, int rings, int segments) {
+    job.kind = UploadJob::BUFFER;
+    job.bytes.resize(size_t(rings) * segments * 6 * sizeof(uint32_t));
+    uint32_t *i = reinterpret_cast<uint32_t*>(job.bytes.data());
+    for (int r = 0; r < rings; ++r) {
+        for (int s = 0; s < segments; ++s) {
+            uint32_t a = r * (segments + 1) + s, b = a + segments + 1;
+            uint32_t quad[6] = {a, a + 1, b, a + 1, b + 1, b};
+            std::memcpy(i, quad, sizeof(quad));
+            i += 6;
+        }
+    }
+}
+
+
+// a loaded asset: a sphere with its own texture. it is drawn once all three pieces are in
+struct StreamedAsset {
+    uint64_t texJob = 0, vertexJob = 0, indexJob = 0;
+    GLuint tex_id = 0, vbo = 0, ebo = 0, vao = 0;
+    GLsizei indexCount = 0;
+    glm::vec3 pos;
+    bool ready() const {
+        return tex_id && vbo && ebo;
+    }
+    void release() {
+        glDeleteTextures(1, &tex_id);
+        glDeleteBuffers(1, &vbo);
+        glDeleteBuffers(1, &ebo);
+        glDeleteVertexArrays(1, &vao);
+        tex_id = vbo = ebo = vao = 0;
+    }
+};
+
+
+void processInput(GLFWwindow *window, glm::vec3 &cameraPos, glm::vec3 &cameraFront, glm::vec3 &cameraUp)
+{
+
+    const float cameraSpeed = 0.05f; // adjust accordingly
+    if (glfwGetKey(window, GLFW_KEY_W) == GLFW_PRESS)
+        cameraPos += cameraSpeed * cameraFront;
+    if (glfwGetKey(window, GLFW_KEY_S) == GLFW_PRESS)
+        cameraPos -= cameraSpeed * cameraFront;
+    if (glfwGetKey(window, GLFW_KEY_A) == GLFW_PRESS)
+        cameraPos -= glm::normalize(glm::cross(cameraFront, cameraUp)) * cameraSpeed;
+    if (glfwGetKey(window, GLFW_KEY_D) == GLFW_PRESS)
+        cameraPos += glm::normalize(glm::cross(cameraFront, cameraUp)) * cameraSpeed;
+    if (glfwGetKey(window, GLFW_KEY_UP) == GLFW_PRESS)
+        cameraPos += glm::normalize(glm::cross(cameraFront, cameraUp)) * cameraSpeed;
+
+}
+
+// true only on the frame the key went down
+bool keyPressed(GLFWwindow *window, int key) {
+    static bool down[GLFW_KEY_LAST + 1] = {};
+    bool now = glfwGetKey(window, key) == GLFW_PRESS;
+    bool pressed = now && !down[key];
+    down[key] = now;
+    return pressed;
+}
+
+
+float yaw = -90.f;
+float pitch = 0.f;
+glm::vec3 cameraFront;
+
+void mouseMovement(GLFWwindow *window, double xPos, double yPos) {
+    static float lastX = xPos, lastY = yPos;
+    float xOffset = xPos - lastX;
+    float yOffset = lastY - yPos;
+    
+    constexpr float sensitivity = 0.05f;
+    xOffset *= sensitivity;
+    yOffset *= sensitivity;
+
+    yaw += xOffset;
+    pitch += yOffset;
+
+    if (std::abs(pitch) > 89.f) // don't ever do it this way. I am lazy
+        pitch = std::abs(pitch) / pitch * 89.f;
+
+    cameraFront.x = cos(glm::radians(yaw)) * cos(glm::radians(pitch));
+    cameraFront.y = sin(glm::radians(pitch));
+    cameraFront.z = sin(glm::radians(yaw)) * cos(glm::radians(pitch));
+
+    cameraFront = glm::normalize(cameraFront);
+    lastX = xPos, lastY = yPos;
+}
+
+
+// ./main               assets load on the upload thread
+// ./main --sync        the same uploads on the render thread, to compare frame times
+// ./main --log file    also writes every frame's time to file, one line per frame
+int main(int argc, char **argv) {
+    bool sync = false;
+    const char *logPath = nullptr;
+    for (int i = 1; i < argc; ++i) {
+        if (!std::strcmp(argv[i], "--sync"))
+            sync = true;
+        else if (!std::strcmp(argv[i], "--log") && i + 1 < argc)
+            logPath = argv[++i];
+    }
+
+    if (glfwInit() != GLFW_TRUE) {
+        glfwTerminate();
+        std::cerr << "Failed to initialize GLFW";
+        return EXIT_FAILURE;
+    }
+    // setting OpenGL version to 3.3
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+    GLFWwindow *win = glfwCreateWindow(800, 600, "This is a hello window!", NULL, NULL);
+    // setting 'context' for OpenGL, i.e. where to draw on current thread
+    glfwMakeContextCurrent(win);
+    // all it does is fetches us the implemented functions of OpenGL
+    if (glewInit() != GLEW_OK) {
+        glfwTerminate();
+        std::cerr << "Failed to initialize GLEW\n";
+        return EXIT_FAILURE;
+    }
+    int screenWidth, screenHeight;
+    glfwGetFramebufferSize(win, &screenWidth, &screenHeight);
+    glViewport(0, 0, screenWidth, screenHeight);
+
+    glEnable(GL_DEPTH_TEST);
+    float triangle_data[] = {
+        //   vertpos   //  //   normal   //  //texcord//
+    -0.5f, -0.5f, -0.5f,  0.0f,  0.0f, -1.0f,  0.0f, 0.0f,
+     0.5f, -0.5f, -0.5f,  0.0f,  0.0f, -1.0f,  1.0f, 0.0f,
+     0.5f,  0.5f, -0.5f,  0.0f,  0.0f, -1.0f,  1.0f, 1.0f,
+     0.5f,  0.5f, -0.5f,  0.0f,  0.0f, -1.0f,  1.0f, 1.0f,
+    -0.5f,  0.5f, -0.5f,  0.0f,  0.0f, -1.0f,  0.0f, 1.0f,
+    -0.5f, -0.5f, -0.5f,  0.0f,  0.0f, -1.0f,  0.0f, 0.0f,
+
+    -0.5f, -0.5f,  0.5f,  0.0f,  0.0f,  1.0f,  0.0f, 0.0f,
+     0.5f, -0.5f,  0.5f,  0.0f,  0.0f,  1.0f,  1.0f, 0.0f,
+     0.5f,  0.5f,  0.5f,  0.0f,  0.0f,  1.0f,  1.0f, 1.0f,
+     0.5f,  0.5f,  0.5f,  0.0f,  0.0f,  1.0f,  1.0f, 1.0f,
+    -0.5f,  0.5f,  0.5f,  0.0f,  0.0f,  1.0f,  0.0f, 1.0f,
+    -0.5f, -0.5f,  0.5f,  0.0f,  0.0f,  1.0f,  0.0f, 0.0f,
+
+    -0.5f,  0.5f,  0.5f, -1.0f,  0.0f,  0.0f,  1.0f, 0.0f,
+    -0.5f,  0.5f, -0.5f, -1.0f,  0.0f,  0.0f,  1.0f, 1.0f,
+    -0.5f, -0.5f, -0.5f, -1.0f,  0.0f,  0.0f,  0.0f, 1.0f,
+    -0.5f, -0.5f, -0.5f, -1.0f,  0.0f,  0.0f,  0.0f, 1.0f,
+    -0.5f, -0.5f,  0.5f, -1.0f,  0.0f,  0.0f,  0.0f, 0.0f,
+    -0.5f,  0.5f,  0.5f, -1.0f,  0.0f,  0.0f,  1.0f, 0.0f,
+
+     0.5f,  0.5f,  0.5f,  1.0f,  0.0f,  0.0f,  1.0f, 0.0f,
+     0.5f,  0.5f, -0.5f,  1.0f,  0.0f,  0.0f,  1.0f, 1.0f,
+     0.5f, -0.5f, -0.5f,  1.0f,  0.0f,  0.0f,  0.0f, 1.0f,
+     0.5f, -0.5f, -0.5f,  1.0f,  0.0f,  0.0f,  0.0f, 1.0f,
+     0.5f, -0.5f,  0.5f,  1.0f,  0.0f,  0.0f,  0.0f, 0.0f,
+     0.5f,  0.5f,  0.5f,  1.0f,  0.0f,  0.0f,  1.0f, 0.0f,
+
+    -0.5f, -0.5f, -0.5f,  0.0f, -1.0f,  0.0f,  0.0f, 1.0f,
+     0.5f, -0.5f, -0.5f,  0.0f, -1.0f,  0.0f,  1.0f, 1.0f,
+     0.5f, -0.5f,  0.5f,  0.0f, -1.0f,  0.0f,  1.0f, 0.0f,
+     0.5f, -0.5f,  0.5f,  0.0f, -1.0f,  0.0f,  1.0f, 0.0f,
+    -0.5f, -0.5f,  0.5f,  0.0f, -1.0f,  0.0f,  0.0f, 0.0f,
+    -0.5f, -0.5f, -0.5f,  0.0f, -1.0f,  0.0f,  0.0f, 1.0f,
+
+    -0.5f,  0.5f, -0.5f,  0.0f,  1.0f,  0.0f,  0.0f, 1.0f,
+     0.5f,  0.5f, -0.5f,  0.0f,  1.0f,  0.0f,  1.0f, 1.0f,
+     0.5f,  0.5f,  0.5f,  0.0f,  1.0f,  0.0f,  1.0f, 0.0f,
+     0.5f,  0.5f,  0.5f,  0.0f,  1.0f,  0.0f,  1.0f, 0.0f,
+    -0.5f,  0.5f,  0.5f,  0.0f,  1.0f,  0.0f,  0.0f, 0.0f,
+    -0.5f,  0.5f, -0.5f,  0.0f,  1.0f,  0.0f,  0.0f, 1.0f
+        
+    };
+
+
+    glm::vec3 cameraPos(0.f, 0.f, 3.f);
+    cameraFront = glm::vec3(0.f,0.f,-1.f);
+    glm::vec3 cameraUp(0.,1.,0.f);
+    
+
+    Texture2D tex;
+    tex.generate2DTex("./image2d.tex");
+    tex.bind();
+
+    GLuint vbo = 0;
+    glGenBuffers(1, &vbo); 
+    glBindBuffer(GL_ARRAY_BUFFER, vbo);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(triangle_data), triangle_data, GL_STATIC_DRAW);
+
+    GLuint vao = 0;
+    glGenVertexArrays(1, &vao);
+    glBindVertexArray(vao);
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)0);
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)(6 * sizeof(float)));
+    glEnableVertexAttribArray(1);
+    glVertexAttribPointer(2, 3, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)(3 * sizeof(float)));
+    glEnableVertexAttribArray(2);
+
+    VertexShader vs;
+    FragmentShader fs;
+    vs.setSource("./vertex.glsl");
+    fs.setSource("./frag.glsl");
+    Program prog;
+    prog.AttachShaders({&vs, &fs});
+
+    prog.UseProgram();
+    prog.setInt("tex", 0);
+
+    glm::mat4 view; // = glm::translate(glm::mat4(1.f), glm::vec3(0.f,0.f,-3.f));
+       
+
+    glm::mat4 proj = glm::perspective(glm::radians(45.f), float(screenWidth) / screenHeight, 0.1f, 100.f);
+
+    prog.setMat4("proj", proj);
+    prog.setMat4("view", view);
+
+    // stbi's flip setting is global, set it once before the upload thread can decode anything
+    stbi_set_flip_vertically_on_load(true);
+    BackgroundUploader uploader;
+    if (!sync && !uploader.start(win)) {
+        std::cerr << "uploading on the render thread instead\n";
+        sync = true;
+    }
+    // start() made a window, make sure ours is still the current one
+    glfwMakeContextCurrent(win);
+
+    // a new asset every couple of seconds, the oldest one goes when there are too many
+    constexpr size_t MAX_ASSETS = 6;
+    static constexpr int TEXTURE_SIZE = 2048, RINGS = 256, SEGMENTS = 512;
+    std::deque<StreamedAsset> assets;
+    uint64_t nextJob = 1;
+    int assetCount = 0;
+    double nextLoad = glfwGetTime();
+    std::vector<UploadResult> ready;
+    auto loadAsset = [&]() {
+        StreamedAsset asset;
+        asset.texJob = nextJob++;
+        asset.vertexJob = nextJob++;
+        asset.indexJob = nextJob++;
+        asset.indexCount = RINGS * SEGMENTS * 6;
+        asset.pos = glm::vec3(2.f * std::cos(assetCount * 1.05f), 0.5f * std::sin(assetCount * 0.7f), 2.f * std::sin(assetCount * 1.05f) - 3.f);
+        const uint32_t seed = assetCount++;
+        UploadJob jobs[3];
+        jobs[0].id = asset.texJob;
+        jobs[0].prepare = [seed](UploadJob &job) { makeTexture(job, TEXTURE_SIZE, seed); };
+        jobs[1].id = asset.vertexJob;
+        jobs[1].prepare = [](UploadJob &job) { makeSphereVertices(job, RINGS, SEGMENTS); };
+        jobs[2].id = asset.indexJob;
+        jobs[2].prepare = [](UploadJob &job) { makeSphereIndices(job, RINGS, SEGMENTS); };
+        for (UploadJob &job : jobs) {
+            if (!sync) {
+                uploader.submit(std::move(job));
+                continue;
+            }
+            // the old way, right here between two frames
+            UploadResult result;
+            performUpload(job, result);
+            glDeleteSync(result.fence);
+            ready.push_back(result);
+        }
+        assets.push_back(asset);
+        if (assets.size() > MAX_ASSETS) {
+            // whatever of it is still on its way gets deleted when it arrives, see below
+            assets.front().release();
+            assets.pop_front();
+        }
+    };
+
+    glfwSetCursorPosCallback(win, mouseMovement); 
+    glfwSetInputMode(win, GLFW_CURSOR, GLFW_CURSOR_DISABLED);  
+
+    std::ofstream frameLog;
+    if (logPath) {
+        frameLog.open(logPath, std::ios::trunc);
+        frameLog << "frame,ms,uploads_queued\n";
+    }
+    double lastReport = glfwGetTime(), frameMs = 0., worstFrameMs = 0.;
+    int frames = 0, hitches = 0, frameNumber = 0;
+    auto frameStart = std::chrono::steady_clock::now();
+    
+    while (!glfwWindowShouldClose(win)) {
+        processInput(win, cameraPos, cameraFront, cameraUp);
+        view = glm::lookAt(cameraPos, cameraFront + cameraPos, cameraUp);
+
+        // L loads one more right away
+        if (keyPressed(win, GLFW_KEY_L) || glfwGetTime() >= nextLoad) {
+            loadAsset();
+            nextLoad = glfwGetTime() + 2.;
+        }
+        if (!sync)
+            uploader.collect(ready);
+        for (const UploadResult &r : ready) {
+            auto owner = std::find_if(assets.begin(), assets.end(), [&](const StreamedAsset &a) {
+                return a.texJob == r.id || a.vertexJob == r.id || a.indexJob == r.id;
+            });
+            if (owner == assets.end() || !r.ok) {
+                // dropped while it was loading
+                if (r.kind == UploadJob::BUFFER)
+                    glDeleteBuffers(1, &r.object);
+                else
+                    glDeleteTextures(1, &r.object);
+                continue;
+            }
+            if (owner->texJob == r.id)
+                owner->tex_id = r.object;
+            else if (owner->vertexJob == r.id)
+                owner->vbo = r.object;
+            else
+                owner->ebo = r.object;
+            if (owner->vbo && owner->ebo && !owner->vao) {
+                // vertex arrays belong to one context, so this one is made here
+                glGenVertexArrays(1, &owner->vao);
+                glBindVertexArray(owner->vao);
+                glBindBuffer(GL_ARRAY_BUFFER, owner->vbo);
+                glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, owner->ebo);
+                glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)0);
+                glEnableVertexAttribArray(0);
+                glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)(6 * sizeof(float)));
+                glEnableVertexAttribArray(1);
+                glVertexAttribPointer(2, 3, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)(3 * sizeof(float)));
+                glEnableVertexAttribArray(2);
+            }
+        }
+        ready.clear();
+
+        prog.UseProgram();
+        prog.setMat4("view", view);
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+        glBindVertexArray(vao);
+        tex.bind();
+        prog.setMat4("model", glm::rotate(glm::translate(glm::mat4(1.f), glm::vec3(0.f, 0.f, -3.f)), float(glfwGetTime()), glm::vec3(0.5f, 1.f, 0.f)));
+        glDrawArrays(GL_TRIANGLES, 0, 36);
+        for (const StreamedAsset &asset : assets) {
+            if (!asset.ready())
+                continue;
+            glBindVertexArray(asset.vao);
+            glBindTexture(GL_TEXTURE_2D, asset.tex_id);
+            prog.setMat4("model", glm::translate(glm::mat4(1.f), asset.pos));
+            glDrawElements(GL_TRIANGLES, asset.indexCount, GL_UNSIGNED_INT, 0);
+        }
+
+        // polls different kinds of events, for example, when we close an application, it fetches that event
+        // or it fetches events like movement of the window.
+        // Without it you can neither move the window or close the window
+        glfwPollEvents();
+        // have you drawn the image, it is stored in the buffer. You can now swap this buffer with main buffer
+        // so the image appears
+        glfwSwapBuffers(win);
+
+        auto now = std::chrono::steady_clock::now();
+        double ms = std::chrono::duration<double, std::milli>(now - frameStart).count();
+        frameStart = now;
+        frameMs += ms;
+        worstFrameMs = std::max(worstFrameMs, ms);
+        hitches += ms > 25.;
+        ++frames;
+        if (frameLog.is_open())
+            frameLog << frameNumber << "," << ms << "," << (sync ? 0 : uploader.queued()) << "\n";
+        ++frameNumber;
+        if (glfwGetTime() - lastReport > 1.) {
+            lastReport = glfwGetTime();
+            std::cout << (sync ? "render thread uploads: " : "upload thread: ") << frameMs / frames << "ms average frame, "
+                      << worstFrameMs << "ms worst, " << hitches << " frames over 25ms";
+            if (!sync)
+                std::cout << ", " << uploader.finished << "/" << uploader.submitted << " uploads done, "
+                          << (uploader.finished ? uploader.uploadMs / uploader.finished : 0.) << "ms each on the upload thread";
+            std::cout << "\n";
+            frames = hitches = 0;
+            frameMs = worstFrameMs = 0.;
+        }
+    }
+    uploader.stop();
+    for (StreamedAsset &asset : assets)
+        asset.release();
+    glfwTerminate();
+    
+    std::cout << "Window should close now!\n";
+
+    return EXIT_SUCCESS;
+
+}
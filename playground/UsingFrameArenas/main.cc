@@ -0,0 +1,738 @@
+#include <GL/glew.h>
+
+#include <GLFW/glfw3.h>
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <new>
+#include <thread>
+#include <vector>
+#include <glm/ext/matrix_clip_space.hpp>
+#include <glm/ext/matrix_transform.hpp>
+#include <glm/geometric.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/ext/matrix_float4x4.hpp>
+#include <glm/gtc/type_ptr.hpp>
+#include <glm/glm.hpp>
+#include <glm/trigonometric.hpp>
+#define STB_IMAGE_IMPLEMENTATION
+#include <stb/stb_image.h>
+#include <iostream>
+
+class Shader {
+    std::string src; 
+protected:
+    const char *getsrc() {
+        return src.data();
+    }
+    GLuint shader_id = 0;
+    bool isCompiled = false;
+protected:
+    virtual const char *getClassName() = 0;
+    GLint getCompilationStatus(GLuint shader_id) {
+        int status;
+        glGetShaderiv(shader_id, GL_COMPILE_STATUS, &status);
+        return status;
+    }
+    void sendError() {
+        char buffer[1024];
+        glGetShaderInfoLog(shader_id, 1024, NULL, buffer);
+        std::cerr << "ERROR::" << getClassName() << " - " << buffer;
+    }
+public:
+    virtual void compile() = 0;
+    void setSource(const char *s) {
+        std::ifstream sourceFile(s);
+        if (!sourceFile.is_open())
+            return;
+        char buffer[8192];
+        while (sourceFile.read(buffer, 8192)) {
+            src.append(buffer, 8192);
+        }
+        if (!sourceFile.eof()) {
+            src.clear();
+            return;
+        }
+        src.append(buffer, sourceFile.gcount());
+    }
+    friend class Program;
+};
+
+
+class VertexShader : public Shader {
+    virtual const char *getClassName() override {
+        return "VertexShader";
+    }
+public:
+    virtual void compile() override {
+        if (shader_id)
+            glDeleteShader(shader_id);
+        shader_id = glCreateShader(GL_VERTEX_SHADER);
+        const char *src = getsrc();
+        glShaderSource(shader_id, 1, &src, NULL);
+        glCompileShader(shader_id);
+        if (!getCompilationStatus(shader_id)) {
+            sendError();
+        }
+        isCompiled = true;
+    }
+};
+
+class FragmentShader : public Shader {
+    const char *getClassName() override {
+        return "FragmentShader";
+    }
+public:
+    virtual void compile() override {
+        if (shader_id)
+            glDeleteShader(shader_id);
+        shader_id = glCreateShader(GL_FRAGMENT_SHADER);
+        const char *src = getsrc();
+        glShaderSource(shader_id, 1, &src, NULL);
+        glCompileShader(shader_id);
+        if (!getCompilationStatus(shader_id)) {
+            sendError();
+        }
+        isCompiled = true;
+    }
+};
+
+
+class Program {
+    GLuint program_id = 0;
+    void sendError() {
+        char buffer[1024];
+        glGetProgramInfoLog(program_id, 1024, NULL, buffer);
+        std::cerr << "ERROR::PROGRAM: " << " - " << buffer;
+    }
+    bool linkStatus() {
+        int status = 0;
+        glGetProgramiv(program_id, GL_LINK_STATUS, &status);
+        return status;
+    }
+public:
+    Program() {
+        program_id = glCreateProgram();
+    }
+    ~Program() {
+        glDeleteProgram(program_id);
+    }
+    void AttachShaders(std::initializer_list<Shader*> shaders) {
+        auto i = shaders.begin();
+        while (i != shaders.end()) {
+            if (!(*i)->isCompiled)
+                (*i)->compile();
+            glAttachShader(program_id, (*i)->shader_id);
+            ++i;
+        }
+        glLinkProgram(program_id);
+        if (!linkStatus()) {
+            sendError();
+        }
+    }
+    void UseProgram() {
+        glUseProgram(program_id);
+    }
+    void setMat4(const char *locName, const glm::mat4 &mat) {
+        int location = glGetUniformLocation(program_id, locName);
+        if (location == -1)
+            return;
+        glUniformMatrix4fv(location, 1, GL_FALSE, glm::value_ptr(mat));
+    }
+};
+
+
+class Texture2D {
+    GLuint tex_id;
+public:
+    void generate2DTex(const char *image_path) {
+        int width, height, nChannels;
+        stbi_set_flip_vertically_on_load(true);
+        uint8_t *raw_image = stbi_load(image_path, &width, &height, &nChannels, 0);
+        float borderColor[] = {1.f, 1.f, 1.f, 1.f};
+        glGenTextures(1, &tex_id);
+        glBindTexture(GL_TEXTURE_2D, tex_id);
+        // what to do when primitive is bigger than the texture
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_BORDER);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_BORDER);
+        glTexParameterfv(GL_TEXTURE_2D, GL_TEXTURE_BORDER_COLOR, borderColor);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        // glTexImage2D(TARGET_TYPE, IM_MIPMAP_LEVEL, TARGET_NRCHANNELS, SRC_WIDTH, SRC_HEIGHT, LEGACY_0, SRC_NRCHANNELS, SRC_DATA_TYPE, SRC_DATA);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, width, height, 0, GL_RGB, GL_UNSIGNED_BYTE, raw_image);
+        stbi_image_free(raw_image);
+    }
+    void bind() {
+        glBindTexture(GL_TEXTURE_2D, tex_id);
+    }
+};
+
+// every heap allocation in the process goes through here, so we can tell when a frame allocates
+std::atomic<size_t> heapAllocations{0};
+
+void *operator new(size_t size) {
+    heapAllocations.fetch_add(1, std::memory_order_relaxed);
+    if (void *p = std::malloc(size ? size : 1))
+        return p;
+    throw std::bad_alloc();
+}
+void operator delete(void *p) noexcept {
+    std::free(p);
+}
+void operator delete(void *p, size_t) noexcept {
+    std::free(p);
+}
+void *operator new(size_t size, std::align_val_t align) {
+    heapAllocations.fetch_add(1, std::memory_order_relaxed);
+    size_t alignment = static_cast<size_t>(align);
+    if (void *p = std::aligned_alloc(alignment, (size + alignment - 1) & ~(alignment - 1)))
+        return p;
+    throw std::bad_alloc();
+}
+void operator delete(void *p, std::align_val_t) noexcept {
+    std::free(p);
+}
+void operator delete(void *p, size_t, std::align_val_t) noexcept {
+    std::free(p);
+}
+
+// freed arena memory gets filled with this so use-after-reset shows up as garbage instead of stale data.
+// on unless we are building with NDEBUG
+#ifndef NDEBUG
+#define ARENA_POISON 1
+#endif
+constexpr uint8_t ARENA_POISON_BYTE = 0xCD;
+
+
+// bump allocator, allocating is a pointer increment and freeing is a reset of the whole thing.
+// if a frame needs more than we have, the extra allocations go to the heap and the arena
+// grows on the next reset, so after a few frames a steady state scene never touches the heap
+class LinearArena {
+    static constexpr size_t OVERFLOW_ALIGN = 64; // nothing we put in here needs more than a cache line
+    uint8_t *base = nullptr;
+    size_t capacity = 0;
+    size_t offset = 0;
+    std::vector<void*> overflow;
+    size_t overflowBytes = 0;
+    size_t allocCount = 0;
+    size_t peak = 0;
+public:
+    explicit LinearArena(size_t capacity = 1 << 20) : capacity(capacity) {
+        base = static_cast<uint8_t*>(::operator new(capacity));
+    }
+    ~LinearArena() {
+        reset();
+        ::operator delete(base);
+    }
+    LinearArena(const LinearArena&) = delete;
+    LinearArena &operator=(const LinearArena&) = delete;
+
+    void *allocate(size_t size, size_t align = alignof(std::max_align_t)) {
+        size_t start = (offset + align - 1) & ~(align - 1);
+        ++allocCount;
+        if (start + size > capacity) {
+            void *p = ::operator new(size, std::align_val_t(OVERFLOW_ALIGN));
+            overflow.push_back(p);
+            overflowBytes += size + align;
+            return p;
+        }
+        offset = start + size;
+        return base + start;
+    }
+    // frees are LIFO only: if this was the last allocation the offset is rewound to where it
+    // started. anything older, or anything in overflow, just stays until reset
+    void free(void *p, size_t size) {
+        uint8_t *bytes = static_cast<uint8_t*>(p);
+        if (bytes < base || bytes >= base + capacity)
+            return;
+#ifdef ARENA_POISON
+        std::memset(bytes, ARENA_POISON_BYTE, size);
+#endif
+        if (bytes + size == base + offset)
+            offset = bytes - base;
+    }
+    void reset() {
+        peak = std::max(peak, offset + overflowBytes);
+#ifdef ARENA_POISON
+        std::memset(base, ARENA_POISON_BYTE, offset);
+#endif
+        for (void *p : overflow)
+            ::operator delete(p, std::align_val_t(OVERFLOW_ALIGN));
+        overflow.clear();
+        if (overflowBytes) {
+            // grow once with some slack, so we don't end up here again next frame
+            ::operator delete(base);
+            capacity = (capacity + overflowBytes) * 3 / 2;
+            base = static_cast<uint8_t*>(::operator new(capacity));
+            overflowBytes = 0;
+        }
+        offset = 0;
+        allocCount = 0;
+    }
+    size_t bytesUsed() const {
+        return offset + overflowBytes;
+    }
+    size_t allocations() const {
+        return allocCount;
+    }
+    size_t highWater() const {
+        return std::max(peak, bytesUsed());
+    }
+    size_t size() const {
+        return capacity;
+    }
+};
+
+
+// lets std containers live in an arena. deallocate is (almost) free, memory comes back on reset
+template <typename T>
+class ArenaAllocator {
+public:
+    using value_type = T;
+    LinearArena *arena;
+
+    explicit ArenaAllocator(LinearArena &arena) : arena(&arena) {}
+    template <typename U>
+    ArenaAllocator(const ArenaAllocator<U> &other) : arena(other.arena) {}
+
+    T *allocate(size_t n) {
+        return static_cast<T*>(arena->allocate(n * sizeof(T), alignof(T)));
+    }
+    void deallocate(T *p, size_t n) {
+        arena->free(p, n * sizeof(T));
+    }
+    template <typename U>
+    bool operator==(const ArenaAllocator<U> &other) const {
+        return arena == other.arena;
+    }
+    template <typename U>
+    bool operator!=(const ArenaAllocator<U> &other) const {
+        return arena != other.arena;
+    }
+};
+
+template <typename T>
+using FrameVector = std::vector<T, ArenaAllocator<T>>;
+
+
+struct FrameStats {
+    size_t bytes = 0;
+    size_t allocations = 0;
+    size_t heapAllocations = 0;
+};
+
+// one arena per thread that ever asks for one, all of them reset together at the end of the frame.
+// nothing may allocate from them while endFrame() runs
+class FrameArenas {
+    static constexpr int MAX_THREADS = 32;
+    LinearArena *arenas[MAX_THREADS] = {};
+    std::atomic<int> threadCount{0};
+    size_t heapAtFrameStart = 0;
+    FrameStats last;
+public:
+    ~FrameArenas() {
+        for (int i = 0; i < threadCount; ++i)
+            delete arenas[i];
+    }
+    LinearArena &local() {
+        thread_local int slot = -1;
+        if (slot == -1) {
+            slot = threadCount.fetch_add(1);
+            if (slot >= MAX_THREADS) {
+                std::cerr << "ERROR::FRAMEARENAS - too many threads\n";
+                std::abort();
+            }
+            arenas[slot] = new LinearArena();
+        }
+        return *arenas[slot];
+    }
+    void beginFrame() {
+        heapAtFrameStart = heapAllocations.load(std::memory_order_relaxed);
+    }
+    void endFrame() {
+        last = FrameStats();
+        for (int i = 0; i < threadCount; ++i) {
+            last.bytes += arenas[i]->bytesUsed();
+            last.allocations += arenas[i]->allocations();
+        }
+        last.heapAllocations = heapAllocations.load(std::memory_order_relaxed) - heapAtFrameStart;
+        for (int i = 0; i < threadCount; ++i)
+            arenas[i]->reset();
+    }
+    const FrameStats &lastFrame() const {
+        return last;
+    }
+};
+
+FrameArenas frameArenas;
+
+
+// for data the GPU still reads after we are done with the frame (mapped buffer ranges, client side arrays).
+// two arenas, the one we are about to reuse is only reset after the fence of the frame that filled it passed
+class GpuFrameArena {
+    LinearArena arenas[2];
+    GLsync fences[2] = {};
+    int current = 0;
+    bool useFences;
+public:
+    explicit GpuFrameArena(bool useFences = true, size_t capacity = 1 << 20)
+        : arenas{LinearArena(capacity), LinearArena(capacity)}, useFences(useFences) {}
+    void *allocate(size_t size, size_t align = alignof(std::max_align_t)) {
+        return arenas[current].allocate(size, align);
+    }
+    LinearArena &arena() {
+        return arenas[current];
+    }
+    // call after the last draw that reads this frame's data was submitted
+    void endFrame() {
+        if (useFences)
+            fences[current] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        current ^= 1;
+        if (fences[current]) {
+            // usually signaled long ago, we are a whole frame ahead
+            glClientWaitSync(fences[current], GL_SYNC_FLUSH_COMMANDS_BIT, 1000000000);
+            glDeleteSync(fences[current]);
+            fences[current] = 0;
+        }
+        arenas[current].reset();
+    }
+};
+
+void processInput(GLFWwindow *window, glm::vec3 &cameraPos, glm::vec3 &cameraFront, glm::vec3 &cameraUp)
+{
+
+    const float cameraSpeed = 0.05f; // adjust accordingly
+    if (glfwGetKey(window, GLFW_KEY_W) == GLFW_PRESS)
+        cameraPos += cameraSpeed * cameraFront;
+    if (glfwGetKey(window, GLFW_KEY_S) == GLFW_PRESS)
+        cameraPos -= cameraSpeed * cameraFront;
+    if (glfwGetKey(window, GLFW_KEY_A) == GLFW_PRESS)
+        cameraPos -= glm::normalize(glm::cross(cameraFront, cameraUp)) * cameraSpeed;
+    if (glfwGetKey(window, GLFW_KEY_D) == GLFW_PRESS)
+        cameraPos += glm::normalize(glm::cross(cameraFront, cameraUp)) * cameraSpeed;
+    if (glfwGetKey(window, GLFW_KEY_UP) == GLFW_PRESS)
+        cameraPos += glm::normalize(glm::cross(cameraFront, cameraUp)) * cameraSpeed;
+
+}
+
+
+float yaw = -90.f;
+float pitch = 0.f;
+glm::vec3 cameraFront;
+
+void mouseMovement(GLFWwindow *window, double xPos, double yPos) {
+    static float lastX = xPos, lastY = yPos;
+    float xOffset = xPos - lastX;
+    float yOffset = lastY - yPos;
+    
+    constexpr float sensitivity = 0.05f;
+    xOffset *= sensitivity;
+    yOffset *= sensitivity;
+
+    yaw += xOffset;
+    pitch += yOffset;
+
+    if (std::abs(pitch) > 89.f) // don't ever do it this way. I am lazy
+        pitch = std::abs(pitch) / pitch * 89.f;
+
+    cameraFront.x = cos(glm::radians(yaw)) * cos(glm::radians(pitch));
+    cameraFront.y = sin(glm::radians(pitch));
+    cameraFront.z = sin(glm::radians(yaw)) * cos(glm::radians(pitch));
+
+    cameraFront = glm::normalize(cameraFront);
+    lastX = xPos, lastY = yPos;
+}
+
+
+constexpr int GRID = 20;
+
+struct DrawItem {
+    float depth;
+    uint32_t index;
+};
+
+// this frame's draw list: a model matrix per cube (kept alive until the GPU is done with the frame)
+// and the order to draw them in, front to back so the depth test rejects as much as possible
+struct DrawList {
+    glm::mat4 *models;
+    FrameVector<DrawItem> items;
+};
+
+DrawList buildDrawList(LinearArena &modelArena, const glm::vec3 &cameraPos, float time, int first = 0, int last = GRID * GRID) {
+    DrawList list = {
+        static_cast<glm::mat4*>(modelArena.allocate((last - first) * sizeof(glm::mat4), alignof(glm::mat4))),
+        FrameVector<DrawItem>(ArenaAllocator<DrawItem>(frameArenas.local()))
+    };
+    list.items.reserve(last - first);
+    for (int i = first; i < last; ++i) {
+        glm::vec3 pos((i % GRID - GRID / 2) * 2.f, 0.f, -(i / GRID) * 2.f);
+        glm::mat4 model = glm::translate(glm::mat4(1.f), pos);
+        model = glm::rotate(model, time + i * 0.1f, glm::vec3(1.f, 0.f, 1.f));
+        list.models[i - first] = model;
+        list.items.push_back({glm::length(pos - cameraPos), uint32_t(i - first)});
+    }
+    std::sort(list.items.begin(), list.items.end(), [](const DrawItem &a, const DrawItem &b) {
+        return a.depth < b.depth;
+    });
+    return list;
+}
+
+// runs frames without a window, with two helper threads building parts of the draw list into their own
+// arenas, and fails if any frame after warm-up touched the heap
+int runCheck() {
+    constexpr int WORKERS = 2;
+    constexpr int WARMUP = 8;
+    constexpr int FRAMES = 500;
+    GpuFrameArena gpuArena(false);
+    std::atomic<int> frame{-1};
+    std::atomic<int> done{0};
+    std::vector<std::thread> workers;
+    for (int w = 0; w < WORKERS; ++w) {
+        workers.emplace_back([&, w] {
+            int seen = -1;
+            while (true) {
+                int f;
+                while ((f = frame.load()) == seen)
+                    std::this_thread::yield();
+                if (f == INT32_MAX)
+                    return;
+                seen = f;
+                // the first half of the grid is split between the workers
+                int chunk = GRID * GRID / 2 / WORKERS;
+                {
+                    // no reserve on purpose, growing has to stay in the arena too
+                    FrameVector<float> scratch(ArenaAllocator<float>(frameArenas.local()));
+                    for (int i = 0; i < chunk; ++i)
+                        scratch.push_back(float(i));
+                    DrawList part = buildDrawList(frameArenas.local(), glm::vec3(0.f), f * 0.01f, w * chunk, (w + 1) * chunk);
+                }
+                done.fetch_add(1);
+            }
+        });
+    }
+    size_t worstHeap = 0;
+    size_t bytes = 0, allocs = 0;
+    bool ok = true;
+    for (int f = 0; f < WARMUP + FRAMES; ++f) {
+        frameArenas.beginFrame();
+        done = 0;
+        frame = f;
+        while (done.load() != WORKERS)
+            std::this_thread::yield();
+        {
+            // the list lives in the arenas, so it has to be gone before they are reset
+            DrawList list = buildDrawList(gpuArena.arena(), glm::vec3(0.f, 0.f, 3.f), f * 0.01f, GRID * GRID / 2);
+        }
+        gpuArena.endFrame();
+        frameArenas.endFrame();
+        const FrameStats &stats = frameArenas.lastFrame();
+        if (f >= WARMUP) {
+            worstHeap = std::max(worstHeap, stats.heapAllocations);
+            if (stats.heapAllocations && ok) {
+                std::cout << "check: frame " << f << " did " << stats.heapAllocations << " heap allocations\n";
+                ok = false;
+            }
+        }
+        bytes = stats.bytes, allocs = stats.allocations;
+    }
+    frame = INT32_MAX;
+    for (std::thread &t : workers)
+        t.join();
+    std::cout << "check: " << FRAMES << " frames, " << bytes << " arena bytes and " << allocs
+              << " arena allocations per frame, worst heap allocations per frame " << worstHeap << "\n";
+
+#ifdef ARENA_POISON
+    LinearArena arena(256);
+    uint32_t *p = static_cast<uint32_t*>(arena.allocate(64 * sizeof(uint32_t), alignof(uint32_t)));
+    for (int i = 0; i < 64; ++i)
+        p[i] = i;
+    arena.reset();
+    for (int i = 0; i < 64 && ok; ++i) {
+        if (p[i] != 0xCDCDCDCDu) {
+            std::cout << "check: arena memory was not poisoned after reset\n";
+            ok = false;
+        }
+    }
+#endif
+    std::cout << (ok ? "check: OK\n" : "check: FAILED\n");
+    return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+
+int main(int argc, char **argv) {
+    if (argc > 1 && !std::strcmp(argv[1], "--check"))
+        return runCheck();
+
+    if (glfwInit() != GLFW_TRUE) {
+        glfwTerminate();
+        std::cerr << "Failed to initialize GLFW";
+        return EXIT_FAILURE;
+    }
+    // setting OpenGL version to 3.3
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+    GLFWwindow *win = glfwCreateWindow(600, 600, "This is a hello window!", NULL, NULL);
+    glViewport(0, 0, 600, 600);
+    // setting 'context' for OpenGL, i.e. where to draw on current thread
+    glfwMakeContextCurrent(win);
+    // all it does is fetches us the implemented functions of OpenGL
+    if (glewInit() != GLEW_OK) {
+        glfwTerminate();
+        std::cerr << "Failed to initialize GLEW\n";
+        return EXIT_FAILURE;
+    }
+
+    glEnable(GL_DEPTH_TEST);
+    float triangle_data[] = {
+        //   vertpos   //  //texcord//
+    -0.5f, -0.5f, -0.5f,  0.0f, 0.0f,
+     0.5f, -0.5f, -0.5f,  1.0f, 0.0f,
+     0.5f,  0.5f, -0.5f,  1.0f, 1.0f,
+     0.5f,  0.5f, -0.5f,  1.0f, 1.0f,
+    -0.5f,  0.5f, -0.5f,  0.0f, 1.0f,
+    -0.5f, -0.5f, -0.5f,  0.0f, 0.0f,
+
+    -0.5f, -0.5f,  0.5f,  0.0f, 0.0f,
+     0.5f, -0.5f,  0.5f,  1.0f, 0.0f,
+     0.5f,  0.5f,  0.5f,  1.0f, 1.0f,
+     0.5f,  0.5f,  0.5f,  1.0f, 1.0f,
+    -0.5f,  0.5f,  0.5f,  0.0f, 1.0f,
+    -0.5f, -0.5f,  0.5f,  0.0f, 0.0f,
+
+    -0.5f,  0.5f,  0.5f,  1.0f, 0.0f,
+    -0.5f,  0.5f, -0.5f,  1.0f, 1.0f,
+    -0.5f, -0.5f, -0.5f,  0.0f, 1.0f,
+    -0.5f, -0.5f, -0.5f,  0.0f, 1.0f,
+    -0.5f, -0.5f,  0.5f,  0.0f, 0.0f,
+    -0.5f,  0.5f,  0.5f,  1.0f, 0.0f,
+
+     0.5f,  0.5f,  0.5f,  1.0f, 0.0f,
+     0.5f,  0.5f, -0.5f,  1.0f, 1.0f,
+     0.5f, -0.5f, -0.5f,  0.0f, 1.0f,
+     0.5f, -0.5f, -0.5f,  0.0f, 1.0f,
+     0.5f, -0.5f,  0.5f,  0.0f, 0.0f,
+     0.5f,  0.5f,  0.5f,  1.0f, 0.0f,
+
+    -0.5f, -0.5f, -0.5f,  0.0f, 1.0f,
+     0.5f, -0.5f, -0.5f,  1.0f, 1.0f,
+     0.5f, -0.5f,  0.5f,  1.0f, 0.0f,
+     0.5f, -0.5f,  0.5f,  1.0f, 0.0f,
+    -0.5f, -0.5f,  0.5f,  0.0f, 0.0f,
+    -0.5f, -0.5f, -0.5f,  0.0f, 1.0f,
+
+    -0.5f,  0.5f, -0.5f,  0.0f, 1.0f,
+     0.5f,  0.5f, -0.5f,  1.0f, 1.0f,
+     0.5f,  0.5f,  0.5f,  1.0f, 0.0f,
+     0.5f,  0.5f,  0.5f,  1.0f, 0.0f,
+    -0.5f,  0.5f,  0.5f,  0.0f, 0.0f,
+    -0.5f,  0.5f, -0.5f,  0.0f, 1.0f
+        
+    };
+
+
+    glm::vec3 cameraPos(0.f, 0.f, 3.f);
+    cameraFront = glm::vec3(0.f,0.f,-1.f);
+    glm::vec3 cameraUp(0.,1.,0.f);
+    
+
+    Texture2D tex;
+    tex.generate2DTex("./image2d.tex");
+    tex.bind();
+
+    GLuint vbo = 0;
+    glGenBuffers(1, &vbo); 
+    glBindBuffer(GL_ARRAY_BUFFER, vbo);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(triangle_data), triangle_data, GL_STATIC_DRAW);
+
+    GLuint ebo = 0;
+    GLuint index_array[] = {
+        // front
+        0, 1, 3,
+        1, 2, 3,
+        //back
+        4, 5, 6,
+        4, 6, 7,
+        // left-facing
+        2, 3, 7,
+        2, 6, 7,
+        // right-facing
+        0, 1, 4,
+        1, 4, 5
+        
+    };
+    glGenBuffers(1, &ebo);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ebo);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(index_array), index_array, GL_STATIC_DRAW);
+    
+    GLuint vao = 0;
+    glGenVertexArrays(1, &vao);
+    glBindVertexArray(vao);
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)0);
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)(3 * sizeof(float)));
+    glEnableVertexAttribArray(1);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ebo); // don't forget to bind ebo, because it uses vao to find ebo, vbo and attrib pointers
+
+    VertexShader vs;
+    FragmentShader fs;
+    vs.setSource("./vertex.glsl");
+    fs.setSource("./frag.glsl");
+    Program prog;
+    prog.AttachShaders({&vs, &fs});
+    prog.UseProgram();
+
+
+    glm::mat4 view; // = glm::translate(glm::mat4(1.f), glm::vec3(0.f,0.f,-3.f));
+       
+
+    glm::mat4 proj = glm::perspective(glm::radians(45.f), 800 / 600.f, 0.1f, 100.f);
+
+    prog.setMat4("proj", proj);
+    prog.setMat4("view", view);
+
+    glfwSetCursorPosCallback(win, mouseMovement); 
+    glfwSetInputMode(win, GLFW_CURSOR, GLFW_CURSOR_DISABLED);  
+    
+    GpuFrameArena gpuArena;
+    size_t frames = 0, worstHeap = 0, peakBytes = 0;
+    while (!glfwWindowShouldClose(win)) {
+        frameArenas.beginFrame();
+        processInput(win, cameraPos, cameraFront, cameraUp);
+        view = glm::lookAt(cameraPos, cameraFront + cameraPos, cameraUp);
+
+        prog.setMat4("view", view);
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+        {
+            DrawList list = buildDrawList(gpuArena.arena(), cameraPos, glfwGetTime());
+            for (const DrawItem &item : list.items) {
+                prog.setMat4("model", list.models[item.index]);
+                glDrawArrays(GL_TRIANGLES, 0, 36);
+            }
+        }
+        gpuArena.endFrame();
+        frameArenas.endFrame();
+        const FrameStats &stats = frameArenas.lastFrame();
+        // the first frames are allowed to allocate, the arenas are still finding their size
+        if (++frames > 8)
+            worstHeap = std::max(worstHeap, stats.heapAllocations);
+        peakBytes = std::max(peakBytes, stats.bytes);
+        // polls different kinds of events, for example, when we close an application, it fetches that event
+        // or it fetches events like movement of the window.
+        // Without it you can neither move the window or close the window
+        glfwPollEvents();
+        // have you drawn the image, it is stored in the buffer. You can now swap this buffer with main buffer
+        // so the image appears
+        glfwSwapBuffers(win);
+    }
+    glfwTerminate();
+    
+    std::cout << "Window should close now!\n";
+    std::cout << "arena peak " << peakBytes << " bytes per frame, worst heap allocations in a frame " << worstHeap << "\n";
+
+    return EXIT_SUCCESS;
+
+}